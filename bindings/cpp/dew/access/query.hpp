@@ -35,9 +35,15 @@ using position_format_t = dew_position_format_t;
 using dataset_options_t = dew_dataset_options_t;
 using dataset_info_t = dew_dataset_info_t;
 using region_request_t = dew_region_request_t;
+using aggregate_request_t = dew_aggregate_request_t;
+using aggregate_result_t = dew_aggregate_result_t;
+using search_request_t = dew_search_request_t;
+using search_result_t = dew_search_result_t;
 using attribute_buffer_t = dew_attribute_buffer_t;
 using result_node_t = dew_result_node_t;
 using request_result_t = dew_request_result_t;
+using request_stats_t = dew_request_stats_t;
+using dataset_stats_t = dew_dataset_stats_t;
 
 class dataset_t;
 class request_t;
@@ -133,6 +139,8 @@ public:
 
   std::string get_attribute_name(uint32_t index) const;
 
+  dew_dataset_stats_t get_stats() const;
+
 private:
   dew_dataset_t *_handle = nullptr;
 };
@@ -196,8 +204,18 @@ public:
 
   float completion_factor() const;
 
+  std::optional<dew_request_stats_t> get_stats() const;
+
   std::optional<dew_request_result_t> get_result() const;
 
+  uint32_t region_count() const;
+
+  std::optional<dew_request_result_t> get_region_result(uint32_t region) const;
+
+  std::optional<dew_aggregate_result_t> get_aggregate() const;
+
+  std::optional<dew_search_result_t> get_search() const;
+
   uint64_t attribute_size(uint32_t attribute_index) const;
 
   // Not wrapped -- call the C function directly with get():
@@ -272,6 +290,13 @@ inline std::string dataset_t::get_attribute_name(uint32_t index) const
   });
 }
 
+inline dew_dataset_stats_t dataset_t::get_stats() const
+{
+  dew_dataset_stats_t out_out{};
+  dew_dataset_get_stats(_handle, &out_out);
+  return out_out;
+}
+
 inline dew_request_status_t request_t::status() const
 {
   dew_request_status_t return_ = dew_request_status(_handle);
@@ -302,6 +327,13 @@ inline float request_t::completion_factor() const
   return return_;
 }
 
+inline std::optional<dew_request_stats_t> request_t::get_stats() const
+{
+  dew_request_stats_t out_out{};
+  bool ok_ = dew_request_get_stats(_handle, &out_out);
+  return ok_ ? std::optional<dew_request_stats_t>(out_out) : std::nullopt;
+}
+
 inline std::optional<dew_request_result_t> request_t::get_result() const
 {
   dew_request_result_t out_out{};
@@ -309,6 +341,33 @@ inline std::optional<dew_request_result_t> request_t::get_result() const
   return ok_ ? std::optional<dew_request_result_t>(out_out) : std::nullopt;
 }
 
+inline uint32_t request_t::region_count() const
+{
+  uint32_t return_ = dew_request_region_count(_handle);
+  return return_;
+}
+
+inline std::optional<dew_request_result_t> request_t::get_region_result(uint32_t region) const
+{
+  dew_request_result_t out_out{};
+  bool ok_ = dew_request_get_region_result(_handle, region, &out_out);
+  return ok_ ? std::optional<dew_request_result_t>(out_out) : std::nullopt;
+}
+
+inline std::optional<dew_aggregate_result_t> request_t::get_aggregate() const
+{
+  dew_aggregate_result_t out_out{};
+  bool ok_ = dew_request_get_aggregate(_handle, &out_out);
+  return ok_ ? std::optional<dew_aggregate_result_t>(out_out) : std::nullopt;
+}
+
+inline std::optional<dew_search_result_t> request_t::get_search() const
+{
+  dew_search_result_t out_out{};
+  bool ok_ = dew_request_get_search(_handle, &out_out);
+  return ok_ ? std::optional<dew_search_result_t>(out_out) : std::nullopt;
+}
+
 inline uint64_t request_t::attribute_size(uint32_t attribute_index) const
 {
   uint64_t return_ = dew_request_attribute_size(_handle, attribute_index);
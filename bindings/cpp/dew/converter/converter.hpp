@@ -26,9 +26,11 @@ namespace dewpp
 
 // ---- aliases of the C declarations ----
 
+using converter_push_status_t = dew_converter_push_status_t;
 using converter_conversion_status_t = dew_converter_conversion_status_t;
 using converter_open_file_semantics_t = dew_converter_open_file_semantics_t;
 using converter_compression_t = dew_converter_compression_t;
+using converter_dedup_keep_t = dew_converter_dedup_keep_t;
 using converter_header_t = dew_converter_header_t;
 using converter_file_pre_init_info_t = dew_converter_file_pre_init_info_t;
 using converter_file_convert_callbacks_t = dew_converter_file_convert_callbacks_t;
@@ -41,6 +43,7 @@ using converter_attribute_stats_t = dew_converter_attribute_stats_t;
 using converter_stats_t = dew_converter_stats_t;
 using converter_io_stats_t = dew_converter_io_stats_t;
 using converter_perf_stats_t = dew_converter_perf_stats_t;
+using converter_numa_node_stats_t = dew_converter_numa_node_stats_t;
 
 class converter_t;
 
@@ -154,6 +157,22 @@ public:
   //  substantial size cost). Must be called before dew_converter_add_data_file.
   void set_lod_all_attributes(uint8_t all) const;
 
+  //  Drop duplicate points after the morton sort (default off). With grid_lod 0 only points with an
+  //  identical morton code are duplicates; grid_lod N > 0 also collapses points sharing a cell 2^N grid
+  //  steps wide (grid_lod 1 removes near-duplicates about one grid step apart). `keep` picks the survivor.
+  //  Applied within each sorted chunk and again across chunks when leaves are collapsed; the removed count
+  //  is reported as duplicate_points_removed in the compression stats. Must be called before
+  //  dew_converter_add_data_file.
+  void set_dedup(uint8_t enabled, uint8_t grid_lod, dew_converter_dedup_keep_t keep) const;
+
+  //  Store an attribute with bounded precision loss (default: exact). Float attributes (r32/r64, e.g.
+  //  gps_time) are kept as integer steps of `tolerance`, restoring within tolerance / 2; integer attributes
+  //  (e.g. intensity) are rounded down to a multiple of the largest power of two not exceeding tolerance + 1,
+  //  and low bits that are zero in every value are dropped -- with tolerance 0 that alone, losslessly.
+  //  Readers get the attribute back in its declared type; zone-map min/max are widened by the error. A
+  //  negative tolerance removes the policy. Must be called before dew_converter_add_data_file.
+  void set_attribute_precision(std::string_view name, double tolerance) const;
+
   //  Read/sort chunk byte target (default 64 MiB): the converter ingests each input in chunks of about
   //  this many bytes (computed from the file's per-point width, never below the node point limit,
   //  capped at 8M points per chunk). Larger chunks amortize source reads and sorting; the octree still
@@ -161,9 +180,80 @@ public:
   //  Must be called before dew_converter_add_data_file.
   void set_read_chunk_bytes(uint64_t bytes) const;
 
+  //  Write a hierarchy directory with the finished dataset (default 0 = none): the serialized trees of the
+  //  top `depth` tree levels (each spans five octree levels), breadth-first in one blob, so a reader opening
+  //  the dataset descends that far after a single read instead of one read per tree. Leave it off for local
+  //  files; it pays off against object stores, where each tree read is a round trip. Trees beyond a 64 MiB
+  //  directory still load on demand.
+  void set_hierarchy_directory_depth(uint32_t depth) const;
+
+  //  Pass 1 to run the conversion on one worker pool per NUMA node (topology from /sys/devices/system/node),
+  //  workers pinned to their node's CPUs. Each input is read, sorted and compressed on one node, and LOD and
+  //  collapse work is spread over the nodes by subtree. Returns 0 and keeps the single shared pool on machines
+  //  with fewer than two nodes, off Linux, or when inputs were already added. Must be called before
+  //  dew_converter_add_data_file.
+  uint8_t set_numa_pools(uint8_t enabled) const;
+
+  //  Pass 1 to let the converter tune itself while it runs: every couple of seconds it compares the stage
+  //  throughputs and queue depths (inputs read, chunks waiting to sort, writes waiting to compress) and moves
+  //  one of the read chunk size and the number of concurrent readers, sorters and compressors, keeping the
+  //  point buffers within the read/sort memory budget and undoing a change that lowered throughput. Each
+  //  decision is logged to stderr; the final settings land in the perf stats. Returns 0 when inputs were
+  //  already added. Must be called before dew_converter_add_data_file.
+  uint8_t set_autotune(uint8_t enabled) const;
+
+  //  Per-node worker utilization while NUMA pools are enabled; the count is 0 otherwise.
+  uint32_t get_numa_node_count() const;
+
+  std::optional<dew_converter_numa_node_stats_t> get_numa_node_stats(uint32_t index) const;
+
   //  May block on ingest backpressure, so Python bindings must release the GIL around it.
   void add_data_file(const std::vector<dew_converter_str_buffer> & buffers) const;
 
+  //  Remove an input file from the dataset, or replace it with another file, without reconverting the rest.
+  //  `name` is the name the file was added with. Its points are dropped from the leaves they landed in, the
+  //  replacement (if any) is read like any input, and LOD is rebuilt only along the morton ranges of the two
+  //  files up to the root; every other node keeps its blobs. Where the removed file's points were already
+  //  merged into per-node units the file is read once more to subtract them, so it must still hold the data
+  //  it was converted from.
+  //
+  //  The call validates and queues the edit; dew_converter_wait_idle waits for it like for a new input. It
+  //  fails when the file is not an input of this dataset, is still being converted, is a push stream segment,
+  //  or the converter uploads to a destination (uploaded subtrees are immutable). An edit interrupted by a
+  //  crash is not resumed: issue it again after reopening.
+  std::optional<error_t> remove_input(std::string_view name) const;
+
+  std::optional<error_t> replace_input(std::string_view name, std::string_view new_name) const;
+
+  //  Push ingest for live feeds (mobile-mapping rigs, scanners streaming over the network): hand the converter
+  //  `point_count` points that are already in memory, one buffer per attribute as in
+  //  dew_converter_file_convert_data_callback_t (attributes[0] must be xyz). Callable from any thread; the
+  //  buffers are copied before it returns. Small batches are coalesced into read-sized chunks, so batch size
+  //  does not shape the stored blobs.
+  //
+  //  header.offset/scale describe the xyz encoding like a file's init header does. header.min is a promise
+  //  about the stream: no point pushed from now on lies below it. It is what lets incremental LOD and
+  //  checkpoints follow the stream while it runs; a batch whose header.min reaches below the part of the
+  //  dataset that is already final is refused with an error. A feed that cannot bound where it goes next
+  //  passes the bottom of its survey area -- the dataset then still grows checkpoint by checkpoint, but LOD
+  //  is only built once the stream ends.
+  //
+  //  Pushed points count against the converter's ingest memory budget until they are sorted. When they do
+  //  not fit, a call with `block` set waits; one without returns dew_push_status_would_block and accepts
+  //  nothing. The stream keeps the converter busy until dew_converter_push_end, so call that before
+  //  dew_converter_wait_idle.
+  result_t<dew_converter_push_status_t> push_points(const dew_converter_header_t & header, const std::vector<dew_attribute_t> & attributes, const dew_blob_t * buffers, uint64_t point_count, uint8_t block) const;
+
+  //  Cut the push stream here: what was pushed so far is sorted, inserted and checkpointed (and its LOD
+  //  built, as far as header.min allows) without waiting for the segment size. The stream stays open.
+  void push_flush() const;
+
+  //  End the push stream. The conversion completes once its last points are in; a later push starts a new one.
+  void push_end() const;
+
+  //  Points per push segment (default 16M): the stream is checkpointed, and its LOD advanced, every this many points.
+  void set_push_segment_points(uint64_t points) const;
+
   void wait_idle() const;
 
   dew_converter_conversion_status_t status() const;
@@ -277,16 +367,94 @@ inline void converter_t::set_lod_all_attributes(uint8_t all) const
   dew_converter_set_lod_all_attributes(_handle, all);
 }
 
+inline void converter_t::set_dedup(uint8_t enabled, uint8_t grid_lod, dew_converter_dedup_keep_t keep) const
+{
+  dew_converter_set_dedup(_handle, enabled, grid_lod, keep);
+}
+
+inline void converter_t::set_attribute_precision(std::string_view name, double tolerance) const
+{
+  dew_converter_set_attribute_precision(_handle, name.data(), static_cast<uint32_t>(name.size()), tolerance);
+}
+
 inline void converter_t::set_read_chunk_bytes(uint64_t bytes) const
 {
   dew_converter_set_read_chunk_bytes(_handle, bytes);
 }
 
+inline void converter_t::set_hierarchy_directory_depth(uint32_t depth) const
+{
+  dew_converter_set_hierarchy_directory_depth(_handle, depth);
+}
+
+inline uint8_t converter_t::set_numa_pools(uint8_t enabled) const
+{
+  uint8_t return_ = dew_converter_set_numa_pools(_handle, enabled);
+  return return_;
+}
+
+inline uint8_t converter_t::set_autotune(uint8_t enabled) const
+{
+  uint8_t return_ = dew_converter_set_autotune(_handle, enabled);
+  return return_;
+}
+
+inline uint32_t converter_t::get_numa_node_count() const
+{
+  uint32_t return_ = dew_converter_get_numa_node_count(_handle);
+  return return_;
+}
+
+inline std::optional<dew_converter_numa_node_stats_t> converter_t::get_numa_node_stats(uint32_t index) const
+{
+  dew_converter_numa_node_stats_t stats_out{};
+  bool ok_ = dew_converter_get_numa_node_stats(_handle, index, &stats_out);
+  return ok_ ? std::optional<dew_converter_numa_node_stats_t>(stats_out) : std::nullopt;
+}
+
 inline void converter_t::add_data_file(const std::vector<dew_converter_str_buffer> & buffers) const
 {
   dew_converter_add_data_file(_handle, const_cast<dew_converter_str_buffer *>(buffers.data()), static_cast<uint32_t>(buffers.size()));
 }
 
+inline std::optional<error_t> converter_t::remove_input(std::string_view name) const
+{
+  detail::error_out_t error_;
+  dew_converter_remove_input(_handle, name.data(), static_cast<uint64_t>(name.size()), error_.slot());
+  return error_.take_if_set();
+}
+
+inline std::optional<error_t> converter_t::replace_input(std::string_view name, std::string_view new_name) const
+{
+  detail::error_out_t error_;
+  dew_converter_replace_input(_handle, name.data(), static_cast<uint64_t>(name.size()), new_name.data(), static_cast<uint64_t>(new_name.size()), error_.slot());
+  return error_.take_if_set();
+}
+
+inline result_t<dew_converter_push_status_t> converter_t::push_points(const dew_converter_header_t & header, const std::vector<dew_attribute_t> & attributes, const dew_blob_t * buffers, uint64_t point_count, uint8_t block) const
+{
+  detail::error_out_t error_;
+  dew_converter_push_status_t return_ = dew_converter_push_points(_handle, &header, attributes.data(), static_cast<uint32_t>(attributes.size()), buffers, point_count, block, error_.slot());
+  if (return_ == dew_push_status_error)
+    return std::unexpected(error_.take("dew_converter_push_points failed"));
+  return return_;
+}
+
+inline void converter_t::push_flush() const
+{
+  dew_converter_push_flush(_handle);
+}
+
+inline void converter_t::push_end() const
+{
+  dew_converter_push_end(_handle);
+}
+
+inline void converter_t::set_push_segment_points(uint64_t points) const
+{
+  dew_converter_set_push_segment_points(_handle, points);
+}
+
 inline void converter_t::wait_idle() const
 {
   dew_converter_wait_idle(_handle);
@@ -27,6 +27,25 @@ namespace dewpp
 {
 
 class converter_data_source_t;
+class converter_arbiter_t;
+
+struct converter_data_source_get_prefetch_stats_result_t
+{
+  uint64_t issued;
+  uint64_t hits;
+  uint32_t in_flight;
+  uint32_t scheduled_last_frame;
+  double hit_rate;
+};
+
+struct converter_data_source_get_occlusion_stats_result_t
+{
+  uint32_t tested;
+  uint32_t occluded;
+  uint32_t occluders;
+  double coverage;
+  double build_ms;
+};
 
 struct converter_data_source_get_memory_stats_result_t
 {
@@ -75,6 +94,15 @@ struct converter_data_source_get_tight_aabb_result_t
   std::array<double, 3> max;
 };
 
+struct converter_arbiter_get_stats_result_t
+{
+  uint32_t sources;
+  uint64_t backlog_bytes;
+  uint64_t gpu_bytes;
+  uint32_t io_in_flight;
+  double min_screen_error;
+};
+
 // Owns its dew_converter_data_source_t: move-only, destroyed with dew_converter_data_source_destroy.
 class converter_data_source_t
 {
@@ -156,6 +184,31 @@ public:
 
   void set_max_in_flight_io(int max_requests) const;
 
+  //  Predictive prefetch. The data source extrapolates the camera path from its recent frames (linear and
+  //  angular velocity) and, while the camera moves, reads ahead the nodes the frustum `lookahead_ms` in the
+  //  future will need: raw blob reads into the read cache, no decode or GPU upload, only in IO slots and
+  //  backlog headroom the on-screen loads leave unused. 0 (the default) disables it.
+  void set_prefetch_lookahead_ms(double lookahead_ms) const;
+
+  //  Prefetch observability: read-aheads issued and hits (a later real load whose primary blob a read-ahead
+  //  had already cached), both since creation; read-aheads in flight now and issued last frame; and
+  //  hit_rate = hits / issued. Any out-pointer may be null.
+  converter_data_source_get_prefetch_stats_result_t get_prefetch_stats() const;
+
+  //  Occlusion culling before IO. Nodes the walker selects but that sit behind what is already drawn are
+  //  tested against a coarse depth pyramid and, with mode 1, loaded only after every visible node; with
+  //  mode 2, not loaded until they come into view (less IO and GPU memory in dense urban/indoor scenes, at
+  //  the price of pop-in when the camera moves around a corner). 0 (the default) disables it. The pyramid is
+  //  built on the CPU from a few dozen points kept per uploaded node, unless a depth callback is set.
+  void set_occlusion_culling(uint32_t mode) const;
+
+  void set_occlusion_depth_callback(dew_converter_data_source_occlusion_depth_callback_t callback, void * callback_user_ptr) const;
+
+  //  Occlusion observability for the last frame: unloaded nodes tested, how many were occluded, nodes
+  //  splatted into the pyramid (0 when it came from the depth callback), the fraction of the pyramid
+  //  covered, and the time spent building it. Any out-pointer may be null.
+  converter_data_source_get_occlusion_stats_result_t get_occlusion_stats() const;
+
   //  One total CPU-memory budget for the streaming renderer. Internally derived into the read-cache size, the
   //  decoded-backlog byte cap (new IO is refused while estimated in-flight + decoded-awaiting-upload bytes
   //  exceed it), the virtual-subtree CPU-resident budget, and a clamp on max_in_flight_io (see
@@ -200,6 +253,76 @@ private:
   dew_converter_data_source_t *_handle = nullptr;
 };
 
+// Owns its dew_converter_arbiter_t: move-only, destroyed with dew_converter_arbiter_destroy.
+class converter_arbiter_t
+{
+public:
+  converter_arbiter_t() = default;
+  explicit converter_arbiter_t(dew_converter_arbiter_t *handle)
+    : _handle(handle)
+  {
+  }
+
+  ~converter_arbiter_t() { reset(); }
+  converter_arbiter_t(converter_arbiter_t &&other) noexcept
+    : _handle(other._handle)
+  {
+    other._handle = nullptr;
+  }
+  converter_arbiter_t &operator=(converter_arbiter_t &&other) noexcept
+  {
+    if (this != &other)
+    {
+      reset();
+      _handle = other._handle;
+      other._handle = nullptr;
+    }
+    return *this;
+  }
+  converter_arbiter_t(const converter_arbiter_t &) = delete;
+  converter_arbiter_t &operator=(const converter_arbiter_t &) = delete;
+
+  void reset()
+  {
+    if (_handle)
+      dew_converter_arbiter_destroy(_handle);
+    _handle = nullptr;
+  }
+
+  // Hand the raw handle back, giving up ownership.
+  [[nodiscard]] dew_converter_arbiter_t *release()
+  {
+    dew_converter_arbiter_t *handle = _handle;
+    _handle = nullptr;
+    return handle;
+  }
+
+  // Named handle() rather than get(): several data sources already have a `get` method of
+  // their own (dew_*_data_source_get), and the wrapper must not shadow it.
+  [[nodiscard]] dew_converter_arbiter_t *handle() const { return _handle; }
+  [[nodiscard]] explicit operator bool() const { return _handle != nullptr; }
+
+  static result_t<converter_arbiter_t> create();
+
+  void add_data_source(const converter_data_source_t & cds) const;
+
+  void remove_data_source(const converter_data_source_t & cds) const;
+
+  //  The same knobs as the per-source setters, with the same defaults (1GB CPU, 512MB GPU, 64 IO).
+  void set_memory_budget(uint64_t total_bytes) const;
+
+  void set_gpu_memory_budget(size_t budget_bytes) const;
+
+  void set_max_in_flight_io(int max_requests) const;
+
+  //  Totals over the registered sources as of their last frames, and the screen-error floor (a fraction of
+  //  the viewport height; 0 when every waiting node fits the free IO slots). Any out-pointer may be null.
+  converter_arbiter_get_stats_result_t get_stats() const;
+
+private:
+  dew_converter_arbiter_t *_handle = nullptr;
+};
+
 // ---- method bodies ----
 //
 // Out-of-line because a body that calls another wrapper's handle() needs that wrapper to be
@@ -282,6 +405,43 @@ inline void converter_data_source_t::set_max_in_flight_io(int max_requests) cons
   dew_converter_data_source_set_max_in_flight_io(_handle, max_requests);
 }
 
+inline void converter_data_source_t::set_prefetch_lookahead_ms(double lookahead_ms) const
+{
+  dew_converter_data_source_set_prefetch_lookahead_ms(_handle, lookahead_ms);
+}
+
+inline converter_data_source_get_prefetch_stats_result_t converter_data_source_t::get_prefetch_stats() const
+{
+  uint64_t issued_out{};
+  uint64_t hits_out{};
+  uint32_t in_flight_out{};
+  uint32_t scheduled_last_frame_out{};
+  double hit_rate_out{};
+  dew_converter_data_source_get_prefetch_stats(_handle, &issued_out, &hits_out, &in_flight_out, &scheduled_last_frame_out, &hit_rate_out);
+  return converter_data_source_get_prefetch_stats_result_t{issued_out, hits_out, in_flight_out, scheduled_last_frame_out, hit_rate_out};
+}
+
+inline void converter_data_source_t::set_occlusion_culling(uint32_t mode) const
+{
+  dew_converter_data_source_set_occlusion_culling(_handle, mode);
+}
+
+inline void converter_data_source_t::set_occlusion_depth_callback(dew_converter_data_source_occlusion_depth_callback_t callback, void * callback_user_ptr) const
+{
+  dew_converter_data_source_set_occlusion_depth_callback(_handle, callback, callback_user_ptr);
+}
+
+inline converter_data_source_get_occlusion_stats_result_t converter_data_source_t::get_occlusion_stats() const
+{
+  uint32_t tested_out{};
+  uint32_t occluded_out{};
+  uint32_t occluders_out{};
+  double coverage_out{};
+  double build_ms_out{};
+  dew_converter_data_source_get_occlusion_stats(_handle, &tested_out, &occluded_out, &occluders_out, &coverage_out, &build_ms_out);
+  return converter_data_source_get_occlusion_stats_result_t{tested_out, occluded_out, occluders_out, coverage_out, build_ms_out};
+}
+
 inline void converter_data_source_t::set_memory_budget(uint64_t total_bytes) const
 {
   dew_converter_data_source_set_memory_budget(_handle, total_bytes);
@@ -387,4 +547,48 @@ inline converter_data_source_get_tight_aabb_result_t converter_data_source_t::ge
   return converter_data_source_get_tight_aabb_result_t{min_out, max_out};
 }
 
+inline result_t<converter_arbiter_t> converter_arbiter_t::create()
+{
+  dew_converter_arbiter_t *handle_ = dew_converter_arbiter_create();
+  if (!handle_)
+    return std::unexpected(error_t(-1, "dew_converter_arbiter_create failed"));
+  return converter_arbiter_t(handle_);
+}
+
+inline void converter_arbiter_t::add_data_source(const converter_data_source_t & cds) const
+{
+  dew_converter_arbiter_add_data_source(_handle, cds.handle());
+}
+
+inline void converter_arbiter_t::remove_data_source(const converter_data_source_t & cds) const
+{
+  dew_converter_arbiter_remove_data_source(_handle, cds.handle());
+}
+
+inline void converter_arbiter_t::set_memory_budget(uint64_t total_bytes) const
+{
+  dew_converter_arbiter_set_memory_budget(_handle, total_bytes);
+}
+
+inline void converter_arbiter_t::set_gpu_memory_budget(size_t budget_bytes) const
+{
+  dew_converter_arbiter_set_gpu_memory_budget(_handle, budget_bytes);
+}
+
+inline void converter_arbiter_t::set_max_in_flight_io(int max_requests) const
+{
+  dew_converter_arbiter_set_max_in_flight_io(_handle, max_requests);
+}
+
+inline converter_arbiter_get_stats_result_t converter_arbiter_t::get_stats() const
+{
+  uint32_t sources_out{};
+  uint64_t backlog_bytes_out{};
+  uint64_t gpu_bytes_out{};
+  uint32_t io_in_flight_out{};
+  double min_screen_error_out{};
+  dew_converter_arbiter_get_stats(_handle, &sources_out, &backlog_bytes_out, &gpu_bytes_out, &io_in_flight_out, &min_screen_error_out);
+  return converter_arbiter_get_stats_result_t{sources_out, backlog_bytes_out, gpu_bytes_out, io_in_flight_out, min_screen_error_out};
+}
+
 } // namespace dewpp
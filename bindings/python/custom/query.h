@@ -86,7 +86,7 @@ template <class ClsT> void bind_query_box(ClsT &cls)
   cls.def(
     "query_box",
     [](Holder &self, std::vector<double> aabb_min, std::vector<double> aabb_max, std::optional<std::vector<std::string>> attributes, const std::string &lod, int32_t level, uint64_t max_points,
-       bool clip_points, const std::string &position_format) {
+       bool clip_points, const std::string &position_format, uint64_t seed) {
       if (aabb_min.size() != 3 || aabb_max.size() != 3)
         throw nb::value_error("aabb_min and aabb_max must each have 3 elements");
 
@@ -108,10 +108,13 @@ template <class ClsT> void bind_query_box(ClsT &cls)
         spec.lod_mode = dew_lod_level;
       else if (lod == "budget")
         spec.lod_mode = dew_lod_point_budget;
+      else if (lod == "sample")
+        spec.lod_mode = dew_lod_sample;
       else
-        throw nb::value_error("lod must be one of 'full', 'level', 'budget'");
+        throw nb::value_error("lod must be one of 'full', 'level', 'budget', 'sample'");
       spec.lod = level;
       spec.max_points = max_points;
+      spec.sample_seed = seed;
       spec.attribute_names = name_ptrs.empty() ? nullptr : name_ptrs.data();
       spec.attribute_count = uint32_t(name_ptrs.size());
       if (position_format == "r64")
@@ -190,7 +193,7 @@ template <class ClsT> void bind_query_box(ClsT &cls)
       return out;
     },
     nb::arg("aabb_min"), nb::arg("aabb_max"), nb::arg("attributes") = nb::none(), nb::arg("lod") = "full", nb::arg("level") = 0, nb::arg("max_points") = 0, nb::arg("clip_points") = true,
-    nb::arg("position_format") = "r64",
+    nb::arg("position_format") = "r64", nb::arg("seed") = 0,
     R"doc(Query the points inside an axis-aligned box.
 
 Returns a dict of NumPy arrays: 'xyz' with shape (N, 3) plus one entry per requested
@@ -199,13 +202,143 @@ attribute, along with 'point_count' and 'node_count'.
 aabb_min / aabb_max  the box, in world coordinates (3 elements each)
 attributes           attribute names to fetch alongside the positions, e.g. ["intensity"]
 lod                  'full' for every source point, 'level' to stop at `level`,
-                     'budget' to descend while under `max_points`
+                     'budget' to descend while under `max_points`, 'sample' for exactly
+                     `max_points` points drawn uniformly at random
 clip_points          True returns exactly the points inside the box; False returns whole
                      octree nodes that overlap it, which is faster but overshoots
 position_format      'r64' absolute doubles (lossless), 'r32' or 'i32' relative to each node
+seed                 lod='sample' only: the same seed draws the same sample
 
 The arrays are copies that Python owns; the underlying request is released before returning.
 )doc");
 }
 
+// The message of `error`, which is destroyed; `fallback` when there is none.
+inline std::string take_error_message(dew_error_t *error, const char *fallback)
+{
+  std::string message = fallback;
+  if (error)
+  {
+    int code = 0;
+    const char *msg = nullptr;
+    size_t len = 0;
+    dew_error_get_info(error, &code, &msg, &len);
+    if (len)
+      message.assign(msg, len);
+    dew_error_destroy(error);
+  }
+  return message;
+}
+
+template <typename T> nb::object owned_array(const T *data, size_t rows, size_t columns)
+{
+  const size_t n = rows * columns;
+  auto *owned = new T[n];
+  if (data)
+    memcpy(owned, data, n * sizeof(T));
+  else
+    memset(owned, 0, n * sizeof(T));
+  nb::capsule deleter(owned, [](void *p) noexcept { delete[] static_cast<T *>(p); });
+  size_t shape[2] = {rows, columns};
+  if (columns == 1)
+    return nb::cast(nb::ndarray<nb::numpy, T, nb::ndim<1>>(owned, 1, shape, deleter));
+  return nb::cast(nb::ndarray<nb::numpy, T, nb::ndim<2>>(owned, 2, shape, deleter));
+}
+
+template <class ClsT> void bind_aggregate_box(ClsT &cls)
+{
+  using Holder = typename ClsT::Type;
+  cls.def(
+    "aggregate_box",
+    [](Holder &self, std::vector<double> aabb_min, std::vector<double> aabb_max, std::optional<std::string> attribute, double cell_size, uint32_t bins, std::vector<double> bin_range,
+       bool full_resolution) {
+      if (aabb_min.size() != 3 || aabb_max.size() != 3)
+        throw nb::value_error("aabb_min and aabb_max must each have 3 elements");
+      if (bin_range.size() != 2)
+        throw nb::value_error("bin_range must have 2 elements");
+
+      dew_region_request_t spec{};
+      for (int i = 0; i < 3; i++)
+      {
+        spec.aabb_min[i] = aabb_min[size_t(i)];
+        spec.aabb_max[i] = aabb_max[size_t(i)];
+      }
+      spec.lod_mode = dew_lod_full;
+      dew_aggregate_request_t aggregate{};
+      aggregate.attribute_name = attribute ? attribute->c_str() : nullptr;
+      aggregate.cell_size = cell_size;
+      aggregate.bin_count = bins;
+      aggregate.bin_min = bin_range[0];
+      aggregate.bin_max = bin_range[1];
+      aggregate.full_resolution = full_resolution ? 1 : 0;
+
+      dew_request_t *request = nullptr;
+      dew_request_status_t status = dew_request_failed;
+      std::string failure;
+      {
+        nb::gil_scoped_release release;
+        dew_error_t *error = nullptr;
+        request = dew_dataset_request_aggregate(self.h, &spec, &aggregate, &error);
+        if (request)
+          status = dew_request_wait(request, -1);
+        else
+          failure = take_error_message(error, "aggregate failed");
+      }
+      if (!request)
+        throw std::runtime_error(failure);
+      if (status != dew_request_completed)
+      {
+        dew_error_t *error = nullptr;
+        dew_request_get_error(request, &error);
+        auto message = take_error_message(error, "aggregate did not complete");
+        dew_request_release(request);
+        throw std::runtime_error(message);
+      }
+
+      dew_aggregate_result_t result{};
+      nb::dict out;
+      if (dew_request_get_aggregate(request, &result))
+      {
+        out["point_count"] = result.point_count;
+        out["bounds_min"] = std::vector<double>(result.bounds_min, result.bounds_min + 3);
+        out["bounds_max"] = std::vector<double>(result.bounds_max, result.bounds_max + 3);
+        out["value_min"] = result.value_min;
+        out["value_max"] = result.value_max;
+        out["value_mean"] = result.value_mean;
+        out["used_lod"] = result.used_lod != 0;
+        if (result.grid_width)
+        {
+          // (rows, columns) = (y, x), the usual raster layout.
+          out["grid_origin"] = std::vector<double>(result.grid_origin, result.grid_origin + 2);
+          out["count"] = owned_array(result.cell_count, result.grid_height, result.grid_width);
+          out["min"] = owned_array(result.cell_min, result.grid_height, result.grid_width);
+          out["max"] = owned_array(result.cell_max, result.grid_height, result.grid_width);
+          out["mean"] = owned_array(result.cell_mean, result.grid_height, result.grid_width);
+        }
+        if (result.bin_count)
+        {
+          out["histogram"] = owned_array(result.bins, result.bin_count, 1);
+          out["below_bins"] = result.below_bins;
+          out["above_bins"] = result.above_bins;
+        }
+      }
+      dew_request_release(request);
+      return out;
+    },
+    nb::arg("aabb_min"), nb::arg("aabb_max"), nb::arg("attribute") = nb::none(), nb::arg("cell_size") = 0.0, nb::arg("bins") = 0, nb::arg("bin_range") = std::vector<double>{0.0, 0.0},
+    nb::arg("full_resolution") = false,
+    R"doc(Aggregate the points inside an axis-aligned box without returning them.
+
+Reduces z, or the first component of `attribute`, inside the engine. Always returns
+'point_count', 'bounds_min', 'bounds_max' and 'value_min' / 'value_max' / 'value_mean'.
+
+cell_size        > 0 adds a 2D grid over the box: 'count', 'min', 'max' and 'mean' arrays of
+                 shape (rows, columns), NaN where a cell is empty, and 'grid_origin'
+bins, bin_range  bins > 0 adds a 'histogram' of `bins` bins over bin_range, plus
+                 'below_bins' / 'above_bins' for the values outside it
+full_resolution  False lets sampled LOD nodes stand in when they are already as dense as the
+                 grid ('used_lod' says whether any did); True always reads every point
+)doc");
+}
+
 } // namespace dewpy
@@ -222,7 +222,7 @@ template <class RequestHolder, class ClsT> void bind_query_submit(ClsT &cls)
   cls.def(
     "query_box_submit",
     [](Holder &self, std::vector<double> aabb_min, std::vector<double> aabb_max, std::optional<std::vector<std::string>> attributes, const std::string &lod, int32_t level, uint64_t max_points,
-       bool clip_points, const std::string &position_format) {
+       bool clip_points, const std::string &position_format, uint64_t seed) {
       if (aabb_min.size() != 3 || aabb_max.size() != 3)
         throw nb::value_error("aabb_min and aabb_max must each have 3 elements");
 
@@ -244,10 +244,13 @@ template <class RequestHolder, class ClsT> void bind_query_submit(ClsT &cls)
         spec.lod_mode = dew_lod_level;
       else if (lod == "budget")
         spec.lod_mode = dew_lod_point_budget;
+      else if (lod == "sample")
+        spec.lod_mode = dew_lod_sample;
       else
-        throw nb::value_error("lod must be one of 'full', 'level', 'budget'");
+        throw nb::value_error("lod must be one of 'full', 'level', 'budget', 'sample'");
       spec.lod = level;
       spec.max_points = max_points;
+      spec.sample_seed = seed;
       spec.attribute_names = name_ptrs.empty() ? nullptr : name_ptrs.data();
       spec.attribute_count = uint32_t(name_ptrs.size());
       if (position_format == "r64")
@@ -286,7 +289,7 @@ template <class RequestHolder, class ClsT> void bind_query_submit(ClsT &cls)
       return out;
     },
     nb::arg("aabb_min"), nb::arg("aabb_max"), nb::arg("attributes") = nb::none(), nb::arg("lod") = "full", nb::arg("level") = 0, nb::arg("max_points") = 0, nb::arg("clip_points") = true,
-    nb::arg("position_format") = "r64",
+    nb::arg("position_format") = "r64", nb::arg("seed") = 0,
     R"doc(Submit a box query and return immediately with a Request.
 
 Same arguments as query_box(), but nothing blocks: the request starts on the dataset's own
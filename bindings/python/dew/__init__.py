@@ -82,7 +82,7 @@ def get_cmake_dir() -> str:
     return str(_PACKAGE_DIR / "cmake")
 
 
-def open_dataset(url, connection: str = "", *, pump=None, memory_budget_bytes: int = 0, decode_threads: int = 0, max_reads_in_flight: int = 0):
+def open_dataset(url, connection: str = "", *, pump=None, memory_budget_bytes: int = 0, decode_threads: int = 0, max_reads_in_flight: int = 0, speculative_subtrees: int = 0):
     """Open a converted ``.dew`` dataset for reading.
 
     A thin wrapper over :class:`Dataset` that fills in the options struct, so the common case is
@@ -103,6 +103,7 @@ def open_dataset(url, connection: str = "", *, pump=None, memory_budget_bytes: i
     options.memory_budget_bytes = memory_budget_bytes
     options.decode_threads = decode_threads
     options.max_reads_in_flight = max_reads_in_flight
+    options.speculative_subtrees = speculative_subtrees
     # The generated binding takes a Pump by reference, so make one when the caller did not. nanobind's
     # keep_alive ties it to the dataset, so it outlives every query made through it.
     dataset = Dataset(str(url), connection, options, pump if pump is not None else Pump())  # noqa: F405
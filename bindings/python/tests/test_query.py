@@ -135,6 +135,24 @@ def test_lod_modes_return_a_subsample_not_a_superset(dataset_path):
     assert budget["point_count"] > 0
 
 
+def test_sample_draws_exactly_n_reproducibly(dataset_path):
+    ds = dew.open_dataset(dataset_path)
+    info = ds.get_info()
+    pad = 1.0 + max(hi - lo for lo, hi in zip(info.aabb_min, info.aabb_max))
+    lo = [v - pad for v in info.aabb_min]
+    hi = [v + pad for v in info.aabb_max]
+
+    full = ds.query_box(lo, hi, lod="full")
+    n = min(300, full["point_count"])
+    first = ds.query_box(lo, hi, lod="sample", max_points=n, seed=3)
+    again = ds.query_box(lo, hi, lod="sample", max_points=n, seed=3)
+
+    assert first["point_count"] == n
+    # Without replacement: no point comes back twice.
+    assert len(np.unique(first["xyz"], axis=0)) == n
+    assert np.array_equal(first["xyz"], again["xyz"])
+
+
 def test_position_formats(dataset_path):
     ds = dew.open_dataset(dataset_path)
     info = ds.get_info()
@@ -152,3 +170,27 @@ def test_position_formats(dataset_path):
         ds.query_box(lo, hi, lod="nope")
     with pytest.raises(ValueError):
         ds.query_box([0.0, 0.0], hi)
+
+
+def test_aggregate_box_matches_the_points_it_summarises(dataset_path):
+    ds = dew.open_dataset(dataset_path)
+    info = ds.get_info()
+    lo = list(info.aabb_min)
+    hi = list(info.aabb_max)
+    points = ds.query_box(lo, hi, lod="full", clip_points=True)
+    z = points["xyz"][:, 2]
+
+    cell = max(h - l for l, h in zip(lo, hi)) / 8.0
+    agg = ds.aggregate_box(lo, hi, cell_size=cell, bins=16, bin_range=[float(z.min()), float(z.max())], full_resolution=True)
+
+    # Only the aggregate comes back, and it accounts for every point exactly once.
+    assert agg["point_count"] == points["point_count"]
+    assert int(agg["count"].sum()) == points["point_count"]
+    assert int(agg["histogram"].sum()) + agg["below_bins"] + agg["above_bins"] == points["point_count"]
+    assert agg["value_min"] == pytest.approx(float(z.min()))
+    assert agg["value_max"] == pytest.approx(float(z.max()))
+    assert agg["value_mean"] == pytest.approx(float(z.mean()))
+    assert not agg["used_lod"]
+    empty = agg["count"] == 0
+    assert np.all(np.isnan(agg["mean"][empty]))
+    assert np.all(agg["min"][~empty] <= agg["max"][~empty])
@@ -0,0 +1,208 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+
+#include "aggregate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace dew::access
+{
+
+namespace
+{
+
+constexpr double k_inf = std::numeric_limits<double>::infinity();
+
+template <typename T>
+void gather_values(const uint8_t *data, uint32_t values_per_point, uint32_t point_count, double *out)
+{
+  for (uint32_t i = 0; i < point_count; i++)
+  {
+    T v;
+    memcpy(&v, data + uint64_t(i) * values_per_point * sizeof(T), sizeof(T));
+    out[i] = double(v);
+  }
+}
+
+// The first component of every point, widened to double.
+void gather_first_component(const uint8_t *data, point_format_t format, uint32_t point_count, double *out)
+{
+  const uint32_t values_per_point = format.components == dew_components_4x4 ? 16 : uint32_t(format.components);
+  switch (format.type)
+  {
+  case dew_type_u8: gather_values<uint8_t>(data, values_per_point, point_count, out); break;
+  case dew_type_i8: gather_values<int8_t>(data, values_per_point, point_count, out); break;
+  case dew_type_u16: gather_values<uint16_t>(data, values_per_point, point_count, out); break;
+  case dew_type_i16: gather_values<int16_t>(data, values_per_point, point_count, out); break;
+  case dew_type_u32: gather_values<uint32_t>(data, values_per_point, point_count, out); break;
+  case dew_type_i32: gather_values<int32_t>(data, values_per_point, point_count, out); break;
+  case dew_type_u64: gather_values<uint64_t>(data, values_per_point, point_count, out); break;
+  case dew_type_i64: gather_values<int64_t>(data, values_per_point, point_count, out); break;
+  case dew_type_r32: gather_values<float>(data, values_per_point, point_count, out); break;
+  case dew_type_r64: gather_values<double>(data, values_per_point, point_count, out); break;
+  default: std::fill(out, out + point_count, 0.0); break;
+  }
+}
+
+void size_grid(aggregate_t &out, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+  out.window_x = x;
+  out.window_y = y;
+  out.window_width = width;
+  out.window_height = height;
+  const size_t cells = size_t(width) * height;
+  out.cell_count.assign(cells, 0);
+  out.cell_min.assign(cells, k_inf);
+  out.cell_max.assign(cells, -k_inf);
+  out.cell_sum.assign(cells, 0.0);
+}
+
+// The grid column (or row) `position` falls in, unclamped.
+int64_t cell_index(double position, double origin, double cell_size)
+{
+  return int64_t(std::floor((position - origin) / cell_size));
+}
+
+} // namespace
+
+aggregate_t::aggregate_t()
+  : bounds_min{k_inf, k_inf, k_inf}
+  , bounds_max{-k_inf, -k_inf, -k_inf}
+  , value_min(k_inf)
+  , value_max(-k_inf)
+{
+}
+
+aggregate_t make_aggregate_total(const aggregate_spec_t &spec)
+{
+  aggregate_t out;
+  if (spec.grid)
+    size_grid(out, 0, 0, spec.grid_width, spec.grid_height);
+  out.bins.assign(spec.bin_count, 0);
+  return out;
+}
+
+void aggregate_points(const aggregate_spec_t &spec, const double *xyz, const uint8_t *values, point_format_t value_format, uint32_t point_count, aggregate_t &partial)
+{
+  partial = aggregate_t();
+  if (point_count == 0)
+    return;
+
+  std::vector<double> value(point_count, 0.0);
+  if (spec.value_is_z)
+  {
+    for (uint32_t i = 0; i < point_count; i++)
+      value[i] = xyz[size_t(i) * 3 + 2];
+  }
+  else if (values)
+  {
+    gather_first_component(values, value_format, point_count, value.data());
+  }
+
+  partial.point_count = point_count;
+  for (uint32_t i = 0; i < point_count; i++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      partial.bounds_min[c] = std::min(partial.bounds_min[c], xyz[size_t(i) * 3 + size_t(c)]);
+      partial.bounds_max[c] = std::max(partial.bounds_max[c], xyz[size_t(i) * 3 + size_t(c)]);
+    }
+    partial.value_min = std::min(partial.value_min, value[i]);
+    partial.value_max = std::max(partial.value_max, value[i]);
+    partial.value_sum += value[i];
+  }
+
+  if (spec.bin_count)
+  {
+    partial.bins.assign(spec.bin_count, 0);
+    const double width = (spec.bin_max - spec.bin_min) / double(spec.bin_count);
+    for (uint32_t i = 0; i < point_count; i++)
+    {
+      const double v = value[i];
+      if (v < spec.bin_min)
+        partial.below_bins++;
+      else if (v > spec.bin_max)
+        partial.above_bins++;
+      else
+        partial.bins[std::min<size_t>(size_t((v - spec.bin_min) / width), spec.bin_count - 1)]++;
+    }
+  }
+
+  if (!spec.grid)
+    return;
+  // Only the window of cells this node's points can reach; the bounds were just computed.
+  const int64_t width = spec.grid_width;
+  const int64_t height = spec.grid_height;
+  const int64_t x0 = std::max<int64_t>(0, cell_index(partial.bounds_min[0], spec.grid_origin[0], spec.cell_size));
+  const int64_t y0 = std::max<int64_t>(0, cell_index(partial.bounds_min[1], spec.grid_origin[1], spec.cell_size));
+  const int64_t x1 = std::min<int64_t>(width - 1, cell_index(partial.bounds_max[0], spec.grid_origin[0], spec.cell_size));
+  const int64_t y1 = std::min<int64_t>(height - 1, cell_index(partial.bounds_max[1], spec.grid_origin[1], spec.cell_size));
+  if (x0 > x1 || y0 > y1)
+    return;
+  size_grid(partial, uint32_t(x0), uint32_t(y0), uint32_t(x1 - x0 + 1), uint32_t(y1 - y0 + 1));
+  for (uint32_t i = 0; i < point_count; i++)
+  {
+    const int64_t cx = cell_index(xyz[size_t(i) * 3], spec.grid_origin[0], spec.cell_size);
+    const int64_t cy = cell_index(xyz[size_t(i) * 3 + 1], spec.grid_origin[1], spec.cell_size);
+    if (cx < x0 || cx > x1 || cy < y0 || cy > y1)
+      continue;
+    const size_t cell = size_t(cy - y0) * partial.window_width + size_t(cx - x0);
+    partial.cell_count[cell]++;
+    partial.cell_min[cell] = std::min(partial.cell_min[cell], value[i]);
+    partial.cell_max[cell] = std::max(partial.cell_max[cell], value[i]);
+    partial.cell_sum[cell] += value[i];
+  }
+}
+
+void aggregate_merge(const aggregate_t &partial, aggregate_t &total)
+{
+  if (partial.point_count == 0)
+    return;
+  total.point_count += partial.point_count;
+  for (int c = 0; c < 3; c++)
+  {
+    total.bounds_min[c] = std::min(total.bounds_min[c], partial.bounds_min[c]);
+    total.bounds_max[c] = std::max(total.bounds_max[c], partial.bounds_max[c]);
+  }
+  total.value_min = std::min(total.value_min, partial.value_min);
+  total.value_max = std::max(total.value_max, partial.value_max);
+  total.value_sum += partial.value_sum;
+
+  for (size_t b = 0; b < partial.bins.size() && b < total.bins.size(); b++)
+    total.bins[b] += partial.bins[b];
+  total.below_bins += partial.below_bins;
+  total.above_bins += partial.above_bins;
+
+  for (uint32_t row = 0; row < partial.window_height; row++)
+  {
+    const size_t from = size_t(row) * partial.window_width;
+    const size_t to = size_t(partial.window_y + row - total.window_y) * total.window_width + (partial.window_x - total.window_x);
+    for (uint32_t col = 0; col < partial.window_width; col++)
+    {
+      total.cell_count[to + col] += partial.cell_count[from + col];
+      total.cell_min[to + col] = std::min(total.cell_min[to + col], partial.cell_min[from + col]);
+      total.cell_max[to + col] = std::max(total.cell_max[to + col], partial.cell_max[from + col]);
+      total.cell_sum[to + col] += partial.cell_sum[from + col];
+    }
+  }
+}
+
+} // namespace dew::access
@@ -0,0 +1,90 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+
+#pragma once
+
+// In-engine reductions for aggregate requests: a 2D grid of min / max / mean / count of one value, a
+// histogram of it, and the bounds of the points it came from. Each decoded node is reduced on its own
+// into a small partial -- its grid is only the window of cells the node's points land in -- and the
+// partials are folded into the request's total in walk order, so the result does not depend on how
+// the decode threads were scheduled.
+
+#include "dataset_types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace dew::access
+{
+using namespace dew::core;
+
+// What an aggregate request reduces, copied out of dew_aggregate_request_t. The value is z, or the
+// first component of one attribute.
+struct aggregate_spec_t
+{
+  bool value_is_z = true;
+  bool grid = false;
+  double grid_origin[2] = {0, 0};
+  double cell_size = 0;
+  uint32_t grid_width = 0;
+  uint32_t grid_height = 0;
+  uint32_t bin_count = 0;
+  double bin_min = 0;
+  double bin_max = 0;
+};
+
+// A partial or a total. The grid arrays cover the window [window_x, window_x + window_width) x
+// [window_y, window_y + window_height) of the full grid, row-major; a total's window is the full grid.
+struct aggregate_t
+{
+  uint64_t point_count = 0;
+  double bounds_min[3];
+  double bounds_max[3];
+  double value_min;
+  double value_max;
+  double value_sum = 0;
+
+  uint32_t window_x = 0;
+  uint32_t window_y = 0;
+  uint32_t window_width = 0;
+  uint32_t window_height = 0;
+  std::vector<uint64_t> cell_count;
+  std::vector<double> cell_min;
+  std::vector<double> cell_max;
+  std::vector<double> cell_sum;
+
+  std::vector<uint64_t> bins;
+  uint64_t below_bins = 0;
+  uint64_t above_bins = 0;
+
+  aggregate_t();
+};
+
+// An empty total: the full grid and every bin, all zero.
+aggregate_t make_aggregate_total(const aggregate_spec_t &spec);
+
+// Reduce `point_count` points into `partial`, which is reset first. `xyz` is double[3] world positions;
+// `values` holds the value attribute in `value_format`, or is null when the value is z or the node
+// lacks the attribute (which then reads as zero, as it does everywhere else). Points outside the grid
+// still count towards the bounds and the histogram.
+void aggregate_points(const aggregate_spec_t &spec, const double *xyz, const uint8_t *values, point_format_t value_format, uint32_t point_count, aggregate_t &partial);
+
+// Fold `partial` into `total` (from make_aggregate_total).
+void aggregate_merge(const aggregate_t &partial, aggregate_t &total);
+
+} // namespace dew::access
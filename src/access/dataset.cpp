@@ -47,6 +47,7 @@ dataset_impl_t::dataset_impl_t(std::string a_url, std::string a_connection, cons
   // How many blob reads may be in flight at once. This is what turns a query over a high-latency
   // store from N round trips into roughly N/max_reads_in_flight.
   max_reads_in_flight = options.max_reads_in_flight ? options.max_reads_in_flight : uint32_t(std::max(1, budgets.io_clamp));
+  speculative_subtrees = options.speculative_subtrees;
 
   reader = std::make_unique<blob_reader_t>(url, connection, pool, perf, storage_error, error);
   if (error.code != 0)
@@ -132,6 +133,12 @@ vio::task_t<void> dataset_impl_t::co_open()
   // and the synchronous node accessors -- depend on that invariant holding.
   registry_size_at_open = registry().data.size();
 
+  // One read for the top of the octree when the dataset carries a hierarchy directory. Advisory: a
+  // directory that cannot be read leaves its trees to load on demand, exactly as without one.
+  {
+    dew_error_t directory_error;
+    co_await trees->load_directory(directory_error);
+  }
   if (!co_await trees->load(trees->root(), error))
   {
     set_state(dew_dataset_error);
@@ -209,24 +216,101 @@ void dataset_impl_t::on_storage_error(const dew_error_t &&e)
 
 // Walk, load whatever sub-trees the walk asked for, walk again. The walk itself never reads storage,
 // so this loop is the only place a region query blocks.
-vio::task_t<bool> dataset_impl_t::co_walk_to_convergence(const region_query_t &query, region_result_t &out)
+vio::task_t<bool> dataset_impl_t::co_walk_to_convergence(const region_query_t &query, region_result_t &out, dew_request_stats_t &stats)
 {
+  auto &loop = loop_thread.event_loop();
+  std::vector<std::pair<tree_id_t, std::shared_ptr<read_request_t>>> loads;
   constexpr int max_rounds = 64;
+  using clock = std::chrono::steady_clock;
+  auto ms_since = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
   for (int round = 0; round < max_rounds; round++)
   {
+    const auto walk_start = clock::now();
     region_walk(registry(), query, out);
+    stats.walk_ms += ms_since(walk_start);
+    stats.walk_rounds++;
+    stats.nodes_walked += out.visited_nodes;
     if (out.trees_to_load.empty())
       co_return true;
+
+    // Every tree the round needs goes out before any is awaited; one at a time would pay the full
+    // latency per tree instead of per round.
+    dew_error_t load_error;
+    loads.clear();
     for (auto id : out.trees_to_load)
     {
-      if (!co_await trees->load(id, error))
-        co_return false;
+      auto read = trees->begin_load(id, load_error);
+      if (load_error.code != 0)
+        break;
+      if (read)
+        loads.emplace_back(id, std::move(read));
+    }
+    bool waited = false;
+    const auto wait_start = clock::now();
+    stats.peak_reads_in_flight = std::max(stats.peak_reads_in_flight, uint32_t(loads.size()));
+    for (auto &[id, read] : loads)
+    {
+      waited = waited || !read->is_done();
+      co_await read->await_on(loop);
+    }
+    stats.io_wait_ms += ms_since(wait_start);
+    if (waited)
+      stats.round_trips++;
+    // Installed even after a failure: every begun load has to be finished exactly once.
+    for (auto &[id, read] : loads)
+    {
+      dew_error_t install_error;
+      if (!trees->finish_load(id, *read, install_error) && load_error.code == 0)
+        load_error = install_error;
+    }
+    stats.trees_loaded += uint32_t(loads.size());
+    if (load_error.code != 0)
+    {
+      error = load_error;
+      co_return false;
     }
   }
   error = {1, "region walk did not converge"};
   co_return false;
 }
 
+void dataset_impl_t::record_request_stats(const dew_request_stats_t &stats)
+{
+  std::unique_lock<std::mutex> lock(stats_mutex);
+  finished_requests++;
+  auto &t = request_totals;
+  t.walk_rounds += stats.walk_rounds;
+  t.trees_loaded += stats.trees_loaded;
+  t.speculative_trees += stats.speculative_trees;
+  t.round_trips += stats.round_trips;
+  t.time_to_first_blob_ms += stats.time_to_first_blob_ms;
+  t.total_ms += stats.total_ms;
+  t.nodes_walked += stats.nodes_walked;
+  t.nodes_read += stats.nodes_read;
+  t.blobs_read += stats.blobs_read;
+  t.cache_hits += stats.cache_hits;
+  t.peak_reads_in_flight = std::max(t.peak_reads_in_flight, stats.peak_reads_in_flight);
+  t.bytes_compressed += stats.bytes_compressed;
+  t.bytes_decompressed += stats.bytes_decompressed;
+  t.walk_ms += stats.walk_ms;
+  t.io_wait_ms += stats.io_wait_ms;
+  t.decode_ms += stats.decode_ms;
+  t.clip_ms += stats.clip_ms;
+  t.append_ms += stats.append_ms;
+}
+
+void dataset_impl_t::get_stats(dew_dataset_stats_t &out)
+{
+  {
+    std::unique_lock<std::mutex> lock(stats_mutex);
+    out.requests = finished_requests;
+    out.totals = request_totals;
+  }
+  out.peak_storage_reads_in_flight = reader ? uint32_t(reader->peak_reads_in_flight()) : 0;
+  out.cache_hits = perf.cache_hits.load(std::memory_order_relaxed);
+  out.cache_misses = perf.cache_misses.load(std::memory_order_relaxed);
+}
+
 void dataset_impl_t::info(dew_dataset_info_t &out) const
 {
   memset(&out, 0, sizeof(out));
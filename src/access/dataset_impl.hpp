@@ -19,6 +19,7 @@
 
 #include <dew/access/query.h>
 
+#include "aggregate.hpp"
 #include "attributes_configs.hpp"
 #include "blob_reader.hpp"
 #include "budget.hpp"
@@ -49,14 +50,32 @@ struct request_impl_t;
 // call returns.
 struct region_job_t
 {
-  double box_min[3] = {0, 0, 0};
-  double box_max[3] = {0, 0, 0};
+  // One area per region; a batch from dew_dataset_request_regions has several, sharing everything else.
+  std::vector<region_area_t> areas;
   dew_lod_mode_t lod_mode = dew_lod_full;
   int32_t lod = 0;
   uint64_t max_points = 0;
+  uint64_t sample_seed = 0; // dew_lod_sample
   std::vector<std::string> attribute_names;
   dew_position_format_t position_format = dew_position_r64_absolute;
   dew_clip_mode_t clip_mode = dew_clip_point;
+  std::vector<attribute_predicate_t> predicates;
+  // lod_mode::spacing instead of full resolution when > 0: an aggregate grid letting sampled nodes
+  // stand in for what is below them.
+  double max_spacing = 0;
+  // An aggregate request reduces its points rather than returning them.
+  bool aggregate = false;
+  aggregate_spec_t aggregate_spec;
+};
+
+// A point search's parameters, copied out of the caller's dew_search_request_t.
+struct search_job_t
+{
+  bool knn = true;                  // false: every point within `radius`
+  std::vector<double> query_points; // x,y,z per query point
+  uint32_t k = 0;
+  double radius = 0; // knn: a cap on the distance when > 0
+  std::vector<std::string> attribute_names;
 };
 
 
@@ -69,13 +88,19 @@ struct dataset_impl_t
   // Nothing on the query path may block: under wasm a blocking read stalls the whole program, and
   // natively it would tie up the dataset loop that other requests run on. Tree loading itself lives
   // in dew::core::tree_set_t, shared with the renderer's frame-driven path.
-  vio::task_t<bool> co_walk_to_convergence(const region_query_t &query, region_result_t &out);
+  // Loads every sub-tree a round needs concurrently; the rounds themselves are still sequential.
+  vio::task_t<bool> co_walk_to_convergence(const region_query_t &query, region_result_t &out, dew_request_stats_t &stats);
   // The deferred open: index, attribute configs, tree registry, root tree. Ends in ready or error.
   vio::task_t<void> co_open();
   // Spawn a region request on the dataset's own loop. Returns immediately; the request reaches a
   // terminal status later and is published through the pump.
   void spawn_region_request(region_job_t job, std::shared_ptr<struct dew_request_t> request);
+  // The same for a kNN or radius search.
+  void spawn_search_request(search_job_t job, std::shared_ptr<struct dew_request_t> request);
   void info(dew_dataset_info_t &out) const;
+  // Add a finished request's stats to the dataset's totals. Any thread.
+  void record_request_stats(const dew_request_stats_t &stats);
+  void get_stats(dew_dataset_stats_t &out);
 
   // Queue a finished request for delivery and raise the pump. Called from whichever thread completed
   // the work; the callback itself runs later, on the host thread, from the pump's drain.
@@ -92,6 +117,7 @@ struct dataset_impl_t
   perf_stats_t perf;
   derived_budgets_t budgets;
   uint32_t max_reads_in_flight = 16;
+  uint32_t speculative_subtrees = 0;
   std::unique_ptr<blob_reader_t> reader;
   attributes_configs_t attributes;
   std::unique_ptr<tree_set_t> trees;
@@ -110,12 +136,27 @@ struct dataset_impl_t
   // handle, but the work may still be running and must not be destroyed under itself.
   std::vector<std::shared_ptr<struct dew_request_t>> requests;
 
+  // dew_dataset_get_stats: every finished request's stats, added up.
+  std::mutex stats_mutex;
+  uint64_t finished_requests = 0;
+  dew_request_stats_t request_totals{};
+
   dew_pump_t *pump = nullptr;
   bool owns_pump = false;
   std::mutex dispatch_mutex;
   std::vector<std::shared_ptr<struct dew_request_t>> awaiting_dispatch;
 };
 
+// Count one issued point or attribute blob read into a request's stats. Its decompressed size is
+// only known once it lands.
+inline void count_blob_read(dew_request_stats_t &stats, const storage_location_t &location, const read_request_t &read)
+{
+  stats.blobs_read++;
+  stats.bytes_compressed += location.size;
+  if (read.cache_hit)
+    stats.cache_hits++;
+}
+
 // One attribute's concatenated output buffer.
 struct out_buffer_t
 {
@@ -126,12 +167,23 @@ struct out_buffer_t
   std::vector<uint8_t> data;
 };
 
+// One region's result: buffer 0 is the positions, requested attributes follow.
+struct region_output_t
+{
+  std::vector<out_buffer_t> buffers;
+  std::vector<dew_result_node_t> nodes;
+  uint64_t point_count = 0;
+
+  // Views handed out by dew_request_get_result; kept alive by `buffers` until release.
+  std::vector<dew_attribute_buffer_t> buffer_views;
+};
+
 struct request_impl_t
 {
   void cancel();
-  // Mark terminal and wake anyone in dew_request_wait. Called once, from the thread that finished
-  // the work.
-  void finish(dew_request_status_t terminal);
+  // Mark terminal, publish the final stats and wake anyone in dew_request_wait. Called once, from the
+  // thread that finished the work.
+  void finish(dew_request_status_t terminal, const dew_request_stats_t &final_stats);
   // Exactly-once guard shared by the pump drain and dew_request_wait -- either may get there first.
   bool claim_callback() { return !callback_fired.exchange(true, std::memory_order_acq_rel); }
 
@@ -143,13 +195,31 @@ struct request_impl_t
   std::atomic<bool> callback_fired{false};
   std::mutex wait_mutex;
   std::condition_variable wait_cond;
-
-  std::vector<out_buffer_t> buffers;
-  std::vector<dew_result_node_t> nodes;
-  uint64_t point_count = 0;
-
-  // Views handed out by dew_request_get_result; kept alive by `buffers` until release.
-  std::vector<dew_attribute_buffer_t> buffer_views;
+  // Published by finish(), under wait_mutex: a cancel makes the status terminal while the work may
+  // still be running, so the status alone cannot say the numbers are final.
+  dew_request_stats_t stats{};
+  bool stats_ready = false;
+
+  // One per region, in the order the regions were given.
+  std::vector<region_output_t> regions;
+
+  // dew_dataset_request_aggregate only. The views are the finished grid statistics (NaN where a cell
+  // is empty), built by dew_request_get_aggregate and kept alive until release.
+  bool is_aggregate = false;
+  aggregate_spec_t aggregate_spec;
+  aggregate_t aggregate;
+  bool aggregate_used_lod = false;
+  std::vector<double> cell_min_view;
+  std::vector<double> cell_max_view;
+  std::vector<double> cell_mean_view;
+
+  // dew_dataset_request_knn / _radius only. Query q's neighbours are entries [search_offsets[q],
+  // search_offsets[q + 1]) of search_indices (into regions[0]'s points) and search_distances, nearest
+  // first.
+  bool is_search = false;
+  std::vector<uint64_t> search_offsets;
+  std::vector<uint64_t> search_indices;
+  std::vector<double> search_distances;
 };
 
 } // namespace dew::access
@@ -21,7 +21,9 @@
 #include "format_util.hpp"
 #include "morton_tree_coordinate_transform.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 namespace dew::access
 {
@@ -107,47 +109,77 @@ bool decode_positions(const void *morton_data, uint32_t data_size, uint32_t poin
   return true;
 }
 
-uint32_t clip_to_box(void *positions, position_format_t format, const double origin[3], double scale, uint32_t point_count, const double box_min[3], const double box_max[3], attribute_span_t *attributes, uint32_t attribute_count)
+namespace
 {
-  const uint32_t stride = position_stride(format);
-  auto *bytes = static_cast<uint8_t *>(positions);
 
-  auto world_at = [&](uint32_t i, double out[3]) {
-    switch (format)
-    {
-    case position_format_t::r64_absolute:
-    {
-      const auto *p = reinterpret_cast<const double *>(bytes + uint64_t(i) * stride);
-      out[0] = p[0]; out[1] = p[1]; out[2] = p[2];
-      break;
-    }
-    case position_format_t::r32_relative:
-    {
-      const auto *p = reinterpret_cast<const float *>(bytes + uint64_t(i) * stride);
-      for (int c = 0; c < 3; c++)
-        out[c] = origin[c] + double(p[c]);
-      break;
-    }
-    case position_format_t::i32_grid:
+void world_position(const uint8_t *bytes, uint32_t stride, position_format_t format, const double origin[3], double scale, uint32_t i, double out[3])
+{
+  switch (format)
+  {
+  case position_format_t::r64_absolute:
+  {
+    const auto *p = reinterpret_cast<const double *>(bytes + uint64_t(i) * stride);
+    out[0] = p[0]; out[1] = p[1]; out[2] = p[2];
+    break;
+  }
+  case position_format_t::r32_relative:
+  {
+    const auto *p = reinterpret_cast<const float *>(bytes + uint64_t(i) * stride);
+    for (int c = 0; c < 3; c++)
+      out[c] = origin[c] + double(p[c]);
+    break;
+  }
+  case position_format_t::i32_grid:
+  {
+    // i32 values are GRID STEPS relative to the node origin, while the caller's box is in world
+    // units -- so they have to be scaled before the comparison, not just offset.
+    const auto *p = reinterpret_cast<const int32_t *>(bytes + uint64_t(i) * stride);
+    for (int c = 0; c < 3; c++)
+      out[c] = origin[c] + double(p[c]) * scale;
+    break;
+  }
+  }
+}
+
+// Move every point whose mask byte is set to the front, positions and attributes in step.
+uint32_t compact_by_mask(const uint8_t *mask, uint8_t *positions, uint32_t stride, uint32_t point_count, attribute_span_t *attributes, uint32_t attribute_count)
+{
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < point_count; i++)
+  {
+    if (!mask[i])
+      continue;
+    if (kept != i)
     {
-      // i32 values are GRID STEPS relative to the node origin, while the caller's box is in world
-      // units -- so they have to be scaled before the comparison, not just offset.
-      const auto *p = reinterpret_cast<const int32_t *>(bytes + uint64_t(i) * stride);
-      for (int c = 0; c < 3; c++)
-        out[c] = origin[c] + double(p[c]) * scale;
-      break;
-    }
+      memcpy(positions + uint64_t(kept) * stride, positions + uint64_t(i) * stride, stride);
+      for (uint32_t a = 0; a < attribute_count; a++)
+      {
+        auto &span = attributes[a];
+        if (!span.data || span.stride == 0)
+          continue;
+        memcpy(span.data + uint64_t(kept) * span.stride, span.data + uint64_t(i) * span.stride, span.stride);
+      }
     }
-  };
+    kept++;
+  }
+  return kept;
+}
+
+} // namespace
+
+uint32_t clip_to_box(void *positions, position_format_t format, const double origin[3], double scale, uint32_t point_count, const double box_min[3], const double box_max[3], attribute_span_t *attributes, uint32_t attribute_count)
+{
+  const uint32_t stride = position_stride(format);
+  auto *bytes = static_cast<uint8_t *>(positions);
 
   uint32_t kept = 0;
   for (uint32_t i = 0; i < point_count; i++)
   {
-    // Zero-initialised, not merely assigned by world_at: that switch has no default, so a format
+    // Zero-initialised, not merely assigned by world_position: that switch has no default, so a format
     // outside the enum would leave this unwritten and the comparison below would read rubbish.
     // GCC 14 spots it (-Werror=maybe-uninitialized) where clang does not.
     double p[3] = {};
-    world_at(i, p);
+    world_position(bytes, stride, format, origin, scale, i, p);
     if (p[0] < box_min[0] || p[0] > box_max[0] || p[1] < box_min[1] || p[1] > box_max[1] || p[2] < box_min[2] || p[2] > box_max[2])
       continue;
     if (kept != i)
@@ -166,4 +198,222 @@ uint32_t clip_to_box(void *positions, position_format_t format, const double ori
   return kept;
 }
 
+bool predicate_accepts(const attribute_predicate_t &predicate, double value)
+{
+  switch (predicate.op)
+  {
+  case predicate_op_t::range:
+    return value >= predicate.min && value <= predicate.max;
+  case predicate_op_t::in:
+    return std::find(predicate.values.begin(), predicate.values.end(), value) != predicate.values.end();
+  case predicate_op_t::not_in:
+    return std::find(predicate.values.begin(), predicate.values.end(), value) == predicate.values.end();
+  }
+  return true;
+}
+
+namespace
+{
+
+// AND one range predicate into `mask`. Branch-free over the column so it vectorises.
+template <typename T>
+void mask_range(const uint8_t *data, uint32_t values_per_point, uint32_t point_count, double lo, double hi, uint8_t *mask)
+{
+  for (uint32_t i = 0; i < point_count; i++)
+  {
+    uint8_t pass = 1;
+    for (uint32_t c = 0; c < values_per_point; c++)
+    {
+      T v;
+      memcpy(&v, data + (uint64_t(i) * values_per_point + c) * sizeof(T), sizeof(T));
+      pass &= uint8_t(double(v) >= lo) & uint8_t(double(v) <= hi);
+    }
+    mask[i] &= pass;
+  }
+}
+
+// AND one set predicate into `mask`. Byte-wide types go through a 256-entry table; wider ones search
+// the sorted value list.
+template <typename T>
+void mask_set(const uint8_t *data, uint32_t values_per_point, uint32_t point_count, const attribute_predicate_t &predicate, uint8_t *mask)
+{
+  const bool want = predicate.op == predicate_op_t::in;
+  if constexpr (sizeof(T) == 1)
+  {
+    uint8_t table[256];
+    for (int b = 0; b < 256; b++)
+    {
+      T v;
+      const auto byte = uint8_t(b);
+      memcpy(&v, &byte, 1);
+      table[b] = predicate_accepts(predicate, double(v)) ? 1 : 0;
+    }
+    for (uint32_t i = 0; i < point_count; i++)
+    {
+      uint8_t pass = 1;
+      for (uint32_t c = 0; c < values_per_point; c++)
+        pass &= table[data[uint64_t(i) * values_per_point + c]];
+      mask[i] &= pass;
+    }
+  }
+  else
+  {
+    std::vector<double> sorted = predicate.values;
+    std::sort(sorted.begin(), sorted.end());
+    for (uint32_t i = 0; i < point_count; i++)
+    {
+      if (!mask[i])
+        continue;
+      uint8_t pass = 1;
+      for (uint32_t c = 0; c < values_per_point && pass; c++)
+      {
+        T v;
+        memcpy(&v, data + (uint64_t(i) * values_per_point + c) * sizeof(T), sizeof(T));
+        pass = std::binary_search(sorted.begin(), sorted.end(), double(v)) == want ? 1 : 0;
+      }
+      mask[i] = pass;
+    }
+  }
+}
+
+template <typename T>
+void mask_predicate(const predicate_input_t &input, uint32_t values_per_point, uint32_t point_count, uint8_t *mask)
+{
+  if (input.predicate->op == predicate_op_t::range)
+    mask_range<T>(input.data, values_per_point, point_count, input.predicate->min, input.predicate->max, mask);
+  else
+    mask_set<T>(input.data, values_per_point, point_count, *input.predicate, mask);
+}
+
+} // namespace
+
+uint32_t filter_by_predicates(const predicate_input_t *predicates, uint32_t predicate_count, void *positions, uint32_t position_stride, uint32_t point_count, attribute_span_t *attributes,
+                              uint32_t attribute_count)
+{
+  std::vector<uint8_t> mask(point_count, uint8_t(1));
+  for (uint32_t p = 0; p < predicate_count; p++)
+  {
+    const auto &input = predicates[p];
+    if (!input.data)
+    {
+      if (!predicate_accepts(*input.predicate, 0.0))
+        return 0;
+      continue;
+    }
+    const uint32_t values_per_point = input.format.components == dew_components_4x4 ? 16 : uint32_t(input.format.components);
+    switch (input.format.type)
+    {
+    case dew_type_u8: mask_predicate<uint8_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_i8: mask_predicate<int8_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_u16: mask_predicate<uint16_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_i16: mask_predicate<int16_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_u32: mask_predicate<uint32_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_i32: mask_predicate<int32_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_u64: mask_predicate<uint64_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_i64: mask_predicate<int64_t>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_r32: mask_predicate<float>(input, values_per_point, point_count, mask.data()); break;
+    case dew_type_r64: mask_predicate<double>(input, values_per_point, point_count, mask.data()); break;
+    default: break;
+    }
+  }
+
+  return compact_by_mask(mask.data(), static_cast<uint8_t *>(positions), position_stride, point_count, attributes, attribute_count);
+}
+
+uint32_t clip_to_geometry(void *positions, position_format_t format, const double origin[3], double scale, uint32_t point_count, const query_geometry_t &geometry, attribute_span_t *attributes,
+                          uint32_t attribute_count)
+{
+  if (geometry.kind == geometry_kind_t::box || point_count == 0)
+    return point_count;
+  const uint32_t stride = position_stride(format);
+  auto *bytes = static_cast<uint8_t *>(positions);
+
+  // World-space columns, so every test below is a straight loop over contiguous doubles.
+  std::vector<double> xs(point_count);
+  std::vector<double> ys(point_count);
+  std::vector<double> zs(point_count);
+  for (uint32_t i = 0; i < point_count; i++)
+  {
+    double p[3] = {};
+    world_position(bytes, stride, format, origin, scale, i, p);
+    xs[i] = p[0];
+    ys[i] = p[1];
+    zs[i] = p[2];
+  }
+  const double *x = xs.data();
+  const double *y = ys.data();
+  const double *z = zs.data();
+
+  std::vector<uint8_t> mask(point_count, uint8_t(1));
+  uint8_t *m = mask.data();
+  const uint32_t vertex_count = uint32_t(geometry.vertices.size() / 2);
+  const double *v = geometry.vertices.data();
+
+  if (geometry.kind != geometry_kind_t::frustum && geometry.z_min < geometry.z_max)
+  {
+    const double z_min = geometry.z_min;
+    const double z_max = geometry.z_max;
+    for (uint32_t i = 0; i < point_count; i++)
+      m[i] &= uint8_t(z[i] >= z_min) & uint8_t(z[i] <= z_max);
+  }
+
+  switch (geometry.kind)
+  {
+  case geometry_kind_t::box:
+    break;
+  case geometry_kind_t::polygon_prism:
+  {
+    // Even-odd rule, one edge at a time: each edge flips the points whose rightward ray it crosses.
+    std::vector<uint8_t> inside(point_count, uint8_t(0));
+    uint8_t *in = inside.data();
+    for (uint32_t e = 0; e < vertex_count; e++)
+    {
+      const uint32_t n = e + 1 == vertex_count ? 0 : e + 1;
+      const double xi = v[e * 2], yi = v[e * 2 + 1];
+      const double xj = v[n * 2], yj = v[n * 2 + 1];
+      const double slope = yj != yi ? (xj - xi) / (yj - yi) : 0.0;
+      for (uint32_t i = 0; i < point_count; i++)
+        in[i] ^= uint8_t((yi > y[i]) != (yj > y[i])) & uint8_t(x[i] < (y[i] - yi) * slope + xi);
+    }
+    for (uint32_t i = 0; i < point_count; i++)
+      m[i] &= in[i];
+    break;
+  }
+  case geometry_kind_t::corridor:
+  {
+    // Inside when within `radius` of ANY segment: the squared distance to each segment, min-reduced.
+    std::vector<double> nearest(point_count, std::numeric_limits<double>::max());
+    double *d = nearest.data();
+    for (uint32_t s = 0; s + 1 < vertex_count; s++)
+    {
+      const double ax = v[s * 2], ay = v[s * 2 + 1];
+      const double dx = v[s * 2 + 2] - ax, dy = v[s * 2 + 3] - ay;
+      const double length2 = dx * dx + dy * dy;
+      const double inv_length2 = length2 > 0 ? 1.0 / length2 : 0.0;
+      for (uint32_t i = 0; i < point_count; i++)
+      {
+        const double t = std::clamp(((x[i] - ax) * dx + (y[i] - ay) * dy) * inv_length2, 0.0, 1.0);
+        const double ex = x[i] - (ax + t * dx);
+        const double ey = y[i] - (ay + t * dy);
+        d[i] = std::min(d[i], ex * ex + ey * ey);
+      }
+    }
+    const double radius2 = geometry.radius * geometry.radius;
+    for (uint32_t i = 0; i < point_count; i++)
+      m[i] &= uint8_t(d[i] <= radius2);
+    break;
+  }
+  case geometry_kind_t::frustum:
+    for (const auto &plane : geometry.planes)
+    {
+      const double a = plane[0], b = plane[1], c = plane[2], w = plane[3];
+      for (uint32_t i = 0; i < point_count; i++)
+        m[i] &= uint8_t(a * x[i] + b * y[i] + c * z[i] + w >= 0.0);
+    }
+    break;
+  }
+
+  return compact_by_mask(m, bytes, stride, point_count, attributes, attribute_count);
+}
+
 } // namespace dew::access
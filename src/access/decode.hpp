@@ -28,6 +28,7 @@
 #include "dataset_types.hpp"
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace dew::access
@@ -78,4 +79,74 @@ struct attribute_span_t
 // world space needs it. It is ignored for the other two formats.
 uint32_t clip_to_box(void *positions, position_format_t format, const double origin[3], double scale, uint32_t point_count, const double box_min[3], const double box_max[3], attribute_span_t *attributes, uint32_t attribute_count);
 
+// A query region other than a plain box, in world units. The query's box still applies on top (it
+// is what the walk tests first); the geometry narrows it.
+//  - polygon_prism: a simple polygon in XY (`vertices`, x,y pairs, implicitly closed) extruded over
+//    [z_min, z_max];
+//  - corridor: every point within `radius` in XY of the polyline `vertices`, over [z_min, z_max];
+//  - frustum: the intersection of six half-spaces a*x + b*y + c*z + d >= 0 (`planes`).
+// z_min >= z_max leaves z unbounded.
+enum class geometry_kind_t
+{
+  box,
+  polygon_prism,
+  corridor,
+  frustum,
+};
+
+struct query_geometry_t
+{
+  geometry_kind_t kind = geometry_kind_t::box;
+  std::vector<double> vertices;
+  double z_min = 0;
+  double z_max = 0;
+  double radius = 0;
+  double planes[6][4] = {};
+};
+
+// Keep only the points inside `geometry`, compacting like clip_to_box. The positions are gathered
+// into world-space columns once, then each polygon edge, corridor segment or frustum plane is tested
+// against the whole column in a branch-free loop the compiler vectorises. A box geometry keeps
+// everything.
+uint32_t clip_to_geometry(void *positions, position_format_t format, const double origin[3], double scale, uint32_t point_count, const query_geometry_t &geometry, attribute_span_t *attributes,
+                          uint32_t attribute_count);
+
+// An attribute predicate, as the query carries it. A point passes when EVERY component of the
+// attribute does: range wants min <= v <= max, in wants v to be one of `values`, not_in wants it to
+// be none of them. A node that lacks the attribute reads as zeros, in the filter as in the output.
+enum class predicate_op_t
+{
+  range,
+  in,
+  not_in,
+};
+
+struct attribute_predicate_t
+{
+  std::string attribute_name;
+  predicate_op_t op = predicate_op_t::range;
+  double min = 0;
+  double max = 0;
+  std::vector<double> values;
+};
+
+// Whether a single value passes, the scalar form of what filter_by_predicates tests per point.
+bool predicate_accepts(const attribute_predicate_t &predicate, double value);
+
+// One predicate bound to one node's decoded attribute: `data` holds point_count values of `format`,
+// or is null when the node lacks the attribute.
+struct predicate_input_t
+{
+  const attribute_predicate_t *predicate;
+  const uint8_t *data;
+  point_format_t format;
+};
+
+// Keep only the points that pass every predicate, compacting positions and attribute buffers in step
+// like clip_to_box. The predicates are evaluated a whole column at a time into a byte mask -- one
+// tight, type-specialised loop per predicate that the compiler vectorises -- before a single
+// compaction pass. Returns the surviving count.
+uint32_t filter_by_predicates(const predicate_input_t *predicates, uint32_t predicate_count, void *positions, uint32_t position_stride, uint32_t point_count, attribute_span_t *attributes,
+                              uint32_t attribute_count);
+
 } // namespace dew::access
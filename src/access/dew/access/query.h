@@ -89,12 +89,22 @@ enum dew_request_status_t
  *
  * IMPORTANT: LOD nodes hold SUBSAMPLED COPIES of their descendants, not a partition of them. Every
  * mode returns exactly one frontier -- never a node and its ancestor -- because unioning levels
- * would double-count by 2-3x while still looking plausible. */
+ * would double-count by 2-3x while still looking plausible.
+ *
+ * dew_lod_sample: a uniform random sample of the region, without replacement -- for training sets,
+ * where dew_lod_point_budget's frontier of whole nodes would spend the budget on whichever branches
+ * happen to be descended first. Each node's share of `max_points` follows the points it holds in
+ * the region, and a sampled LOD node is read instead of the full resolution below it wherever it is
+ * dense enough to supply that share, so only the sparse parts of the sample pay for leaf reads.
+ * Returns exactly `max_points` points when the region holds that many after clipping and
+ * predicates, all of them otherwise. Exact to the region only with dew_clip_point. A single region
+ * only: not for batches or aggregates. */
 enum dew_lod_mode_t
 {
-  dew_lod_full,        /* descend to the leaves: full resolution, source points only */
-  dew_lod_level,       /* stop at `lod` (larger = coarser) and return that frontier */
-  dew_lod_point_budget /* descend while the running total stays under `max_points` */
+  dew_lod_full,         /* descend to the leaves: full resolution, source points only */
+  dew_lod_level,        /* stop at `lod` (larger = coarser) and return that frontier */
+  dew_lod_point_budget, /* descend while the running total stays under `max_points` */
+  dew_lod_sample        /* exactly `max_points` points drawn at random, spatially uniform; above */
 };
 
 enum dew_clip_mode_t
@@ -122,6 +132,10 @@ struct dew_dataset_options_t
    * from N round trips into roughly N/this. A target rather than a cap: one node's blobs are always
    * issued together, so the floor is 1 + the number of attributes requested. 0 = derived. */
   uint32_t max_reads_in_flight;
+  /* Sub-trees a request may prefetch beyond what it needs: siblings of the ones it descends into,
+   * which is what a neighbouring query most often wants next. They load in the background into the
+   * dataset's resident set and never delay the request itself. 0 = none. */
+  uint32_t speculative_subtrees;
 };
 
 /* Returns immediately with the dataset in `opening`; `error` is only set for arguments that cannot
@@ -180,6 +194,56 @@ DEW_ACCESS_EXPORT uint32_t dew_dataset_attribute_count(struct dew_dataset_t *dat
 //= out_string: name[name_buffer_size]
 DEW_ACCESS_EXPORT uint32_t dew_dataset_get_attribute_name(struct dew_dataset_t *dataset, uint32_t index, char *name, uint32_t name_buffer_size);
 
+enum dew_predicate_op_t
+{
+  dew_predicate_range, /* min <= value <= max */
+  dew_predicate_in,    /* value is one of `values` */
+  dew_predicate_not_in /* value is none of `values` */
+};
+
+/* A filter on one attribute's values. A point passes when every component of the attribute does; a
+ * node that lacks the attribute reads as zeros, exactly as in the returned buffers.
+ *
+ * Predicates are pushed down: each stored node records per-attribute zone maps (the value range, and
+ * for single-byte attributes such as classification the exact set of values present), so nodes and
+ * whole subtrees that cannot match are skipped without being read. Datasets converted before zone
+ * maps existed are still filtered correctly, just without the skipping. */
+//= py.skip
+struct dew_attribute_predicate_t
+{
+  const char *attribute_name; /* NUL-terminated */
+  enum dew_predicate_op_t op;
+  double min;
+  double max;
+  //= arrays: values[value_count]
+  const double *values;
+  uint32_t value_count;
+};
+
+enum dew_region_shape_t
+{
+  dew_region_box,      /* the aabb alone */
+  dew_region_polygon,  /* a vertical prism: polygon in x/y, optionally limited to z_min..z_max */
+  dew_region_corridor, /* everything within `radius` (in x/y) of a polyline, optionally z-limited */
+  dew_region_frustum   /* the intersection of six half-spaces */
+};
+
+/* A shape the region is clipped to on top of its aabb. Nodes are tested against it conservatively,
+ * so whole subtrees outside it are never read; points are clipped exactly when clip_mode is
+ * dew_clip_point. When the request's aabb is empty, a polygon or corridor supplies its own bounds. */
+//= py.skip
+struct dew_region_geometry_t
+{
+  enum dew_region_shape_t shape;
+  //= arrays: vertices[vertex_count]
+  const double *vertices; /* x,y pairs, world units; the polygon closes itself */
+  uint32_t vertex_count;  /* number of x,y pairs */
+  double z_min;           /* z_min >= z_max leaves z unbounded */
+  double z_max;
+  double radius;          /* corridor half-width */
+  double planes[6][4];    /* frustum: inside where a*x + b*y + c*z + d >= 0 for every plane */
+};
+
 //= py.skip
 struct dew_region_request_t
 {
@@ -195,6 +259,11 @@ struct dew_region_request_t
   enum dew_clip_mode_t clip_mode;
   dew_request_done_callback_t done;
   void *done_user_ptr;
+  //= arrays: predicates[predicate_count]
+  const struct dew_attribute_predicate_t *predicates; /* all must pass; NULL/0 = no filter */
+  uint32_t predicate_count;
+  const struct dew_region_geometry_t *geometry; /* NULL = the aabb alone */
+  uint64_t sample_seed;                         /* dew_lod_sample: the same seed draws the same sample */
 };
 
 /* Returns a new request; release it with dew_request_release.
@@ -205,6 +274,139 @@ struct dew_region_request_t
 //= bind: skip
 DEW_ACCESS_EXPORT struct dew_request_t *dew_dataset_request_region(struct dew_dataset_t *dataset, const struct dew_region_request_t *request, struct dew_error_t **error);
 
+/* One region of a batch. An empty aabb means the whole dataset, or a polygon's or corridor's own
+ * extent, exactly as in dew_region_request_t. */
+//= py.skip
+struct dew_region_t
+{
+  double aabb_min[3];
+  double aabb_max[3];
+  const struct dew_region_geometry_t *geometry; /* NULL = the aabb alone */
+};
+
+/* Many regions in ONE request -- for tile servers and data loaders that ask for hundreds of
+ * neighbouring areas at once. The union of the regions is walked once and every node in it is read
+ * and decoded once, however many regions share it; its points are then clipped per region and
+ * scattered into per-region results. max_reads_in_flight applies to the batch as a whole.
+ *
+ * Everything except the area comes from `request` (whose own aabb and geometry are ignored). Read
+ * the results with dew_request_region_count and dew_request_get_region_result; region i's result
+ * is what dew_dataset_request_region would have returned for that region alone -- except under
+ * dew_lod_point_budget, where the budget covers the union and each region gets its share of it.
+ *
+ * bind: skip for the same reason as dew_dataset_request_region. */
+//= bind: skip
+DEW_ACCESS_EXPORT struct dew_request_t *dew_dataset_request_regions(struct dew_dataset_t *dataset, const struct dew_region_request_t *request, const struct dew_region_t *regions, uint32_t region_count,
+                                                                    struct dew_error_t **error);
+
+/* An aggregation over a region: the points are decoded and reduced inside the engine and only the
+ * compact aggregate comes back -- for DEMs, density maps and class histograms without pulling every
+ * point out. The value reduced is z, or the first component of `attribute_name`.
+ *
+ * Any combination of the three outputs: the bounds and value statistics always, a 2D grid over the
+ * region's x/y when cell_size > 0 (the region must then be bounded: an aabb, or a polygon/corridor),
+ * and a histogram when bin_count > 0. Bin i covers [bin_min + i*w, bin_min + (i+1)*w) with
+ * w = (bin_max - bin_min) / bin_count, the last bin also taking bin_max; one bin per class of a u8
+ * attribute is bin_min 0, bin_max 256, bin_count 256.
+ *
+ * With a grid and dew_lod_full, nodes whose sampled points are already as dense as the grid stand in
+ * for the full resolution below them unless full_resolution is set; counts are then of the samples. */
+//= py.skip
+struct dew_aggregate_request_t
+{
+  const char *attribute_name; /* NUL-terminated; NULL = z */
+  double cell_size;           /* grid cell edge in world units; 0 = no grid */
+  uint32_t bin_count;         /* 0 = no histogram */
+  double bin_min;
+  double bin_max;
+  uint8_t full_resolution; /* 1 = never substitute sampled LOD nodes */
+};
+
+/* Grid arrays are row-major, grid_width * grid_height cells, row 0 at grid_origin's y. An empty cell
+ * has count 0 and NaN min / max / mean. Pointers stay valid until dew_request_release. */
+//= py.skip
+struct dew_aggregate_result_t
+{
+  uint64_t point_count;
+  double bounds_min[3];
+  double bounds_max[3];
+  double value_min;
+  double value_max;
+  double value_mean;
+  uint32_t grid_width;
+  uint32_t grid_height;
+  double grid_origin[2];
+  double cell_size;
+  const uint64_t *cell_count;
+  const double *cell_min;
+  const double *cell_max;
+  const double *cell_mean;
+  //= arrays: bins[bin_count]
+  const uint64_t *bins;
+  uint32_t bin_count;
+  uint64_t below_bins; /* values under bin_min */
+  uint64_t above_bins; /* values over bin_max */
+  uint8_t used_lod;    /* 1 when sampled LOD nodes stood in for full resolution */
+};
+
+/* Everything but the attributes, position format and clip mode comes from `request`: the area,
+ * geometry, LOD and predicates. Points are always clipped exactly. Read the result with
+ * dew_request_get_aggregate; dew_request_get_result reports no points for an aggregate request.
+ *
+ * bind: skip for the same reason as dew_dataset_request_region. */
+//= bind: skip
+DEW_ACCESS_EXPORT struct dew_request_t *dew_dataset_request_aggregate(struct dew_dataset_t *dataset, const struct dew_region_request_t *request, const struct dew_aggregate_request_t *aggregate,
+                                                                      struct dew_error_t **error);
+
+/* A point search around a batch of query points, at full resolution. The nodes are visited nearest
+ * first per query point and read only when some query point reaches them; a node read for one query
+ * point is decoded once and reused by every other, so a batch of neighbouring seeds costs little more
+ * than one. The same holds for the octree's sub-trees: one is loaded only when some query point's
+ * descent reaches it, so even a knn search without a radius cap loads the hierarchy around its seeds,
+ * never the whole of it. Decoded nodes are kept within the dataset's memory budget: past it, one that
+ * no unfinished query point still needs is dropped. Query points must be finite.
+ *
+ * The result is every neighbour found, once, in the ordinary point buffers (dew_request_get_result:
+ * r64 absolute positions plus the requested attributes, no nodes), and per query point the indices
+ * of its neighbours into those buffers with their distances (dew_request_get_search). */
+//= py.skip
+struct dew_search_request_t
+{
+  const double *query_points; /* x,y,z per query point, world units */
+  uint32_t query_count;
+  uint32_t k;    /* knn: neighbours per query point */
+  double radius; /* radius: the search radius; knn: a cap on the distance, 0 = none */
+  //= arrays: attribute_names[attribute_count]
+  const char *const *attribute_names;
+  uint32_t attribute_count;
+  dew_request_done_callback_t done;
+  void *done_user_ptr;
+};
+
+/* The k nearest points to each query point, fewer where the dataset (or the radius cap) runs out.
+ * Equidistant points are ordered by where they are stored, so the answer is the same on every run.
+ *
+ * bind: skip for the same reason as dew_dataset_request_region. */
+//= bind: skip
+DEW_ACCESS_EXPORT struct dew_request_t *dew_dataset_request_knn(struct dew_dataset_t *dataset, const struct dew_search_request_t *request, struct dew_error_t **error);
+/* Every point within `radius` of each query point. */
+//= bind: skip
+DEW_ACCESS_EXPORT struct dew_request_t *dew_dataset_request_radius(struct dew_dataset_t *dataset, const struct dew_search_request_t *request, struct dew_error_t **error);
+
+/* Query point q's neighbours are entries offsets[q] .. offsets[q + 1] of indices and distances,
+ * nearest first. Pointers stay valid until dew_request_release. */
+//= py.skip
+struct dew_search_result_t
+{
+  uint32_t query_count;
+  const uint64_t *offsets; /* query_count + 1 entries */
+  //= arrays: indices[neighbour_count]
+  const uint64_t *indices; /* into the points of dew_request_get_result */
+  //= arrays: distances[neighbour_count]
+  const double *distances;
+  uint64_t neighbour_count;
+};
+
 //= py.skip
 DEW_ACCESS_EXPORT enum dew_request_status_t dew_request_status(struct dew_request_t *request);
 //= blocking
@@ -219,6 +421,61 @@ DEW_ACCESS_EXPORT void dew_request_release(struct dew_request_t *request);
 //= py.skip
 DEW_ACCESS_EXPORT float dew_request_completion_factor(struct dew_request_t *request);
 
+/* How a request went. Region requests descend each branch as soon as its sub-tree lands and read
+ * point blobs for finished nodes while other sub-trees are still loading, so on a high-latency
+ * store the interesting numbers are how soon the first point blob went out and how many times the
+ * request had nothing left to do but wait.
+ *
+ * The rest is for tuning a dataset's options: peak_reads_in_flight against max_reads_in_flight,
+ * decode_ms and clip_ms against decode_threads, cache_hits against memory_budget_bytes. The times
+ * are wall time on the request's own thread and roughly add up to total_ms; decoding and clipping
+ * share the pool, so their phase is split between the two by the thread time each took. */
+//= py.skip
+struct dew_request_stats_t
+{
+  uint32_t walk_rounds;          /* walks: the first, plus one per sub-tree descended into (or per
+                                    full re-walk, for a point-budget request) */
+  uint32_t trees_loaded;         /* sub-trees this request read */
+  uint32_t speculative_trees;    /* sibling sub-trees it asked to prefetch */
+  uint32_t round_trips;          /* times it waited on storage with nothing else in hand */
+  double time_to_first_blob_ms;  /* from start to the first point blob read being issued */
+  double total_ms;               /* from start to terminal */
+  uint32_t nodes_walked;         /* octree nodes its walks looked at, over every walk */
+  uint32_t nodes_read;           /* storage units whose points it read */
+  uint32_t blobs_read;           /* point and attribute blobs it read; sub-trees are trees_loaded */
+  uint32_t cache_hits;           /* of those, served from the dataset's cache without a storage read */
+  uint32_t peak_reads_in_flight; /* most reads, blobs and sub-trees, it had outstanding at once */
+  uint64_t bytes_compressed;     /* blob bytes as stored */
+  uint64_t bytes_decompressed;   /* the same blobs, decompressed */
+  double walk_ms;                /* selecting nodes */
+  double io_wait_ms;             /* waiting on storage with nothing else in hand */
+  double decode_ms;              /* decoding positions, copying attributes and predicates */
+  double clip_ms;                /* clipping points to the region */
+  double append_ms;              /* placing nodes in the output, compacting it and drawing samples */
+};
+
+/* Fills `out` once the request's work has stopped; returns 0 before that. A canceled request turns
+ * terminal at once but may still be winding down, so its stats can lag its status briefly. */
+//= py.skip
+DEW_ACCESS_EXPORT uint8_t dew_request_get_stats(struct dew_request_t *request, struct dew_request_stats_t *out);
+
+/* Every request a dataset has finished, added up -- what a service polls to see how its settings
+ * are doing under real traffic. In `totals` counts, bytes and times are summed (divide by
+ * `requests` for a mean) and peak_reads_in_flight is the highest any one request reached. */
+//= py.skip
+struct dew_dataset_stats_t
+{
+  uint64_t requests; /* requests whose work has stopped, however they ended */
+  struct dew_request_stats_t totals;
+  /* Storage reads in flight at once across every request and sub-tree load together: what
+   * max_reads_in_flight actually achieved. Cache hits never count. */
+  uint32_t peak_storage_reads_in_flight;
+  uint64_t cache_hits;   /* every read the dataset's cache served, trees included */
+  uint64_t cache_misses; /* and every one it sent to storage */
+};
+//= py.skip
+DEW_ACCESS_EXPORT void dew_dataset_get_stats(struct dew_dataset_t *dataset, struct dew_dataset_stats_t *out);
+
 /* One attribute's contiguous buffer, concatenated across every node in the result. Buffer 0 is
  * always the positions and is never named in attribute_names; requested attributes start at 1. */
 //= py.skip
@@ -260,8 +517,21 @@ struct dew_request_result_t
   uint32_t node_count;
 };
 
+/* The result of a single-region request, or of region 0 of a batch. dew_request_attribute_size and
+ * dew_request_copy_attribute likewise address region 0. */
 //= py.skip
 DEW_ACCESS_EXPORT uint8_t dew_request_get_result(struct dew_request_t *request, struct dew_request_result_t *out);
+/* How many per-region results a completed request holds: 1 for dew_dataset_request_region. */
+//= py.skip
+DEW_ACCESS_EXPORT uint32_t dew_request_region_count(struct dew_request_t *request);
+//= py.skip
+DEW_ACCESS_EXPORT uint8_t dew_request_get_region_result(struct dew_request_t *request, uint32_t region, struct dew_request_result_t *out);
+/* The aggregate of a completed dew_dataset_request_aggregate request; 0 for any other request. */
+//= py.skip
+DEW_ACCESS_EXPORT uint8_t dew_request_get_aggregate(struct dew_request_t *request, struct dew_aggregate_result_t *out);
+/* The neighbours of a completed kNN or radius request; 0 for any other request. */
+//= py.skip
+DEW_ACCESS_EXPORT uint8_t dew_request_get_search(struct dew_request_t *request, struct dew_search_result_t *out);
 //= py.skip
 DEW_ACCESS_EXPORT uint64_t dew_request_attribute_size(struct dew_request_t *request, uint32_t attribute_index);
 //= arrays: dst[dst_bytes]
@@ -21,8 +21,11 @@
 
 #include "dataset_impl.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstring>
+#include <limits>
 
 using namespace dew::access;
 
@@ -124,40 +127,183 @@ uint32_t dew_dataset_get_attribute_name(struct dew_dataset_t *dataset, uint32_t
   return dataset->attributes.attrib_name_registry_get(index, name, name_buffer_size);
 }
 
-struct dew_request_t *dew_dataset_request_region(struct dew_dataset_t *dataset, const struct dew_region_request_t *spec, struct dew_error_t **error)
+namespace
+{
+
+bool check_submittable(struct dew_dataset_t *dataset, const struct dew_region_request_t *spec, struct dew_error_t **error)
 {
   if (!dataset || !spec)
   {
     fill_error(error, {1, "null dataset or request"});
-    return nullptr;
+    return false;
   }
   if (dataset->state.load(std::memory_order_acquire) != dew_dataset_ready)
   {
     fill_error(error, dataset->error.code ? dataset->error : dew_error_t{1, "dataset is not ready"});
-    return nullptr;
+    return false;
   }
 
-  auto request = std::make_shared<dew_request_t>();
-  request->dataset = dataset;
-  request->done = spec->done;
-  request->done_user_ptr = spec->done_user_ptr;
+  if (spec->lod_mode == dew_lod_sample && spec->max_points == 0)
+  {
+    fill_error(error, {1, "dew_lod_sample needs max_points > 0"});
+    return false;
+  }
 
-  // Copy everything out of the caller's struct before returning: the request outlives this call, and
-  // attribute_names points at memory the caller may free the moment we return.
-  region_job_t job;
+  for (uint32_t p = 0; p < spec->predicate_count; p++)
+  {
+    if (!spec->predicates || !spec->predicates[p].attribute_name)
+    {
+      fill_error(error, {1, "predicate without an attribute name"});
+      return false;
+    }
+    if (spec->predicates[p].op != dew_predicate_range && spec->predicates[p].value_count && !spec->predicates[p].values)
+    {
+      fill_error(error, {1, "predicate values missing"});
+      return false;
+    }
+  }
+  return true;
+}
+
+bool check_geometry(const struct dew_region_geometry_t *geometry, struct dew_error_t **error)
+{
+  if (!geometry)
+    return true;
+  if ((geometry->shape == dew_region_polygon || geometry->shape == dew_region_corridor) && geometry->vertex_count && !geometry->vertices)
+  {
+    fill_error(error, {1, "region geometry vertices missing"});
+    return false;
+  }
+  if (geometry->shape == dew_region_polygon && geometry->vertex_count < 3)
+  {
+    fill_error(error, {1, "a region polygon needs at least three vertices"});
+    return false;
+  }
+  if (geometry->shape == dew_region_corridor && (geometry->vertex_count < 2 || !(geometry->radius >= 0)))
+  {
+    fill_error(error, {1, "a region corridor needs at least two vertices and a non-negative radius"});
+    return false;
+  }
+  return true;
+}
+
+// Copy one caller area. An empty box is the whole dataset -- unless a polygon or corridor can supply
+// its own extent, which then bounds the walk instead of leaving the box test pruning nothing.
+region_area_t make_area(const double aabb_min[3], const double aabb_max[3], const struct dew_region_geometry_t *geometry)
+{
+  region_area_t area;
   for (int i = 0; i < 3; i++)
   {
-    job.box_min[i] = spec->aabb_min[i];
-    job.box_max[i] = spec->aabb_max[i];
+    area.box.min[i] = aabb_min[i];
+    area.box.max[i] = aabb_max[i];
+  }
+  if (geometry)
+  {
+    auto &out = area.geometry;
+    switch (geometry->shape)
+    {
+    case dew_region_polygon:
+      out.kind = geometry_kind_t::polygon_prism;
+      break;
+    case dew_region_corridor:
+      out.kind = geometry_kind_t::corridor;
+      break;
+    case dew_region_frustum:
+      out.kind = geometry_kind_t::frustum;
+      break;
+    case dew_region_box:
+    default:
+      out.kind = geometry_kind_t::box;
+      break;
+    }
+    if (out.kind == geometry_kind_t::polygon_prism || out.kind == geometry_kind_t::corridor)
+      out.vertices.assign(geometry->vertices, geometry->vertices + size_t(geometry->vertex_count) * 2);
+    out.z_min = geometry->z_min;
+    out.z_max = geometry->z_max;
+    out.radius = geometry->radius;
+    memcpy(out.planes, geometry->planes, sizeof(out.planes));
+  }
+
+  auto &box = area.box;
+  const bool box_empty = box.min[0] >= box.max[0] && box.min[1] >= box.max[1] && box.min[2] >= box.max[2];
+  if (box_empty && !area.geometry.vertices.empty())
+  {
+    const auto &out = area.geometry;
+    const double pad = out.kind == geometry_kind_t::corridor ? out.radius : 0.0;
+    for (int i = 0; i < 2; i++)
+    {
+      box.min[i] = std::numeric_limits<double>::max();
+      box.max[i] = std::numeric_limits<double>::lowest();
+    }
+    for (size_t v = 0; v + 1 < out.vertices.size(); v += 2)
+    {
+      for (int i = 0; i < 2; i++)
+      {
+        box.min[i] = std::min(box.min[i], out.vertices[v + size_t(i)] - pad);
+        box.max[i] = std::max(box.max[i], out.vertices[v + size_t(i)] + pad);
+      }
+    }
+    const bool z_bounded = out.z_min < out.z_max;
+    box.min[2] = z_bounded ? out.z_min : std::numeric_limits<double>::lowest();
+    box.max[2] = z_bounded ? out.z_max : std::numeric_limits<double>::max();
+  }
+  else
+  {
+    area.whole_dataset = box_empty;
   }
+  return area;
+}
+
+// Copy everything out of the caller's struct before returning: the request outlives this call, and
+// attribute_names points at memory the caller may free the moment we return.
+region_job_t make_region_job(const struct dew_region_request_t *spec, std::vector<region_area_t> areas)
+{
+  region_job_t job;
+  job.areas = std::move(areas);
   job.lod_mode = spec->lod_mode;
   job.lod = spec->lod;
   job.max_points = spec->max_points;
+  job.sample_seed = spec->sample_seed;
   job.position_format = spec->position_format;
   job.clip_mode = spec->clip_mode;
   job.attribute_names.reserve(spec->attribute_count);
   for (uint32_t a = 0; a < spec->attribute_count; a++)
     job.attribute_names.emplace_back(spec->attribute_names && spec->attribute_names[a] ? spec->attribute_names[a] : "");
+  job.predicates.resize(spec->predicate_count);
+  for (uint32_t p = 0; p < spec->predicate_count; p++)
+  {
+    const auto &in = spec->predicates[p];
+    auto &out = job.predicates[p];
+    out.attribute_name = in.attribute_name;
+    switch (in.op)
+    {
+    case dew_predicate_in:
+      out.op = predicate_op_t::in;
+      break;
+    case dew_predicate_not_in:
+      out.op = predicate_op_t::not_in;
+      break;
+    case dew_predicate_range:
+    default:
+      out.op = predicate_op_t::range;
+      break;
+    }
+    out.min = in.min;
+    out.max = in.max;
+    if (in.op != dew_predicate_range)
+      out.values.assign(in.values, in.values + in.value_count);
+  }
+  return job;
+}
+
+struct dew_request_t *submit_region_job(struct dew_dataset_t *dataset, const struct dew_region_request_t *spec, region_job_t job)
+{
+  auto request = std::make_shared<dew_request_t>();
+  request->dataset = dataset;
+  request->done = spec->done;
+  request->done_user_ptr = spec->done_user_ptr;
+  request->is_aggregate = job.aggregate;
+  request->aggregate_spec = job.aggregate_spec;
 
   dataset->requests.push_back(request);
   // Runs on the dataset's loop; the caller's thread is not blocked and the request is genuinely
@@ -166,6 +312,179 @@ struct dew_request_t *dew_dataset_request_region(struct dew_dataset_t *dataset,
   return request.get();
 }
 
+struct dew_request_t *submit_search_job(struct dew_dataset_t *dataset, const struct dew_search_request_t *spec, bool knn, struct dew_error_t **error)
+{
+  if (!dataset || !spec)
+  {
+    fill_error(error, {1, "null dataset or request"});
+    return nullptr;
+  }
+  if (dataset->state.load(std::memory_order_acquire) != dew_dataset_ready)
+  {
+    fill_error(error, dataset->error.code ? dataset->error : dew_error_t{1, "dataset is not ready"});
+    return nullptr;
+  }
+  if (!spec->query_points || spec->query_count == 0)
+  {
+    fill_error(error, {1, "a search needs at least one query point"});
+    return nullptr;
+  }
+  // A NaN distance is never past any bound, so such a query would read the whole dataset.
+  for (size_t i = 0; i < size_t(spec->query_count) * 3; i++)
+  {
+    if (!std::isfinite(spec->query_points[i]))
+    {
+      fill_error(error, {1, "search query points must be finite"});
+      return nullptr;
+    }
+  }
+  if (knn && spec->k == 0)
+  {
+    fill_error(error, {1, "a knn search needs k > 0"});
+    return nullptr;
+  }
+  if (!(spec->radius >= 0) || (!knn && !(spec->radius > 0)))
+  {
+    fill_error(error, {1, "a radius search needs a positive radius"});
+    return nullptr;
+  }
+
+  search_job_t job;
+  job.knn = knn;
+  job.query_points.assign(spec->query_points, spec->query_points + size_t(spec->query_count) * 3);
+  job.k = spec->k;
+  job.radius = spec->radius;
+  job.attribute_names.reserve(spec->attribute_count);
+  for (uint32_t a = 0; a < spec->attribute_count; a++)
+    job.attribute_names.emplace_back(spec->attribute_names && spec->attribute_names[a] ? spec->attribute_names[a] : "");
+
+  auto request = std::make_shared<dew_request_t>();
+  request->dataset = dataset;
+  request->done = spec->done;
+  request->done_user_ptr = spec->done_user_ptr;
+  request->is_search = true;
+  dataset->requests.push_back(request);
+  dataset->spawn_search_request(std::move(job), request);
+  return request.get();
+}
+
+} // namespace
+
+struct dew_request_t *dew_dataset_request_region(struct dew_dataset_t *dataset, const struct dew_region_request_t *spec, struct dew_error_t **error)
+{
+  if (!check_submittable(dataset, spec, error) || !check_geometry(spec->geometry, error))
+    return nullptr;
+  std::vector<region_area_t> areas;
+  areas.push_back(make_area(spec->aabb_min, spec->aabb_max, spec->geometry));
+  return submit_region_job(dataset, spec, make_region_job(spec, std::move(areas)));
+}
+
+struct dew_request_t *dew_dataset_request_regions(struct dew_dataset_t *dataset, const struct dew_region_request_t *spec, const struct dew_region_t *regions, uint32_t region_count, struct dew_error_t **error)
+{
+  if (!check_submittable(dataset, spec, error))
+    return nullptr;
+  if (!regions || region_count == 0)
+  {
+    fill_error(error, {1, "a region batch needs at least one region"});
+    return nullptr;
+  }
+  if (spec->lod_mode == dew_lod_sample)
+  {
+    fill_error(error, {1, "dew_lod_sample takes a single region"});
+    return nullptr;
+  }
+  std::vector<region_area_t> areas;
+  areas.reserve(region_count);
+  for (uint32_t r = 0; r < region_count; r++)
+  {
+    if (!check_geometry(regions[r].geometry, error))
+      return nullptr;
+    areas.push_back(make_area(regions[r].aabb_min, regions[r].aabb_max, regions[r].geometry));
+  }
+  return submit_region_job(dataset, spec, make_region_job(spec, std::move(areas)));
+}
+
+struct dew_request_t *dew_dataset_request_aggregate(struct dew_dataset_t *dataset, const struct dew_region_request_t *spec, const struct dew_aggregate_request_t *aggregate, struct dew_error_t **error)
+{
+  if (!check_submittable(dataset, spec, error) || !check_geometry(spec->geometry, error))
+    return nullptr;
+  if (!aggregate)
+  {
+    fill_error(error, {1, "null aggregate"});
+    return nullptr;
+  }
+  if (spec->lod_mode == dew_lod_sample)
+  {
+    fill_error(error, {1, "dew_lod_sample returns points and cannot be aggregated"});
+    return nullptr;
+  }
+  if (!(aggregate->cell_size >= 0))
+  {
+    fill_error(error, {1, "an aggregate grid needs a non-negative cell size"});
+    return nullptr;
+  }
+  if (aggregate->bin_count && !(aggregate->bin_max > aggregate->bin_min))
+  {
+    fill_error(error, {1, "an aggregate histogram needs bin_max > bin_min"});
+    return nullptr;
+  }
+
+  std::vector<region_area_t> areas;
+  areas.push_back(make_area(spec->aabb_min, spec->aabb_max, spec->geometry));
+  auto job = make_region_job(spec, std::move(areas));
+  // The reduction reads world-space doubles and exactly the points inside the area, whatever the
+  // caller's struct says; the one attribute it needs is the value.
+  job.attribute_names.clear();
+  if (aggregate->attribute_name)
+    job.attribute_names.emplace_back(aggregate->attribute_name);
+  job.position_format = dew_position_r64_absolute;
+  job.clip_mode = dew_clip_point;
+  job.aggregate = true;
+
+  auto &out = job.aggregate_spec;
+  out.value_is_z = aggregate->attribute_name == nullptr;
+  if (aggregate->cell_size > 0)
+  {
+    const auto &box = job.areas[0].box;
+    if (job.areas[0].whole_dataset || !std::isfinite(box.min[0]) || !std::isfinite(box.min[1]) || !std::isfinite(box.max[0]) || !std::isfinite(box.max[1]))
+    {
+      fill_error(error, {1, "an aggregate grid needs a bounded region"});
+      return nullptr;
+    }
+    // +1 so a point on the far edge of the area still has a cell.
+    const double width = std::floor((box.max[0] - box.min[0]) / aggregate->cell_size) + 1;
+    const double height = std::floor((box.max[1] - box.min[1]) / aggregate->cell_size) + 1;
+    constexpr double max_cells = double(1u << 24);
+    if (width * height > max_cells)
+    {
+      fill_error(error, {1, "an aggregate grid may have at most 16M cells"});
+      return nullptr;
+    }
+    out.grid = true;
+    out.grid_origin[0] = box.min[0];
+    out.grid_origin[1] = box.min[1];
+    out.cell_size = aggregate->cell_size;
+    out.grid_width = uint32_t(width);
+    out.grid_height = uint32_t(height);
+    if (spec->lod_mode == dew_lod_full && !aggregate->full_resolution)
+      job.max_spacing = aggregate->cell_size;
+  }
+  out.bin_count = aggregate->bin_count;
+  out.bin_min = aggregate->bin_min;
+  out.bin_max = aggregate->bin_max;
+  return submit_region_job(dataset, spec, std::move(job));
+}
+
+struct dew_request_t *dew_dataset_request_knn(struct dew_dataset_t *dataset, const struct dew_search_request_t *spec, struct dew_error_t **error)
+{
+  return submit_search_job(dataset, spec, true, error);
+}
+
+struct dew_request_t *dew_dataset_request_radius(struct dew_dataset_t *dataset, const struct dew_search_request_t *spec, struct dew_error_t **error)
+{
+  return submit_search_job(dataset, spec, false, error);
+}
+
 enum dew_request_status_t dew_request_status(struct dew_request_t *request)
 {
   return request ? request->status.load(std::memory_order_acquire) : dew_request_failed;
@@ -216,6 +535,25 @@ float dew_request_completion_factor(struct dew_request_t *request)
   return request->status.load(std::memory_order_acquire) == dew_request_pending ? 0.0f : 1.0f;
 }
 
+uint8_t dew_request_get_stats(struct dew_request_t *request, struct dew_request_stats_t *out)
+{
+  if (!request || !out)
+    return 0;
+  std::unique_lock<std::mutex> lock(request->wait_mutex);
+  if (!request->stats_ready)
+    return 0;
+  *out = request->stats;
+  return 1;
+}
+
+void dew_dataset_get_stats(struct dew_dataset_t *dataset, struct dew_dataset_stats_t *out)
+{
+  if (!dataset || !out)
+    return;
+  *out = {};
+  dataset->get_stats(*out);
+}
+
 void dew_request_release(struct dew_request_t *request)
 {
   if (!request)
@@ -250,16 +588,26 @@ void dew_request_release(struct dew_request_t *request)
   }
 }
 
-uint8_t dew_request_get_result(struct dew_request_t *request, struct dew_request_result_t *out)
+uint32_t dew_request_region_count(struct dew_request_t *request)
+{
+  if (!request || request->status.load(std::memory_order_acquire) != dew_request_completed)
+    return 0;
+  return uint32_t(request->regions.size());
+}
+
+uint8_t dew_request_get_region_result(struct dew_request_t *request, uint32_t region, struct dew_request_result_t *out)
 {
   if (!request || !out)
     return 0;
   if (request->status.load(std::memory_order_acquire) != dew_request_completed)
     return 0;
+  if (region >= request->regions.size())
+    return 0;
 
-  request->buffer_views.clear();
-  request->buffer_views.reserve(request->buffers.size());
-  for (auto &buffer : request->buffers)
+  auto &output = request->regions[region];
+  output.buffer_views.clear();
+  output.buffer_views.reserve(output.buffers.size());
+  for (auto &buffer : output.buffers)
   {
     dew_attribute_buffer_t view{};
     view.name = buffer.name.c_str();
@@ -268,32 +616,109 @@ uint8_t dew_request_get_result(struct dew_request_t *request, struct dew_request
     view.components = buffer.components;
     view.data = buffer.data.data();
     view.size_bytes = buffer.data.size();
-    request->buffer_views.push_back(view);
+    output.buffer_views.push_back(view);
+  }
+
+  out->point_count = output.point_count;
+  out->buffers = output.buffer_views.data();
+  out->buffer_count = uint32_t(output.buffer_views.size());
+  out->nodes = output.nodes.data();
+  out->node_count = uint32_t(output.nodes.size());
+  return 1;
+}
+
+uint8_t dew_request_get_result(struct dew_request_t *request, struct dew_request_result_t *out)
+{
+  return dew_request_get_region_result(request, 0, out);
+}
+
+uint8_t dew_request_get_aggregate(struct dew_request_t *request, struct dew_aggregate_result_t *out)
+{
+  if (!request || !out)
+    return 0;
+  if (request->status.load(std::memory_order_acquire) != dew_request_completed || !request->is_aggregate)
+    return 0;
+
+  const auto &spec = request->aggregate_spec;
+  const auto &total = request->aggregate;
+  *out = dew_aggregate_result_t{};
+  out->point_count = total.point_count;
+  if (total.point_count)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      out->bounds_min[i] = total.bounds_min[i];
+      out->bounds_max[i] = total.bounds_max[i];
+    }
+    out->value_min = total.value_min;
+    out->value_max = total.value_max;
+    out->value_mean = total.value_sum / double(total.point_count);
   }
 
-  out->point_count = request->point_count;
-  out->buffers = request->buffer_views.data();
-  out->buffer_count = uint32_t(request->buffer_views.size());
-  out->nodes = request->nodes.data();
-  out->node_count = uint32_t(request->nodes.size());
+  if (spec.grid)
+  {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const size_t cells = total.cell_count.size();
+    request->cell_min_view.assign(cells, nan);
+    request->cell_max_view.assign(cells, nan);
+    request->cell_mean_view.assign(cells, nan);
+    for (size_t c = 0; c < cells; c++)
+    {
+      if (total.cell_count[c] == 0)
+        continue;
+      request->cell_min_view[c] = total.cell_min[c];
+      request->cell_max_view[c] = total.cell_max[c];
+      request->cell_mean_view[c] = total.cell_sum[c] / double(total.cell_count[c]);
+    }
+    out->grid_width = spec.grid_width;
+    out->grid_height = spec.grid_height;
+    out->grid_origin[0] = spec.grid_origin[0];
+    out->grid_origin[1] = spec.grid_origin[1];
+    out->cell_size = spec.cell_size;
+    out->cell_count = total.cell_count.data();
+    out->cell_min = request->cell_min_view.data();
+    out->cell_max = request->cell_max_view.data();
+    out->cell_mean = request->cell_mean_view.data();
+  }
+
+  out->bins = total.bins.data();
+  out->bin_count = uint32_t(total.bins.size());
+  out->below_bins = total.below_bins;
+  out->above_bins = total.above_bins;
+  out->used_lod = request->aggregate_used_lod ? 1 : 0;
+  return 1;
+}
+
+uint8_t dew_request_get_search(struct dew_request_t *request, struct dew_search_result_t *out)
+{
+  if (!request || !out)
+    return 0;
+  if (request->status.load(std::memory_order_acquire) != dew_request_completed || !request->is_search)
+    return 0;
+  *out = dew_search_result_t{};
+  out->query_count = uint32_t(request->search_offsets.size() - 1);
+  out->offsets = request->search_offsets.data();
+  out->indices = request->search_indices.data();
+  out->distances = request->search_distances.data();
+  out->neighbour_count = request->search_indices.size();
   return 1;
 }
 
 uint64_t dew_request_attribute_size(struct dew_request_t *request, uint32_t attribute_index)
 {
-  if (!request || attribute_index >= request->buffers.size())
+  if (!request || request->regions.empty() || attribute_index >= request->regions[0].buffers.size())
     return 0;
-  return request->buffers[attribute_index].data.size();
+  return request->regions[0].buffers[attribute_index].data.size();
 }
 
 uint64_t dew_request_copy_attribute(struct dew_request_t *request, uint32_t attribute_index, uint8_t *dst, uint64_t dst_bytes, struct dew_error_t **error)
 {
-  if (!request || attribute_index >= request->buffers.size())
+  if (!request || request->regions.empty() || attribute_index >= request->regions[0].buffers.size())
   {
     fill_error(error, {1, "no such attribute in this result"});
     return 0;
   }
-  const auto &buffer = request->buffers[attribute_index].data;
+  const auto &buffer = request->regions[0].buffers[attribute_index].data;
   if (dst_bytes < buffer.size())
   {
     fill_error(error, {1, "destination buffer is too small"});
@@ -20,7 +20,10 @@
 
 #include "morton_tree_coordinate_transform.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <limits>
 
 namespace dew::access
 {
@@ -39,15 +42,269 @@ aabb_t aabb_child(const aabb_t &parent, int child_index)
   return out;
 }
 
+bool zone_may_match(const attribute_zone_t &zone, const attribute_predicate_t &predicate)
+{
+  if (!(zone.flags & attribute_zone_has_range))
+    return true;
+  switch (predicate.op)
+  {
+  case predicate_op_t::range:
+    return zone.max >= predicate.min && zone.min <= predicate.max;
+  case predicate_op_t::in:
+    for (double value : predicate.values)
+    {
+      if (value < zone.min || value > zone.max)
+        continue;
+      if (!(zone.flags & attribute_zone_has_values))
+        return true;
+      if (value == double(uint32_t(value)) && attribute_zone_has_value(zone, uint32_t(value)))
+        return true;
+    }
+    return false;
+  case predicate_op_t::not_in:
+    if (zone.flags & attribute_zone_has_values)
+    {
+      for (uint32_t value = uint32_t(zone.min); value <= uint32_t(zone.max); value++)
+      {
+        if (attribute_zone_has_value(zone, value) && predicate_accepts(predicate, double(value)))
+          return true;
+      }
+      return false;
+    }
+    // A range alone only rules out a unit holding a single, excluded value.
+    return zone.min != zone.max || predicate_accepts(predicate, zone.min);
+  }
+  return true;
+}
+
+namespace
+{
+
+bool z_overlaps(const query_geometry_t &geometry, const aabb_t &box)
+{
+  return geometry.z_min >= geometry.z_max || (box.max[2] >= geometry.z_min && box.min[2] <= geometry.z_max);
+}
+
+bool z_contains(const query_geometry_t &geometry, const aabb_t &box)
+{
+  return geometry.z_min >= geometry.z_max || (box.min[2] >= geometry.z_min && box.max[2] <= geometry.z_max);
+}
+
+bool point_in_polygon(const std::vector<double> &vertices, double px, double py)
+{
+  const size_t count = vertices.size() / 2;
+  bool inside = false;
+  for (size_t e = 0, n = count - 1; e < count; n = e++)
+  {
+    const double xi = vertices[e * 2], yi = vertices[e * 2 + 1];
+    const double xj = vertices[n * 2], yj = vertices[n * 2 + 1];
+    if ((yi > py) != (yj > py) && px < (xj - xi) * (py - yi) / (yj - yi) + xi)
+      inside = !inside;
+  }
+  return inside;
+}
+
+// Liang-Barsky: does the segment a-b touch the closed xy rectangle of `box`?
+bool segment_touches_rect(double ax, double ay, double bx, double by, const aabb_t &box)
+{
+  double t0 = 0.0;
+  double t1 = 1.0;
+  const double d[2] = {bx - ax, by - ay};
+  const double a[2] = {ax, ay};
+  for (int axis = 0; axis < 2; axis++)
+  {
+    if (d[axis] == 0.0)
+    {
+      if (a[axis] < box.min[axis] || a[axis] > box.max[axis])
+        return false;
+      continue;
+    }
+    double lo = (box.min[axis] - a[axis]) / d[axis];
+    double hi = (box.max[axis] - a[axis]) / d[axis];
+    if (lo > hi)
+      std::swap(lo, hi);
+    t0 = std::max(t0, lo);
+    t1 = std::min(t1, hi);
+    if (t0 > t1)
+      return false;
+  }
+  return true;
+}
+
+double point_segment_distance2(double px, double py, double ax, double ay, double bx, double by)
+{
+  const double dx = bx - ax;
+  const double dy = by - ay;
+  const double length2 = dx * dx + dy * dy;
+  const double t = length2 > 0 ? std::clamp(((px - ax) * dx + (py - ay) * dy) / length2, 0.0, 1.0) : 0.0;
+  const double ex = px - (ax + t * dx);
+  const double ey = py - (ay + t * dy);
+  return ex * ex + ey * ey;
+}
+
+double point_rect_distance2(double px, double py, const aabb_t &box)
+{
+  const double dx = std::max({box.min[0] - px, 0.0, px - box.max[0]});
+  const double dy = std::max({box.min[1] - py, 0.0, py - box.max[1]});
+  return dx * dx + dy * dy;
+}
+
+// The minimum distance between a segment and a rectangle, in the xy plane, squared. When they do not
+// touch, the closest pair has an endpoint of one on the boundary of the other.
+double segment_rect_distance2(double ax, double ay, double bx, double by, const aabb_t &box)
+{
+  if (segment_touches_rect(ax, ay, bx, by, box))
+    return 0.0;
+  double best = std::min(point_rect_distance2(ax, ay, box), point_rect_distance2(bx, by, box));
+  const double corners[4][2] = {{box.min[0], box.min[1]}, {box.max[0], box.min[1]}, {box.min[0], box.max[1]}, {box.max[0], box.max[1]}};
+  for (const auto &corner : corners)
+    best = std::min(best, point_segment_distance2(corner[0], corner[1], ax, ay, bx, by));
+  return best;
+}
+
+} // namespace
+
+bool geometry_overlaps(const query_geometry_t &geometry, const aabb_t &box)
+{
+  const auto &v = geometry.vertices;
+  const size_t vertex_count = v.size() / 2;
+  switch (geometry.kind)
+  {
+  case geometry_kind_t::box:
+    return true;
+  case geometry_kind_t::polygon_prism:
+  {
+    if (!z_overlaps(geometry, box) || vertex_count < 3)
+      return false;
+    // A corner of the rectangle inside the polygon, or any edge touching the rectangle -- which also
+    // catches a polygon lying wholly inside it.
+    if (point_in_polygon(v, box.min[0], box.min[1]))
+      return true;
+    for (size_t e = 0, n = vertex_count - 1; e < vertex_count; n = e++)
+    {
+      if (segment_touches_rect(v[n * 2], v[n * 2 + 1], v[e * 2], v[e * 2 + 1], box))
+        return true;
+    }
+    return false;
+  }
+  case geometry_kind_t::corridor:
+  {
+    if (!z_overlaps(geometry, box))
+      return false;
+    const double radius2 = geometry.radius * geometry.radius;
+    for (size_t s = 0; s + 1 < vertex_count; s++)
+    {
+      if (segment_rect_distance2(v[s * 2], v[s * 2 + 1], v[s * 2 + 2], v[s * 2 + 3], box) <= radius2)
+        return true;
+    }
+    return false;
+  }
+  case geometry_kind_t::frustum:
+    // The box is outside when its corner furthest along a plane's normal is still behind it.
+    for (const auto &plane : geometry.planes)
+    {
+      double d = plane[3];
+      for (int axis = 0; axis < 3; axis++)
+        d += plane[axis] * (plane[axis] >= 0 ? box.max[axis] : box.min[axis]);
+      if (d < 0)
+        return false;
+    }
+    return true;
+  }
+  return true;
+}
+
+bool geometry_contains(const query_geometry_t &geometry, const aabb_t &box)
+{
+  const auto &v = geometry.vertices;
+  const size_t vertex_count = v.size() / 2;
+  const double corners[4][2] = {{box.min[0], box.min[1]}, {box.max[0], box.min[1]}, {box.min[0], box.max[1]}, {box.max[0], box.max[1]}};
+  switch (geometry.kind)
+  {
+  case geometry_kind_t::box:
+    return true;
+  case geometry_kind_t::polygon_prism:
+  {
+    if (!z_contains(geometry, box) || vertex_count < 3)
+      return false;
+    for (const auto &corner : corners)
+    {
+      if (!point_in_polygon(v, corner[0], corner[1]))
+        return false;
+    }
+    // A concave polygon can hold all four corners and still cut into the rectangle; any edge that
+    // touches it means some of the rectangle may be outside.
+    for (size_t e = 0, n = vertex_count - 1; e < vertex_count; n = e++)
+    {
+      if (segment_touches_rect(v[n * 2], v[n * 2 + 1], v[e * 2], v[e * 2 + 1], box))
+        return false;
+    }
+    return true;
+  }
+  case geometry_kind_t::corridor:
+  {
+    if (!z_contains(geometry, box))
+      return false;
+    // One segment's capsule is convex, so holding all four corners means holding the rectangle.
+    const double radius2 = geometry.radius * geometry.radius;
+    for (size_t s = 0; s + 1 < vertex_count; s++)
+    {
+      bool all = true;
+      for (const auto &corner : corners)
+        all = all && point_segment_distance2(corner[0], corner[1], v[s * 2], v[s * 2 + 1], v[s * 2 + 2], v[s * 2 + 3]) <= radius2;
+      if (all)
+        return true;
+    }
+    return false;
+  }
+  case geometry_kind_t::frustum:
+    for (const auto &plane : geometry.planes)
+    {
+      double d = plane[3];
+      for (int axis = 0; axis < 3; axis++)
+        d += plane[axis] * (plane[axis] >= 0 ? box.min[axis] : box.max[axis]);
+      if (d < 0)
+        return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+bool area_overlaps(const region_area_t &area, const aabb_t &box)
+{
+  return (area.whole_dataset || aabb_overlaps(box, area.box)) && geometry_overlaps(area.geometry, box);
+}
+
+bool area_contains(const region_area_t &area, const aabb_t &box)
+{
+  return (area.whole_dataset || aabb_contains(area.box, box)) && geometry_contains(area.geometry, box);
+}
+
 namespace
 {
 
+bool query_overlaps(const region_query_t &query, const aabb_t &box)
+{
+  if (!query.areas.empty())
+    return std::any_of(query.areas.begin(), query.areas.end(), [&box](const region_area_t &area) { return area_overlaps(area, box); });
+  return (query.whole_dataset || aabb_overlaps(box, query.box)) && geometry_overlaps(query.geometry, box);
+}
+
+bool query_contains(const region_query_t &query, const aabb_t &box)
+{
+  if (!query.areas.empty())
+    return false;
+  return (query.whole_dataset || aabb_contains(query.box, box)) && geometry_contains(query.geometry, box);
+}
+
 struct pending_node_t
 {
   const tree_t *tree;
   int skip;
   aabb_t cell;
-  bool fully_inside; // the cell lies wholly inside the query box -> children inherit it, no re-test
+  bool fully_inside; // the cell lies wholly inside the query -> children inherit it, no re-test
+  int32_t sample_cell = -1; // lod_mode::sample: the innermost interior node above this one
 };
 
 aabb_t cell_from_morton(const tree_config_t &config, const morton::morton192_t &min, const morton::morton192_t &max)
@@ -66,16 +323,92 @@ bool tree_resident(const tree_registry_t &registry, tree_id_t id)
   return std::atomic_ref<uint8_t>(const_cast<uint8_t &>(registry.tree_id_initialized[id.data])).load(std::memory_order_acquire) != 0;
 }
 
+enum class zone_verdict_t
+{
+  may_match,
+  unit_ruled_out,    // no point of the unit itself can pass
+  subtree_ruled_out, // ... nor any point anywhere below it
+};
+
+// Test one unit against the query's predicates using nothing but its zone maps.
+zone_verdict_t unit_zone_verdict(const tree_t *tree, input_data_id_t input_id, const region_query_t &query)
+{
+  if (query.predicates.empty() || !query.attributes)
+    return zone_verdict_t::may_match;
+  const auto attributes_id = tree->storage_map.attribute_id(input_id);
+  const auto *zones = tree->storage_map.zones(input_id);
+  auto verdict = zone_verdict_t::may_match;
+  for (const auto &predicate : query.predicates)
+  {
+    const int index = query.attributes->get_attribute_index(attributes_id, predicate.attribute_name).index;
+    if (index < 0)
+    {
+      // The unit lacks the attribute and reads as zeros -- but says nothing about what lies below it.
+      if (!predicate_accepts(predicate, 0.0))
+        verdict = zone_verdict_t::unit_ruled_out;
+      continue;
+    }
+    if (!zones || index >= int(zones->size()))
+      continue;
+    const auto &zone = (*zones)[size_t(index)];
+    if (zone_may_match(zone, predicate))
+      continue;
+    if (zone.flags & attribute_zone_subtree)
+      return zone_verdict_t::subtree_ruled_out;
+    verdict = zone_verdict_t::unit_ruled_out;
+  }
+  return verdict;
+}
+
+// Whether the predicates rule out the node at (level, skip) together with everything below it: its
+// LOD unit's subtree-wide zone has to, and so does any source data the node itself holds.
+bool subtree_ruled_out(const tree_t *tree, int level, int skip, const region_query_t &query)
+{
+  if (query.predicates.empty())
+    return false;
+  const auto &collection = tree->data[level][size_t(skip)];
+  bool subtree_covered = false;
+  for (const auto &subset : collection.data)
+  {
+    const auto verdict = unit_zone_verdict(tree, subset.input_id, query);
+    if (verdict == zone_verdict_t::may_match)
+      return false;
+    if (verdict == zone_verdict_t::subtree_ruled_out && !input_data_id_is_leaf(subset.input_id))
+      subtree_covered = true;
+  }
+  return subtree_covered;
+}
+
+// How far apart a node's sampled (LOD) points sit in XY, estimated from its tight extent and its
+// sample count -- point clouds are surfaces far more often than volumes. Infinite when the node has no
+// sampled unit, so the walk keeps descending.
+double sampled_spacing(const tree_registry_t &registry, const tree_t *tree, int level, int skip)
+{
+  const auto &collection = tree->data[level][size_t(skip)];
+  uint64_t samples = 0;
+  for (const auto &subset : collection.data)
+  {
+    if (!input_data_id_is_leaf(subset.input_id))
+      samples += subset.count.data;
+  }
+  if (samples == 0)
+    return std::numeric_limits<double>::infinity();
+  const auto tight = cell_from_morton(registry.tree_config, collection.min, collection.max);
+  const double extent = std::max(tight.max[0] - tight.min[0], tight.max[1] - tight.min[1]);
+  return extent / std::sqrt(double(samples));
+}
+
 // Emit every storage unit held at this node, honouring the LOD rule: a full-resolution query takes
-// only leaf data, anything else takes only the sampled LOD unit.
-void emit_node(const tree_registry_t &registry, const tree_t *tree, int level, int skip, const aabb_t &cell, bool fully_inside, const region_query_t &query, region_result_t &out)
+// only leaf data, anything else takes only the sampled LOD unit. A sample walk offers the sampled
+// unit of every interior node it passes and the leaf data of every leaf.
+void emit_node(const tree_registry_t &registry, const tree_t *tree, int level, int skip, const aabb_t &cell, bool fully_inside, int32_t sample_cell, const region_query_t &query, region_result_t &out)
 {
   const auto &collection = tree->data[level][size_t(skip)];
   if (collection.data.empty())
     return;
 
   const auto tight = cell_from_morton(registry.tree_config, collection.min, collection.max);
-  if (!query.whole_dataset && !aabb_overlaps(tight, query.box))
+  if (!query_overlaps(query, tight))
     return;
 
   const int lod = morton::morton_tree_level_to_lod(tree->magnitude, level);
@@ -85,7 +418,7 @@ void emit_node(const tree_registry_t &registry, const tree_t *tree, int level, i
   {
     const bool leaf_data = input_data_id_is_leaf(subset.input_id);
     // full resolution wants source points only; every other mode wants the sampled copy only.
-    if (query.lod_mode == lod_mode_t::full)
+    if (query.lod_mode == lod_mode_t::full || (query.lod_mode == lod_mode_t::sample && child_mask == 0))
     {
       if (!leaf_data)
         continue;
@@ -96,6 +429,12 @@ void emit_node(const tree_registry_t &registry, const tree_t *tree, int level, i
       continue;
     }
 
+    if (unit_zone_verdict(tree, subset.input_id, query) != zone_verdict_t::may_match)
+    {
+      out.pruned_nodes++;
+      continue;
+    }
+
     region_node_t node;
     node.tree_id = tree->id;
     node.level = uint16_t(level);
@@ -110,7 +449,8 @@ void emit_node(const tree_registry_t &registry, const tree_t *tree, int level, i
     node.child_mask = child_mask;
     node.is_leaf = child_mask == 0;
     node.is_lod = !leaf_data;
-    node.fully_inside = fully_inside || aabb_contains(query.box, tight);
+    node.fully_inside = fully_inside || query_contains(query, tight);
+    node.sample_cell = sample_cell;
     out.total_points += subset.count.data;
     out.nodes.push_back(node);
   }
@@ -118,39 +458,39 @@ void emit_node(const tree_registry_t &registry, const tree_t *tree, int level, i
 
 } // namespace
 
-void region_walk(const tree_registry_t &registry, const region_query_t &query, region_result_t &out)
+namespace
+{
+
+void reset_result(region_result_t &out)
 {
   out.nodes.clear();
   out.trees_to_load.clear();
+  out.subtrees_to_load.clear();
+  out.sibling_trees.clear();
   out.total_points = 0;
+  out.visited_nodes = 0;
+  out.pruned_nodes = 0;
+  out.pruned_subtrees = 0;
+  out.sample_cells.clear();
+}
 
-  if (registry.data.empty())
-    return;
-  if (!tree_resident(registry, registry.root))
-  {
-    out.trees_to_load.push_back(registry.root);
-    return;
-  }
-  const tree_t *root = registry.get(registry.root);
-  if (!root || root->data[0].empty() || root->data[0][0].data.empty())
-    return;
-
-  const aabb_t root_cell = cell_from_morton(registry.tree_config, root->morton_min, root->morton_max);
-  if (!query.whole_dataset && !aabb_overlaps(root_cell, query.box))
-    return;
-
+// The breadth-first descent shared by both entry points, from one resident start node at `first_depth`.
+void walk_from(const tree_registry_t &registry, const region_query_t &query, const pending_node_t &start, int first_depth, region_result_t &out)
+{
   std::vector<pending_node_t> current;
   std::vector<pending_node_t> next;
-  current.push_back({root, 0, root_cell, query.whole_dataset || aabb_contains(query.box, root_cell)});
+  std::vector<tree_id_t> siblings;
+  current.push_back(start);
 
   // A tree is five levels deep and hops to a sub-tree below that, so the absolute depth is unbounded
   // in principle; 40 matches the renderer's cap and is far beyond any real dataset.
   constexpr int max_depth = 40;
-  for (int depth = 0; depth < max_depth && !current.empty(); depth++)
+  for (int depth = first_depth; depth < max_depth && !current.empty(); depth++)
   {
     const int level = depth % 5;
     next.clear();
 
+    out.visited_nodes += uint32_t(current.size());
     for (const auto &pending : current)
     {
       const tree_t *tree = pending.tree;
@@ -162,12 +502,28 @@ void region_walk(const tree_registry_t &registry, const region_query_t &query, r
         descend = false;
       if (descend && query.lod_mode == lod_mode_t::point_budget && out.total_points >= query.max_points)
         descend = false;
+      if (descend && query.lod_mode == lod_mode_t::spacing && sampled_spacing(registry, tree, level, pending.skip) <= query.max_spacing)
+        descend = false;
 
       if (!descend)
       {
-        emit_node(registry, tree, level, pending.skip, pending.cell, pending.fully_inside, query, out);
+        emit_node(registry, tree, level, pending.skip, pending.cell, pending.fully_inside, pending.sample_cell, query, out);
+        continue;
+      }
+      if (subtree_ruled_out(tree, level, pending.skip, query))
+      {
+        out.pruned_subtrees++;
         continue;
       }
+      // A sample walk offers this node's sampled unit as a stand-in for everything below it, and
+      // numbers the node so region_select_sample can tell which units it would replace.
+      int32_t sample_cell = pending.sample_cell;
+      if (query.lod_mode == lod_mode_t::sample)
+      {
+        sample_cell = int32_t(out.sample_cells.size());
+        out.sample_cells.push_back({pending.sample_cell});
+        emit_node(registry, tree, level, pending.skip, pending.cell, pending.fully_inside, sample_cell, query, out);
+      }
 
       // Interior node: recurse into the octants that exist and overlap the box.
       //
@@ -176,6 +532,8 @@ void region_walk(const tree_registry_t &registry, const region_query_t &query, r
       // not resident. Failing to advance it silently misroutes every later sibling to the wrong node.
       int child_count = 0;
       uint8_t bits = children;
+      siblings.clear();
+      bool needed_a_sub_tree = false;
       for (int i = 0; i < 8; i++, bits >>= 1)
       {
         if (!(bits & 1))
@@ -183,9 +541,18 @@ void region_walk(const tree_registry_t &registry, const region_query_t &query, r
         const int this_child = child_count++;
 
         const aabb_t child_cell = aabb_child(pending.cell, i);
-        if (!query.whole_dataset && !aabb_overlaps(child_cell, query.box))
+        if (!query_overlaps(query, child_cell))
+        {
+          if (level == 4)
+          {
+            const auto sub_tree_id = tree->sub_trees[size_t(tree->skips[4][size_t(pending.skip)] + this_child)];
+            if (!tree_resident(registry, sub_tree_id))
+              siblings.push_back(sub_tree_id);
+          }
           continue;
+        }
 
+        const bool inside = pending.fully_inside || query_contains(query, child_cell);
         const tree_t *child_tree = tree;
         int child_skip = tree->skips[level][size_t(pending.skip)] + this_child;
         if (level == 4)
@@ -194,6 +561,8 @@ void region_walk(const tree_registry_t &registry, const region_query_t &query, r
           if (!tree_resident(registry, sub_tree_id))
           {
             out.trees_to_load.push_back(sub_tree_id);
+            out.subtrees_to_load.push_back({sub_tree_id, child_cell, inside, depth + 1});
+            needed_a_sub_tree = true;
             continue;
           }
           child_tree = registry.get(sub_tree_id);
@@ -201,12 +570,155 @@ void region_walk(const tree_registry_t &registry, const region_query_t &query, r
             continue;
           child_skip = 0;
         }
-        const bool inside = pending.fully_inside || aabb_contains(query.box, child_cell);
-        next.push_back({child_tree, child_skip, child_cell, inside});
+        next.push_back({child_tree, child_skip, child_cell, inside, sample_cell});
       }
+      if (needed_a_sub_tree)
+        out.sibling_trees.insert(out.sibling_trees.end(), siblings.begin(), siblings.end());
     }
     current.swap(next);
   }
 }
 
+} // namespace
+
+void region_walk(const tree_registry_t &registry, const region_query_t &query, region_result_t &out)
+{
+  reset_result(out);
+
+  if (registry.data.empty())
+    return;
+  if (!tree_resident(registry, registry.root))
+  {
+    out.trees_to_load.push_back(registry.root);
+    return;
+  }
+  const tree_t *root = registry.get(registry.root);
+  if (!root || root->data[0].empty() || root->data[0][0].data.empty())
+    return;
+
+  const aabb_t root_cell = cell_from_morton(registry.tree_config, root->morton_min, root->morton_max);
+  if (!query_overlaps(query, root_cell))
+    return;
+
+  walk_from(registry, query, {root, 0, root_cell, query_contains(query, root_cell)}, 0, out);
+}
+
+void region_walk_subtree(const tree_registry_t &registry, const region_query_t &query, const region_subtree_t &start, region_result_t &out)
+{
+  reset_result(out);
+
+  if (!tree_resident(registry, start.tree_id))
+  {
+    out.trees_to_load.push_back(start.tree_id);
+    out.subtrees_to_load.push_back(start);
+    return;
+  }
+  const tree_t *tree = registry.get(start.tree_id);
+  if (!tree)
+    return;
+  walk_from(registry, query, {tree, 0, start.cell, start.fully_inside}, start.depth, out);
+}
+
+namespace
+{
+
+// The share of a unit's points estimated to lie in the query: the share of its bounds' volume inside
+// the box. An axis the bounds are flat on counts as inside when it is within the box at all.
+double region_share(const region_query_t &query, const region_node_t &node)
+{
+  if (node.fully_inside || query.whole_dataset)
+    return 1.0;
+  double share = 1.0;
+  for (int i = 0; i < 3; i++)
+  {
+    const double extent = node.tight.max[i] - node.tight.min[i];
+    const double overlap = std::min(node.tight.max[i], query.box.max[i]) - std::max(node.tight.min[i], query.box.min[i]);
+    if (overlap < 0)
+      return 0.0;
+    if (extent > 0)
+      share *= std::min(1.0, overlap / extent);
+  }
+  return share;
+}
+
+} // namespace
+
+void region_select_sample(const region_query_t &query, region_result_t &out)
+{
+  // A sampled unit has to hold this many times its node's share before it stands in for the full
+  // resolution: clipping and predicates thin it and the source below it unevenly, and the draw can
+  // only take what is there.
+  constexpr double k_oversample = 2.0;
+
+  const size_t cell_count = out.sample_cells.size();
+  std::vector<double> sampled(cell_count, 0.0); // estimated in the region
+  std::vector<double> source(cell_count, 0.0);  // likewise, everywhere below the cell
+  std::vector<uint64_t> sampled_raw(cell_count, 0);
+  std::vector<uint64_t> source_raw(cell_count, 0);
+  double total = 0;
+  for (const auto &node : out.nodes)
+  {
+    const double estimate = double(node.point_count.data) * region_share(query, node);
+    const auto cell = size_t(node.sample_cell);
+    if (node.is_lod)
+    {
+      sampled[cell] += estimate;
+      sampled_raw[cell] += node.point_count.data;
+      continue;
+    }
+    total += estimate;
+    if (node.sample_cell >= 0)
+    {
+      source[cell] += estimate;
+      source_raw[cell] += node.point_count.data;
+    }
+  }
+  // Children follow their parents, so one backwards pass sums every subtree.
+  for (size_t c = cell_count; c-- > 0;)
+  {
+    const int32_t parent = out.sample_cells[c].parent;
+    if (parent < 0)
+      continue;
+    source[size_t(parent)] += source[c];
+    source_raw[size_t(parent)] += source_raw[c];
+  }
+
+  // 0: read below, 1: this cell's sampled unit is read, 2: an ancestor's is.
+  std::vector<uint8_t> state(cell_count, 0);
+  const double fraction = total > 0 ? double(query.max_points) / total : 1.0;
+  if (fraction < 1.0)
+  {
+    for (size_t c = 0; c < cell_count; c++)
+    {
+      const int32_t parent = out.sample_cells[c].parent;
+      if (parent >= 0 && state[size_t(parent)] != 0)
+        state[c] = 2;
+      else if (sampled[c] > 0 && sampled[c] >= k_oversample * fraction * source[c])
+        state[c] = 1;
+    }
+  }
+
+  size_t kept = 0;
+  out.total_points = 0;
+  for (auto &node : out.nodes)
+  {
+    const auto cell = size_t(node.sample_cell);
+    if (node.is_lod)
+    {
+      if (state[cell] != 1)
+        continue;
+      node.represents = sampled_raw[cell] ? std::max(1.0, double(source_raw[cell]) / double(sampled_raw[cell])) : 1.0;
+    }
+    else
+    {
+      if (node.sample_cell >= 0 && state[cell] != 0)
+        continue;
+      node.represents = 1.0;
+    }
+    out.total_points += node.point_count.data;
+    out.nodes[kept++] = node;
+  }
+  out.nodes.resize(kept);
+}
+
 } // namespace dew::access
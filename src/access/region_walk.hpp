@@ -31,7 +31,9 @@
 // looking entirely plausible. Every mode below therefore emits exactly one frontier: the set of
 // nodes at which the descent stopped, and never an ancestor of another emitted node.
 
+#include "attributes_configs.hpp"
 #include "dataset_types.hpp"
+#include "decode.hpp"
 #include "input_storage_map.hpp"
 #include "tree.hpp"
 
@@ -78,6 +80,17 @@ enum class lod_mode_t
   full,         // descend to the leaves; emit leaf data only (full resolution)
   level,        // stop at a given morton lod and emit that frontier
   point_budget, // descend while the running point total stays under a budget
+  spacing,      // stop at the first node whose sampled points are already as dense as max_spacing
+  sample,       // descend to the leaves, also offering every interior node's sampled unit; the frontier
+                // is then picked by region_select_sample
+};
+
+// One area a query selects: a box, or the whole dataset, optionally refined by a geometry.
+struct region_area_t
+{
+  aabb_t box{{0, 0, 0}, {0, 0, 0}};
+  bool whole_dataset = false;
+  query_geometry_t geometry;
 };
 
 struct region_query_t
@@ -85,10 +98,38 @@ struct region_query_t
   aabb_t box{{0, 0, 0}, {0, 0, 0}};
   lod_mode_t lod_mode = lod_mode_t::full;
   int32_t lod = 0;             // lod_mode::level
-  uint64_t max_points = 0;     // lod_mode::point_budget
+  uint64_t max_points = 0;     // lod_mode::point_budget, and the sample size for lod_mode::sample
+  double max_spacing = 0;      // lod_mode::spacing, world units between neighbouring points in XY
   bool whole_dataset = false;  // ignore `box` and take everything
+  // Optional finer shape, tested on top of `box` (which should bound it, so the box still prunes
+  // first). A node is kept when it may overlap both.
+  query_geometry_t geometry;
+  // Several areas at once, replacing box / whole_dataset / geometry when not empty: a node is kept
+  // when it may overlap ANY of them, so a batch walks the union once. region_node_t::fully_inside
+  // is never set then -- which area a node is inside is the caller's question, via area_contains.
+  std::vector<region_area_t> areas;
+  // Attribute predicates, ANDed. The walk drops every unit whose zone maps rule a predicate out, and
+  // skips a whole subtree when its LOD unit's subtree-wide zone does; `attributes` resolves the names
+  // per unit and must be set whenever `predicates` is not empty.
+  std::vector<attribute_predicate_t> predicates;
+  const attributes_configs_t *attributes = nullptr;
 };
 
+// Whether any value a zone describes could pass `predicate` (a zone without a range could hold
+// anything). Conservative: true unless the zone proves otherwise.
+bool zone_may_match(const attribute_zone_t &zone, const attribute_predicate_t &predicate);
+
+// Conservative node-vs-geometry tests. `geometry_overlaps` may answer true for a box that misses the
+// shape (the points are clipped later anyway) but never false for one that touches it;
+// `geometry_contains` only answers true when every point of the box is inside, so per-point clipping
+// can be skipped. A box geometry overlaps and contains everything -- `region_query_t::box` covers it.
+bool geometry_overlaps(const query_geometry_t &geometry, const aabb_t &box);
+bool geometry_contains(const query_geometry_t &geometry, const aabb_t &box);
+
+// The same pair for a whole area, box and geometry together.
+bool area_overlaps(const region_area_t &area, const aabb_t &box);
+bool area_contains(const region_area_t &area, const aabb_t &box);
+
 // One selected node's readable unit: which storage-map entry to read, how many points, and where it
 // sits in the world.
 struct region_node_t
@@ -106,8 +147,31 @@ struct region_node_t
   uint8_t child_mask = 0;
   bool is_leaf = false;
   bool is_lod = false;
-  // True when the node's cell lies wholly inside the query box, so per-point clipping can be skipped.
+  // True when the node's cell lies wholly inside the query box and geometry, so per-point clipping can
+  // be skipped.
   bool fully_inside = false;
+  // lod_mode::sample: the region_result_t::sample_cells entry of the node a sampled unit was taken
+  // at, or of the innermost interior node above a source unit; -1 above the root.
+  int32_t sample_cell = -1;
+  // How many source points each of this unit's points stands for in a sample: 1 for source points,
+  // more for a sampled unit read in place of the full resolution below it.
+  double represents = 1.0;
+};
+
+// lod_mode::sample: one interior node the walk passed through. Parents precede their children.
+struct region_sample_cell_t
+{
+  int32_t parent = -1;
+};
+
+// Where a descent stopped for want of a sub-tree: enough to resume it from that sub-tree's root once
+// it is resident, without re-walking everything above it.
+struct region_subtree_t
+{
+  tree_id_t tree_id;
+  aabb_t cell{{0, 0, 0}, {0, 0, 0}};
+  bool fully_inside = false;
+  int depth = 0; // absolute depth of the sub-tree's root, so the depth cap stays global
 };
 
 struct region_result_t
@@ -116,7 +180,19 @@ struct region_result_t
   // Sub-trees the descent needed but that are not resident yet. The caller loads these and walks
   // again; the walk is otherwise complete when this is empty.
   std::vector<tree_id_t> trees_to_load;
+  // The same sub-trees, in the same order, with where to resume -- for region_walk_subtree.
+  std::vector<region_subtree_t> subtrees_to_load;
+  // Non-resident sub-trees the query does NOT need that share a parent node with one it does. The
+  // cheapest guess at what a neighbouring query will want next; loading them is entirely optional.
+  std::vector<tree_id_t> sibling_trees;
   uint64_t total_points = 0;
+  // Octree nodes the descent looked at, emitted or not.
+  uint32_t visited_nodes = 0;
+  // Units and subtrees the predicates' zone maps ruled out without reading them.
+  uint32_t pruned_nodes = 0;
+  uint32_t pruned_subtrees = 0;
+  // lod_mode::sample only.
+  std::vector<region_sample_cell_t> sample_cells;
 };
 
 // Walk `registry` (whatever of it is resident) and select the nodes matching `query`. Pure and
@@ -124,4 +200,20 @@ struct region_result_t
 // `trees_to_load` until that list comes back empty.
 void region_walk(const tree_registry_t &registry, const region_query_t &query, region_result_t &out);
 
+// Continue a walk below one sub-tree that `region_walk` (or an earlier call of this) reported, now
+// that it is resident. Emits exactly the nodes and further sub-trees the full re-walk would have found
+// under it, which is what lets a caller descend each branch as soon as its sub-tree lands instead of
+// waiting for the slowest one. Not for lod_mode_t::point_budget, whose stopping rule depends on the
+// running total across every branch; that mode has to re-walk from the root. Nor for
+// lod_mode_t::sample, whose cells are numbered across the whole walk.
+void region_walk_subtree(const tree_registry_t &registry, const region_query_t &query, const region_subtree_t &start, region_result_t &out);
+
+// Turn a converged lod_mode_t::sample walk into the frontier to read, in place. The sample fraction
+// is max_points over the source points estimated in the region (a unit straddling the box counts by
+// the share of its bounds inside it). A sampled unit is kept wherever it holds a comfortable
+// multiple of its node's share -- replacing everything below it, which is never read -- and source
+// units are kept wherever no ancestor qualified. Sets `represents` on what is kept. Walk order is
+// preserved.
+void region_select_sample(const region_query_t &query, region_result_t &out);
+
 } // namespace dew::access
@@ -22,7 +22,10 @@
 #include "format_util.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <deque>
 #include <future>
 
 namespace dew::access
@@ -35,14 +38,18 @@ void request_impl_t::cancel()
     wait_cond.notify_all();
 }
 
-void request_impl_t::finish(dew_request_status_t terminal)
+void request_impl_t::finish(dew_request_status_t terminal, const dew_request_stats_t &final_stats)
 {
   auto expected = dew_request_pending;
   // A cancel that got in first wins: it is already terminal and must stay that way.
   status.compare_exchange_strong(expected, terminal);
   {
     std::unique_lock<std::mutex> lock(wait_mutex);
+    stats = final_stats;
+    stats_ready = true;
   }
+  if (dataset)
+    dataset->record_request_stats(final_stats);
   wait_cond.notify_all();
 }
 
@@ -65,22 +72,30 @@ position_format_t to_internal(dew_position_format_t f)
 
 } // namespace
 
-// Execute a region request end to end: walk to a converged node set, then for each node read the
-// position blob plus each requested attribute, decode, optionally clip, and append to the
-// concatenated output buffers.
+// Execute a region request end to end: walk, read the position blob plus each requested attribute
+// of every selected node, decode, filter by the attribute predicates, optionally clip to the box and
+// geometry, each node straight into its pre-placed slice of the concatenated output buffers.
 //
-// Runs as a coroutine on the dataset's own loop, so the caller's thread is never blocked. Reads are
-// still issued one at a time -- overlapping them is the next step, and this one only has to prove
-// the suspend/resume path against results that must not change.
-vio::task_t<bool> run_region_request(dataset_impl_t &dataset, const region_job_t &spec, request_impl_t &request)
+// The walk and the reads are pipelined. Each branch is walked on as soon as its sub-tree lands, and
+// nodes the walk has finalised are read while other sub-trees are still loading, so a deep dataset
+// on a high-latency store no longer pays a full round trip per tree layer before the first point
+// blob goes out. Runs as a coroutine on the dataset's own loop, so the caller's thread is never
+// blocked.
+vio::task_t<bool> run_region_request(dataset_impl_t &dataset, const region_job_t &spec, request_impl_t &request, dew_request_stats_t &stats, std::chrono::steady_clock::time_point started)
 {
+  // One area walks as it always has; a batch walks the union of its areas, once.
+  const auto &areas = spec.areas;
   region_query_t query;
-  for (int i = 0; i < 3; i++)
+  if (areas.size() == 1)
   {
-    query.box.min[i] = spec.box_min[i];
-    query.box.max[i] = spec.box_max[i];
+    query.box = areas[0].box;
+    query.whole_dataset = areas[0].whole_dataset;
+    query.geometry = areas[0].geometry;
+  }
+  else
+  {
+    query.areas = areas;
   }
-  query.whole_dataset = (spec.box_min[0] >= spec.box_max[0] && spec.box_min[1] >= spec.box_max[1] && spec.box_min[2] >= spec.box_max[2]);
   switch (spec.lod_mode)
   {
   case dew_lod_level:
@@ -91,29 +106,52 @@ vio::task_t<bool> run_region_request(dataset_impl_t &dataset, const region_job_t
     query.lod_mode = lod_mode_t::point_budget;
     query.max_points = spec.max_points;
     break;
+  case dew_lod_sample:
+    query.lod_mode = lod_mode_t::sample;
+    query.max_points = spec.max_points;
+    break;
   case dew_lod_full:
   default:
-    query.lod_mode = lod_mode_t::full;
+    query.lod_mode = spec.max_spacing > 0 ? lod_mode_t::spacing : lod_mode_t::full;
+    query.max_spacing = spec.max_spacing;
     break;
   }
 
+  query.predicates = spec.predicates;
+  query.attributes = &dataset.attributes;
+
   const auto &names = spec.attribute_names;
   const uint32_t attribute_count = uint32_t(names.size());
 
-  region_result_t walked;
-  if (!co_await dataset.co_walk_to_convergence(query, walked))
+  // A predicate on a requested attribute filters on that buffer; one on any other attribute needs its
+  // blob read alongside, purely for the filter.
+  const uint32_t predicate_count = uint32_t(spec.predicates.size());
+  std::vector<int> predicate_attribute(predicate_count, -1);
+  std::vector<int> predicate_filter(predicate_count, -1);
+  std::vector<std::string> filter_names;
+  for (uint32_t p = 0; p < predicate_count; p++)
   {
-    request.error = dataset.error.code ? dataset.error : dew_error_t{1, "region walk failed"};
-    co_return false;
+    const auto &name = spec.predicates[p].attribute_name;
+    auto requested = std::find(names.begin(), names.end(), name);
+    if (requested != names.end())
+    {
+      predicate_attribute[p] = int(requested - names.begin());
+      continue;
+    }
+    auto filter = std::find(filter_names.begin(), filter_names.end(), name);
+    predicate_filter[p] = int(filter - filter_names.begin());
+    if (filter == filter_names.end())
+      filter_names.push_back(name);
   }
+  const uint32_t filter_count = uint32_t(filter_names.size());
 
   const auto position_format = to_internal(spec.position_format);
   const uint32_t position_stride_bytes = position_stride(position_format);
 
-  // Buffer 0 is always the positions; requested attributes follow in the order given.
-  request.buffers.clear();
-  request.buffers.resize(size_t(attribute_count) + 1);
-  auto &positions = request.buffers[0];
+  // Buffer 0 is always the positions; requested attributes follow in the order given. Every region of
+  // a batch gets the same layout.
+  std::vector<out_buffer_t> layout(size_t(attribute_count) + 1);
+  auto &positions = layout[0];
   positions.name = "xyz";
   positions.stride = position_stride_bytes;
   switch (position_format)
@@ -130,124 +168,283 @@ vio::task_t<bool> run_region_request(dataset_impl_t &dataset, const region_job_t
   }
   positions.components = dew_components_3;
 
-  // Resolve each attribute's format ACROSS ALL selected nodes before appending anything.
+  // Resolve each attribute's format BEFORE anything is placed, from the dataset's attribute
+  // configs rather than from the selected nodes.
   //
   // Nodes do not all carry the same attribute set -- slimmed LOD nodes drop the non-visual ones --
   // so a node that lacks an attribute has to contribute zeros to keep every buffer index-aligned
   // with the positions. Discovering the stride lazily from the first node that happens to have the
   // attribute breaks that: any earlier node contributes nothing at all, and the attribute array ends
-  // up shorter than xyz and silently misaligned against it.
+  // up shorter than xyz and silently misaligned against it. And since nodes are placed while the
+  // walk is still finding others, the selected set is not known up front either.
   for (uint32_t a = 0; a < attribute_count; a++)
   {
-    auto &out = request.buffers[a + 1];
+    auto &out = layout[a + 1];
     out.name = names[a];
-    for (const auto &node : walked.nodes)
-    {
-      const auto index = dataset.attributes.get_attribute_index(node.attributes_id, names[a]);
-      if (index.index < 0)
-        continue;
-      out.type = index.format.type;
-      out.components = index.format.components;
-      out.stride = uint32_t(size_for_format(index.format.type, index.format.components));
-      break;
-    }
+    const auto index = dataset.attributes.find_attribute(names[a]);
+    if (index.index < 0)
+      continue;
+    out.type = index.format.type;
+    out.components = index.format.components;
+    out.stride = uint32_t(size_for_format(index.format.type, index.format.components));
   }
+  request.regions.assign(areas.size(), region_output_t{});
+  for (auto &region : request.regions)
+    region.buffers = layout;
+  if (spec.aggregate)
+    request.aggregate = make_aggregate_total(spec.aggregate_spec);
 
-  // What one node contributes, decoded off the dataset loop and appended in walk order afterwards.
-  // Staging is not an optimisation: decoding straight into the shared concatenated buffers from
-  // several pool threads would make the output order depend on thread scheduling.
+  // Where each node's points land. The output offsets are fixed BEFORE any decode: every node gets a
+  // slice of the concatenated buffers sized for all of its points, handed out in walk order on this
+  // loop, and a pool thread decodes straight into it. No staging copy, no single-threaded append, and
+  // an output order that does not depend on which thread finishes first.
+  //
+  // A slice is exact unless something drops points -- a predicate, or a dew_clip_point node straddling
+  // its region. Those leave a gap behind the node's kept points, which one parallel compaction closes
+  // once every node is in (compact_regions below). A node that fails to decode fails the request.
+  //
+  // A batch decodes a node ONCE into staging, then copies it into the slice of each region it
+  // overlaps, and each region clips its own copy: the read and the decode are shared, which is the
+  // point of batching. An aggregate request reduces from staging and has no slices at all.
   struct node_stage_t
   {
     bool valid = false;
-    uint32_t kept = 0;
     double origin[3] = {0, 0, 0};
-    std::vector<uint8_t> positions;
-    std::vector<std::vector<uint8_t>> attributes;
-    const region_node_t *node = nullptr;
+    std::vector<uint8_t> positions;               // staging: batches and aggregates only
+    std::vector<std::vector<uint8_t>> attributes; // likewise
+    std::vector<uint32_t> kept;                   // per region; 0 where the node adds nothing
+    aggregate_t partial;                          // an aggregate request's reduction of the node
+    double clip_ms = 0;                           // thread time spent clipping, for the stats
+    double job_ms = 0;                            // thread time of the whole job
     dew_error_t error;
   };
+  // A node's slice in one region, in walk order, for the compaction.
+  struct placed_t
+  {
+    uint64_t slot; // first point of the slice
+    uint32_t kept; // points at its front that survived
+  };
+  constexpr uint64_t k_no_slot = ~uint64_t(0);
+  std::vector<uint64_t> region_slots(areas.size(), 0); // slice points handed out, gaps included
+  std::vector<std::vector<placed_t>> placed(areas.size());
+  std::vector<uint8_t> region_gapped(areas.size(), 0);
+  // dew_lod_sample: region_node_t::represents for each node of the (single) region, in its order.
+  std::vector<double> sample_represents;
 
-  // One node's reads, issued but not yet awaited.
+  // One node's reads, issued but not yet awaited. The node is held by value: the walk that found it
+  // is long gone by the time its reads land.
   struct pending_node_t
   {
-    const region_node_t *node = nullptr;
+    region_node_t node;
     std::shared_ptr<read_request_t> position;
     std::vector<std::shared_ptr<read_request_t>> attributes; // null where the node lacks it
+    std::vector<std::shared_ptr<read_request_t>> filters;    // predicate-only attributes, likewise
+    std::vector<point_format_t> filter_formats;
+  };
+
+  // A sub-tree read in flight, and where to resume the walk once it is installed. A null read means
+  // it was already resident.
+  struct subtree_load_t
+  {
+    region_subtree_t at;
+    std::shared_ptr<read_request_t> read;
   };
 
   auto &loop = dataset.loop_thread.event_loop();
   // max_reads_in_flight is a TARGET, not a hard cap: a node's position blob and its attribute blobs
   // are issued as a unit, so the floor is one node's worth (1 + attribute_count) even when the
   // budget is smaller. Splitting a node across batches would buy nothing -- it cannot be decoded
-  // until all of its blobs have landed anyway.
-  const uint32_t reads_per_node = 1 + attribute_count;
-  const uint32_t batch_nodes = std::max<uint32_t>(1, dataset.max_reads_in_flight / std::max<uint32_t>(1, reads_per_node));
+  // until all of its blobs have landed anyway. Sub-tree reads count against the same budget.
+  const uint32_t reads_per_node = 1 + attribute_count + filter_count;
+  const uint32_t read_budget = std::max<uint32_t>(1, dataset.max_reads_in_flight);
+  auto elapsed_ms = [&started]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count(); };
+  auto ms_since = [](std::chrono::steady_clock::time_point start) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+  // The pipeline. Nodes the walk has finalised wait in `ready`, in walk order, which is also output
+  // order; sub-trees it still needs wait in `to_fetch`, then in `loading` once their read is out.
+  // Every queue is FIFO and every sub-tree is descended into in the order it was asked for, never
+  // in the order its read happened to land, so the result does not depend on storage timing.
+  std::deque<region_node_t> ready;
+  std::deque<region_subtree_t> to_fetch;
+  std::deque<subtree_load_t> loading;
+  std::vector<pending_node_t> issued;
+  uint32_t issued_reads = 0;
+  uint32_t tree_reads = 0;
+  bool first_blob_issued = false;
+
+  auto take = [&](const region_result_t &result) {
+    ready.insert(ready.end(), result.nodes.begin(), result.nodes.end());
+    to_fetch.insert(to_fetch.end(), result.subtrees_to_load.begin(), result.subtrees_to_load.end());
+    if (stats.speculative_trees < dataset.speculative_subtrees && !result.sibling_trees.empty())
+    {
+      // Fire-and-forget into the resident set: deduplicated there, and nothing here waits on them.
+      const size_t count = std::min<size_t>(result.sibling_trees.size(), dataset.speculative_subtrees - stats.speculative_trees);
+      dataset.trees->request(std::vector<tree_id_t>(result.sibling_trees.begin(), result.sibling_trees.begin() + ptrdiff_t(count)));
+      stats.speculative_trees += uint32_t(count);
+    }
+  };
 
-  for (size_t begin = 0; begin < walked.nodes.size(); begin += batch_nodes)
+  region_result_t walked;
+  if (query.lod_mode == lod_mode_t::point_budget || query.lod_mode == lod_mode_t::sample || !dataset.trees->resident(dataset.registry().root))
   {
-    if (request.status.load(std::memory_order_acquire) == dew_request_canceled)
+    // A point budget stops on the running total across EVERY branch, so no branch can be finalised
+    // before the whole frontier is known: walk to convergence first, then read. A sample's quotas
+    // follow the region's total just the same.
+    if (!co_await dataset.co_walk_to_convergence(query, walked, stats))
+    {
+      request.error = dataset.error.code ? dataset.error : dew_error_t{1, "region walk failed"};
       co_return false;
-    const size_t end = std::min(begin + batch_nodes, walked.nodes.size());
+    }
+    if (query.lod_mode == lod_mode_t::sample)
+    {
+      const auto select_start = std::chrono::steady_clock::now();
+      region_select_sample(query, walked);
+      stats.walk_ms += ms_since(select_start);
+    }
+  }
+  else
+  {
+    const auto walk_start = std::chrono::steady_clock::now();
+    region_walk(dataset.registry(), query, walked);
+    stats.walk_ms += ms_since(walk_start);
+    stats.walk_rounds++;
+    stats.nodes_walked += walked.visited_nodes;
+  }
+  take(walked);
+
+  // Issue one node's blobs; read() only queues, nothing here waits.
+  auto issue_node = [&](const region_node_t &node) {
+    if (node.point_count.data == 0)
+      return;
+    const tree_t *tree = dataset.registry().get(node.tree_id);
+    if (!tree)
+      return;
+
+    pending_node_t entry;
+    entry.node = node;
+    // Slot 0 of a storage unit is a storage_header_t followed by the morton codes.
+    const auto position_location = tree->storage_map.location(node.input_id, 0);
+    if (position_location.size == 0)
+      return; // absent slot; offset == 0 is a VALID location, so never test that
+    entry.position = dataset.reader->read(position_location, read_options_t{false, true, {}});
+    count_blob_read(stats, position_location, *entry.position);
+    issued_reads++;
+    stats.nodes_read++;
 
-    // ---- issue: every read in the batch goes out before any of them is awaited, which is what
-    // turns per-blob latency into one batch's worth instead of the sum. read() only queues.
-    std::vector<pending_node_t> pending;
-    pending.reserve(end - begin);
-    for (size_t i = begin; i < end; i++)
+    entry.attributes.resize(attribute_count);
+    for (uint32_t a = 0; a < attribute_count; a++)
     {
-      const auto &node = walked.nodes[i];
-      if (node.point_count.data == 0)
-        continue;
-      const tree_t *tree = dataset.registry().get(node.tree_id);
-      if (!tree)
+      if (layout[a + 1].stride == 0)
+        continue; // no node has it at all
+      const auto index = dataset.attributes.get_attribute_index(node.attributes_id, names[a]);
+      if (index.index < 0)
+        continue; // this node lacks it: contributes zeros
+      const auto location = tree->storage_map.location(node.input_id, index.index);
+      if (location.size == 0)
         continue;
+      entry.attributes[a] = dataset.reader->read(location, read_options_t{false, true, {}});
+      count_blob_read(stats, location, *entry.attributes[a]);
+      issued_reads++;
+    }
 
-      pending_node_t entry;
-      entry.node = &node;
-      // Slot 0 of a storage unit is a storage_header_t followed by the morton codes.
-      const auto position_location = tree->storage_map.location(node.input_id, 0);
-      if (position_location.size == 0)
-        continue; // absent slot; offset == 0 is a VALID location, so never test that
-      entry.position = dataset.reader->read(position_location, read_options_t{false, true, {}});
-
-      entry.attributes.resize(attribute_count);
-      for (uint32_t a = 0; a < attribute_count; a++)
-      {
-        if (request.buffers[a + 1].stride == 0)
-          continue; // no node has it at all
-        const auto index = dataset.attributes.get_attribute_index(node.attributes_id, names[a]);
-        if (index.index < 0)
-          continue; // this node lacks it: contributes zeros
-        const auto location = tree->storage_map.location(node.input_id, index.index);
-        if (location.size == 0)
-          continue;
-        entry.attributes[a] = dataset.reader->read(location, read_options_t{false, true, {}});
-      }
-      pending.push_back(std::move(entry));
+    entry.filters.resize(filter_count);
+    entry.filter_formats.resize(filter_count);
+    for (uint32_t f = 0; f < filter_count; f++)
+    {
+      const auto index = dataset.attributes.get_attribute_index(node.attributes_id, filter_names[f]);
+      if (index.index < 0)
+        continue;
+      const auto location = tree->storage_map.location(node.input_id, index.index);
+      if (location.size == 0)
+        continue;
+      entry.filter_formats[f] = index.format;
+      entry.filters[f] = dataset.reader->read(location, read_options_t{false, true, {}});
+      count_blob_read(stats, location, *entry.filters[f]);
+      issued_reads++;
     }
+    stats.peak_reads_in_flight = std::max(stats.peak_reads_in_flight, issued_reads + tree_reads);
+    if (!first_blob_issued)
+    {
+      first_blob_issued = true;
+      stats.time_to_first_blob_ms = elapsed_ms();
+    }
+    issued.push_back(std::move(entry));
+  };
 
-    // ---- await: they were all issued together, so the later ones are usually already done.
-    for (auto &entry : pending)
+  // Decode every issued node (their reads have all landed) into its slice, then record the nodes in
+  // issue order.
+  auto decode_issued = [&]() -> bool {
+    const bool single = areas.size() == 1;
+    const size_t region_count = areas.size();
+    auto append_start = std::chrono::steady_clock::now();
+    auto landed = [&stats](const std::shared_ptr<read_request_t> &read) {
+      if (read && read->error.code == 0)
+        stats.bytes_decompressed += read->buffer_info.size;
+    };
+    for (auto &entry : issued)
     {
-      co_await entry.position->await_on(loop);
+      landed(entry.position);
       for (auto &attribute : entry.attributes)
+        landed(attribute);
+      for (auto &filter : entry.filters)
+        landed(filter);
+    }
+
+    // ---- place, here on the loop and in issue order. [node * region_count + region]
+    std::vector<uint64_t> slots(issued.size() * region_count, k_no_slot);
+    if (!spec.aggregate)
+    {
+      for (size_t r = 0; r < region_count; r++)
       {
-        if (attribute)
-          co_await attribute->await_on(loop);
+        uint64_t end = region_slots[r];
+        for (size_t i = 0; i < issued.size(); i++)
+        {
+          if (!single && !area_overlaps(areas[r], issued[i].node.tight))
+            continue;
+          slots[i * region_count + r] = end;
+          end += issued[i].node.point_count.data;
+        }
+        // Reserve for every node the walk has found so far, not only this batch, so a converged walk
+        // sizes a lone region once. A batch region would over-reserve on nodes it may not overlap, so
+        // it grows geometrically instead.
+        uint64_t known = end;
+        if (single)
+        {
+          for (auto &node : ready)
+            known += node.point_count.data;
+        }
+        for (auto &buffer : request.regions[r].buffers)
+        {
+          if (!buffer.stride)
+            continue;
+          if (buffer.data.capacity() < known * buffer.stride)
+            buffer.data.reserve(std::max<size_t>(size_t(known * buffer.stride), buffer.data.capacity() * 2));
+          // Zero-filled, so a node lacking an attribute still contributes its full share and every
+          // buffer stays aligned with the positions.
+          buffer.data.resize(size_t(end * buffer.stride));
+        }
+        region_slots[r] = end;
       }
     }
 
     // ---- decode: pure CPU, so hop it to the pool. Under wasm the pool has no workers and runs the
-    // job inline, which must be equally correct.
-    std::vector<node_stage_t> stages(pending.size());
+    // job inline, which must be equally correct. Jobs write disjoint slices, and nothing resizes the
+    // buffers until every job is done.
+    stats.append_ms += ms_since(append_start);
+    const auto decode_start = std::chrono::steady_clock::now();
+    std::vector<node_stage_t> stages(issued.size());
     std::vector<std::future<void>> jobs;
-    jobs.reserve(pending.size());
-    for (size_t i = 0; i < pending.size(); i++)
+    jobs.reserve(issued.size());
+    for (size_t i = 0; i < issued.size(); i++)
     {
-      auto *entry = &pending[i];
+      auto *entry = &issued[i];
       auto *stage = &stages[i];
-      jobs.push_back(dataset.pool.enqueue([entry, stage, &dataset, &request, &spec, position_format, position_stride_bytes, attribute_count, &query]() {
-        stage->node = entry->node;
+      const uint64_t *node_slots = slots.data() + i * region_count;
+      jobs.push_back(dataset.pool.enqueue([entry, stage, node_slots, single, &request, &dataset, &layout, &spec, &areas, position_format, position_stride_bytes, attribute_count, filter_count,
+                                           &predicate_attribute, &predicate_filter]() {
+        const auto job_start = std::chrono::steady_clock::now();
+        auto job_ms = [job_start]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job_start).count(); };
+        stage->kept.assign(areas.size(), 0);
         if (entry->position->error.code != 0)
         {
           stage->error = entry->position->error;
@@ -261,93 +458,545 @@ vio::task_t<bool> run_region_request(dataset_impl_t &dataset, const region_job_t
           stage->error = split_error;
           return;
         }
-        const uint32_t offset = entry->node->offset_in_subset.data;
-        const uint32_t count = entry->node->point_count.data;
+        const uint32_t offset = entry->node.offset_in_subset.data;
+        const uint32_t count = entry->node.point_count.data;
         if (uint64_t(offset) + count > header.point_count)
           return; // subset does not fit the stored unit; skip rather than read out of bounds
-
         const uint32_t src_stride = uint32_t(size_for_format(header.point_format.type, header.point_format.components));
         const auto *src = static_cast<const uint8_t *>(point_data.data) + uint64_t(offset) * src_stride;
 
-        stage->positions.resize(size_t(count) * position_stride_bytes);
-        if (!decode_positions(src, count * src_stride, count, header.point_format, header.morton_min, header.lod_span, dataset.registry().tree_config, position_format, stage->positions.data(),
+        // A lone region decodes straight into its slice; a batch or an aggregate into staging.
+        const bool direct = single && !spec.aggregate;
+        uint8_t *positions = nullptr;
+        std::vector<attribute_span_t> spans(attribute_count, attribute_span_t{nullptr, 0});
+        if (direct)
+        {
+          auto &region = request.regions[0];
+          positions = region.buffers[0].data.data() + node_slots[0] * position_stride_bytes;
+          for (uint32_t a = 0; a < attribute_count; a++)
+          {
+            const uint32_t stride = layout[a + 1].stride;
+            if (stride)
+              spans[a] = attribute_span_t{region.buffers[a + 1].data.data() + node_slots[0] * stride, stride};
+          }
+        }
+        else
+        {
+          stage->positions.resize(size_t(count) * position_stride_bytes);
+          positions = stage->positions.data();
+          stage->attributes.resize(attribute_count);
+          for (uint32_t a = 0; a < attribute_count; a++)
+          {
+            const uint32_t stride = layout[a + 1].stride;
+            if (!stride)
+              continue;
+            stage->attributes[a].assign(size_t(count) * stride, uint8_t(0));
+            spans[a] = attribute_span_t{stage->attributes[a].data(), stride};
+          }
+        }
+
+        if (!decode_positions(src, count * src_stride, count, header.point_format, header.morton_min, header.lod_span, dataset.registry().tree_config, position_format, positions,
                               uint64_t(count) * position_stride_bytes, stage->origin))
         {
           stage->error = {1, "failed to decode node positions"};
           return;
         }
-
-        stage->attributes.resize(attribute_count);
-        std::vector<attribute_span_t> spans(attribute_count, attribute_span_t{nullptr, 0});
         for (uint32_t a = 0; a < attribute_count; a++)
         {
-          const uint32_t stride = request.buffers[a + 1].stride;
-          if (stride == 0)
-            continue;
-          // Zero-filled by default, so a node lacking the attribute still contributes its full share
-          // and every buffer stays aligned with the positions.
-          stage->attributes[a].assign(size_t(count) * stride, uint8_t(0));
+          const uint32_t stride = spans[a].stride;
           auto &source = entry->attributes[a];
-          if (source && source->error.code == 0 && uint64_t(offset + count) * stride <= source->buffer_info.size)
-            memcpy(stage->attributes[a].data(), static_cast<const uint8_t *>(source->buffer_info.data) + uint64_t(offset) * stride, size_t(count) * stride);
-          spans[a] = attribute_span_t{stage->attributes[a].data(), stride};
+          if (stride && source && source->error.code == 0 && uint64_t(offset + count) * stride <= source->buffer_info.size)
+            memcpy(spans[a].data, static_cast<const uint8_t *>(source->buffer_info.data) + uint64_t(offset) * stride, size_t(count) * stride);
         }
 
         uint32_t kept = count;
-        if (spec.clip_mode == dew_clip_point && !query.whole_dataset && !entry->node->fully_inside)
+        if (!spec.predicates.empty())
         {
-          kept = clip_to_box(stage->positions.data(), position_format, stage->origin, dataset.registry().tree_config.scale, count, spec.box_min, spec.box_max, spans.data(), attribute_count);
-          stage->positions.resize(size_t(kept) * position_stride_bytes);
-          for (uint32_t a = 0; a < attribute_count; a++)
+          std::vector<std::vector<uint8_t>> filter_values(filter_count);
+          for (uint32_t f = 0; f < filter_count; f++)
           {
-            const uint32_t stride = request.buffers[a + 1].stride;
-            if (stride)
-              stage->attributes[a].resize(size_t(kept) * stride);
+            auto &source = entry->filters[f];
+            const uint32_t stride = uint32_t(size_for_format(entry->filter_formats[f].type, entry->filter_formats[f].components));
+            if (!source || source->error.code != 0 || stride == 0 || uint64_t(offset + count) * stride > source->buffer_info.size)
+              continue; // lacks it: reads as zeros
+            const auto *begin = static_cast<const uint8_t *>(source->buffer_info.data) + uint64_t(offset) * stride;
+            filter_values[f].assign(begin, begin + size_t(count) * stride);
+          }
+          std::vector<predicate_input_t> inputs(spec.predicates.size());
+          for (size_t p = 0; p < inputs.size(); p++)
+          {
+            inputs[p].predicate = &spec.predicates[p];
+            inputs[p].data = nullptr;
+            if (predicate_attribute[p] >= 0)
+            {
+              const auto &out = layout[size_t(predicate_attribute[p]) + 1];
+              inputs[p].format = {out.type, out.components};
+              inputs[p].data = spans[size_t(predicate_attribute[p])].data;
+            }
+            else
+            {
+              const auto f = size_t(predicate_filter[p]);
+              inputs[p].format = entry->filter_formats[f];
+              if (!filter_values[f].empty())
+                inputs[p].data = filter_values[f].data();
+            }
           }
+          kept = filter_by_predicates(inputs.data(), uint32_t(inputs.size()), positions, position_stride_bytes, kept, spans.data(), attribute_count);
+        }
+
+        // ---- clip, in place, in whichever buffer the points now sit.
+        const double scale = dataset.registry().tree_config.scale;
+        auto clip = [&](const region_area_t &area, bool inside, uint8_t *clip_positions, attribute_span_t *clip_spans, uint32_t n) {
+          if (spec.clip_mode != dew_clip_point || inside)
+            return n;
+          const auto clip_start = std::chrono::steady_clock::now();
+          if (!area.whole_dataset)
+            n = clip_to_box(clip_positions, position_format, stage->origin, scale, n, area.box.min, area.box.max, clip_spans, attribute_count);
+          if (area.geometry.kind != geometry_kind_t::box)
+            n = clip_to_geometry(clip_positions, position_format, stage->origin, scale, n, area.geometry, clip_spans, attribute_count);
+          stage->clip_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - clip_start).count();
+          return n;
+        };
+
+        if (direct)
+        {
+          stage->kept[0] = clip(areas[0], entry->node.fully_inside, positions, spans.data(), kept);
+        }
+        else if (spec.aggregate)
+        {
+          // ---- reduce: an aggregate request keeps only the node's partial, never its points.
+          if (!single && !area_overlaps(areas[0], entry->node.tight))
+            kept = 0;
+          const bool inside = single ? entry->node.fully_inside : area_contains(areas[0], entry->node.tight);
+          kept = clip(areas[0], inside, positions, spans.data(), kept);
+          const uint8_t *values = nullptr;
+          point_format_t value_format;
+          if (attribute_count && layout[1].stride)
+          {
+            values = spans[0].data;
+            value_format = point_format_t(layout[1].type, layout[1].components);
+          }
+          // Positions are r64 absolute for an aggregate, so they are the world-space doubles it wants.
+          aggregate_points(spec.aggregate_spec, reinterpret_cast<const double *>(positions), values, value_format, kept, stage->partial);
+          stage->positions = {};
+          stage->attributes = {};
+        }
+        else
+        {
+          // ---- scatter: copy the decoded node into the slice of every region that overlaps it; each
+          // then clips its own copy.
+          for (size_t r = 0; r < areas.size(); r++)
+          {
+            if (node_slots[r] == k_no_slot)
+              continue;
+            auto &region = request.regions[r];
+            uint8_t *region_positions = region.buffers[0].data.data() + node_slots[r] * position_stride_bytes;
+            memcpy(region_positions, positions, size_t(kept) * position_stride_bytes);
+            std::vector<attribute_span_t> region_spans(attribute_count, attribute_span_t{nullptr, 0});
+            for (uint32_t a = 0; a < attribute_count; a++)
+            {
+              const uint32_t stride = spans[a].stride;
+              if (!stride)
+                continue;
+              region_spans[a] = attribute_span_t{region.buffers[a + 1].data.data() + node_slots[r] * stride, stride};
+              memcpy(region_spans[a].data, spans[a].data, size_t(kept) * stride);
+            }
+            const bool inside = single ? entry->node.fully_inside : area_contains(areas[r], entry->node.tight);
+            stage->kept[r] = clip(areas[r], inside, region_positions, region_spans.data(), kept);
+          }
+          stage->positions = {};
+          stage->attributes = {};
         }
-        stage->kept = kept;
         stage->valid = true;
+        stage->job_ms = job_ms();
       }));
     }
     for (auto &job : jobs)
       job.get();
 
-    // ---- append in WALK ORDER, on this loop. Output is therefore identical no matter how many
-    // decode threads ran, which is what makes the result reproducible.
-    for (auto &stage : stages)
+    // The jobs overlap, so their thread times add up to more than the phase took; the phase's wall
+    // time is split between decoding and clipping in proportion instead.
     {
+      const double phase_ms = ms_since(decode_start);
+      double job_total = 0;
+      double clip_total = 0;
+      for (auto &stage : stages)
+      {
+        job_total += stage.job_ms;
+        clip_total += stage.clip_ms;
+      }
+      const double clip_share = job_total > 0 ? std::min(1.0, clip_total / job_total) : 0.0;
+      stats.clip_ms += phase_ms * clip_share;
+      stats.decode_ms += phase_ms * (1.0 - clip_share);
+    }
+    append_start = std::chrono::steady_clock::now();
+
+    // ---- record in WALK ORDER, on this loop. The slices were fixed before the decode, so the output
+    // is identical no matter how many decode threads ran, which is what makes it reproducible.
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+      auto &stage = stages[i];
+      const auto &node = issued[i].node;
       if (stage.error.code != 0)
       {
         request.error = stage.error;
-        co_return false;
+        return false;
+      }
+      if (spec.aggregate)
+      {
+        if (!stage.valid)
+          continue;
+        if (stage.partial.point_count && node.is_lod)
+          request.aggregate_used_lod = true;
+        aggregate_merge(stage.partial, request.aggregate);
+        continue;
+      }
+
+      for (size_t r = 0; r < region_count; r++)
+      {
+        const uint64_t slot = slots[i * region_count + r];
+        if (slot == k_no_slot)
+          continue;
+        const uint32_t kept = stage.valid ? stage.kept[r] : 0;
+        placed[r].push_back(placed_t{slot, kept});
+        if (kept != node.point_count.data)
+          region_gapped[r] = 1;
+        if (kept == 0)
+          continue;
+
+        auto &region = request.regions[r];
+        dew_result_node_t result_node{};
+        result_node.tree_id = node.tree_id.data;
+        result_node.level = node.level;
+        result_node.index = node.index;
+        result_node.lod = node.lod;
+        // Where the points sit once the gaps are closed, which is where an append would have put them.
+        result_node.first_point = region.point_count;
+        result_node.point_count = kept;
+        for (int c = 0; c < 3; c++)
+          result_node.position_offset[c] = stage.origin[c];
+        result_node.is_leaf = node.is_leaf ? 1 : 0;
+        result_node.is_lod = node.is_lod ? 1 : 0;
+        region.nodes.push_back(result_node);
+        region.point_count += kept;
+        if (spec.lod_mode == dew_lod_sample)
+          sample_represents.push_back(node.represents);
+      }
+    }
+    stats.append_ms += ms_since(append_start);
+    return true;
+  };
+
+  // ---- compact: close the gaps predicates and clipping left behind. Each node's kept points move to
+  // the running count -- the offsets its result node already carries -- in one parallel pass per
+  // buffer, into a buffer of the exact final size. Regions without gaps are already exact.
+  auto compact_regions = [&]() {
+    constexpr size_t k_nodes_per_job = 64;
+    for (size_t r = 0; r < areas.size(); r++)
+    {
+      if (!region_gapped[r])
+        continue;
+      auto &region = request.regions[r];
+      const auto &nodes = placed[r];
+      std::vector<uint64_t> first(nodes.size());
+      uint64_t running = 0;
+      for (size_t n = 0; n < nodes.size(); n++)
+      {
+        first[n] = running;
+        running += nodes[n].kept;
+      }
+      for (auto &buffer : region.buffers)
+      {
+        if (!buffer.stride)
+          continue;
+        std::vector<uint8_t> compacted(size_t(region.point_count * buffer.stride));
+        std::vector<std::future<void>> jobs;
+        for (size_t begin = 0; begin < nodes.size(); begin += k_nodes_per_job)
+        {
+          const size_t end = std::min(nodes.size(), begin + k_nodes_per_job);
+          jobs.push_back(dataset.pool.enqueue([&nodes, &first, &buffer, &compacted, begin, end]() {
+            const size_t stride = buffer.stride;
+            for (size_t n = begin; n < end; n++)
+            {
+              if (nodes[n].kept)
+                memcpy(compacted.data() + first[n] * stride, buffer.data.data() + nodes[n].slot * stride, size_t(nodes[n].kept) * stride);
+            }
+          }));
+        }
+        for (auto &job : jobs)
+          job.get();
+        buffer.data = std::move(compacted);
       }
-      if (!stage.valid || stage.kept == 0)
+    }
+  };
+
+  // ---- draw: dew_lod_sample takes exactly max_points of what came back, without replacement. Every
+  // node gets a share in proportion to the source points it stands for -- its own points, or for a
+  // sampled unit everything below it -- capped at what it holds, with the excess handed on to the
+  // rest until the sample is full. Then each node draws its share from its own seeded generator, so
+  // the sample depends on the seed and the data alone, never on thread scheduling.
+  auto draw_sample = [&]() {
+    auto &region = request.regions[0];
+    const size_t node_count = region.nodes.size();
+    std::vector<uint64_t> quota(node_count, 0);
+    uint64_t left = std::min<uint64_t>(spec.max_points, region.point_count);
+    while (left > 0)
+    {
+      double weight = 0;
+      for (size_t n = 0; n < node_count; n++)
+      {
+        if (quota[n] < region.nodes[n].point_count)
+          weight += double(region.nodes[n].point_count) * sample_represents[n];
+      }
+      if (!(weight > 0))
+        break;
+      std::vector<std::pair<double, size_t>> remainders;
+      uint64_t given = 0;
+      for (size_t n = 0; n < node_count; n++)
+      {
+        const uint64_t room = region.nodes[n].point_count - quota[n];
+        if (room == 0)
+          continue;
+        const double share = double(left) * double(region.nodes[n].point_count) * sample_represents[n] / weight;
+        const uint64_t whole = std::min<uint64_t>(room, uint64_t(share));
+        quota[n] += whole;
+        given += whole;
+        remainders.emplace_back(share - std::floor(share), n);
+      }
+      if (given > 0)
+      {
+        left -= std::min(left, given);
         continue;
+      }
+      // Every share is under one point: the largest remainders take one each.
+      std::stable_sort(remainders.begin(), remainders.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+      for (size_t i = 0; i < remainders.size() && left > 0; i++, left--)
+        quota[remainders[i].second]++;
+    }
 
-      positions.data.insert(positions.data.end(), stage.positions.begin(), stage.positions.end());
-      for (uint32_t a = 0; a < attribute_count; a++)
+    std::vector<uint64_t> first(node_count, 0);
+    uint64_t total = 0;
+    for (size_t n = 0; n < node_count; n++)
+    {
+      first[n] = total;
+      total += quota[n];
+    }
+
+    // Which rows each node keeps, ascending so a node's points stay in their stored order.
+    std::vector<std::vector<uint32_t>> rows(node_count);
+    {
+      std::vector<std::future<void>> jobs;
+      constexpr size_t k_nodes_per_job = 64;
+      for (size_t begin = 0; begin < node_count; begin += k_nodes_per_job)
       {
-        auto &out = request.buffers[a + 1];
-        if (out.stride)
-          out.data.insert(out.data.end(), stage.attributes[a].begin(), stage.attributes[a].end());
+        const size_t end = std::min(node_count, begin + k_nodes_per_job);
+        jobs.push_back(dataset.pool.enqueue([&rows, &quota, &region, &spec, begin, end]() {
+          for (size_t n = begin; n < end; n++)
+          {
+            const auto count = uint32_t(region.nodes[n].point_count);
+            if (quota[n] == 0 || quota[n] == count)
+              continue; // none or all of it: no draw needed
+            // splitmix64, seeded per node: cheap, and identical on every platform, which the
+            // standard distributions are not.
+            uint64_t state = spec.sample_seed ^ (0x9e3779b97f4a7c15ull * (n + 1));
+            auto next = [&state]() {
+              uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+              z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+              z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+              return z ^ (z >> 31);
+            };
+            // A partial Fisher-Yates shuffle: the first `quota` entries are a uniform draw.
+            std::vector<uint32_t> order(count);
+            for (uint32_t i = 0; i < count; i++)
+              order[i] = i;
+            for (uint32_t i = 0; i < quota[n]; i++)
+              std::swap(order[i], order[i + uint32_t(next() % (count - i))]);
+            order.resize(size_t(quota[n]));
+            std::sort(order.begin(), order.end());
+            rows[n] = std::move(order);
+          }
+        }));
       }
+      for (auto &job : jobs)
+        job.get();
+    }
 
-      dew_result_node_t result_node{};
-      result_node.tree_id = stage.node->tree_id.data;
-      result_node.level = stage.node->level;
-      result_node.index = stage.node->index;
-      result_node.lod = stage.node->lod;
-      result_node.first_point = request.point_count;
-      result_node.point_count = stage.kept;
-      for (int i = 0; i < 3; i++)
-        result_node.position_offset[i] = stage.origin[i];
-      result_node.is_leaf = stage.node->is_leaf ? 1 : 0;
-      result_node.is_lod = stage.node->is_lod ? 1 : 0;
-      request.nodes.push_back(result_node);
-      request.point_count += stage.kept;
+    for (auto &buffer : region.buffers)
+    {
+      if (!buffer.stride)
+        continue;
+      std::vector<uint8_t> drawn(size_t(total * buffer.stride));
+      std::vector<std::future<void>> jobs;
+      constexpr size_t k_nodes_per_job = 64;
+      for (size_t begin = 0; begin < node_count; begin += k_nodes_per_job)
+      {
+        const size_t end = std::min(node_count, begin + k_nodes_per_job);
+        jobs.push_back(dataset.pool.enqueue([&rows, &quota, &first, &region, &buffer, &drawn, begin, end]() {
+          const size_t stride = buffer.stride;
+          for (size_t n = begin; n < end; n++)
+          {
+            const uint8_t *source = buffer.data.data() + region.nodes[n].first_point * stride;
+            uint8_t *target = drawn.data() + first[n] * stride;
+            if (quota[n] == region.nodes[n].point_count)
+            {
+              memcpy(target, source, size_t(quota[n]) * stride);
+              continue;
+            }
+            for (size_t i = 0; i < rows[n].size(); i++)
+              memcpy(target + i * stride, source + size_t(rows[n][i]) * stride, stride);
+          }
+        }));
+      }
+      for (auto &job : jobs)
+        job.get();
+      buffer.data = std::move(drawn);
+    }
+
+    // Nodes the draw left empty are dropped, as a clip that emptied them would have been.
+    size_t kept = 0;
+    for (size_t n = 0; n < node_count; n++)
+    {
+      if (quota[n] == 0)
+        continue;
+      auto node = region.nodes[n];
+      node.first_point = first[n];
+      node.point_count = quota[n];
+      region.nodes[kept++] = node;
+    }
+    region.nodes.resize(kept);
+    region.point_count = total;
+  };
+
+  // Install a landed sub-tree and walk on below it.
+  dew_error_t load_error;
+  auto descend_into = [&](subtree_load_t &load) -> bool {
+    if (load.read)
+    {
+      tree_reads--;
+      if (!dataset.trees->finish_load(load.at.tree_id, *load.read, load_error))
+        return false;
+    }
+    const auto walk_start = std::chrono::steady_clock::now();
+    region_walk_subtree(dataset.registry(), query, load.at, walked);
+    stats.walk_ms += ms_since(walk_start);
+    stats.walk_rounds++;
+    stats.nodes_walked += walked.visited_nodes;
+    take(walked);
+    return true;
+  };
+
+  bool ok = true;
+  while (!ready.empty() || !to_fetch.empty() || !loading.empty())
+  {
+    if (request.status.load(std::memory_order_acquire) == dew_request_canceled)
+    {
+      ok = false;
+      break;
+    }
+
+    // ---- descend: every sub-tree that has landed, oldest first, so each branch continues as soon
+    // as it can without the order of landing leaking into the result.
+    while (ok && !loading.empty() && (!loading.front().read || loading.front().read->is_done()))
+    {
+      ok = descend_into(loading.front());
+      loading.pop_front();
+    }
+    if (!ok)
+      break;
+
+    // ---- issue: sub-trees first, since they gate everything below them, then as many finalised
+    // nodes as the budget allows.
+    while (!to_fetch.empty() && tree_reads + issued_reads < read_budget)
+    {
+      subtree_load_t load{to_fetch.front(), dataset.trees->begin_load(to_fetch.front().tree_id, load_error)};
+      to_fetch.pop_front();
+      if (load_error.code != 0)
+      {
+        ok = false;
+        break;
+      }
+      if (load.read)
+      {
+        tree_reads++;
+        stats.trees_loaded++;
+        stats.peak_reads_in_flight = std::max(stats.peak_reads_in_flight, issued_reads + tree_reads);
+      }
+      loading.push_back(std::move(load));
+    }
+    if (!ok)
+      break;
+    while (!ready.empty() && (tree_reads + issued_reads == 0 || tree_reads + issued_reads + reads_per_node <= read_budget))
+    {
+      issue_node(ready.front());
+      ready.pop_front();
+    }
+
+    // ---- wait: for the node reads when there are any -- they were all issued together, so the later
+    // ones are usually already done -- and otherwise for the oldest sub-tree. Sub-tree reads keep
+    // landing meanwhile; the next pass descends into them.
+    if (!issued.empty())
+    {
+      bool waited = false;
+      const auto wait_start = std::chrono::steady_clock::now();
+      for (auto &entry : issued)
+      {
+        waited = waited || !entry.position->is_done();
+        co_await entry.position->await_on(loop);
+        for (auto &attribute : entry.attributes)
+        {
+          if (!attribute)
+            continue;
+          waited = waited || !attribute->is_done();
+          co_await attribute->await_on(loop);
+        }
+        for (auto &filter : entry.filters)
+        {
+          if (!filter)
+            continue;
+          waited = waited || !filter->is_done();
+          co_await filter->await_on(loop);
+        }
+      }
+      stats.io_wait_ms += ms_since(wait_start);
+      if (waited)
+        stats.round_trips++;
+      ok = decode_issued();
+      issued.clear();
+      issued_reads = 0;
+      if (!ok)
+        break;
+    }
+    else if (!loading.empty() && loading.front().read)
+    {
+      if (!loading.front().read->is_done())
+        stats.round_trips++;
+      const auto wait_start = std::chrono::steady_clock::now();
+      co_await loading.front().read->await_on(loop);
+      stats.io_wait_ms += ms_since(wait_start);
     }
   }
 
+  if (!ok)
+  {
+    // Every begun sub-tree load is still finished -- the tree set counts them -- and installed, since
+    // the next request will probably want it.
+    for (auto &load : loading)
+    {
+      if (!load.read)
+        continue;
+      co_await load.read->await_on(loop);
+      dew_error_t ignored;
+      dataset.trees->finish_load(load.at.tree_id, *load.read, ignored);
+    }
+    if (load_error.code != 0)
+      request.error = load_error;
+    co_return false;
+  }
+  const auto append_start = std::chrono::steady_clock::now();
+  compact_regions();
+  if (spec.lod_mode == dew_lod_sample)
+    draw_sample();
+  stats.append_ms += ms_since(append_start);
   co_return true;
 }
 
@@ -362,8 +1011,11 @@ void dataset_impl_t::spawn_region_request(region_job_t job, std::shared_ptr<dew_
   auto *dataset = this;
   loop_thread.event_loop().run_in_loop([dataset, job = std::move(job), request]() mutable {
     [](dataset_impl_t *ds, region_job_t j, std::shared_ptr<dew_request_t> r) -> vio::detached_task_t {
-      const bool ok = co_await run_region_request(*ds, j, *r);
-      r->finish(ok ? dew_request_completed : dew_request_failed);
+      const auto started = std::chrono::steady_clock::now();
+      dew_request_stats_t stats{};
+      const bool ok = co_await run_region_request(*ds, j, *r, stats, started);
+      stats.total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+      r->finish(ok ? dew_request_completed : dew_request_failed, stats);
       // Queue for delivery and raise the wake. The callback itself runs later, on the host thread.
       ds->publish(r);
     }(dataset, std::move(job), request);
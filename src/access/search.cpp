@@ -0,0 +1,771 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+
+#include "dataset_impl.hpp"
+
+#include "format_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+namespace dew::access
+{
+
+namespace
+{
+
+constexpr uint32_t k_no_node = std::numeric_limits<uint32_t>::max();
+
+double box_distance2(const aabb_t &box, const double p[3])
+{
+  double d2 = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    const double d = p[i] < box.min[i] ? box.min[i] - p[i] : (p[i] > box.max[i] ? p[i] - box.max[i] : 0.0);
+    d2 += d * d;
+  }
+  return d2;
+}
+
+// A bounding-box hierarchy over what one walk emitted: its nodes' tight boxes and the cells of the
+// sub-trees it stopped at. The walk hands back a flat frontier; this puts it back into a tree a query
+// can descend nearest-first, without sorting the whole frontier once per query point. Every sub-tree
+// some query reaches is walked once in turn and gets a hierarchy of its own in the same entries.
+constexpr uint32_t k_subtree_ref = uint32_t(1) << 31; // marks an `order` item as a sub-tree
+
+struct node_hierarchy_t
+{
+  struct entry_t
+  {
+    aabb_t box{{0, 0, 0}, {0, 0, 0}};
+    uint32_t first = 0; // into `order`, for a leaf entry
+    uint32_t count = 0; // 0 for an inner entry
+    uint32_t children[2] = {0, 0};
+  };
+  std::vector<entry_t> entries;
+  std::vector<uint32_t> order; // node indices, or sub-tree indices | k_subtree_ref, grouped by leaf entry
+};
+
+constexpr uint32_t k_nodes_per_leaf_entry = 4;
+
+const aabb_t &item_box(const std::vector<region_node_t> &nodes, const std::vector<region_subtree_t> &subtrees, uint32_t item)
+{
+  return item & k_subtree_ref ? subtrees[item & ~k_subtree_ref].cell : nodes[item].tight;
+}
+
+uint32_t build_entry(node_hierarchy_t &hierarchy, const std::vector<region_node_t> &nodes, const std::vector<region_subtree_t> &subtrees, uint32_t first, uint32_t count)
+{
+  const auto index = uint32_t(hierarchy.entries.size());
+  hierarchy.entries.emplace_back();
+  aabb_t box = item_box(nodes, subtrees, hierarchy.order[first]);
+  for (uint32_t i = 1; i < count; i++)
+  {
+    const auto &item = item_box(nodes, subtrees, hierarchy.order[first + i]);
+    for (int c = 0; c < 3; c++)
+    {
+      box.min[c] = std::min(box.min[c], item.min[c]);
+      box.max[c] = std::max(box.max[c], item.max[c]);
+    }
+  }
+  hierarchy.entries[index].box = box;
+  if (count <= k_nodes_per_leaf_entry)
+  {
+    hierarchy.entries[index].first = first;
+    hierarchy.entries[index].count = count;
+    return index;
+  }
+
+  // Split at the median along the longest axis; ties broken by item so the tree is the same on every
+  // run.
+  int axis = 0;
+  for (int c = 1; c < 3; c++)
+  {
+    if (box.max[c] - box.min[c] > box.max[axis] - box.min[axis])
+      axis = c;
+  }
+  auto centre = [&](uint32_t item) {
+    const auto &b = item_box(nodes, subtrees, item);
+    return b.min[axis] + b.max[axis];
+  };
+  const uint32_t half = count / 2;
+  const auto begin = hierarchy.order.begin() + ptrdiff_t(first);
+  std::nth_element(begin, begin + ptrdiff_t(half), begin + ptrdiff_t(count), [&](uint32_t a, uint32_t b) {
+    const double ca = centre(a);
+    const double cb = centre(b);
+    return ca < cb || (ca == cb && a < b);
+  });
+  const uint32_t left = build_entry(hierarchy, nodes, subtrees, first, half);
+  const uint32_t right = build_entry(hierarchy, nodes, subtrees, first + half, count - half);
+  hierarchy.entries[index].children[0] = left;
+  hierarchy.entries[index].children[1] = right;
+  return index;
+}
+
+// A hierarchy over nodes [first_node, +node_count) and sub-trees [first_subtree, +subtree_count);
+// its root entry, or k_no_node when there is nothing in it.
+uint32_t build_hierarchy(node_hierarchy_t &hierarchy, const std::vector<region_node_t> &nodes, const std::vector<region_subtree_t> &subtrees, uint32_t first_node, uint32_t node_count,
+                         uint32_t first_subtree, uint32_t subtree_count)
+{
+  if (node_count + subtree_count == 0)
+    return k_no_node;
+  const auto first = uint32_t(hierarchy.order.size());
+  for (uint32_t i = 0; i < node_count; i++)
+    hierarchy.order.push_back(first_node + i);
+  for (uint32_t i = 0; i < subtree_count; i++)
+    hierarchy.order.push_back((first_subtree + i) | k_subtree_ref);
+  return build_entry(hierarchy, nodes, subtrees, first, node_count + subtree_count);
+}
+
+// Where a node sits in the octree, which -- unlike its index here, which follows the order the search
+// happened to walk it in, and so what was resident -- is the same on every run.
+uint64_t node_key(const region_node_t &node)
+{
+  return (uint64_t(node.tree_id.data) << 32) | (uint64_t(node.level) << 16) | node.index;
+}
+
+// One node's points, decoded once and shared by every query point that visits it.
+struct decoded_node_t
+{
+  std::vector<double> xyz;
+  std::vector<std::vector<uint8_t>> attributes;
+};
+
+// Something a query still has to visit: a hierarchy entry, a sub-tree the walk stopped at, or a
+// node. Ordered nearest first, ties broken so the visiting order never depends on timing.
+enum class frontier_kind_t : uint8_t
+{
+  entry,
+  subtree,
+  node,
+};
+struct frontier_item_t
+{
+  double distance2;
+  uint32_t index;
+  frontier_kind_t kind;
+};
+bool nearer(const frontier_item_t &a, const frontier_item_t &b)
+{
+  if (a.distance2 != b.distance2)
+    return a.distance2 < b.distance2;
+  if (a.kind != b.kind)
+    return a.kind < b.kind;
+  return a.index < b.index;
+}
+
+struct neighbour_t
+{
+  double distance2;
+  uint64_t key; // node_key of its node: the tie-break
+  uint32_t node;
+  uint32_t point;
+};
+bool nearer(const neighbour_t &a, const neighbour_t &b)
+{
+  if (a.distance2 != b.distance2)
+    return a.distance2 < b.distance2;
+  if (a.key != b.key)
+    return a.key < b.key;
+  return a.point < b.point;
+}
+
+// Where one query point's best-first descent stands. It runs until it needs a node that is not
+// decoded yet, or a sub-tree that is not walked yet, then waits for the next round.
+struct query_state_t
+{
+  std::vector<frontier_item_t> frontier; // a min-heap on nearer()
+  std::vector<neighbour_t> found;        // knn: a max-heap of the k best; radius: every hit
+  bool done = false;
+  uint32_t waiting_node = k_no_node;
+  uint32_t waiting_subtree = k_no_node;
+  // Once done: `found` nearest first, and its points copied out of the decoded nodes -- xyz, then per
+  // requested attribute its bytes -- so those nodes can be dropped while the rest of the batch runs.
+  std::vector<double> kept_xyz;
+  std::vector<std::vector<uint8_t>> kept_attributes;
+};
+
+} // namespace
+
+// Execute a kNN or radius search: let every query point descend the octree nearest-first, through the
+// nodes and the sub-trees alike. Nodes are read and decoded, and sub-trees loaded and walked, only
+// when some query reaches them, in rounds -- each round advances every query as far as what is
+// decoded and walked allows, then reads what the stalled ones wait for -- and what is read is kept for
+// the rest of the batch, so neighbouring query points share their reads. A search around one seed
+// therefore loads the sub-trees around it, not the whole hierarchy. The decoded nodes are held to the
+// dataset's decoded-bytes budget: past it, a node no unfinished query still refers to is dropped, and
+// read again should a later expansion reach it.
+vio::task_t<bool> run_search_request(dataset_impl_t &dataset, const search_job_t &spec, request_impl_t &request, dew_request_stats_t &stats, std::chrono::steady_clock::time_point started)
+{
+  const auto query_count = uint32_t(spec.query_points.size() / 3);
+  const double cap2 = spec.radius > 0 ? spec.radius * spec.radius : std::numeric_limits<double>::infinity();
+
+  auto &loop = dataset.loop_thread.event_loop();
+  auto ms_since = [](std::chrono::steady_clock::time_point start) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+  // ---- walk: the box the answers can lie in when there is a radius, otherwise everything -- but only
+  // through what is resident. The sub-trees it stops at join the queries' frontiers like nodes do.
+  region_query_t query;
+  query.lod_mode = lod_mode_t::full;
+  query.attributes = &dataset.attributes;
+  if (spec.radius > 0)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      query.box.min[c] = std::numeric_limits<double>::max();
+      query.box.max[c] = std::numeric_limits<double>::lowest();
+    }
+    for (uint32_t q = 0; q < query_count; q++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        query.box.min[c] = std::min(query.box.min[c], spec.query_points[size_t(q) * 3 + size_t(c)] - spec.radius);
+        query.box.max[c] = std::max(query.box.max[c], spec.query_points[size_t(q) * 3 + size_t(c)] + spec.radius);
+      }
+    }
+  }
+  else
+  {
+    query.whole_dataset = true;
+  }
+  // Every node and sub-tree any walk has emitted so far. Written only on the dataset loop between
+  // rounds; the advance jobs only read them.
+  std::vector<region_node_t> nodes;
+  std::vector<region_subtree_t> subtrees;
+  // Per sub-tree, the root entry of its walk's hierarchy once it is walked; k_no_node before that,
+  // k_empty_subtree when the walk found nothing in it.
+  constexpr uint32_t k_empty_subtree = k_no_node - 1;
+  std::vector<uint32_t> subtree_entry;
+  node_hierarchy_t hierarchy;
+  region_result_t walked;
+  auto add_walked = [&]() {
+    const auto first_node = uint32_t(nodes.size());
+    const auto first_subtree = uint32_t(subtrees.size());
+    nodes.insert(nodes.end(), walked.nodes.begin(), walked.nodes.end());
+    subtrees.insert(subtrees.end(), walked.subtrees_to_load.begin(), walked.subtrees_to_load.end());
+    subtree_entry.resize(subtrees.size(), k_no_node);
+    stats.walk_rounds++;
+    stats.nodes_walked += walked.visited_nodes;
+    return build_hierarchy(hierarchy, nodes, subtrees, first_node, uint32_t(walked.nodes.size()), first_subtree, uint32_t(walked.subtrees_to_load.size()));
+  };
+
+  if (!dataset.registry().data.empty() && !dataset.trees->resident(dataset.registry().root))
+  {
+    dew_error_t load_error;
+    const auto wait_start = std::chrono::steady_clock::now();
+    stats.peak_reads_in_flight = std::max(stats.peak_reads_in_flight, uint32_t(1));
+    if (!co_await dataset.trees->load(dataset.registry().root, load_error))
+    {
+      request.error = load_error.code ? load_error : dew_error_t{1, "search walk failed"};
+      co_return false;
+    }
+    stats.io_wait_ms += ms_since(wait_start);
+    stats.trees_loaded++;
+    stats.round_trips++;
+  }
+  const auto walk_start = std::chrono::steady_clock::now();
+  region_walk(dataset.registry(), query, walked);
+  const uint32_t root_entry = add_walked();
+  stats.walk_ms += ms_since(walk_start);
+
+  // Buffer 0 is the positions, always r64 absolute; requested attributes follow in the order given.
+  const auto attribute_count = uint32_t(spec.attribute_names.size());
+  std::vector<out_buffer_t> layout(size_t(attribute_count) + 1);
+  layout[0].name = "xyz";
+  layout[0].type = dew_type_r64;
+  layout[0].components = dew_components_3;
+  layout[0].stride = uint32_t(3 * sizeof(double));
+  for (uint32_t a = 0; a < attribute_count; a++)
+  {
+    auto &out = layout[a + 1];
+    out.name = spec.attribute_names[a];
+    const auto index = dataset.attributes.find_attribute(out.name);
+    if (index.index < 0)
+      continue;
+    out.type = index.format.type;
+    out.components = index.format.components;
+    out.stride = uint32_t(size_for_format(index.format.type, index.format.components));
+  }
+
+  std::vector<query_state_t> states(query_count);
+  if (root_entry != k_no_node)
+  {
+    for (uint32_t q = 0; q < query_count; q++)
+      states[q].frontier.push_back({box_distance2(hierarchy.entries[root_entry].box, &spec.query_points[size_t(q) * 3]), root_entry, frontier_kind_t::entry});
+  }
+  else
+  {
+    for (auto &state : states)
+      state.done = true;
+  }
+
+  // Like `nodes`: written only on the dataset loop between rounds.
+  std::vector<std::unique_ptr<const decoded_node_t>> decoded(nodes.size());
+  uint64_t decoded_bytes = 0;
+  auto node_bytes = [](const decoded_node_t &node) {
+    uint64_t bytes = node.xyz.size() * sizeof(double);
+    for (const auto &attribute : node.attributes)
+      bytes += attribute.size();
+    return bytes;
+  };
+
+  const auto heap_order = [](const frontier_item_t &a, const frontier_item_t &b) { return nearer(b, a); };
+  const auto found_order = [](const neighbour_t &a, const neighbour_t &b) { return nearer(a, b); };
+  auto bound = [&](const query_state_t &state) {
+    if (spec.knn && state.found.size() == spec.k)
+      return state.found.front().distance2;
+    return cap2;
+  };
+
+  // Descend one query as far as the decoded nodes and walked sub-trees allow.
+  auto advance = [&](uint32_t q) {
+    auto &state = states[q];
+    const double *p = &spec.query_points[size_t(q) * 3];
+    state.waiting_node = k_no_node;
+    state.waiting_subtree = k_no_node;
+    auto push = [&](frontier_item_t item) {
+      state.frontier.push_back(item);
+      std::push_heap(state.frontier.begin(), state.frontier.end(), heap_order);
+    };
+    while (!state.frontier.empty())
+    {
+      const auto top = state.frontier.front();
+      if (top.distance2 > bound(state))
+        break;
+      if (top.kind == frontier_kind_t::node && !decoded[top.index])
+      {
+        state.waiting_node = top.index;
+        return;
+      }
+      if (top.kind == frontier_kind_t::subtree && subtree_entry[top.index] == k_no_node)
+      {
+        state.waiting_subtree = top.index;
+        return;
+      }
+      std::pop_heap(state.frontier.begin(), state.frontier.end(), heap_order);
+      state.frontier.pop_back();
+
+      if (top.kind == frontier_kind_t::subtree)
+      {
+        const uint32_t root = subtree_entry[top.index];
+        if (root != k_empty_subtree)
+          push({box_distance2(hierarchy.entries[root].box, p), root, frontier_kind_t::entry});
+        continue;
+      }
+      if (top.kind == frontier_kind_t::entry)
+      {
+        const auto &entry = hierarchy.entries[top.index];
+        if (entry.count == 0)
+        {
+          for (auto child : entry.children)
+            push({box_distance2(hierarchy.entries[child].box, p), child, frontier_kind_t::entry});
+        }
+        else
+        {
+          for (uint32_t i = 0; i < entry.count; i++)
+          {
+            const uint32_t item = hierarchy.order[entry.first + i];
+            if (item & k_subtree_ref)
+              push({box_distance2(subtrees[item & ~k_subtree_ref].cell, p), item & ~k_subtree_ref, frontier_kind_t::subtree});
+            else
+              push({box_distance2(nodes[item].tight, p), item, frontier_kind_t::node});
+          }
+        }
+        continue;
+      }
+
+      const auto &xyz = decoded[top.index]->xyz;
+      const auto point_count = uint32_t(xyz.size() / 3);
+      const uint64_t key = node_key(nodes[top.index]);
+      for (uint32_t i = 0; i < point_count; i++)
+      {
+        const double dx = xyz[size_t(i) * 3] - p[0];
+        const double dy = xyz[size_t(i) * 3 + 1] - p[1];
+        const double dz = xyz[size_t(i) * 3 + 2] - p[2];
+        const neighbour_t candidate{dx * dx + dy * dy + dz * dz, key, top.index, i};
+        if (candidate.distance2 > cap2)
+          continue;
+        if (!spec.knn)
+        {
+          state.found.push_back(candidate);
+        }
+        else if (state.found.size() < spec.k)
+        {
+          state.found.push_back(candidate);
+          std::push_heap(state.found.begin(), state.found.end(), found_order);
+        }
+        else if (nearer(candidate, state.found.front()))
+        {
+          std::pop_heap(state.found.begin(), state.found.end(), found_order);
+          state.found.back() = candidate;
+          std::push_heap(state.found.begin(), state.found.end(), found_order);
+        }
+      }
+    }
+    state.done = true;
+    state.frontier.clear();
+    state.frontier.shrink_to_fit();
+    std::sort(state.found.begin(), state.found.end(), found_order);
+    state.kept_xyz.reserve(state.found.size() * 3);
+    state.kept_attributes.resize(attribute_count);
+    for (const auto &neighbour : state.found)
+    {
+      const auto &node = *decoded[neighbour.node];
+      state.kept_xyz.insert(state.kept_xyz.end(), &node.xyz[size_t(neighbour.point) * 3], &node.xyz[size_t(neighbour.point) * 3] + 3);
+      for (uint32_t a = 0; a < attribute_count; a++)
+      {
+        const uint32_t stride = layout[a + 1].stride;
+        if (stride == 0)
+          continue;
+        const auto *value = node.attributes[a].data() + size_t(neighbour.point) * stride;
+        state.kept_attributes[a].insert(state.kept_attributes[a].end(), value, value + stride);
+      }
+    }
+  };
+
+  // One node's reads, issued but not yet awaited.
+  struct pending_read_t
+  {
+    uint32_t node;
+    std::shared_ptr<read_request_t> position;
+    std::vector<std::shared_ptr<read_request_t>> attributes;
+  };
+
+  const uint32_t reads_per_node = 1 + attribute_count;
+  const size_t nodes_per_round = std::max<size_t>(1, std::max<uint32_t>(1, dataset.max_reads_in_flight) / reads_per_node);
+  // Enough chunks to keep every pool thread busy, few enough that each is worth the hop.
+  constexpr uint32_t queries_per_job = 256;
+  bool first_blob_issued = false;
+  auto elapsed_ms = [&started]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count(); };
+
+  while (true)
+  {
+    if (request.status.load(std::memory_order_acquire) == dew_request_canceled)
+      co_return false;
+
+    // ---- advance: query points are independent, so chunks of them go to the pool. It is the
+    // search's walk, so the stats count it as one.
+    const auto advance_start = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> jobs;
+    for (uint32_t first = 0; first < query_count; first += queries_per_job)
+    {
+      const uint32_t last = std::min(query_count, first + queries_per_job);
+      jobs.push_back(dataset.pool.enqueue([&advance, &states, first, last]() {
+        for (uint32_t q = first; q < last; q++)
+        {
+          if (!states[q].done)
+            advance(q);
+        }
+      }));
+    }
+    for (auto &job : jobs)
+      job.get();
+    stats.walk_ms += ms_since(advance_start);
+
+    // ---- evict: over budget, drop every decoded node no unfinished query can still visit or return.
+    // What the pinned nodes alone hold may stay over it; the budget bounds the cache, not the working set.
+    if (decoded_bytes > dataset.budgets.decoded_backlog_cap)
+    {
+      std::vector<uint8_t> pinned(nodes.size(), 0);
+      for (const auto &state : states)
+      {
+        if (state.done)
+          continue;
+        for (const auto &item : state.frontier)
+        {
+          if (item.kind == frontier_kind_t::node)
+            pinned[item.index] = 1;
+        }
+        for (const auto &neighbour : state.found)
+          pinned[neighbour.node] = 1;
+      }
+      for (size_t n = 0; n < decoded.size(); n++)
+      {
+        if (decoded[n] && !pinned[n])
+        {
+          decoded_bytes -= node_bytes(*decoded[n]);
+          decoded[n].reset();
+        }
+      }
+    }
+
+    // ---- gather: what the stalled queries wait for, lowest index first, one budget's worth of
+    // nodes and of sub-trees.
+    std::vector<uint32_t> needed;
+    std::vector<uint32_t> needed_subtrees;
+    for (const auto &state : states)
+    {
+      if (state.done)
+        continue;
+      if (state.waiting_node != k_no_node)
+        needed.push_back(state.waiting_node);
+      if (state.waiting_subtree != k_no_node)
+        needed_subtrees.push_back(state.waiting_subtree);
+    }
+    if (needed.empty() && needed_subtrees.empty())
+      break;
+    std::sort(needed.begin(), needed.end());
+    needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+    if (needed.size() > nodes_per_round)
+      needed.resize(nodes_per_round);
+    std::sort(needed_subtrees.begin(), needed_subtrees.end());
+    needed_subtrees.erase(std::unique(needed_subtrees.begin(), needed_subtrees.end()), needed_subtrees.end());
+    if (needed_subtrees.size() > std::max<uint32_t>(1, dataset.max_reads_in_flight))
+      needed_subtrees.resize(std::max<uint32_t>(1, dataset.max_reads_in_flight));
+
+    // ---- read: the sub-trees and the nodes together, so one round trip covers both.
+    dew_error_t load_error;
+    std::vector<std::shared_ptr<read_request_t>> tree_reads(needed_subtrees.size());
+    uint32_t tree_read_count = 0;
+    for (size_t i = 0; i < needed_subtrees.size(); i++)
+    {
+      tree_reads[i] = dataset.trees->begin_load(subtrees[needed_subtrees[i]].tree_id, load_error);
+      if (load_error.code != 0)
+      {
+        request.error = load_error;
+        co_return false;
+      }
+      if (tree_reads[i])
+        tree_read_count++;
+    }
+    std::vector<pending_read_t> reads;
+    reads.reserve(needed.size());
+    uint32_t issued_reads = 0;
+    for (auto n : needed)
+    {
+      const auto &node = nodes[n];
+      pending_read_t entry;
+      entry.node = n;
+      const tree_t *tree = dataset.registry().get(node.tree_id);
+      const auto position_location = tree ? tree->storage_map.location(node.input_id, 0) : storage_location_t{};
+      if (tree && position_location.size != 0)
+      {
+        entry.position = dataset.reader->read(position_location, read_options_t{false, true, {}});
+        count_blob_read(stats, position_location, *entry.position);
+        issued_reads++;
+        stats.nodes_read++;
+        entry.attributes.resize(attribute_count);
+        for (uint32_t a = 0; a < attribute_count; a++)
+        {
+          if (layout[a + 1].stride == 0)
+            continue;
+          const auto index = dataset.attributes.get_attribute_index(node.attributes_id, spec.attribute_names[a]);
+          if (index.index < 0)
+            continue;
+          const auto location = tree->storage_map.location(node.input_id, index.index);
+          if (location.size != 0)
+          {
+            entry.attributes[a] = dataset.reader->read(location, read_options_t{false, true, {}});
+            count_blob_read(stats, location, *entry.attributes[a]);
+            issued_reads++;
+          }
+        }
+        if (!first_blob_issued)
+        {
+          first_blob_issued = true;
+          stats.time_to_first_blob_ms = elapsed_ms();
+        }
+      }
+      reads.push_back(std::move(entry));
+    }
+    stats.peak_reads_in_flight = std::max(stats.peak_reads_in_flight, issued_reads + tree_read_count);
+    bool waited = false;
+    const auto wait_start = std::chrono::steady_clock::now();
+    for (auto &read : tree_reads)
+    {
+      if (!read)
+        continue;
+      waited = waited || !read->is_done();
+      co_await read->await_on(loop);
+    }
+    for (auto &entry : reads)
+    {
+      if (!entry.position)
+        continue;
+      waited = waited || !entry.position->is_done();
+      co_await entry.position->await_on(loop);
+      if (entry.position->error.code == 0)
+        stats.bytes_decompressed += entry.position->buffer_info.size;
+      for (auto &attribute : entry.attributes)
+      {
+        if (!attribute)
+          continue;
+        waited = waited || !attribute->is_done();
+        co_await attribute->await_on(loop);
+        if (attribute->error.code == 0)
+          stats.bytes_decompressed += attribute->buffer_info.size;
+      }
+    }
+    stats.io_wait_ms += ms_since(wait_start);
+    if (waited)
+      stats.round_trips++;
+
+    // ---- walk on below each sub-tree that landed, in index order so the node numbering -- and so
+    // the frontiers' tie-breaks -- do not depend on which read finished first.
+    for (size_t i = 0; i < needed_subtrees.size(); i++)
+    {
+      const uint32_t s = needed_subtrees[i];
+      if (tree_reads[i])
+      {
+        if (!dataset.trees->finish_load(subtrees[s].tree_id, *tree_reads[i], load_error))
+        {
+          request.error = load_error;
+          co_return false;
+        }
+        stats.trees_loaded++;
+      }
+      const auto walk_start = std::chrono::steady_clock::now();
+      region_walk_subtree(dataset.registry(), query, subtrees[s], walked);
+      const uint32_t entry = add_walked();
+      subtree_entry[s] = entry == k_no_node ? k_empty_subtree : entry;
+      stats.walk_ms += ms_since(walk_start);
+    }
+    decoded.resize(nodes.size());
+
+    // ---- decode on the pool. A node whose unit is absent decodes to no points, so the queries
+    // waiting on it simply move past it.
+    const auto decode_start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<decoded_node_t>> landed(reads.size());
+    std::vector<dew_error_t> errors(reads.size());
+    jobs.clear();
+    for (size_t i = 0; i < reads.size(); i++)
+    {
+      jobs.push_back(dataset.pool.enqueue([&, i]() {
+        auto out = std::make_unique<decoded_node_t>();
+        const auto &entry = reads[i];
+        const auto &node = nodes[entry.node];
+        if (entry.position)
+        {
+          if (entry.position->error.code != 0)
+          {
+            errors[i] = entry.position->error;
+            return;
+          }
+          storage_header_t header;
+          dew_blob_t point_data;
+          if (!deserialize_points(entry.position->buffer_info, header, point_data, errors[i]))
+            return;
+          const uint32_t offset = node.offset_in_subset.data;
+          const uint32_t count = node.point_count.data;
+          if (uint64_t(offset) + count <= header.point_count)
+          {
+            const uint32_t src_stride = uint32_t(size_for_format(header.point_format.type, header.point_format.components));
+            const auto *src = static_cast<const uint8_t *>(point_data.data) + uint64_t(offset) * src_stride;
+            out->xyz.resize(size_t(count) * 3);
+            double origin[3];
+            if (!decode_positions(src, count * src_stride, count, header.point_format, header.morton_min, header.lod_span, dataset.registry().tree_config, position_format_t::r64_absolute,
+                                  out->xyz.data(), uint64_t(count) * 3 * sizeof(double), origin))
+            {
+              errors[i] = {1, "failed to decode node positions"};
+              return;
+            }
+            out->attributes.resize(attribute_count);
+            for (uint32_t a = 0; a < attribute_count; a++)
+            {
+              const uint32_t stride = layout[a + 1].stride;
+              if (stride == 0)
+                continue;
+              // Zero-filled where the node lacks the attribute, as in a region request.
+              out->attributes[a].assign(size_t(count) * stride, uint8_t(0));
+              const auto &source = entry.attributes[a];
+              if (source && source->error.code == 0 && uint64_t(offset + count) * stride <= source->buffer_info.size)
+                memcpy(out->attributes[a].data(), static_cast<const uint8_t *>(source->buffer_info.data) + uint64_t(offset) * stride, size_t(count) * stride);
+            }
+          }
+        }
+        landed[i] = std::move(out);
+      }));
+    }
+    for (auto &job : jobs)
+      job.get();
+    stats.decode_ms += ms_since(decode_start);
+    for (size_t i = 0; i < reads.size(); i++)
+    {
+      if (errors[i].code != 0)
+      {
+        request.error = errors[i];
+        co_return false;
+      }
+      decoded_bytes += node_bytes(*landed[i]);
+      decoded[reads[i].node] = std::move(landed[i]);
+    }
+  }
+
+  // ---- results: every neighbour once in the point buffers, in query order then nearest first, and
+  // per query its indices into them and its distances.
+  const auto append_start = std::chrono::steady_clock::now();
+  auto &output = request.regions.emplace_back();
+  output.buffers = layout;
+  std::unordered_map<uint64_t, uint64_t> point_index;
+  request.search_offsets.assign(1, 0);
+  for (auto &state : states)
+  {
+    for (size_t i = 0; i < state.found.size(); i++)
+    {
+      const auto &neighbour = state.found[i];
+      const uint64_t key = (uint64_t(neighbour.node) << 32) | neighbour.point;
+      auto [it, inserted] = point_index.try_emplace(key, output.point_count);
+      if (inserted)
+      {
+        const auto *xyz = reinterpret_cast<const uint8_t *>(&state.kept_xyz[i * 3]);
+        output.buffers[0].data.insert(output.buffers[0].data.end(), xyz, xyz + 3 * sizeof(double));
+        for (uint32_t a = 0; a < attribute_count; a++)
+        {
+          const uint32_t stride = layout[a + 1].stride;
+          if (stride == 0)
+            continue;
+          const auto *value = state.kept_attributes[a].data() + i * stride;
+          output.buffers[a + 1].data.insert(output.buffers[a + 1].data.end(), value, value + stride);
+        }
+        output.point_count++;
+      }
+      request.search_indices.push_back(it->second);
+      request.search_distances.push_back(std::sqrt(neighbour.distance2));
+    }
+    request.search_offsets.push_back(request.search_indices.size());
+    state.found = {};
+    state.kept_xyz = {};
+    state.kept_attributes = {};
+  }
+  stats.append_ms += ms_since(append_start);
+  co_return true;
+}
+
+// Spawn the search on the dataset's own loop and return at once; see spawn_region_request for why the
+// job and the request are passed by value.
+void dataset_impl_t::spawn_search_request(search_job_t job, std::shared_ptr<dew_request_t> request)
+{
+  auto *dataset = this;
+  loop_thread.event_loop().run_in_loop([dataset, job = std::move(job), request]() mutable {
+    [](dataset_impl_t *ds, search_job_t j, std::shared_ptr<dew_request_t> r) -> vio::detached_task_t {
+      const auto started = std::chrono::steady_clock::now();
+      dew_request_stats_t stats{};
+      const bool ok = co_await run_search_request(*ds, j, *r, stats, started);
+      stats.total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+      r->finish(ok ? dew_request_completed : dew_request_failed, stats);
+      ds->publish(r);
+    }(dataset, std::move(job), request);
+  });
+}
+
+} // namespace dew::access
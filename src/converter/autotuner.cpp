@@ -0,0 +1,154 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "autotuner.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace dew::converter
+{
+autotuner_t::autotuner_t(uint32_t worker_count, uint64_t memory_budget, uint64_t read_chunk_bytes)
+  : _worker_count(std::max(worker_count, 1u))
+  , _memory_budget(memory_budget)
+{
+  // Start balanced and let the queues pull workers towards the slow stage: a quarter of the workers
+  // reading, half of them sorting and half compressing.
+  _settings.read_chunk_bytes = std::clamp(read_chunk_bytes, k_min_chunk_bytes, k_max_chunk_bytes);
+  _settings.max_readers = std::max(1u, _worker_count / 4);
+  _settings.max_sorters = std::max(1u, _worker_count / 2);
+  _settings.max_compressors = std::max(1u, _worker_count / 2);
+  _before_change = _settings;
+}
+
+bool autotuner_t::change(knob_t knob, autotune_settings_t next, const char *reason, std::string &decision)
+{
+  _before_change = _settings;
+  _settings = next;
+  _last_knob = knob;
+  _decisions++;
+  decision = fmt::format("{}: chunk {} MiB, readers {}, sorters {}, compressors {}", reason, next.read_chunk_bytes >> 20, next.max_readers, next.max_sorters, next.max_compressors);
+  return true;
+}
+
+bool autotuner_t::update(const autotune_sample_t &sample, std::string &decision)
+{
+  if (!_have_previous)
+  {
+    _previous = sample;
+    _have_previous = true;
+    return false;
+  }
+  auto previous = _previous;
+  _previous = sample;
+  if (sample.seconds <= 0)
+    return false;
+
+  // Bytes read plus bytes written per second: a reader that only fills buffers, or a writer that only
+  // drains them, does not count twice.
+  double rate = double((sample.read_bytes - previous.read_bytes) + (sample.write_bytes - previous.write_bytes)) / sample.seconds;
+  if (_hold_intervals > 0)
+    _hold_intervals--;
+  auto held = [this](knob_t knob) { return _hold_intervals > 0 && _held_knob == knob; };
+
+  auto next = _settings;
+  if (sample.memory_bytes > _memory_budget / 10 * 9)
+  {
+    // Shedding memory is never reverted for throughput.
+    bool changed = false;
+    if (next.max_readers > 1)
+    {
+      next.max_readers--;
+      changed = change(knob_t::readers, next, "memory above 90% of budget, one reader fewer", decision);
+    }
+    else if (next.read_chunk_bytes > k_min_chunk_bytes)
+    {
+      next.read_chunk_bytes = std::max(k_min_chunk_bytes, next.read_chunk_bytes / 2);
+      changed = change(knob_t::chunk, next, "memory above 90% of budget, smaller chunks", decision);
+    }
+    _last_knob = knob_t::none;
+    return changed;
+  }
+
+  if (_last_knob != knob_t::none)
+  {
+    auto knob = _last_knob;
+    _last_knob = knob_t::none;
+    if (rate < _rate_before_change * 0.9)
+    {
+      std::swap(_settings, _before_change);
+      _held_knob = knob;
+      _hold_intervals = 3;
+      _decisions++;
+      decision = fmt::format("throughput fell {:.0f}% after the last change, reverted: chunk {} MiB, readers {}, sorters {}, compressors {}", 100.0 * (1.0 - rate / _rate_before_change),
+                             _settings.read_chunk_bytes >> 20, _settings.max_readers, _settings.max_sorters, _settings.max_compressors);
+      return true;
+    }
+  }
+
+  _rate_before_change = rate;
+  uint64_t headroom_limit = _memory_budget / 4 * 3;
+  uint64_t headroom = sample.memory_bytes < headroom_limit ? headroom_limit - sample.memory_bytes : 0;
+
+  // Each stage runs on the same workers, so feeding the slow one may mean taking from the other.
+  if (sample.writes_queued > 0 && sample.writes_queued >= sample.sorts_queued && !held(knob_t::compressors))
+  {
+    if (next.max_compressors < _worker_count)
+    {
+      next.max_compressors++;
+      return change(knob_t::compressors, next, "compression is backing up, one compressor more", decision);
+    }
+    if (next.max_sorters > 1 && sample.sorts_queued == 0 && !held(knob_t::sorters))
+    {
+      next.max_sorters--;
+      return change(knob_t::sorters, next, "compression is backing up, one sorter fewer", decision);
+    }
+  }
+  if (sample.sorts_queued > 0 && !held(knob_t::sorters))
+  {
+    if (next.max_sorters < _worker_count)
+    {
+      next.max_sorters++;
+      return change(knob_t::sorters, next, "sorting is backing up, one sorter more", decision);
+    }
+    if (next.max_compressors > 1 && sample.writes_queued == 0 && !held(knob_t::compressors))
+    {
+      next.max_compressors--;
+      return change(knob_t::compressors, next, "sorting is backing up, one compressor fewer", decision);
+    }
+  }
+  if (sample.sorts_queued == 0 && sample.writes_queued == 0 && sample.inputs_waiting > 0 && sample.readers_active >= next.max_readers && next.max_readers < _worker_count &&
+      headroom >= 2 * next.read_chunk_bytes && !held(knob_t::readers))
+  {
+    next.max_readers++;
+    return change(knob_t::readers, next, "downstream is idle, one reader more", decision);
+  }
+  uint32_t sort_operations = sample.sort_operations - previous.sort_operations;
+  if (sort_operations > 0 && next.read_chunk_bytes < k_max_chunk_bytes && !held(knob_t::chunk))
+  {
+    // Short sorts mean the per-chunk overhead (splits, events, tree inserts) weighs more than the sort.
+    uint64_t sort_ms = (sample.sort_time_us - previous.sort_time_us) / sort_operations / 1000;
+    if (sort_ms < 100 && headroom >= next.read_chunk_bytes * (next.max_readers + next.max_sorters))
+    {
+      next.read_chunk_bytes = std::min(k_max_chunk_bytes, next.read_chunk_bytes * 2);
+      return change(knob_t::chunk, next, "sorts are short, larger chunks", decision);
+    }
+  }
+  return false;
+}
+} // namespace dew::converter
@@ -0,0 +1,108 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Opt-in runtime tuning of the ingest pipeline (dew_converter_set_autotune).
+//
+// The fixed defaults -- 64 MiB read chunks, every queued input read at once up to the read/sort budget,
+// a sort and a compression job per chunk as soon as it arrives -- suit a large local disk and a big
+// machine. On slow storage or few cores they oversubscribe one stage while another starves. The tuner
+// watches one interval of the run at a time and moves one knob per interval:
+//  - memory first: above 90% of the budget it sheds a reader, then halves the chunk size;
+//  - a throughput drop of more than 10% after a change reverts that change and holds the knob for a few
+//    intervals;
+//  - otherwise it feeds the stage with the deepest backlog: queued compressions get a compressor, queued
+//    sorts a sorter, and an idle pipeline with memory to spare another reader. Short sorts grow the chunk
+//    size, which only applies to inputs started afterwards.
+// It is a pure function of the samples it is fed; processor_t samples the perf counters and the stage
+// queues and applies the settings to the reader, the sort queue and the storage writes.
+
+#include <cstdint>
+#include <string>
+
+namespace dew::converter
+{
+struct autotune_settings_t
+{
+  uint64_t read_chunk_bytes = 0;
+  uint32_t max_readers = 0;     // inputs read concurrently
+  uint32_t max_sorters = 0;     // chunks sorted concurrently
+  uint32_t max_compressors = 0; // storage writes compressing concurrently
+};
+
+struct autotune_sample_t
+{
+  double seconds = 0;           // since the previous sample
+  uint64_t read_bytes = 0;      // cumulative, as in perf_stats_t
+  uint64_t sort_bytes = 0;
+  uint64_t sort_time_us = 0;
+  uint32_t sort_operations = 0;
+  uint64_t write_bytes = 0;     // leaf and LOD writes
+  uint32_t readers_active = 0;
+  uint32_t inputs_waiting = 0;  // registered inputs not started yet
+  uint32_t sorts_queued = 0;
+  uint32_t sorts_running = 0;
+  uint32_t writes_queued = 0;
+  uint32_t writes_running = 0;
+  uint64_t memory_bytes = 0;    // pooled point buffers handed out
+};
+
+class autotuner_t
+{
+public:
+  static constexpr uint64_t k_min_chunk_bytes = 8ull << 20;
+  static constexpr uint64_t k_max_chunk_bytes = 512ull << 20;
+
+  autotuner_t(uint32_t worker_count, uint64_t memory_budget, uint64_t read_chunk_bytes);
+
+  const autotune_settings_t &settings() const
+  {
+    return _settings;
+  }
+  uint32_t decisions() const
+  {
+    return _decisions;
+  }
+
+  // Feeds one interval. Returns true when a setting changed; `decision` then says which and why.
+  bool update(const autotune_sample_t &sample, std::string &decision);
+
+private:
+  enum class knob_t : uint8_t
+  {
+    none,
+    chunk,
+    readers,
+    sorters,
+    compressors
+  };
+  bool change(knob_t knob, autotune_settings_t next, const char *reason, std::string &decision);
+
+  uint32_t _worker_count;
+  uint64_t _memory_budget;
+  autotune_settings_t _settings;
+  autotune_settings_t _before_change;
+  knob_t _last_knob = knob_t::none;
+  knob_t _held_knob = knob_t::none;
+  uint32_t _hold_intervals = 0;
+  double _rate_before_change = 0;
+  bool _have_previous = false;
+  autotune_sample_t _previous;
+  uint32_t _decisions = 0;
+};
+} // namespace dew::converter
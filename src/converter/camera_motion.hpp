@@ -0,0 +1,126 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Camera-path extrapolation for the render IO prefetch. The data source feeds it the camera-to-world
+// transform (frame_camera_cpp_t::inverse_view) once per frame; it keeps a smoothed linear velocity and
+// angular velocity and extrapolates a pose a few hundred milliseconds ahead, so the scheduler can warm
+// the blob cache for the region a pan or orbit is about to expose. The dew_camera_t itself carries no
+// motion state (it is a pair of matrices the host overwrites), so the velocities are derived here from
+// successive frames rather than from the camera controllers.
+
+#include "glm_include.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dew::converter
+{
+
+class camera_motion_t
+{
+public:
+  // Record this frame's camera-to-world transform. `delta_ms` is the time since the previous frame. The
+  // velocities are exponentially smoothed so a single jittery frame (input event coalescing, a GC pause)
+  // doesn't fling the prediction; a stop is still picked up within a few frames.
+  void update(const glm::dmat4 &inverse_view, double delta_ms)
+  {
+    if (!m_has_sample || delta_ms <= 0.0)
+    {
+      m_last = inverse_view;
+      m_has_sample = true;
+      return;
+    }
+    const glm::dvec3 position_now(inverse_view[3]);
+    const glm::dvec3 position_prev(m_last[3]);
+    const glm::dvec3 velocity_now = (position_now - position_prev) / delta_ms;
+
+    // World-frame relative rotation R = R_now * R_prev^T, as axis * angle (Rodrigues, inverted).
+    const glm::dmat3 rotation_now(inverse_view);
+    const glm::dmat3 rotation_prev(m_last);
+    const glm::dmat3 relative = rotation_now * glm::transpose(rotation_prev);
+    const double cos_angle = std::clamp((relative[0][0] + relative[1][1] + relative[2][2] - 1.0) * 0.5, -1.0, 1.0);
+    const double angle = std::acos(cos_angle);
+    glm::dvec3 angular_now(0.0);
+    const double sin_angle = std::sin(angle);
+    if (angle > 1e-9 && sin_angle > 1e-9)
+    {
+      // glm is column-major: relative[c][r]. The skew part (R - R^T) / (2 sin) is the rotation axis.
+      const glm::dvec3 axis(relative[1][2] - relative[2][1], relative[2][0] - relative[0][2], relative[0][1] - relative[1][0]);
+      angular_now = axis / (2.0 * sin_angle) * (angle / delta_ms);
+    }
+
+    m_velocity = glm::mix(m_velocity, velocity_now, smoothing);
+    m_angular_velocity = glm::mix(m_angular_velocity, angular_now, smoothing);
+    m_last = inverse_view;
+  }
+
+  // Forget the history, e.g. after a camera jump (the host set a new view): a teleport is not motion.
+  void reset()
+  {
+    m_has_sample = false;
+    m_velocity = glm::dvec3(0.0);
+    m_angular_velocity = glm::dvec3(0.0);
+  }
+
+  // True once the camera moves fast enough that `ahead_ms` of extrapolation lands somewhere other than
+  // where it is now. `scene_scale` is a length in world units (the node size the walker works with), so
+  // the test is relative: a creep that moves the eye by less than 1% of it, and turns by less than half a
+  // degree, is not worth a second walk.
+  [[nodiscard]] bool is_moving(double ahead_ms, double scene_scale) const
+  {
+    if (!m_has_sample)
+      return false;
+    const double travel = glm::length(m_velocity) * ahead_ms;
+    const double turn = glm::length(m_angular_velocity) * ahead_ms;
+    constexpr double half_degree = 0.5 * 3.14159265358979323846 / 180.0;
+    return travel > scene_scale * 0.01 || turn > half_degree;
+  }
+
+  // The camera-to-world transform `ahead_ms` from the last sample: position moved along the velocity, the
+  // orientation turned about the angular-velocity axis (around the eye, which is what both an FPS look and
+  // an arcball orbit's view direction do to first order).
+  [[nodiscard]] glm::dmat4 predict_inverse_view(double ahead_ms) const
+  {
+    glm::dmat4 predicted = m_last;
+    const double turn = glm::length(m_angular_velocity) * ahead_ms;
+    if (turn > 1e-9)
+    {
+      const glm::dmat3 rotation = glm::dmat3(glm::rotate(glm::dmat4(1.0), turn, glm::normalize(m_angular_velocity)));
+      const glm::dmat3 oriented = rotation * glm::dmat3(m_last);
+      predicted[0] = glm::dvec4(oriented[0], 0.0);
+      predicted[1] = glm::dvec4(oriented[1], 0.0);
+      predicted[2] = glm::dvec4(oriented[2], 0.0);
+    }
+    predicted[3] = glm::dvec4(glm::dvec3(m_last[3]) + m_velocity * ahead_ms, 1.0);
+    return predicted;
+  }
+
+  [[nodiscard]] const glm::dvec3 &velocity() const { return m_velocity; }                 // world units per ms
+  [[nodiscard]] const glm::dvec3 &angular_velocity() const { return m_angular_velocity; } // radians per ms, axis * rate
+
+  static constexpr double smoothing = 0.5;
+
+private:
+  glm::dmat4 m_last = glm::dmat4(1.0);
+  glm::dvec3 m_velocity = glm::dvec3(0.0);
+  glm::dvec3 m_angular_velocity = glm::dvec3(0.0);
+  bool m_has_sample = false;
+};
+
+} // namespace dew::converter
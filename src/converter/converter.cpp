@@ -242,6 +242,24 @@ void dew_converter_set_lod_all_attributes(dew_converter_t *converter, uint8_t al
   converter->processor.set_pre_init_tree_config(config);
 }
 
+void dew_converter_set_dedup(dew_converter_t *converter, uint8_t enabled, uint8_t grid_lod, enum dew_converter_dedup_keep_t keep)
+{
+  auto config = converter->processor.tree_config_peek();
+  config.dedup_enabled = enabled ? 1 : 0;
+  // Codes stop distinguishing anything past the 64 levels of a 192-bit morton code.
+  config.dedup_grid_lod = std::min<uint8_t>(grid_lod, 63);
+  config.dedup_keep = uint8_t(keep);
+  converter->processor.set_pre_init_tree_config(config);
+}
+
+void dew_converter_set_attribute_precision(dew_converter_t *converter, const char *name, uint32_t name_size, double tolerance)
+{
+  attribute_precision_t precision;
+  precision.enabled = tolerance >= 0;
+  precision.tolerance = precision.enabled ? tolerance : 0;
+  converter->processor.set_attribute_precision(std::string(name, name_size), precision);
+}
+
 void dew_converter_set_compression_level(dew_converter_t *converter, int level)
 {
   converter->processor.storage_handler().set_compression_level(level);
@@ -257,6 +275,42 @@ void dew_converter_set_read_chunk_bytes(dew_converter_t *converter, uint64_t byt
   converter->processor.set_pre_init_read_chunk_bytes(bytes);
 }
 
+void dew_converter_set_hierarchy_directory_depth(dew_converter_t *converter, uint32_t depth)
+{
+  converter->processor.set_hierarchy_directory_depth(depth);
+}
+
+uint8_t dew_converter_set_numa_pools(dew_converter_t *converter, uint8_t enabled)
+{
+  return converter->processor.set_numa_pools(enabled != 0) ? 1 : 0;
+}
+
+uint8_t dew_converter_set_autotune(dew_converter_t *converter, uint8_t enabled)
+{
+  return converter->processor.set_autotune(enabled != 0) ? 1 : 0;
+}
+
+uint32_t dew_converter_get_numa_node_count(dew_converter_t *converter)
+{
+  if (!converter)
+    return 0;
+  return uint32_t(converter->processor.numa_stats().size());
+}
+
+bool dew_converter_get_numa_node_stats(dew_converter_t *converter, uint32_t index, dew_converter_numa_node_stats_t *stats)
+{
+  if (!converter || !stats)
+    return false;
+  auto nodes = converter->processor.numa_stats();
+  if (index >= nodes.size())
+    return false;
+  stats->node = nodes[index].node;
+  stats->workers = nodes[index].workers;
+  stats->cpu_seconds = nodes[index].cpu_seconds;
+  stats->utilization = nodes[index].utilization;
+  return true;
+}
+
 void dew_converter_add_data_file(dew_converter_t *converter, dew_converter_str_buffer *buffers, uint32_t buffer_count)
 {
   std::vector<std::pair<std::unique_ptr<char[]>, uint32_t>> input_files;
@@ -273,6 +327,73 @@ void dew_converter_add_data_file(dew_converter_t *converter, dew_converter_str_b
   converter->processor.add_files(std::move(input_files));
 }
 
+static bool edit_input(dew_converter_t *converter, std::string name, std::string new_name, dew_error_t **error)
+{
+  auto edit_error = converter->processor.edit_input(std::move(name), std::move(new_name));
+  if (edit_error.code == 0)
+    return true;
+  if (error)
+  {
+    *error = new dew_error_t();
+    (*error)->code = edit_error.code;
+    (*error)->msg = edit_error.msg;
+  }
+  return false;
+}
+
+bool dew_converter_remove_input(dew_converter_t *converter, const char *name, uint64_t name_size, dew_error_t **error)
+{
+  return edit_input(converter, std::string(name, name_size), std::string(), error);
+}
+
+bool dew_converter_replace_input(dew_converter_t *converter, const char *name, uint64_t name_size, const char *new_name, uint64_t new_name_size, dew_error_t **error)
+{
+  if (new_name_size == 0)
+  {
+    if (error)
+    {
+      *error = new dew_error_t();
+      (*error)->code = 1;
+      (*error)->msg = "The replacement needs a file name";
+    }
+    return false;
+  }
+  return edit_input(converter, std::string(name, name_size), std::string(new_name, new_name_size), error);
+}
+
+dew_converter_push_status_t dew_converter_push_points(dew_converter_t *converter, const dew_converter_header_t *header, const dew_attribute_t *attributes, uint32_t attribute_count, const dew_blob_t *buffers,
+                                                      uint64_t point_count, uint8_t block, dew_error_t **error)
+{
+  dew_error_t push_error;
+  auto status = dew_push_status_error;
+  if (!header)
+    push_error = {1, "No header"};
+  else
+    status = converter->processor.push_points(*header, attributes, attribute_count, buffers, point_count, block != 0, push_error);
+  if (status == dew_push_status_error && error)
+  {
+    *error = new dew_error_t();
+    (*error)->code = push_error.code;
+    (*error)->msg = push_error.msg;
+  }
+  return status;
+}
+
+void dew_converter_push_flush(dew_converter_t *converter)
+{
+  converter->processor.push_flush();
+}
+
+void dew_converter_push_end(dew_converter_t *converter)
+{
+  converter->processor.push_end();
+}
+
+void dew_converter_set_push_segment_points(dew_converter_t *converter, uint64_t points)
+{
+  converter->processor.set_push_segment_points(points);
+}
+
 void dew_converter_wait_idle(dew_converter_t *converter)
 {
   converter->processor.wait_idle();
@@ -295,6 +416,7 @@ static void fill_converter_stats(const compression_stats_t &src, dew_converter_s
   dst->lod_buffer_count = src.lod_buffer_count;
   dst->compression_method = static_cast<uint32_t>(src.method);
   dst->input_file_size_bytes = src.input_file_size_bytes;
+  dst->duplicate_points_removed = src.duplicate_points_removed;
   dst->attribute_count = static_cast<uint32_t>(std::min(src.per_attribute.size(), size_t(32)));
   for (uint32_t i = 0; i < dst->attribute_count; i++)
   {
@@ -369,6 +491,17 @@ bool dew_converter_get_perf_stats(dew_converter_t *converter, dew_converter_perf
   perf_stats->lod_generation_seconds = double(parsed.lod_generation_us) / 1e6;
   perf_stats->cache_hits = parsed.cache_hits;
   perf_stats->cache_misses = parsed.cache_misses;
+  perf_stats->buffer_pool_hits = parsed.buffer_pool_hits;
+  perf_stats->buffer_pool_misses = parsed.buffer_pool_misses;
+  perf_stats->allocation_seconds = double(parsed.allocation_time_us) / 1e6;
+  perf_stats->peak_buffer_bytes = parsed.peak_buffer_bytes;
+  perf_stats->peak_rss_bytes = parsed.peak_rss_bytes;
+  perf_stats->autotuned = parsed.autotuned ? 1 : 0;
+  perf_stats->autotune_read_chunk_bytes = parsed.autotune_read_chunk_bytes;
+  perf_stats->autotune_max_readers = uint32_t(parsed.autotune_max_readers);
+  perf_stats->autotune_max_sorters = uint32_t(parsed.autotune_max_sorters);
+  perf_stats->autotune_max_compressors = uint32_t(parsed.autotune_max_compressors);
+  perf_stats->autotune_decisions = uint32_t(parsed.autotune_decisions);
   return true;
 }
 
@@ -395,6 +528,18 @@ bool dew_converter_get_live_perf_stats(struct dew_converter_t *converter, struct
   perf_stats->lod_generation_seconds = double(ps.lod_generation_time_us.load(std::memory_order_relaxed)) / 1e6;
   perf_stats->cache_hits = ps.cache_hits.load(std::memory_order_relaxed);
   perf_stats->cache_misses = ps.cache_misses.load(std::memory_order_relaxed);
+  ps.sample_memory();
+  perf_stats->buffer_pool_hits = ps.buffer_pool_hits.load(std::memory_order_relaxed);
+  perf_stats->buffer_pool_misses = ps.buffer_pool_misses.load(std::memory_order_relaxed);
+  perf_stats->allocation_seconds = double(ps.allocation_time_us.load(std::memory_order_relaxed)) / 1e6;
+  perf_stats->peak_buffer_bytes = ps.peak_buffer_bytes.load(std::memory_order_relaxed);
+  perf_stats->peak_rss_bytes = ps.peak_rss_bytes.load(std::memory_order_relaxed);
+  perf_stats->autotuned = ps.autotuned.load(std::memory_order_relaxed) ? 1 : 0;
+  perf_stats->autotune_read_chunk_bytes = ps.autotune_read_chunk_bytes.load(std::memory_order_relaxed);
+  perf_stats->autotune_max_readers = ps.autotune_max_readers.load(std::memory_order_relaxed);
+  perf_stats->autotune_max_sorters = ps.autotune_max_sorters.load(std::memory_order_relaxed);
+  perf_stats->autotune_max_compressors = ps.autotune_max_compressors.load(std::memory_order_relaxed);
+  perf_stats->autotune_decisions = ps.autotune_decisions.load(std::memory_order_relaxed);
   return true;
 }
 
@@ -88,6 +88,17 @@ static uint64_t braked_read_cache_bytes(const derived_budgets_t &d, brake_level_
   return d.read_cache_bytes;
 }
 
+// The same for the point-buffer pool's retain limit. Retained chunk buffers are pure headroom, so they
+// go first under pressure. The pool is process-wide: the source that set its budget last sizes it.
+static uint64_t braked_buffer_pool_bytes(const derived_budgets_t &d, brake_level_t level)
+{
+  if (level == brake_level_t::critical)
+    return 0;
+  if (level == brake_level_t::high)
+    return d.buffer_pool_bytes / 4;
+  return d.buffer_pool_bytes;
+}
+
 dew_converter_data_source_t::dew_converter_data_source_t(const std::string &a_url, render::callback_manager_t &a_callbacks)
   : url(a_url)
   , processor(a_url, file_existence_requirement_t::exist, error)
@@ -122,6 +133,7 @@ dew_converter_data_source_t::dew_converter_data_source_t(const std::string &a_ur
   // render path never populates it).
   processor.storage_handler().set_read_cache_size(derived_budgets.read_cache_bytes);
   processor.storage_handler().set_decompressed_cache_size(derived_budgets.decompressed_cache_bytes);
+  point_buffer_pool().set_retain_limit(derived_budgets.buffer_pool_bytes);
 
   // Read compression stats for attribute normalization
   attribute_stats = processor.storage_handler().get_compression_stats();
@@ -147,6 +159,9 @@ dew_converter_data_source_t::~dew_converter_data_source_t()
   // drain queued jobs against already-freed nodes). destroy_render_node spin-waits each in-flight convert /
   // materialize job, tears down virtual subtrees, and frees all GPU buffers -- fixing both the native
   // shutdown use-after-free and the GPU-buffer leak on data-source destroy/reload.
+  if (arbiter)
+    arbiter->remove_source(this);
+  cancel_prefetch(prefetch, node_loader.get());
   for (auto &np : render_list)
     if (np)
       destroy_render_node(*np, callbacks, node_loader.get(), &virtual_gpu_used);
@@ -176,8 +191,14 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
   int frame_viewport_height;
   double frame_render_density_px;
   io_limits_t io_limits;
+  double frame_prefetch_ms;
+  occlusion_mode_t frame_occlusion_mode;
+  dew_converter_data_source_occlusion_depth_callback_t frame_depth_callback;
+  void *frame_depth_user_ptr;
+  int frame_viewport_width;
   brake_level_t frame_brake;
   size_t frame_cpu_resident_budget; // snapshot: set_memory_budget writes the member under the mutex
+  std::shared_ptr<resource_arbiter_t> frame_arbiter;
   {
     std::unique_lock<std::mutex> lock(mutex);
     new_attribute = current_attribute_name != next_attribute_name;
@@ -185,6 +206,27 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
     frac_threshold = screen_fraction_threshold;
     frame_viewport_height = viewport_height;
     frame_render_density_px = render_density_px;
+    frame_prefetch_ms = prefetch_lookahead_ms;
+    frame_occlusion_mode = occlusion_mode;
+    frame_depth_callback = occlusion_depth_callback;
+    frame_depth_user_ptr = occlusion_depth_user_ptr;
+    frame_viewport_width = viewport_width;
+    frame_arbiter = arbiter;
+    arbiter_grant_t grant;
+    if (frame_arbiter)
+    {
+      grant = frame_arbiter->grant(this);
+      // The cache/resident share changes whenever a source joins or leaves the arbiter.
+      if (grant.share.read_cache_bytes != derived_budgets.read_cache_bytes || grant.share.decompressed_cache_bytes != derived_budgets.decompressed_cache_bytes ||
+          grant.share.cpu_resident_budget != derived_budgets.cpu_resident_budget || grant.share.total != derived_budgets.total)
+      {
+        derived_budgets = grant.share;
+        cpu_resident_budget = derived_budgets.cpu_resident_budget;
+        processor.storage_handler().set_read_cache_size(braked_read_cache_bytes(derived_budgets, brake_level));
+        processor.storage_handler().set_decompressed_cache_size(derived_budgets.decompressed_cache_bytes);
+        point_buffer_pool().set_retain_limit(braked_buffer_pool_bytes(derived_budgets, brake_level));
+      }
+    }
 
     // Heap-pressure brake. The level only ever rises within a run (on wasm the heap never shrinks, so
     // pressure that latched once is real until reload); the one-shot cache shrinks fire on each upward
@@ -203,6 +245,7 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
       fmt::print(stderr, "[membrake] heap {} MB of {} MB ceiling -> {} (tightening io/cache caps)\n",
                  heap_bytes / (1024 * 1024), heap_max / (1024 * 1024), brake_level == brake_level_t::critical ? "critical" : "high");
       processor.storage_handler().set_read_cache_size(braked_read_cache_bytes(derived_budgets, brake_level));
+      point_buffer_pool().set_retain_limit(braked_buffer_pool_bytes(derived_budgets, brake_level));
     }
     frame_brake = brake_level;
     frame_cpu_resident_budget = cpu_resident_budget;
@@ -212,6 +255,15 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
     io_limits.max_upload_bytes = upload_budget_per_frame;
     io_limits.gpu_memory_budget = gpu_memory_budget;
     io_limits.decoded_backlog_cap = derived_budgets.decoded_backlog_cap;
+    if (frame_arbiter)
+    {
+      // Shared budgets: what the other sources left of the global caps, and the cross-source error floor.
+      io_limits.max_concurrent_io = grant.max_concurrent_io;
+      io_limits.gpu_memory_budget = grant.gpu_memory_budget;
+      io_limits.decoded_backlog_cap = grant.decoded_backlog_cap;
+      io_limits.rank_by_screen_error = true;
+      io_limits.min_screen_error = grant.min_screen_error;
+    }
     // The brake never relaxes (the wasm heap cannot shrink), so every level must stay livable as a
     // PERMANENT state: high halves the caps, critical quarters them and trickles new IO at 1/frame --
     // never zero, which would brick streaming for the rest of the session. malloc reuses freed space
@@ -229,6 +281,11 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
     }
   }
 
+  // A registered source runs its decodes on the arbiter's pool; its own is created on first use only.
+  if (!frame_arbiter && !own_convert_pool)
+    own_convert_pool = std::make_unique<vio::thread_pool_t>(std::max(2u, std::thread::hardware_concurrency() / 2));
+  vio::thread_pool_t &convert_pool = frame_arbiter ? frame_arbiter->convert_pool() : *own_convert_pool;
+
   // Handle attribute change
   if (new_attribute)
   {
@@ -251,6 +308,7 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
 
   // Phase 1: Tree walk
   glm::dvec3 camera_position = glm::dvec3(camera.inverse_view[3]);
+  camera_motion.update(camera.inverse_view, delta_ms);
   lod_params_t lod_params;
   lod_params.camera_position = camera_position;
   lod_params.projection = camera.projection;
@@ -301,9 +359,44 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
       fade_duration_ms, callbacks, node_loader.get(), &virtual_gpu_used, pending_destroy);
   frame_timings.render_list_size = int(render_list.size());
   auto t_after_build = clock::now();
+  auto tree_config = processor.tree_config();
+
+  // Phase 2.5: Occlusion pyramid, from the consumer's depth readback of the previous frame when it provides
+  // one, else splatted from the occluder samples of the nodes already uploaded (with this frame's camera).
+  // process_io_and_upload then ranks or drops the unloaded nodes behind it.
+  frame_timings.occlusion_ms = 0;
+  occlusion_occluders_last = 0;
+  occlusion_from_readback_last = false;
+  if (frame_occlusion_mode != occlusion_mode_t::off)
+  {
+    auto to0 = clock::now();
+    if (frame_depth_callback && has_previous_camera)
+    {
+      occlusion_pyramid.begin(previous_camera, frame_viewport_width, frame_viewport_height);
+      occlusion_from_readback_last = frame_depth_callback(occlusion_pyramid.level0(), occlusion_pyramid.width(), occlusion_pyramid.height(), frame_depth_user_ptr) != 0;
+      if (occlusion_from_readback_last)
+        occlusion_pyramid.convert_window_depth();
+    }
+    if (!occlusion_from_readback_last)
+    {
+      occlusion_pyramid.begin(camera, frame_viewport_width, frame_viewport_height);
+      const glm::dvec3 tree_offset(tree_config.offset[0], tree_config.offset[1], tree_config.offset[2]);
+      for (auto &np : render_list)
+      {
+        const auto &node = *np;
+        if (node.gpu_state != render_node_gpu_state::uploaded || !node.walker_data.frustum_visible || node.fade_state == render_node_fade_state::fade_out)
+          continue;
+        if (node.occluder_samples.empty())
+          continue;
+        occlusion_pyramid.splat_node(node, tree_offset);
+        occlusion_occluders_last++;
+      }
+    }
+    occlusion_pyramid.build();
+    frame_timings.occlusion_ms = std::chrono::duration<double, std::milli>(clock::now() - to0).count();
+  }
 
   // Phase 3: IO + upload (single pass for distances, completions, scheduling, upload)
-  auto tree_config = processor.tree_config();
   // Departed-but-busy nodes parked in pending_destroy (including ones build_render_list just parked) still
   // hold decoded/decoding CPU buffers in the same heap; pre-charge them against the backlog cap. An
   // uploaded node's decoded buffers were already reaped -- only pre-upload states pin CPU.
@@ -311,9 +404,14 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
     if (np && (np->io_state == render_node_io_state::converting ||
                (np->io_state == render_node_io_state::loaded && np->gpu_state == render_node_gpu_state::none)))
       io_limits.deferred_backlog_bytes += estimate_node_cpu_bytes(np->walker_data);
+  // Prefetch switched off at runtime: let go of the read-aheads still in flight (their bytes stay cached).
+  if (frame_prefetch_ms <= 0.0 && !prefetch.in_flight.empty())
+    cancel_prefetch(prefetch, node_loader.get());
   auto io_stats = process_io_and_upload(render_list, camera_position, tree_config,
       callbacks, node_loader.get(), convert_pool, camera, io_limits,
-      current_attr_min, current_attr_max, enable_virtual_subtrees, virtual_gpu_used, &cpu_reap_queue);
+      current_attr_min, current_attr_max, enable_virtual_subtrees, virtual_gpu_used, &cpu_reap_queue,
+      frame_prefetch_ms > 0.0 ? &prefetch : nullptr,
+      frame_occlusion_mode != occlusion_mode_t::off ? &occlusion_pyramid : nullptr, frame_occlusion_mode);
   decoded_backlog_bytes_last.store(io_stats.backlog_bytes, std::memory_order_relaxed);
   // Free this frame's dead decoded CPU buffers on a worker (their dtor cascade is ~140 render-thread samples).
   if (!cpu_reap_queue.empty())
@@ -327,6 +425,49 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
   frame_timings.normalize_ms = io_stats.normalize_ms;
   frame_timings.gpu_upload_ms = io_stats.gpu_upload_ms;
   frame_timings.uploads_this_frame = io_stats.uploads_done;
+
+  // Phase 3.5: Predictive prefetch. Extrapolate the camera path, walk the frustum it will have
+  // prefetch_lookahead_ms from now, and read ahead the nodes that walk selects but this frame's did not --
+  // the leading edge of a pan, which otherwise shows coarse LOD until the loads issued on arrival catch up.
+  // The predicted walk also requests any unloaded subtrees it reaches, so tree blobs are warmed too.
+  frame_timings.prefetch_ms = 0;
+  prefetch_scheduled_last = 0;
+  if (frame_prefetch_ms > 0.0)
+  {
+    const auto &ta = tight_aabb_accumulator;
+    const double scene_scale = ta.min.x <= ta.max.x ? glm::length(ta.max - ta.min) : 0.0;
+    if (camera_motion.is_moving(frame_prefetch_ms, scene_scale))
+    {
+      auto tp0 = clock::now();
+      const glm::dmat4 predicted_inverse_view = camera_motion.predict_inverse_view(frame_prefetch_ms);
+      lod_params_t predicted_lod_params = lod_params;
+      predicted_lod_params.camera_position = glm::dvec3(predicted_inverse_view[3]);
+      frustum_tree_walker_t predicted_walker(camera.projection * glm::inverse(predicted_inverse_view), predicted_lod_params, cached_walker_attribute_names);
+      processor.walk_tree(predicted_walker);
+
+      node_set_t selected_now;
+      selected_now.reserve(walker_subsets.size());
+      for (auto &s : walker_subsets)
+        selected_now.insert(s.node);
+      auto &candidates = predicted_walker.m_new_nodes.point_subsets;
+      candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                      [&selected_now](const tree_walker_data_t &w) { return selected_now.count(w.node) > 0; }),
+                       candidates.end());
+      prefetch_scheduled_last = schedule_prefetch(prefetch, candidates, predicted_lod_params.camera_position, tree_config,
+                                                  node_loader.get(), io_limits, io_stats);
+      frame_timings.prefetch_ms = std::chrono::duration<double, std::milli>(clock::now() - tp0).count();
+    }
+  }
+  if (frame_arbiter)
+  {
+    arbiter_report_t report;
+    report.backlog_bytes = io_stats.backlog_bytes;
+    report.gpu_bytes = io_stats.gpu_memory_used + virtual_gpu_used + io_stats.projected_gpu_bytes;
+    report.io_in_flight = io_stats.io_in_flight + int(prefetch.in_flight.size());
+    report.demand = std::move(io_stats.screen_error_demand);
+    frame_arbiter->report(this, std::move(report));
+  }
+  io_stats_last = io_stats;
   auto t_after_io_upload = clock::now();
 
   // Phase 4: Update fades
@@ -452,7 +593,7 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
     vf.callbacks = &callbacks;
     vf.convert_pool = &convert_pool;
     vf.lod_random_offsets = &virtual_lod_random_offsets;
-    vf.gpu_memory_budget = gpu_memory_budget;
+    vf.gpu_memory_budget = io_limits.gpu_memory_budget;
     vf.gpu_memory_used = &virtual_gpu_used;
     vf.real_gpu_used = io_stats.gpu_memory_used; // monolith GPU total this frame -> shared budget gate
     vf.virtual_min_points = virtual_min_points;
@@ -614,6 +755,9 @@ void dew_converter_data_source_t::add_to_frame(dew_frame_camera_t *c_camera, dew
   points_rendered_last_frame = pts_rendered;
   auto t_after_emit = clock::now();
 
+  previous_camera = camera;
+  has_previous_camera = true;
+
   auto t_end = clock::now();
 
   auto to_ms = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
@@ -741,6 +885,56 @@ void dew_converter_data_source_set_max_in_flight_io(struct dew_converter_data_so
   converter_data_source->max_in_flight_io = max_requests;
 }
 
+void dew_converter_data_source_set_prefetch_lookahead_ms(struct dew_converter_data_source_t *cds, double lookahead_ms)
+{
+  std::unique_lock<std::mutex> lock(cds->mutex);
+  cds->prefetch_lookahead_ms = lookahead_ms > 0.0 ? lookahead_ms : 0.0;
+}
+
+void dew_converter_data_source_get_prefetch_stats(struct dew_converter_data_source_t *cds,
+  uint64_t *issued, uint64_t *hits, uint32_t *in_flight, uint32_t *scheduled_last_frame, double *hit_rate)
+{
+  auto &p = cds->prefetch;
+  if (issued)
+    *issued = p.issued_total;
+  if (hits)
+    *hits = p.hits_total;
+  if (in_flight)
+    *in_flight = uint32_t(p.in_flight.size());
+  if (scheduled_last_frame)
+    *scheduled_last_frame = uint32_t(cds->prefetch_scheduled_last);
+  if (hit_rate)
+    *hit_rate = p.hit_rate();
+}
+
+void dew_converter_data_source_set_occlusion_culling(struct dew_converter_data_source_t *cds, uint32_t mode)
+{
+  std::unique_lock<std::mutex> lock(cds->mutex);
+  cds->occlusion_mode = mode > uint32_t(occlusion_mode_t::skip) ? occlusion_mode_t::off : occlusion_mode_t(mode);
+}
+
+void dew_converter_data_source_set_occlusion_depth_callback(struct dew_converter_data_source_t *cds, dew_converter_data_source_occlusion_depth_callback_t callback, void *user_ptr)
+{
+  std::unique_lock<std::mutex> lock(cds->mutex);
+  cds->occlusion_depth_callback = callback;
+  cds->occlusion_depth_user_ptr = user_ptr;
+}
+
+void dew_converter_data_source_get_occlusion_stats(struct dew_converter_data_source_t *cds,
+  uint32_t *tested, uint32_t *occluded, uint32_t *occluders, double *coverage, double *build_ms)
+{
+  if (tested)
+    *tested = uint32_t(cds->io_stats_last.occlusion_tested);
+  if (occluded)
+    *occluded = uint32_t(cds->io_stats_last.occlusion_occluded);
+  if (occluders)
+    *occluders = uint32_t(cds->occlusion_occluders_last);
+  if (coverage)
+    *coverage = cds->occlusion_pyramid.valid() ? cds->occlusion_pyramid.coverage() : 0.0;
+  if (build_ms)
+    *build_ms = cds->frame_timings.occlusion_ms;
+}
+
 void dew_converter_data_source_set_memory_budget(struct dew_converter_data_source_t *cds, uint64_t total_bytes)
 {
   constexpr uint64_t min_budget = 64 * 1024 * 1024;
@@ -756,6 +950,7 @@ void dew_converter_data_source_set_memory_budget(struct dew_converter_data_sourc
   // divisor in effect, so lowering the budget under pressure tightens the cache as the user expects.
   cds->processor.storage_handler().set_read_cache_size(braked_read_cache_bytes(cds->derived_budgets, cds->brake_level));
   cds->processor.storage_handler().set_decompressed_cache_size(cds->derived_budgets.decompressed_cache_bytes);
+  point_buffer_pool().set_retain_limit(braked_buffer_pool_bytes(cds->derived_budgets, cds->brake_level));
 }
 
 uint64_t dew_converter_data_source_get_memory_budget(struct dew_converter_data_source_t *cds)
@@ -786,6 +981,77 @@ void dew_converter_data_source_get_memory_stats(struct dew_converter_data_source
     *read_cache_bytes = cds->processor.storage_handler().read_cache_current_bytes();
 }
 
+struct dew_converter_arbiter_t *dew_converter_arbiter_create(void)
+{
+  return new dew_converter_arbiter_t();
+}
+
+void dew_converter_arbiter_destroy(struct dew_converter_arbiter_t *arbiter)
+{
+  delete arbiter;
+}
+
+void dew_converter_arbiter_add_data_source(struct dew_converter_arbiter_t *arbiter, struct dew_converter_data_source_t *cds)
+{
+  std::unique_lock<std::mutex> lock(cds->mutex);
+  if (cds->arbiter == arbiter->arbiter)
+    return;
+  if (cds->arbiter)
+    cds->arbiter->remove_source(cds);
+  cds->arbiter = arbiter->arbiter;
+  cds->arbiter->add_source(cds);
+  // The cache and resident share is applied by the next frame's grant.
+}
+
+void dew_converter_arbiter_remove_data_source(struct dew_converter_arbiter_t *arbiter, struct dew_converter_data_source_t *cds)
+{
+  std::unique_lock<std::mutex> lock(cds->mutex);
+  if (cds->arbiter != arbiter->arbiter)
+    return;
+  cds->arbiter->remove_source(cds);
+  // A frame in progress holds its own reference, so it finishes on the shared pool; the next one creates
+  // the source's own.
+  cds->arbiter.reset();
+  // Back on its own budgets, exactly as set_memory_budget would leave them.
+  cds->derived_budgets = derive_budgets(cds->total_memory_budget);
+  cds->cpu_resident_budget = cds->derived_budgets.cpu_resident_budget;
+  cds->processor.storage_handler().set_read_cache_size(braked_read_cache_bytes(cds->derived_budgets, cds->brake_level));
+  cds->processor.storage_handler().set_decompressed_cache_size(cds->derived_budgets.decompressed_cache_bytes);
+  point_buffer_pool().set_retain_limit(braked_buffer_pool_bytes(cds->derived_budgets, cds->brake_level));
+}
+
+void dew_converter_arbiter_set_memory_budget(struct dew_converter_arbiter_t *arbiter, uint64_t total_bytes)
+{
+  constexpr uint64_t min_budget = 64 * 1024 * 1024;
+  arbiter->arbiter->set_memory_budget(std::max(total_bytes, min_budget));
+}
+
+void dew_converter_arbiter_set_gpu_memory_budget(struct dew_converter_arbiter_t *arbiter, size_t budget_bytes)
+{
+  arbiter->arbiter->set_gpu_memory_budget(budget_bytes);
+}
+
+void dew_converter_arbiter_set_max_in_flight_io(struct dew_converter_arbiter_t *arbiter, int max_requests)
+{
+  arbiter->arbiter->set_max_in_flight_io(max_requests);
+}
+
+void dew_converter_arbiter_get_stats(struct dew_converter_arbiter_t *arbiter,
+  uint32_t *sources, uint64_t *backlog_bytes, uint64_t *gpu_bytes, uint32_t *io_in_flight, double *min_screen_error)
+{
+  const auto st = arbiter->arbiter->stats();
+  if (sources)
+    *sources = uint32_t(st.sources);
+  if (backlog_bytes)
+    *backlog_bytes = st.backlog_bytes;
+  if (gpu_bytes)
+    *gpu_bytes = st.gpu_bytes;
+  if (io_in_flight)
+    *io_in_flight = uint32_t(st.io_in_flight);
+  if (min_screen_error)
+    *min_screen_error = st.min_screen_error;
+}
+
 uint64_t dew_converter_data_source_get_points_rendered(struct dew_converter_data_source_t *converter_data_source)
 {
   return converter_data_source->points_rendered_last_frame;
@@ -17,14 +17,18 @@
 ************************************************************************/
 #pragma once
 
+#include "camera_motion.hpp"
 #include "compressor.hpp"
 #include "converter.hpp"
 #include "data_source_node_bbox.hpp"
 #include "frustum_tree_walker.hpp"
 #include "memory_budget.hpp"
+#include "occlusion_culler.hpp"
 #include "render_node.hpp"
 #include "render_pipeline.hpp"
+#include "resource_arbiter.hpp"
 #include "renderer_callbacks.hpp"
+#include <dew/converter/converter_data_source.h>
 #include <dew/render/data_source.h>
 
 #include <vio/thread_pool.h>
@@ -72,6 +76,16 @@ struct dew_converter_data_source_t
   size_t upload_budget_per_frame = 6 * 1024 * 1024;
   int max_in_flight_io = 64;
   int max_new_io_per_frame = 16;
+  // Predictive prefetch: how far ahead (ms) to extrapolate the camera path and warm the blob cache for the
+  // predicted frustum. 0 disables it (and the second walk it costs). Read-aheads only use IO slots and
+  // backlog headroom the real loads leave unused; see schedule_prefetch.
+  double prefetch_lookahead_ms = 0.0;
+  // Occlusion culling before IO (occlusion_culler.hpp). Off by default. With a depth callback the pyramid
+  // comes from the consumer's readback of the previous frame; without one (or when it declines) it is
+  // splatted from the uploaded nodes' occluder samples.
+  dew::converter::occlusion_mode_t occlusion_mode = dew::converter::occlusion_mode_t::off;
+  dew_converter_data_source_occlusion_depth_callback_t occlusion_depth_callback = nullptr;
+  void *occlusion_depth_user_ptr = nullptr;
 
   // Total CPU-memory budget for the streaming renderer (the one consumer knob; GPU has its own budget above).
   // derive_budgets() splits it into the read-cache size, the decoded-backlog byte cap, the virtual-resident
@@ -94,7 +108,12 @@ struct dew_converter_data_source_t
   dew_buffer_t index_buffer;
 
   std::unique_ptr<dew::render::node_data_loader_t> node_loader;
-  vio::thread_pool_t convert_pool{std::max(2u, std::thread::hardware_concurrency() / 2)};
+  // Shared budgets (resource_arbiter.hpp), set by dew_converter_arbiter_add_data_source under the mutex.
+  // Declared before the pools so it outlives them: the shared convert pool may still run this source's
+  // reap jobs when the source goes. A registered source uses the arbiter's pool; its own is only created
+  // (lazily, on the render thread) when it renders unregistered.
+  std::shared_ptr<dew::converter::resource_arbiter_t> arbiter;
+  std::unique_ptr<vio::thread_pool_t> own_convert_pool;
   dew::converter::render_list_t render_list;
   // Departed nodes whose worker job (convert / resident-build / virtual materialize) is still in flight.
   // build_render_list parks them here instead of spin-waiting; add_to_frame retries them each frame. This
@@ -105,8 +124,21 @@ struct dew_converter_data_source_t
   // Render-thread-only (only add_to_frame touches it), so no lock.
   std::vector<dew::render::loaded_node_data_t> cpu_reap_queue;
 
+  // Render-thread-only (add_to_frame); the stats getter reads them unlocked like the other frame stats.
+  dew::converter::camera_motion_t camera_motion;
+  dew::converter::prefetch_state_t prefetch;
+  int prefetch_scheduled_last = 0;
+  dew::converter::occlusion_pyramid_t occlusion_pyramid;
+  dew::render::frame_camera_cpp_t previous_camera = {};
+  bool has_previous_camera = false;
+  int occlusion_occluders_last = 0;   // nodes splatted into the pyramid (0 when it came from a readback)
+  bool occlusion_from_readback_last = false;
+
   uint64_t points_rendered_last_frame = 0;
   dew::converter::frame_timings_t frame_timings;
+  // The last frame's full IO/upload counters (frame_timings keeps only the timings). Render-thread-only, read
+  // by in-process harnesses (dew bench) between frames.
+  dew::converter::io_upload_stats_t io_stats_last;
 
   dew::core::compression_stats_t attribute_stats;
   double current_attr_min = 0.0;
@@ -139,3 +171,10 @@ struct dew_converter_data_source_t
   bool virtual_animating = false;            // a resident build / materialize / fade is pending -> keep ticking
   std::vector<float> virtual_lod_random_offsets; // deterministic per-cell pick, identical to the converter's
 };
+
+// The C handle only holds a reference: registered data sources keep the arbiter (and its convert pool)
+// alive past dew_converter_arbiter_destroy until they are removed or destroyed.
+struct dew_converter_arbiter_t
+{
+  std::shared_ptr<dew::converter::resource_arbiter_t> arbiter = std::make_shared<dew::converter::resource_arbiter_t>();
+};
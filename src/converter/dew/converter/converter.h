@@ -135,6 +135,13 @@ struct dew_converter_str_buffer
   uint32_t size;
 };
 
+enum dew_converter_push_status_t
+{
+  dew_push_status_accepted,
+  dew_push_status_would_block,
+  dew_push_status_error
+};
+
 enum dew_converter_conversion_status_t
 {
   dew_conversion_status_error,
@@ -156,6 +163,17 @@ enum dew_converter_compression_t
   dew_converter_compression_huff0 = 3
 };
 
+// Which point survives duplicate elimination (dew_converter_set_dedup). The input-order policies rank
+// points by position within their chunk, and chunks by arrival at the leaf; the attribute policies fall
+// back to that order when values tie or the input lacks the attribute.
+enum dew_converter_dedup_keep_t
+{
+  dew_converter_dedup_keep_first = 0,
+  dew_converter_dedup_keep_last = 1,
+  dew_converter_dedup_keep_max_intensity = 2,
+  dew_converter_dedup_keep_latest_gps_time = 3
+};
+
 struct dew_converter_attribute_stats_t
 {
   char name[64];
@@ -178,6 +196,7 @@ struct dew_converter_stats_t
   uint32_t lod_buffer_count;
   uint32_t compression_method;
   uint64_t input_file_size_bytes;
+  uint64_t duplicate_points_removed;
   uint32_t attribute_count;
   //= arrays: attributes[attribute_count]
   struct dew_converter_attribute_stats_t attributes[32];
@@ -193,6 +212,14 @@ struct dew_converter_io_stats_t
   double low_mbps;
 };
 
+struct dew_converter_numa_node_stats_t
+{
+  uint32_t node;      // NUMA node id as the kernel numbers it
+  uint32_t workers;   // pinned worker threads
+  double cpu_seconds; // CPU time the node's workers consumed
+  double utilization; // cpu_seconds / (workers * wall time since the pools started), 0..1
+};
+
 struct dew_converter_perf_stats_t
 {
   double total_time_seconds;
@@ -207,6 +234,17 @@ struct dew_converter_perf_stats_t
   double lod_generation_seconds;
   uint64_t cache_hits;
   uint64_t cache_misses;
+  uint64_t buffer_pool_hits;   // point-chunk buffers reused from the recycling pool
+  uint64_t buffer_pool_misses; // ... and those that had to be allocated
+  double allocation_seconds;   // time the pool spent in the allocator
+  uint64_t peak_buffer_bytes;  // peak bytes of pooled point buffers in use at once
+  uint64_t peak_rss_bytes;     // peak resident set of the process (0 where unavailable)
+  uint8_t autotuned;           // dew_converter_set_autotune was on; the settings below are its final ones
+  uint64_t autotune_read_chunk_bytes;
+  uint32_t autotune_max_readers;
+  uint32_t autotune_max_sorters;
+  uint32_t autotune_max_compressors;
+  uint32_t autotune_decisions; // settings changes made during the run
 };
 
 struct dew_converter_t;
@@ -279,6 +317,22 @@ DEW_CONVERTER_EXPORT void dew_converter_set_tree_scale(struct dew_converter_t *c
  * substantial size cost). Must be called before dew_converter_add_data_file. */
 DEW_CONVERTER_EXPORT void dew_converter_set_lod_all_attributes(struct dew_converter_t *converter, uint8_t all);
 
+/* Drop duplicate points after the morton sort (default off). With grid_lod 0 only points with an
+ * identical morton code are duplicates; grid_lod N > 0 also collapses points sharing a cell 2^N grid
+ * steps wide (grid_lod 1 removes near-duplicates about one grid step apart). `keep` picks the survivor.
+ * Applied within each sorted chunk and again across chunks when leaves are collapsed; the removed count
+ * is reported as duplicate_points_removed in the compression stats. Must be called before
+ * dew_converter_add_data_file. */
+DEW_CONVERTER_EXPORT void dew_converter_set_dedup(struct dew_converter_t *converter, uint8_t enabled, uint8_t grid_lod, enum dew_converter_dedup_keep_t keep);
+
+/* Store an attribute with bounded precision loss (default: exact). Float attributes (r32/r64, e.g.
+ * gps_time) are kept as integer steps of `tolerance`, restoring within tolerance / 2; integer attributes
+ * (e.g. intensity) are rounded down to a multiple of the largest power of two not exceeding tolerance + 1,
+ * and low bits that are zero in every value are dropped -- with tolerance 0 that alone, losslessly.
+ * Readers get the attribute back in its declared type; zone-map min/max are widened by the error. A
+ * negative tolerance removes the policy. Must be called before dew_converter_add_data_file. */
+DEW_CONVERTER_EXPORT void dew_converter_set_attribute_precision(struct dew_converter_t *converter, const char *name, uint32_t name_size, double tolerance);
+
 // Read/sort chunk byte target (default 64 MiB): the converter ingests each input in chunks of about
 // this many bytes (computed from the file's per-point width, never below the node point limit,
 // capped at 8M points per chunk). Larger chunks amortize source reads and sorting; the octree still
@@ -286,11 +340,85 @@ DEW_CONVERTER_EXPORT void dew_converter_set_lod_all_attributes(struct dew_conver
 // Must be called before dew_converter_add_data_file.
 DEW_CONVERTER_EXPORT void dew_converter_set_read_chunk_bytes(struct dew_converter_t *converter, uint64_t bytes);
 
+// Write a hierarchy directory with the finished dataset (default 0 = none): the serialized trees of the
+// top `depth` tree levels (each spans five octree levels), breadth-first in one blob, so a reader opening
+// the dataset descends that far after a single read instead of one read per tree. Leave it off for local
+// files; it pays off against object stores, where each tree read is a round trip. Trees beyond a 64 MiB
+// directory still load on demand.
+DEW_CONVERTER_EXPORT void dew_converter_set_hierarchy_directory_depth(struct dew_converter_t *converter, uint32_t depth);
+
+// Pass 1 to run the conversion on one worker pool per NUMA node (topology from /sys/devices/system/node),
+// workers pinned to their node's CPUs. Each input is read, sorted and compressed on one node, and LOD and
+// collapse work is spread over the nodes by subtree. Returns 0 and keeps the single shared pool on machines
+// with fewer than two nodes, off Linux, or when inputs were already added. Must be called before
+// dew_converter_add_data_file.
+DEW_CONVERTER_EXPORT uint8_t dew_converter_set_numa_pools(struct dew_converter_t *converter, uint8_t enabled);
+
+// Pass 1 to let the converter tune itself while it runs: every couple of seconds it compares the stage
+// throughputs and queue depths (inputs read, chunks waiting to sort, writes waiting to compress) and moves
+// one of the read chunk size and the number of concurrent readers, sorters and compressors, keeping the
+// point buffers within the read/sort memory budget and undoing a change that lowered throughput. Each
+// decision is logged to stderr; the final settings land in the perf stats. Returns 0 when inputs were
+// already added. Must be called before dew_converter_add_data_file.
+DEW_CONVERTER_EXPORT uint8_t dew_converter_set_autotune(struct dew_converter_t *converter, uint8_t enabled);
+
+// Per-node worker utilization while NUMA pools are enabled; the count is 0 otherwise.
+DEW_CONVERTER_EXPORT uint32_t dew_converter_get_numa_node_count(struct dew_converter_t *converter);
+DEW_CONVERTER_EXPORT bool dew_converter_get_numa_node_stats(struct dew_converter_t *converter, uint32_t index, struct dew_converter_numa_node_stats_t *stats);
+
 // May block on ingest backpressure, so Python bindings must release the GIL around it.
 //= arrays: buffers[buffer_count]
 //= blocking
 DEW_CONVERTER_EXPORT void dew_converter_add_data_file(struct dew_converter_t *converter, struct dew_converter_str_buffer *buffers, uint32_t buffer_count);
 
+/* Remove an input file from the dataset, or replace it with another file, without reconverting the rest.
+ * `name` is the name the file was added with. Its points are dropped from the leaves they landed in, the
+ * replacement (if any) is read like any input, and LOD is rebuilt only along the morton ranges of the two
+ * files up to the root; every other node keeps its blobs. Where the removed file's points were already
+ * merged into per-node units the file is read once more to subtract them, so it must still hold the data
+ * it was converted from.
+ *
+ * The call validates and queues the edit; dew_converter_wait_idle waits for it like for a new input. It
+ * fails when the file is not an input of this dataset, is still being converted, is a push stream segment,
+ * or the converter uploads to a destination (uploaded subtrees are immutable). An edit interrupted by a
+ * crash is not resumed: issue it again after reopening. */
+DEW_CONVERTER_EXPORT bool dew_converter_remove_input(struct dew_converter_t *converter, const char *name, uint64_t name_size, struct dew_error_t **error);
+
+DEW_CONVERTER_EXPORT bool dew_converter_replace_input(struct dew_converter_t *converter, const char *name, uint64_t name_size, const char *new_name, uint64_t new_name_size, struct dew_error_t **error);
+
+/* Push ingest for live feeds (mobile-mapping rigs, scanners streaming over the network): hand the converter
+ * `point_count` points that are already in memory, one buffer per attribute as in
+ * dew_converter_file_convert_data_callback_t (attributes[0] must be xyz). Callable from any thread; the
+ * buffers are copied before it returns. Small batches are coalesced into read-sized chunks, so batch size
+ * does not shape the stored blobs.
+ *
+ * header.offset/scale describe the i32 xyz encoding like a file's init header does. header.min is a
+ * promise about the stream: no point pushed from now on lies below it. It is what lets incremental LOD and
+ * checkpoints follow the stream while it runs; a batch whose header.min -- or whose own lowest point,
+ * should it break the promise -- reaches below the part of the dataset that is already final is refused
+ * with an error. A feed that cannot bound where it goes next
+ * passes the bottom of its survey area -- the dataset then still grows checkpoint by checkpoint, but LOD
+ * is only built once the stream ends.
+ *
+ * Pushed points count against the converter's ingest memory budget until they are sorted. When they do
+ * not fit, a call with `block` set waits; one without returns dew_push_status_would_block and accepts
+ * nothing. The stream keeps the converter busy until dew_converter_push_end, so call that before
+ * dew_converter_wait_idle. */
+//= py.skip
+//= arrays: attributes[attribute_count]
+DEW_CONVERTER_EXPORT enum dew_converter_push_status_t dew_converter_push_points(struct dew_converter_t *converter, const struct dew_converter_header_t *header, const struct dew_attribute_t *attributes, uint32_t attribute_count,
+                                                                                const struct dew_blob_t *buffers, uint64_t point_count, uint8_t block, struct dew_error_t **error);
+
+// Cut the push stream here: what was pushed so far is sorted, inserted and checkpointed (and its LOD
+// built, as far as header.min allows) without waiting for the segment size. The stream stays open.
+DEW_CONVERTER_EXPORT void dew_converter_push_flush(struct dew_converter_t *converter);
+
+// End the push stream. The conversion completes once its last points are in; a later push starts a new one.
+DEW_CONVERTER_EXPORT void dew_converter_push_end(struct dew_converter_t *converter);
+
+// Points per push segment (default 16M): the stream is checkpointed, and its LOD advanced, every this many points.
+DEW_CONVERTER_EXPORT void dew_converter_set_push_segment_points(struct dew_converter_t *converter, uint64_t points);
+
 DEW_CONVERTER_EXPORT void dew_converter_wait_idle(struct dew_converter_t *converter);
 
 DEW_CONVERTER_EXPORT enum dew_converter_conversion_status_t dew_converter_status(struct dew_converter_t *converter);
@@ -60,6 +60,37 @@ DEW_CONVERTER_EXPORT void dew_converter_data_source_set_gpu_memory_budget(struct
 DEW_CONVERTER_EXPORT void dew_converter_data_source_set_upload_budget_per_frame(struct dew_converter_data_source_t *converter_data_source, size_t budget_bytes);
 DEW_CONVERTER_EXPORT void dew_converter_data_source_set_max_in_flight_io(struct dew_converter_data_source_t *converter_data_source, int max_requests);
 
+/* Predictive prefetch. The data source extrapolates the camera path from its recent frames (linear and
+ * angular velocity) and, while the camera moves, reads ahead the nodes the frustum `lookahead_ms` in the
+ * future will need: raw blob reads into the read cache, no decode or GPU upload, only in IO slots and
+ * backlog headroom the on-screen loads leave unused. 0 (the default) disables it. */
+DEW_CONVERTER_EXPORT void dew_converter_data_source_set_prefetch_lookahead_ms(struct dew_converter_data_source_t *cds, double lookahead_ms);
+/* Prefetch observability: read-aheads issued and hits (a later real load whose primary blob a read-ahead
+ * had already cached), both since creation; read-aheads in flight now and issued last frame; and
+ * hit_rate = hits / issued. Any out-pointer may be null. */
+DEW_CONVERTER_EXPORT void dew_converter_data_source_get_prefetch_stats(struct dew_converter_data_source_t *cds,
+  uint64_t *issued, uint64_t *hits, uint32_t *in_flight, uint32_t *scheduled_last_frame, double *hit_rate);
+
+/* Occlusion culling before IO. Nodes the walker selects but that sit behind what is already drawn are
+ * tested against a coarse depth pyramid and, with mode 1, loaded only after every visible node; with
+ * mode 2, not loaded until they come into view (less IO and GPU memory in dense urban/indoor scenes, at
+ * the price of pop-in when the camera moves around a corner). 0 (the default) disables it. The pyramid is
+ * built on the CPU from a few dozen points kept per uploaded node, unless a depth callback is set. */
+DEW_CONVERTER_EXPORT void dew_converter_data_source_set_occlusion_culling(struct dew_converter_data_source_t *cds, uint32_t mode);
+/* Supplies the previous frame's depth instead. Called on the render thread during the frame: fill
+ * `depth` (width * height floats, row 0 at the TOP -- flip a GL readback) with window depth in [0,1],
+ * each value the FARTHEST depth of the pixels it covers, and return 1; return 0 to fall back to the CPU
+ * pyramid for this frame. width/height are small (at most 128 on the long side). Null unsets it. */
+//= py.skip
+typedef uint8_t (*dew_converter_data_source_occlusion_depth_callback_t)(float *depth, int width, int height, void *user_ptr);
+//= py.skip
+DEW_CONVERTER_EXPORT void dew_converter_data_source_set_occlusion_depth_callback(struct dew_converter_data_source_t *cds, dew_converter_data_source_occlusion_depth_callback_t callback, void *user_ptr);
+/* Occlusion observability for the last frame: unloaded nodes tested, how many were occluded, nodes
+ * splatted into the pyramid (0 when it came from the depth callback), the fraction of the pyramid
+ * covered, and the time spent building it. Any out-pointer may be null. */
+DEW_CONVERTER_EXPORT void dew_converter_data_source_get_occlusion_stats(struct dew_converter_data_source_t *cds,
+  uint32_t *tested, uint32_t *occluded, uint32_t *occluders, double *coverage, double *build_ms);
+
 /* One total CPU-memory budget for the streaming renderer. Internally derived into the read-cache size, the
  * decoded-backlog byte cap (new IO is refused while estimated in-flight + decoded-awaiting-upload bytes
  * exceed it), the virtual-subtree CPU-resident budget, and a clamp on max_in_flight_io (see
@@ -77,6 +108,26 @@ DEW_CONVERTER_EXPORT void dew_converter_data_source_get_memory_stats(struct dew_
   uint64_t *heap_bytes, uint64_t *heap_max, uint64_t *budget_bytes, uint64_t *backlog_bytes,
   uint64_t *read_cache_bytes, uint64_t *resident_cpu_bytes, uint32_t *brake_level);
 
+/* Shared budgets for several converter data sources in one renderer. Registered sources draw on one CPU
+ * memory budget, one GPU budget, one in-flight IO limit and one convert thread pool instead of each
+ * deriving its own, and unloaded nodes are ranked by screen-space error across all of them, so the
+ * coarsest-looking part of the view loads first whichever dataset it is in. The per-source budget setters
+ * are ignored while a source is registered. Sources may be added and removed at any time; a removed source
+ * falls back to its own budgets. The arbiter lives until it is destroyed AND no source holds it. */
+struct dew_converter_arbiter_t;
+DEW_CONVERTER_EXPORT struct dew_converter_arbiter_t *dew_converter_arbiter_create(void);
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_destroy(struct dew_converter_arbiter_t *arbiter);
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_add_data_source(struct dew_converter_arbiter_t *arbiter, struct dew_converter_data_source_t *cds);
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_remove_data_source(struct dew_converter_arbiter_t *arbiter, struct dew_converter_data_source_t *cds);
+/* The same knobs as the per-source setters, with the same defaults (1GB CPU, 512MB GPU, 64 IO). */
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_set_memory_budget(struct dew_converter_arbiter_t *arbiter, uint64_t total_bytes);
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_set_gpu_memory_budget(struct dew_converter_arbiter_t *arbiter, size_t budget_bytes);
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_set_max_in_flight_io(struct dew_converter_arbiter_t *arbiter, int max_requests);
+/* Totals over the registered sources as of their last frames, and the screen-error floor (a fraction of
+ * the viewport height; 0 when every waiting node fits the free IO slots). Any out-pointer may be null. */
+DEW_CONVERTER_EXPORT void dew_converter_arbiter_get_stats(struct dew_converter_arbiter_t *arbiter,
+  uint32_t *sources, uint64_t *backlog_bytes, uint64_t *gpu_bytes, uint32_t *io_in_flight, double *min_screen_error);
+
 DEW_CONVERTER_EXPORT uint64_t dew_converter_data_source_get_points_rendered(struct dew_converter_data_source_t *converter_data_source);
 
 DEW_CONVERTER_EXPORT uint8_t dew_converter_data_source_is_animating(struct dew_converter_data_source_t *converter_data_source);
@@ -27,6 +27,12 @@ extern "C" {
 
 DEW_CONVERTER_EXPORT struct dew_converter_file_convert_callbacks_t dew_laszip_callbacks(void);
 
+/* Inputs named by an object-store URL (s3://bucket/tile.laz, az://, dir://, mem://) are read in place with
+ * ranged GETs of window_bytes (0: the 8 MiB default), read_ahead windows ahead of the decoder; the
+ * pre-init probe fetches only the LAS header. connection is the provider connection string for the input
+ * bucket (NULL or empty: environment credentials). Process-wide; applies to inputs opened afterwards. */
+DEW_CONVERTER_EXPORT void dew_laszip_set_remote_options(uint64_t window_bytes, uint32_t read_ahead, const char *connection, size_t connection_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,8 +20,12 @@
 #include "memory_writer.hpp"
 #include "morton_tree_coordinate_transform.hpp"
 
+#include <fmt/format.h>
+
+#include <algorithm>
 #include <cstring>
 #include <mutex>
+#include <string_view>
 
 namespace dew::converter
 {
@@ -70,7 +74,7 @@ input_data_reference_t input_data_source_registry_t::register_file(std::unique_p
   for (auto &kv : _registry)
   {
     auto &item = kv.second;
-    if (item.name_length == name_length && memcmp(item.name.get(), name.get(), name_length) == 0)
+    if (!item.subtract && item.name_length == name_length && memcmp(item.name.get(), name.get(), name_length) == 0)
     {
       if (already_done && item.read_finished && item.inserted_into_tree == item.sub_count)
         *already_done = true;
@@ -91,6 +95,131 @@ input_data_reference_t input_data_source_registry_t::register_file(std::unique_p
   return {input_id, {item.name.get(), item.name_length}};
 }
 
+bool input_data_source_registry_t::register_stream_segment(const morton::morton192_t &floor, input_data_reference_t &ref)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (floor < _reported_watermark)
+    return false;
+  auto input_id = get_next_input_id();
+  auto &item = _registry[input_id.data];
+  morton::morton_init_max(item.morton_min);
+  item.input_id = input_id;
+  // Segments are never matched by name (register_file) -- the name only has to be unique and readable.
+  auto name = fmt::format("push://{}", input_id.data);
+  item.name_length = uint32_t(name.size());
+  item.name.reset(new char[name.size() + 1]);
+  memcpy(item.name.get(), name.c_str(), name.size() + 1);
+  item.attribute_id = {0};
+  item.public_header = {};
+  item.input_order = floor;
+  item.stream = true;
+  item.read_started = true;
+  _sorted_input_sources.push_back(input_id.data);
+  ref = {input_id, {item.name.get(), item.name_length}};
+  return true;
+}
+
+bool input_data_source_registry_t::lower_stream_floor(input_data_id_t id, const morton::morton192_t &floor)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto &item = get_item(id, _registry);
+  if (!(floor < item.input_order))
+    return true;
+  if (floor < _reported_watermark)
+    return false;
+  item.input_order = floor;
+  return true;
+}
+
+void input_data_source_registry_t::restore_reported_watermark(const morton::morton192_t &watermark)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (_reported_watermark < watermark)
+    _reported_watermark = watermark;
+}
+
+bool input_data_source_registry_t::stream_segment_complete(input_data_id_t id)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto &item = get_item(id, _registry);
+  return item.stream && item.read_finished && item.inserted_into_tree == item.sub_count;
+}
+
+std::optional<input_extent_t> input_data_source_registry_t::find_input(const char *name, uint32_t name_length)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (auto &kv : _registry)
+  {
+    auto &item = kv.second;
+    if (item.subtract || item.name_length != name_length || memcmp(item.name.get(), name, name_length) != 0)
+      continue;
+    return input_extent_t{item.input_id, item.morton_min, item.morton_max, item.read_finished && item.inserted_into_tree == item.sub_count, item.stream};
+  }
+  return {};
+}
+
+input_extent_t input_data_source_registry_t::extent(input_data_id_t id)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto &item = get_item(id, _registry);
+  return {item.input_id, item.morton_min, item.morton_max, item.read_finished && item.inserted_into_tree == item.sub_count, item.stream};
+}
+
+input_data_reference_t input_data_source_registry_t::register_subtract_file(input_data_id_t source)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto input_id = get_next_input_id();
+  auto &source_item = get_item(source, _registry);
+  auto name_length = source_item.name_length;
+  std::unique_ptr<char[]> name(new char[name_length + 1]);
+  memcpy(name.get(), source_item.name.get(), name_length);
+  name[name_length] = 0;
+  auto &item = _registry[input_id.data]; // may rehash: source_item is not used past this point
+  morton::morton_init_max(item.morton_min);
+  item.input_id = input_id;
+  item.name = std::move(name);
+  item.name_length = name_length;
+  item.attribute_id = {0};
+  item.public_header = {};
+  item.subtract = true;
+  return {input_id, {item.name.get(), item.name_length}};
+}
+
+bool input_data_source_registry_t::is_subtract_input(input_data_id_t id)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  return get_item(id, _registry).subtract;
+}
+
+bool input_data_source_registry_t::input_complete(input_data_id_t id)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto &item = get_item(id, _registry);
+  return item.read_finished && item.inserted_into_tree == item.sub_count;
+}
+
+void input_data_source_registry_t::forget_input(input_data_id_t id)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto it = _registry.find(id.data);
+  if (it == _registry.end())
+    return;
+  auto &item = it->second;
+  _input_data_with_sub_parts -= item.sub_count;
+  _input_data_inserted_to_tree -= item.inserted_into_tree;
+  if (item.read_finished)
+    _input_data_id_done_count--;
+  auto sorted = std::find(_sorted_input_sources.begin(), _sorted_input_sources.end(), id.data);
+  if (sorted != _sorted_input_sources.end())
+  {
+    if (uint32_t(sorted - _sorted_input_sources.begin()) < _done_prefix_index)
+      _done_prefix_index--;
+    _sorted_input_sources.erase(sorted);
+  }
+  _registry.erase(it);
+  _unsorted_input_sources_dirty = true;
+}
+
 void input_data_source_registry_t::register_pre_init_result(const tree_config_t &tree_config, input_data_id_t id, bool found_min, double (&min)[3], uint64_t approximate_point_count, uint8_t approximate_point_size_bytes, uint64_t input_file_size_bytes)
 {
   std::unique_lock<std::mutex> lock(_mutex);
@@ -217,6 +346,18 @@ std::optional<input_data_next_input_t> input_data_source_registry_t::next_input_
   return ret;
 }
 
+uint32_t input_data_source_registry_t::inputs_waiting() const
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  uint32_t waiting = 0;
+  for (auto &item : _registry)
+  {
+    if (!item.second.read_started)
+      waiting++;
+  }
+  return waiting;
+}
+
 uint64_t input_data_source_registry_t::get_approximate_size(input_data_id_t id)
 {
   std::unique_lock<std::mutex> lock(_mutex);
@@ -267,12 +408,22 @@ std::optional<morton::morton192_t> input_data_source_registry_t::get_done_morton
     auto &item = kv.second;
     if (!item.read_started && item.input_order < boundary)
       boundary = item.input_order;
+    // An open stream segment is dispatched, but it sits wherever it was registered in the dispatch order,
+    // not by its floor: clamp by it explicitly, it can still deliver points anywhere above its floor.
+    if (item.stream && !(item.read_finished && item.inserted_into_tree == item.sub_count))
+    {
+      auto stream_min = item.morton_min < item.input_order ? item.morton_min : item.input_order;
+      if (stream_min < boundary)
+        boundary = stream_min;
+    }
   }
   // Boundary 0 proves nothing final; report "no watermark" instead of a zero-advance.
   morton::morton192_t zero;
   memset(&zero, 0, sizeof(zero));
   if (!(zero < boundary))
     return {};
+  if (_reported_watermark < boundary)
+    _reported_watermark = boundary;
   return boundary;
 }
 
@@ -304,25 +455,44 @@ std::vector<uint8_t> input_data_source_registry_t::serialize() const
   uint32_t size = 0;
   size += sizeof(k_input_registry_magic);
   size += sizeof(uint32_t); // file count
+  // Subtract entries belong to an edit in flight and are not persisted: on resume the edit is issued
+  // again, and a dispatch list naming them would not restore.
+  uint32_t file_count = 0;
+  std::vector<uint32_t> sorted_sources;
+  sorted_sources.reserve(_sorted_input_sources.size());
+  uint32_t done_prefix_index = 0;
+  for (uint32_t i = 0; i < uint32_t(_sorted_input_sources.size()); i++)
+  {
+    if (_registry.at(_sorted_input_sources[i]).subtract)
+      continue;
+    sorted_sources.push_back(_sorted_input_sources[i]);
+    if (i < _done_prefix_index)
+      done_prefix_index = uint32_t(sorted_sources.size());
+  }
   for (auto &kv : _registry)
   {
+    if (kv.second.subtract)
+      continue;
+    file_count++;
     size += sizeof(uint32_t);                        // id
     size += sizeof(uint32_t) + kv.second.name_length; // name
     size += 3 * uint32_t(sizeof(morton::morton192_t)); // input_order, morton_min, morton_max
     size += 2 * uint32_t(sizeof(uint32_t));          // sub_count, inserted_into_tree
     size += 2 * uint32_t(sizeof(uint8_t));           // read_started, read_finished
   }
-  size += sizeof(uint32_t) + uint32_t(_sorted_input_sources.size()) * uint32_t(sizeof(uint32_t));
+  size += sizeof(uint32_t) + uint32_t(sorted_sources.size()) * uint32_t(sizeof(uint32_t));
   size += sizeof(uint32_t); // done prefix index
 
   std::vector<uint8_t> out(size);
   uint8_t *ptr = out.data();
   uint8_t *end_ptr = ptr + out.size();
   bool ok = write_memory(ptr, end_ptr, k_input_registry_magic);
-  ok = ok && write_memory(ptr, end_ptr, uint32_t(_registry.size()));
+  ok = ok && write_memory(ptr, end_ptr, file_count);
   for (auto &kv : _registry)
   {
     auto &item = kv.second;
+    if (item.subtract)
+      continue;
     ok = ok && write_memory(ptr, end_ptr, kv.first);
     ok = ok && write_memory(ptr, end_ptr, item.name_length);
     if (ok && item.name_length)
@@ -343,9 +513,9 @@ std::vector<uint8_t> input_data_source_registry_t::serialize() const
     ok = ok && write_memory(ptr, end_ptr, uint8_t(item.read_started ? 1 : 0));
     ok = ok && write_memory(ptr, end_ptr, uint8_t(item.read_finished ? 1 : 0));
   }
-  ok = ok && write_memory(ptr, end_ptr, uint32_t(_sorted_input_sources.size()));
-  ok = ok && write_vec_type(ptr, end_ptr, _sorted_input_sources);
-  ok = ok && write_memory(ptr, end_ptr, _done_prefix_index);
+  ok = ok && write_memory(ptr, end_ptr, uint32_t(sorted_sources.size()));
+  ok = ok && write_vec_type(ptr, end_ptr, sorted_sources);
+  ok = ok && write_memory(ptr, end_ptr, done_prefix_index);
   assert(ok && ptr == end_ptr);
   if (!ok)
     return {};
@@ -405,6 +575,21 @@ dew_error_t input_data_source_registry_t::deserialize(const uint8_t *data, uint3
     if (id > max_id)
       max_id = id;
   }
+  // A push stream segment that was still open cannot be re-read: its points came from a live feed.
+  // Keep what the checkpoint committed and close it there, so it does not hold back completion.
+  static constexpr std::string_view push_prefix = "push://";
+  for (auto &kv : _registry)
+  {
+    auto &item = kv.second;
+    if (item.read_finished || std::string_view(item.name.get(), item.name_length).substr(0, push_prefix.size()) != push_prefix)
+      continue;
+    item.stream = true;
+    item.read_started = true;
+    item.read_finished = true;
+    _input_data_with_sub_parts -= item.sub_count - item.inserted_into_tree;
+    item.sub_count = item.inserted_into_tree;
+    _input_data_id_done_count++;
+  }
   uint32_t sorted_count = 0;
   if (!read_memory(ptr, end_ptr, sorted_count))
     return invalid;
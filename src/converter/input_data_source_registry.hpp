@@ -47,6 +47,8 @@ struct input_data_source_impl_t
   morton::morton192_t input_order;
   bool read_started = false;
   bool read_finished = false;
+  bool stream = false; // a push stream segment: dispatched on registration, input_order is its floor
+  bool subtract = false; // a re-read of a removed input: its points are taken out of the tree, not added
   uint8_t approximate_point_size_bytes = 0;
   uint32_t inserted_into_tree = 0;
   uint32_t sub_count = 0;
@@ -63,6 +65,16 @@ struct input_data_reference_t
   input_name_ref_t name;
 };
 
+// Where an input's points went, for localized removal (see register_subtract_file).
+struct input_extent_t
+{
+  input_data_id_t input_id;
+  morton::morton192_t morton_min;
+  morton::morton192_t morton_max;
+  bool complete; // read and every chunk inserted into the tree
+  bool stream;
+};
+
 struct input_data_next_input_t
 {
   input_data_id_t id;
@@ -86,6 +98,28 @@ public:
   // when the file completed in an earlier session per the restored snapshot -- the caller must then
   // skip reading it (its points are already in the committed tree).
   input_data_reference_t register_file(std::unique_ptr<char[]> &&name, uint32_t name_length, bool *already_done = nullptr);
+  // Push ingest: registers the next segment of a live stream as an input that is already dispatched,
+  // with `floor` (the morton of the lowest point the stream declares it may still deliver) as its
+  // input_order. lower_stream_floor moves an open segment's floor down for a batch that reaches lower.
+  // Both refuse (return false) a floor below a watermark get_done_morton already reported: that region is
+  // final, and the points would land in subtrees whose LOD was already built.
+  [[nodiscard]] bool register_stream_segment(const morton::morton192_t &floor, input_data_reference_t &ref);
+  [[nodiscard]] bool lower_stream_floor(input_data_id_t id, const morton::morton192_t &floor);
+  // Resume: the committed LOD watermark is final too, before get_done_morton ever reports one.
+  void restore_reported_watermark(const morton::morton192_t &watermark);
+  // True once a stream segment is closed and every chunk it received is in the tree.
+  bool stream_segment_complete(input_data_id_t id);
+  // Input removal/replacement. find_input looks a file up by name (never a subtract entry); extent reads
+  // one back by id. register_subtract_file registers a second read of `source` -- same name, fresh id --
+  // whose sorted chunks the processor routes to the tree as points to REMOVE; subtract entries are never
+  // name-matched and never persisted (an interrupted edit is simply issued again). forget_input drops an
+  // entry whose points are gone from the tree, so a file of the same name can be added again.
+  std::optional<input_extent_t> find_input(const char *name, uint32_t name_length);
+  input_extent_t extent(input_data_id_t id);
+  input_data_reference_t register_subtract_file(input_data_id_t source);
+  bool is_subtract_input(input_data_id_t id);
+  bool input_complete(input_data_id_t id);
+  void forget_input(input_data_id_t id);
   void register_pre_init_result(const tree_config_t &tree_config, input_data_id_t id, bool found_min, double (&min)[3], uint64_t approximate_point_count, uint8_t approximate_point_size_bytes, uint64_t input_file_size_bytes);
   void handle_input_init(input_data_id_t id, attributes_id_t attributes_id, dew_converter_header_t public_header);
   void handle_sub_added(input_data_id_t id);
@@ -97,6 +131,8 @@ public:
   bool all_inserted_into_tree() const;
 
   std::optional<input_data_next_input_t> next_input_to_process();
+  // Registered inputs next_input_to_process has not handed out yet.
+  uint32_t inputs_waiting() const;
   uint64_t get_approximate_size(input_data_id_t id);
 
   std::optional<morton::morton192_t> get_done_morton();
@@ -121,5 +157,6 @@ private:
   std::vector<uint32_t> _sorted_input_sources;
   bool _unsorted_input_sources_dirty;
   uint32_t _done_prefix_index = 0;
+  morton::morton192_t _reported_watermark = {};
 };
 } // namespace dew::converter
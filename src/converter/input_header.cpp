@@ -30,12 +30,12 @@ void attribute_buffers_initialize(const std::vector<point_format_t> &attributes_
   for (auto &attribute : attributes_def)
   {
     uint32_t buffer_size = size_for_format(attribute.type) * uint32_t(attribute.components) * point_count;
-    buffers.data.emplace_back(new uint8_t[buffer_size]);
+    buffers.data.emplace_back(point_buffer_pool().acquire(buffer_size));
     buffers.buffers.emplace_back(buffers.data.back().get(), buffer_size);
   }
 }
 
-void attribute_buffers_initialize(const std::vector<point_format_t> &attributes_def, attribute_buffers_t &buffers, uint32_t point_count, std::unique_ptr<uint8_t[]> &&morton_attribute_buffer)
+void attribute_buffers_initialize(const std::vector<point_format_t> &attributes_def, attribute_buffers_t &buffers, uint32_t point_count, point_buffer_t &&morton_attribute_buffer)
 {
   buffers.data.reserve(attributes_def.size());
   buffers.buffers.reserve(attributes_def.size());
@@ -50,7 +50,7 @@ void attribute_buffers_initialize(const std::vector<point_format_t> &attributes_
     }
     else
     {
-      buffers.data.emplace_back(new uint8_t[buffer_size]);
+      buffers.data.emplace_back(point_buffer_pool().acquire(buffer_size));
     }
     buffers.buffers.emplace_back(buffers.data.back().get(), buffer_size);
   }
@@ -20,16 +20,22 @@
 #include <dew/converter/laszip_file_convert_callbacks.h>
 
 #include "error.hpp"
+#include "remote_input.hpp"
 
 #include <fmt/format.h>
 #include <laszip_api.h>
 
+#include <algorithm>
 #include <assert.h>
+#include <cstring>
 #include <filesystem>
 
+using dew::converter::remote_input_t;
+
 struct laszip_handle_t
 {
   std::string filename;
+  std::unique_ptr<remote_input_t> remote; // object-store inputs; outlives the reader reading from it
   laszip_POINTER reader = nullptr;
   laszip_point *point = nullptr;
   uint64_t point_count = 0;
@@ -139,6 +145,87 @@ static void add_attributes_format_10(dew_attributes_t *attributes)
   add_wave_packets(attributes);
 }
 
+// Opens the laszip reader on a local path, or on a read-ahead stream for an object-store URL.
+static bool open_laszip_reader(laszip_handle_t &handle, const std::string &filename, laszip_BOOL *is_compressed, struct dew_error_t **error)
+{
+  if (!dew::converter::is_remote_input(filename))
+  {
+    if (!laszip_open_reader(handle.reader, filename.c_str(), is_compressed))
+      return true;
+    *error = new dew_error_t();
+    (*error)->code = -1;
+    (*error)->msg = fmt::format("Failed opening laszip reader for '{}'.", filename);
+    return false;
+  }
+  dew_error_t remote_error;
+  handle.remote = remote_input_t::open(filename, dew::converter::remote_input_options(), remote_error);
+  if (!handle.remote)
+  {
+    *error = new dew_error_t(std::move(remote_error));
+    return false;
+  }
+  if (!laszip_open_reader_stream(handle.reader, handle.remote->stream(), is_compressed))
+    return true;
+  *error = new dew_error_t();
+  (*error)->code = -1;
+  (*error)->msg = handle.remote->error().code != 0 ? fmt::format("Failed opening laszip reader for '{}': {}", filename, handle.remote->error().msg)
+                                                    : fmt::format("Failed opening laszip reader for '{}'.", filename);
+  return false;
+}
+
+// LAS public header fields, by offset (identical for LAZ: only the point format carries the compression
+// bits). Big enough for the 1.4 header; older headers are shorter and stop before the 64-bit count.
+static constexpr uint64_t k_las_header_bytes = 375;
+
+template <typename T>
+static T las_header_field(const uint8_t *header, size_t offset)
+{
+  T value;
+  memcpy(&value, header + offset, sizeof(value));
+  return value;
+}
+
+// Pre-init for an object-store input: one ranged GET of the header instead of opening laszip, which
+// would also fetch the VLRs and (for LAZ) the chunk table at the end of the object.
+static dew_converter_file_pre_init_info_t remote_get_aabb_min(const std::string &filename, struct dew_error_t **error)
+{
+  dew_converter_file_pre_init_info_t ret = {};
+  dew_error_t remote_error;
+  auto remote = remote_input_t::open(filename, dew::converter::remote_input_options(), remote_error);
+  if (!remote)
+  {
+    *error = new dew_error_t(std::move(remote_error));
+    return ret;
+  }
+  ret.input_file_size_bytes = remote->size();
+  uint8_t header[k_las_header_bytes] = {};
+  const uint64_t header_size = std::min<uint64_t>(k_las_header_bytes, remote->size());
+  if (header_size < 227 || (remote_error = remote->read_range(0, header, header_size)).code != 0 || memcmp(header, "LASF", 4) != 0)
+  {
+    *error = new dew_error_t();
+    (*error)->code = -1;
+    (*error)->msg = remote_error.code != 0 ? fmt::format("Failed to read LAS header for '{}': {}", filename, remote_error.msg) : fmt::format("'{}' is not a LAS/LAZ file.", filename);
+    return ret;
+  }
+  const uint8_t version_minor = header[25];
+  uint64_t point_count = las_header_field<uint32_t>(header, 107);
+  if (point_count == 0 && version_minor >= 4 && header_size >= 255)
+    point_count = las_header_field<uint64_t>(header, 247);
+
+  ret.aabb_min[0] = las_header_field<double>(header, 187);
+  ret.aabb_min[1] = las_header_field<double>(header, 203);
+  ret.aabb_min[2] = las_header_field<double>(header, 219);
+  ret.approximate_point_count = point_count;
+  ret.approximate_point_size_bytes = uint8_t(las_header_field<uint16_t>(header, 105));
+  ret.found_aabb_min = true;
+  ret.found_point_count = true;
+  ret.scale[0] = las_header_field<double>(header, 131);
+  ret.scale[1] = las_header_field<double>(header, 139);
+  ret.scale[2] = las_header_field<double>(header, 147);
+  ret.found_scale = ret.scale[0] > 0.0 && ret.scale[1] > 0.0 && ret.scale[2] > 0.0;
+  return ret;
+}
+
 static dew_converter_file_pre_init_info_t laszip_converter_file_get_aabb_min(const char *filename, size_t filename_size, struct dew_error_t **error)
 {
   (void)filename;
@@ -150,6 +237,9 @@ static dew_converter_file_pre_init_info_t laszip_converter_file_get_aabb_min(con
   ret.found_scale = false;
   ret.input_file_size_bytes = 0;
 
+  if (dew::converter::is_remote_input(std::string_view(filename, filename_size)))
+    return remote_get_aabb_min(std::string(filename, filename_size), error);
+
   {
     std::error_code ec;
     auto fsize = std::filesystem::file_size(std::filesystem::path(std::string(filename, filename_size)), ec);
@@ -219,14 +309,8 @@ static void laszip_converter_file_init(const char *filename, size_t filename_siz
   laszip_BOOL is_compressed = 0;
   std::string filename_str(filename, filename_size);
   laszip_handle->filename = filename_str;
-  if (laszip_open_reader(laszip_handle->reader, filename_str.c_str(), &is_compressed))
-  {
-    *error = new dew_error_t();
-    auto e = *error;
-    e->code = -1;
-    e->msg = fmt::format("Failed opening laszip reader for '{}'.", filename_str);
+  if (!open_laszip_reader(*laszip_handle, filename_str, &is_compressed, error))
     return;
-  }
 
   laszip_header_struct *lasheader;
   if (laszip_get_header_pointer(laszip_handle->reader, &lasheader))
@@ -457,7 +541,10 @@ void copy_points_for_format(laszip_handle_t *laszip_handle, uint64_t point_count
       *error = new dew_error_t();
       auto e = *error;
       e->code = -1;
-      e->msg = fmt::format("Failed to read point from laszip reader '{}'.", laszip_handle->filename);
+      if (laszip_handle->remote && laszip_handle->remote->error().code != 0)
+        e->msg = fmt::format("Failed to read point from laszip reader '{}': {}", laszip_handle->filename, laszip_handle->remote->error().msg);
+      else
+        e->msg = fmt::format("Failed to read point from laszip reader '{}'.", laszip_handle->filename);
       return;
     }
     copy_point_for_format<FORMAT>(buffers, i, point);
@@ -531,6 +618,17 @@ static void laszip_converter_file_destroy_user_ptr(void *user_ptr)
   delete laszip_handle;
 }
 
+void dew_laszip_set_remote_options(uint64_t window_bytes, uint32_t read_ahead, const char *connection, size_t connection_size)
+{
+  dew::converter::remote_input_options_t options;
+  if (window_bytes)
+    options.window_bytes = window_bytes;
+  options.read_ahead = read_ahead;
+  if (connection && connection_size)
+    options.connection.assign(connection, connection_size);
+  dew::converter::set_remote_input_options(std::move(options));
+}
+
 struct dew_converter_file_convert_callbacks_t dew_laszip_callbacks()
 {
   dew_converter_file_convert_callbacks_t ret;
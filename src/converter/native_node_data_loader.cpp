@@ -56,7 +56,15 @@ bool native_node_data_loader_t::is_ready(render::load_handle_t handle)
   std::lock_guard<std::mutex> lock(_mutex);
   auto it = _pending.find(handle);
   if (it == _pending.end())
-    return false;
+  {
+    auto pit = _prefetching.find(handle);
+    if (pit == _prefetching.end())
+      return false;
+    for (auto &read : pit->second)
+      if (!read->is_done())
+        return false;
+    return true;
+  }
   return it->second.data_handler->is_done();
 }
 
@@ -85,7 +93,40 @@ void native_node_data_loader_t::cancel(render::load_handle_t handle)
   {
     it->second.data_handler->cancel_requests();
     _pending.erase(it);
+    return;
   }
+  // A prefetch is only dropped, never cancelled: a cancelled read still caches its bytes, but there is no
+  // reason to mark it -- nothing decodes a raw read anyway.
+  _prefetching.erase(handle);
+}
+
+render::load_handle_t native_node_data_loader_t::request_prefetch(const void *request_data, uint32_t request_size)
+{
+  assert(request_size == sizeof(native_load_request_t));
+  (void)request_size;
+
+  native_load_request_t req;
+  std::memcpy(&req, request_data, sizeof(req));
+
+  // raw: the compressed bytes land in the read cache and stop there. The later request_load takes the
+  // cache-hit branch and decompresses on the pool, which is the whole saving -- the network round trip.
+  std::vector<std::shared_ptr<read_request_t>> reads;
+  reads.reserve(4);
+  for (auto &location : req.locations)
+  {
+    if (location.size == 0)
+      break;
+    read_options_t options;
+    options.raw = true;
+    reads.emplace_back(_reader.read(location, std::move(options)));
+  }
+  if (reads.empty())
+    return render::invalid_load_handle;
+
+  auto handle = _next_handle.fetch_add(1);
+  std::lock_guard<std::mutex> lock(_mutex);
+  _prefetching[handle] = std::move(reads);
+  return handle;
 }
 
 } // namespace dew::converter
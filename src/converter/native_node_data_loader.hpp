@@ -26,6 +26,7 @@
 #include <atomic>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace dew::converter
 {
@@ -60,12 +61,15 @@ public:
   bool is_ready(render::load_handle_t handle) override;
   render::loaded_node_data_t get_data(render::load_handle_t handle) override;
   void cancel(render::load_handle_t handle) override;
+  render::load_handle_t request_prefetch(const void *request_data, uint32_t request_size) override;
 
 private:
   blob_reader_t &_reader;
   std::mutex _mutex;
   std::atomic<uint64_t> _next_handle{1};
   std::unordered_map<uint64_t, pending_request_t> _pending;
+  // Raw (compressed, undecoded) read-aheads; they share the handle space with _pending.
+  std::unordered_map<uint64_t, std::vector<std::shared_ptr<read_request_t>>> _prefetching;
 };
 
 } // namespace dew::converter
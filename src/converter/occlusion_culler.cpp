@@ -0,0 +1,238 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "occlusion_culler.hpp"
+
+#include "render_node.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace dew::converter
+{
+
+namespace
+{
+constexpr float empty_depth = std::numeric_limits<float>::max();
+constexpr double eye_epsilon = 1e-6;
+} // namespace
+
+void capture_occluder_samples(render_node_t &node, const void *vertex_data, uint32_t vertex_data_size, uint32_t point_count, bool lod_ordered)
+{
+  node.occluder_samples.clear();
+  node.occluder_radius = 0.0f;
+  const uint32_t stride = 3u * uint32_t(sizeof(float));
+  if (!vertex_data || point_count == 0 || vertex_data_size < uint64_t(point_count) * stride)
+    return;
+
+  const uint32_t count = std::min(point_count, occluder_samples_per_node);
+  node.occluder_samples.resize(count);
+  const auto *bytes = static_cast<const uint8_t *>(vertex_data);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const uint32_t source = lod_ordered ? i : uint32_t(uint64_t(i) * point_count / count);
+    std::memcpy(&node.occluder_samples[i], bytes + size_t(source) * stride, stride);
+  }
+
+  // Points of a scan lie on surfaces, so the spacing follows an area, not a volume: spread `count` samples
+  // over the largest face of the tight box. The radius is a little over the half-diagonal of that spacing,
+  // the smallest disc that closes a regular grid of samples (the LOD prefix is one point per grid cell).
+  const glm::dvec3 extent = node.walker_data.tight_aabb.max - node.walker_data.tight_aabb.min;
+  double e[3] = {std::max(extent.x, 0.0), std::max(extent.y, 0.0), std::max(extent.z, 0.0)};
+  std::sort(e, e + 3);
+  const double spacing = std::sqrt(e[2] * e[1] / double(count));
+  node.occluder_radius = float(0.75 * spacing);
+}
+
+void occlusion_pyramid_t::begin(const render::frame_camera_cpp_t &camera, int viewport_width, int viewport_height)
+{
+  _camera = camera;
+  _valid = false;
+  viewport_width = std::max(viewport_width, 1);
+  viewport_height = std::max(viewport_height, 1);
+  glm::ivec2 size;
+  if (viewport_width >= viewport_height)
+    size = {max_resolution, std::max(1, int(std::lround(double(max_resolution) * viewport_height / viewport_width)))};
+  else
+    size = {std::max(1, int(std::lround(double(max_resolution) * viewport_width / viewport_height))), max_resolution};
+
+  _sizes.clear();
+  _sizes.push_back(size);
+  while (size.x > 1 || size.y > 1)
+  {
+    size = {std::max(1, (size.x + 1) / 2), std::max(1, (size.y + 1) / 2)};
+    _sizes.push_back(size);
+  }
+  _levels.resize(_sizes.size());
+  for (size_t i = 0; i < _sizes.size(); i++)
+    _levels[i].assign(size_t(_sizes[i].x) * size_t(_sizes[i].y), empty_depth);
+}
+
+void occlusion_pyramid_t::splat_node(const render_node_t &node, const glm::dvec3 &tree_offset)
+{
+  if (_levels.empty() || node.occluder_samples.empty() || node.occluder_radius <= 0.0f)
+    return;
+  const int w = _sizes[0].x;
+  const int h = _sizes[0].y;
+  auto &level = _levels[0];
+  const glm::dvec3 origin = tree_offset + glm::dvec3(node.offset[0], node.offset[1], node.offset[2]);
+  // Texels per world unit at clip.w == 1 (perspective divides by w; an orthographic w is 1 everywhere).
+  const double texel_scale = _camera.projection[1][1] * 0.5 * double(h);
+
+  for (const auto &sample : node.occluder_samples)
+  {
+    const glm::dvec4 world(origin + glm::dvec3(sample), 1.0);
+    const glm::dvec4 clip = _camera.view_projection * world;
+    if (clip.w <= eye_epsilon)
+      continue;
+    const double depth = -(_camera.view * world).z;
+    if (depth <= 0.0)
+      continue;
+    const double radius = double(node.occluder_radius) * texel_scale / clip.w;
+    if (radius < 0.5)
+      continue; // cannot be trusted to cover a whole texel centre
+    const double cx = (clip.x / clip.w * 0.5 + 0.5) * w;
+    const double cy = (0.5 - clip.y / clip.w * 0.5) * h;
+    const int x0 = std::max(0, int(std::floor(cx - radius)));
+    const int x1 = std::min(w - 1, int(std::ceil(cx + radius)));
+    const int y0 = std::max(0, int(std::floor(cy - radius)));
+    const int y1 = std::min(h - 1, int(std::ceil(cy + radius)));
+    const double r2 = radius * radius;
+    for (int y = y0; y <= y1; y++)
+    {
+      const double dy = double(y) + 0.5 - cy;
+      for (int x = x0; x <= x1; x++)
+      {
+        const double dx = double(x) + 0.5 - cx;
+        if (dx * dx + dy * dy > r2)
+          continue;
+        float &texel = level[size_t(y) * size_t(w) + size_t(x)];
+        texel = std::min(texel, float(depth));
+      }
+    }
+  }
+}
+
+void occlusion_pyramid_t::convert_window_depth()
+{
+  if (_levels.empty())
+    return;
+  const int w = _sizes[0].x;
+  const int h = _sizes[0].y;
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++)
+    {
+      float &texel = _levels[0][size_t(y) * size_t(w) + size_t(x)];
+      if (!(texel < 1.0f)) // cleared (far plane) or NaN: nothing drawn there
+      {
+        texel = empty_depth;
+        continue;
+      }
+      const glm::dvec4 ndc((x + 0.5) / w * 2.0 - 1.0, 1.0 - (y + 0.5) / h * 2.0, double(texel) * 2.0 - 1.0, 1.0);
+      const glm::dvec4 view = _camera.inverse_projection * ndc;
+      const double depth = view.w != 0.0 ? -view.z / view.w : 0.0;
+      texel = depth > 0.0 ? float(depth) : empty_depth;
+    }
+  }
+}
+
+void occlusion_pyramid_t::build()
+{
+  for (size_t i = 1; i < _levels.size(); i++)
+  {
+    const glm::ivec2 src = _sizes[i - 1];
+    const glm::ivec2 dst = _sizes[i];
+    const auto &from = _levels[i - 1];
+    auto &to = _levels[i];
+    for (int y = 0; y < dst.y; y++)
+    {
+      for (int x = 0; x < dst.x; x++)
+      {
+        const int sx = std::min(2 * x + 1, src.x - 1);
+        const int sy = std::min(2 * y + 1, src.y - 1);
+        float m = from[size_t(2 * y) * src.x + size_t(2 * x)];
+        m = std::max(m, from[size_t(2 * y) * src.x + size_t(sx)]);
+        m = std::max(m, from[size_t(sy) * src.x + size_t(2 * x)]);
+        m = std::max(m, from[size_t(sy) * src.x + size_t(sx)]);
+        to[size_t(y) * dst.x + size_t(x)] = m;
+      }
+    }
+  }
+  _valid = !_levels.empty();
+}
+
+double occlusion_pyramid_t::coverage() const
+{
+  if (_levels.empty() || _levels[0].empty())
+    return 0.0;
+  const auto covered = std::count_if(_levels[0].begin(), _levels[0].end(), [](float d) { return d != empty_depth; });
+  return double(covered) / double(_levels[0].size());
+}
+
+bool occlusion_pyramid_t::is_occluded(const node_aabb_t &aabb) const
+{
+  if (!_valid)
+    return false;
+  const int w = _sizes[0].x;
+  const int h = _sizes[0].y;
+  double min_x = std::numeric_limits<double>::max(), min_y = min_x, nearest = min_x;
+  double max_x = std::numeric_limits<double>::lowest(), max_y = max_x;
+  for (int corner = 0; corner < 8; corner++)
+  {
+    const glm::dvec4 world(corner & 1 ? aabb.max.x : aabb.min.x, corner & 2 ? aabb.max.y : aabb.min.y, corner & 4 ? aabb.max.z : aabb.min.z, 1.0);
+    const glm::dvec4 clip = _camera.view_projection * world;
+    const double depth = -(_camera.view * world).z;
+    if (clip.w <= eye_epsilon || depth <= 0.0)
+      return false; // the box reaches the eye plane: its projection is unbounded
+    const double sx = (clip.x / clip.w * 0.5 + 0.5) * w;
+    const double sy = (0.5 - clip.y / clip.w * 0.5) * h;
+    min_x = std::min(min_x, sx);
+    max_x = std::max(max_x, sx);
+    min_y = std::min(min_y, sy);
+    max_y = std::max(max_y, sy);
+    nearest = std::min(nearest, depth);
+  }
+  int x0 = std::max(0, int(std::floor(min_x)));
+  int x1 = std::min(w - 1, int(std::floor(max_x)));
+  int y0 = std::max(0, int(std::floor(min_y)));
+  int y1 = std::min(h - 1, int(std::floor(max_y)));
+  if (x0 > x1 || y0 > y1)
+    return false; // off screen: frustum culling's business, not ours
+
+  // The coarsest-but-one level where the rectangle spans at most 2x2 texels: a constant-cost test.
+  size_t level = 0;
+  while (level + 1 < _levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+    level++;
+  x0 >>= level;
+  x1 = std::min(x1 >> level, _sizes[level].x - 1);
+  y0 >>= level;
+  y1 = std::min(y1 >> level, _sizes[level].y - 1);
+
+  float farthest = 0.0f;
+  const auto &texels = _levels[level];
+  for (int y = y0; y <= y1; y++)
+    for (int x = x0; x <= x1; x++)
+      farthest = std::max(farthest, texels[size_t(y) * _sizes[level].x + size_t(x)]);
+  if (farthest == empty_depth)
+    return false;
+  return nearest > double(farthest) * (1.0 + depth_bias);
+}
+
+} // namespace dew::converter
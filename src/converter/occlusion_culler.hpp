@@ -0,0 +1,100 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Occlusion culling of octree nodes before IO. The walker only culls by frustum and screen-space error, so
+// in a street or a building most of what it selects sits behind a facade that is already on screen -- and
+// every one of those nodes is still read, decoded and uploaded. This stage tests a candidate node's tight
+// AABB against a coarse depth pyramid of what is already drawn and lets process_io_and_upload push the
+// occluded ones to the back of the IO queue (or not load them at all).
+//
+// The pyramid is a max-depth (hierarchical-Z) pyramid in view-space depth over a small grid (at most
+// max_resolution texels on the long side). Its level 0 comes from one of two places:
+//  - CPU occluders: every uploaded node keeps a handful of its coarsest points (the LOD order puts an even
+//    spread of the node first) and splats them as discs sized to their spacing, with the current camera.
+//  - A depth readback from the consumer (dew_converter_data_source_set_occlusion_depth_callback), which
+//    is exact but one frame old; it is tested with the camera it was rendered with.
+//
+// Everything is biased towards "visible". A texel only counts as covered when a splat reaches its centre,
+// splats smaller than a texel are dropped, an empty texel is infinitely far, a box crossing the eye plane
+// is never occluded, and a box must lie behind the FARTHEST depth under its screen rectangle (plus
+// depth_bias) to be occluded. A wrong "occluded" costs pop-in; a wrong "visible" only costs the IO this
+// stage exists to save.
+
+#include "data_source.hpp" // render::frame_camera_cpp_t
+#include "frustum_tree_walker.hpp" // node_aabb_t
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace dew::converter
+{
+
+struct render_node_t;
+
+enum class occlusion_mode_t : uint8_t
+{
+  off = 0,
+  deprioritize = 1, // occluded nodes load only after every visible one was admitted
+  skip = 2,         // occluded nodes are not loaded until they come into view
+};
+
+// Occluder points kept per uploaded node (12 bytes each).
+static constexpr uint32_t occluder_samples_per_node = 64;
+
+// Keep a spread of a freshly decoded node's points (packed r32x3, relative to the node offset) as its
+// occluder samples. `lod_ordered` buffers are coarse->fine, so their prefix is already the spread; other
+// buffers are strided. The splat radius follows from the spacing the samples would have on the node's
+// largest face.
+void capture_occluder_samples(render_node_t &node, const void *vertex_data, uint32_t vertex_data_size, uint32_t point_count, bool lod_ordered);
+
+class occlusion_pyramid_t
+{
+public:
+  // Start a new pyramid for `camera`: size level 0 to the viewport's aspect and clear it to "nothing drawn".
+  void begin(const render::frame_camera_cpp_t &camera, int viewport_width, int viewport_height);
+  // CPU occluders: rasterize an uploaded node's occluder samples into level 0.
+  void splat_node(const render_node_t &node, const glm::dvec3 &tree_offset);
+  // Readback occluders: the consumer writes window depth [0,1] into level 0 (row 0 at the top, each texel
+  // the farthest depth of the pixels it covers), then convert_window_depth turns it into view depth.
+  [[nodiscard]] float *level0() { return _levels.empty() ? nullptr : _levels[0].data(); }
+  void convert_window_depth();
+  // Max-reduce the upper levels. Until build() runs after a begin(), nothing tests as occluded.
+  void build();
+
+  [[nodiscard]] bool valid() const { return _valid; }
+  [[nodiscard]] int width() const { return _sizes.empty() ? 0 : _sizes[0].x; }
+  [[nodiscard]] int height() const { return _sizes.empty() ? 0 : _sizes[0].y; }
+  // Fraction of level-0 texels holding an occluder, for stats.
+  [[nodiscard]] double coverage() const;
+
+  [[nodiscard]] bool is_occluded(const node_aabb_t &aabb) const;
+
+  static constexpr int max_resolution = 128;
+  static constexpr double depth_bias = 0.02; // relative: a box must be 2% farther than the occluder
+
+private:
+  render::frame_camera_cpp_t _camera = {};
+  std::vector<std::vector<float>> _levels;
+  std::vector<glm::ivec2> _sizes;
+  bool _valid = false;
+};
+
+} // namespace dew::converter
@@ -0,0 +1,132 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Duplicate-point elimination (tree_config_t::dedup_*). Overlapping flight lines and repeated scans
+// leave coincident points adjacent in morton order, so they are dropped where the points are already
+// sorted: the sort worker removes the duplicates inside each ingest chunk, and leaf collapse removes
+// the ones that straddle chunks when it merges a leaf's subsets. Both walk the same runs with the same
+// survivor policy, so a leaf ends up with one point per code (or grid cell) whichever chunks its
+// points arrived in.
+
+#include "dataset_types.hpp"
+#include "format_util.hpp"
+#include "morton.hpp"
+
+#include <cstring>
+
+namespace dew::converter
+{
+using namespace dew::core;
+
+// Mirrors dew_converter_dedup_keep_t.
+enum class dedup_keep_t : uint8_t
+{
+  first = 0,
+  last = 1,
+  max_intensity = 2,
+  latest_gps_time = 3
+};
+
+// Attribute the survivor policy compares, or nullptr for the input-order policies.
+inline const char *dedup_keep_attribute(dedup_keep_t keep)
+{
+  switch (keep)
+  {
+  case dedup_keep_t::max_intensity:
+    return "intensity";
+  case dedup_keep_t::latest_gps_time:
+    return "gps_time";
+  default:
+    return nullptr;
+  }
+}
+
+// Two sorted codes are duplicates when identical, or with grid_lod > 0 when they share the cell
+// grid_lod levels above the finest grid (morton_lod is the level of their highest differing bit).
+template <typename T, size_t C>
+inline bool dedup_same_cell(const morton::morton_t<T, C> &a, const morton::morton_t<T, C> &b, int grid_lod)
+{
+  if (a == b)
+    return true;
+  return grid_lod > 0 && morton::morton_lod(a, b) < grid_lod;
+}
+
+// First component of element `index` as a double; the tie-break attributes are scalars.
+inline double dedup_attribute_value(const uint8_t *data, point_format_t format, uint64_t index)
+{
+  const uint8_t *elem = data + index * uint64_t(size_for_format(format.type, format.components));
+  switch (format.type)
+  {
+  case dew_type_u8: { uint8_t v; memcpy(&v, elem, 1); return double(v); }
+  case dew_type_i8: { int8_t v; memcpy(&v, elem, 1); return double(v); }
+  case dew_type_u16: { uint16_t v; memcpy(&v, elem, 2); return double(v); }
+  case dew_type_i16: { int16_t v; memcpy(&v, elem, 2); return double(v); }
+  case dew_type_u32: { uint32_t v; memcpy(&v, elem, 4); return double(v); }
+  case dew_type_i32: { int32_t v; memcpy(&v, elem, 4); return double(v); }
+  case dew_type_r32: { float v; memcpy(&v, elem, 4); return double(v); }
+  case dew_type_u64: { uint64_t v; memcpy(&v, elem, 8); return double(v); }
+  case dew_type_i64: { int64_t v; memcpy(&v, elem, 8); return double(v); }
+  case dew_type_r64: { double v; memcpy(&v, elem, 8); return v; }
+  default: return 0.0;
+  }
+}
+
+// Walks `count` sorted entries and calls emit(i) once per run of duplicates with the survivor, in
+// order. same(a, b) compares entries, order(i) is the input-order rank (first/last policies and the
+// tie-break for equal attribute values) and value(i) the policy attribute (only called when the
+// policy names one; has_value false falls back to first). Returns the number of entries dropped.
+template <typename SAME, typename ORDER, typename VALUE, typename EMIT>
+uint64_t dedup_sorted_runs(size_t count, dedup_keep_t keep, bool has_value, SAME &&same, ORDER &&order, VALUE &&value, EMIT &&emit)
+{
+  const bool by_value = has_value && dedup_keep_attribute(keep) != nullptr;
+  uint64_t removed = 0;
+  size_t run_start = 0;
+  while (run_start < count)
+  {
+    size_t best = run_start;
+    size_t run_end = run_start + 1;
+    if (run_end < count && same(run_start, run_end))
+    {
+      double best_value = by_value ? value(run_start) : 0.0;
+      for (; run_end < count && same(run_start, run_end); run_end++)
+      {
+        bool better;
+        if (by_value)
+        {
+          const double v = value(run_end);
+          better = v > best_value || (v == best_value && order(run_end) < order(best));
+          if (better)
+            best_value = v;
+        }
+        else if (keep == dedup_keep_t::last)
+          better = order(run_end) > order(best);
+        else
+          better = order(run_end) < order(best);
+        if (better)
+          best = run_end;
+      }
+    }
+    emit(best);
+    removed += run_end - run_start - 1;
+    run_start = run_end;
+  }
+  return removed;
+}
+
+} // namespace dew::converter
@@ -22,12 +22,18 @@
 #include "loop_quiesce.hpp"
 #include "frustum_tree_walker.hpp"
 
+#include "input_header.hpp"
 #include "morton_tree_coordinate_transform.hpp"
 
+#include <dew/core/default_attribute_names.h>
+
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <functional>
+#include <limits>
 
 namespace dew::converter
 {
@@ -35,6 +41,7 @@ using namespace dew::core;
 processor_t::processor_t(std::string url, file_existence_requirement_t existence_requirement, dew_error_t &error, const destination_config_t &destination)
   : _url(std::move(url))
   , _thread_pool(int(std::thread::hardware_concurrency()))
+  , _worker_pools(_thread_pool, std::thread::hardware_concurrency())
   , _runtime_callbacks({})
   , _runtime_callback_user_ptr(nullptr)
   , _convert_callbacks({})
@@ -60,6 +67,8 @@ processor_t::processor_t(std::string url, file_existence_requirement_t existence
   , _point_reader(_input_event_loop, _thread_pool, _attributes_configs, _perf_stats, _input_init, _sub_added, _sorted_points, _point_reader_done_with_file, _point_reader_file_errors)
   , _read_sort_budget(uint64_t(1) << 30)
   , _read_sort_active_approximate_size(0)
+  , _input_edit_requests(_event_loop, bind(&processor_t::handle_input_edit_request))
+  , _input_edit_step(_event_loop, bind(&processor_t::handle_input_edit_step))
 {
   _destination = destination;
   _event_loop.add_about_to_block_listener(this);
@@ -141,7 +150,9 @@ processor_t::processor_t(std::string url, file_existence_requirement_t existence
         return;
       _lod_done_morton = _tree_handler.tree_registry().lod_watermark;
       _current_lod_target_morton = _lod_done_morton;
+      _input_data_source_registry.restore_reported_watermark(_lod_done_morton);
     }
+    _tree_live.store(true, std::memory_order_release);
     _tree_handler.request_root();
   }
 
@@ -229,7 +240,9 @@ processor_t::~processor_t()
   _tree_handler.begin_shutdown();
 
   // (2) Drain + join the shared pool. Its parked tree-load tasks wait_for_read() on the storage loop and
-  //     post the decoded tree to the tree loop -- both are still running here.
+  //     post the decoded tree to the tree loop -- both are still running here. The NUMA node pools (if
+  //     enabled) carry the same kinds of tasks and are fed by the same loops, so they drain here too.
+  _worker_pools.join();
   _thread_pool.join();
 
   // (3) No worker references storage/tree state now. Stop those loops before their backend / read cache /
@@ -249,10 +262,245 @@ void processor_t::add_files(std::vector<std::pair<std::unique_ptr<char[]>, uint3
     _idle = false;
     _new_file_events_sent++;
   }
+  _inputs_started.store(true, std::memory_order_release);
   _perf_stats.conversion_start = perf_stats_t::clock_t::now();
   _files_added.post_event(std::move(input_files));
 }
 
+// Push ingest for live feeds. A batch is copied into the chunk being filled (batches with the same layout
+// and coordinate frame coalesce, so a scanner pushing a few thousand points at a time does not produce
+// blobs of a few thousand points), and full chunks go straight to the sort workers -- from there on they
+// travel the same sorted -> written -> tree path as the chunks of an input file.
+//
+// The stream is cut into segments, each registered as its own, already dispatched input. A segment's
+// input_order is the stream's floor: the morton of the lowest header.min pushed into it. That is what lets
+// the done-morton watermark, and with it incremental LOD and finality, advance while the stream is still
+// running: a closed segment is an input like any other, and the open one holds the watermark at its floor.
+// header.min is therefore a promise about the stream, not just the batch: nothing pushed from here on lies
+// below it. The batch itself is held to it: its floor is the lower of header.min and the points' own
+// minimum, so a batch that breaks the promise is treated as reaching that far down. A batch whose floor
+// lies below a watermark that was already reported is refused -- its points would land in subtrees whose
+// LOD is built. A feed that cannot bound where it goes next pushes with
+// header.min at the bottom of its survey area; it is then only final once the stream ends, and the
+// checkpoint taken after each segment still lets a renderer watch the points arrive.
+//
+// Backpressure: admitted bytes count against the read/sort budget the input files share, until the sort
+// worker hands the chunk on. A batch that does not fit blocks, or returns would_block; one always fits
+// when nothing pushed is in flight. Admitted bytes still sitting in the coalescing chunk would never be
+// handed on while the feed waits, so the chunk is sent before any wait -- otherwise a batch bigger than
+// what is left of the budget would be waiting on itself. Input files finishing their read release the
+// budget too, and wake the wait as well.
+dew_converter_push_status_t processor_t::push_points(const dew_converter_header_t &header, const dew_attribute_t *attributes, uint32_t attribute_count, const dew_blob_t *buffers, uint64_t point_count, bool block,
+                                                     dew_error_t &error)
+{
+  if (!attributes || !buffers || attribute_count == 0)
+  {
+    error = {1, "Pushed points need at least the " DEW_ATTRIBUTE_XYZ " attribute"};
+    return dew_push_status_error;
+  }
+  if (attributes[0].name_size != strlen(DEW_ATTRIBUTE_XYZ) || memcmp(attributes[0].name, DEW_ATTRIBUTE_XYZ, attributes[0].name_size) != 0)
+  {
+    error = {1, "First attribute has to be " DEW_ATTRIBUTE_XYZ};
+    return dew_push_status_error;
+  }
+  if (attributes[0].type != dew_type_i32 || attributes[0].components != dew_components_3)
+  {
+    error = {1, "Pushed " DEW_ATTRIBUTE_XYZ " has to be i32 with 3 components"};
+    return dew_push_status_error;
+  }
+  dew_attributes_t tmp_attributes;
+  for (uint32_t i = 0; i < attribute_count; i++)
+    dew_attributes_add_attribute(&tmp_attributes, attributes[i].name, attributes[i].name_size, attributes[i].type, attributes[i].components);
+  auto attributes_id = _attributes_configs.get_attribute_config_index(std::move(tmp_attributes));
+  auto format = _attributes_configs.get_format_components(attributes_id);
+  uint64_t bytes_per_point = 0;
+  for (uint32_t i = 0; i < attribute_count; i++)
+  {
+    auto attribute_size = uint64_t(size_for_format(format[i].type, format[i].components));
+    if (uint64_t(buffers[i].size) < attribute_size * point_count || (point_count && !buffers[i].data))
+    {
+      error = {1, fmt::format("Buffer {} holds fewer than {} points", i, point_count)};
+      return dew_push_status_error;
+    }
+    bytes_per_point += attribute_size;
+  }
+  if (point_count == 0)
+    return dew_push_status_accepted;
+  _inputs_started.store(true, std::memory_order_release);
+
+  auto tree_config = _tree_handler.tree_config();
+  int32_t xyz_min[3] = {std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max()};
+  const auto *xyz = static_cast<const int32_t *>(buffers[0].data);
+  for (uint64_t i = 0; i < point_count; i++)
+  {
+    for (int c = 0; c < 3; c++)
+      xyz_min[c] = std::min(xyz_min[c], xyz[i * 3 + uint64_t(c)]);
+  }
+  double batch_min[3];
+  for (int c = 0; c < 3; c++)
+    batch_min[c] = std::min(header.min[c], double(xyz_min[c]) * header.scale[c] + header.offset[c]);
+  morton::morton192_t floor;
+  convert_pos_to_morton(tree_config.scale, tree_config.offset, batch_min, floor);
+  const int64_t batch_bytes = int64_t(point_count * bytes_per_point);
+
+  std::unique_lock<std::mutex> lock(_push_mutex);
+  auto fits = [&] {
+    const int64_t in_flight = _push_bytes_in_flight;
+    return in_flight == 0 || in_flight + batch_bytes + _read_sort_active_approximate_size <= _read_sort_budget;
+  };
+  if (!fits())
+  {
+    push_send_pending_locked(tree_config);
+    if (!block)
+      return dew_push_status_would_block;
+    _push_budget_condition.wait(lock, fits);
+  }
+
+  if (!_push.open)
+  {
+    _push.attributes = attributes_id;
+    _push.header = header;
+    if (!push_open_segment_locked(floor))
+    {
+      error = {1, "Pushed points lie below the part of the dataset that is already final"};
+      return dew_push_status_error;
+    }
+  }
+  else if (floor < _push.floor)
+  {
+    if (!_input_data_source_registry.lower_stream_floor(_push.segment, floor))
+    {
+      error = {1, "Pushed points lie below the part of the dataset that is already final"};
+      return dew_push_status_error;
+    }
+    _push.floor = floor;
+  }
+  _push.last_floor = floor;
+  _push_bytes_in_flight += batch_bytes;
+
+  uint64_t copied = 0;
+  while (copied < point_count)
+  {
+    if (_push.pending_count && (_push.attributes != attributes_id || memcmp(_push.header.offset, header.offset, sizeof(header.offset)) != 0 || memcmp(_push.header.scale, header.scale, sizeof(header.scale)) != 0))
+      push_send_pending_locked(tree_config);
+    if (!_push.pending_count)
+    {
+      _push.attributes = attributes_id;
+      _push.header = header;
+      _push.pending_format = format;
+      _push.pending_capacity = read_chunk_point_count(tree_config, format);
+      _push.pending = {};
+      attribute_buffers_initialize(format, _push.pending.buffers, _push.pending_capacity);
+    }
+    const uint32_t take = uint32_t(std::min<uint64_t>(_push.pending_capacity - _push.pending_count, point_count - copied));
+    for (uint32_t i = 0; i < attribute_count; i++)
+    {
+      const size_t attribute_size = size_for_format(format[i].type, format[i].components);
+      memcpy(_push.pending.buffers.data[i].get() + size_t(_push.pending_count) * attribute_size, static_cast<const uint8_t *>(buffers[i].data) + size_t(copied) * attribute_size, size_t(take) * attribute_size);
+    }
+    _push.pending_count += take;
+    _push.pending_bytes += uint64_t(take) * bytes_per_point;
+    copied += take;
+    if (_push.pending_count == _push.pending_capacity)
+      push_send_pending_locked(tree_config);
+  }
+
+  _push.segment_points += point_count;
+  if (_push.segment_points >= _push_segment_points)
+    push_close_segment_locked(tree_config, true);
+  return dew_push_status_accepted;
+}
+
+void processor_t::push_flush()
+{
+  std::unique_lock<std::mutex> lock(_push_mutex);
+  if (_push.open)
+    push_close_segment_locked(_tree_handler.tree_config(), true);
+}
+
+void processor_t::push_end()
+{
+  std::unique_lock<std::mutex> lock(_push_mutex);
+  if (_push.open)
+    push_close_segment_locked(_tree_handler.tree_config(), false);
+}
+
+void processor_t::set_push_segment_points(uint64_t points)
+{
+  std::unique_lock<std::mutex> lock(_push_mutex);
+  _push_segment_points = std::max<uint64_t>(points, 1);
+}
+
+bool processor_t::push_open_segment_locked(const morton::morton192_t &floor)
+{
+  input_data_reference_t ref;
+  if (!_input_data_source_registry.register_stream_segment(floor, ref))
+    return false;
+  if (!_push.open)
+    _perf_stats.conversion_start = perf_stats_t::clock_t::now();
+  _push.open = true;
+  _push.segment = ref.input_id;
+  _push.next_sub = 0;
+  _push.segment_points = 0;
+  _push.floor = floor;
+  _input_init.post_event(std::make_tuple(ref.input_id, _push.attributes, _push.header));
+  std::unique_lock<std::mutex> idle_lock(_idle_mutex);
+  _idle = false;
+  return true;
+}
+
+void processor_t::push_send_pending_locked(const tree_config_t &tree_config)
+{
+  if (!_push.pending_count)
+    return;
+  points_t points = std::move(_push.pending);
+  storage_header_initialize(points.header);
+  points.header.input_id = _push.segment;
+  points.header.input_id.sub = _push.next_sub++;
+  assert(points.header.input_id.sub < (1u << 30) && "push sub ids must stay clear of the collapsed-leaf id bits");
+  points.header.point_count = _push.pending_count;
+  points.attributes_id = _push.attributes;
+  attribute_buffers_adjust_buffers_to_size(_push.pending_format, points.buffers, _push.pending_count);
+  _push_chunk_bytes[(uint64_t(points.header.input_id.data) << 32) | points.header.input_id.sub] = _push.pending_bytes;
+  _perf_stats.source_read.record(_push.pending_bytes, 0);
+
+  auto sub = points.header.input_id;
+  _sub_added.post_event(std::move(sub));
+  auto public_header = _push.header;
+  public_header.point_count = _push.pending_count;
+  _point_reader.add_pushed_points(tree_config, public_header, std::move(points));
+  _push.pending = {};
+  _push.pending_count = 0;
+  _push.pending_bytes = 0;
+}
+
+void processor_t::push_close_segment_locked(const tree_config_t &tree_config, bool reopen)
+{
+  push_send_pending_locked(tree_config);
+  _point_reader.close_pushed_input(_push.segment);
+  _push.open = false;
+  // The next segment starts at the last batch's floor. That is at or above this segment's floor, which
+  // clamped every watermark reported while it was open, so the registration cannot be refused -- and a
+  // feed that raises its floor as it moves on lets the watermark follow it.
+  if (reopen)
+  {
+    bool opened = push_open_segment_locked(_push.last_floor);
+    assert(opened);
+    (void)opened;
+  }
+}
+
+void processor_t::push_release_chunk(input_data_id_t input_id)
+{
+  std::unique_lock<std::mutex> lock(_push_mutex);
+  auto it = _push_chunk_bytes.find((uint64_t(input_id.data) << 32) | input_id.sub);
+  if (it == _push_chunk_bytes.end())
+    return;
+  _push_bytes_in_flight -= int64_t(it->second);
+  _push_chunk_bytes.erase(it);
+  _push_budget_condition.notify_all();
+}
+
 void processor_t::walk_tree(frustum_tree_walker_t &walker)
 {
   if (!_attribute_index_map || _cached_attribute_names != walker.m_attribute_names)
@@ -334,8 +582,12 @@ upload_stats_t processor_t::upload_stats() const
 
 void processor_t::about_to_block()
 {
-  while (_read_sort_budget - _read_sort_active_approximate_size > 0)
+  if (_autotune_enabled.load(std::memory_order_relaxed))
+    maybe_autotune();
+  while (_read_sort_budget - _read_sort_active_approximate_size - _push_bytes_in_flight > 0)
   {
+    if (_autotuner && _reading_inputs.size() >= _autotuner->settings().max_readers)
+      break;
     auto next_input = _input_data_source_registry.next_input_to_process();
     if (!next_input)
       break;
@@ -344,10 +596,16 @@ void processor_t::about_to_block()
     file.callbacks = _convert_callbacks;
     file.id = next_input->id;
     file.filename = next_input->name;
-    _point_reader.add_file(_tree_handler.tree_config(), std::move(file));
+    auto tree_config = _tree_handler.tree_config();
+    // The tuned chunk size only travels with the reader's copy; the persisted config keeps the configured one.
+    if (_autotuner)
+      tree_config.read_chunk_byte_target = _autotuner->settings().read_chunk_bytes;
+    _reading_inputs.insert(file.id.data);
+    _point_reader.add_file(tree_config, std::move(file));
   }
+  advance_input_edit();
   std::unique_lock<std::mutex> lock(_idle_mutex);
-  if (_input_data_source_registry.all_inserted_into_tree() && _new_file_events_sent == 0 && !_generating_lod)
+  if (_input_data_source_registry.all_inserted_into_tree() && _new_file_events_sent == 0 && !_generating_lod && _input_edits.empty())
   {
     _idle = true;
     _idle_condition.notify_all();
@@ -369,8 +627,6 @@ void processor_t::handle_new_files(std::vector<std::pair<std::unique_ptr<char[]>
     _new_file_events_sent--;
     return;
   }
-  // Peek, do not seal: the first batch's pre-init results may still adopt the source scale.
-  auto tree_config_val = _tree_handler.tree_config_peek();
   std::vector<std::pair<input_data_id_t, input_name_ref_t>> file_refs;
   file_refs.reserve(new_files.size());
   for (auto &new_file : new_files)
@@ -385,7 +641,13 @@ void processor_t::handle_new_files(std::vector<std::pair<std::unique_ptr<char[]>
     std::unique_lock<std::mutex> lock(_idle_mutex);
     _new_file_events_sent--;
   }
+  start_input_reads(std::move(file_refs));
+}
 
+void processor_t::start_input_reads(std::vector<std::pair<input_data_id_t, input_name_ref_t>> &&file_refs)
+{
+  // Peek, do not seal: the first batch's pre-init results may still adopt the source scale.
+  auto tree_config_val = _tree_handler.tree_config_peek();
   // Launch pre-init processing as a detached coroutine using schedule_work
   [](processor_t *self, std::vector<std::pair<input_data_id_t, input_name_ref_t>> refs, tree_config_t tc) -> vio::detached_task_t
   {
@@ -503,6 +765,15 @@ void processor_t::handle_sub_added(input_data_id_t &&event)
 void processor_t::handle_sorted_points(std::pair<points_t, dew_error_t> &&event)
 {
   _input_data_source_registry.handle_sorted_points(event.first.header.input_id, event.first.header.morton_min, event.first.header.morton_max);
+  if (_input_data_source_registry.is_subtract_input(event.first.header.input_id))
+  {
+    // A removed input read again: its points leave the tree instead of being stored.
+    _tree_handler.subtract_points.post_event(std::move(event.first));
+    return;
+  }
+  push_release_chunk(event.first.header.input_id);
+  if (event.first.duplicates_removed)
+    _storage_handler.note_duplicates_removed(event.first.duplicates_removed);
   _storage_handler.write(
     event.first.header, event.first.attributes_id, std::move(event.first.buffers),
     [this](const storage_header_t &header, attributes_id_t attributes, std::vector<storage_location_t> locations, const dew_error_t &) { this->handle_points_written(header, attributes, std::move(locations)); });
@@ -520,7 +791,14 @@ void processor_t::handle_file_reading_done(input_data_id_t &&file)
   if (std::getenv("DEW_DEBUG_CHAIN"))
     fmt::print(stderr, "[sched] reading_done file={}\n", file.data);
   _read_sort_active_approximate_size -= _input_data_source_registry.get_approximate_size(file);
+  {
+    // Taken so the drop cannot slip between a blocked push's check and its wait.
+    std::unique_lock<std::mutex> lock(_push_mutex);
+  }
+  _push_budget_condition.notify_all();
+  _reading_inputs.erase(file.data);
   _input_data_source_registry.handle_reading_done(file);
+  maybe_checkpoint_stream_segment(file);
 }
 
 void processor_t::handle_index_write_done()
@@ -533,11 +811,23 @@ void processor_t::handle_index_write_done()
   // PREVIOUS watermark, so it must not conclude the in-flight pass (that would advance
   // _lod_done_morton past unserialized state and stall/duplicate LOD scheduling).
   const bool was_generating = _generating_lod;
-  if (was_generating && _tree_handler.last_committed_watermark() < _current_lod_target_morton)
+  // An input edit's rebuild pass keeps the watermark, so only the tree handler can tell its checkpoint.
+  const bool edit_pass = was_generating && !_input_edits.empty() && _input_edits.front().phase == input_edit_phase_t::regenerating;
+  if (edit_pass)
+  {
+    if (!_tree_handler.take_edit_pass_committed())
+      return;
+  }
+  else if (was_generating && _tree_handler.last_committed_watermark() < _current_lod_target_morton)
+  {
     return;
+  }
   _lod_done_morton = _current_lod_target_morton;
   _generating_lod = false;
+  if (edit_pass)
+    _input_edits.pop_front();
   _perf_stats.conversion_end = perf_stats_t::clock_t::now();
+  advance_input_edit();
   maybe_start_lod();
   if (!_generating_lod && was_generating)
   {
@@ -570,6 +860,18 @@ void processor_t::handle_tree_done_with_input(input_data_id_t &&event)
     fmt::print(stderr, "[sched] tree_done file={}\n", event.data);
   _input_data_source_registry.handle_tree_done_with_input(event);
   maybe_start_lod();
+  maybe_checkpoint_stream_segment(event);
+}
+
+void processor_t::maybe_checkpoint_stream_segment(input_data_id_t input_id)
+{
+  // A push segment that is complete either moved the watermark (and the LOD pass ends in a checkpoint) or
+  // is held back by the stream's floor; checkpoint the latter anyway so a live reader sees its points.
+  if (!_input_data_source_registry.stream_segment_complete(input_id))
+    return;
+  maybe_start_lod();
+  if (!_generating_lod)
+    _tree_handler.request_checkpoint();
 }
 
 void processor_t::maybe_start_lod()
@@ -581,6 +883,8 @@ void processor_t::maybe_start_lod()
   }
   if (_generating_lod)
     return;
+  if (!_input_edits.empty() && _input_edits.front().phase != input_edit_phase_t::queued)
+    return; // the edit runs its own pass; the watermark catches up after it
   auto done_morton = _input_data_source_registry.get_done_morton();
   if (done_morton && *done_morton > _lod_done_morton)
   {
@@ -590,6 +894,143 @@ void processor_t::maybe_start_lod()
   }
 }
 
+dew_error_t processor_t::edit_input(std::string name, std::string new_name)
+{
+  if (!_destination.url.empty())
+    return {1, "Inputs cannot be removed or replaced while converting to a destination: uploaded subtrees are immutable"};
+  auto extent = _input_data_source_registry.find_input(name.data(), uint32_t(name.size()));
+  if (!extent)
+    return {1, fmt::format("{} is not an input of this dataset", name)};
+  if (extent->stream)
+    return {1, "Pushed stream segments cannot be removed or replaced"};
+  if (!extent->complete)
+    return {1, fmt::format("{} is still being converted", name)};
+  if (!new_name.empty() && new_name != name && _input_data_source_registry.find_input(new_name.data(), uint32_t(new_name.size())))
+    return {1, fmt::format("{} is already an input of this dataset", new_name)};
+
+  input_edit_t edit;
+  edit.name = std::move(name);
+  edit.new_name = std::move(new_name);
+  edit.input_id = extent->input_id;
+  edit.min = extent->morton_min;
+  edit.max = extent->morton_max;
+  {
+    std::unique_lock<std::mutex> lock(_idle_mutex);
+    _idle = false;
+    _new_file_events_sent++;
+  }
+  _tree_live.store(true, std::memory_order_release);
+  _input_edit_requests.post_event(std::move(edit));
+  return {};
+}
+
+void processor_t::handle_input_edit_request(input_edit_t &&edit)
+{
+  _input_edits.push_back(std::move(edit));
+  {
+    std::unique_lock<std::mutex> lock(_idle_mutex);
+    _new_file_events_sent--;
+  }
+  advance_input_edit();
+}
+
+void processor_t::advance_input_edit()
+{
+  while (!_input_edits.empty())
+  {
+    auto &edit = _input_edits.front();
+    switch (edit.phase)
+    {
+    case input_edit_phase_t::queued:
+    {
+      if (_generating_lod || _shutting_down.load(std::memory_order_acquire))
+        return; // the pass in flight samples the leaves; handle_index_write_done comes back here
+      // An earlier queued edit of the same name may have removed or replaced the input meanwhile.
+      auto extent = _input_data_source_registry.find_input(edit.name.data(), uint32_t(edit.name.size()));
+      if (!extent || !(extent->input_id == edit.input_id))
+      {
+        dew_error_t error = {1, fmt::format("{} was already removed or replaced by an earlier edit", edit.name)};
+        if (_runtime_callbacks.error)
+          _runtime_callbacks.error(_runtime_callback_user_ptr, &error);
+        _input_edits.pop_front();
+        continue;
+      }
+      edit.phase = input_edit_phase_t::stripping;
+      _tree_handler.strip_input(edit.input_id, edit.min, edit.max, [this](bool needs_subtraction) { _input_edit_step.post_event(std::move(needs_subtraction)); });
+      return;
+    }
+    case input_edit_phase_t::subtract_reading:
+      if (!_input_data_source_registry.input_complete(edit.subtract_id))
+        return;
+      edit.phase = input_edit_phase_t::subtracting;
+      _tree_handler.subtract_stripped_points([this]() { _input_edit_step.post_event(false); });
+      return;
+    case input_edit_phase_t::replacing:
+    {
+      if (edit.has_replacement && !_input_data_source_registry.input_complete(edit.replacement_id))
+        return;
+      _tree_handler.set_reopen_input(~uint32_t(0));
+      lod_dirty_ranges_t ranges;
+      if (!(edit.max < edit.min))
+        ranges.emplace_back(edit.min, edit.max);
+      if (edit.has_replacement)
+      {
+        auto extent = _input_data_source_registry.extent(edit.replacement_id);
+        if (!(extent.morton_max < extent.morton_min))
+          ranges.emplace_back(extent.morton_min, extent.morton_max);
+      }
+      edit.phase = input_edit_phase_t::regenerating;
+      _generating_lod = true;
+      _current_lod_target_morton = _lod_done_morton;
+      _tree_handler.regenerate_lod(std::move(ranges));
+      return;
+    }
+    default:
+      return; // waiting on the tree loop
+    }
+  }
+}
+
+void processor_t::handle_input_edit_step(bool &&needs_subtraction)
+{
+  assert(!_input_edits.empty());
+  auto &edit = _input_edits.front();
+  if (edit.phase == input_edit_phase_t::stripping && needs_subtraction)
+  {
+    auto ref = _input_data_source_registry.register_subtract_file(edit.input_id);
+    edit.subtract_id = ref.input_id;
+    edit.has_subtract = true;
+    edit.phase = input_edit_phase_t::subtract_reading;
+    start_input_reads({{ref.input_id, ref.name}});
+    return;
+  }
+  // The old input's points are out of the tree: forget it, so a file of the same name can come back.
+  _input_data_source_registry.forget_input(edit.input_id);
+  if (edit.has_subtract)
+    _input_data_source_registry.forget_input(edit.subtract_id);
+  edit.phase = input_edit_phase_t::replacing;
+  if (!edit.new_name.empty() && _input_data_source_registry.find_input(edit.new_name.data(), uint32_t(edit.new_name.size())))
+  {
+    // Added by dew_converter_add_data_file while the edit ran: it converts as that input already.
+    dew_error_t error = {1, fmt::format("{} was added as an input meanwhile; {} was only removed", edit.new_name, edit.name)};
+    if (_runtime_callbacks.error)
+      _runtime_callbacks.error(_runtime_callback_user_ptr, &error);
+  }
+  else if (!edit.new_name.empty())
+  {
+    auto name_length = uint32_t(edit.new_name.size());
+    std::unique_ptr<char[]> name(new char[name_length + 1]);
+    memcpy(name.get(), edit.new_name.data(), name_length);
+    name[name_length] = 0;
+    auto ref = _input_data_source_registry.register_file(std::move(name), name_length, nullptr);
+    edit.replacement_id = ref.input_id;
+    edit.has_replacement = true;
+    _tree_handler.set_reopen_input(ref.input_id.data);
+    start_input_reads({{ref.input_id, ref.name}});
+  }
+  advance_input_edit();
+}
+
 dew_error_t processor_t::upgrade_to_write(bool truncate)
 {
   auto ret = _storage_handler.upgrade_to_write(truncate);
@@ -628,6 +1069,90 @@ void processor_t::set_pre_init_read_chunk_bytes(uint64_t bytes)
   _tree_handler.set_tree_initialization_read_chunk_bytes(bytes);
 }
 
+void processor_t::set_hierarchy_directory_depth(uint32_t depth)
+{
+  _tree_handler.set_hierarchy_directory_depth(depth);
+}
+
+bool processor_t::set_autotune(bool enabled)
+{
+  if (_inputs_started.load(std::memory_order_acquire))
+    return false;
+  _autotune_enabled.store(enabled, std::memory_order_relaxed);
+  _perf_stats.autotuned.store(enabled, std::memory_order_relaxed);
+  return true;
+}
+
+void processor_t::maybe_autotune()
+{
+  auto now = perf_stats_t::clock_t::now();
+  if (_autotuner && now - _autotune_last_sample < std::chrono::seconds(2))
+    return;
+
+  autotune_sample_t sample;
+  sample.seconds = _autotuner ? std::chrono::duration<double>(now - _autotune_last_sample).count() : 0;
+  sample.read_bytes = _perf_stats.source_read.total_bytes.load(std::memory_order_relaxed);
+  sample.sort_bytes = _perf_stats.sort.total_bytes.load(std::memory_order_relaxed);
+  sample.sort_time_us = _perf_stats.sort.total_time_us.load(std::memory_order_relaxed);
+  sample.sort_operations = _perf_stats.sort.operation_count.load(std::memory_order_relaxed);
+  sample.write_bytes = _perf_stats.source_write.total_bytes.load(std::memory_order_relaxed) + _perf_stats.lod_write.total_bytes.load(std::memory_order_relaxed);
+  sample.readers_active = uint32_t(_reading_inputs.size());
+  sample.inputs_waiting = _input_data_source_registry.inputs_waiting();
+  sample.sorts_queued = _point_reader.sorts_queued();
+  sample.sorts_running = _point_reader.sorts_running();
+  sample.writes_queued = _storage_handler.writes_queued();
+  sample.writes_running = _storage_handler.writes_running();
+  sample.memory_bytes = point_buffer_pool().stats().outstanding_bytes;
+  _autotune_last_sample = now;
+
+  std::string decision;
+  if (!_autotuner)
+  {
+    // The read chunk size is only final once the inputs start, so the tuner starts from it here; the
+    // first sample is its baseline.
+    _autotuner = std::make_unique<autotuner_t>(std::thread::hardware_concurrency(), uint64_t(_read_sort_budget), _tree_handler.tree_config_peek().read_chunk_byte_target);
+    _autotuner->update(sample, decision);
+  }
+  else if (_autotuner->update(sample, decision))
+  {
+    fmt::print(stderr, "[autotune] {}\n", decision);
+  }
+  else
+  {
+    return;
+  }
+  auto &settings = _autotuner->settings();
+  _point_reader.set_sort_concurrency_limit(settings.max_sorters);
+  _storage_handler.set_write_concurrency_limit(settings.max_compressors);
+  _perf_stats.autotune_read_chunk_bytes.store(settings.read_chunk_bytes, std::memory_order_relaxed);
+  _perf_stats.autotune_max_readers.store(settings.max_readers, std::memory_order_relaxed);
+  _perf_stats.autotune_max_sorters.store(settings.max_sorters, std::memory_order_relaxed);
+  _perf_stats.autotune_max_compressors.store(settings.max_compressors, std::memory_order_relaxed);
+  _perf_stats.autotune_decisions.store(_autotuner->decisions(), std::memory_order_relaxed);
+}
+
+bool processor_t::set_numa_pools(bool enabled)
+{
+  if (!enabled || _worker_pools.numa_enabled())
+    return _worker_pools.numa_enabled();
+  // The components read their pools pointer unsynchronized on their own loops; that is only safe
+  // while nothing has been routed yet -- no input, and no tree work of a reopened dataset or an edit.
+  if (_inputs_started.load(std::memory_order_acquire) || _tree_live.load(std::memory_order_acquire))
+    return false;
+  auto nodes = detect_numa_topology();
+  if (!_worker_pools.enable_numa(nodes))
+    return false;
+  if (std::getenv("DEW_DEBUG_CHAIN"))
+  {
+    for (auto &node : nodes)
+      fmt::print(stderr, "[numa] node {}: {} workers\n", node.id, node.cpus.size());
+  }
+  _point_reader.set_worker_pools(&_worker_pools);
+  _storage_handler.set_worker_pools(&_worker_pools);
+  _tree_handler.set_worker_pools(&_worker_pools);
+  return true;
+}
+
 void processor_t::set_runtime_callbacks(const dew_converter_runtime_callbacks_t &runtime_callbacks, void *user_ptr)
 {
   _runtime_callbacks = runtime_callbacks;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -35,6 +36,7 @@
 #include <vio/thread_pool.h>
 
 #include "attributes_configs.hpp"
+#include "autotuner.hpp"
 #include "dataset_types.hpp"
 #include "frustum_tree_walker.hpp"
 #include "input_data_source_registry.hpp"
@@ -43,6 +45,7 @@
 #include "reader.hpp"
 #include "storage_handler.hpp"
 #include "tree_handler.hpp"
+#include "worker_pools.hpp"
 
 namespace dew::converter
 {
@@ -85,9 +88,30 @@ public:
   }
   void set_pre_init_node_point_limit(uint32_t node_point_limit);
   void set_pre_init_read_chunk_bytes(uint64_t bytes);
+  void set_hierarchy_directory_depth(uint32_t depth);
+  // Per-NUMA-node worker pools (worker_pools.hpp). Before the first input, on a new dataset; returns
+  // false (single pool kept) when the machine has fewer than two nodes or the option comes too late --
+  // a reopened dataset's tree loop is live from the open on.
+  bool set_numa_pools(bool enabled);
+  // Opt-in runtime tuning of chunk size and stage concurrency (autotuner.hpp). Before the first input;
+  // returns false when the option comes too late.
+  bool set_autotune(bool enabled);
+  std::vector<numa_node_stats_t> numa_stats() const
+  {
+    return _worker_pools.node_stats();
+  }
   void set_runtime_callbacks(const dew_converter_runtime_callbacks_t &runtime_callbacks, void *user_ptr);
   void set_converter_callbacks(const dew_converter_file_convert_callbacks_t &convert_callbacks);
   void add_files(std::vector<std::pair<std::unique_ptr<char[]>, uint32_t>> &&input_files);
+  // Push ingest (dew_converter_push_points and friends). Thread-safe. See push_points in processor.cpp.
+  dew_converter_push_status_t push_points(const dew_converter_header_t &header, const dew_attribute_t *attributes, uint32_t attribute_count, const dew_blob_t *buffers, uint64_t point_count, bool block,
+                                          dew_error_t &error);
+  void push_flush();
+  void push_end();
+  void set_push_segment_points(uint64_t points);
+  // Input edits (dew_converter_remove_input / dew_converter_replace_input). Thread-safe: validates, then
+  // queues the edit; the processor loop runs edits one at a time. An empty new_name removes the input.
+  [[nodiscard]] dew_error_t edit_input(std::string name, std::string new_name);
   void walk_tree(frustum_tree_walker_t &walker);
   tree_config_t tree_config();
   void request_aabb(std::function<void(double[3], double[3])> callback);
@@ -137,6 +161,7 @@ public:
 private:
   std::string _url;
   vio::thread_pool_t _thread_pool;
+  worker_pools_t _worker_pools;
   dew_converter_runtime_callbacks_t _runtime_callbacks;
   void *_runtime_callback_user_ptr;
   dew_converter_file_convert_callbacks_t _convert_callbacks;
@@ -149,6 +174,11 @@ private:
   // Set on _event_loop during teardown, before the shared pool is joined: the pre-init coroutine
   // launched from handle_new_files schedules work onto that pool, and enqueue-after-stop aborts.
   std::atomic_bool _shutting_down = false;
+  // First input added or pushed; worker-pool routing is fixed from here on.
+  std::atomic_bool _inputs_started = false;
+  // The tree loop may be running LOD or collapse without any input: a reopened index is being loaded,
+  // or an input edit was asked for. Worker-pool routing is fixed from here on as well.
+  std::atomic_bool _tree_live = false;
   morton::morton192_t _lod_done_morton = {};
   morton::morton192_t _current_lod_target_morton = {};
 
@@ -180,6 +210,10 @@ public:
   {
     _storage_handler.set_cache_max_bytes(cap_bytes);
   }
+  void set_attribute_precision(const std::string &name, const attribute_precision_t &precision)
+  {
+    _attributes_configs.set_attribute_precision(name, precision);
+  }
 
 private:
 
@@ -200,8 +234,85 @@ private:
   vio::event_loop_t &_input_event_loop;
   point_reader_t _point_reader;
 
+  // Bytes the input files being read and sorted are expected to hold. Pushed batches count against the same
+  // budget, so the push path reads the file side from other threads.
   int64_t _read_sort_budget;
-  int64_t _read_sort_active_approximate_size;
+  std::atomic<int64_t> _read_sort_active_approximate_size;
+  // Files about_to_block started that are not done reading; the autotuner caps their number.
+  ankerl::unordered_dense::set<uint32_t> _reading_inputs;
+
+  // Set before the first input; the tuner itself is made on the processor loop at its first sample.
+  std::atomic_bool _autotune_enabled = false;
+  std::unique_ptr<autotuner_t> _autotuner;
+  perf_stats_t::time_point_t _autotune_last_sample;
+  void maybe_autotune();
+
+  // The live push stream. It is cut into segments of about _push_segment_points points, each its own input
+  // in the registry, so LOD passes and checkpoints can catch up with it while it runs.
+  struct push_stream_t
+  {
+    bool open = false;
+    input_data_id_t segment = {};
+    uint32_t next_sub = 0;
+    uint64_t segment_points = 0;
+    morton::morton192_t floor = {};      // of the open segment: the lowest header.min pushed into it
+    morton::morton192_t last_floor = {}; // header.min of the last batch: where the next segment starts
+    // The chunk being filled: small batches coalesce up to the read chunk size before they are sorted.
+    points_t pending;
+    uint32_t pending_count = 0;
+    uint32_t pending_capacity = 0;
+    uint64_t pending_bytes = 0;
+    std::vector<point_format_t> pending_format;
+    attributes_id_t attributes = {}; // of the pending chunk, or the last one sent
+    dew_converter_header_t header = {};
+  };
+  std::mutex _push_mutex;
+  std::condition_variable _push_budget_condition;
+  push_stream_t _push;
+  uint64_t _push_segment_points = uint64_t(16) << 20;
+  std::atomic<int64_t> _push_bytes_in_flight = 0; // written under _push_mutex
+  ankerl::unordered_dense::map<uint64_t, uint64_t> _push_chunk_bytes; // (segment, sub) -> admitted bytes
+
+  [[nodiscard]] bool push_open_segment_locked(const morton::morton192_t &floor);
+  void push_send_pending_locked(const tree_config_t &tree_config);
+  void push_close_segment_locked(const tree_config_t &tree_config, bool reopen);
+  void push_release_chunk(input_data_id_t input_id);
+  void maybe_checkpoint_stream_segment(input_data_id_t input_id);
+
+  // Input edits. A removed input's reader chunks are dropped from the leaves; leaves whose chunks were
+  // already collapsed into per-leaf units get the input read again and its points subtracted by morton
+  // code. Then the replacement (if any) is read like any input, and one LOD pass rebuilds only the nodes
+  // over the old and new ranges. Edits wait for a pass in flight, and block new ones while they run.
+  enum class input_edit_phase_t
+  {
+    queued,
+    stripping,
+    subtract_reading,
+    subtracting,
+    replacing,
+    regenerating,
+  };
+  struct input_edit_t
+  {
+    std::string name;
+    std::string new_name; // empty: remove only
+    input_data_id_t input_id = {};
+    morton::morton192_t min = {};
+    morton::morton192_t max = {};
+    input_data_id_t subtract_id = {};
+    bool has_subtract = false;
+    input_data_id_t replacement_id = {};
+    bool has_replacement = false;
+    input_edit_phase_t phase = input_edit_phase_t::queued;
+  };
+  std::deque<input_edit_t> _input_edits; // processor loop only
+  vio::event_pipe_t<input_edit_t> _input_edit_requests;
+  vio::event_pipe_t<bool> _input_edit_step; // a tree-loop phase finished; for stripping: needs subtraction
+
+  void handle_input_edit_request(input_edit_t &&edit);
+  void handle_input_edit_step(bool &&needs_subtraction);
+  void advance_input_edit();
+  void start_input_reads(std::vector<std::pair<input_data_id_t, input_name_ref_t>> &&file_refs);
 
   std::unique_ptr<attribute_index_map_t> _attribute_index_map;
   std::vector<std::string> _cached_attribute_names;
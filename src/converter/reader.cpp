@@ -23,6 +23,7 @@
 #include "loop_quiesce.hpp"
 #include "morton.hpp"
 #include "sorter.hpp"
+#include "worker_pools.hpp"
 
 #include <fmt/printf.h>
 
@@ -68,6 +69,20 @@ struct callback_closer
   void *user_ptr;
 };
 
+uint32_t read_chunk_point_count(const tree_config_t &tree_config, const std::vector<point_format_t> &attribute_info)
+{
+  // Read/sort chunk size targets read_chunk_byte_target bytes (default 64 MiB): big chunks
+  // amortize source reads and the morton sort; the octree still subdivides them into
+  // node_point_limit leaves, and leaf collapse rewrites final leaves into per-node units. Never
+  // below node_point_limit (a chunk should fill at least one node), capped so per-chunk memory
+  // spikes stay bounded.
+  uint64_t bytes_per_point = 0;
+  for (auto &format : attribute_info)
+    bytes_per_point += uint64_t(size_for_format(format.type, format.components));
+  uint64_t target_points = tree_config.read_chunk_byte_target / (bytes_per_point ? bytes_per_point : 1);
+  return uint32_t(std::clamp<uint64_t>(target_points, tree_config.node_point_limit, k_default_max_chunk_points));
+}
+
 void get_data_worker_t::work()
 {
   storage_header_initialize(storage_header);
@@ -105,16 +120,7 @@ void get_data_worker_t::work()
   auto attribute_info = attribute_configs.get_format_components(attributes_id);
   input_init_pipe.post_event(std::make_tuple(storage_header.input_id, attributes_id, public_header));
 
-  // Read/sort chunk size targets read_chunk_byte_target bytes (default 64 MiB): big chunks
-  // amortize source reads and the morton sort; the octree still subdivides them into
-  // node_point_limit leaves, and leaf collapse rewrites final leaves into per-node units. Never
-  // below node_point_limit (a chunk should fill at least one node), capped so per-chunk memory
-  // spikes stay bounded.
-  uint64_t bytes_per_point = 0;
-  for (auto &format : attribute_info)
-    bytes_per_point += uint64_t(size_for_format(format.type, format.components));
-  uint64_t target_points = point_reader_file.tree_config.read_chunk_byte_target / (bytes_per_point ? bytes_per_point : 1);
-  uint32_t convert_size = uint32_t(std::clamp<uint64_t>(target_points, point_reader_file.tree_config.node_point_limit, k_default_max_chunk_points));
+  uint32_t convert_size = read_chunk_point_count(point_reader_file.tree_config, attribute_info);
   uint8_t done_read_file = false;
   uint32_t local_points_read;
   uint32_t sub_part = 0;
@@ -227,6 +233,7 @@ point_reader_t::point_reader_t(vio::event_loop_t &event_loop, vio::thread_pool_t
   , _file_errors(file_errors)
   , _new_files_pipe(event_loop, bind(&point_reader_t::handle_new_files))
   , _unsorted_points(event_loop, bind(&point_reader_t::handle_unsorted_points))
+  , _pushed_points(event_loop, bind(&point_reader_t::handle_pushed_points))
 {
   event_loop.add_about_to_block_listener(this);
 }
@@ -236,14 +243,36 @@ void point_reader_t::add_file(tree_config_t tree_config, get_points_file_t &&new
   _new_files_pipe.post_event(std::move(tree_config), std::move(new_file));
 }
 
+void point_reader_t::add_pushed_points(tree_config_t tree_config, const dew_converter_header_t &public_header, points_t &&points)
+{
+  pushed_points_event_t event;
+  event.tree_config = std::move(tree_config);
+  event.input_id = points.header.input_id;
+  event.input_id.sub = 0;
+  event.public_header = public_header;
+  event.points = std::move(points);
+  event.has_points = true;
+  _pushed_points.post_event(std::move(event));
+}
+
+void point_reader_t::close_pushed_input(input_data_id_t input_id)
+{
+  pushed_points_event_t event;
+  event.input_id = input_id;
+  event.input_id.sub = 0;
+  event.close = true;
+  _pushed_points.post_event(std::move(event));
+}
+
 void point_reader_t::about_to_block()
 {
-  auto finished = std::partition(_point_reader_files.begin(), _point_reader_files.end(), [](const std::unique_ptr<point_reader_file_t> &a) { return !a->input_reader->done() || a->input_split != a->sort_done; });
+  dispatch_sorts();
+  auto finished = std::partition(_point_reader_files.begin(), _point_reader_files.end(), [](const std::unique_ptr<point_reader_file_t> &a) { return !a->input_done() || a->input_split != a->sort_done; });
   for (auto it = finished; it != _point_reader_files.end(); ++it)
   {
     auto &input_reader = it->get()->input_reader;
-    assert(input_reader->done());
-    if (input_reader->error)
+    assert(it->get()->input_done());
+    if (input_reader && input_reader->error)
     {
       file_error_t file_error;
       file_error.error = std::move(*input_reader->error);
@@ -251,7 +280,7 @@ void point_reader_t::about_to_block()
       _file_errors.post_event(std::move(file_error));
     }
 
-    auto to_send = it->get()->input_reader->storage_header.input_id;
+    auto to_send = it->get()->input_id();
     _done_with_file.post_event(std::move(to_send));
   }
   _point_reader_files.erase(finished, _point_reader_files.end());
@@ -266,13 +295,55 @@ void point_reader_t::begin_shutdown()
     _shutting_down.store(true, std::memory_order_release);
 }
 
+void point_reader_t::set_sort_concurrency_limit(uint32_t limit)
+{
+  _sort_limit.store(limit, std::memory_order_relaxed);
+  _event_loop.run_in_loop([this] { dispatch_sorts(); });
+}
+
+void point_reader_t::queue_sort(point_reader_file_t &reader_file, std::unique_ptr<sort_worker_t> &&sort_worker)
+{
+  // The file owns its workers; the queue only orders them. A file with queued sorts is never finished
+  // (sort_done lags input_split), so the pointers stay valid until they are dispatched.
+  reader_file.sort_workers.emplace_back(std::move(sort_worker));
+  _pending_sorts.emplace_back(&reader_file, reader_file.sort_workers.back().get());
+  dispatch_sorts();
+}
+
+void point_reader_t::dispatch_sorts()
+{
+  if (_shutting_down.load(std::memory_order_acquire))
+    return;
+  uint32_t running = 0;
+  for (auto &reader_file : _point_reader_files)
+    running += reader_file->sorts_started - reader_file->sort_done;
+  uint32_t limit = _sort_limit.load(std::memory_order_relaxed);
+  while (!_pending_sorts.empty() && (limit == 0 || running < limit))
+  {
+    auto [reader_file, sort_worker] = _pending_sorts.front();
+    _pending_sorts.pop_front();
+    reader_file->sorts_started++;
+    running++;
+    sort_worker->enqueue(reader_file->event_loop, reader_file->thread_pool);
+  }
+  _sorts_queued.store(uint32_t(_pending_sorts.size()), std::memory_order_relaxed);
+  _sorts_running.store(running, std::memory_order_relaxed);
+}
+
+vio::thread_pool_t &point_reader_t::pool_for_input(input_data_id_t input_id)
+{
+  // The file reader keeps this pool for its sort workers too, so a chunk's buffers are filled and
+  // sorted by workers on one node.
+  return _worker_pools ? _worker_pools->pool_for_input(input_id) : _thread_pool;
+}
+
 void point_reader_t::handle_new_files(tree_config_t &&tree_config, get_points_file_t &&new_file)
 {
   // point_reader_file_t's constructor enqueues its get_data_worker onto the shared pool, so during
   // teardown it must not be built at all.
   if (_shutting_down.load(std::memory_order_acquire))
     return;
-  _point_reader_files.emplace_back(new point_reader_file_t(tree_config, _event_loop, _thread_pool, _attributes_configs, _perf_stats, new_file, _input_init_pipe, _sub_added, _unsorted_points, _sorted_points_pipe));
+  _point_reader_files.emplace_back(new point_reader_file_t(tree_config, _event_loop, pool_for_input(new_file.id), _attributes_configs, _perf_stats, new_file, _input_init_pipe, _sub_added, _unsorted_points, _sorted_points_pipe));
 }
 
 void point_reader_t::handle_unsorted_points(unsorted_points_event_t &&unsorted_points)
@@ -282,8 +353,29 @@ void point_reader_t::handle_unsorted_points(unsorted_points_event_t &&unsorted_p
     return;
   auto &tree_config = unsorted_points.reader_file.tree_config;
   auto &reader_file = unsorted_points.reader_file;
-  unsorted_points.reader_file.sort_workers.emplace_back(new sort_worker_t(tree_config, reader_file, _attributes_configs, _perf_stats, unsorted_points.public_header, std::move(unsorted_points.points)));
-  unsorted_points.reader_file.sort_workers.back()->enqueue(unsorted_points.reader_file.event_loop, unsorted_points.reader_file.thread_pool);
+  queue_sort(reader_file, std::make_unique<sort_worker_t>(tree_config, reader_file, _attributes_configs, _perf_stats, unsorted_points.public_header, std::move(unsorted_points.points)));
+}
+
+void point_reader_t::handle_pushed_points(pushed_points_event_t &&event)
+{
+  if (_shutting_down.load(std::memory_order_acquire))
+    return;
+  auto it = std::find_if(_point_reader_files.begin(), _point_reader_files.end(), [&event](const std::unique_ptr<point_reader_file_t> &a) { return !a->input_reader && a->pushed_input_id.data == event.input_id.data; });
+  if (it == _point_reader_files.end())
+  {
+    _point_reader_files.emplace_back(new point_reader_file_t(event.tree_config, _event_loop, pool_for_input(event.input_id), _perf_stats, event.input_id, _sorted_points_pipe));
+    it = std::prev(_point_reader_files.end());
+  }
+  auto &reader_file = **it;
+  if (event.has_points)
+  {
+    // A segment's own split count: it is only final once the segment is closed, which about_to_block
+    // checks before comparing it against sort_done.
+    reader_file.input_split++;
+    queue_sort(reader_file, std::make_unique<sort_worker_t>(reader_file.tree_config, reader_file, _attributes_configs, _perf_stats, event.public_header, std::move(event.points)));
+  }
+  if (event.close)
+    reader_file.push_closed = true;
 }
 
 } // namespace dew::converter
@@ -20,6 +20,7 @@
 #include <fmt/printf.h>
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_set>
@@ -42,6 +43,7 @@ namespace dew::converter
 {
 using namespace dew::core;
 class storage_handler_t;
+class worker_pools_t;
 struct get_points_file_t
 {
   input_data_id_t id;
@@ -110,6 +112,10 @@ public:
   bool _done{false};
 };
 
+// Points per read/sort chunk for an input with this layout: about tree_config.read_chunk_byte_target
+// bytes, clamped to [node_point_limit, k_default_max_chunk_points].
+uint32_t read_chunk_point_count(const tree_config_t &tree_config, const std::vector<point_format_t> &attribute_info);
+
 struct point_reader_file_t
 {
   point_reader_file_t(const tree_config_t &a_tree_config, vio::event_loop_t &a_event_loop, vio::thread_pool_t &a_thread_pool, attributes_configs_t &a_attributes_configs, perf_stats_t &a_perf_stats,
@@ -125,10 +131,26 @@ struct point_reader_file_t
   {
     input_reader->enqueue(a_event_loop, a_thread_pool);
   }
+  // A pushed stream segment (dew_converter_push_points): there is no reader worker, the chunks arrive
+  // through point_reader_t::add_pushed_points and the segment is done once it is closed and every chunk
+  // it received has been sorted.
+  point_reader_file_t(const tree_config_t &a_tree_config, vio::event_loop_t &a_event_loop, vio::thread_pool_t &a_thread_pool, perf_stats_t &a_perf_stats, input_data_id_t a_pushed_input_id,
+                      vio::event_pipe_t<std::pair<points_t, dew_error_t>> &a_sorted_points_pipe)
+    : tree_config(a_tree_config)
+    , event_loop(a_event_loop)
+    , thread_pool(a_thread_pool)
+    , perf_stats(a_perf_stats)
+    , sorted_points_pipe(a_sorted_points_pipe)
+    , pushed_input_id(a_pushed_input_id)
+  {
+  }
   ~point_reader_file_t()
   {
   }
 
+  [[nodiscard]] bool input_done() const { return input_reader ? input_reader->done() : push_closed; }
+  [[nodiscard]] input_data_id_t input_id() const { return input_reader ? input_reader->storage_header.input_id : pushed_input_id; }
+
   tree_config_t tree_config;
   vio::event_loop_t &event_loop;
   vio::thread_pool_t &thread_pool;
@@ -137,7 +159,20 @@ struct point_reader_file_t
   std::vector<std::unique_ptr<sort_worker_t>> sort_workers;
   vio::event_pipe_t<std::pair<points_t, dew_error_t>> &sorted_points_pipe;
   uint32_t input_split = 0;
+  uint32_t sorts_started = 0;
   uint32_t sort_done = 0;
+  input_data_id_t pushed_input_id = {};
+  bool push_closed = false;
+};
+
+struct pushed_points_event_t
+{
+  tree_config_t tree_config;
+  input_data_id_t input_id;
+  dew_converter_header_t public_header;
+  points_t points;
+  bool has_points = false;
+  bool close = false;
 };
 
 class memory_requester_t
@@ -179,20 +214,48 @@ public:
                  vio::event_pipe_t<std::tuple<input_data_id_t, attributes_id_t, dew_converter_header_t>> &input_init_pipe, vio::event_pipe_t<input_data_id_t> &sub_added,
                  vio::event_pipe_t<std::pair<points_t, dew_error_t>> &sorted_points_pipe, vio::event_pipe_t<input_data_id_t> &done_with_file, vio::event_pipe_t<file_error_t> &file_errors);
   void add_file(tree_config_t tree_config, get_points_file_t &&new_file);
+  // Push ingest: hand one already converted chunk of a stream segment (points.header.input_id) to the
+  // sort workers, and close the segment once no more chunks will follow. Thread-safe; the chunks and the
+  // close of one segment must be posted from one thread (or under one lock) to keep their order.
+  void add_pushed_points(tree_config_t tree_config, const dew_converter_header_t &public_header, points_t &&points);
+  void close_pushed_input(input_data_id_t input_id);
+  // Read and sort each input on its NUMA node's pool (worker_pools.hpp). Before the first add_file;
+  // null (the default) keeps everything on the shared pool.
+  void set_worker_pools(worker_pools_t *worker_pools)
+  {
+    _worker_pools = worker_pools;
+  }
 
   // Teardown barrier: after this returns, this reader will never enqueue onto the shared thread pool
   // again, so the pool may be joined. Mirrors tree_handler_t::begin_shutdown -- both loops outlive the
   // pool join in processor_t's ordered teardown, and enqueue-after-stop is a bare abort().
   void begin_shutdown();
 
+  // Sort workers running at once across all inputs (0 = no limit, the default); chunks over the limit wait
+  // in arrival order. Thread-safe; a raised limit takes effect on the reader loop's next pass.
+  void set_sort_concurrency_limit(uint32_t limit);
+  uint32_t sorts_queued() const
+  {
+    return _sorts_queued.load(std::memory_order_relaxed);
+  }
+  uint32_t sorts_running() const
+  {
+    return _sorts_running.load(std::memory_order_relaxed);
+  }
+
   void about_to_block() override;
 
 private:
   void handle_new_files(tree_config_t &&tree_config, get_points_file_t &&new_file);
   void handle_unsorted_points(unsorted_points_event_t &&unsorted_points);
+  void handle_pushed_points(pushed_points_event_t &&event);
+  vio::thread_pool_t &pool_for_input(input_data_id_t input_id);
+  void queue_sort(point_reader_file_t &reader_file, std::unique_ptr<sort_worker_t> &&sort_worker);
+  void dispatch_sorts();
 
   vio::event_loop_t &_event_loop;
   vio::thread_pool_t &_thread_pool;
+  worker_pools_t *_worker_pools = nullptr;
   attributes_configs_t &_attributes_configs;
   perf_stats_t &_perf_stats;
   vio::event_pipe_t<std::tuple<input_data_id_t, attributes_id_t, dew_converter_header_t>> &_input_init_pipe;
@@ -202,7 +265,12 @@ private:
   vio::event_pipe_t<file_error_t> &_file_errors;
   vio::event_pipe_t<tree_config_t, get_points_file_t> _new_files_pipe;
   vio::event_pipe_t<unsorted_points_event_t> _unsorted_points;
+  vio::event_pipe_t<pushed_points_event_t> _pushed_points;
   std::vector<std::unique_ptr<point_reader_file_t>> _point_reader_files;
+  std::deque<std::pair<point_reader_file_t *, sort_worker_t *>> _pending_sorts;
+  std::atomic<uint32_t> _sort_limit = 0;
+  std::atomic<uint32_t> _sorts_queued = 0;
+  std::atomic<uint32_t> _sorts_running = 0;
   std::atomic_bool _shutting_down = false;
 };
 } // namespace dew::converter
@@ -0,0 +1,255 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "remote_input.hpp"
+
+#include "loop_blocking.hpp"
+#include "url.hpp"
+
+#include <vio/objstore/create_object_store.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace dew::converter
+{
+using namespace dew::core;
+
+static std::mutex g_options_mutex;
+static remote_input_options_t g_options;
+
+static dew_error_t from_vio(const vio::error_t &e)
+{
+  return {e.code != 0 ? e.code : -1, e.msg};
+}
+
+bool is_remote_input(std::string_view name)
+{
+  auto sep = name.find("://");
+  if (sep == std::string_view::npos || sep == 0)
+    return false;
+  auto scheme = parse_url(std::string(name.substr(0, sep + 3))).scheme;
+  return scheme != "file";
+}
+
+void set_remote_input_options(remote_input_options_t options)
+{
+  options.window_bytes = std::max<uint64_t>(options.window_bytes, 64 * 1024);
+  std::unique_lock<std::mutex> lock(g_options_mutex);
+  g_options = std::move(options);
+}
+
+remote_input_options_t remote_input_options()
+{
+  std::unique_lock<std::mutex> lock(g_options_mutex);
+  return g_options;
+}
+
+remote_input_t::remote_input_t(const remote_input_options_t &options)
+  : _loop_thread()
+  , _loop(_loop_thread.event_loop())
+  , _window_bytes(std::max<uint64_t>(options.window_bytes, 1))
+  , _read_ahead(options.read_ahead)
+  , _fetch_state(std::make_shared<fetch_state_t>())
+  , _stream(this)
+{
+}
+
+remote_input_t::~remote_input_t()
+{
+  // Dropped windows may still be filling; their GETs run on _io, which must outlive them.
+  {
+    std::unique_lock<std::mutex> lock(_fetch_state->mutex);
+    _fetch_state->condition.wait(lock, [this] { return _fetch_state->in_flight == 0; });
+  }
+  _loop_thread.stop_and_join();
+}
+
+std::unique_ptr<remote_input_t> remote_input_t::open(const std::string &url, const remote_input_options_t &options, dew_error_t &error)
+{
+  // "s3://bucket/dir/tile.laz" -> store "s3://bucket/dir", object "tile.laz".
+  auto parsed = parse_url(url);
+  auto slash = parsed.path.rfind('/');
+  if (parsed.scheme.empty() || slash == std::string::npos || slash == 0 || slash + 1 == parsed.path.size())
+  {
+    error = {1, fmt::format("Remote input '{}' does not name an object", url)};
+    return nullptr;
+  }
+  std::unique_ptr<remote_input_t> input(new remote_input_t(options));
+  auto io = vio::objstore::create_io_manager(parsed.scheme + "://" + parsed.path.substr(0, slash), std::string_view(options.connection), input->_loop);
+  if (!io.has_value())
+  {
+    error = from_vio(io.error());
+    return nullptr;
+  }
+  input->_io = std::move(io.value());
+  input->_object = parsed.path.substr(slash + 1);
+  auto *raw = input.get();
+  error = run_on_loop_blocking(input->_loop, [raw]() { return raw->probe_size(); });
+  if (error.code != 0)
+  {
+    error.msg = fmt::format("Remote input '{}': {}", url, error.msg);
+    return nullptr;
+  }
+  return input;
+}
+
+vio::task_t<dew_error_t> remote_input_t::probe_size()
+{
+  auto info = co_await _io->object_info(_object);
+  if (!info.has_value())
+    co_return from_vio(info.error());
+  if (!info->exists)
+    co_return dew_error_t{1, "no such object"};
+  _size = info->size;
+  co_return dew_error_t{};
+}
+
+vio::task_t<dew_error_t> remote_input_t::do_read_range(uint64_t offset, uint8_t *dst, uint64_t size)
+{
+  vio::objstore::io_range_t range;
+  range.offset = int64_t(offset);
+  range.size = int64_t(size);
+  auto r = co_await _io->read_object(_object, dst, range);
+  if (!r.has_value())
+    co_return from_vio(r.error());
+  if (uint64_t(r.value()) != size)
+    co_return dew_error_t{1, "Short read from remote input"};
+  co_return dew_error_t{};
+}
+
+dew_error_t remote_input_t::read_range(uint64_t offset, uint8_t *dst, uint64_t size)
+{
+  if (offset + size > _size)
+    return {1, "Read past the end of the remote input"};
+  return run_on_loop_blocking(_loop, [this, offset, dst, size]() { return do_read_range(offset, dst, size); });
+}
+
+namespace
+{
+// By-value parameters: they live in the coroutine frame for the whole GET (see loop_blocking.hpp).
+template <typename Window, typename State>
+vio::task_t<void> fetch_window(vio::objstore::io_manager_t *io, std::string object, std::shared_ptr<Window> window, std::shared_ptr<State> state)
+{
+  vio::objstore::io_range_t range;
+  range.offset = int64_t(window->offset);
+  range.size = int64_t(window->size);
+  auto r = co_await io->read_object(object, window->data.get(), range);
+  dew_error_t error;
+  if (!r.has_value())
+    error = from_vio(r.error());
+  else if (uint64_t(r.value()) != window->size)
+    error = {1, "Short read from remote input"};
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    window->error = std::move(error);
+    window->done = true;
+    state->in_flight--;
+  }
+  state->condition.notify_all();
+  co_return;
+}
+} // namespace
+
+void remote_input_t::fill_read_ahead()
+{
+  while (_windows.size() < size_t(_read_ahead) + 1 && _next_fetch_offset < _size)
+  {
+    auto window = std::make_shared<window_t>();
+    window->offset = _next_fetch_offset;
+    window->size = std::min(_window_bytes, _size - _next_fetch_offset);
+    window->data.reset(new uint8_t[window->size]);
+    _next_fetch_offset += window->size;
+    {
+      std::unique_lock<std::mutex> lock(_fetch_state->mutex);
+      _fetch_state->in_flight++;
+    }
+    _loop.run_in_loop([io = _io.get(), object = _object, window, state = _fetch_state]() -> vio::task_t<void> { return fetch_window(io, object, window, state); });
+    _windows.push_back(std::move(window));
+  }
+}
+
+uint64_t remote_input_t::position() const
+{
+  return eback() ? _get_offset + uint64_t(gptr() - eback()) : _get_offset;
+}
+
+remote_input_t::int_type remote_input_t::underflow()
+{
+  if (gptr() < egptr())
+    return traits_type::to_int_type(*gptr());
+  const uint64_t pos = position();
+  while (!_windows.empty() && _windows.front()->offset + _windows.front()->size <= pos)
+    _windows.pop_front();
+  if (!_windows.empty() && _windows.front()->offset > pos)
+    _windows.clear(); // seeked backwards past the read-ahead
+  if (_windows.empty())
+    _next_fetch_offset = pos;
+  fill_read_ahead();
+  setg(nullptr, nullptr, nullptr);
+  _get_offset = pos;
+  if (_windows.empty() || _error.code != 0)
+    return traits_type::eof();
+
+  auto &window = *_windows.front();
+  {
+    std::unique_lock<std::mutex> lock(_fetch_state->mutex);
+    _fetch_state->condition.wait(lock, [&window] { return window.done; });
+  }
+  if (window.error.code != 0)
+  {
+    _error = window.error;
+    return traits_type::eof();
+  }
+  auto *base = reinterpret_cast<char *>(window.data.get());
+  setg(base, base + (pos - window.offset), base + window.size);
+  _get_offset = window.offset;
+  return traits_type::to_int_type(*gptr());
+}
+
+remote_input_t::pos_type remote_input_t::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  if (!(which & std::ios_base::in))
+    return pos_type(off_type(-1));
+  int64_t base = 0;
+  if (dir == std::ios_base::cur)
+    base = int64_t(position());
+  else if (dir == std::ios_base::end)
+    base = int64_t(_size);
+  return seekpos(pos_type(off_type(base + int64_t(off))), which);
+}
+
+remote_input_t::pos_type remote_input_t::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+  const auto target = int64_t(off_type(pos));
+  if (!(which & std::ios_base::in) || target < 0 || uint64_t(target) > _size)
+    return pos_type(off_type(-1));
+  const uint64_t offset = uint64_t(target);
+  if (eback() && offset >= _get_offset && offset <= _get_offset + uint64_t(egptr() - eback()))
+  {
+    setg(eback(), eback() + (offset - _get_offset), egptr());
+    return pos;
+  }
+  // Outside the current window: underflow keeps any read-ahead window that covers the target.
+  setg(nullptr, nullptr, nullptr);
+  _get_offset = offset;
+  return pos;
+}
+
+} // namespace dew::converter
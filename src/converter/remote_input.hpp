@@ -0,0 +1,137 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Remote inputs: LAS/LAZ files named by an object-store URL (s3://bucket/tile.laz, az://, dir://, mem://)
+// are read through the same vio io_manager_t the storage backends use, instead of being staged to disk.
+//
+// laszip reads from a std::istream (laszip_open_reader_stream). remote_input_t is that stream's buffer:
+// the get area is one window of a ranged GET, and the next `read_ahead` windows are already in flight
+// while laszip decodes the current one, so a long sequential read keeps the connection busy. A seek inside
+// the current window is free; any other seek drops the read-ahead and restarts it at the target (laszip
+// seeks to the LAZ chunk table and back once at open, then streams).
+//
+// The pre-init probe does not build a stream at all: read_range fetches only the LAS header.
+//
+// The io runs on the input's own loop thread; the laszip callbacks block on it from the reader's pool
+// worker, which is where they already block on local file IO.
+
+#include <dew/core/error.h>
+
+#include <vio/event_loop.h>
+#include <vio/objstore/object_store.h>
+#include <vio/task.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace dew::converter
+{
+
+// True for names with an object-store scheme; bare paths and file:// stay on laszip's own file reader.
+bool is_remote_input(std::string_view name);
+
+struct remote_input_options_t
+{
+  uint64_t window_bytes = uint64_t(8) << 20; // bytes per ranged GET
+  uint32_t read_ahead = 2;                   // windows in flight ahead of the one being decoded
+  std::string connection;                    // provider connection string; empty = environment credentials
+};
+
+// Process-wide: the laszip callbacks carry no converter context. Applies to inputs opened afterwards.
+void set_remote_input_options(remote_input_options_t options);
+remote_input_options_t remote_input_options();
+
+class remote_input_t : public std::streambuf
+{
+public:
+  // Resolve the object and its size (one HEAD); null with `error` set when it cannot be read.
+  static std::unique_ptr<remote_input_t> open(const std::string &url, const remote_input_options_t &options, dew_error_t &error);
+  ~remote_input_t() override;
+  remote_input_t(const remote_input_t &) = delete;
+  remote_input_t &operator=(const remote_input_t &) = delete;
+
+  uint64_t size() const
+  {
+    return _size;
+  }
+  std::istream &stream()
+  {
+    return _stream;
+  }
+  // The fetch error that ended the stream early, if any.
+  const dew_error_t &error() const
+  {
+    return _error;
+  }
+
+  // One blocking ranged read outside the stream's windows (the header probe).
+  [[nodiscard]] dew_error_t read_range(uint64_t offset, uint8_t *dst, uint64_t size);
+
+protected:
+  int_type underflow() override;
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+  struct window_t
+  {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    std::unique_ptr<uint8_t[]> data;
+    bool done = false; // under fetch_state_t::mutex
+    dew_error_t error;
+  };
+  // Shared with the fetch coroutines, which may outlive a dropped window.
+  struct fetch_state_t
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    int in_flight = 0;
+  };
+
+  explicit remote_input_t(const remote_input_options_t &options);
+  vio::task_t<dew_error_t> probe_size();
+  vio::task_t<dew_error_t> do_read_range(uint64_t offset, uint8_t *dst, uint64_t size);
+  void fill_read_ahead();
+  uint64_t position() const;
+
+  vio::thread_with_event_loop_t _loop_thread;
+  vio::event_loop_t &_loop;
+  std::unique_ptr<vio::objstore::io_manager_t> _io;
+  std::string _object;
+  uint64_t _size = 0;
+  uint64_t _window_bytes;
+  uint32_t _read_ahead;
+
+  std::deque<std::shared_ptr<window_t>> _windows; // ascending and contiguous; [0] backs the get area
+  uint64_t _next_fetch_offset = 0;
+  uint64_t _get_offset = 0; // object offset of eback(), or the position while the get area is empty
+  std::shared_ptr<fetch_state_t> _fetch_state;
+  dew_error_t _error;
+  std::istream _stream;
+};
+
+} // namespace dew::converter
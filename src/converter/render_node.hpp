@@ -27,6 +27,7 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace dew::converter
 {
@@ -93,6 +94,11 @@ struct render_node_t
   // runs on a fresh upload, the promoter must free the monolith and reload to re-acquire the handler once
   // budget headroom returns — without this flag the leaf is stranded on its full-res monolith forever.
   bool salvage_lost = false;
+
+  // Occlusion culling (occlusion_culler.hpp): a spread of this node's points, relative to `offset`, kept at
+  // upload so it can occlude the nodes behind it once it is on screen; the radius is their splat size.
+  std::vector<glm::vec3> occluder_samples;
+  float occluder_radius = 0.0f;
 };
 
 struct frame_timings_t
@@ -105,6 +111,8 @@ struct frame_timings_t
   double gpu_upload_ms = 0;
   double fade_ms = 0;
   double emit_ms = 0;
+  double prefetch_ms = 0; // predicted-frustum walk + read-ahead scheduling (0 while the camera is still)
+  double occlusion_ms = 0; // depth-pyramid build (0 while occlusion culling is off)
   double total_ms = 0;
   int walker_node_count = 0;
   uint64_t walker_total_points = 0;
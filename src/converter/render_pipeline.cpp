@@ -236,6 +236,13 @@ static void convert_node_data(render_node_t &node, render::node_data_loader_t *n
   node.convert_done.store(true, std::memory_order_release);
 }
 
+double node_screen_error(const tree_walker_data_t &w, double distance, const glm::dmat4 &projection)
+{
+  const double node_size = glm::length(w.aabb.max - w.aabb.min) * 0.5;
+  // Inside (or within a cell of) the node it covers the screen; clamp rather than divide by ~0.
+  return projection[1][1] * 0.5 * node_size / std::max(distance, node_size);
+}
+
 io_upload_stats_t process_io_and_upload(
     render_list_t &render_list,
     const glm::dvec3 &camera_position,
@@ -248,7 +255,10 @@ io_upload_stats_t process_io_and_upload(
     double attr_min, double attr_max,
     bool promote_leaves,
     size_t virtual_gpu_used,
-    std::vector<render::loaded_node_data_t> *reap_sink)
+    std::vector<render::loaded_node_data_t> *reap_sink,
+    prefetch_state_t *prefetch,
+    const occlusion_pyramid_t *occlusion,
+    occlusion_mode_t occlusion_mode)
 {
   using clock = std::chrono::high_resolution_clock;
   auto to_ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
@@ -256,8 +266,30 @@ io_upload_stats_t process_io_and_upload(
   io_upload_stats_t stats;
   // Departed-but-busy nodes parked outside the render list still pin decoded CPU buffers in the same heap.
   stats.backlog_bytes = limits.deferred_backlog_bytes;
+  // Retire read-aheads whose reads have landed (their bytes now sit in the read cache); the rest keep their
+  // IO-slot and byte charge. The slot charge applies to the real loads below too -- a read-ahead is a read
+  // the backend is serving, whoever asked for it -- but schedule_prefetch only ever fills the slots the
+  // real loads left over, so it costs an on-screen node at most the frames until the read-ahead lands.
+  if (prefetch)
+  {
+    auto &pending = prefetch->in_flight;
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [node_loader](const prefetch_state_t::in_flight_t &e) {
+                                   if (!node_loader->is_ready(e.handle))
+                                     return false;
+                                   node_loader->cancel(e.handle); // release the handle; the bytes stay cached
+                                   return true;
+                                 }),
+                  pending.end());
+    stats.prefetch_in_flight = int(pending.size());
+    for (auto &e : pending)
+      stats.prefetch_bytes_in_flight += e.bytes;
+  }
   std::vector<priority_entry_t> load_list;
+  std::vector<priority_entry_t> occluded_list; // deprioritize: loaded after every visible node
   std::vector<priority_entry_t> upload_list;
+  const bool occlusion_active = occlusion && occlusion_mode != occlusion_mode_t::off;
+  const bool occlusion_testable = occlusion_active && occlusion->valid();
 
   // Phase A: Single pass — compute distances, advance state machine, classify nodes
   auto t0 = clock::now();
@@ -324,24 +356,66 @@ io_upload_stats_t process_io_and_upload(
       // monolith_freed: a live virtual cut represents this leaf; don't reload its monolith (R3). On un-promotion
       // the promoter clears monolith_freed + io_state so it reloads here.
       if (node.gpu_state == render_node_gpu_state::none && node.fade_state != render_node_fade_state::fade_out && !node.monolith_freed)
-        load_list.push_back({i, node.cached_distance});
+      {
+        const double screen_error = limits.rank_by_screen_error ? node_screen_error(node.walker_data, node.cached_distance, camera_frame.projection) : 0.0;
+        if (occlusion_testable)
+        {
+          stats.occlusion_tested++;
+          if (occlusion->is_occluded(node.walker_data.tight_aabb))
+          {
+            stats.occlusion_occluded++;
+            if (occlusion_mode == occlusion_mode_t::deprioritize)
+              occluded_list.push_back({i, node.cached_distance, screen_error});
+            break;
+          }
+        }
+        load_list.push_back({i, node.cached_distance, screen_error});
+      }
       break;
     }
   }
   auto t1 = clock::now();
   stats.scan_classify_ms = to_ms(t1 - t0);
 
-  // Phase B: Schedule IO — sort by distance, issue closest first
+  // Phase B: Schedule IO — sort by distance, issue closest first. Under an arbiter the order is coarsest on
+  // screen first (closest breaking ties), the order every source sharing the IO slots agrees on.
   auto dist_cmp = [](const priority_entry_t &a, const priority_entry_t &b) { return a.distance < b.distance; };
-  std::sort(load_list.begin(), load_list.end(), dist_cmp);
+  auto error_cmp = [](const priority_entry_t &a, const priority_entry_t &b) {
+    return a.screen_error != b.screen_error ? a.screen_error > b.screen_error : a.distance < b.distance;
+  };
+  if (limits.rank_by_screen_error)
+    std::sort(load_list.begin(), load_list.end(), error_cmp);
+  else
+    std::sort(load_list.begin(), load_list.end(), dist_cmp);
+  if (!occluded_list.empty())
+  {
+    if (limits.rank_by_screen_error)
+      std::sort(occluded_list.begin(), occluded_list.end(), error_cmp);
+    else
+      std::sort(occluded_list.begin(), occluded_list.end(), dist_cmp);
+    load_list.insert(load_list.end(), occluded_list.begin(), occluded_list.end());
+  }
 
   for (auto &entry : load_list)
   {
-    if (stats.io_in_flight >= limits.max_concurrent_io)
+    if (limits.rank_by_screen_error && entry.screen_error < limits.min_screen_error)
+    {
+      stats.io_denied_arbiter++;
+      break;
+    }
+    if (stats.io_in_flight + stats.prefetch_in_flight >= limits.max_concurrent_io)
       break;
     if (stats.io_scheduled >= limits.max_new_io_per_frame)
       break;
     auto &node = *render_list[entry.index];
+    // A node whose read-ahead is still in flight waits for it rather than reading the same blobs a second
+    // time; once it lands, the load is a cache hit. Its slot is already charged as a prefetch.
+    if (prefetch && node.walker_data.locations[0].size > 0)
+    {
+      const cache_key_t key{node.walker_data.locations[0].file_id, node.walker_data.locations[0].offset};
+      if (std::any_of(prefetch->in_flight.begin(), prefetch->in_flight.end(), [&key](const prefetch_state_t::in_flight_t &e) { return e.key == key; }))
+        continue;
+    }
     // Byte gates (closest-first, so `break` like the upload loop -- a far node must not leapfrog a near one).
     // The backlog gate is what bounds CPU-heap growth: without it, every decoded node frees an IO slot while
     // its buffers wait (possibly forever, if the GPU budget is full) in the same heap. The GPU-fit gate skips
@@ -375,6 +449,31 @@ io_upload_stats_t process_io_and_upload(
     stats.io_scheduled++;
     stats.backlog_bytes += est_cpu;
     stats.projected_gpu_bytes += est_gpu;
+    // A hit is a load whose primary blob a read-ahead already brought in; one still in flight held the load
+    // back above, so every warmed key that gets here has landed.
+    if (prefetch && req.locations[0].size > 0)
+    {
+      const cache_key_t key{req.locations[0].file_id, req.locations[0].offset};
+      if (prefetch->warmed.erase(key))
+      {
+        stats.prefetch_hits++;
+        prefetch->hits_total++;
+      }
+    }
+  }
+  if (prefetch)
+    stats.prefetch_hit_rate = prefetch->hit_rate();
+  // The loop admits a prefix of load_list; what is still unloaded behind it is this source's bid.
+  if (limits.rank_by_screen_error)
+  {
+    for (auto &entry : load_list)
+    {
+      if (render_list[entry.index]->io_state != render_node_io_state::none)
+        continue;
+      stats.screen_error_demand.push_back(entry.screen_error);
+      if (stats.screen_error_demand.size() >= max_screen_error_demand)
+        break;
+    }
   }
   auto t2 = clock::now();
   stats.schedule_io_ms = to_ms(t2 - t1);
@@ -442,6 +541,8 @@ io_upload_stats_t process_io_and_upload(
     callbacks.do_initialize_buffer(node.params_buffer, dew_type_r32, dew_components_4, sizeof(node.params_data), &node.params_data);
 
     node.gpu_state = render_node_gpu_state::uploaded;
+    if (occlusion_active && loaded.vertex_type == dew_type_r32 && loaded.vertex_components == dew_components_3)
+      capture_occluder_samples(node, loaded.vertex_data, loaded.vertex_data_size, loaded.point_count, node.has_lod_order);
     // A spanning leaf may later want virtual subdivision, which needs the pre-reorder morton codes. Salvage the
     // data_handler (already in memory, about to be freed) before release; promotion decides per-frame.
     if (promote_leaves && node.walker_data.is_leaf && !node.resident_handler && node.loaded_data._impl_data)
@@ -476,6 +577,84 @@ io_upload_stats_t process_io_and_upload(
   return stats;
 }
 
+int schedule_prefetch(
+    prefetch_state_t &prefetch,
+    std::vector<tree_walker_data_t> &candidates,
+    const glm::dvec3 &predicted_position,
+    const tree_config_t &tree_config,
+    render::node_data_loader_t *node_loader,
+    const io_limits_t &limits,
+    io_upload_stats_t &stats)
+{
+  if (!node_loader || candidates.empty())
+    return 0;
+
+  // Closest to where the eye is GOING first -- the leading edge of a pan is what the user sees next.
+  std::vector<priority_entry_t> order;
+  order.reserve(candidates.size());
+  for (int i = 0; i < int(candidates.size()); i++)
+  {
+    const auto &taabb = candidates[i].tight_aabb;
+    glm::dvec3 nearest = glm::clamp(predicted_position, taabb.min, taabb.max);
+    order.push_back({i, glm::length(nearest - predicted_position)});
+  }
+  std::sort(order.begin(), order.end(), [](const priority_entry_t &a, const priority_entry_t &b) { return a.distance < b.distance; });
+
+  int issued = 0;
+  for (auto &entry : order)
+  {
+    // Leftovers only: the real loads already took their share of the slot, per-frame and byte caps above.
+    if (stats.io_in_flight + stats.prefetch_in_flight >= limits.max_concurrent_io)
+      break;
+    if (stats.io_scheduled + stats.prefetch_scheduled >= limits.max_new_io_per_frame)
+      break;
+    const auto &w = candidates[entry.index];
+    if (w.locations[0].size == 0)
+      continue;
+    const cache_key_t key{w.locations[0].file_id, w.locations[0].offset};
+    if (prefetch.warmed.count(key))
+      continue; // fetched (or fetching) already
+    // The read-ahead holds compressed bytes only, so charge exactly those against the backlog headroom.
+    uint64_t bytes = 0;
+    for (auto &location : w.locations)
+      bytes += location.size;
+    if (stats.backlog_bytes + stats.prefetch_bytes_in_flight + bytes > limits.decoded_backlog_cap)
+      break;
+
+    native_load_request_t req;
+    std::memcpy(req.format, w.format, sizeof(req.format));
+    std::memcpy(req.locations, w.locations, sizeof(req.locations));
+    req.tree_config = tree_config;
+    const auto handle = node_loader->request_prefetch(&req, sizeof(req));
+    if (handle == render::invalid_load_handle)
+      break; // this loader cannot prefetch
+
+    prefetch.in_flight.push_back({handle, key, bytes});
+    prefetch.warmed.insert(key);
+    prefetch.warmed_order.push_back(key);
+    while (prefetch.warmed_order.size() > prefetch_state_t::max_warmed)
+    {
+      prefetch.warmed.erase(prefetch.warmed_order.front());
+      prefetch.warmed_order.pop_front();
+    }
+    prefetch.issued_total++;
+    stats.prefetch_scheduled++;
+    stats.prefetch_in_flight++;
+    stats.prefetch_bytes_in_flight += bytes;
+    issued++;
+  }
+  stats.prefetch_hit_rate = prefetch.hit_rate();
+  return issued;
+}
+
+void cancel_prefetch(prefetch_state_t &prefetch, render::node_data_loader_t *node_loader)
+{
+  if (node_loader)
+    for (auto &e : prefetch.in_flight)
+      node_loader->cancel(e.handle);
+  prefetch.in_flight.clear();
+}
+
 void update_fades(
     render_list_t &render_list,
     float delta_ms,
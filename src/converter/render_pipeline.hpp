@@ -17,11 +17,15 @@
 ************************************************************************/
 #pragma once
 
+#include "blob_reader.hpp" // cache_key_t (prefetch hit accounting keys on the same (file_id, offset))
 #include "dataset_types.hpp"
+#include "occlusion_culler.hpp"
 #include "render_node.hpp"
 #include "renderer_callbacks.hpp"
 
+#include <deque>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace vio { class thread_pool_t; }
@@ -44,6 +48,7 @@ struct priority_entry_t
 {
   int index;
   double distance;
+  double screen_error = 0.0; // only with io_limits_t::rank_by_screen_error
 };
 
 static constexpr float default_fade_duration_ms = 300.0f;
@@ -77,8 +82,16 @@ struct io_limits_t
   // CPU bytes still pinned by departed nodes parked in pending_destroy (decoded buffers whose worker job
   // hasn't finished); they share the same heap, so they pre-charge the backlog.
   size_t deferred_backlog_bytes = 0;
+  // Cross-source arbitration (resource_arbiter.hpp): rank the load queue by node_screen_error instead of
+  // distance, and leave nodes below min_screen_error for a later frame -- another data source sharing the
+  // budgets has coarser ones waiting.
+  bool rank_by_screen_error = false;
+  double min_screen_error = 0.0;
 };
 
+// Unscheduled nodes reported to the arbiter per frame; more than the IO slots of any sane setup.
+static constexpr size_t max_screen_error_demand = 256;
+
 struct io_upload_stats_t
 {
   int io_in_flight = 0;
@@ -86,6 +99,7 @@ struct io_upload_stats_t
   int uploads_done = 0;
   int io_denied_backlog = 0; // IO refused: decoded-backlog byte cap reached
   int io_denied_gpu = 0;     // IO refused: node wouldn't fit the GPU budget
+  int io_denied_arbiter = 0; // IO deferred: below the arbiter's screen-error floor
   size_t gpu_memory_used = 0;
   size_t backlog_bytes = 0;       // estimated CPU bytes held by loading/converting/loaded nodes this frame
   size_t projected_gpu_bytes = 0; // GPU bytes the in-flight pipeline will claim once uploaded
@@ -93,8 +107,54 @@ struct io_upload_stats_t
   double schedule_io_ms = 0;
   double normalize_ms = 0;
   double gpu_upload_ms = 0;
+  // Predictive prefetch (schedule_prefetch). Read-aheads are raw blob reads for nodes in the extrapolated
+  // frustum; a hit is a real load whose primary blob a read-ahead had already warmed. The rate is
+  // cumulative (hits / issued over the data source's lifetime), the counts are this frame's.
+  int prefetch_scheduled = 0;
+  int prefetch_in_flight = 0;
+  int prefetch_hits = 0;
+  size_t prefetch_bytes_in_flight = 0;
+  double prefetch_hit_rate = 0;
+  // Occlusion culling: unloaded nodes tested against the depth pyramid this frame, and how many of them
+  // were behind it (pushed to the back of the IO queue, or not loaded with occlusion_mode_t::skip).
+  int occlusion_tested = 0;
+  int occlusion_occluded = 0;
+  // With rank_by_screen_error: the screen errors of the unloaded nodes left unscheduled this frame, highest
+  // first (at most max_screen_error_demand) -- this source's bid for the next frame's IO slots.
+  std::vector<double> screen_error_demand;
+};
+
+// Screen-space error of a node that is not loaded yet, in fractions of the viewport height: the half-
+// diagonal of its octree cell (the spacing its points would refine) projected at its nearest distance.
+// The same measure the walker subdivides on, so it compares nodes of different datasets directly.
+double node_screen_error(const tree_walker_data_t &w, double distance, const glm::dmat4 &projection);
+
+// Read-ahead bookkeeping that outlives a frame. `in_flight` holds the loader handles until their reads land
+// (they are charged against the IO slot and backlog caps until then); `warmed` remembers which primary
+// blobs were prefetched so the real load can be counted as a hit. `warmed` is a bounded FIFO -- an entry
+// the camera never reached ages out and simply counts as a miss.
+struct prefetch_state_t
+{
+  struct in_flight_t
+  {
+    render::load_handle_t handle;
+    cache_key_t key;
+    uint64_t bytes;
+  };
+  std::vector<in_flight_t> in_flight;
+  std::unordered_set<cache_key_t, cache_key_hash_t> warmed;
+  std::deque<cache_key_t> warmed_order;
+  uint64_t issued_total = 0;
+  uint64_t hits_total = 0;
+
+  static constexpr size_t max_warmed = 4096;
+
+  [[nodiscard]] double hit_rate() const { return issued_total ? double(hits_total) / double(issued_total) : 0.0; }
 };
 
+// With an `occlusion` pyramid and a mode other than off, unloaded nodes the pyramid reports occluded are
+// loaded after all the others (deprioritize) or not at all (skip), and every upload keeps its occluder
+// samples for the next frame's pyramid.
 io_upload_stats_t process_io_and_upload(
     render_list_t &render_list,
     const glm::dvec3 &camera_position,
@@ -107,7 +167,29 @@ io_upload_stats_t process_io_and_upload(
     double attr_min, double attr_max,
     bool promote_leaves,
     size_t virtual_gpu_used,
-    std::vector<render::loaded_node_data_t> *reap_sink);
+    std::vector<render::loaded_node_data_t> *reap_sink,
+    prefetch_state_t *prefetch = nullptr,
+    const occlusion_pyramid_t *occlusion = nullptr,
+    occlusion_mode_t occlusion_mode = occlusion_mode_t::off);
+
+// Low-priority read-ahead, run AFTER process_io_and_upload on the same frame with its stats: `candidates`
+// are walker nodes from the predicted (extrapolated) frustum that the current walk did not select. They are
+// issued closest-to-the-predicted-eye first, only into whatever IO slots, per-frame IO allowance and
+// decoded-backlog headroom the real loads left unused, so a prefetch can never delay a node that is on
+// screen now. No decode, no GPU upload: the blobs land compressed in the read cache. Returns the number
+// of read-aheads issued (also added to stats.prefetch_scheduled).
+int schedule_prefetch(
+    prefetch_state_t &prefetch,
+    std::vector<tree_walker_data_t> &candidates,
+    const glm::dvec3 &predicted_position,
+    const tree_config_t &tree_config,
+    render::node_data_loader_t *node_loader,
+    const io_limits_t &limits,
+    io_upload_stats_t &stats);
+
+// Release the read-aheads still in flight (data-source teardown / attribute change). The bytes already
+// fetched stay cached.
+void cancel_prefetch(prefetch_state_t &prefetch, render::node_data_loader_t *node_loader);
 
 void update_fades(
     render_list_t &render_list,
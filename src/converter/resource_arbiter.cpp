@@ -0,0 +1,152 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "resource_arbiter.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace dew::converter
+{
+
+resource_arbiter_t::resource_arbiter_t()
+  : _convert_pool(std::max(2u, std::thread::hardware_concurrency() / 2))
+{
+}
+
+void resource_arbiter_t::add_source(const dew_converter_data_source_t *source)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto it = std::find_if(_sources.begin(), _sources.end(), [source](const source_state_t &s) { return s.source == source; });
+  if (it == _sources.end())
+    _sources.push_back({source, {}});
+}
+
+void resource_arbiter_t::remove_source(const dew_converter_data_source_t *source)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _sources.erase(std::remove_if(_sources.begin(), _sources.end(), [source](const source_state_t &s) { return s.source == source; }), _sources.end());
+}
+
+void resource_arbiter_t::set_memory_budget(uint64_t total_bytes)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _budgets = derive_budgets(total_bytes);
+}
+
+uint64_t resource_arbiter_t::memory_budget()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _budgets.total;
+}
+
+void resource_arbiter_t::set_gpu_memory_budget(size_t budget_bytes)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _gpu_memory_budget = budget_bytes;
+}
+
+void resource_arbiter_t::set_max_in_flight_io(int max_requests)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _max_in_flight_io = std::max(1, max_requests);
+}
+
+// The error of the last unscheduled node, across every source, that the free IO slots could still take.
+// 0 when they can take all of them (or none: the concurrency gate stops everything then anyway).
+double resource_arbiter_t::min_screen_error_locked() const
+{
+  int in_flight = 0;
+  size_t demand_count = 0;
+  for (auto &s : _sources)
+  {
+    in_flight += s.last.io_in_flight;
+    demand_count += s.last.demand.size();
+  }
+  const int free_slots = std::min(_max_in_flight_io, _budgets.io_clamp) - in_flight;
+  if (free_slots <= 0 || demand_count <= size_t(free_slots))
+    return 0.0;
+  std::vector<double> demand;
+  demand.reserve(demand_count);
+  for (auto &s : _sources)
+    demand.insert(demand.end(), s.last.demand.begin(), s.last.demand.end());
+  std::nth_element(demand.begin(), demand.begin() + (free_slots - 1), demand.end(), std::greater<double>());
+  return demand[size_t(free_slots - 1)];
+}
+
+arbiter_grant_t resource_arbiter_t::grant(const dew_converter_data_source_t *source)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  size_t others_backlog = 0;
+  size_t others_gpu = 0;
+  int others_in_flight = 0;
+  for (auto &s : _sources)
+  {
+    if (s.source == source)
+      continue;
+    others_backlog += s.last.backlog_bytes;
+    others_gpu += s.last.gpu_bytes;
+    others_in_flight += s.last.io_in_flight;
+  }
+
+  arbiter_grant_t g;
+  const size_t backlog_cap = size_t(_budgets.decoded_backlog_cap);
+  g.decoded_backlog_cap = backlog_cap > others_backlog ? backlog_cap - others_backlog : 0;
+  g.gpu_memory_budget = _gpu_memory_budget > others_gpu ? _gpu_memory_budget - others_gpu : 0;
+  g.max_concurrent_io = std::max(0, std::min(_max_in_flight_io, _budgets.io_clamp) - others_in_flight);
+  g.min_screen_error = min_screen_error_locked();
+
+  // Caches and resident sources are long-lived per-source state, so they are split rather than arbitrated
+  // per frame: an even share keeps the sum at the global derivation.
+  const uint64_t n = std::max<uint64_t>(1, _sources.size());
+  g.share = _budgets;
+  g.share.read_cache_bytes /= n;
+  g.share.decompressed_cache_bytes /= n;
+  g.share.cpu_resident_budget /= n;
+  return g;
+}
+
+void resource_arbiter_t::report(const dew_converter_data_source_t *source, arbiter_report_t &&report)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (auto &s : _sources)
+  {
+    if (s.source == source)
+    {
+      s.last = std::move(report);
+      return;
+    }
+  }
+}
+
+arbiter_stats_t resource_arbiter_t::stats()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  arbiter_stats_t st;
+  st.sources = int(_sources.size());
+  for (auto &s : _sources)
+  {
+    st.backlog_bytes += s.last.backlog_bytes;
+    st.gpu_bytes += s.last.gpu_bytes;
+    st.io_in_flight += s.last.io_in_flight;
+  }
+  st.min_screen_error = min_screen_error_locked();
+  return st;
+}
+
+} // namespace dew::converter
@@ -0,0 +1,113 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// One set of streaming budgets shared by several converter data sources in the same renderer. On its own
+// every data source derives its own CPU budget, GPU budget, IO concurrency and convert pool, so twenty
+// tiled datasets in one view hold twenty times the memory the consumer asked for and compete blindly for
+// bandwidth. Registered with an arbiter, a source instead gets per frame:
+//  - the byte caps (decoded backlog, GPU) minus what the OTHER sources held at the end of their last frame;
+//  - the IO slots the other sources' in-flight loads leave free;
+//  - a screen-space-error floor: every source reports the unloaded nodes it could not schedule, and the
+//    floor is the error of the last one that still fits the free slots across ALL sources, so the
+//    coarsest-on-screen nodes load first no matter which dataset they belong to;
+//  - an even share of the read/decompressed caches and the virtual-subtree resident budget;
+//  - the arbiter's convert pool in place of its own.
+//
+// The sources render one after the other inside dew_renderer_frame, so the arbitration works from the
+// others' previous reports: everything a source is granted is at most one frame stale, which the byte gates'
+// escape hatch (a source with an empty pipeline may always admit one node) already tolerates.
+
+#include "memory_budget.hpp" // derived_budgets_t
+
+#include <vio/thread_pool.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+struct dew_converter_data_source_t;
+
+namespace dew::converter
+{
+
+// What one source may use for its next frame.
+struct arbiter_grant_t
+{
+  size_t decoded_backlog_cap = 0;
+  size_t gpu_memory_budget = 0;
+  int max_concurrent_io = 0;
+  double min_screen_error = 0.0; // unloaded nodes below this wait; another source has coarser ones
+  derived_budgets_t share;       // cache and resident budgets: the global derivation split evenly
+};
+
+// What a source held at the end of its frame.
+struct arbiter_report_t
+{
+  size_t backlog_bytes = 0;
+  size_t gpu_bytes = 0; // uploaded, virtual and projected in-flight
+  int io_in_flight = 0; // real loads and read-aheads
+  std::vector<double> demand; // screen errors of the unloaded nodes it could not schedule
+};
+
+struct arbiter_stats_t
+{
+  int sources = 0;
+  uint64_t backlog_bytes = 0;
+  uint64_t gpu_bytes = 0;
+  int io_in_flight = 0;
+  double min_screen_error = 0.0;
+};
+
+class resource_arbiter_t
+{
+public:
+  resource_arbiter_t();
+
+  void add_source(const dew_converter_data_source_t *source);
+  void remove_source(const dew_converter_data_source_t *source);
+
+  void set_memory_budget(uint64_t total_bytes);
+  [[nodiscard]] uint64_t memory_budget();
+  void set_gpu_memory_budget(size_t budget_bytes);
+  void set_max_in_flight_io(int max_requests);
+
+  [[nodiscard]] arbiter_grant_t grant(const dew_converter_data_source_t *source);
+  void report(const dew_converter_data_source_t *source, arbiter_report_t &&report);
+  [[nodiscard]] arbiter_stats_t stats();
+
+  [[nodiscard]] vio::thread_pool_t &convert_pool() { return _convert_pool; }
+
+private:
+  struct source_state_t
+  {
+    const dew_converter_data_source_t *source;
+    arbiter_report_t last;
+  };
+
+  double min_screen_error_locked() const;
+
+  std::mutex _mutex;
+  std::vector<source_state_t> _sources;
+  derived_budgets_t _budgets = derive_budgets(uint64_t(1024) * 1024 * 1024);
+  size_t _gpu_memory_budget = 512 * 1024 * 1024;
+  int _max_in_flight_io = 64;
+  vio::thread_pool_t _convert_pool;
+};
+
+} // namespace dew::converter
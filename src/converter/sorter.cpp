@@ -21,6 +21,7 @@
 #include "input_header.hpp"
 #include "morton.hpp"
 #include "morton_tree_coordinate_transform.hpp"
+#include "point_dedup.hpp"
 
 #include <dew/core/default_attribute_names.h>
 
@@ -67,12 +68,12 @@ typename std::enable_if<C1 <= C2>::type assert_morton_downcast(uint32_t point_co
 }
 
 template <typename INDEX_T, typename T1, size_t C1, typename T2, size_t C2>
-typename std::enable_if<(sizeof(morton::morton_t<T1, C1>) > sizeof(morton::morton_t<T2, C2>))>::type downcast_point_buffer(const INDEX_T *indecies_begin, const std::unique_ptr<uint8_t[]> &source, uint32_t source_size,
-                                                                                                                           std::unique_ptr<uint8_t[]> &target, uint32_t &target_size)
+typename std::enable_if<(sizeof(morton::morton_t<T1, C1>) > sizeof(morton::morton_t<T2, C2>))>::type downcast_point_buffer(const INDEX_T *indecies_begin, const point_buffer_t &source, uint32_t source_size,
+                                                                                                                           point_buffer_t &target, uint32_t &target_size)
 {
   uint32_t point_count = source_size / sizeof(morton::morton_t<T1, C1>);
   target_size = point_count * sizeof(morton::morton_t<T2, C2>);
-  target.reset(new uint8_t[target_size]);
+  target = point_buffer_pool().acquire(target_size);
   const morton::morton_t<T1, C1> *source_morton = reinterpret_cast<const morton::morton_t<T1, C1> *>(source.get());
   morton::morton_t<T2, C2> *target_morton = reinterpret_cast<morton::morton_t<T2, C2> *>(target.get());
 
@@ -87,8 +88,8 @@ typename std::enable_if<(sizeof(morton::morton_t<T1, C1>) > sizeof(morton::morto
 }
 
 template <typename INDEX_T, typename T1, size_t C1, typename T2, size_t C2>
-typename std::enable_if<(sizeof(morton::morton_t<T1, C1>) <= sizeof(morton::morton_t<T2, C2>))>::type downcast_point_buffer(const INDEX_T *indecies_begin, const std::unique_ptr<uint8_t[]> &source, uint32_t source_size,
-                                                                                                                            std::unique_ptr<uint8_t[]> &target, uint32_t &target_size)
+typename std::enable_if<(sizeof(morton::morton_t<T1, C1>) <= sizeof(morton::morton_t<T2, C2>))>::type downcast_point_buffer(const INDEX_T *indecies_begin, const point_buffer_t &source, uint32_t source_size,
+                                                                                                                            point_buffer_t &target, uint32_t &target_size)
 {
   (void)indecies_begin;
   (void)source;
@@ -152,12 +153,12 @@ void reorderVectorInPlace(order_iterator indecies_begin, order_iterator indecies
 }
 
 template <typename INDEX_T, size_t C, typename T>
-void reorder_buffer_two(uint32_t count, const INDEX_T *indecies_begin, const void *source, std::unique_ptr<uint8_t[]> &target, uint32_t &target_size)
+void reorder_buffer_two(uint32_t count, const INDEX_T *indecies_begin, const void *source, point_buffer_t &target, uint32_t &target_size)
 {
   using copy_t = std::array<T, C>;
   const copy_t *source_data = reinterpret_cast<const copy_t *>(source);
   target_size = count * sizeof(copy_t);
-  target.reset(new uint8_t[target_size]);
+  target = point_buffer_pool().acquire(target_size);
   copy_t *target_data = reinterpret_cast<copy_t *>(target.get());
   for (uint32_t i = 0; i < count; i++)
   {
@@ -178,7 +179,7 @@ void reorder_buffer_two_into(uint32_t count, const INDEX_T *indecies_begin, cons
 }
 
 template <typename INDEX_T, size_t C>
-void reorder_buffer_one(uint32_t count, const INDEX_T *indecies_begin, std::pair<dew_type_t, dew_components_t> format, const void *source, std::unique_ptr<uint8_t[]> &target, uint32_t &target_size)
+void reorder_buffer_one(uint32_t count, const INDEX_T *indecies_begin, std::pair<dew_type_t, dew_components_t> format, const void *source, point_buffer_t &target, uint32_t &target_size)
 {
   switch (format.first)
   {
@@ -278,7 +279,7 @@ void reorder_buffer_one_into(uint32_t count, const INDEX_T *indecies_begin, std:
 }
 
 template <typename INDEX_T>
-static void reorder_buffer(uint32_t count, const INDEX_T *indecies_begin, std::pair<dew_type_t, dew_components_t> format, const void *source, std::unique_ptr<uint8_t[]> &target, uint32_t &target_size)
+static void reorder_buffer(uint32_t count, const INDEX_T *indecies_begin, std::pair<dew_type_t, dew_components_t> format, const void *source, point_buffer_t &target, uint32_t &target_size)
 {
   switch (format.second)
   {
@@ -330,7 +331,7 @@ void convert_and_sort_morton(const tree_config_t &tree_config, attributes_config
   auto &header = points.header;
   auto count = header.point_count;
   auto buffer_size = uint32_t(sizeof(morton::morton_t<MT, C>) * count);
-  std::unique_ptr<uint8_t[]> world_morton_unique_ptr(new uint8_t[buffer_size]);
+  point_buffer_t world_morton_unique_ptr = point_buffer_pool().acquire(buffer_size);
   morton::morton_t<MT, C> *morton_begin = reinterpret_cast<morton::morton_t<MT, C> *>(world_morton_unique_ptr.get());
   // Both fill loops below are `for (i = 0; i < count; i++)`, so an empty batch
   // leaves this untouched -- and it is read unconditionally by the
@@ -372,13 +373,43 @@ void convert_and_sort_morton(const tree_config_t &tree_config, attributes_config
       morton::encode(tmp, morton_begin[i]);
     }
   }
-  std::unique_ptr<uint8_t[]> indecies(new uint8_t[sizeof(INDEX_T) * count]);
+  point_buffer_t indecies = point_buffer_pool().acquire(sizeof(INDEX_T) * count);
   INDEX_T *indecies_begin = reinterpret_cast<INDEX_T *>(indecies.get());
   INDEX_T *indecies_end = indecies_begin + count;
   std::iota(indecies_begin, indecies_end, INDEX_T(0));
 
   std::sort(indecies_begin, indecies_end, [morton_begin](INDEX_T a, INDEX_T b) { return morton_begin[a] < morton_begin[b]; });
 
+  // Duplicate elimination (point_dedup.hpp): compact the sorted permutation to one survivor per run.
+  // Every buffer below is gathered through it, so they all shrink with it. Input order is the original
+  // index, which std::sort left unordered inside a run -- the policy compares it explicitly.
+  if (tree_config.dedup_enabled && count > 1)
+  {
+    const auto keep = dedup_keep_t(tree_config.dedup_keep);
+    const uint8_t *value_data = nullptr;
+    point_format_t value_format = {};
+    if (auto *name = dedup_keep_attribute(keep))
+    {
+      auto value_index = attributes_config.get_attribute_index(points.attributes_id, name);
+      if (value_index.index > 0)
+      {
+        value_data = static_cast<const uint8_t *>(points.buffers.buffers[value_index.index].data);
+        value_format = value_index.format;
+      }
+    }
+    const int grid_lod = tree_config.dedup_grid_lod;
+    uint32_t kept = 0;
+    points.duplicates_removed = uint32_t(dedup_sorted_runs(
+      count, keep, value_data != nullptr,
+      [morton_begin, indecies_begin, grid_lod](size_t a, size_t b) { return dedup_same_cell(morton_begin[indecies_begin[a]], morton_begin[indecies_begin[b]], grid_lod); },
+      [indecies_begin](size_t i) { return uint64_t(indecies_begin[i]); },
+      [indecies_begin, value_data, value_format](size_t i) { return dedup_attribute_value(value_data, value_format, indecies_begin[i]); },
+      [indecies_begin, &kept](size_t i) { indecies_begin[kept++] = indecies_begin[i]; }));
+    count = kept;
+    header.point_count = count;
+    buffer_size = uint32_t(sizeof(morton::morton_t<MT, C>) * count);
+  }
+
   morton::morton192_t base_morton;
   morton::encode(tmp, base_morton);
 
@@ -396,7 +427,7 @@ void convert_and_sort_morton(const tree_config_t &tree_config, attributes_config
   // otherwise index indecies_begin[-1] and crash.
   points.header.lod_span = morton::morton_lod(first, last);
   dew_type_t new_type = morton_type_from_lod(points.header.lod_span);
-  std::unique_ptr<uint8_t[]> new_data;
+  point_buffer_t new_data;
   uint32_t new_buffer_size = 0;
   if (new_type == dew_type_m32 && sizeof(morton::morton_t<MT, C>) > sizeof(morton::morton32_t))
     downcast_point_buffer<INDEX_T, MT, C, uint32_t, 1>(indecies_begin, world_morton_unique_ptr, buffer_size, new_data, new_buffer_size);
@@ -438,7 +469,7 @@ void convert_and_sort_morton(const tree_config_t &tree_config, attributes_config
       auto &attr = attributes.attributes[i];
       total_reorder_size += uint32_t(size_for_format(attr.type, attr.components)) * count;
     }
-    std::unique_ptr<uint8_t[]> reorder_block(new uint8_t[total_reorder_size]);
+    point_buffer_t reorder_block = point_buffer_pool().acquire(total_reorder_size);
     uint8_t *block_ptr = reorder_block.get();
     for (int i = 1; i <= reorder_attr_count; i++)
     {
@@ -448,7 +479,8 @@ void convert_and_sort_morton(const tree_config_t &tree_config, attributes_config
       reorder_buffer_into<INDEX_T>(count, indecies_begin, attr_format, points.buffers.data[i].get(), block_ptr);
       points.buffers.data[i].reset();
       points.buffers.buffers[i].data = block_ptr;
-      assert(attr_size == points.buffers.buffers[i].size);
+      assert(attr_size == points.buffers.buffers[i].size || points.duplicates_removed > 0);
+      points.buffers.buffers[i].size = attr_size;
       block_ptr += attr_size;
     }
     points.buffers.data.emplace_back(std::move(reorder_block));
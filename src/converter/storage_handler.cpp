@@ -18,6 +18,7 @@
 #include "storage_handler.hpp"
 #include "compressor_zstd.hpp"
 #include "input_header.hpp"
+#include "worker_pools.hpp"
 #ifndef __EMSCRIPTEN__
 #include "packed_file_backend.hpp" // cache-tier configuration (native only)
 #include <vio/objstore/create_object_store.h>
@@ -86,6 +87,7 @@ dew_error_t storage_handler_t::read_index(std::unique_ptr<uint8_t[]> &free_blobs
   attribute_configs_size = load.attribute_configs_size;
   tree_registry_buffer = std::move(load.tree_registry);
   tree_registry_size = load.tree_registry_size;
+  _tree_registry_journal = std::move(load.tree_registry_journal);
 
   if (load.stats && load.stats_size > 0)
     _compression_stats = compression_stats_t::deserialize(load.stats.get(), load.stats_size);
@@ -134,19 +136,37 @@ void storage_handler_t::write_blob_locations_and_update_header(storage_location_
   _write_blob_locations_and_update_header_pipe.post_event(std::move(location), std::move(old_locations), std::move(done));
 }
 
-static void compute_attribute_min_max(const uint8_t *data, uint32_t size, const point_format_t &format, double &out_min, double &out_max)
+// One pass over an attribute buffer: its value range, plus the set of values present when the
+// attribute is a single u8 component (attribute_zone.hpp).
+static attribute_zone_t compute_attribute_zone(const uint8_t *data, uint32_t size, const point_format_t &format)
 {
-  out_min = std::numeric_limits<double>::max();
-  out_max = std::numeric_limits<double>::lowest();
+  attribute_zone_t zone;
   int elem_size = size_for_format(format.type) * static_cast<int>(format.components);
   if (elem_size <= 0 || size == 0)
-    return;
+    return zone;
   uint32_t count = size / static_cast<uint32_t>(elem_size);
   if (count == 0)
-    return;
-  for (uint32_t i = 0; i < count; i++)
+    return zone;
+  if (format.type == dew_type_u8 && format.components == dew_components_1)
   {
-    const uint8_t *elem = data + i * elem_size;
+    for (uint32_t i = 0; i < count; i++)
+      zone.value_bits[data[i] >> 6] |= uint64_t(1) << (data[i] & 63);
+    for (uint32_t v = 0; v < 256; v++)
+    {
+      if (!attribute_zone_has_value(zone, v))
+        continue;
+      if (double(v) < zone.min)
+        zone.min = double(v);
+      zone.max = double(v);
+    }
+    zone.flags = attribute_zone_has_range | attribute_zone_has_values;
+    return zone;
+  }
+  const int value_size = size_for_format(format.type);
+  const uint32_t value_count = count * static_cast<uint32_t>(format.components);
+  for (uint32_t i = 0; i < value_count; i++)
+  {
+    const uint8_t *elem = data + uint64_t(i) * value_size;
     double val = 0.0;
     switch (format.type)
     {
@@ -160,17 +180,21 @@ static void compute_attribute_min_max(const uint8_t *data, uint32_t size, const
     case dew_type_u64: { uint64_t v; memcpy(&v, elem, 8); val = double(v); break; }
     case dew_type_i64: { int64_t v; memcpy(&v, elem, 8); val = double(v); break; }
     case dew_type_r64: { double v; memcpy(&v, elem, 8); val = v; break; }
-    default: continue;
+    default: return zone;
     }
-    if (val < out_min) out_min = val;
-    if (val > out_max) out_max = val;
+    if (val < zone.min) zone.min = val;
+    if (val > zone.max) zone.max = val;
   }
+  // A buffer of NaNs has no range to offer; leave it unknown rather than claim an empty one.
+  if (zone.min <= zone.max)
+    zone.flags = attribute_zone_has_range;
+  return zone;
 }
 
 static bool serialize_points(const storage_header_t &header, const dew_blob_t &points, dew_blob_t &serialize_data, std::shared_ptr<uint8_t[]> &data_owner)
 {
   serialize_data.size = sizeof(header) + points.size;
-  data_owner = std::make_shared<uint8_t[]>(serialize_data.size);
+  data_owner = point_buffer_pool().acquire(serialize_data.size); // returns to the pool when the write drops it
   serialize_data.data = data_owner.get();
   auto output_bytes = static_cast<uint8_t *>(serialize_data.data);
   memcpy(output_bytes, &header, sizeof(header));
@@ -220,11 +244,23 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
     point_format_t format;
     std::string attr_name;
     bool is_lod;
+    attribute_precision_t precision;
   };
   std::vector<buffer_info_t> buffer_infos(buffer_count);
 
   bool is_lod = !is_leaf;
 
+  // The node whose worker filled the chunk's buffers (see buffer_pool.hpp); unpooled buffers fall back to
+  // the input's node. Read before the morton buffer is recycled below.
+  vio::thread_pool_t *compress_pool = &_thread_pool;
+  if (_worker_pools)
+  {
+    uint32_t node = _worker_pools->node_for_input(header.input_id);
+    if (!attribute_buffers.data.empty() && attribute_buffers.data[0] && attribute_buffers.data[0].get_deleter().size_class != 0)
+      node = attribute_buffers.data[0].get_deleter().node;
+    compress_pool = &_worker_pools->pool(node);
+  }
+
   for (int i = 0; i < buffer_count; i++)
   {
     auto &info = buffer_infos[i];
@@ -232,6 +268,9 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
     {
       dew_blob_t buffer_data;
       serialize_points(header, attribute_buffers.buffers[i], buffer_data, info.data_owner);
+      // The serialized copy carries the points now; recycle the sorted morton buffer right away.
+      if (!attribute_buffers.data.empty() && attribute_buffers.data[0].get() == attribute_buffers.buffers[0].data)
+        attribute_buffers.data[0].reset();
       info.raw = static_cast<uint8_t *>(buffer_data.data);
       info.size = buffer_data.size;
       info.format = header.point_format;
@@ -252,11 +291,14 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
     else
       info.attr_name = "unknown";
     info.is_lod = is_lod;
+    if (i > 0)
+      info.precision = _attributes_configs.get_attribute_precision(info.attr_name);
   }
 
   lock.unlock();
 
   std::vector<storage_location_t> locations(buffer_count);
+  std::vector<attribute_zone_t> zones(buffer_count);
   dew_error_t error;
 
   if (_compressor)
@@ -272,17 +314,31 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
     {
       auto &info = buffer_infos[i];
       work_items.push_back([compressor, raw = info.raw, size = info.size, data_owner = info.data_owner,
-                            format = info.format, point_count, i, attr_name = info.attr_name, is_lod = info.is_lod]() -> std::expected<compressed_write_data_t, vio::error_t>
+                            format = info.format, point_count, i, attr_name = info.attr_name, is_lod = info.is_lod, precision = info.precision]() -> std::expected<compressed_write_data_t, vio::error_t>
       {
-        double attr_min = std::numeric_limits<double>::max();
-        double attr_max = std::numeric_limits<double>::lowest();
+        attribute_zone_t zone;
         if (i > 0)
+          zone = compute_attribute_zone(raw, size, format);
+        auto compressed = try_compress_constant(raw, size, format);
+        double precision_error = 0;
+        bool packed = false;
+        if (!compressed.data && precision.enabled)
         {
-          compute_attribute_min_max(raw, size, format, attr_min, attr_max);
+          compressed = compress_with_precision(compressor, raw, size, format, point_count, precision, precision_error);
+          packed = compressed.data != nullptr;
         }
-        auto compressed = try_compress_constant(raw, size, format);
         if (!compressed.data)
           compressed = compressor->compress(raw, size, format, point_count);
+        // The range must hold the values readers get back, which may sit up to the tolerance outside it,
+        // and a rounded value may no longer be one the value set recorded.
+        if (i > 0 && packed)
+        {
+          zone.min -= precision_error;
+          zone.max += precision_error;
+          zone.flags &= ~attribute_zone_has_values;
+        }
+        const double attr_min = zone.flags ? zone.min : std::numeric_limits<double>::max();
+        const double attr_max = zone.flags ? zone.max : std::numeric_limits<double>::lowest();
 
         compressed_write_data_t wd;
         wd.buffer_index = i;
@@ -291,6 +347,7 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
         wd.uncompressed_size = size;
         wd.min_value = attr_min;
         wd.max_value = attr_max;
+        wd.zone = zone;
         wd.is_lod = is_lod;
 
         if (compressed.error.code != 0)
@@ -307,7 +364,7 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
       });
     }
 
-    auto results = co_await vio::schedule_work(_event_loop, _thread_pool, std::move(work_items));
+    auto results = co_await vio::schedule_work(_event_loop, *compress_pool, std::move(work_items));
 
     // Process compression results on the event loop thread
     for (auto &result : results)
@@ -328,6 +385,7 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
         compression_flags = hdr.flags;
       }
       _compression_stats.accumulate(wd.attribute_name, wd.format, wd.uncompressed_size, wd.size, wd.min_value, wd.max_value, compression_flags, wd.is_lod);
+      zones[wd.buffer_index] = wd.zone;
 
       auto &location = locations[wd.buffer_index];
       _reader.backend()->allocate_blob(wd.size, storage_backend_t::blob_kind_t::data, location);
@@ -340,12 +398,29 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
     for (int i = 0; i < buffer_count; i++)
     {
       auto &info = buffer_infos[i];
-      _compression_stats.accumulate(info.attr_name, info.format, info.size, info.size, std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), 0, info.is_lod);
+      // Without a compressor a precision policy still packs the buffer, into an uncompressed envelope.
+      double precision_error = 0;
+      compression_result_t packed;
+      if (info.precision.enabled)
+        packed = compress_with_precision(nullptr, info.raw, info.size, info.format, header.point_count, info.precision, precision_error);
+      auto data = packed.data ? packed.data : info.data_owner;
+      uint32_t data_size = packed.data ? packed.size : info.size;
+      if (i > 0)
+      {
+        zones[i] = compute_attribute_zone(info.raw, info.size, info.format);
+        if (packed.data)
+        {
+          zones[i].min -= precision_error;
+          zones[i].max += precision_error;
+          zones[i].flags &= ~attribute_zone_has_values;
+        }
+      }
+      _compression_stats.accumulate(info.attr_name, info.format, info.size, data_size, std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), 0, info.is_lod);
 
       auto &location = locations[i];
-      _reader.backend()->allocate_blob(info.size, storage_backend_t::blob_kind_t::data, location);
+      _reader.backend()->allocate_blob(data_size, storage_backend_t::blob_kind_t::data, location);
 
-      co_await do_write(info.data_owner, location);
+      co_await do_write(data, location);
     }
   }
 
@@ -366,23 +441,75 @@ vio::task_t<void> storage_handler_t::do_write_events(storage_header_t header, at
   if (_on_write_progress)
     _on_write_progress();
 
+  if (error.code == 0)
+  {
+    std::unique_lock<std::mutex> zone_lock(_zone_maps_mutex);
+    _zone_maps[header.input_id] = std::move(zones);
+  }
+
   if (done)
   {
     done(header, attributes_id, std::move(locations), error);
   }
 }
 
-void storage_handler_t::handle_write_events(
-  std::tuple<storage_header_t, attributes_id_t, attribute_buffers_t, std::function<void(const storage_header_t &, attributes_id_t, std::vector<storage_location_t> &&, const dew_error_t &error)>> &&event)
+std::vector<attribute_zone_t> storage_handler_t::take_zone_maps(input_data_id_t id)
 {
+  std::unique_lock<std::mutex> lock(_zone_maps_mutex);
+  auto it = _zone_maps.find(id);
+  if (it == _zone_maps.end())
+    return {};
+  auto zones = std::move(it->second);
+  _zone_maps.erase(it);
+  return zones;
+}
+
+void storage_handler_t::handle_write_events(write_event_t &&event)
+{
+  uint32_t limit = _write_limit.load(std::memory_order_relaxed);
+  if (!_deferred_writes.empty() || (limit != 0 && _writes_running.load(std::memory_order_relaxed) >= limit))
+  {
+    _deferred_writes.emplace_back(std::move(event));
+    _writes_queued.store(uint32_t(_deferred_writes.size()), std::memory_order_relaxed);
+    dispatch_deferred_writes();
+    return;
+  }
+  launch_write_event(std::move(event));
+}
+
+void storage_handler_t::launch_write_event(write_event_t &&event)
+{
+  _writes_running.fetch_add(1, std::memory_order_relaxed);
   auto &&[storage_header, attributes_id, attribute_buffers, done] = std::move(event);
   [](storage_handler_t *self, storage_header_t header, attributes_id_t attrib_id, attribute_buffers_t buffers,
      std::function<void(const storage_header_t &, attributes_id_t, std::vector<storage_location_t> &&, const dew_error_t &error)> done_cb) -> vio::detached_task_t
   {
     co_await self->do_write_events(std::move(header), std::move(attrib_id), std::move(buffers), std::move(done_cb));
+    self->_writes_running.fetch_sub(1, std::memory_order_relaxed);
+    self->dispatch_deferred_writes();
   }(this, std::move(storage_header), std::move(attributes_id), std::move(attribute_buffers), std::move(done));
 }
 
+void storage_handler_t::dispatch_deferred_writes()
+{
+  while (!_deferred_writes.empty())
+  {
+    uint32_t limit = _write_limit.load(std::memory_order_relaxed);
+    if (limit != 0 && _writes_running.load(std::memory_order_relaxed) >= limit)
+      break;
+    auto event = std::move(_deferred_writes.front());
+    _deferred_writes.pop_front();
+    launch_write_event(std::move(event));
+  }
+  _writes_queued.store(uint32_t(_deferred_writes.size()), std::memory_order_relaxed);
+}
+
+void storage_handler_t::set_write_concurrency_limit(uint32_t limit)
+{
+  _write_limit.store(limit, std::memory_order_relaxed);
+  _event_loop.run_in_loop([this]() { dispatch_deferred_writes(); });
+}
+
 vio::task_t<void> storage_handler_t::do_write_trees(std::vector<tree_id_t> tree_ids, std::vector<serialized_tree_t> serialized_trees,
                                                     std::function<void(std::vector<tree_id_t> &&, std::vector<storage_location_t> &&, dew_error_t &&)> done)
 {
@@ -459,6 +586,7 @@ vio::task_t<void> storage_handler_t::do_write_blob_locations_and_update_header(s
   auto serialized_stats_data = _compression_stats.serialize(stats_size);
 
   uint32_t perf_size = 0;
+  _perf_stats.sample_memory();
   auto serialized_perf_data = _perf_stats.serialize(perf_size);
 
   checkpoint_t checkpoint;
@@ -655,6 +783,11 @@ void storage_handler_t::note_source_blobs_freed(attributes_id_t attributes_id, s
   });
 }
 
+void storage_handler_t::note_duplicates_removed(uint64_t point_count)
+{
+  _event_loop.run_in_loop([this, point_count]() { _compression_stats.duplicate_points_removed += point_count; });
+}
+
 void storage_handler_t::note_blobs_uploaded(std::vector<std::pair<uint64_t, storage_location_t>> &&blobs)
 {
   // Hop to the storage loop: the residency table is single-threaded there. remote_id encodes the
@@ -26,6 +26,7 @@
 #include <vio/task.h>
 #include <vio/thread_pool.h>
 
+#include "attribute_zone.hpp"
 #include "attributes_configs.hpp"
 #include "compressor.hpp"
 #include "dataset_types.hpp"
@@ -37,6 +38,7 @@
 #include <ankerl/unordered_dense.h>
 
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <future>
 #include <limits>
@@ -60,10 +62,12 @@ struct compressed_write_data_t
   uint32_t uncompressed_size;
   double min_value = std::numeric_limits<double>::max();
   double max_value = std::numeric_limits<double>::lowest();
+  attribute_zone_t zone;
   bool is_lod = false;
 };
 
 class storage_handler_t;
+class worker_pools_t;
 
 class storage_handler_t
 {
@@ -104,6 +108,9 @@ public:
   void register_input_file_size(uint32_t file_id, uint64_t size_bytes);
   void set_compressor(compression_method_t method);
   void set_compression_level(int level);
+  // Compress each chunk on the NUMA node that first touched its buffers (worker_pools.hpp). Before any
+  // write; null keeps the shared pool.
+  void set_worker_pools(worker_pools_t *worker_pools) { _worker_pools = worker_pools; }
   void set_read_cache_size(uint64_t max_bytes) { _reader.set_read_cache_size(max_bytes); }
   void set_decompressed_cache_size(uint64_t max_bytes) { _reader.set_decompressed_cache_size(max_bytes); }
   uint64_t read_cache_current_bytes() { return _reader.read_cache_current_bytes(); }
@@ -118,6 +125,8 @@ public:
   // Leaf collapse freed a source chunk's blobs: remove their contribution from the compression stats
   // (thread-safe; hops to the storage loop where the stats live).
   void note_source_blobs_freed(attributes_id_t attributes_id, std::vector<storage_location_t> locations, uint32_t point_count);
+  // Duplicate elimination dropped points (sort worker or leaf collapse); thread-safe like the above.
+  void note_duplicates_removed(uint64_t point_count);
   // Block until every already-posted storage-loop task has run (FIFO barrier). NOT wasm-safe
   // (single-threaded); destination-mode teardown only.
   void drain_posted_events();
@@ -145,12 +154,29 @@ public:
   // Approximate (unsynchronized counters); false when no cache tier is configured.
   bool get_cache_tier_stats(cache_tier_stats_t &out) const;
 
+  // The journal records read_index replayed into the registry blob (empty for a plain blob); the tree
+  // handler takes them to resume the chain.
+  std::vector<storage_location_t> take_tree_registry_journal() { return std::move(_tree_registry_journal); }
   const compression_stats_t &get_compression_stats() const { return _compression_stats; }
   const perf_stats_t::deserialized_perf_stats_t &get_deserialized_perf_stats() const { return _deserialized_perf_stats; }
 
+  // Point writes compressing at once (0 = no limit, the default); writes over the limit wait in arrival
+  // order and start as running ones land. Thread-safe.
+  void set_write_concurrency_limit(uint32_t limit);
+  uint32_t writes_queued() const { return _writes_queued.load(std::memory_order_relaxed); }
+  uint32_t writes_running() const { return _writes_running.load(std::memory_order_relaxed); }
+
+  // The zone maps of the unit last written under `id` (one per buffer, see attribute_zone.hpp), handed
+  // over once: whoever adds the unit to a storage map takes them after the write's done callback.
+  // Empty when nothing is known. Thread-safe.
+  std::vector<attribute_zone_t> take_zone_maps(input_data_id_t id);
+
 private:
-  void handle_write_events(
-    std::tuple<storage_header_t, attributes_id_t, attribute_buffers_t, std::function<void(const storage_header_t &, attributes_id_t, std::vector<storage_location_t> &&, const dew_error_t &error)>> &&event);
+  using write_event_t =
+    std::tuple<storage_header_t, attributes_id_t, attribute_buffers_t, std::function<void(const storage_header_t &, attributes_id_t, std::vector<storage_location_t> &&, const dew_error_t &error)>>;
+  void handle_write_events(write_event_t &&event);
+  void launch_write_event(write_event_t &&event);
+  void dispatch_deferred_writes();
   void handle_write_trees(std::tuple<std::vector<tree_id_t>, std::vector<serialized_tree_t>, std::function<void(std::vector<tree_id_t> &&, std::vector<storage_location_t> &&, dew_error_t &&)>> &&event);
   void handle_write_tree_registry(serialized_tree_registry_t &&serialized_trr, std::function<void(storage_location_t, dew_error_t &&error)> &&done);
   void handle_write_blob_locations_and_update_header(storage_location_t &&new_tree_registry_location, std::vector<storage_location_t> &&old_locations, std::function<void(dew_error_t &&error)> &&done);
@@ -164,6 +190,7 @@ private:
   vio::task_t<void> do_write_blob_locations_and_update_header(storage_location_t new_tree_registry_location, std::vector<storage_location_t> old_locations, std::function<void(dew_error_t &&error)> done);
 
   vio::thread_pool_t &_thread_pool;
+  worker_pools_t *_worker_pools = nullptr;
   // Declared before every write pipe below so it outlives them: the pipes are bound to ITS event loop.
   blob_reader_t _reader;
   vio::event_loop_t &_event_loop;
@@ -176,9 +203,16 @@ private:
   std::function<void()> _on_checkpoint_request;
   std::atomic<bool> _checkpoint_requested{false};
   compression_stats_t _compression_stats;
+  std::vector<storage_location_t> _tree_registry_journal;
   perf_stats_t::deserialized_perf_stats_t _deserialized_perf_stats{};
+  std::deque<write_event_t> _deferred_writes;
+  std::atomic<uint32_t> _write_limit = 0;
+  std::atomic<uint32_t> _writes_queued = 0;
+  std::atomic<uint32_t> _writes_running = 0; // written on the storage loop only
   std::set<uint32_t> _seen_input_files;
   ankerl::unordered_dense::map<uint32_t, uint64_t> _input_file_sizes;
+  std::mutex _zone_maps_mutex;
+  ankerl::unordered_dense::map<input_data_id_t, std::vector<attribute_zone_t>, input_data_id_hash_t> _zone_maps;
 
   vio::event_pipe_t<void> &_index_written;
   vio::event_pipe_t<dew_error_t> &_storage_error;
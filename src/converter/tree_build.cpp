@@ -50,6 +50,51 @@ static tree_t &tree_cache_add_tree(tree_registry_t &tree_cache, tree_t *(&parent
   return *tree_cache.data.back();
 }
 
+// Where an insert walk finds and creates trees. The coordinator walks without a shard and works on the
+// registry directly. A shard walk runs on a pool thread next to other shards: the registry is read-only
+// then, so trees it creates take ids from the plan's counter and stay in the shard until
+// tree_merge_shards moves them in.
+struct tree_build_context_t
+{
+  tree_registry_t &registry;
+  tree_shard_plan_t *plan = nullptr;
+  tree_shard_t *shard = nullptr;
+
+  tree_t *get(tree_id_t id)
+  {
+    if (shard && id.data >= plan->base_id)
+    {
+      auto it = shard->created.find(id.data);
+      assert(it != shard->created.end() && "a shard only reaches the trees below its own subtree");
+      return it->second.get();
+    }
+    return registry.get(id);
+  }
+
+  tree_t &add_tree(tree_t *(&parent))
+  {
+    if (!shard)
+      return tree_cache_add_tree(registry, parent);
+    uint32_t id = plan->next_id.fetch_add(1, std::memory_order_relaxed);
+    auto &tree = shard->created[id];
+    tree.reset(new tree_t());
+    tree->id.data = id;
+    return *tree;
+  }
+
+  bool is_building(tree_id_t id) const
+  {
+    if (shard && id.data >= plan->base_id)
+      return true;
+    return registry.tree_state[id.data] == uint8_t(tree_state_t::building);
+  }
+
+  uint32_t current_id() const
+  {
+    return shard ? plan->next_id.load(std::memory_order_relaxed) : registry.current_id;
+  }
+};
+
 tree_id_t tree_initialize(tree_registry_t &tree_registry, storage_handler_t &cache, const storage_header_t &header, attributes_id_t attributes, std::vector<storage_location_t> &&locations)
 {
   tree_t &tree = tree_cache_create_root_tree(tree_registry);
@@ -173,11 +218,15 @@ static void sub_tree_split_points_to_children(storage_handler_t &cache, input_st
   points = points_collection_t();
 }
 
-static void move_storage_locations_to_subtree(tree_registry_t &tree_cache, const points_collection_t &collection, tree_t &parent, tree_t &sub_tree)
+static void move_storage_locations_to_subtree(tree_build_context_t &ctx, const points_collection_t &collection, tree_t &parent, tree_t &sub_tree)
 {
   for (auto &p : collection.data)
   {
     const bool parent_had = parent.storage_map.contains(p.input_id);
+    // Zone maps travel with the entry; take them before dereference can erase it from the parent.
+    std::vector<attribute_zone_t> zones;
+    if (const auto *parent_zones = parent.storage_map.zones(p.input_id); parent_zones && !sub_tree.storage_map.contains(p.input_id))
+      zones = *parent_zones;
     auto attrib_locations_pair = parent.storage_map.dereference(p.input_id);
     const bool parent_erased = parent_had && !parent.storage_map.contains(p.input_id);
     bool child_created = false;
@@ -190,15 +239,25 @@ static void move_storage_locations_to_subtree(tree_registry_t &tree_cache, const
     else
     {
       sub_tree.storage_map.add_storage(p.input_id, attrib_locations_pair.first, std::move(attrib_locations_pair.second));
+      if (!zones.empty())
+        sub_tree.storage_map.set_zones(p.input_id, std::move(zones));
       child_created = true;
     }
     // Registry-global chunk lifetime: +1 when a tree map gains the unit, -1 when one loses it
     // (net zero for a plain hand-off). LOD/collapsed units are per-tree, never tracked.
     if (input_data_id_is_leaf(p.input_id) && !input_data_id_is_collapsed_leaf(p.input_id))
     {
-      auto refs = tree_cache.chunk_tree_refs.find(p.input_id);
-      if (refs != tree_cache.chunk_tree_refs.end())
+      auto refs = ctx.registry.chunk_tree_refs.find(p.input_id);
+      if (refs != ctx.registry.chunk_tree_refs.end())
       {
+        if (ctx.shard)
+        {
+          // The table is read-only while shards run; tree_merge_shards applies the net change.
+          const int32_t delta = int32_t(child_created) - int32_t(parent_erased);
+          if (delta)
+            ctx.shard->chunk_ref_deltas[p.input_id] += delta;
+          continue;
+        }
         if (child_created)
           refs->second.tree_count++;
         if (parent_erased)
@@ -213,17 +272,17 @@ static void move_storage_locations_to_subtree(tree_registry_t &tree_cache, const
   }
 }
 
-static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_t &cache, tree_id_t tree_id, const morton::morton192_t &min, int current_level, int skip, uint16_t current_name,
+static void sub_tree_insert_points(tree_build_context_t &ctx, storage_handler_t &cache, tree_id_t tree_id, const morton::morton192_t &min, int current_level, int skip, uint16_t current_name,
                                    points_collection_t &&points) // NOLINT(*-no-recursion)
 {
-  auto *tree = tree_cache.get(tree_id);
+  auto *tree = ctx.get(tree_id);
   // A finalized tree is immutable: its morton_max was proven below a committed done-morton
   // watermark, so no input may route points into it ever again. Hitting this assert means the
   // watermark overclaimed (registry ordering bug) -- fail loudly instead of corrupting a tree the
   // upload/eviction tiers treat as frozen.
-  assert(tree_cache.tree_state[tree_id.data] == uint8_t(tree_state_t::building) && "point insert into finalized tree");
+  assert(ctx.is_building(tree_id) && "point insert into finalized tree");
   tree->is_dirty = true;
-  assert(tree->id.data < tree_cache.current_id);
+  assert(tree->id.data < ctx.current_id());
   assert(current_level != 0 || tree->morton_min == min);
   assert(tree->mins[current_level][skip] == min);
   assert(tree->node_ids[current_level][skip] == current_name);
@@ -249,14 +308,14 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
       {
         uint16_t sub_tree_name = morton::morton_get_name(0, 0, child_mask);
         auto sub_tree_id = tree->sub_trees[sub_skip];
-        auto *sub_tree = tree_cache.get(sub_tree_id);
-        move_storage_locations_to_subtree(tree_cache, points, *tree, *sub_tree);
-        sub_tree_insert_points(tree_cache, cache, sub_tree_id, new_min, 0, 0, sub_tree_name, std::move(points));
+        auto *sub_tree = ctx.get(sub_tree_id);
+        move_storage_locations_to_subtree(ctx, points, *tree, *sub_tree);
+        sub_tree_insert_points(ctx, cache, sub_tree_id, new_min, 0, 0, sub_tree_name, std::move(points));
       }
       else
       {
         auto child_name = morton::morton_get_name(current_name, current_level + 1, child_mask);
-        sub_tree_insert_points(tree_cache, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(points));
+        sub_tree_insert_points(ctx, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(points));
       }
       return;
     }
@@ -266,13 +325,13 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
 
       if (current_level == 4)
       {
-        auto &sub_tree = tree_cache_add_tree(tree_cache, tree);
+        auto &sub_tree = ctx.add_tree(tree);
         tree->sub_trees.emplace(tree->sub_trees.begin() + sub_skip, sub_tree.id);
         sub_tree_increase_skips(*tree, current_level, skip);
-        tree_initialize_sub(*tree, tree_cache, points.min, sub_tree);
+        tree_initialize_sub(*tree, ctx.registry, points.min, sub_tree);
         uint16_t sub_tree_name = morton::morton_get_name(0, 0, child_mask);
-        move_storage_locations_to_subtree(tree_cache, points, *tree, sub_tree);
-        sub_tree_insert_points(tree_cache, cache, sub_tree.id, new_min, 0, 0, sub_tree_name, std::move(points));
+        move_storage_locations_to_subtree(ctx, points, *tree, sub_tree);
+        sub_tree_insert_points(ctx, cache, sub_tree.id, new_min, 0, 0, sub_tree_name, std::move(points));
       }
       else
       {
@@ -284,13 +343,13 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
         tree->mins[current_level + 1][sub_skip] = new_min;
         assert((new_min.data[0] & 1) == 0);
 #endif
-        sub_tree_insert_points(tree_cache, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(points));
+        sub_tree_insert_points(ctx, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(points));
       }
       return;
     }
   }
 
-  if (node == 0 && tree->data[current_level][skip].point_count + points.point_count <= tree_cache.node_limit)
+  if (node == 0 && tree->data[current_level][skip].point_count + points.point_count <= ctx.registry.node_limit)
   {
     assert(!(points.min < min));
     points_data_add(tree->data[current_level][skip], std::move(points));
@@ -325,7 +384,7 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
       morton::morton_set_child_mask(lod, uint8_t(i), new_min);
       assert(child_data.min_lod <= lod);
 
-      tree = tree_cache.get(tree_id);
+      tree = ctx.get(tree_id);
       int sub_skip = tree->skips[current_level][skip] + child_count;
 
       if (current_level == 4)
@@ -334,18 +393,18 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
         if (!has_this_child)
         {
           node |= uint8_t(1) << i;
-          auto &sub_tree = tree_cache_add_tree(tree_cache, tree);
+          auto &sub_tree = ctx.add_tree(tree);
           tree->sub_trees.emplace(tree->sub_trees.begin() + sub_skip, sub_tree.id);
           sub_tree_increase_skips(*tree, current_level, skip);
-          tree_initialize_sub(*tree, tree_cache, child_data.min, sub_tree);
-          move_storage_locations_to_subtree(tree_cache, child_data, *tree, sub_tree);
-          sub_tree_insert_points(tree_cache, cache, sub_tree.id, new_min, 0, 0, sub_tree_name, std::move(child_data));
+          tree_initialize_sub(*tree, ctx.registry, child_data.min, sub_tree);
+          move_storage_locations_to_subtree(ctx, child_data, *tree, sub_tree);
+          sub_tree_insert_points(ctx, cache, sub_tree.id, new_min, 0, 0, sub_tree_name, std::move(child_data));
         }
         else
         {
-          tree_t *sub_tree = tree_cache.get(tree->sub_trees[sub_skip]);
-          move_storage_locations_to_subtree(tree_cache, child_data, *tree, *sub_tree);
-          sub_tree_insert_points(tree_cache, cache, sub_tree->id, new_min, 0, 0, sub_tree_name, std::move(child_data));
+          tree_t *sub_tree = ctx.get(tree->sub_trees[sub_skip]);
+          move_storage_locations_to_subtree(ctx, child_data, *tree, *sub_tree);
+          sub_tree_insert_points(ctx, cache, sub_tree->id, new_min, 0, 0, sub_tree_name, std::move(child_data));
         }
       }
       else
@@ -353,7 +412,7 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
         auto child_name = morton::morton_get_name(current_name, current_level + 1, i);
         if (has_this_child)
         {
-          sub_tree_insert_points(tree_cache, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(child_data));
+          sub_tree_insert_points(ctx, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(child_data));
         }
         else
         {
@@ -365,7 +424,7 @@ static void sub_tree_insert_points(tree_registry_t &tree_cache, storage_handler_
           tree->mins[current_level + 1][sub_skip] = new_min;
           assert((new_min.data[0] & 1) == 0);
 #endif
-          sub_tree_insert_points(tree_cache, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(child_data));
+          sub_tree_insert_points(ctx, cache, tree_id, new_min, current_level + 1, sub_skip, child_name, std::move(child_data));
         }
       }
       child_count++;
@@ -451,29 +510,173 @@ static tree_id_t reparent_tree(tree_registry_t &tree_registry, tree_id_t tree_id
   return new_parent.id;
 }
 
-tree_id_t tree_add_points(tree_registry_t &tree_registry, storage_handler_t &cache, const tree_id_t &tree_id, const storage_header_t &header, attributes_id_t attributes_id, std::vector<storage_location_t> &&locations)
+// Reparent when the chunk falls outside the root, then hand the chunk's storage to the root. Returns the
+// chunk's points collection, ready to insert from the (possibly new) root.
+static points_collection_t add_chunk_to_root(tree_registry_t &tree_registry, storage_handler_t &cache, tree_id_t &root_id, const storage_header_t &header, attributes_id_t attributes_id,
+                                             std::vector<storage_location_t> &&locations)
 {
-  tree_id_t ret = tree_id;
-  auto *tree = tree_registry.get(tree_id);
+  auto *tree = tree_registry.get(root_id);
   // assert(validate_points_offset(header));
   if (header.morton_min < tree->morton_min || header.morton_max > tree->morton_max)
   {
-    ret = reparent_tree(tree_registry, tree_id, header.morton_min, header.morton_max);
-    tree = tree_registry.get(ret);
+    root_id = reparent_tree(tree_registry, root_id, header.morton_min, header.morton_max);
+    tree = tree_registry.get(root_id);
   }
 
   points_collection_t points_data;
   points_data_initialize(points_data, header);
-  auto min = tree->morton_min;
-  uint16_t name = morton::morton_get_name(0, 0, morton::morton_get_child_mask(morton::morton_magnitude_to_lod(tree->magnitude) + 1, points_data.min));
-  assert(name == tree->node_ids[0][0]);
   tree->storage_map.add_storage(header.input_id, attributes_id, std::move(locations));
+  if (auto zones = cache.take_zone_maps(header.input_id); !zones.empty())
+    tree->storage_map.set_zones(header.input_id, std::move(zones));
   // Registry-global chunk lifetime: this tree's map now holds the chunk unit. Subtree moves
   // adjust the count; collapse frees the chunk's blobs when it drops to zero.
   if (input_data_id_is_leaf(header.input_id) && !input_data_id_is_collapsed_leaf(header.input_id))
     tree_registry.chunk_tree_refs[header.input_id] = {1, uint32_t(header.point_count)};
   tree->leaves_collapsed = false; // fresh subset-shaped leaf data
-  sub_tree_insert_points(tree_registry, cache, tree->id, min, 0, 0, name, std::move(points_data));
+  return points_data;
+}
+
+static void insert_from_root(tree_build_context_t &ctx, storage_handler_t &cache, tree_id_t root_id, points_collection_t &&points)
+{
+  auto *tree = ctx.get(root_id);
+  auto min = tree->morton_min;
+  uint16_t name = morton::morton_get_name(0, 0, morton::morton_get_child_mask(morton::morton_magnitude_to_lod(tree->magnitude) + 1, points.min));
+  assert(name == tree->node_ids[0][0]);
+  sub_tree_insert_points(ctx, cache, tree->id, min, 0, 0, name, std::move(points));
+}
+
+tree_id_t tree_add_points(tree_registry_t &tree_registry, storage_handler_t &cache, const tree_id_t &tree_id, const storage_header_t &header, attributes_id_t attributes_id, std::vector<storage_location_t> &&locations)
+{
+  tree_id_t ret = tree_id;
+  auto points_data = add_chunk_to_root(tree_registry, cache, ret, header, attributes_id, std::move(locations));
+  tree_build_context_t ctx{tree_registry};
+  insert_from_root(ctx, cache, ret, std::move(points_data));
   return ret;
 }
+
+// Follow the chunk down the root's own five levels. When the whole chunk falls below one level-4 child,
+// that top-level subtree (created if the level-4 node exists but the child does not) takes over the
+// chunk's storage and its id is returned through sub_tree_id. Anything else -- the chunk spans several
+// children, or stops in one of the root's own nodes -- returns false with the root untouched.
+static bool route_to_subtree(tree_build_context_t &ctx, tree_id_t root_id, const points_collection_t &points, tree_id_t &sub_tree_id)
+{
+  tree_t *tree = ctx.registry.get(root_id);
+  if (tree->magnitude == 0)
+    return false;
+  int skip = 0;
+  for (int level = 0; level < 5; level++)
+  {
+    int lod = morton::morton_tree_level_to_lod(tree->magnitude, level);
+    auto &node = tree->nodes[level][skip];
+    if (lod <= points.min_lod || !node)
+      return false;
+    auto child_mask = morton::morton_get_child_mask(lod, points.min);
+    int sub_skip = tree->skips[level][skip] + sub_tree_count_skips(node, child_mask);
+    const bool has_child = node & (1 << child_mask);
+    if (level < 4)
+    {
+      if (!has_child)
+        return false;
+      skip = sub_skip;
+      continue;
+    }
+    if (has_child)
+    {
+      sub_tree_id = tree->sub_trees[sub_skip];
+    }
+    else
+    {
+      node |= uint8_t(1) << child_mask;
+      auto &sub_tree = tree_cache_add_tree(ctx.registry, tree);
+      tree->sub_trees.emplace(tree->sub_trees.begin() + sub_skip, sub_tree.id);
+      sub_tree_increase_skips(*tree, level, skip);
+      tree_initialize_sub(*tree, ctx.registry, points.min, sub_tree);
+      sub_tree_id = sub_tree.id;
+    }
+    tree->is_dirty = true;
+    move_storage_locations_to_subtree(ctx, points, *tree, *ctx.registry.get(sub_tree_id));
+    return true;
+  }
+  return false;
+}
+
+size_t tree_plan_shards(tree_registry_t &tree_registry, storage_handler_t &cache, std::vector<tree_insert_t> &inserts, size_t begin, tree_shard_plan_t &plan)
+{
+  assert(plan.shards.empty());
+  tree_build_context_t ctx{tree_registry};
+  ankerl::unordered_dense::map<uint32_t, size_t> shard_index;
+  size_t i = begin;
+  for (; i < inserts.size(); i++)
+  {
+    auto &insert = inserts[i];
+    auto *root = tree_registry.get(tree_registry.root);
+    // A new root would own the subtrees the queued shards were given: run those first.
+    const bool reparents = insert.header.morton_min < root->morton_min || insert.header.morton_max > root->morton_max;
+    if (reparents && !plan.shards.empty())
+      break;
+    auto points = add_chunk_to_root(tree_registry, cache, tree_registry.root, insert.header, insert.attributes_id, std::move(insert.locations));
+    tree_id_t sub_tree_id;
+    if (!route_to_subtree(ctx, tree_registry.root, points, sub_tree_id))
+    {
+      insert_from_root(ctx, cache, tree_registry.root, std::move(points));
+      continue;
+    }
+    auto [it, inserted] = shard_index.try_emplace(sub_tree_id.data, plan.shards.size());
+    if (inserted)
+    {
+      plan.shards.emplace_back();
+      plan.shards.back().tree_id = sub_tree_id;
+    }
+    plan.shards[it->second].inserts.push_back(std::move(points));
+  }
+  plan.base_id = tree_registry.current_id;
+  plan.next_id.store(plan.base_id, std::memory_order_relaxed);
+  return i;
+}
+
+void tree_shard_insert(tree_registry_t &tree_registry, storage_handler_t &cache, tree_shard_plan_t &plan, tree_shard_t &shard)
+{
+  tree_build_context_t ctx{tree_registry, &plan, &shard};
+  for (auto &points : shard.inserts)
+  {
+    auto *tree = tree_registry.get(shard.tree_id);
+    auto min = tree->morton_min;
+    auto name = tree->node_ids[0][0];
+    sub_tree_insert_points(ctx, cache, shard.tree_id, min, 0, 0, name, std::move(points));
+  }
+  shard.inserts.clear();
+}
+
+void tree_merge_shards(tree_registry_t &tree_registry, tree_shard_plan_t &plan)
+{
+  assert(tree_registry.current_id == plan.base_id && tree_registry.data.size() == plan.base_id);
+  const uint32_t end_id = plan.next_id.load(std::memory_order_relaxed);
+  tree_registry.data.resize(end_id);
+  for (uint32_t id = plan.base_id; id < end_id; id++)
+  {
+    tree_registry.locations.emplace_back();
+    tree_registry.tree_id_initialized.push_back(1);
+    tree_registry.tree_state.push_back(uint8_t(tree_state_t::building));
+    tree_registry.tree_band.push_back(tree_band_none);
+  }
+  tree_registry.current_id = end_id;
+
+  for (auto &shard : plan.shards)
+  {
+    for (auto &[id, tree] : shard.created)
+      tree_registry.data[id] = std::move(tree);
+    for (auto &[input_id, delta] : shard.chunk_ref_deltas)
+    {
+      auto refs = tree_registry.chunk_tree_refs.find(input_id);
+      assert(refs != tree_registry.chunk_tree_refs.end());
+      refs->second.tree_count = uint32_t(int64_t(refs->second.tree_count) + delta);
+      assert(refs->second.tree_count > 0 && "a subtree still references the unit");
+    }
+  }
+#ifndef NDEBUG
+  for (uint32_t id = plan.base_id; id < end_id; id++)
+    assert(tree_registry.data[id] && "every id taken from the plan's counter belongs to a created tree");
+#endif
+  plan.shards.clear();
+}
 } // namespace dew::converter
@@ -28,6 +28,8 @@
 
 #include "tree.hpp"
 
+#include <atomic>
+
 namespace dew::converter
 {
 using namespace dew::core;
@@ -40,4 +42,44 @@ tree_id_t tree_initialize(tree_registry_t &tree_registry, storage_handler_t &cac
 // root) reparenting as needed. Returns the possibly-new root id.
 tree_id_t tree_add_points(tree_registry_t &tree_registry, storage_handler_t &cache, const tree_id_t &tree_id, const storage_header_t &header, attributes_id_t attributes_id, std::vector<storage_location_t> &&locations);
 
+// Sharded insertion. The tree loop is the single writer of the registry, so a batch of sorted chunks
+// is split in three steps:
+//  - tree_plan_shards (tree loop): reparenting, the root's own nodes and the top-level subtrees stay with
+//    the caller. Each chunk that falls wholly below one level-4 child of the root is queued on that
+//    subtree's shard; the rest are inserted right away. Planning stops before a chunk that would
+//    reparent the root while shards are queued.
+//  - tree_shard_insert (any thread, one call per shard, concurrently): inserts a shard's chunks into
+//    its subtree. Shards own disjoint trees and only read the registry.
+//  - tree_merge_shards (tree loop, after every shard ran): moves the trees the shards created into the
+//    registry and applies their chunk-reference changes.
+struct tree_insert_t
+{
+  storage_header_t header;
+  attributes_id_t attributes_id;
+  std::vector<storage_location_t> locations;
+};
+
+struct tree_shard_t
+{
+  tree_id_t tree_id; // a top-level subtree of the root
+  std::vector<points_collection_t> inserts;
+  ankerl::unordered_dense::map<uint32_t, std::unique_ptr<tree_t>> created;
+  ankerl::unordered_dense::map<input_data_id_t, int32_t, input_data_id_hash_t> chunk_ref_deltas;
+};
+
+struct tree_shard_plan_t
+{
+  std::vector<tree_shard_t> shards;
+  uint32_t base_id = 0;              // the registry's current_id when planning finished
+  std::atomic<uint32_t> next_id{0};  // ids for trees the shards create
+};
+
+// Plan inserts[begin..] against tree_registry.root (which must exist). Returns the index of the first
+// insert not consumed.
+size_t tree_plan_shards(tree_registry_t &tree_registry, storage_handler_t &cache, std::vector<tree_insert_t> &inserts, size_t begin, tree_shard_plan_t &plan);
+
+void tree_shard_insert(tree_registry_t &tree_registry, storage_handler_t &cache, tree_shard_plan_t &plan, tree_shard_t &shard);
+
+void tree_merge_shards(tree_registry_t &tree_registry, tree_shard_plan_t &plan);
+
 } // namespace dew::converter
@@ -20,11 +20,14 @@
 #include "attributes_configs.hpp"
 #include "input_header.hpp"
 #include "morton_tree_coordinate_transform.hpp"
+#include "point_dedup.hpp"
 #include "storage_handler.hpp"
+#include "worker_pools.hpp"
 
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <limits>
 
 namespace dew::converter
 {
@@ -118,6 +121,46 @@ void tree_collapse_runner_t::collapse_for_pass(const morton::morton192_t &target
 
   if (std::getenv("DEW_DEBUG_CHAIN"))
     fprintf(stderr, "[collapse] pass target=%llx jobs=%zu\n", (unsigned long long)target.data[0], _jobs.size());
+  start_jobs(std::move(on_done));
+}
+
+void tree_collapse_runner_t::subtract_from_leaves(std::vector<leaf_subtraction_t> &&subtractions, std::function<void()> on_done)
+{
+  assert(_jobs.empty() && "one collapse pass at a time");
+  for (auto &subtraction : subtractions)
+  {
+    if (subtraction.remove.empty())
+      continue;
+    auto *tree = _tree_registry.get(subtraction.tree_id);
+    assert(tree && "edited trees are loaded before the edit touches them");
+    auto &collection = tree->data[subtraction.level][subtraction.node_index];
+    if (std::none_of(collection.data.begin(), collection.data.end(), [](const points_subset_t &subset) { return input_data_id_is_collapsed_leaf(subset.input_id); }))
+      continue;
+    // Any other subsets (chunks of a later input) are merged in as well: the rewritten leaf is collapsed.
+    collapse_job_t job;
+    job.tree_id = subtraction.tree_id;
+    job.level = subtraction.level;
+    job.node_index = subtraction.node_index;
+    job.new_id = next_collapsed_id(_tree_registry);
+    job.collection = collection;
+    for (auto &subset : collection.data)
+    {
+      if (job.sources.contains(subset.input_id))
+        continue;
+      auto info = tree->storage_map.info(subset.input_id);
+      job.sources[subset.input_id] = {info.first, std::move(info.second)};
+    }
+    job.remove = std::move(subtraction.remove);
+    std::sort(job.remove.begin(), job.remove.end());
+    _jobs.push_back(std::move(job));
+  }
+  if (std::getenv("DEW_DEBUG_CHAIN"))
+    fprintf(stderr, "[collapse] subtract jobs=%zu\n", _jobs.size());
+  start_jobs(std::move(on_done));
+}
+
+void tree_collapse_runner_t::start_jobs(std::function<void()> on_done)
+{
   if (_jobs.empty())
   {
     on_done();
@@ -133,7 +176,8 @@ void tree_collapse_runner_t::collapse_for_pass(const morton::morton192_t &target
   for (auto &job : _jobs)
   {
     auto *job_ptr = &job;
-    _thread_pool.enqueue([this, job_ptr] { merge_worker(*job_ptr); });
+    auto &pool = _worker_pools ? _worker_pools->pool_for_tree(job.tree_id) : _thread_pool;
+    pool.enqueue([this, job_ptr] { merge_worker(*job_ptr); });
   }
 }
 
@@ -162,10 +206,10 @@ void append_absolute(const read_only_points_t &points, uint32_t subset_index, co
 }
 
 template <typename D_M>
-std::unique_ptr<uint8_t[]> make_destination_morton(const std::vector<merge_entry_t> &entries, uint32_t &size)
+point_buffer_t make_destination_morton(const std::vector<merge_entry_t> &entries, uint32_t &size)
 {
   size = uint32_t(entries.size() * sizeof(D_M));
-  auto buffer = std::make_unique<uint8_t[]>(size);
+  auto buffer = point_buffer_pool().acquire(size);
   auto *out = reinterpret_cast<D_M *>(buffer.get());
   for (size_t i = 0; i < entries.size(); i++)
     morton::morton_downcast(entries[i].absolute, out[i]);
@@ -228,6 +272,81 @@ void tree_collapse_runner_t::merge_worker(collapse_job_t &job)
   //    subset order as the tie-break for equal codes (duplicate points).
   std::stable_sort(entries.begin(), entries.end(), [](const merge_entry_t &a, const merge_entry_t &b) { return a.absolute < b.absolute; });
 
+  // 2b. Input removal: multiset difference against the sorted removal codes. A leaf none of them
+  //     lands in keeps its unit (nothing is written); one they empty is cleared by apply_results.
+  if (!job.remove.empty())
+  {
+    size_t kept = 0;
+    size_t remove_index = 0;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+      while (remove_index < job.remove.size() && job.remove[remove_index] < entries[i].absolute)
+        remove_index++;
+      if (remove_index < job.remove.size() && job.remove[remove_index] == entries[i].absolute)
+      {
+        remove_index++;
+        continue;
+      }
+      entries[kept++] = entries[i];
+    }
+    if (kept == entries.size())
+    {
+      finish();
+      return;
+    }
+    entries.resize(kept);
+    if (entries.empty())
+    {
+      job.emptied = true;
+      finish();
+      return;
+    }
+  }
+
+  // 2c. Duplicate elimination across chunks (point_dedup.hpp): the sort worker only saw one chunk at a
+  //     time, so a run here can span subsets. Merge order (subset order, then position) is the input
+  //     order for the first/last policies; the policy attribute is read per source unit on demand.
+  const auto &tree_config = _tree_registry.tree_config;
+  if (tree_config.dedup_enabled && entries.size() > 1)
+  {
+    struct value_source_t
+    {
+      std::unique_ptr<read_attribute_t> read;
+      point_format_t format = {};
+    };
+    const auto keep = dedup_keep_t(tree_config.dedup_keep);
+    const char *value_name = dedup_keep_attribute(keep);
+    ankerl::unordered_dense::map<input_data_id_t, value_source_t, input_data_id_hash_t> value_sources;
+    auto value = [&](size_t i) -> double {
+      const auto unit_id = job.collection.data[entries[i].subset_index].input_id;
+      auto [it, inserted] = value_sources.try_emplace(unit_id);
+      auto &source = it->second;
+      if (inserted)
+      {
+        auto &info = job.sources.at(unit_id);
+        auto value_index = _attributes_configs.get_attribute_index(info.attributes_id, value_name);
+        if (value_index.index > 0 && size_t(value_index.index) < info.locations.size())
+        {
+          source.read = std::make_unique<read_attribute_t>(_storage, info.locations[value_index.index]);
+          source.format = value_index.format;
+          if (source.read->error.code != 0)
+            source.read.reset();
+        }
+      }
+      // A unit without the attribute (or whose read failed) ranks below any that has it.
+      if (!source.read)
+        return std::numeric_limits<double>::lowest();
+      return dedup_attribute_value(static_cast<const uint8_t *>(source.read->data.data), source.format, entries[i].source_index);
+    };
+    const int grid_lod = tree_config.dedup_grid_lod;
+    size_t kept = 0;
+    job.duplicates_removed = dedup_sorted_runs(
+      entries.size(), keep, value_name != nullptr, [&entries, grid_lod](size_t a, size_t b) { return dedup_same_cell(entries[a].absolute, entries[b].absolute, grid_lod); },
+      [](size_t i) { return uint64_t(i); }, value, [&entries, &kept](size_t i) { entries[kept++] = entries[i]; });
+    entries.resize(kept);
+  }
+  job.generated_point_count = uint32_t(entries.size());
+
   // 3. Destination format: the sorter's exact rule -- lod span of [min, max] picks the narrowest
   //    morton type whose truncation is lossless for every point in the unit.
   job.generated_min = entries.front().absolute;
@@ -235,7 +354,7 @@ void tree_collapse_runner_t::merge_worker(collapse_job_t &job)
   const int lod_span = morton::morton_lod(job.generated_min, job.generated_max);
   const dew_type_t destination_type = morton_type_from_lod(lod_span);
   uint32_t morton_buffer_size = 0;
-  std::unique_ptr<uint8_t[]> morton_buffer;
+  point_buffer_t morton_buffer;
   switch (destination_type)
   {
   case dew_type_m32:
@@ -315,7 +434,9 @@ void tree_collapse_runner_t::apply_results()
     assert(tree && "collapsed trees stay loaded for the duration of the pass");
     if (std::getenv("DEW_DEBUG_CHAIN"))
       fprintf(stderr, "[collapse] apply tree=%u level=%d idx=%u failed=%d locations=%zu\n", job.tree_id.data, job.level, job.node_index, int(job.failed), job.generated_locations.size());
-    if (job.failed || job.generated_locations.empty())
+    // The rewritten unit's zone maps, claimed even when the unit is not applied so none are left behind.
+    auto zones = _storage.take_zone_maps(job.new_id);
+    if (job.failed || (job.generated_locations.empty() && !job.emptied))
       continue; // leaf keeps its subsets; the tree stays building and is retried next pass
 
     tree->is_dirty = true;
@@ -333,6 +454,13 @@ void tree_collapse_runner_t::apply_results()
       const bool had = tree->storage_map.contains(id);
       auto attrib_locations = tree->storage_map.dereference(id);
       const bool erased = had && !tree->storage_map.contains(id);
+      if (erased && input_data_id_is_collapsed_leaf(id))
+      {
+        // A collapsed unit rewritten without a removed input's points: units are per tree, so it is dead.
+        _storage.note_source_blobs_freed(attrib_locations.first, attrib_locations.second, subset.count.data);
+        tree->storage_map.restore_discarded(std::move(attrib_locations.second));
+        continue;
+      }
       if (!erased || !input_data_id_is_leaf(id) || input_data_id_is_collapsed_leaf(id))
         continue;
       auto refs = _tree_registry.chunk_tree_refs.find(id);
@@ -349,25 +477,37 @@ void tree_collapse_runner_t::apply_results()
       }
     }
 
+    if (job.emptied)
+    {
+      collection = points_collection_t();
+      job.applied = true;
+      continue;
+    }
     tree->storage_map.add_storage(job.new_id, job.generated_attributes_id, std::move(job.generated_locations));
+    if (!zones.empty())
+      tree->storage_map.set_zones(job.new_id, std::move(zones));
     collection.data.clear();
-    collection.data.emplace_back(job.new_id, offset_in_subset_t(0), point_count_t(uint32_t(job.collection.point_count)));
+    collection.point_count = job.generated_point_count;
+    collection.data.emplace_back(job.new_id, offset_in_subset_t(0), point_count_t(job.generated_point_count));
     collection.min = job.generated_min;
     collection.max = job.generated_max;
     collection.min_lod = morton::morton_lod(collection.min, collection.max);
+    if (job.duplicates_removed)
+      _storage.note_duplicates_removed(job.duplicates_removed);
     job.applied = true;
   }
 
-  // A tree is collapsed when every leaf now has collapsed shape (failed jobs leave it building).
+  // A tree is collapsed when every leaf now has collapsed shape (failed jobs leave it building). A
+  // subtraction job that found nothing to drop is not a failure.
   ankerl::unordered_dense::map<uint32_t, bool, ankerl::unordered_dense::hash<uint32_t>> touched;
   for (auto &job : _jobs)
-    touched[job.tree_id.data] = touched[job.tree_id.data] || !job.applied;
+    touched[job.tree_id.data] = touched[job.tree_id.data] || job.failed || (!job.applied && job.remove.empty());
   for (auto &[tree_id, any_failed] : touched)
   {
     if (std::getenv("DEW_DEBUG_CHAIN"))
       fprintf(stderr, "[collapse] tree=%u failed=%d\n", tree_id, int(any_failed));
     if (!any_failed)
-      _tree_registry.get(tree_id_t(tree_id))->leaves_collapsed = true;
+      tree_compute_leaves_collapsed(*_tree_registry.get(tree_id_t(tree_id)), _tree_registry);
   }
 
   _jobs.clear();
@@ -50,6 +50,7 @@ namespace dew::converter
 {
 using namespace dew::core;
 class storage_handler_t;
+class worker_pools_t;
 
 struct collapse_job_t
 {
@@ -59,15 +60,32 @@ struct collapse_job_t
   input_data_id_t new_id;
   points_collection_t collection;  // snapshot of the leaf's subsets (the leaf is immutable)
   child_storage_map_t sources;     // unit id -> {attributes_id, locations}
+  // Input removal: absolute codes of points to drop from the merged leaf (sorted; a multiset -- each
+  // code drops one matching point). Empty for a plain collapse.
+  std::vector<morton::morton192_t> remove;
   // Worker outputs:
   attributes_id_t generated_attributes_id = {};
   std::vector<storage_location_t> generated_locations;
   morton::morton192_t generated_min = {};
   morton::morton192_t generated_max = {};
+  uint32_t generated_point_count = 0;
+  uint64_t duplicates_removed = 0; // duplicate elimination across the merged subsets
   bool failed = false;
+  bool emptied = false; // `remove` took every point: nothing was written, the leaf is cleared
   bool applied = false; // set by apply_results after the tree consumed the outputs
 };
 
+// A collapsed leaf that holds points of a removed input (see tree_handler_t::strip_input).
+struct leaf_subtraction_t
+{
+  tree_id_t tree_id;
+  int level;
+  uint32_t node_index;
+  morton::morton192_t min;
+  morton::morton192_t max;
+  std::vector<morton::morton192_t> remove;
+};
+
 class tree_collapse_runner_t
 {
 public:
@@ -79,14 +97,27 @@ public:
   // on_done exactly once -- synchronously when there is nothing to collapse.
   void collapse_for_pass(const morton::morton192_t &target, std::function<void()> on_done);
 
+  // Tree loop only; never concurrent with a pass. Rewrites each leaf holding a collapsed unit without the
+  // listed points (same merge worker, same apply), then calls on_done exactly once. Leaves that lost
+  // nothing keep their subsets.
+  void subtract_from_leaves(std::vector<leaf_subtraction_t> &&subtractions, std::function<void()> on_done);
+
   void merge_worker(collapse_job_t &job); // pool thread
 
+  // Merge each subtree's leaves on its NUMA node's pool (worker_pools.hpp); null = the shared pool.
+  void set_worker_pools(worker_pools_t *worker_pools)
+  {
+    _worker_pools = worker_pools;
+  }
+
 private:
+  void start_jobs(std::function<void()> on_done);
   void handle_worker_done();
   void apply_results();
 
   vio::event_loop_t &_event_loop;
   vio::thread_pool_t &_thread_pool;
+  worker_pools_t *_worker_pools = nullptr;
   tree_registry_t &_tree_registry;
   storage_handler_t &_storage;
   attributes_configs_t &_attributes_configs;
@@ -21,11 +21,13 @@
 
 #include "tree_lod_generator.hpp"
 
+#include "hierarchy_directory.hpp"
 #include "morton_tree_coordinate_transform.hpp"
 #include "storage_handler.hpp"
 
 #include "loop_quiesce.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 
@@ -110,6 +112,7 @@ tree_handler_t::tree_handler_t(vio::thread_pool_t &thread_pool, storage_handler_
   , _request_aabb(_event_loop, bind(&tree_handler_t::handle_request_aabb))
   , _request_root(_event_loop, bind(&tree_handler_t::handle_request_root))
   , _request_trees_batch(_event_loop, bind(&tree_handler_t::handle_request_trees_batch))
+  , subtract_points(_event_loop, bind(&tree_handler_t::handle_subtract_points))
 {
   _event_loop.add_about_to_block_listener(this);
 }
@@ -143,6 +146,10 @@ dew_error_t tree_handler_t::deserialize_tree_registry(std::unique_ptr<uint8_t[]>
   auto ret = tree_registry_deserialize(tree_registry_buffer, tree_registry_blobs_size, _tree_registry);
   if (ret.code == 0)
   {
+    // Resume the journal chain read_index replayed; with no baseline in memory the first checkpoint
+    // compacts it into a fresh snapshot.
+    _registry_journal = {};
+    _registry_journal.records = _file_cache.take_tree_registry_journal();
     _initialized = true;
     _configuration_initialized = true;
     // Resume: seed the finality/LOD watermarks from the persisted registry (v2; zero for v1 files
@@ -213,9 +220,129 @@ void tree_handler_t::set_tree_initialization_read_chunk_bytes(uint64_t bytes)
 
 void tree_handler_t::about_to_block()
 {
+  // Every add_points queued this loop iteration is inserted as one batch.
+  drain_deferred_adds();
 }
 
 void tree_handler_t::handle_add_points(storage_header_t &&header, attributes_id_t &&attributes_id, std::vector<storage_location_t> &&storage)
+{
+  if (!_initialized)
+  {
+    insert_points(std::move(header), std::move(attributes_id), std::move(storage));
+    return;
+  }
+  // Queued until about_to_block, so the chunks the sort workers delivered meanwhile are inserted as one
+  // batch. The chunk's trees may not be loaded (a reopened dataset loads them lazily): inserts wait for
+  // them in arrival order.
+  _deferred_adds.push_back({std::move(header), std::move(attributes_id), std::move(storage)});
+}
+
+void tree_handler_t::drain_deferred_adds()
+{
+  std::vector<tree_insert_t> batch;
+  while (!_deferred_adds.empty() && !_deferred_adds_waiting)
+  {
+    auto &front = _deferred_adds.front();
+    std::vector<tree_id_t> unloaded;
+    collect_unloaded_trees(_tree_registry.root, {{front.header.morton_min, front.header.morton_max}}, unloaded);
+    if (unloaded.empty())
+    {
+      batch.push_back(std::move(front));
+      _deferred_adds.pop_front();
+      continue;
+    }
+    insert_batch(std::move(batch));
+    batch.clear();
+    _deferred_adds_waiting = true;
+    load_ranges({{front.header.morton_min, front.header.morton_max}}, [this]() {
+      _deferred_adds_waiting = false;
+      auto add = std::move(_deferred_adds.front());
+      _deferred_adds.pop_front();
+      insert_points(std::move(add.header), std::move(add.attributes_id), std::move(add.locations));
+    });
+  }
+  insert_batch(std::move(batch));
+}
+
+void tree_handler_t::insert_batch(std::vector<tree_insert_t> &&batch)
+{
+  if (batch.empty())
+    return;
+  auto tree_start = std::chrono::steady_clock::now();
+  const uint32_t reopen_input = _reopen_input.load(std::memory_order_acquire);
+  for (auto &insert : batch)
+  {
+    if (insert.header.input_id.data == reopen_input)
+      reopen_trees(insert.header.morton_min, insert.header.morton_max);
+  }
+  size_t next = 0;
+  while (next < batch.size())
+  {
+    tree_shard_plan_t plan;
+    next = tree_plan_shards(_tree_registry, _file_cache, batch, next, plan);
+    run_shards(plan);
+    tree_merge_shards(_tree_registry, plan);
+  }
+  auto tree_end = std::chrono::steady_clock::now();
+  auto tree_us = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(tree_end - tree_start).count());
+  _perf_stats.tree_build_time_us.fetch_add(tree_us, std::memory_order_relaxed);
+
+  for (auto &insert : batch)
+  {
+    auto to_send = insert.header.input_id;
+    _done_with_input.post_event(std::move(to_send));
+  }
+}
+
+void tree_handler_t::run_shards(tree_shard_plan_t &plan)
+{
+  const size_t count = plan.shards.size();
+#ifndef __EMSCRIPTEN__
+  if (count > 1 && !_shutting_down.load(std::memory_order_acquire))
+  {
+    // The tree loop claims shards as well, so a batch completes even while every pool thread is busy
+    // sorting; the pool tasks only ever speed it up. A task that starts after the last shard was claimed
+    // touches nothing but `run`.
+    struct shard_run_t
+    {
+      explicit shard_run_t(size_t a_count)
+        : count(a_count)
+      {
+      }
+      const size_t count;
+      std::atomic<size_t> next{0};
+      std::mutex mutex;
+      std::condition_variable cv;
+      size_t done = 0;
+    };
+    auto run = std::make_shared<shard_run_t>(count);
+    auto work = [this, run, &plan]() {
+      size_t finished = 0;
+      for (size_t i = run->next.fetch_add(1); i < run->count; i = run->next.fetch_add(1))
+      {
+        tree_shard_insert(_tree_registry, _file_cache, plan, plan.shards[i]);
+        finished++;
+      }
+      if (finished)
+      {
+        std::unique_lock<std::mutex> lock(run->mutex);
+        run->done += finished;
+        run->cv.notify_all();
+      }
+    };
+    for (size_t i = 1; i < count; i++)
+      _thread_pool.enqueue(work);
+    work();
+    std::unique_lock<std::mutex> lock(run->mutex);
+    run->cv.wait(lock, [&run] { return run->done == run->count; });
+    return;
+  }
+#endif
+  for (auto &shard : plan.shards)
+    tree_shard_insert(_tree_registry, _file_cache, plan, shard);
+}
+
+void tree_handler_t::insert_points(storage_header_t &&header, attributes_id_t &&attributes_id, std::vector<storage_location_t> &&storage)
 {
   auto tree_start = std::chrono::steady_clock::now();
   if (!_initialized)
@@ -226,6 +353,8 @@ void tree_handler_t::handle_add_points(storage_header_t &&header, attributes_id_
   }
   else
   {
+    if (header.input_id.data == _reopen_input.load(std::memory_order_acquire))
+      reopen_trees(header.morton_min, header.morton_max);
     _tree_registry.root = tree_add_points(_tree_registry, _file_cache, _tree_registry.root, header, attributes_id, std::move(storage));
   }
   auto tree_end = std::chrono::steady_clock::now();
@@ -236,6 +365,224 @@ void tree_handler_t::handle_add_points(storage_header_t &&header, attributes_id_
   _done_with_input.post_event(std::move(to_send));
 }
 
+static bool ranges_intersect(const lod_dirty_ranges_t &ranges, const morton::morton192_t &min, const morton::morton192_t &max)
+{
+  for (auto &[range_min, range_max] : ranges)
+  {
+    if (!(max < range_min) && !(range_max < min))
+      return true;
+  }
+  return false;
+}
+
+void tree_handler_t::collect_unloaded_trees(tree_id_t tree_id, const lod_dirty_ranges_t &ranges, std::vector<tree_id_t> &unloaded) // NOLINT(*-no-recursion)
+{
+  if (tree_id.data >= _tree_registry.data.size())
+    return;
+  auto *tree = _tree_registry.data[tree_id.data].get();
+  if (!tree)
+  {
+    unloaded.push_back(tree_id);
+    return;
+  }
+  if (!ranges_intersect(ranges, tree->morton_min, tree->morton_max))
+    return;
+  for (auto &sub_tree : tree->sub_trees)
+    collect_unloaded_trees(sub_tree, ranges, unloaded);
+}
+
+void tree_handler_t::load_ranges(lod_dirty_ranges_t ranges, std::function<void()> on_loaded)
+{
+  std::vector<tree_id_t> unloaded;
+  if (_initialized)
+    collect_unloaded_trees(_tree_registry.root, ranges, unloaded);
+  if (unloaded.empty())
+  {
+    on_loaded();
+    return;
+  }
+  _range_loads.push_back({std::move(ranges), std::move(on_loaded)});
+  handle_request_trees_batch(std::move(unloaded)); // already-requested trees are skipped
+}
+
+void tree_handler_t::retry_range_loads()
+{
+  // A loaded tree can reveal further unloaded subtrees, so every waiter re-walks its ranges.
+  auto loads = std::move(_range_loads);
+  _range_loads.clear();
+  for (auto &load : loads)
+    load_ranges(std::move(load.ranges), std::move(load.on_loaded));
+  drain_deferred_adds();
+}
+
+void tree_handler_t::reopen_trees(const morton::morton192_t &min, const morton::morton192_t &max)
+{
+  for (auto &tree : _tree_registry.data)
+  {
+    if (!tree || tree->morton_max < min || max < tree->morton_min)
+      continue;
+    auto &state = _tree_registry.tree_state[tree->id.data];
+    assert(state != uint8_t(tree_state_t::uploaded) && "edits are refused in destination mode");
+    if (state == uint8_t(tree_state_t::final))
+      state = uint8_t(tree_state_t::building);
+  }
+}
+
+// Release one subset reference of a reader chunk the way collapse does: the chunk's blobs are freed
+// through the checkpoint when the last tree drops it.
+static void release_chunk_subset(tree_registry_t &tree_registry, storage_handler_t &storage, tree_t &tree, input_data_id_t id)
+{
+  const bool had = tree.storage_map.contains(id);
+  auto attrib_locations = tree.storage_map.dereference(id);
+  if (!had || tree.storage_map.contains(id))
+    return;
+  auto refs = tree_registry.chunk_tree_refs.find(id);
+  if (refs == tree_registry.chunk_tree_refs.end())
+    return; // pre-v3 cache: chunk lifetime unknown, never freed
+  assert(refs->second.tree_count > 0);
+  if (--refs->second.tree_count == 0)
+  {
+    storage.note_source_blobs_freed(attrib_locations.first, attrib_locations.second, refs->second.point_count);
+    tree.storage_map.restore_discarded(std::move(attrib_locations.second));
+    tree_registry.chunk_tree_refs.erase(refs);
+  }
+}
+
+void tree_handler_t::strip_input(input_data_id_t input, const morton::morton192_t &min, const morton::morton192_t &max, std::function<void(bool)> done)
+{
+  _event_loop.run_in_loop([this, input, min, max, done = std::move(done)]() {
+    _edit_subtractions.clear();
+    if (!_initialized || max < min)
+    {
+      done(false); // the input never delivered a point
+      return;
+    }
+    load_ranges({{min, max}}, [this, input, min, max, done]() {
+      reopen_trees(min, max);
+      for (auto &tree : _tree_registry.data)
+      {
+        if (!tree || tree->morton_max < min || max < tree->morton_min)
+          continue;
+        bool changed = false;
+        for (int level = 0; level < 5; level++)
+        {
+          for (uint32_t skip = 0; skip < uint32_t(tree->nodes[level].size()); skip++)
+          {
+            auto &collection = tree->data[level][skip];
+            if (tree->nodes[level][skip] != 0 || collection.point_count == 0 || collection.max < min || max < collection.min)
+              continue;
+            bool has_collapsed = false;
+            uint64_t dropped = 0;
+            auto keep = collection.data.begin();
+            for (auto it = collection.data.begin(); it != collection.data.end(); ++it)
+            {
+              const auto id = it->input_id;
+              if (input_data_id_is_collapsed_leaf(id))
+                has_collapsed = true;
+              if (id.data != input.data || !input_data_id_is_leaf(id) || input_data_id_is_collapsed_leaf(id))
+              {
+                *keep++ = *it;
+                continue;
+              }
+              release_chunk_subset(_tree_registry, _file_cache, *tree, id);
+              dropped += it->count.data;
+            }
+            collection.data.erase(keep, collection.data.end());
+            if (dropped)
+            {
+              changed = true;
+              collection.point_count -= dropped;
+              if (collection.data.empty())
+                collection = points_collection_t(); // min/max of a non-empty leaf stay a valid, if loose, bound
+            }
+            if (has_collapsed)
+              _edit_subtractions.push_back({tree->id, level, skip, collection.min, collection.max, {}});
+          }
+        }
+        if (changed)
+        {
+          tree->is_dirty = true;
+          tree_compute_leaves_collapsed(*tree, _tree_registry);
+        }
+      }
+      std::sort(_edit_subtractions.begin(), _edit_subtractions.end(), [](const leaf_subtraction_t &a, const leaf_subtraction_t &b) { return a.min < b.min; });
+      done(!_edit_subtractions.empty());
+    });
+  });
+}
+
+template <typename S_M>
+static void append_absolute_codes(const dew_blob_t &buffer, uint32_t point_count, const morton::morton192_t &morton_min, std::vector<morton::morton192_t> &codes)
+{
+  const auto *source = reinterpret_cast<const S_M *>(buffer.data);
+  for (uint32_t i = 0; i < point_count; i++)
+    morton::morton_upcast(source[i], morton_min, codes.emplace_back());
+}
+
+void tree_handler_t::handle_subtract_points(points_t &&points)
+{
+  auto &header = points.header;
+  std::vector<morton::morton192_t> codes;
+  codes.reserve(header.point_count);
+  switch (header.point_format.type)
+  {
+  case dew_type_m32:
+    append_absolute_codes<morton::morton32_t>(points.buffers.buffers[0], header.point_count, header.morton_min, codes);
+    break;
+  case dew_type_m64:
+    append_absolute_codes<morton::morton64_t>(points.buffers.buffers[0], header.point_count, header.morton_min, codes);
+    break;
+  case dew_type_m128:
+    append_absolute_codes<morton::morton128_t>(points.buffers.buffers[0], header.point_count, header.morton_min, codes);
+    break;
+  case dew_type_m192:
+    append_absolute_codes<morton::morton192_t>(points.buffers.buffers[0], header.point_count, header.morton_min, codes);
+    break;
+  default:
+    assert(false && "sorted chunks hold a morton type");
+    break;
+  }
+  // Sorted chunk against sorted, disjoint leaf ranges: one merge walk.
+  auto leaf = _edit_subtractions.begin();
+  if (!codes.empty())
+    leaf = std::lower_bound(_edit_subtractions.begin(), _edit_subtractions.end(), codes.front(), [](const leaf_subtraction_t &l, const morton::morton192_t &code) { return l.max < code; });
+  for (auto &code : codes)
+  {
+    while (leaf != _edit_subtractions.end() && leaf->max < code)
+      ++leaf;
+    if (leaf == _edit_subtractions.end())
+      break;
+    if (!(code < leaf->min))
+      leaf->remove.push_back(code);
+  }
+  auto to_send = header.input_id;
+  _done_with_input.post_event(std::move(to_send));
+}
+
+void tree_handler_t::subtract_stripped_points(std::function<void()> done)
+{
+  _event_loop.run_in_loop([this, done = std::move(done)]() {
+    auto subtractions = std::move(_edit_subtractions);
+    _edit_subtractions.clear();
+    _tree_collapse.subtract_from_leaves(std::move(subtractions), done);
+  });
+}
+
+void tree_handler_t::regenerate_lod(lod_dirty_ranges_t ranges)
+{
+  _event_loop.run_in_loop([this, ranges = std::move(ranges)]() {
+    load_ranges(ranges, [this, ranges]() {
+      for (auto &[min, max] : ranges)
+      {
+        reopen_trees(min, max);
+        _tree_lod_generator.add_dirty_range(min, max);
+      }
+      _edit_pass_pending = true;
+      handle_generate_lod(_tree_lod_generator.lod_complete_morton());
+    });
+  });
+}
+
 void tree_handler_t::generate_lod(const morton::morton192_t &max)
 {
   // Hop to the tree loop: the pass target and the generator's batch state are tree-loop state, and
@@ -418,6 +765,11 @@ void tree_handler_t::handle_serialize_trees()
     _pass_watermark = _pending_pass_watermark;
     _has_pass_watermark = true;
   }
+  if (_edit_pass_pending)
+  {
+    _edit_pass_pending = false;
+    _edit_pass_lod_done = true;
+  }
   launch_serialize_chain();
 }
 
@@ -491,11 +843,12 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
   // so strict '<' alone would leave it building forever. Only loaded trees are marked; an
   // unloaded (lazily-not-yet-read) tree on a resumed session keeps its persisted state and is
   // finalized by a later pass or the terminal one.
+  bool terminal_pass = false;
   if (_has_pass_watermark)
   {
     morton::morton192_t terminal;
     memset(&terminal, 0xFF, sizeof(terminal));
-    const bool terminal_pass = !(_pass_watermark < terminal);
+    terminal_pass = !(_pass_watermark < terminal);
     if (_tree_registry.lod_watermark < _pass_watermark)
       _tree_registry.lod_watermark = _pass_watermark;
     for (auto &tree : _tree_registry.data)
@@ -511,6 +864,10 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
     }
   }
 
+  // An input edit's LOD rebuild is concluded by the first chain that starts after it completed.
+  const bool concludes_edit_pass = _edit_pass_lod_done;
+  _edit_pass_lod_done = false;
+
   // Step 1: Serialize dirty trees. A finalized tree must never be dirty again -- its serialized
   // form from its finalizing checkpoint is immutable (the upload/eviction tiers depend on this).
   std::vector<tree_id_t> tree_ids;
@@ -526,6 +883,8 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
     taken_discards.clear();
     for (auto *tree : serialized_tree_ptrs)
       tree->is_dirty = true; // stays in every later checkpoint until a write succeeds
+    if (concludes_edit_pass)
+      _edit_pass_lod_done = true; // the next chain concludes it instead
   };
   for (auto &tree : _tree_registry.data)
   {
@@ -553,6 +912,19 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
     }
   }
 
+  // The hierarchy directory holds copies of the top trees, so a checkpoint that rewrites any tree
+  // drops it. The terminal pass writes a fresh one, serialized here from the same snapshot as the
+  // trees; trees not resident (a resumed session that never loaded them) are left to load on demand.
+  const bool drop_directory = !tree_ids.empty() && _tree_registry.hierarchy_directory.size != 0;
+  serialized_tree_registry_t directory = {nullptr, 0};
+  const auto directory_depth = _hierarchy_directory_depth.load(std::memory_order_relaxed);
+  if (directory_depth > 0 && terminal_pass && (drop_directory || _tree_registry.hierarchy_directory.size == 0))
+  {
+    directory = hierarchy_directory_serialize(_tree_registry.root, directory_depth, [this](tree_id_t id) -> const tree_t * {
+      return id.data < _tree_registry.data.size() ? _tree_registry.data[id.data].get() : nullptr;
+    });
+  }
+
   // Refresh the input-registry snapshot embedded in the registry blob (resume support).
   if (_input_registry_snapshot_provider)
     _tree_registry.input_registry_snapshot = _input_registry_snapshot_provider();
@@ -604,24 +976,85 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
     location = trees_result.locations[i];
   }
 
-  // Step 4: Serialize and write tree registry
-  auto serialized_registry = tree_registry_serialize(_tree_registry);
-  callback_awaitable_t<write_tree_registry_result_t> write_registry_awaitable(_event_loop);
+  auto write_registry_blob = [this](serialized_tree_registry_t &&blob)
   {
-    auto state = write_registry_awaitable._state;
-    _file_cache.write_tree_registry(std::move(serialized_registry),
+    callback_awaitable_t<write_tree_registry_result_t> awaitable(_event_loop);
+    auto state = awaitable._state;
+    _file_cache.write_tree_registry(std::move(blob),
       [state](storage_location_t loc, dew_error_t &&err)
       {
         state->result.location = loc;
         state->result.error = std::move(err);
         state->caller_loop.run_in_loop([state] { state->continuation.resume(); });
       });
+    return awaitable;
+  };
+
+  // Step 3b: Swap the hierarchy directory. It is an ordinary metadata blob, freed with the checkpoint
+  // that supersedes it. A failed write only costs the accelerator: readers load those trees instead.
+  storage_location_t superseded_directory = {};
+  storage_location_t written_directory = {};
+  if (drop_directory)
+  {
+    superseded_directory = _tree_registry.hierarchy_directory;
+    old_locations.push_back(superseded_directory);
+    _tree_registry.hierarchy_directory = {};
+  }
+  if (directory.data)
+  {
+    auto directory_result = co_await write_registry_blob(std::move(directory));
+    if (directory_result.error.code != 0)
+      fmt::print(stderr, "Error writing hierarchy directory: {}\n", directory_result.error.msg);
+    else
+      _tree_registry.hierarchy_directory = written_directory = directory_result.location;
   }
+  // When the commit below fails, the superseded directory is still the committed one and the new one is
+  // referenced only by registry records that never got committed. Both go to the orphans the next
+  // successful commit frees, and the registry goes without a directory until a terminal pass writes one
+  // again -- keeping the new one would have the next commit free a blob it still points at.
+  auto orphan_directories = [&]() {
+    if (superseded_directory.size != 0)
+      _registry_journal.orphans.push_back(superseded_directory);
+    if (written_directory.size != 0)
+    {
+      _registry_journal.orphans.push_back(written_directory);
+      if (_tree_registry.hierarchy_directory == written_directory)
+        _tree_registry.hierarchy_directory = {};
+    }
+  };
+
+  // Step 4: Journal the tree registry: write the next record (a delta against the last committed one,
+  // or a compacting snapshot), then the manifest listing the chain. The index points at the manifest.
+  auto record = tree_registry_journal_next(_registry_journal, _tree_registry);
+  if (record.snapshot)
+    old_locations.insert(old_locations.end(), _registry_journal.records.begin(), _registry_journal.records.end());
+  old_locations.insert(old_locations.end(), _registry_journal.orphans.begin(), _registry_journal.orphans.end());
   if (chain_debug)
-    fmt::print(stderr, "[chain] awaiting write_registry\n");
-  auto registry_result = co_await write_registry_awaitable;
+    fmt::print(stderr, "[chain] awaiting write_registry snapshot={}\n", record.snapshot);
+  auto record_result = co_await write_registry_blob(serialized_tree_registry_t(record.data));
+  write_tree_registry_result_t registry_result;
+  if (record_result.error.code == 0)
+  {
+    auto chain = record.snapshot ? std::vector<storage_location_t>() : _registry_journal.records;
+    chain.push_back(record_result.location);
+    registry_result = co_await write_registry_blob(tree_registry_journal_manifest(chain));
+  }
+  else
+  {
+    registry_result.error = record_result.error;
+  }
   if (chain_debug)
     fmt::print(stderr, "[chain] write_registry done err={}\n", registry_result.error.code);
+  if (registry_result.error.code != 0)
+  {
+    fmt::print(stderr, "Error writing tree registry: {}\n", registry_result.error.msg);
+    if (record_result.error.code == 0)
+      _registry_journal.orphans.push_back(record_result.location);
+    orphan_directories();
+    if (concludes_edit_pass)
+      _edit_pass_lod_done = true;
+    co_return;
+  }
 
   // Step 5: Write blob locations and update header. The completion callback runs on the STORAGE
   // loop strictly BEFORE the handler posts the index-written event (see
@@ -633,7 +1066,7 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
     auto state = write_blob_awaitable._state;
     auto committed_watermark = _tree_registry.lod_watermark;
     _file_cache.write_blob_locations_and_update_header(registry_result.location, std::move(old_locations),
-      [state, this, committed_watermark](dew_error_t &&err)
+      [state, this, committed_watermark, concludes_edit_pass](dew_error_t &&err)
       {
         if (err.code == 0)
         {
@@ -641,6 +1074,8 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
             std::unique_lock<std::mutex> lock(_committed_watermark_mutex);
             _last_committed_watermark = committed_watermark;
           }
+          if (concludes_edit_pass)
+            _edit_pass_committed.store(true, std::memory_order_release);
           std::unique_lock<std::mutex> lock(_band_emission_mutex);
           _commits_seen++;
         }
@@ -656,8 +1091,15 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
   if (blob_result.error.code != 0)
   {
     fmt::print(stderr, "Error committing checkpoint index: {}\n", blob_result.error.msg);
+    _registry_journal.orphans.push_back(record_result.location);
+    _registry_journal.orphans.push_back(registry_result.location);
+    orphan_directories();
+    if (concludes_edit_pass)
+      _edit_pass_lod_done = true;
     co_return;
   }
+  tree_registry_journal_commit(_registry_journal, std::move(record), record_result.location);
+  _registry_journal.orphans.clear();
   // (The committed watermark was already published from the storage-side completion callback,
   // happens-before the index-written event.)
   // Everything this checkpoint finalized is now derivable from COMMITTED state -- band it, then
@@ -672,7 +1114,13 @@ vio::task_t<void> tree_handler_t::do_serialize_trees()
 
 void tree_handler_t::handle_deserialize_tree(tree_id_t &&tree_id, serialized_tree_t &&data)
 {
-  assert(_tree_registry.get(tree_id) == nullptr);
+  // A hierarchy-directory entry and an on-demand load of the same tree can both land (the walk may
+  // ask before the directory is in). Same bytes either way; the first one stays.
+  if (tree_id.data >= _tree_registry.data.size() || _tree_registry.get(tree_id) != nullptr)
+    return;
+  // Directory entries arrive unrequested; mark them so a later request does not read them again.
+  _tree_id_requested.resize(_tree_registry.data.size());
+  _tree_id_requested[tree_id.data] = 1;
   _tree_registry.data[tree_id.data] = std::make_unique<tree_t>();
   auto tree = _tree_registry.get(tree_id);
   assert(tree);
@@ -693,6 +1141,7 @@ void tree_handler_t::handle_deserialize_tree(tree_id_t &&tree_id, serialized_tre
     _first_root_initialized = true;
     _root_cv.notify_all();
   }
+  retry_range_loads();
 }
 
 void tree_handler_t::handle_request_aabb(std::function<void(double *, double *)> &&function)
@@ -746,6 +1195,55 @@ void tree_handler_t::handle_request_aabb(std::function<void(double *, double *)>
 
 void tree_handler_t::handle_request_root()
 {
-  handle_request_trees_batch(std::vector<tree_id_t>{_tree_registry.root});
+  const auto directory = _tree_registry.hierarchy_directory;
+  if (directory.size == 0 || _shutting_down.load(std::memory_order_acquire))
+  {
+    handle_request_trees_batch(std::vector<tree_id_t>{_tree_registry.root});
+    return;
+  }
+  // One read for the top of the octree (hierarchy_directory.hpp): every entry goes through the same
+  // deserialize pipe as a single-tree load, root first. The root is marked requested so a walk does
+  // not load it again meanwhile; an unreadable directory hands it back to the ordinary path, and the
+  // trees below load on demand as they would without a directory.
+  _tree_id_requested.resize(_tree_registry.data.size());
+  _tree_id_requested[_tree_registry.root.data] = 1;
+  auto finish = [this, root = _tree_registry.root](read_request_t &req) {
+    uint32_t depth = 0;
+    std::vector<hierarchy_directory_entry_t> entries;
+    dew_error_t error = req.error;
+    if (error.code == 0)
+      error = hierarchy_directory_parse(req.buffer.get(), uint32_t(req.buffer_info.size), depth, entries);
+    if (error.code == 0 && (entries.empty() || entries[0].id.data != root.data))
+      error = {1, "hierarchy directory does not start at the root tree"};
+    if (error.code != 0)
+    {
+      fmt::print(stderr, "Error reading hierarchy directory, loading trees one by one: {}\n", error.msg);
+      _event_loop.run_in_loop([this, root]() {
+        _tree_id_requested[root.data] = 0;
+        handle_request_trees_batch(std::vector<tree_id_t>{root});
+      });
+      return;
+    }
+    for (auto &entry : entries)
+    {
+      serialized_tree_t data;
+      data.size = int(entry.size);
+      data.data = std::shared_ptr<uint8_t[]>(req.buffer, req.buffer.get() + entry.offset);
+      _deserialize_tree.post_event(tree_id_t(entry.id.data), std::move(data));
+    }
+  };
+  auto req = _file_cache.read(directory);
+#ifdef __EMSCRIPTEN__
+  [](tree_handler_t *self, std::shared_ptr<read_request_t> req, decltype(finish) finish) -> vio::detached_task_t
+  {
+    co_await req->await_on(self->_event_loop);
+    finish(*req);
+  }(this, req, finish);
+#else
+  _thread_pool.enqueue([req, finish]() {
+    req->wait_for_read();
+    finish(*req);
+  });
+#endif
 }
 } // namespace dew::converter
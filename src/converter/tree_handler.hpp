@@ -24,11 +24,15 @@
 #include <vio/thread_pool.h>
 
 #include <atomic>
+#include <deque>
+#include <functional>
 
 #include "perf_stats.hpp"
 #include "tree.hpp"
+#include "tree_build.hpp" // tree_insert_t, tree_shard_plan_t
 #include "tree_collapse.hpp"
 #include "tree_lod_generator.hpp"
+#include "tree_registry_journal.hpp"
 #include "upload_handler.hpp" // band_job_t
 
 namespace dew::converter
@@ -65,6 +69,19 @@ public:
   }
   void set_tree_initialization_node_point_limit(uint32_t limit);
   void set_tree_initialization_read_chunk_bytes(uint64_t bytes);
+  // Write a hierarchy directory of this many tree levels with the terminal checkpoint (0 = none; see
+  // hierarchy_directory.hpp). Any thread; read by the next checkpoint chain.
+  void set_hierarchy_directory_depth(uint32_t depth)
+  {
+    _hierarchy_directory_depth.store(depth, std::memory_order_relaxed);
+  }
+  // Route LOD and collapse work by subtree onto NUMA node pools (worker_pools.hpp). Before any input is
+  // added; null keeps the shared pool.
+  void set_worker_pools(worker_pools_t *worker_pools)
+  {
+    _tree_lod_generator.set_worker_pools(worker_pools);
+    _tree_collapse.set_worker_pools(worker_pools);
+  }
   void about_to_block() override;
   // Thread-safe: posts to the tree loop. The pass target/generator state belong to the tree loop,
   // which may be mid-checkpoint (serialize chain, band emission) when the processor advances the
@@ -97,6 +114,23 @@ public:
   void request_aabb(std::function<void(double *, double *)> function);
   void request_trees_async(std::vector<tree_id_t> tree_ids);
 
+  // Input removal/replacement (processor_t::edit_input); the processor runs one edit at a time. Each entry
+  // point hops to the tree loop and reports back ON the tree loop.
+  // strip_input loads every tree over [min, max], reopens them (final -> building), drops the input's
+  // reader chunks from their leaves and records the collapsed leaves under the range: those merged the
+  // input's points into their own unit, so the input is read again and its points arrive through
+  // subtract_points. done(needs_subtraction) tells the processor whether that re-read is needed.
+  void strip_input(input_data_id_t input, const morton::morton192_t &min, const morton::morton192_t &max, std::function<void(bool)> done);
+  // Rewrite the recorded leaves without the points subtract_points delivered, then call done.
+  void subtract_stripped_points(std::function<void()> done);
+  // Chunks of this input may land in final trees (an edit's replacement input reopens them). ~0u: none.
+  void set_reopen_input(uint32_t input_data) { _reopen_input.store(input_data, std::memory_order_release); }
+  // Rebuild the LOD nodes over `ranges` -- and every ancestor up to the root -- for the current pass
+  // watermark, reusing every other node. Ends in a checkpoint like any pass; take_edit_pass_committed
+  // turns true once that checkpoint committed.
+  void regenerate_lod(lod_dirty_ranges_t ranges);
+  bool take_edit_pass_committed() { return _edit_pass_committed.exchange(false, std::memory_order_acq_rel); }
+
   const tree_registry_t &tree_registry() const { return _tree_registry; }
   const attributes_configs_t &attributes_configs() const { return _attributes_configs; }
   // True once the tree configuration is fixed (sealed by first use, or restored from a reopened
@@ -120,6 +154,20 @@ private:
   void handle_request_aabb(std::function<void(double *, double *)> &&function);
   void handle_request_root();
   void handle_request_trees_batch(std::vector<tree_id_t> &&tree_ids);
+  void handle_subtract_points(points_t &&points);
+  // Edits and inserts on a reopened dataset touch trees that may not be loaded yet. load_ranges requests
+  // every tree a walk over `ranges` needs (each intersecting tree and its direct subtrees: the LOD walk
+  // reads their top nodes) and runs on_loaded once they are all in -- synchronously when they already are.
+  void collect_unloaded_trees(tree_id_t tree_id, const lod_dirty_ranges_t &ranges, std::vector<tree_id_t> &unloaded);
+  void load_ranges(lod_dirty_ranges_t ranges, std::function<void()> on_loaded);
+  void retry_range_loads();
+  void reopen_trees(const morton::morton192_t &min, const morton::morton192_t &max);
+  void drain_deferred_adds();
+  void insert_points(storage_header_t &&header, attributes_id_t &&attributes_id, std::vector<storage_location_t> &&storage);
+  // Insert a batch of chunks whose trees are loaded: planned on the tree loop, subtree shards inserted on
+  // the pool and the tree loop together (see tree_plan_shards).
+  void insert_batch(std::vector<tree_insert_t> &&batch);
+  void run_shards(tree_shard_plan_t &plan);
 
   void seal_configuration()
   {
@@ -151,6 +199,8 @@ private:
   perf_stats_t &_perf_stats;
 
   tree_registry_t _tree_registry;
+  tree_registry_journal_t _registry_journal; // tree loop only
+  std::atomic<uint32_t> _hierarchy_directory_depth{0};
   std::vector<uint8_t> _tree_id_requested;
 
   // Done-morton watermark plumbing for finality marking (monotone max across passes). generate_lod
@@ -212,6 +262,21 @@ private:
 
   std::vector<std::function<void()>> _tree_deserialized_callbacks;
 
+  // Input edits (tree loop only, except the two atomics).
+  struct range_load_t
+  {
+    lod_dirty_ranges_t ranges;
+    std::function<void()> on_loaded;
+  };
+  std::vector<range_load_t> _range_loads;
+  std::deque<tree_insert_t> _deferred_adds; // inserts not yet in the tree, kept in arrival order
+  bool _deferred_adds_waiting = false;
+  std::vector<leaf_subtraction_t> _edit_subtractions; // sorted by min; ranges are disjoint leaf cells
+  std::atomic<uint32_t> _reopen_input{~uint32_t(0)};
+  bool _edit_pass_pending = false;  // regenerate_lod started a pass
+  bool _edit_pass_lod_done = false; // ... and it completed: the next checkpoint concludes it
+  std::atomic<bool> _edit_pass_committed{false};
+
 public:
   vio::event_pipe_t<storage_header_t, attributes_id_t, std::vector<storage_location_t>> add_points;
   vio::event_pipe_t<morton::morton192_t> _generate_lod_pipe;
@@ -222,6 +287,8 @@ public:
   vio::event_pipe_t<std::function<void(double *, double *)>> _request_aabb;
   vio::event_pipe_t<void> _request_root;
   vio::event_pipe_t<std::vector<tree_id_t>> _request_trees_batch;
+  // Sorted chunks of a removed input's re-read: their points are taken out of the stripped leaves.
+  vio::event_pipe_t<points_t> subtract_points;
 
 private:
 };
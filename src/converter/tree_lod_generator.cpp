@@ -23,6 +23,7 @@
 #include "morton.hpp"
 #include "morton_tree_coordinate_transform.hpp"
 #include "storage_handler.hpp"
+#include "worker_pools.hpp"
 
 #include <fixed_size_vector.hpp>
 #include <algorithm>
@@ -171,8 +172,18 @@ struct tree_iterator_t
   std::vector<lod_node_worker_data_t> parents;
 };
 
+static bool range_is_dirty(const lod_dirty_ranges_t &dirty_ranges, const morton::morton192_t &min, const morton::morton192_t &max)
+{
+  for (auto &[dirty_min, dirty_max] : dirty_ranges)
+  {
+    if (!(max < dirty_min) && !(dirty_max < min))
+      return true;
+  }
+  return false;
+}
+
 static void tree_get_work_items(tree_registry_t &tree_cache, storage_handler_t &cache, tree_id_t &tree_id, lod_node_worker_data_t &parent_node, std::vector<lod_tree_worker_data_t> &to_lod,
-                                const morton::morton192_t &max_morton, const morton::morton192_t &already_lod_morton)
+                                const morton::morton192_t &max_morton, const morton::morton192_t &already_lod_morton, const lod_dirty_ranges_t &dirty_ranges)
 {
   auto tree = tree_cache.get(tree_id);
   assert(tree->morton_min >= parent_node.node_min);
@@ -218,8 +229,9 @@ static void tree_get_work_items(tree_registry_t &tree_cache, storage_handler_t &
         // Node's range is not strictly below the done boundary — skip entirely
         if (!(node_max < max_morton))
           continue;
-        // Node fully within already-LODed range AND has LOD data — skip but add to parent
-        if (node && node_max < already_lod_morton && data.point_count > 0 && data.data.size() == 1)
+        // Node fully within already-LODed range AND has LOD data — skip but add to parent. Unless an
+        // input edit changed points under it: then it is rebuilt, and so is every ancestor.
+        if (node && node_max < already_lod_morton && data.point_count > 0 && data.data.size() == 1 && !range_is_dirty(dirty_ranges, node_min, node_max))
         {
           parent.child_data.push_back(data);
           parent.child_trees.push_back(tree_id);
@@ -259,6 +271,15 @@ static void tree_get_work_items(tree_registry_t &tree_cache, storage_handler_t &
       {
         parent.child_data.push_back(data);
         parent.child_trees.push_back(tree_id);
+        if (node && data.data[0].count.data != 0)
+        {
+          // An already-LOD'd node rebuilt for an input edit: its parent must read the blob the rebuild
+          // writes as a whole unit, like a fresh placeholder -- not the old point count.
+          auto &rebuilt = parent.child_data.back();
+          rebuilt.point_count = 0;
+          rebuilt.data[0].offset = offset_in_subset_t(~uint32_t(0));
+          rebuilt.data[0].count = point_count_t(0);
+        }
       }
     }
 
@@ -276,7 +297,7 @@ static void tree_get_work_items(tree_registry_t &tree_cache, storage_handler_t &
     auto tree_skip = tree_iterator[buffer_index].skips[to_process_index];
     auto subtree_id = tree->sub_trees[tree_skip];
     auto &parent = parent_buffer[tree_iterator[buffer_index].parent_indecies[to_process_index]];
-    tree_get_work_items(tree_cache, cache, subtree_id, parent, to_lod, max_morton, already_lod_morton);
+    tree_get_work_items(tree_cache, cache, subtree_id, parent, to_lod, max_morton, already_lod_morton, dirty_ranges);
   }
   lod_tree_worker_data.nodes[4] = std::move(tree_iterator[buffer_index].parents);
   if (lod_tree_worker_data.nodes[0].size())
@@ -692,7 +713,7 @@ struct calculate_child_buffer_size_t
 
 template <typename T, size_t N>
 static void quantize_morton_remember_indecies_t(storage_handler_t &cache, const morton::morton192_t &node_min, const std::vector<points_collection_t> &child_data, const child_storage_map_t &child_storage_map, int lod,
-                                                const std::vector<float> &random_offsets, bool adaptive_sampling, std::unique_ptr<uint8_t[]> &morton_data, std::vector<std::pair<input_data_id_t, uint32_t>> &indecies, morton::morton192_t &min,
+                                                const std::vector<float> &random_offsets, bool adaptive_sampling, point_buffer_t &morton_data, std::vector<std::pair<input_data_id_t, uint32_t>> &indecies, morton::morton192_t &min,
                                                 morton::morton192_t &max)
 {
   std::vector<morton_to_lod_t<T, N>> morton_to_lod;
@@ -741,7 +762,7 @@ static void quantize_morton_remember_indecies_t(storage_handler_t &cache, const
   morton::morton_upcast(morton_to_lod.front().morton, node_min, min);
   morton::morton_upcast(morton_to_lod.back().morton, node_min, max);
 
-  morton_data.reset(new uint8_t[sizeof(morton::morton_t<T, N>) * morton_to_lod.size()]);
+  morton_data = point_buffer_pool().acquire(sizeof(morton::morton_t<T, N>) * morton_to_lod.size());
   auto target_morton_buffer = reinterpret_cast<morton::morton_t<T, N> *>(morton_data.get());
   uint32_t current_target_morton_buffer_index = 0;
   indecies.reserve(morton_to_lod.size());
@@ -766,7 +787,7 @@ static void quantize_morton_remember_indecies_t(storage_handler_t &cache, const
 }
 
 static void quantize_morton_remember_indecies(storage_handler_t &cache, const morton::morton192_t &node_min, const std::vector<points_collection_t> &child_data, const child_storage_map_t &child_storage_map, int lod,
-                                              const std::vector<float> &random_offsets, bool adaptive_sampling, std::unique_ptr<uint8_t[]> &morton_data, std::vector<std::pair<input_data_id_t, uint32_t>> &indecies, morton::morton192_t &min,
+                                              const std::vector<float> &random_offsets, bool adaptive_sampling, point_buffer_t &morton_data, std::vector<std::pair<input_data_id_t, uint32_t>> &indecies, morton::morton192_t &min,
                                               morton::morton192_t &max)
 {
   auto lod_format = morton_type_from_lod(lod);
@@ -811,7 +832,7 @@ void lod_worker_t::work()
 
   std::vector<std::pair<input_data_id_t, uint32_t>> indecies;
   {
-    std::unique_ptr<uint8_t[]> morton_attribute_buffer;
+    point_buffer_t morton_attribute_buffer;
     quantize_morton_remember_indecies(cache, data.node_min, data.child_data, data.child_storage_info, data.lod, random_offsets, generation_config.lod_adaptive_sampling != 0, morton_attribute_buffer, indecies, destination_header.morton_min,
                                       destination_header.morton_max);
     attribute_buffers_initialize(lod_attrib_mapping.destination, buffers, uint32_t(indecies.size()), std::move(morton_attribute_buffer));
@@ -841,6 +862,20 @@ void lod_worker_t::work()
 
 static void get_storage_info(tree_registry_t &tree_cache, lod_node_worker_data_t &node)
 {
+  // A child gathered before this pass ran can have come out of it empty (an input edit removed every point
+  // under it; see adjust_tree_after_lod): it no longer has storage, so it no longer feeds its parent.
+  for (int i = 0; i < int(node.child_data.size());)
+  {
+    auto &child = node.child_data[i];
+    auto *tree = tree_cache.get(node.child_trees[i]);
+    if (child.data.size() == 1 && !input_data_id_is_leaf(child.data[0].input_id) && !tree->storage_map.contains(child.data[0].input_id))
+    {
+      node.child_data.erase(node.child_data.begin() + i);
+      node.child_trees.erase(node.child_trees.begin() + i);
+      continue;
+    }
+    i++;
+  }
   for (int i = 0; i < int(node.child_data.size()); i++)
   {
     auto tree_id = node.child_trees[i];
@@ -860,7 +895,40 @@ static void get_storage_info(tree_registry_t &tree_cache, lod_node_worker_data_t
   }
 }
 
-static void adjust_tree_after_lod(tree_registry_t &tree_cache, std::vector<lod_tree_worker_data_t> &to_adjust, int level)
+// Widen a freshly written LOD unit's zone maps to cover the whole subtree below it, so a query that
+// rules the unit out can skip the subtree too (attribute_zone.hpp). Children are matched by attribute
+// NAME -- they need not share the LOD unit's attribute layout. Any child that cannot vouch for an
+// attribute (no zone map, or it lacks the attribute) leaves that attribute unknown.
+static void widen_zones_to_subtree(tree_registry_t &tree_cache, attributes_configs_t &attributes_configs, const lod_node_worker_data_t &node, std::vector<attribute_zone_t> &zones)
+{
+  const auto &destination = attributes_configs.get(node.generated_attributes_id);
+  for (int index = 1; index < int(zones.size()) && index < int(destination.attributes.size()); index++)
+  {
+    auto &zone = zones[size_t(index)];
+    const std::string name(destination.attributes[size_t(index)].name, destination.attributes[size_t(index)].name_size);
+    for (int i = 0; i < int(node.child_data.size()) && zone.flags; i++)
+    {
+      const auto *tree = tree_cache.get(node.child_trees[size_t(i)]);
+      for (const auto &subset : node.child_data[size_t(i)].data)
+      {
+        const auto *child_zones = tree && tree->storage_map.contains(subset.input_id) ? tree->storage_map.zones(subset.input_id) : nullptr;
+        const int child_index = child_zones ? attributes_configs.get_attribute_index(tree->storage_map.attribute_id(subset.input_id), name).index : -1;
+        if (child_index < 1 || child_index >= int(child_zones->size()))
+        {
+          zone.flags = 0;
+          break;
+        }
+        attribute_zone_merge(zone, (*child_zones)[size_t(child_index)]);
+        if (!zone.flags)
+          break;
+      }
+    }
+    if (zone.flags)
+      zone.flags |= attribute_zone_subtree;
+  }
+}
+
+static void adjust_tree_after_lod(tree_registry_t &tree_cache, storage_handler_t &cache_file, attributes_configs_t &attributes_configs, std::vector<lod_tree_worker_data_t> &to_adjust, int level)
 {
   for (auto &adjust_data : to_adjust)
   {
@@ -887,23 +955,39 @@ static void adjust_tree_after_lod(tree_registry_t &tree_cache, std::vector<lod_t
       assert(node_ids[tree_index] == current);
       auto &done_node = adjust_data.nodes[level][node_index];
       auto &points_collection = tree->data[level][tree_index];
+      if (done_node.child_data.empty())
+      {
+        // Nothing left under the node: drop its LOD blob so its parent skips it, and let a later pass
+        // give it a fresh id should points arrive here again.
+        if (tree->storage_map.contains(done_node.storage_name))
+          tree->storage_map.dereference_discard(done_node.storage_name);
+        points_collection = points_collection_t();
+        continue;
+      }
       points_collection.point_count = done_node.generated_point_count.data;
       points_collection.min = done_node.generated_min;
       points_collection.max = done_node.generated_max;
       assert(points_collection.data.size() == 1);
       points_collection.data[0].count.data = done_node.generated_point_count.data;
       points_collection.data[0].offset.data = 0;
+      if (tree->storage_map.contains(done_node.storage_name))
+        tree->storage_map.dereference_discard(done_node.storage_name); // rebuilt for an input edit
       tree->storage_map.add_storage(done_node.storage_name, done_node.generated_attributes_id, std::move(done_node.generated_locations));
+      if (auto zones = cache_file.take_zone_maps(done_node.storage_name); !zones.empty())
+      {
+        widen_zones_to_subtree(tree_cache, attributes_configs, done_node, zones);
+        tree->storage_map.set_zones(done_node.storage_name, std::move(zones));
+      }
     }
   }
 }
 
 static void iterate_batch(const std::vector<float> &random_offsets, tree_lod_generator_t &lod_generator, lod_worker_batch_t &batch, tree_registry_t &tree_cache, storage_handler_t &cache_file,
-                          attributes_configs_t &attributes_configs, vio::event_loop_t &loop, vio::thread_pool_t &pool)
+                          attributes_configs_t &attributes_configs, vio::event_loop_t &loop, vio::thread_pool_t &pool, worker_pools_t *worker_pools)
 {
   (void)loop;
   if (!batch.new_batch)
-    adjust_tree_after_lod(tree_cache, batch.worker_data, batch.level);
+    adjust_tree_after_lod(tree_cache, cache_file, attributes_configs, batch.worker_data, batch.level);
 
   batch.new_batch = false;
   for (auto &worker : batch.lod_workers)
@@ -920,20 +1004,35 @@ static void iterate_batch(const std::vector<float> &random_offsets, tree_lod_gen
     if (batch_size == 0)
       batch.level--;
   }
+  // Resolve storage (and drop emptied children) before counting: the count must be final before the
+  // first worker is enqueued, since workers complete against it.
+  batch_size = 0;
+  for (auto &tree : batch.worker_data)
+  {
+    for (auto &node : tree.nodes[batch.level])
+    {
+      get_storage_info(tree_cache, node);
+      if (!node.child_data.empty())
+        batch_size++;
+    }
+  }
   batch.batch_size = int(batch_size);
 
   batch.lod_workers.reserve(batch_size);
 
   for (auto &tree : batch.worker_data)
   {
+    auto &tree_pool = worker_pools ? worker_pools->pool_for_tree(tree.tree_id) : pool;
     for (auto &node : tree.nodes[batch.level])
     {
-      assert(!node.child_data.empty());
-      get_storage_info(tree_cache, node);
+      if (node.child_data.empty())
+        continue; // emptied by an input edit; adjust_tree_after_lod clears it
       auto &lod_worker = batch.lod_workers.emplace_back(lod_generator, batch, cache_file, attributes_configs, node, random_offsets);
-      lod_worker.enqueue_lod(pool);
+      lod_worker.enqueue_lod(tree_pool);
     }
   }
+  if (batch.lod_workers.empty())
+    lod_generator.post_iterate_workers();
 }
 
 tree_lod_generator_t::tree_lod_generator_t(vio::event_loop_t &loop, vio::thread_pool_t &thread_pool, tree_registry_t &tree_cache, storage_handler_t &file_cache, attributes_configs_t &attributes_configs,
@@ -955,8 +1054,11 @@ void tree_lod_generator_t::generate_lods(tree_id_t &tree_id, const morton::morto
   std::vector<lod_tree_worker_data_t> to_lod;
   lod_node_worker_data_t fake_parent;
   fake_parent.node_min = _tree_cache.data[tree_id.data]->morton_min;
-  tree_get_work_items(_tree_cache, _file_cache, tree_id, fake_parent, to_lod, max, _lod_complete_morton);
+  tree_get_work_items(_tree_cache, _file_cache, tree_id, fake_parent, to_lod, max, _lod_complete_morton, _dirty_ranges);
   _lod_complete_morton = max;
+  // Every dirty node below `max` is in to_lod now; the ones above it are past the watermark and the
+  // pass that reaches them rebuilds them anyway.
+  _dirty_ranges.clear();
   if (!to_lod.empty())
   {
     std::sort(to_lod.begin(), to_lod.end(), [](const lod_tree_worker_data_t &a, const lod_tree_worker_data_t &b) { return a.magnitude < b.magnitude; });
@@ -988,13 +1090,13 @@ void tree_lod_generator_t::iterate_workers()
 {
   if (!_lod_batches.empty() && _lod_batches.front()->completed == int(_lod_batches.front()->lod_workers.size()) && _lod_batches.front()->level == 0)
   {
-    adjust_tree_after_lod(_tree_cache, _lod_batches.front()->worker_data, 0);
+    adjust_tree_after_lod(_tree_cache, _file_cache, _attributes_configs, _lod_batches.front()->worker_data, 0);
     for (auto &worker : _lod_batches.front()->lod_workers)
       worker.mark_done();
     _lod_batches.pop_front();
   }
   if (!_lod_batches.empty() && (_lod_batches.front()->new_batch || _lod_batches.front()->completed == int(_lod_batches.front()->lod_workers.size())))
-    iterate_batch(_random_offsets, *this, *_lod_batches.front(), _tree_cache, _file_cache, _attributes_configs, _loop, _thread_pool);
+    iterate_batch(_random_offsets, *this, *_lod_batches.front(), _tree_cache, _file_cache, _attributes_configs, _loop, _thread_pool, _worker_pools);
   if (_lod_batches.empty())
   {
     auto lod_end = perf_stats_t::clock_t::now();
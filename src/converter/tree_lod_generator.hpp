@@ -37,6 +37,7 @@ namespace dew::converter
 {
 using namespace dew::core;
 class storage_handler_t;
+class worker_pools_t;
 
 struct lod_child_storage_info_t
 {
@@ -98,6 +99,10 @@ private:
   bool _done{false};
 };
 
+// Morton ranges whose LOD must be rebuilt although they lie below the already-LOD'd watermark (an input
+// was removed or replaced there). A node is rebuilt when its range intersects one of them.
+using lod_dirty_ranges_t = std::vector<std::pair<morton::morton192_t, morton::morton192_t>>;
+
 struct lod_worker_batch_t
 {
   std::vector<lod_tree_worker_data_t> worker_data;
@@ -113,6 +118,11 @@ class tree_lod_generator_t
 public:
   tree_lod_generator_t(vio::event_loop_t &loop, vio::thread_pool_t &thread_pool, tree_registry_t &tree_cache, storage_handler_t &file_cache, attributes_configs_t &attributes_configs, perf_stats_t &perf_stats, vio::event_pipe_t<void> &lod_done);
   void generate_lods(tree_id_t &tree_id, const morton::morton192_t &max);
+  // Run each subtree's LOD nodes on its NUMA node's pool (worker_pools.hpp); null = the shared pool.
+  void set_worker_pools(worker_pools_t *worker_pools)
+  {
+    _worker_pools = worker_pools;
+  }
 
   // Resume: seed the already-LOD'd floor from the persisted registry watermark, so the first pass
   // of a reopened conversion doesn't re-walk (and re-LOD) nodes below it -- those belong to trees
@@ -121,8 +131,24 @@ public:
   {
     _lod_complete_morton = m;
   }
+  const morton::morton192_t &lod_complete_morton() const
+  {
+    return _lod_complete_morton;
+  }
+
+  // Input edits: the next generate_lods also rebuilds every already-LOD'd node intersecting
+  // [min, max], from the changed leaves up to the root, and reuses every other node's blob. The
+  // ranges are consumed by that pass.
+  void add_dirty_range(const morton::morton192_t &min, const morton::morton192_t &max)
+  {
+    _dirty_ranges.emplace_back(min, max);
+  }
 
   void iterate_workers();
+  void post_iterate_workers()
+  {
+    _iterate_workers.post_event();
+  }
 
   void add_worker_done(lod_worker_batch_t &batch)
   {
@@ -135,6 +161,7 @@ public:
 private:
   vio::event_loop_t &_loop;
   vio::thread_pool_t &_thread_pool;
+  worker_pools_t *_worker_pools = nullptr;
 public:
   const tree_config_t &generation_tree_config() const
   {
@@ -153,6 +180,7 @@ private:
 
   std::deque<std::unique_ptr<lod_worker_batch_t>> _lod_batches;
   morton::morton192_t _lod_complete_morton = {};
+  lod_dirty_ranges_t _dirty_ranges;
 };
 
 } // namespace dew::converter
@@ -447,6 +447,9 @@ vio::task_t<void> upload_handler_t::process_band(band_job_t job)
       registry.tree_state[i] = uint8_t(tree_state_t::uploaded);
       registry.tree_band[i] = registry.tree_band[i] == tree_band_none ? job.band_id : registry.tree_band[i];
     }
+    // The hierarchy directory is a cache-file blob the bucket does not carry (`dew copy` can write one
+    // into a bucket); the bucket's readers load every tree on demand.
+    registry.hierarchy_directory = {};
     auto reserialized_registry = tree_registry_serialize(registry);
     if (!reserialized_registry.data)
     {
@@ -151,7 +151,15 @@ bool worker_node_data_loader_t::is_ready(render::load_handle_t handle)
 
   auto it = _pending.find(handle);
   if (it == _pending.end())
-    return false;
+  {
+    auto pit = _prefetching.find(handle);
+    if (pit == _prefetching.end())
+      return false;
+    for (const auto &r : pit->second)
+      if (r && !r->_done)
+        return false;
+    return true;
+  }
   pending_t &p = it->second;
 
   if (p.phase == phase_t::reading)
@@ -251,7 +259,10 @@ void worker_node_data_loader_t::cancel(render::load_handle_t handle)
 {
   auto it = _pending.find(handle);
   if (it == _pending.end())
+  {
+    _prefetching.erase(handle); // a read-ahead just drops its handle; the bytes stay cached
     return;
+  }
   for (auto &r : it->second.reads)
     if (r)
       r->set_cancelled();
@@ -260,6 +271,29 @@ void worker_node_data_loader_t::cancel(render::load_handle_t handle)
   _pending.erase(it);
 }
 
+render::load_handle_t worker_node_data_loader_t::request_prefetch(const void *request_data, uint32_t request_size)
+{
+  native_load_request_t req;
+  std::memcpy(&req, request_data, sizeof(req) < request_size ? sizeof(req) : request_size);
+
+  // Exactly the reads request_load would issue (raw, so they land compressed in the read cache), minus the
+  // worker hand-off: the later request_load finds them cached and goes straight to post_to_worker.
+  std::array<std::shared_ptr<read_request_t>, 4> reads{};
+  bool any = false;
+  for (int i = 0; i < 4; ++i)
+  {
+    if (req.locations[i].size == 0)
+      continue;
+    reads[i] = _reader.read(req.locations[i], read_options_t{/*raw=*/true, false, {}});
+    any = true;
+  }
+  if (!any)
+    return render::invalid_load_handle;
+  const uint64_t handle = _next_handle++;
+  _prefetching.emplace(handle, std::move(reads));
+  return handle;
+}
+
 } // namespace dew::converter
 
 #endif // __EMSCRIPTEN__
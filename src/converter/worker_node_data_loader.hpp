@@ -56,6 +56,7 @@ public:
   bool is_ready(render::load_handle_t handle) override;
   render::loaded_node_data_t get_data(render::load_handle_t handle) override;
   void cancel(render::load_handle_t handle) override;
+  render::load_handle_t request_prefetch(const void *request_data, uint32_t request_size) override;
 
 private:
   enum class phase_t
@@ -85,6 +86,8 @@ private:
   emscripten::val _pool; // globalThis.__dewDecodePool
   uint64_t _next_handle = 1;
   std::unordered_map<uint64_t, pending_t> _pending;
+  // Read-aheads: raw reads that only warm the cache, never posted to a worker. Same handle space as _pending.
+  std::unordered_map<uint64_t, std::array<std::shared_ptr<read_request_t>, 4>> _prefetching;
 };
 
 } // namespace dew::converter
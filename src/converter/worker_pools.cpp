@@ -0,0 +1,309 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "worker_pools.hpp"
+
+#include "buffer_pool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+namespace dew::converter
+{
+
+bool parse_cpu_list(std::string_view text, std::vector<int> &cpus)
+{
+  cpus.clear();
+  while (!text.empty() && (text.back() == '\n' || text.back() == ' '))
+    text.remove_suffix(1);
+  if (text.empty())
+    return true; // memory-only node
+  auto parse_int = [](std::string_view s, int &out) {
+    if (s.empty())
+      return false;
+    int value = 0;
+    for (char c : s)
+    {
+      if (c < '0' || c > '9')
+        return false;
+      value = value * 10 + (c - '0');
+    }
+    out = value;
+    return true;
+  };
+  while (!text.empty())
+  {
+    auto comma = text.find(',');
+    auto range = text.substr(0, comma);
+    text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    int first = 0;
+    int last = 0;
+    auto dash = range.find('-');
+    if (dash == std::string_view::npos)
+    {
+      if (!parse_int(range, first))
+        return false;
+      last = first;
+    }
+    else if (!parse_int(range.substr(0, dash), first) || !parse_int(range.substr(dash + 1), last) || last < first)
+    {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; cpu++)
+      cpus.push_back(cpu);
+  }
+  return true;
+}
+
+std::vector<numa_node_t> detect_numa_topology(const std::string &sysfs_root)
+{
+  std::vector<numa_node_t> nodes;
+#if defined(__linux__)
+  DIR *dir = opendir(sysfs_root.c_str());
+  if (!dir)
+    return nodes;
+  while (auto *entry = readdir(dir))
+  {
+    std::string_view name(entry->d_name);
+    if (!name.starts_with("node") || name.size() == 4)
+      continue;
+    uint32_t id = 0;
+    bool numeric = true;
+    for (char c : name.substr(4))
+    {
+      if (c < '0' || c > '9')
+      {
+        numeric = false;
+        break;
+      }
+      id = id * 10 + uint32_t(c - '0');
+    }
+    if (!numeric)
+      continue;
+    std::ifstream file(sysfs_root + "/" + std::string(name) + "/cpulist");
+    std::string line;
+    if (!file || !std::getline(file, line))
+      continue;
+    numa_node_t node;
+    node.id = id;
+    if (!parse_cpu_list(line, node.cpus) || node.cpus.empty())
+      continue;
+    nodes.push_back(std::move(node));
+  }
+  closedir(dir);
+  std::sort(nodes.begin(), nodes.end(), [](const numa_node_t &a, const numa_node_t &b) { return a.id < b.id; });
+#else
+  (void)sysfs_root;
+#endif
+  return nodes;
+}
+
+struct worker_pools_t::node_pool_t
+{
+  numa_node_t node;
+  std::unique_ptr<vio::thread_pool_t> pool;
+  mutable std::mutex mutex;
+#if defined(__linux__)
+  std::vector<clockid_t> worker_clocks;
+#endif
+};
+
+// Shared-pool workers held in a wait until join(), so the node pools do not come on top of them.
+struct worker_pools_t::park_t
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  uint32_t parked = 0;
+  bool released = false;
+};
+
+worker_pools_t::worker_pools_t(vio::thread_pool_t &shared_pool, uint32_t shared_workers)
+  : _shared_pool(shared_pool)
+  , _shared_workers(shared_workers)
+{
+}
+
+worker_pools_t::~worker_pools_t()
+{
+  join();
+}
+
+bool worker_pools_t::enable_numa(const std::vector<numa_node_t> &nodes)
+{
+  if (!_nodes.empty() || _joined || nodes.size() < 2)
+    return false;
+
+  // Pin every worker up front: each pool gets one startup task per thread, and the tasks hold their
+  // threads until all of them have arrived, so every thread runs exactly one and is pinned before any
+  // routed work can reach it. The state is shared: tasks may still be leaving the wait when we return.
+  struct arrival_t
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t expected = 0;
+    size_t arrived = 0;
+  };
+  auto arrival = std::make_shared<arrival_t>();
+  for (auto &node : nodes)
+    arrival->expected += node.cpus.size();
+
+  for (uint32_t index = 0; index < uint32_t(nodes.size()); index++)
+  {
+    auto node_pool = std::make_unique<node_pool_t>();
+    node_pool->node = nodes[index];
+    node_pool->pool = std::make_unique<vio::thread_pool_t>(int(nodes[index].cpus.size()));
+    _nodes.push_back(std::move(node_pool));
+  }
+  for (uint32_t index = 0; index < uint32_t(_nodes.size()); index++)
+  {
+    auto *node_pool = _nodes[index].get();
+    for (size_t worker = 0; worker < node_pool->node.cpus.size(); worker++)
+    {
+      node_pool->pool->enqueue([node_pool, index, arrival] {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : node_pool->node.cpus)
+        {
+          if (cpu >= 0 && cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // best effort: a cpuset may forbid it
+        clockid_t clock;
+        if (pthread_getcpuclockid(pthread_self(), &clock) == 0)
+        {
+          std::unique_lock<std::mutex> lock(node_pool->mutex);
+          node_pool->worker_clocks.push_back(clock);
+        }
+#endif
+        buffer_pool_t::set_thread_node(index);
+        std::unique_lock<std::mutex> lock(arrival->mutex);
+        arrival->arrived++;
+        arrival->condition.notify_all();
+        arrival->condition.wait(lock, [&] { return arrival->arrived == arrival->expected; });
+      });
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(arrival->mutex);
+    arrival->condition.wait(lock, [&] { return arrival->arrived == arrival->expected; });
+  }
+
+  // The shared pool keeps a worker per node, and at least two: tree shards, pre-init, uploads and the
+  // blob reader's decompress hops still run there, and some of them wait on each other.
+  const uint32_t keep = std::max<uint32_t>(2, uint32_t(nodes.size()));
+  _park = std::make_shared<park_t>();
+  for (uint32_t worker = keep; worker < _shared_workers; worker++)
+  {
+    _shared_pool.enqueue_detached([park = _park] {
+      std::unique_lock<std::mutex> lock(park->mutex);
+      park->parked++;
+      park->condition.wait(lock, [&] { return park->released; });
+      park->parked--;
+    });
+  }
+  _started = std::chrono::steady_clock::now();
+  return true;
+}
+
+uint32_t worker_pools_t::node_for_input(input_data_id_t id) const
+{
+  return _nodes.empty() ? 0 : id.data % uint32_t(_nodes.size());
+}
+
+uint32_t worker_pools_t::node_for_tree(tree_id_t id) const
+{
+  return _nodes.empty() ? 0 : id.data % uint32_t(_nodes.size());
+}
+
+vio::thread_pool_t &worker_pools_t::pool(uint32_t node)
+{
+  if (_nodes.empty() || _joined.load(std::memory_order_acquire))
+    return _shared_pool;
+  return *_nodes[node % _nodes.size()]->pool;
+}
+
+std::vector<numa_node_stats_t> worker_pools_t::sample_stats() const
+{
+  std::vector<numa_node_stats_t> stats;
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - _started).count();
+  for (auto &node_pool : _nodes)
+  {
+    numa_node_stats_t node_stats;
+    node_stats.node = node_pool->node.id;
+    node_stats.workers = uint32_t(node_pool->node.cpus.size());
+#if defined(__linux__)
+    std::unique_lock<std::mutex> lock(node_pool->mutex);
+    for (auto clock : node_pool->worker_clocks)
+    {
+      timespec ts = {};
+      if (clock_gettime(clock, &ts) == 0)
+        node_stats.cpu_seconds += double(ts.tv_sec) + double(ts.tv_nsec) / 1e9;
+    }
+#endif
+    if (wall > 0.0 && node_stats.workers > 0)
+      node_stats.utilization = std::min(1.0, node_stats.cpu_seconds / (wall * node_stats.workers));
+    stats.push_back(node_stats);
+  }
+  return stats;
+}
+
+std::vector<numa_node_stats_t> worker_pools_t::node_stats() const
+{
+  if (_joined.load(std::memory_order_acquire))
+    return _final_stats;
+  return sample_stats();
+}
+
+uint32_t worker_pools_t::parked_shared_workers() const
+{
+  if (!_park)
+    return 0;
+  std::unique_lock<std::mutex> lock(_park->mutex);
+  return _park->parked;
+}
+
+void worker_pools_t::join()
+{
+  if (_joined.load(std::memory_order_acquire))
+    return;
+  // The worker clocks die with their threads; keep the last sample. Published before the flag, and
+  // the flag before the join, so nothing routes onto a pool that is going away.
+  _final_stats = sample_stats();
+  _joined.store(true, std::memory_order_release);
+  for (auto &node_pool : _nodes)
+    node_pool->pool->join();
+  if (_park)
+  {
+    {
+      std::unique_lock<std::mutex> lock(_park->mutex);
+      _park->released = true;
+    }
+    _park->condition.notify_all();
+  }
+}
+
+} // namespace dew::converter
@@ -0,0 +1,135 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Optional per-NUMA-node worker pools.
+//
+// By default every stage of a conversion -- read, sort, compress, LOD, collapse -- runs on the processor's
+// one shared pool, and on a multi-socket machine a chunk read on one socket is routinely sorted and
+// compressed on the other, every pass pulling its buffers across the interconnect. With NUMA pools
+// enabled there is one pool per node, each worker pinned to its node's CPUs and tagged with the node so
+// the point buffer pool hands it buffers from that node's free list (fresh ones are placed by the
+// worker's first write). Work is then routed by affinity:
+//  - an input chunk is read, sorted and compressed on node_for_input(id): the reader runs on that pool,
+//    so its buffers are first-touched there, and the storage write compresses on the node recorded in
+//    the buffers' deleter;
+//  - LOD and collapse jobs run on node_for_tree(subtree), so one subtree's passes stay on one node.
+// Everything else (tree shards, pre-init, uploads) stays on the shared pool. The node pools together
+// have a worker per CPU, so all but a few of the shared pool's workers are parked while they run --
+// otherwise the machine would have two workers per CPU.
+//
+// Single-node machines, non-Linux platforms and the default configuration never enable the per-node
+// pools; every pool_for_* then returns the shared pool and behaviour is exactly the single-pool one.
+
+#include "dataset_types.hpp"
+#include "tree.hpp"
+
+#include <vio/thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dew::converter
+{
+using namespace dew::core;
+
+struct numa_node_t
+{
+  uint32_t id = 0;
+  std::vector<int> cpus;
+};
+
+// Parse a kernel cpulist ("0-3,8,10-11"); false on malformed input.
+bool parse_cpu_list(std::string_view text, std::vector<int> &cpus);
+
+// Nodes with at least one CPU, from <sysfs_root>/node<N>/cpulist. Empty when the directory is missing
+// (non-NUMA kernels, containers without sysfs) and always empty off Linux.
+std::vector<numa_node_t> detect_numa_topology(const std::string &sysfs_root = "/sys/devices/system/node");
+
+struct numa_node_stats_t
+{
+  uint32_t node = 0;
+  uint32_t workers = 0;
+  double cpu_seconds = 0.0; // CPU time consumed by the node's workers
+  double utilization = 0.0; // cpu_seconds / (workers * wall time since the pools started), 0..1
+};
+
+class worker_pools_t
+{
+public:
+  // `shared_workers` is how many threads shared_pool was started with.
+  worker_pools_t(vio::thread_pool_t &shared_pool, uint32_t shared_workers);
+  ~worker_pools_t();
+  worker_pools_t(const worker_pools_t &) = delete;
+  worker_pools_t &operator=(const worker_pools_t &) = delete;
+
+  // Start one pinned pool per node and park the shared workers it no longer needs; returns false (and
+  // changes nothing) for fewer than two nodes or when already enabled. Must happen before any work is
+  // routed.
+  bool enable_numa(const std::vector<numa_node_t> &nodes);
+  bool numa_enabled() const
+  {
+    return !_nodes.empty();
+  }
+  uint32_t node_count() const
+  {
+    return _nodes.empty() ? 1 : uint32_t(_nodes.size());
+  }
+
+  uint32_t node_for_input(input_data_id_t id) const;
+  uint32_t node_for_tree(tree_id_t id) const;
+  vio::thread_pool_t &pool(uint32_t node);
+  vio::thread_pool_t &pool_for_input(input_data_id_t id)
+  {
+    return pool(node_for_input(id));
+  }
+  vio::thread_pool_t &pool_for_tree(tree_id_t id)
+  {
+    return pool(node_for_tree(id));
+  }
+
+  // Per-node worker CPU time and utilization; empty unless NUMA pools are enabled.
+  std::vector<numa_node_stats_t> node_stats() const;
+  // Shared-pool workers currently parked.
+  uint32_t parked_shared_workers() const;
+
+  // Join the per-node pools and release the parked shared workers (the shared pool is its owner's to
+  // join, after this). Stats stay readable afterwards.
+  void join();
+
+private:
+  struct node_pool_t;
+  struct park_t;
+  std::vector<numa_node_stats_t> sample_stats() const;
+
+  vio::thread_pool_t &_shared_pool;
+  uint32_t _shared_workers;
+  std::vector<std::unique_ptr<node_pool_t>> _nodes;
+  std::shared_ptr<park_t> _park;
+  std::chrono::steady_clock::time_point _started;
+  // Read by pool() on every loop that routes work, written by join().
+  std::atomic<bool> _joined = false;
+  std::vector<numa_node_stats_t> _final_stats;
+};
+
+} // namespace dew::converter
@@ -0,0 +1,318 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "attribute_precision.hpp"
+#include "format_util.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace dew::core
+{
+namespace
+{
+// Follows the compression header of a quantized blob; the packed values' own PCM blob comes after it.
+struct precision_header_t
+{
+  double offset; // r32/r64: value = offset + stored * step
+  double step;
+  uint64_t int_offset; // integers: value = int_offset + (stored << shift), in the order-preserving unsigned domain
+  uint8_t source_type;
+  uint8_t stored_type;
+  uint8_t shift;
+  uint8_t reserved[5];
+};
+static_assert(sizeof(precision_header_t) == 32, "precision_header_t must be 32 bytes");
+
+constexpr uint64_t k_sign_bit = uint64_t(1) << 63;
+
+bool is_float_type(dew_type_t type)
+{
+  return type == dew_type_r32 || type == dew_type_r64;
+}
+
+bool is_integer_type(dew_type_t type)
+{
+  switch (type)
+  {
+  case dew_type_u8:
+  case dew_type_i8:
+  case dew_type_u16:
+  case dew_type_i16:
+  case dew_type_u32:
+  case dew_type_i32:
+  case dew_type_u64:
+  case dew_type_i64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool is_signed_type(dew_type_t type)
+{
+  return type == dew_type_i8 || type == dew_type_i16 || type == dew_type_i32 || type == dew_type_i64;
+}
+
+double read_float(const uint8_t *data, dew_type_t type, uint32_t index)
+{
+  if (type == dew_type_r32)
+  {
+    float v;
+    memcpy(&v, data + size_t(index) * 4, 4);
+    return v;
+  }
+  double v;
+  memcpy(&v, data + size_t(index) * 8, 8);
+  return v;
+}
+
+void write_float(uint8_t *data, dew_type_t type, uint32_t index, double value)
+{
+  if (type == dew_type_r32)
+  {
+    float v = float(value);
+    memcpy(data + size_t(index) * 4, &v, 4);
+    return;
+  }
+  memcpy(data + size_t(index) * 8, &value, 8);
+}
+
+// Integers of every width and sign map onto uint64 so that the order is kept: sign-extended and with the
+// sign bit flipped for the signed types.
+uint64_t read_ordered(const uint8_t *data, dew_type_t type, uint32_t index)
+{
+  int size = size_for_format(type);
+  uint64_t raw = 0;
+  memcpy(&raw, data + size_t(index) * size, size_t(size));
+  if (!is_signed_type(type))
+    return raw;
+  int shift = 64 - size * 8;
+  int64_t extended = int64_t(raw << shift) >> shift;
+  return uint64_t(extended) ^ k_sign_bit;
+}
+
+void write_ordered(uint8_t *data, dew_type_t type, uint32_t index, uint64_t value)
+{
+  if (is_signed_type(type))
+    value ^= k_sign_bit;
+  memcpy(data + size_t(index) * size_for_format(type), &value, size_t(size_for_format(type)));
+}
+
+dew_type_t narrowest_unsigned(uint64_t max_value)
+{
+  if (max_value <= 0xff)
+    return dew_type_u8;
+  if (max_value <= 0xffff)
+    return dew_type_u16;
+  if (max_value <= 0xffffffff)
+    return dew_type_u32;
+  return dew_type_u64;
+}
+
+uint64_t read_unsigned(const uint8_t *data, dew_type_t type, uint32_t index)
+{
+  uint64_t value = 0;
+  memcpy(&value, data + size_t(index) * size_for_format(type), size_t(size_for_format(type)));
+  return value;
+}
+
+void write_unsigned(uint8_t *data, dew_type_t type, uint32_t index, uint64_t value)
+{
+  memcpy(data + size_t(index) * size_for_format(type), &value, size_t(size_for_format(type)));
+}
+
+compression_header_t make_header(compression_method_t method, const point_format_t &format, uint32_t uncompressed_size, uint32_t compressed_size)
+{
+  compression_header_t header;
+  header.magic[0] = 'P';
+  header.magic[1] = 'C';
+  header.magic[2] = 'M';
+  header.magic[3] = 1;
+  header.method = method;
+  header.type_size = uint8_t(size_for_format(format.type));
+  header.component_count = uint8_t(format.components);
+  header.flags = 0;
+  header.uncompressed_size = uncompressed_size;
+  header.compressed_size = compressed_size;
+  return header;
+}
+} // namespace
+
+compression_result_t compress_with_precision(compressor_t *compressor, const void *data, uint32_t size, const point_format_t &format, uint32_t point_count, const attribute_precision_t &precision,
+                                             double &max_error)
+{
+  compression_result_t result;
+  max_error = 0;
+  if (!precision.enabled || !(precision.tolerance >= 0) || !(is_float_type(format.type) || is_integer_type(format.type)))
+    return result;
+  int type_size = size_for_format(format.type);
+  uint32_t count = size / uint32_t(type_size);
+  if (count == 0 || size % uint32_t(type_size) != 0)
+    return result;
+  auto bytes = static_cast<const uint8_t *>(data);
+
+  precision_header_t precision_header = {};
+  precision_header.source_type = uint8_t(format.type);
+  std::vector<uint64_t> steps(count);
+  if (is_float_type(format.type))
+  {
+    if (!(precision.tolerance > 0))
+      return result;
+    double min_value = std::numeric_limits<double>::max();
+    double max_value = std::numeric_limits<double>::lowest();
+    for (uint32_t i = 0; i < count; i++)
+    {
+      double v = read_float(bytes, format.type, i);
+      if (!std::isfinite(v))
+        return result;
+      min_value = std::min(min_value, v);
+      max_value = std::max(max_value, v);
+    }
+    double step = precision.tolerance;
+    if (!((max_value - min_value) / step < 9.0e18))
+      return result;
+    for (uint32_t i = 0; i < count; i++)
+      steps[i] = uint64_t(std::llround((read_float(bytes, format.type, i) - min_value) / step));
+    precision_header.offset = min_value;
+    precision_header.step = step;
+    // Half a step, plus the rounding of the restore's multiply-add at this magnitude, plus -- for r32 --
+    // the rounding of the restored value to float: half an ulp, |v| * 2^-24. A restored value may sit
+    // half a step past the extremes, so the magnitude includes a step.
+    const double magnitude = std::max(std::abs(min_value), std::abs(max_value)) + step;
+    const double restore_epsilon = format.type == dew_type_r32 ? 0x1p-24 : 0.0;
+    max_error = step / 2 + magnitude * (restore_epsilon + 0x1p-50);
+  }
+  else
+  {
+    // Rounding down to a multiple of 2^low_bits errs by at most 2^low_bits - 1 and never leaves the type's range.
+    int low_bits = 0;
+    while (low_bits < type_size * 8 - 1 && double((uint64_t(1) << (low_bits + 1)) - 1) <= precision.tolerance)
+      low_bits++;
+    uint64_t low_mask = ~((uint64_t(1) << low_bits) - 1);
+    uint64_t min_value = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < count; i++)
+    {
+      steps[i] = read_ordered(bytes, format.type, i) & low_mask;
+      min_value = std::min(min_value, steps[i]);
+    }
+    uint64_t set_bits = 0;
+    for (auto &value : steps)
+    {
+      value -= min_value;
+      set_bits |= value;
+    }
+    uint8_t shift = set_bits ? uint8_t(std::countr_zero(set_bits)) : 0;
+    for (auto &value : steps)
+      value >>= shift;
+    precision_header.int_offset = min_value;
+    precision_header.shift = shift;
+    max_error = double((uint64_t(1) << low_bits) - 1);
+  }
+
+  uint64_t max_step = 0;
+  for (auto value : steps)
+    max_step = std::max(max_step, value);
+  dew_type_t stored_type = narrowest_unsigned(max_step);
+  precision_header.stored_type = uint8_t(stored_type);
+  point_format_t stored_format(stored_type, format.components);
+  uint32_t stored_size = count * uint32_t(size_for_format(stored_type));
+  auto packed = std::make_unique<uint8_t[]>(stored_size);
+  for (uint32_t i = 0; i < count; i++)
+    write_unsigned(packed.get(), stored_type, i, steps[i]);
+
+  auto inner = try_compress_constant(packed.get(), stored_size, stored_format);
+  if (!inner.data && compressor)
+    inner = compressor->compress(packed.get(), stored_size, stored_format, point_count);
+  if (!inner.data || inner.error.code != 0)
+  {
+    // Stored as is: the envelope still has to hold a PCM blob.
+    inner = {};
+    inner.size = uint32_t(sizeof(compression_header_t)) + stored_size;
+    inner.data = std::make_shared<uint8_t[]>(inner.size);
+    auto header = make_header(compression_method_t::none, stored_format, stored_size, stored_size);
+    memcpy(inner.data.get(), &header, sizeof(header));
+    memcpy(inner.data.get() + sizeof(header), packed.get(), stored_size);
+  }
+
+  uint32_t payload_size = uint32_t(sizeof(precision_header_t)) + inner.size;
+  auto header = make_header(compression_method_t::quantized, format, size, payload_size);
+  // The packed values' preprocessing flags, for the compression stats.
+  compression_header_t inner_header;
+  memcpy(&inner_header, inner.data.get(), sizeof(inner_header));
+  header.flags = inner_header.flags;
+
+  result.size = uint32_t(sizeof(compression_header_t)) + payload_size;
+  result.data = std::make_shared<uint8_t[]>(result.size);
+  memcpy(result.data.get(), &header, sizeof(header));
+  memcpy(result.data.get() + sizeof(header), &precision_header, sizeof(precision_header));
+  memcpy(result.data.get() + sizeof(header) + sizeof(precision_header), inner.data.get(), inner.size);
+  return result;
+}
+
+compression_result_t decompress_quantized(const void *data, uint32_t size)
+{
+  compression_result_t result;
+  compression_header_t header;
+  precision_header_t precision_header;
+  if (size < sizeof(header) + sizeof(precision_header))
+  {
+    result.error = {-1, "Quantized blob too small"};
+    return result;
+  }
+  auto bytes = static_cast<const uint8_t *>(data);
+  memcpy(&header, bytes, sizeof(header));
+  memcpy(&precision_header, bytes + sizeof(header), sizeof(precision_header));
+  auto source_type = dew_type_t(precision_header.source_type);
+  auto stored_type = dew_type_t(precision_header.stored_type);
+  if (!(is_float_type(source_type) || is_integer_type(source_type)) || !is_integer_type(stored_type) || is_signed_type(stored_type) || header.type_size != size_for_format(source_type) ||
+      header.uncompressed_size % header.type_size != 0 || precision_header.shift > 63)
+  {
+    result.error = {-1, "Invalid quantized blob header"};
+    return result;
+  }
+
+  auto inner = decompress_any(bytes + sizeof(header) + sizeof(precision_header), size - uint32_t(sizeof(header) + sizeof(precision_header)));
+  if (inner.error.code != 0)
+    return inner;
+  uint32_t count = header.uncompressed_size / header.type_size;
+  if (inner.size != count * uint32_t(size_for_format(stored_type)))
+  {
+    result.error = {-1, "Quantized blob size mismatch"};
+    return result;
+  }
+
+  auto output = std::make_shared<uint8_t[]>(header.uncompressed_size);
+  if (is_float_type(source_type))
+  {
+    for (uint32_t i = 0; i < count; i++)
+      write_float(output.get(), source_type, i, precision_header.offset + double(read_unsigned(inner.data.get(), stored_type, i)) * precision_header.step);
+  }
+  else
+  {
+    for (uint32_t i = 0; i < count; i++)
+      write_ordered(output.get(), source_type, i, precision_header.int_offset + (read_unsigned(inner.data.get(), stored_type, i) << precision_header.shift));
+  }
+  result.data = std::move(output);
+  result.size = header.uncompressed_size;
+  return result;
+}
+} // namespace dew::core
@@ -0,0 +1,57 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Lossy-but-bounded storage precision for point attributes.
+//
+// Many attributes carry more precision than the instrument delivered: LAS gps_time is an f64 where
+// microseconds within a flight line are all anyone reads, and 12-bit intensity is scaled into a u16 with
+// its low bits always zero. With a policy set for an attribute (attributes_configs_t::
+// set_attribute_precision), every buffer of it is packed before compression:
+//  - r32/r64 values become unsigned integers counting steps of `tolerance` above the buffer minimum, so a
+//    restored value is within tolerance / 2 of the original (plus the restore's own rounding);
+//  - integer values are rounded to a multiple of 2^low_bits (low_bits = the smallest that keeps the
+//    error within tolerance; tolerance 0 rounds nothing), then shifted right past every bit that is zero
+//    in all of them -- lossless in itself -- after subtracting the buffer minimum.
+// The packed values are stored in the narrowest unsigned type that holds them and compressed as usual;
+// the blob is a compression_method_t::quantized envelope carrying the restore parameters, so
+// decompress_any hands every reader (render, query, LOD, collapse) the attribute in its declared type.
+// Re-packing restored values reproduces them exactly, so collapse and LOD rewrites do not add error.
+
+#include "compressor.hpp"
+
+#include <cstdint>
+
+namespace dew::core
+{
+struct attribute_precision_t
+{
+  bool enabled = false;
+  double tolerance = 0; // largest acceptable difference between a stored and a restored value
+};
+
+// Packs `data` per `precision` and compresses the packed values with `compressor` (null: stored
+// uncompressed). Returns an empty result when the policy does not apply to the buffer -- a morton or
+// unsupported type, non-finite values, or a range too wide for 64-bit steps -- and the caller stores
+// it losslessly. `max_error` receives the largest difference a restored value can have.
+compression_result_t compress_with_precision(compressor_t *compressor, const void *data, uint32_t size, const point_format_t &format, uint32_t point_count, const attribute_precision_t &precision,
+                                             double &max_error);
+
+// decompress_any's compression_method_t::quantized case.
+compression_result_t decompress_quantized(const void *data, uint32_t size);
+} // namespace dew::core
@@ -0,0 +1,81 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Per-unit attribute zone maps: what values one storage unit holds in one attribute.
+//
+// Recorded at write time next to the unit's storage locations (input_storage_map_t), so a query can
+// rule a node out from the tree alone, before reading a single blob. Every zone has the value range;
+// single-component u8 attributes -- classification, return number, user data -- also get the exact
+// set of values present as a 256-bit map, which is what makes "classification in {2, 6}" prunable
+// when a range alone would span the whole domain.
+//
+// A zone may only ever be WIDER than the values it describes, never narrower: a query skips whatever
+// a zone rules out. LOD units rely on that -- their zone is the union over the whole subtree below
+// them (attribute_zone_subtree), not just the sampled points, so ruling one out skips the subtree.
+
+#include <cstdint>
+#include <limits>
+
+namespace dew::core
+{
+
+inline constexpr uint32_t attribute_zone_has_range = 1u << 0;
+inline constexpr uint32_t attribute_zone_has_values = 1u << 1;
+inline constexpr uint32_t attribute_zone_subtree = 1u << 2;
+
+// Written as-is into the tree blob: keep it trivially copyable and free of padding.
+struct attribute_zone_t
+{
+  double min = std::numeric_limits<double>::max();
+  double max = std::numeric_limits<double>::lowest();
+  uint64_t value_bits[4] = {};
+  uint32_t flags = 0; // 0 = nothing known, the unit may hold any value
+  uint32_t reserved = 0;
+};
+static_assert(sizeof(attribute_zone_t) == 56, "attribute_zone_t is serialized verbatim");
+
+inline bool attribute_zone_has_value(const attribute_zone_t &zone, uint32_t value)
+{
+  return value < 256 && (zone.value_bits[value >> 6] >> (value & 63)) & 1;
+}
+
+// Widen `into` to also cover `other`. Anything one side does not know, the union does not know.
+inline void attribute_zone_merge(attribute_zone_t &into, const attribute_zone_t &other)
+{
+  if (!(other.flags & attribute_zone_has_range))
+  {
+    into.flags = 0;
+    return;
+  }
+  if (other.min < into.min)
+    into.min = other.min;
+  if (other.max > into.max)
+    into.max = other.max;
+  if (other.flags & attribute_zone_has_values)
+  {
+    for (int i = 0; i < 4; i++)
+      into.value_bits[i] |= other.value_bits[i];
+  }
+  else
+  {
+    into.flags &= ~attribute_zone_has_values;
+  }
+}
+
+} // namespace dew::core
@@ -303,6 +303,42 @@ attribute_index_t attributes_configs_t::get_attribute_index(attributes_id_t id,
   return {-1, {}};
 }
 
+attribute_index_t attributes_configs_t::find_attribute(const std::string &name) const
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (const auto &config : _attributes_configs)
+  {
+    for (int i = 0; i < int(config.attributes.attributes.size()); i++)
+    {
+      auto &attrib = config.attributes.attributes[i];
+      if (attrib.name_size == name.size() && memcmp(attrib.name, name.data(), name.size()) == 0)
+        return {i, {attrib.type, attrib.components}};
+    }
+  }
+  return {-1, {}};
+}
+
+void attributes_configs_t::set_attribute_precision(const std::string &name, const attribute_precision_t &precision)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto it = std::find_if(_attribute_precision.begin(), _attribute_precision.end(), [&name](const std::pair<std::string, attribute_precision_t> &entry) { return entry.first == name; });
+  if (it != _attribute_precision.end())
+    it->second = precision;
+  else
+    _attribute_precision.emplace_back(name, precision);
+}
+
+attribute_precision_t attributes_configs_t::get_attribute_precision(const std::string &name) const
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (auto &entry : _attribute_precision)
+  {
+    if (entry.first == name)
+      return entry.second;
+  }
+  return {};
+}
+
 serialized_attributes_t attributes_configs_t::serialize() const
 {
   auto count = uint32_t(_attributes_configs.size());
@@ -18,13 +18,17 @@
 #ifndef ATTRIBUTES_CONFIGS_HPP
 #define ATTRIBUTES_CONFIGS_HPP
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include <dataset_types.hpp>
 
+#include "attribute_precision.hpp"
+
 namespace dew::core
 {
 
@@ -85,6 +89,8 @@ public:
   point_format_t get_point_format(attributes_id_t id);
 
   attribute_index_t get_attribute_index(attributes_id_t id, const std::string &name) const;
+  // `name` as the first config carrying it has it; index -1 when no config does.
+  attribute_index_t find_attribute(const std::string &name) const;
 
   serialized_attributes_t serialize() const;
   [[nodiscard]] dew_error_t deserialize(const std::unique_ptr<uint8_t[]> &data, uint32_t size);
@@ -92,6 +98,11 @@ public:
   uint32_t attrib_name_registry_count() const;
   uint32_t attrib_name_registry_get(uint32_t index, char *name, uint32_t buffer_size) const;
 
+  // Storage precision policy by attribute name (attribute_precision.hpp), applied to every buffer of that
+  // attribute the storage handler writes. Not persisted: the blobs carry what is needed to restore them.
+  void set_attribute_precision(const std::string &name, const attribute_precision_t &precision);
+  attribute_precision_t get_attribute_precision(const std::string &name) const;
+
 private:
   mutable std::mutex _mutex;
   // std::deque (not std::vector): get() and the LOD-mapping accessors hand out references into
@@ -100,6 +111,7 @@ private:
   // concurrent worker registering a new config cannot dangle another worker's held reference.
   std::deque<attribute_config_t> _attributes_configs;
   std::vector<std::string> _attribute_name_registry;
+  std::vector<std::pair<std::string, attribute_precision_t>> _attribute_precision;
 };
 
 } // namespace dew::core
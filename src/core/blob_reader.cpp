@@ -218,6 +218,7 @@ std::shared_ptr<read_request_t> blob_reader_t::read(storage_location_t location,
     if (decompressed_hit.has_value())
     {
       _perf_stats.cache_hits.fetch_add(1, std::memory_order_relaxed);
+      ret->cache_hit = true;
       ret->buffer = decompressed_hit->data;
       ret->buffer_info.data = ret->buffer.get();
       ret->buffer_info.size = decompressed_hit->size;
@@ -229,6 +230,7 @@ std::shared_ptr<read_request_t> blob_reader_t::read(storage_location_t location,
   if (cached.has_value())
   {
     _perf_stats.cache_hits.fetch_add(1, std::memory_order_relaxed);
+    ret->cache_hit = true;
     auto &cv = cached.value();
     if (raw)
     {
@@ -88,6 +88,12 @@ struct read_request_t
   void wait_for_read();
   void set_cancelled() { _cancelled.store(true, std::memory_order_relaxed); }
   bool is_cancelled() const { return _cancelled.load(std::memory_order_relaxed); }
+  // Non-blocking poll for pollers that neither park in wait_for_read nor co_await (the render prefetch).
+  bool is_done()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _done;
+  }
 
   std::shared_ptr<uint8_t[]> buffer;
   dew_blob_t buffer_info;
@@ -95,6 +101,7 @@ struct read_request_t
 
   bool raw = false; // when set, read() returns the COMPRESSED bytes as-is (no decompress) -- used by the
                     // wasm decode-worker path, which decompresses off the main thread.
+  bool cache_hit = false; // served from a cache, never a backend read; set before read() returns
   bool _done = false;
   std::atomic_bool _cancelled{false};
   std::mutex _mutex;
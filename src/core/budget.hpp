@@ -42,6 +42,7 @@ struct derived_budgets_t
   uint64_t decoded_backlog_cap = 0;      // in-flight + decoded-awaiting-upload CPU bytes across the render list
   uint64_t cpu_resident_budget = 0;      // virtual-subtree resident sources + salvage handlers
   int io_clamp = 0;                      // effective max_in_flight_io = min(user knob, io_clamp)
+  uint64_t buffer_pool_bytes = 0;        // freed point-chunk buffers the buffer pool keeps for reuse
 };
 
 // Split the one total budget B into the pools that bound CPU-heap growth. The remaining ~B/4 is deliberate
@@ -59,6 +60,9 @@ inline derived_budgets_t derive_budgets(uint64_t total_bytes)
   d.decoded_backlog_cap = std::clamp<uint64_t>(total_bytes / 4, 24 * mb, 256 * mb);
   d.cpu_resident_budget = std::clamp<uint64_t>(total_bytes / 4, 32 * mb, 256 * mb);
   d.io_clamp = int(std::clamp<uint64_t>(d.decoded_backlog_cap / (4 * mb), 4, 64));
+  // The write pipeline's chunk buffers (reader, sort, storage write), not the render pools above: room for
+  // a few 64MB read chunks' worth of attributes at the default budget.
+  d.buffer_pool_bytes = std::clamp<uint64_t>(total_bytes / 4, 32 * mb, 512 * mb);
   return d;
 }
 
@@ -0,0 +1,236 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "buffer_pool.hpp"
+
+#include "budget.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/heap.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace dew::core
+{
+
+static constexpr uint32_t k_min_class_shift = 16; // sizes <= 64KB are not pooled
+static constexpr uint32_t k_max_class_shift = 30; // sizes > 1GB are not pooled
+static constexpr uint32_t k_class_count = (k_max_class_shift - k_min_class_shift) * 4 + 1;
+
+static thread_local uint32_t t_thread_node = 0;
+
+static uint64_t elapsed_us(std::chrono::steady_clock::time_point start)
+{
+  return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void point_buffer_deleter_t::operator()(uint8_t *data) const
+{
+  if (size_class == 0)
+    delete[] data;
+  else
+    point_buffer_pool().release(data, size_class, node);
+}
+
+buffer_pool_t::buffer_pool_t(uint64_t retain_limit)
+  : _free(k_class_count)
+  , _retain_limit(retain_limit)
+{
+}
+
+buffer_pool_t::~buffer_pool_t()
+{
+  for (auto &list : _free)
+  {
+    for (auto *data : list)
+      delete[] data;
+  }
+}
+
+void buffer_pool_t::set_thread_node(uint32_t node)
+{
+  t_thread_node = node;
+}
+
+uint32_t buffer_pool_t::thread_node()
+{
+  return t_thread_node;
+}
+
+std::vector<uint8_t *> &buffer_pool_t::free_list_locked(uint32_t node, uint32_t size_class)
+{
+  const size_t index = size_t(node) * k_class_count + size_class;
+  if (index >= _free.size())
+    _free.resize((size_t(node) + 1) * k_class_count);
+  return _free[index];
+}
+
+uint32_t buffer_pool_t::class_for(uint64_t size)
+{
+  if (size <= (uint64_t(1) << k_min_class_shift) || size > (uint64_t(1) << k_max_class_shift))
+    return 0;
+  const auto shift = uint32_t(std::bit_width(size - 1)) - 1; // size in (2^shift, 2^(shift+1)]
+  const uint64_t base = uint64_t(1) << shift;
+  const uint64_t step = base / 4;
+  const auto quarter = uint32_t((size - base + step - 1) / step); // 1..4
+  return (shift - k_min_class_shift) * 4 + quarter;
+}
+
+uint64_t buffer_pool_t::class_bytes(uint32_t size_class)
+{
+  const uint32_t shift = k_min_class_shift + (size_class - 1) / 4;
+  const uint32_t quarter = (size_class - 1) % 4 + 1;
+  const uint64_t base = uint64_t(1) << shift;
+  return base + quarter * (base / 4);
+}
+
+point_buffer_t buffer_pool_t::acquire(uint64_t size)
+{
+  const uint32_t size_class = class_for(size);
+  if (size_class == 0)
+  {
+    auto start = std::chrono::steady_clock::now();
+    point_buffer_t buffer(new uint8_t[size]);
+    auto us = elapsed_us(start);
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stats.misses++;
+    _stats.allocation_time_us += us;
+    return buffer;
+  }
+
+  const uint64_t bytes = class_bytes(size_class);
+  const uint32_t node = t_thread_node;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stats.outstanding_bytes += bytes;
+    _stats.peak_outstanding_bytes = std::max(_stats.peak_outstanding_bytes, _stats.outstanding_bytes);
+    auto &list = free_list_locked(node, size_class);
+    if (!list.empty())
+    {
+      auto *data = list.back();
+      list.pop_back();
+      _stats.retained_bytes -= bytes;
+      _stats.hits++;
+      return point_buffer_t(data, point_buffer_deleter_t(size_class, node));
+    }
+    _stats.misses++;
+  }
+  // A fresh buffer's pages are placed by the first write, which the acquiring thread is about to do.
+  auto start = std::chrono::steady_clock::now();
+  point_buffer_t buffer(new uint8_t[bytes], point_buffer_deleter_t(size_class, node));
+  auto us = elapsed_us(start);
+  std::unique_lock<std::mutex> lock(_mutex);
+  _stats.allocation_time_us += us;
+  return buffer;
+}
+
+void buffer_pool_t::release(uint8_t *data, uint32_t size_class, uint32_t node)
+{
+  const uint64_t bytes = class_bytes(size_class);
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stats.outstanding_bytes -= bytes;
+    if (_stats.retained_bytes + bytes <= _retain_limit)
+    {
+      free_list_locked(node, size_class).push_back(data);
+      _stats.retained_bytes += bytes;
+      return;
+    }
+  }
+  auto start = std::chrono::steady_clock::now();
+  delete[] data;
+  auto us = elapsed_us(start);
+  std::unique_lock<std::mutex> lock(_mutex);
+  _stats.allocation_time_us += us;
+}
+
+void buffer_pool_t::trim_locked(std::vector<uint8_t *> &to_free)
+{
+  // Largest classes first: the fewest frees to get under the cap.
+  const size_t node_count = _free.size() / k_class_count;
+  for (uint32_t size_class = k_class_count - 1; size_class > 0 && _stats.retained_bytes > _retain_limit; size_class--)
+  {
+    const uint64_t bytes = class_bytes(size_class);
+    for (size_t node = 0; node < node_count; node++)
+    {
+      auto &list = _free[node * k_class_count + size_class];
+      while (!list.empty() && _stats.retained_bytes > _retain_limit)
+      {
+        to_free.push_back(list.back());
+        list.pop_back();
+        _stats.retained_bytes -= bytes;
+      }
+    }
+  }
+}
+
+void buffer_pool_t::set_retain_limit(uint64_t bytes)
+{
+  std::vector<uint8_t *> to_free;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _retain_limit = bytes;
+    trim_locked(to_free);
+  }
+  for (auto *data : to_free)
+    delete[] data;
+}
+
+buffer_pool_stats_t buffer_pool_t::stats() const
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+buffer_pool_t &point_buffer_pool()
+{
+  // Deliberately leaked: point buffers owned by other statics may be destroyed after any function-local
+  // static would be, and must still find their pool.
+  static auto *pool = new buffer_pool_t(derive_budgets(uint64_t(1) << 30).buffer_pool_bytes);
+  return *pool;
+}
+
+uint64_t process_peak_rss_bytes()
+{
+#if defined(__EMSCRIPTEN__)
+  return uint64_t(emscripten_get_heap_size());
+#elif defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters = {};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return uint64_t(counters.PeakWorkingSetSize);
+#else
+  struct rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return uint64_t(usage.ru_maxrss); // bytes on macOS
+#else
+  return uint64_t(usage.ru_maxrss) * 1024; // kilobytes on Linux
+#endif
+#endif
+}
+
+} // namespace dew::core
@@ -0,0 +1,117 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Recycling pool for point-chunk buffers.
+//
+// A read batch allocates one buffer per attribute, the sort allocates the morton, index and reordered
+// buffers, and all of it is freed once the compressed blobs are written -- tens of megabytes per chunk,
+// gigabytes per minute on a long conversion. Those sizes repeat (every chunk of a file has the same
+// point count), so the pool keeps freed buffers on per-size-class free lists and hands them back out
+// instead of going through malloc each time.
+//
+// The buffers are point_buffer_t: a unique_ptr whose deleter remembers the size class, so a pooled buffer
+// returns itself to the pool wherever it dies -- including inside the shared_ptr the storage write
+// converts it to. Plain new[] buffers convert into point_buffer_t with class 0 and are simply deleted.
+//
+// Classes are quarter steps between powers of two above 64KB (at most 25% slack); smaller and >1GB
+// requests bypass the pool. Retention is capped by the budget's buffer_pool_bytes: a release that would
+// push the retained bytes over the cap frees the buffer instead.
+//
+// With NUMA worker pools (the converter's worker_pools.hpp) each pinned worker tags its thread with its
+// node; free lists are per node and a buffer goes back to the node whose worker first touched it, so a
+// recycled buffer stays local to the workers that will fill it.
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dew::core
+{
+
+struct point_buffer_deleter_t
+{
+  point_buffer_deleter_t() = default;
+  point_buffer_deleter_t(std::default_delete<uint8_t[]>) // NOLINT(google-explicit-constructor): adopt new[] buffers
+  {
+  }
+  point_buffer_deleter_t(uint32_t a_size_class, uint32_t a_node)
+    : size_class(a_size_class)
+    , node(a_node)
+  {
+  }
+
+  uint32_t size_class = 0; // 0: not pooled
+  uint32_t node = 0;       // NUMA node whose free list it returns to
+  void operator()(uint8_t *data) const;
+};
+using point_buffer_t = std::unique_ptr<uint8_t[], point_buffer_deleter_t>;
+
+struct buffer_pool_stats_t
+{
+  uint64_t hits = 0;               // acquires served from a free list
+  uint64_t misses = 0;             // acquires that went to the allocator
+  uint64_t allocation_time_us = 0; // time spent in new[]/delete[] on the pool's slow paths
+  uint64_t outstanding_bytes = 0;  // pooled-class bytes currently handed out
+  uint64_t peak_outstanding_bytes = 0;
+  uint64_t retained_bytes = 0; // bytes parked on the free lists
+};
+
+class buffer_pool_t
+{
+public:
+  explicit buffer_pool_t(uint64_t retain_limit);
+  ~buffer_pool_t();
+  buffer_pool_t(const buffer_pool_t &) = delete;
+  buffer_pool_t &operator=(const buffer_pool_t &) = delete;
+
+  // A buffer of at least `size` bytes (uninitialized, like new[]).
+  point_buffer_t acquire(uint64_t size);
+  // Lower or raise the retention cap; lowering frees retained buffers down to it (0 empties the pool).
+  void set_retain_limit(uint64_t bytes);
+  buffer_pool_stats_t stats() const;
+
+  static uint32_t class_for(uint64_t size);
+  static uint64_t class_bytes(uint32_t size_class);
+
+  // The NUMA node acquires on the calling thread draw from (0 unless a pinned worker set it).
+  static void set_thread_node(uint32_t node);
+  static uint32_t thread_node();
+
+private:
+  friend struct point_buffer_deleter_t;
+  void release(uint8_t *data, uint32_t size_class, uint32_t node);
+  std::vector<uint8_t *> &free_list_locked(uint32_t node, uint32_t size_class);
+  void trim_locked(std::vector<uint8_t *> &to_free);
+
+  mutable std::mutex _mutex;
+  std::vector<std::vector<uint8_t *>> _free; // [node * class count + size class]
+  uint64_t _retain_limit;
+  buffer_pool_stats_t _stats;
+};
+
+// The process-wide pool every point_buffer_t returns to. Sized from derive_budgets() at the default
+// total budget; a consumer with its own budget calls set_retain_limit.
+buffer_pool_t &point_buffer_pool();
+
+// Peak resident set of the process in bytes (the heap size on wasm, where the heap never shrinks);
+// 0 when the platform has no probe.
+uint64_t process_peak_rss_bytes();
+
+} // namespace dew::core
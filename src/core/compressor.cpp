@@ -19,6 +19,7 @@
 #include "compressor_zstd.hpp"
 #include "compressor_fse.hpp"
 #include "compressor_ans.hpp"
+#include "attribute_precision.hpp"
 #include "format_util.hpp"
 
 #include <cstring>
@@ -38,6 +39,7 @@ std::unique_ptr<compressor_t> create_compressor(compression_method_t method)
     return std::make_unique<compressor_ans_t>();
   case compression_method_t::none:
   case compression_method_t::constant:
+  case compression_method_t::quantized:
     return nullptr;
   }
   return nullptr;
@@ -130,6 +132,8 @@ compression_result_t decompress_any(const void *data, uint32_t size)
     compressor_ans_t decompressor;
     return decompressor.decompress(data, size);
   }
+  case compression_method_t::quantized:
+    return decompress_quantized(data, size);
   case compression_method_t::constant:
   {
     uint32_t element_size = static_cast<uint32_t>(header.type_size) * static_cast<uint32_t>(header.component_count);
@@ -210,7 +214,7 @@ void compression_stats_t::accumulate(const std::string &name, const point_format
 std::shared_ptr<uint8_t[]> compression_stats_t::serialize(uint32_t &out_size) const
 {
   // compute total size
-  uint32_t size = 4 + 4 + 4 + 4 + 1 + 3 + 8 + 4; // version, input_file_count, total_buffer_count, lod_buffer_count, method, padding, input_file_size_bytes, attribute_count
+  uint32_t size = 4 + 4 + 4 + 4 + 1 + 3 + 8 + 8 + 4; // version, input_file_count, total_buffer_count, lod_buffer_count, method, padding, input_file_size_bytes, duplicate_points_removed, attribute_count
   for (auto &attr : per_attribute)
   {
     size += 4;                                  // name_size
@@ -226,7 +230,7 @@ std::shared_ptr<uint8_t[]> compression_stats_t::serialize(uint32_t &out_size) co
   auto *ptr = data.get();
   memset(ptr, 0, size);
 
-  uint32_t version = 5;
+  uint32_t version = 6;
   memcpy(ptr, &version, 4); ptr += 4;
   memcpy(ptr, &input_file_count, 4); ptr += 4;
   memcpy(ptr, &total_buffer_count, 4); ptr += 4;
@@ -235,6 +239,7 @@ std::shared_ptr<uint8_t[]> compression_stats_t::serialize(uint32_t &out_size) co
   memcpy(ptr, &m, 1); ptr += 1;
   ptr += 3; // padding
   memcpy(ptr, &input_file_size_bytes, 8); ptr += 8;
+  memcpy(ptr, &duplicate_points_removed, 8); ptr += 8;
   uint32_t attr_count = static_cast<uint32_t>(per_attribute.size());
   memcpy(ptr, &attr_count, 4); ptr += 4;
 
@@ -299,7 +304,7 @@ compression_stats_t compression_stats_t::deserialize(const uint8_t *data, uint32
   auto *ptr = data;
   uint32_t version;
   memcpy(&version, ptr, 4); ptr += 4;
-  if (version < 1 || version > 5)
+  if (version < 1 || version > 6)
     return stats;
 
   memcpy(&stats.input_file_count, ptr, 4); ptr += 4;
@@ -317,6 +322,10 @@ compression_stats_t compression_stats_t::deserialize(const uint8_t *data, uint32
   {
     memcpy(&stats.input_file_size_bytes, ptr, 8); ptr += 8;
   }
+  if (version >= 6)
+  {
+    memcpy(&stats.duplicate_points_removed, ptr, 8); ptr += 8;
+  }
 
   uint32_t attr_count;
   memcpy(&attr_count, ptr, 4); ptr += 4;
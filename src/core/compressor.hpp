@@ -36,7 +36,8 @@ enum class compression_method_t : uint8_t
   zstd = 2,
   huff0 = 3,
   constant = 4,
-  ans = 5
+  ans = 5,
+  quantized = 6 // attribute_precision.hpp: packed values in a nested PCM blob
 };
 
 static constexpr uint8_t compression_flag_delta_encoded      = 1 << 0;
@@ -105,6 +106,8 @@ struct compression_stats_t
   uint32_t lod_buffer_count = 0;
   compression_method_t method = compression_method_t::none;
   uint64_t input_file_size_bytes = 0;
+  // Points dropped by duplicate elimination (sort worker + leaf collapse, see point_dedup.hpp).
+  uint64_t duplicate_points_removed = 0;
   std::vector<attribute_compression_stats_t> per_attribute;
 
   void accumulate(const std::string &name, const point_format_t &format, uint32_t uncompressed, uint32_t compressed, double min_val = std::numeric_limits<double>::max(), double max_val = std::numeric_limits<double>::lowest(), uint8_t flags = 0, bool is_lod = false);
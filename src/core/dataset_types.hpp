@@ -19,6 +19,7 @@
 
 #include <dew/core/types.h>
 
+#include "buffer_pool.hpp"
 #include "error.hpp"
 #include "morton.hpp"
 
@@ -105,7 +106,7 @@ namespace dew::core
 struct attribute_buffers_t
 {
   std::vector<dew_blob_t> buffers;
-  std::vector<std::unique_ptr<uint8_t[]>> data;
+  std::vector<point_buffer_t> data; // pooled buffers return to point_buffer_pool() when released
 };
 
 struct storage_location_t
@@ -213,6 +214,7 @@ struct points_t
   storage_header_t header;
   attributes_id_t attributes_id;
   attribute_buffers_t buffers;
+  uint32_t duplicates_removed = 0; // dropped by the sort worker's dedup (tree_config_t::dedup_*); not stored
 };
 
 struct tree_config_t
@@ -238,7 +240,14 @@ struct tree_config_t
   // the fixed lod-9 sampling rate, so coarsening beyond it needs the renderer taught per-node density
   // first. Left in place (gated) for that future redesign; do NOT enable for rendered datasets. (v4.)
   uint8_t lod_adaptive_sampling = 0;
-  uint8_t reserved_[6] = {};
+  // Duplicate elimination after the morton sort (point_dedup.hpp), default OFF. dedup_enabled drops
+  // all but one point per identical morton code -- or, with dedup_grid_lod > 0, per cell
+  // 2^dedup_grid_lod grid steps wide; dedup_keep picks the survivor (dew_converter_dedup_keep_t).
+  // Set via dew_converter_set_dedup. (Carved out of the v4 reserved bytes: older blobs read as off.)
+  uint8_t dedup_enabled = 0;
+  uint8_t dedup_grid_lod = 0;
+  uint8_t dedup_keep = 0;
+  uint8_t reserved_[3] = {};
 };
 // Chunk point-count clamp: 8M points default cap (a decompressed morton blob is count x up to 24B --
 // keep worst-case read spikes bounded); 16M is the hard ceiling (u32 subset offsets stay far clear).
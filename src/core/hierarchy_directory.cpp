@@ -0,0 +1,118 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "hierarchy_directory.hpp"
+
+#include "memory_writer.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace dew::core
+{
+
+static constexpr uint32_t k_hierarchy_directory_magic = 0x31524448u; // 'HDR1' little-endian
+
+serialized_tree_registry_t hierarchy_directory_serialize(tree_id_t root, uint32_t depth, const std::function<const tree_t *(tree_id_t)> &tree_for)
+{
+  if (depth == 0)
+    return {nullptr, 0};
+
+  // Breadth-first, one tree level at a time, so the entries come out in the order a walk needs them.
+  std::vector<std::pair<tree_id_t, serialized_tree_t>> trees;
+  uint64_t total = 0;
+  std::vector<tree_id_t> level = {root};
+  for (uint32_t tree_level = 0; tree_level < depth && !level.empty(); tree_level++)
+  {
+    std::vector<tree_id_t> next;
+    for (auto id : level)
+    {
+      const tree_t *tree = tree_for(id);
+      if (!tree)
+        continue;
+      auto serialized = tree_serialize(*tree);
+      if (!serialized.data)
+        return {nullptr, 0};
+      const uint64_t entry_bytes = sizeof(hierarchy_directory_entry_t) + uint64_t(serialized.size);
+      if (total + entry_bytes > k_hierarchy_directory_max_bytes)
+      {
+        next.clear();
+        break;
+      }
+      total += entry_bytes;
+      trees.emplace_back(id, std::move(serialized));
+      next.insert(next.end(), tree->sub_trees.begin(), tree->sub_trees.end());
+    }
+    level = std::move(next);
+  }
+  if (trees.empty())
+    return {nullptr, 0};
+
+  const auto count = uint32_t(trees.size());
+  const uint64_t header_size = sizeof(k_hierarchy_directory_magic) + sizeof(depth) + sizeof(count) + uint64_t(count) * sizeof(hierarchy_directory_entry_t);
+  const uint64_t blob_size = header_size + (total - uint64_t(count) * sizeof(hierarchy_directory_entry_t));
+  auto data = std::make_shared<uint8_t[]>(blob_size);
+  uint8_t *ptr = data.get();
+  uint8_t *end_ptr = ptr + blob_size;
+  if (!write_memory(ptr, end_ptr, k_hierarchy_directory_magic) || !write_memory(ptr, end_ptr, depth) || !write_memory(ptr, end_ptr, count))
+    return {nullptr, 0};
+  auto offset = uint32_t(header_size);
+  for (auto &[id, serialized] : trees)
+  {
+    hierarchy_directory_entry_t entry = {id, offset, uint32_t(serialized.size)};
+    if (!write_memory(ptr, end_ptr, entry))
+      return {nullptr, 0};
+    offset += entry.size;
+  }
+  for (auto &[id, serialized] : trees)
+  {
+    (void)id;
+    memcpy(ptr, serialized.data.get(), size_t(serialized.size));
+    ptr += serialized.size;
+  }
+  return {std::move(data), int(blob_size)};
+}
+
+dew_error_t hierarchy_directory_parse(const uint8_t *data, uint32_t size, uint32_t &depth, std::vector<hierarchy_directory_entry_t> &entries)
+{
+  const dew_error_t invalid = {1, "Invalid hierarchy directory"};
+  const uint8_t *ptr = data;
+  const uint8_t *end_ptr = data + size;
+  uint32_t magic = 0;
+  uint32_t count = 0;
+  if (!read_memory(ptr, end_ptr, magic) || magic != k_hierarchy_directory_magic)
+    return invalid;
+  if (!read_memory(ptr, end_ptr, depth) || !read_memory(ptr, end_ptr, count))
+    return invalid;
+  if (uint64_t(count) * sizeof(hierarchy_directory_entry_t) > uint64_t(end_ptr - ptr))
+    return invalid;
+  entries.resize(count);
+  for (auto &entry : entries)
+  {
+    if (!read_memory(ptr, end_ptr, entry))
+      return invalid;
+  }
+  const auto header_end = uint32_t(ptr - data);
+  for (auto &entry : entries)
+  {
+    if (entry.offset < header_end || uint64_t(entry.offset) + entry.size > size)
+      return invalid;
+  }
+  return {};
+}
+
+} // namespace dew::core
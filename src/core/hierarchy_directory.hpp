@@ -0,0 +1,67 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// The hierarchy directory: the top of the octree in ONE blob.
+//
+// Without it a reader opens with the registry (locations for every tree, data for none) and then pays
+// one blob read per tree a walk descends into. Against an object store those reads are sequential
+// round trips -- a tree's sub-trees are only known once the tree itself is in -- so walking to mid
+// depth costs dozens of them before the first point is read.
+//
+// The directory packs the serialized trees of the top `depth` tree levels (each tree spans five octree
+// levels) into a single blob, breadth-first from the root so a reader that stops early has still read
+// the part it walks first. It carries the trees verbatim rather than a second node format: installing
+// an entry is exactly installing a loaded tree, so every walker descends through the directory
+// without knowing it exists. It is an accelerator, never the only copy -- the registry still points at
+// every tree blob, and a tree the directory leaves out loads on demand as before.
+//
+// Layout: 'HDR1', depth, entry count, then per entry {tree id, offset, size} with offsets from the
+// start of the blob, then the tree bytes in entry order.
+
+#include "tree.hpp"
+
+#include <dew/core/error.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace dew::core
+{
+
+// A directory larger than this stops growing at the tree that would cross it: past a few tens of
+// megabytes one read no longer beats the on-demand loads it replaces.
+static constexpr uint32_t k_hierarchy_directory_max_bytes = 64u << 20;
+
+struct hierarchy_directory_entry_t
+{
+  tree_id_t id;
+  uint32_t offset;
+  uint32_t size;
+};
+
+// Serialize the trees within `depth` tree levels of `root` (1 = the root tree alone), breadth-first.
+// `tree_for` returns the tree for an id, or null when it is not at hand; a missing tree is left out
+// together with everything below it. Returns a null blob when there is nothing to write.
+serialized_tree_registry_t hierarchy_directory_serialize(tree_id_t root, uint32_t depth, const std::function<const tree_t *(tree_id_t)> &tree_for);
+
+// Validate the header and return the entries, which index into the same `data`.
+[[nodiscard]] dew_error_t hierarchy_directory_parse(const uint8_t *data, uint32_t size, uint32_t &depth, std::vector<hierarchy_directory_entry_t> &entries);
+
+} // namespace dew::core
@@ -37,6 +37,7 @@ void input_storage_map_t::add_storage(input_data_id_t id, attributes_id_t attrib
       _discarded.emplace_back(old_location);
   value.attributes_id = attributes_id;
   value.storage = std::move(storage);
+  value.zones.clear();
   value.ref_count++;
 }
 void input_storage_map_t::dereference_discard(input_data_id_t id)
@@ -92,6 +93,21 @@ attributes_id_t input_storage_map_t::attribute_id(input_data_id_t id) const
   assert(it != _map.end());
   return it->second.attributes_id;
 }
+void input_storage_map_t::set_zones(input_data_id_t id, std::vector<attribute_zone_t> &&zones)
+{
+  auto it = _map.find(id);
+  assert(it != _map.end());
+  it->second.zones = std::move(zones);
+}
+
+const std::vector<attribute_zone_t> *input_storage_map_t::zones(input_data_id_t id) const
+{
+  auto it = _map.find(id);
+  if (it == _map.end() || it->second.zones.empty())
+    return nullptr;
+  return &it->second.zones;
+}
+
 uint32_t input_storage_map_t::serialized_size() const
 {
   uint32_t size = 0;
@@ -104,6 +120,15 @@ uint32_t input_storage_map_t::serialized_size() const
     size += sizeof(uint32_t);
     size += uint32_t(value.storage.size()) * sizeof(value.storage[0]);
   }
+  size += sizeof(uint32_t); // zone map entry count
+  for (auto &[id, value] : _map)
+  {
+    if (value.zones.empty())
+      continue;
+    size += sizeof(id);
+    size += sizeof(uint32_t);
+    size += uint32_t(value.zones.size()) * sizeof(value.zones[0]);
+  }
   return size;
 }
 
@@ -129,6 +154,27 @@ std::pair<bool, uint8_t *> input_storage_map_t::serialize(uint8_t *buffer, const
     if (!write_vec_type(ptr, end, value.storage))
       return {false, ptr};
   }
+
+  // Zone maps trail the entries as their own section. The storage map is the last thing in a tree
+  // blob, so a reader that predates them stops before it, and a blob written before them simply ends
+  // here (see deserialize).
+  uint32_t zone_entries = 0;
+  for (auto &[id, value] : _map)
+    zone_entries += value.zones.empty() ? 0 : 1;
+  if (!write_memory(ptr, end, zone_entries))
+    return {false, ptr};
+  for (auto &[id, value] : _map)
+  {
+    if (value.zones.empty())
+      continue;
+    if (!write_memory(ptr, end, id))
+      return {false, ptr};
+    auto zone_count = uint32_t(value.zones.size());
+    if (!write_memory(ptr, end, zone_count))
+      return {false, ptr};
+    if (!write_vec_type(ptr, end, value.zones))
+      return {false, ptr};
+  }
   return {true, ptr};
 }
 
@@ -155,7 +201,28 @@ std::pair<bool, const uint8_t *> input_storage_map_t::deserialize(const uint8_t
       return {false, ptr};
     if (!read_vec_type(ptr, end, storage, storage_size))
       return {false, ptr};
-    _map[id] = {attributes_id, std::move(storage), ref_count};
+    _map[id] = {attributes_id, std::move(storage), ref_count, {}};
+  }
+
+  if (ptr == end)
+    return {true, ptr}; // written before zone maps existed
+  uint32_t zone_entries;
+  if (!read_memory(ptr, end, zone_entries))
+    return {false, ptr};
+  for (uint32_t i = 0; i < zone_entries; i++)
+  {
+    input_data_id_t id;
+    uint32_t zone_count;
+    std::vector<attribute_zone_t> zones;
+    if (!read_memory(ptr, end, id))
+      return {false, ptr};
+    if (!read_memory(ptr, end, zone_count))
+      return {false, ptr};
+    if (!read_vec_type(ptr, end, zones, zone_count))
+      return {false, ptr};
+    auto it = _map.find(id);
+    if (it != _map.end())
+      it->second.zones = std::move(zones);
   }
   return {true, ptr};
 }
@@ -17,6 +17,7 @@
 ************************************************************************/
 #pragma once
 #include <ankerl/unordered_dense.h>
+#include <attribute_zone.hpp>
 #include <dataset_types.hpp>
 #include <cstring>
 #include <vector>
@@ -56,6 +57,10 @@ public:
     return it == _map.end() ? 0 : it->second.ref_count;
   }
   attributes_id_t attribute_id(input_data_id_t id) const;
+  // Zone maps for an entry, indexed like its storage locations (slot 0, the positions, has none).
+  // add_storage starts an entry without any; nullptr when none were recorded (older datasets).
+  void set_zones(input_data_id_t id, std::vector<attribute_zone_t> &&zones);
+  [[nodiscard]] const std::vector<attribute_zone_t> *zones(input_data_id_t id) const;
   [[nodiscard]] storage_location_t location(input_data_id_t id, int attribute_index) const;
   void add_ref(input_data_id_t id);
 
@@ -101,6 +106,7 @@ private:
     attributes_id_t attributes_id;
     std::vector<storage_location_t> storage;
     uint32_t ref_count;
+    std::vector<attribute_zone_t> zones;
   };
   ankerl::unordered_dense::map<input_data_id_t, value_t, input_data_id_hash_t> _map;
   std::vector<storage_location_t> _discarded;
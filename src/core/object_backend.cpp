@@ -19,6 +19,7 @@
 
 #include "bucket_format.hpp"
 #include "loop_blocking.hpp"
+#include "tree_registry_journal.hpp"
 
 #include <algorithm>
 #include <cassert>
@@ -163,6 +164,23 @@ vio::task_t<dew_error_t> object_backend_t::read_location(storage_location_t loc,
   co_return dew_error_t{};
 }
 
+vio::task_t<dew_error_t> object_backend_t::replay_tree_registry_journal(index_load_t &out)
+{
+  if (!tree_registry_journal_is_manifest(out.tree_registry.get(), out.tree_registry_size))
+    co_return dew_error_t{};
+  auto err = tree_registry_journal_parse_manifest(out.tree_registry.get(), out.tree_registry_size, out.tree_registry_journal);
+  if (err.code != 0)
+    co_return err;
+  std::vector<tree_registry_journal_blob_t> records(out.tree_registry_journal.size());
+  for (size_t i = 0; i < records.size(); i++)
+  {
+    err = co_await read_location(out.tree_registry_journal[i], records[i].data, records[i].size);
+    if (err.code != 0)
+      co_return err;
+  }
+  co_return tree_registry_journal_replay(records, out.tree_registry, out.tree_registry_size);
+}
+
 vio::task_t<dew_error_t> object_backend_t::do_read_index(index_load_t &out)
 {
   // The "manifest" object name is shared by both layouts; sniff by content. Sizes differ (128-byte
@@ -203,6 +221,9 @@ vio::task_t<dew_error_t> object_backend_t::do_read_index(index_load_t &out)
     if (err.code != 0)
       co_return err;
     err = co_await read_location(root.tree_registry, out.tree_registry, out.tree_registry_size);
+    if (err.code != 0)
+      co_return err;
+    err = co_await replay_tree_registry_journal(out);
     if (err.code != 0)
       co_return err;
     err = co_await read_location(root.compression_stats, out.stats, out.stats_size);
@@ -239,6 +260,9 @@ vio::task_t<dew_error_t> object_backend_t::do_read_index(index_load_t &out)
   if (err.code != 0)
     co_return err;
   err = co_await read_location(tree_registry, out.tree_registry, out.tree_registry_size);
+  if (err.code != 0)
+    co_return err;
+  err = co_await replay_tree_registry_journal(out);
   if (err.code != 0)
     co_return err;
   err = co_await read_location(compression_stats, out.stats, out.stats_size);
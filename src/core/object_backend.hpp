@@ -66,6 +66,8 @@ public:
 private:
   vio::task_t<dew_error_t> do_read_index(index_load_t &out);
   vio::task_t<dew_error_t> read_location(storage_location_t loc, std::unique_ptr<uint8_t[]> &buf, uint32_t &size);
+  // If out.tree_registry is a journal manifest, read its records and replace it with the replayed registry.
+  vio::task_t<dew_error_t> replay_tree_registry_journal(index_load_t &out);
   vio::task_t<dew_error_t> probe_exists(bool &out) const; // HEAD the manifest to set _exists on open
   storage_location_t next_location(uint32_t size); // allocate a fresh 64-bit id split into file_id/offset
 
@@ -21,6 +21,7 @@
 
 #include "bucket_format.hpp"
 #include "file_hole_punch.hpp"
+#include "tree_registry_journal.hpp"
 
 #include <uv.h>
 
@@ -362,6 +363,26 @@ vio::task_t<dew_error_t> packed_file_backend_t::do_read_index(index_load_t &out)
     error = {1, "Failed to read tree_registry: " + error.msg};
     co_return error;
   }
+  if (tree_registry_journal_is_manifest(out.tree_registry.get(), out.tree_registry_size))
+  {
+    error = tree_registry_journal_parse_manifest(out.tree_registry.get(), out.tree_registry_size, out.tree_registry_journal);
+    if (error.code != 0)
+      co_return error;
+    std::vector<tree_registry_journal_blob_t> records(out.tree_registry_journal.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+      error = co_await co_read_into_buffer(_event_loop, file, out.tree_registry_journal[i], records[i].data);
+      records[i].size = out.tree_registry_journal[i].size;
+      if (error.code != 0)
+      {
+        error = {1, "Failed to read tree registry journal record: " + error.msg};
+        co_return error;
+      }
+    }
+    error = tree_registry_journal_replay(records, out.tree_registry, out.tree_registry_size);
+    if (error.code != 0)
+      co_return error;
+  }
 
   _stats_location = compression_stats;
   _perf_stats_location = perf_stats;
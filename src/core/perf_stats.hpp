@@ -17,6 +17,8 @@
 ************************************************************************/
 #pragma once
 
+#include "buffer_pool.hpp"
+
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -105,6 +107,33 @@ struct perf_stats_t
   std::atomic<uint64_t> cache_hits{0};
   std::atomic<uint64_t> cache_misses{0};
 
+  // Point-buffer pool and process memory, copied from point_buffer_pool() by sample_memory(). Both are
+  // process-wide, so converters running side by side each see the others' buffers mixed into theirs.
+  std::atomic<uint64_t> buffer_pool_hits{0};
+  std::atomic<uint64_t> buffer_pool_misses{0};
+  std::atomic<uint64_t> allocation_time_us{0};
+  std::atomic<uint64_t> peak_buffer_bytes{0};
+  std::atomic<uint64_t> peak_rss_bytes{0};
+
+  // The autotuner's settings (autotuner.hpp) as they stood when the run ended, and how many changes it
+  // made; all zero when it was off.
+  std::atomic<bool> autotuned{false};
+  std::atomic<uint64_t> autotune_read_chunk_bytes{0};
+  std::atomic<uint32_t> autotune_max_readers{0};
+  std::atomic<uint32_t> autotune_max_sorters{0};
+  std::atomic<uint32_t> autotune_max_compressors{0};
+  std::atomic<uint32_t> autotune_decisions{0};
+
+  void sample_memory()
+  {
+    auto pool = point_buffer_pool().stats();
+    buffer_pool_hits.store(pool.hits, std::memory_order_relaxed);
+    buffer_pool_misses.store(pool.misses, std::memory_order_relaxed);
+    allocation_time_us.store(pool.allocation_time_us, std::memory_order_relaxed);
+    peak_buffer_bytes.store(pool.peak_outstanding_bytes, std::memory_order_relaxed);
+    peak_rss_bytes.store(process_peak_rss_bytes(), std::memory_order_relaxed);
+  }
+
   double total_time_seconds() const
   {
     auto dur = std::chrono::duration_cast<std::chrono::microseconds>(conversion_end - conversion_start).count();
@@ -118,7 +147,11 @@ struct perf_stats_t
   }
 
   // Binary serialization: version(1) + 5*io_counter(40 each) + tree_build_us(8) + lod_gen_us(8) + total_time_us(8) + cache_hits(8) + cache_misses(8)
-  static constexpr uint32_t serialized_size = 1 + 5 * 40 + 8 + 8 + 8 + 8 + 8;
+  // + buffer_pool_hits(8) + buffer_pool_misses(8) + allocation_time_us(8) + peak_buffer_bytes(8) + peak_rss_bytes(8)
+  // + autotuned(8) + autotune_read_chunk_bytes(8) + autotune_max_readers/sorters/compressors(8 each) + autotune_decisions(8)
+  static constexpr uint32_t serialized_size_with_cache = 1 + 5 * 40 + 8 + 8 + 8 + 8 + 8;
+  static constexpr uint32_t serialized_size_with_pool = serialized_size_with_cache + 5 * 8;
+  static constexpr uint32_t serialized_size = serialized_size_with_pool + 6 * 8;
 
   std::unique_ptr<uint8_t[]> serialize(uint32_t &out_size) const
   {
@@ -166,6 +199,30 @@ struct perf_stats_t
     v = cache_misses.load(std::memory_order_relaxed);
     memcpy(p, &v, 8); p += 8;
 
+    v = buffer_pool_hits.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = buffer_pool_misses.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = allocation_time_us.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = peak_buffer_bytes.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = peak_rss_bytes.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+
+    v = autotuned.load(std::memory_order_relaxed) ? 1 : 0;
+    memcpy(p, &v, 8); p += 8;
+    v = autotune_read_chunk_bytes.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = autotune_max_readers.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = autotune_max_sorters.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = autotune_max_compressors.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+    v = autotune_decisions.load(std::memory_order_relaxed);
+    memcpy(p, &v, 8); p += 8;
+
     return buf;
   }
 
@@ -206,6 +263,17 @@ struct perf_stats_t
     uint64_t lod_generation_us;
     uint64_t cache_hits;
     uint64_t cache_misses;
+    uint64_t buffer_pool_hits;
+    uint64_t buffer_pool_misses;
+    uint64_t allocation_time_us;
+    uint64_t peak_buffer_bytes;
+    uint64_t peak_rss_bytes;
+    bool autotuned;
+    uint64_t autotune_read_chunk_bytes;
+    uint64_t autotune_max_readers;
+    uint64_t autotune_max_sorters;
+    uint64_t autotune_max_compressors;
+    uint64_t autotune_decisions;
     bool valid;
   };
 
@@ -245,11 +313,30 @@ struct perf_stats_t
     memcpy(&result.lod_generation_us, p, 8); p += 8;
     memcpy(&result.total_time_us, p, 8); p += 8;
 
-    if (size >= serialized_size)
+    if (size >= serialized_size_with_cache)
     {
       memcpy(&result.cache_hits, p, 8); p += 8;
       memcpy(&result.cache_misses, p, 8); p += 8;
     }
+    if (size >= serialized_size_with_pool)
+    {
+      memcpy(&result.buffer_pool_hits, p, 8); p += 8;
+      memcpy(&result.buffer_pool_misses, p, 8); p += 8;
+      memcpy(&result.allocation_time_us, p, 8); p += 8;
+      memcpy(&result.peak_buffer_bytes, p, 8); p += 8;
+      memcpy(&result.peak_rss_bytes, p, 8); p += 8;
+    }
+    if (size >= serialized_size)
+    {
+      uint64_t autotuned = 0;
+      memcpy(&autotuned, p, 8); p += 8;
+      result.autotuned = autotuned != 0;
+      memcpy(&result.autotune_read_chunk_bytes, p, 8); p += 8;
+      memcpy(&result.autotune_max_readers, p, 8); p += 8;
+      memcpy(&result.autotune_max_sorters, p, 8); p += 8;
+      memcpy(&result.autotune_max_compressors, p, 8); p += 8;
+      memcpy(&result.autotune_decisions, p, 8); p += 8;
+    }
 
     result.total_time_seconds = double(result.total_time_us) / 1e6;
     result.valid = true;
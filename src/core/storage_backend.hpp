@@ -41,8 +41,9 @@ struct index_load_t
   uint32_t free_blobs_size = 0;
   std::unique_ptr<uint8_t[]> attribute_configs;
   uint32_t attribute_configs_size = 0;
-  std::unique_ptr<uint8_t[]> tree_registry;
+  std::unique_ptr<uint8_t[]> tree_registry; // always a full registry: a journal is replayed on read
   uint32_t tree_registry_size = 0;
+  std::vector<storage_location_t> tree_registry_journal; // the replayed records; empty for a plain blob
   std::unique_ptr<uint8_t[]> stats;
   uint32_t stats_size = 0;
   std::unique_ptr<uint8_t[]> perf;
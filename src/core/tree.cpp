@@ -18,6 +18,7 @@
 #include "tree.hpp"
 
 #include "memory_writer.hpp"
+#include "tree_registry_journal.hpp" // manifest/record magics
 
 #include <cassert>
 
@@ -332,6 +333,9 @@ void tree_compute_leaves_collapsed(tree_t &tree, const tree_registry_t &tree_reg
 static constexpr uint32_t k_tree_registry_magic_v2 = 0x32475254u; // 'TRG2' little-endian
 static constexpr uint32_t k_tree_registry_magic_v3 = 0x33475254u; // 'TRG3' little-endian
 static constexpr uint32_t k_tree_registry_magic_v4 = 0x34475254u; // 'TRG4' little-endian (grown tree_config: lod flags)
+// A v4 blob may end with one more storage_location_t, the hierarchy directory. It is a trailer rather
+// than a 'TRG5' because it is purely an accelerator: an older reader stops before it and still opens
+// the dataset, it just loads every tree on demand.
 
 // The v2 on-disk layout of tree_config_t (before read_chunk_byte_target). Field order matches the
 // live struct so the memcpy'd bytes line up.
@@ -382,6 +386,9 @@ serialized_tree_registry_t tree_registry_serialize(const tree_registry_t &tree_r
   tree_registry_size += uint32_t(sizeof(uint32_t)) * tree_registry_count; // tree_band
   tree_registry_size += sizeof(input_snapshot_size);
   tree_registry_size += input_snapshot_size;
+  const bool has_directory = tree_registry.hierarchy_directory.size != 0;
+  if (has_directory)
+    tree_registry_size += sizeof(tree_registry.hierarchy_directory);
 
   auto data = std::make_shared<uint8_t[]>(tree_registry_size);
   uint8_t *ptr = data.get();
@@ -426,6 +433,8 @@ serialized_tree_registry_t tree_registry_serialize(const tree_registry_t &tree_r
     return {nullptr, 0};
   if (input_snapshot_size && !write_vec_type(ptr, end_ptr, tree_registry.input_registry_snapshot))
     return {nullptr, 0};
+  if (has_directory && !write_memory(ptr, end_ptr, tree_registry.hierarchy_directory))
+    return {nullptr, 0};
   return {std::move(data), int(tree_registry_size)};
 }
 
@@ -439,6 +448,8 @@ dew_error_t tree_registry_deserialize(const std::unique_ptr<uint8_t[]> &data, ui
   const bool v4 = first_word == k_tree_registry_magic_v4;
   const bool v3 = v4 || first_word == k_tree_registry_magic_v3;
   const bool v2 = v3 || first_word == k_tree_registry_magic_v2;
+  if (first_word == k_tree_registry_manifest_magic || first_word == k_tree_registry_delta_magic)
+    return {1, "Tree registry blob is a journal manifest or record; read it through the storage backend, which replays it"};
   // A future 'TRG5'+ blob would otherwise fall through to the v1 branch (first_word treated as
   // node_limit) and silently misparse. Any 'TRG?' word that is not a known version is a
   // newer-format dataset; refuse it explicitly. (Real node_limit values never reach ~0x54475254.)
@@ -537,6 +548,11 @@ dew_error_t tree_registry_deserialize(const std::unique_ptr<uint8_t[]> &data, ui
       return {1, "Invalid tree registry data"};
     if (!read_vec_type(ptr, end_ptr, tree_registry.input_registry_snapshot, input_snapshot_size))
       return {1, "Invalid tree registry data"};
+    // Optional trailer: the hierarchy directory location. Absent (nothing left) on blobs written
+    // without a directory and on every blob from before it existed.
+    tree_registry.hierarchy_directory = {};
+    if (v4 && ptr < end_ptr && !read_memory(ptr, end_ptr, tree_registry.hierarchy_directory))
+      return {1, "Invalid tree registry data"};
   }
   else
   {
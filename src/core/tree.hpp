@@ -179,6 +179,9 @@ struct tree_registry_t
   // tree handler right before each checkpoint (via the processor-installed provider); handed back
   // to the processor after deserialize.
   std::vector<uint8_t> input_registry_snapshot;
+  // Where the hierarchy directory lives (see hierarchy_directory.hpp); zero size = none. An optional
+  // trailer on v4 blobs, so readers that predate it simply load every tree on demand.
+  storage_location_t hierarchy_directory;
 
   tree_t *get(tree_id_t id)
   {
@@ -0,0 +1,296 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "tree_registry_journal.hpp"
+
+#include "memory_writer.hpp"
+
+#include <cstring>
+
+namespace dew::core
+{
+
+namespace
+{
+struct blob_builder_t
+{
+  std::vector<uint8_t> bytes;
+
+  template <typename T>
+  void add(const T &value)
+  {
+    auto at = bytes.size();
+    bytes.resize(at + sizeof(value));
+    memcpy(bytes.data() + at, &value, sizeof(value));
+  }
+
+  void add_bytes(const std::vector<uint8_t> &data)
+  {
+    bytes.insert(bytes.end(), data.begin(), data.end());
+  }
+
+  serialized_tree_registry_t finish() const
+  {
+    auto data = std::make_shared<uint8_t[]>(bytes.size());
+    if (!bytes.empty())
+      memcpy(data.get(), bytes.data(), bytes.size());
+    return {std::move(data), int(bytes.size())};
+  }
+};
+
+// Registry scalars, written in full by every delta (they are a few dozen bytes).
+void add_scalars(blob_builder_t &out, const tree_registry_t &registry)
+{
+  out.add(registry.node_limit);
+  out.add(registry.current_id);
+  out.add(registry.root);
+  out.add(registry.tree_config);
+  out.add(registry.current_lod_node_id);
+  out.add(registry.current_collapsed_node_id);
+  out.add(registry.lod_watermark);
+}
+
+tree_registry_journal_baseline_t baseline_from(const tree_registry_t &registry)
+{
+  tree_registry_journal_baseline_t baseline;
+  baseline.locations = registry.locations;
+  baseline.tree_state = registry.tree_state;
+  baseline.tree_band = registry.tree_band;
+  baseline.chunk_tree_refs = registry.chunk_tree_refs;
+  baseline.input_registry_snapshot = registry.input_registry_snapshot;
+  baseline.hierarchy_directory = registry.hierarchy_directory;
+  return baseline;
+}
+
+serialized_tree_registry_t serialize_delta(const tree_registry_journal_baseline_t &base, const tree_registry_t &registry)
+{
+  blob_builder_t out;
+  out.add(k_tree_registry_delta_magic);
+  add_scalars(out, registry);
+
+  auto tree_count = uint32_t(registry.locations.size());
+  out.add(tree_count);
+  std::vector<uint32_t> changed;
+  for (uint32_t id = 0; id < tree_count; id++)
+  {
+    const bool known = id < base.locations.size();
+    const storage_location_t old_location = known ? base.locations[id] : storage_location_t{};
+    const uint8_t old_state = known ? base.tree_state[id] : uint8_t(tree_state_t::building);
+    const uint32_t old_band = known ? base.tree_band[id] : tree_band_none;
+    if (!(registry.locations[id] == old_location) || registry.tree_state[id] != old_state || registry.tree_band[id] != old_band)
+      changed.push_back(id);
+  }
+  out.add(uint32_t(changed.size()));
+  for (auto id : changed)
+  {
+    out.add(id);
+    out.add(registry.locations[id]);
+    out.add(registry.tree_state[id]);
+    out.add(registry.tree_band[id]);
+  }
+
+  uint32_t upserts = 0;
+  blob_builder_t upsert_bytes;
+  for (auto &[chunk_id, chunk_ref] : registry.chunk_tree_refs)
+  {
+    auto it = base.chunk_tree_refs.find(chunk_id);
+    if (it != base.chunk_tree_refs.end() && it->second.tree_count == chunk_ref.tree_count && it->second.point_count == chunk_ref.point_count)
+      continue;
+    upsert_bytes.add(chunk_id);
+    upsert_bytes.add(chunk_ref.tree_count);
+    upsert_bytes.add(chunk_ref.point_count);
+    upserts++;
+  }
+  uint32_t erases = 0;
+  blob_builder_t erase_bytes;
+  for (auto &[chunk_id, chunk_ref] : base.chunk_tree_refs)
+  {
+    (void)chunk_ref;
+    if (registry.chunk_tree_refs.contains(chunk_id))
+      continue;
+    erase_bytes.add(chunk_id);
+    erases++;
+  }
+  out.add(upserts);
+  out.add_bytes(upsert_bytes.bytes);
+  out.add(erases);
+  out.add_bytes(erase_bytes.bytes);
+
+  const bool snapshot_changed = registry.input_registry_snapshot != base.input_registry_snapshot;
+  out.add(uint8_t(snapshot_changed));
+  if (snapshot_changed)
+  {
+    out.add(uint32_t(registry.input_registry_snapshot.size()));
+    out.add_bytes(registry.input_registry_snapshot);
+  }
+  // Optional trailer, like the registry blob's: only a delta that moves the directory carries it.
+  if (registry.hierarchy_directory != base.hierarchy_directory)
+    out.add(registry.hierarchy_directory);
+  return out.finish();
+}
+
+dew_error_t apply_delta(const uint8_t *data, uint32_t size, tree_registry_t &registry)
+{
+  const dew_error_t invalid = {1, "Invalid tree registry journal record"};
+  const uint8_t *ptr = data;
+  const uint8_t *end_ptr = data + size;
+  uint32_t magic = 0;
+  if (!read_memory(ptr, end_ptr, magic) || magic != k_tree_registry_delta_magic)
+    return invalid;
+  if (!read_memory(ptr, end_ptr, registry.node_limit) || !read_memory(ptr, end_ptr, registry.current_id) || !read_memory(ptr, end_ptr, registry.root) ||
+      !read_memory(ptr, end_ptr, registry.tree_config) || !read_memory(ptr, end_ptr, registry.current_lod_node_id) ||
+      !read_memory(ptr, end_ptr, registry.current_collapsed_node_id) || !read_memory(ptr, end_ptr, registry.lod_watermark))
+    return invalid;
+
+  uint32_t tree_count = 0;
+  if (!read_memory(ptr, end_ptr, tree_count) || tree_count < registry.locations.size())
+    return invalid; // tree ids are never retired
+  registry.locations.resize(tree_count);
+  registry.tree_state.resize(tree_count, uint8_t(tree_state_t::building));
+  registry.tree_band.resize(tree_count, tree_band_none);
+  uint32_t changed = 0;
+  if (!read_memory(ptr, end_ptr, changed))
+    return invalid;
+  for (uint32_t i = 0; i < changed; i++)
+  {
+    uint32_t id = 0;
+    if (!read_memory(ptr, end_ptr, id) || id >= tree_count)
+      return invalid;
+    if (!read_memory(ptr, end_ptr, registry.locations[id]) || !read_memory(ptr, end_ptr, registry.tree_state[id]) || !read_memory(ptr, end_ptr, registry.tree_band[id]))
+      return invalid;
+  }
+
+  uint32_t upserts = 0;
+  if (!read_memory(ptr, end_ptr, upserts))
+    return invalid;
+  for (uint32_t i = 0; i < upserts; i++)
+  {
+    input_data_id_t chunk_id;
+    tree_registry_t::chunk_ref_t chunk_ref;
+    if (!read_memory(ptr, end_ptr, chunk_id) || !read_memory(ptr, end_ptr, chunk_ref.tree_count) || !read_memory(ptr, end_ptr, chunk_ref.point_count))
+      return invalid;
+    registry.chunk_tree_refs[chunk_id] = chunk_ref;
+  }
+  uint32_t erases = 0;
+  if (!read_memory(ptr, end_ptr, erases))
+    return invalid;
+  for (uint32_t i = 0; i < erases; i++)
+  {
+    input_data_id_t chunk_id;
+    if (!read_memory(ptr, end_ptr, chunk_id))
+      return invalid;
+    registry.chunk_tree_refs.erase(chunk_id);
+  }
+
+  uint8_t snapshot_changed = 0;
+  if (!read_memory(ptr, end_ptr, snapshot_changed))
+    return invalid;
+  if (snapshot_changed)
+  {
+    uint32_t snapshot_size = 0;
+    if (!read_memory(ptr, end_ptr, snapshot_size) || !read_vec_type(ptr, end_ptr, registry.input_registry_snapshot, snapshot_size))
+      return invalid;
+  }
+  if (ptr < end_ptr && !read_memory(ptr, end_ptr, registry.hierarchy_directory))
+    return invalid;
+  return {};
+}
+} // namespace
+
+tree_registry_journal_record_t tree_registry_journal_next(const tree_registry_journal_t &journal, const tree_registry_t &registry)
+{
+  tree_registry_journal_record_t record;
+  record.snapshot = !journal.has_baseline || journal.records.empty() || journal.records.size() >= k_tree_registry_journal_max_records ||
+                    journal.delta_bytes >= journal.snapshot_size;
+  record.data = record.snapshot ? tree_registry_serialize(registry) : serialize_delta(journal.baseline, registry);
+  record.baseline = baseline_from(registry);
+  return record;
+}
+
+serialized_tree_registry_t tree_registry_journal_manifest(const std::vector<storage_location_t> &records)
+{
+  blob_builder_t out;
+  out.add(k_tree_registry_manifest_magic);
+  out.add(uint32_t(records.size()));
+  for (auto &location : records)
+    out.add(location);
+  return out.finish();
+}
+
+void tree_registry_journal_commit(tree_registry_journal_t &journal, tree_registry_journal_record_t &&record, storage_location_t location)
+{
+  if (record.snapshot)
+  {
+    journal.records.assign(1, location);
+    journal.snapshot_size = location.size;
+    journal.delta_bytes = 0;
+  }
+  else
+  {
+    journal.records.push_back(location);
+    journal.delta_bytes += location.size;
+  }
+  journal.baseline = std::move(record.baseline);
+  journal.has_baseline = true;
+}
+
+bool tree_registry_journal_is_manifest(const uint8_t *data, uint32_t size)
+{
+  uint32_t magic = 0;
+  if (size < sizeof(magic))
+    return false;
+  memcpy(&magic, data, sizeof(magic));
+  return magic == k_tree_registry_manifest_magic;
+}
+
+dew_error_t tree_registry_journal_parse_manifest(const uint8_t *data, uint32_t size, std::vector<storage_location_t> &records)
+{
+  const uint8_t *ptr = data;
+  const uint8_t *end_ptr = data + size;
+  uint32_t magic = 0;
+  uint32_t count = 0;
+  if (!read_memory(ptr, end_ptr, magic) || magic != k_tree_registry_manifest_magic || !read_memory(ptr, end_ptr, count) || count == 0)
+    return {1, "Invalid tree registry journal manifest"};
+  if (!read_vec_type(ptr, end_ptr, records, count))
+    return {1, "Invalid tree registry journal manifest"};
+  return {};
+}
+
+dew_error_t tree_registry_journal_replay(const std::vector<tree_registry_journal_blob_t> &records, std::unique_ptr<uint8_t[]> &out, uint32_t &out_size)
+{
+  if (records.empty())
+    return {1, "Tree registry journal has no snapshot"};
+  tree_registry_t registry;
+  auto error = tree_registry_deserialize(records[0].data, records[0].size, registry);
+  if (error.code != 0)
+    return error;
+  for (size_t i = 1; i < records.size(); i++)
+  {
+    error = apply_delta(records[i].data.get(), records[i].size, registry);
+    if (error.code != 0)
+      return error;
+  }
+  auto serialized = tree_registry_serialize(registry);
+  if (!serialized.data)
+    return {1, "Failed to serialize the replayed tree registry"};
+  out_size = uint32_t(serialized.size);
+  out = std::make_unique<uint8_t[]>(out_size);
+  memcpy(out.get(), serialized.data.get(), out_size);
+  return {};
+}
+
+} // namespace dew::core
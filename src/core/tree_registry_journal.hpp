@@ -0,0 +1,110 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// Append-only journal for the tree registry blob.
+//
+// A checkpoint used to rewrite the whole serialized registry -- every tree location, state and band,
+// the chunk reference table and the input-registry snapshot -- even when a pass touched a handful of
+// trees. With a journal the blob the index points at is a small MANIFEST ('TRGJ') listing records:
+//  - record 0 is a full registry snapshot (the ordinary 'TRG4' blob);
+//  - every later record ('TRGD') holds only what changed since the record before it: the registry
+//    scalars, the trees whose location/state/band differ, chunk references added, changed or dropped,
+//    the input-registry snapshot when it changed, and the hierarchy directory location when it moved.
+// Records are ordinary metadata blobs: the backend frees only the superseded manifest, so the chain
+// stays allocated until a compaction writes a fresh snapshot and hands the old records to the
+// checkpoint's `freed` list.
+//
+// Readers never see the journal. The backends' read_index replays a manifest into a full registry
+// blob, so every consumer of index_load_t::tree_registry keeps deserializing one 'TRG4' blob; the
+// record locations come along in index_load_t::tree_registry_journal for a writer resuming the chain.
+
+#include "tree.hpp"
+
+#include <dew/core/error.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dew::core
+{
+
+// 'TRG?' words, so a reader that predates the journal refuses a manifest as a newer registry format
+// instead of misparsing it.
+static constexpr uint32_t k_tree_registry_manifest_magic = 0x4A475254u; // 'TRGJ' little-endian
+static constexpr uint32_t k_tree_registry_delta_magic = 0x44475254u;    // 'TRGD' little-endian
+
+// The registry state the newest committed record describes; the next delta is taken against it.
+struct tree_registry_journal_baseline_t
+{
+  std::vector<storage_location_t> locations;
+  std::vector<uint8_t> tree_state;
+  std::vector<uint32_t> tree_band;
+  ankerl::unordered_dense::map<input_data_id_t, tree_registry_t::chunk_ref_t, input_data_id_hash_t> chunk_tree_refs;
+  std::vector<uint8_t> input_registry_snapshot;
+  storage_location_t hierarchy_directory;
+};
+
+// Writer side, owned by the tree loop.
+struct tree_registry_journal_t
+{
+  std::vector<storage_location_t> records; // committed chain; [0] is the snapshot
+  uint64_t snapshot_size = 0;
+  uint64_t delta_bytes = 0; // sum over the deltas in `records`
+  bool has_baseline = false;
+  tree_registry_journal_baseline_t baseline;
+  // Records written by checkpoints that then failed to commit; freed by the next commit.
+  std::vector<storage_location_t> orphans;
+};
+
+// Compaction: a snapshot is written instead of a delta once the chain holds this many records, or once
+// its deltas add up to the snapshot they apply to (bounding replay at about twice a snapshot read).
+static constexpr size_t k_tree_registry_journal_max_records = 32;
+
+struct tree_registry_journal_record_t
+{
+  serialized_tree_registry_t data;
+  bool snapshot = false;
+  tree_registry_journal_baseline_t baseline; // what the record describes; adopted on commit
+};
+
+// Build the next record for `registry`: a delta against the journal's baseline, or a snapshot when there
+// is no baseline yet or compaction is due. data.data is null on a serialization failure.
+tree_registry_journal_record_t tree_registry_journal_next(const tree_registry_journal_t &journal, const tree_registry_t &registry);
+
+// The manifest listing `records` (the chain including the record about to be committed).
+serialized_tree_registry_t tree_registry_journal_manifest(const std::vector<storage_location_t> &records);
+
+// The checkpoint that wrote `record` at `location` committed: adopt its baseline and extend (or, for a
+// snapshot, restart) the chain.
+void tree_registry_journal_commit(tree_registry_journal_t &journal, tree_registry_journal_record_t &&record, storage_location_t location);
+
+// Reader side.
+bool tree_registry_journal_is_manifest(const uint8_t *data, uint32_t size);
+[[nodiscard]] dew_error_t tree_registry_journal_parse_manifest(const uint8_t *data, uint32_t size, std::vector<storage_location_t> &records);
+
+struct tree_registry_journal_blob_t
+{
+  std::unique_ptr<uint8_t[]> data;
+  uint32_t size = 0;
+};
+// Apply the records (snapshot first) and serialize the result as one full registry blob.
+[[nodiscard]] dew_error_t tree_registry_journal_replay(const std::vector<tree_registry_journal_blob_t> &records, std::unique_ptr<uint8_t[]> &out, uint32_t &out_size);
+
+} // namespace dew::core
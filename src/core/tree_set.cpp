@@ -18,6 +18,7 @@
 
 #include "tree_set.hpp"
 
+#include "hierarchy_directory.hpp"
 #include "morton_tree_coordinate_transform.hpp"
 
 #include <atomic>
@@ -79,36 +80,71 @@ bool tree_set_t::install(tree_id_t id, const serialized_tree_t &data, dew_error_
   return true;
 }
 
-vio::task_t<bool> tree_set_t::do_load(tree_id_t id, dew_error_t &error)
+storage_location_t tree_set_t::location_for(tree_id_t id, dew_error_t &error) const
 {
   if (id.data >= _registry.locations.size())
   {
     error = {1, "tree id is outside the registry"};
-    co_return false;
+    return {};
   }
-  if (resident(id))
-    co_return true;
   const auto location = _registry.locations[id.data];
   if (location.size == 0)
-  {
     error = {1, "tree has no stored location"};
-    co_return false;
+  return location;
+}
+
+bool tree_set_t::install_read(tree_id_t id, read_request_t &read, dew_error_t &error)
+{
+  if (read.error.code != 0)
+  {
+    error = read.error;
+    return false;
   }
+  serialized_tree_t serialized;
+  serialized.size = int(read.buffer_info.size);
+  serialized.data = read.buffer;
+  return install(id, serialized, error);
+}
+
+vio::task_t<bool> tree_set_t::do_load(tree_id_t id, dew_error_t &error)
+{
+  if (id.data < _registry.locations.size() && resident(id))
+    co_return true;
+  const auto location = location_for(id, error);
+  if (location.size == 0)
+    co_return false;
 
   std::shared_ptr<read_request_t> request;
   // decompress_inline: the caller is on the loop, not a pool worker, so decompressing here cannot
   // park a pool thread -- and hopping to a pool that may have no threads (wasm) would never return.
   co_await co_read(_reader, location, read_options_t{false, true, {}}, _loop, request);
-  if (request->error.code != 0)
+  co_return install_read(id, *request, error);
+}
+
+std::shared_ptr<read_request_t> tree_set_t::begin_load(tree_id_t id, dew_error_t &error)
+{
+  if (resident(id))
+    return nullptr;
+  if (_shutting_down)
   {
-    error = request->error;
-    co_return false;
+    error = {1, "the tree set is shutting down"};
+    return nullptr;
   }
+  const auto location = location_for(id, error);
+  if (location.size == 0)
+    return nullptr;
+  if (id.data < _requested.size())
+    _requested[id.data] = 1;
+  _in_flight.fetch_add(1, std::memory_order_acq_rel);
+  _loads_started.fetch_add(1, std::memory_order_acq_rel);
+  // decompress_inline for the same reason as do_load: the read is finished on the loop.
+  return _reader.read(location, read_options_t{false, true, {}});
+}
 
-  serialized_tree_t serialized;
-  serialized.size = int(request->buffer_info.size);
-  serialized.data = request->buffer;
-  co_return install(id, serialized, error);
+bool tree_set_t::finish_load(tree_id_t id, read_request_t &read, dew_error_t &error)
+{
+  _in_flight.fetch_sub(1, std::memory_order_acq_rel);
+  return install_read(id, read, error);
 }
 
 vio::task_t<bool> tree_set_t::load(tree_id_t id, dew_error_t &error)
@@ -131,6 +167,46 @@ vio::task_t<bool> tree_set_t::load(tree_id_t id, dew_error_t &error)
   co_return std::move(ok);
 }
 
+vio::task_t<bool> tree_set_t::load_directory(dew_error_t &error)
+{
+  const auto location = _registry.hierarchy_directory;
+  if (location.size == 0)
+    co_return true;
+  if (_shutting_down)
+  {
+    error = {1, "the tree set is shutting down"};
+    co_return false;
+  }
+
+  std::shared_ptr<read_request_t> request;
+  // decompress_inline for the same reason as do_load.
+  co_await co_read(_reader, location, read_options_t{false, true, {}}, _loop, request);
+  if (request->error.code != 0)
+  {
+    error = request->error;
+    co_return false;
+  }
+  uint32_t depth = 0;
+  std::vector<hierarchy_directory_entry_t> entries;
+  error = hierarchy_directory_parse(request->buffer.get(), uint32_t(request->buffer_info.size), depth, entries);
+  if (error.code != 0)
+    co_return false;
+  for (auto &entry : entries)
+  {
+    // Each entry aliases the one buffer: no per-tree copy, and the buffer lives until the last
+    // deserialize is done with it.
+    serialized_tree_t serialized;
+    serialized.data = std::shared_ptr<uint8_t[]>(request->buffer, request->buffer.get() + entry.offset);
+    serialized.size = int(entry.size);
+    if (!install(entry.id, serialized, error))
+      co_return false;
+    if (entry.id.data < _requested.size())
+      _requested[entry.id.data] = 1;
+    _directory_trees.fetch_add(1, std::memory_order_acq_rel);
+  }
+  co_return true;
+}
+
 void tree_set_t::request(std::vector<tree_id_t> ids)
 {
   if (ids.empty() || _shutting_down)
@@ -81,6 +81,21 @@ public:
   // that wants a complete answer before it replies -- a query.
   vio::task_t<bool> load(tree_id_t id, dew_error_t &error);
 
+  // The same load SPLIT in two, for a caller that overlaps tree reads with other reads of its own:
+  // begin_load() issues the read and returns it, the caller awaits it however suits, and
+  // finish_load() installs the result. Returns null when there is nothing to wait for -- the tree is
+  // already resident, or cannot be loaded at all, in which case `error` is set. Loop-only, like
+  // load(). Every begin_load that returns a read must be matched by one finish_load.
+  std::shared_ptr<read_request_t> begin_load(tree_id_t id, dew_error_t &error);
+  bool finish_load(tree_id_t id, read_request_t &read, dew_error_t &error);
+
+  // Install every tree in the registry's hierarchy directory with ONE read (see
+  // hierarchy_directory.hpp). Call at open, before walking; a walk then descends through the top of
+  // the octree without a load per tree. True with nothing done when the registry names no directory.
+  // On failure some trees may already be installed -- each one is complete -- and the rest load on
+  // demand, so a caller may treat the error as advisory. Loop-only, like load().
+  vio::task_t<bool> load_directory(dew_error_t &error);
+
   // ASK for the trees and return immediately. For a caller that must answer now and can pick the
   // result up later -- a renderer, which re-walks next frame. Deduplicated: a tree already resident
   // or already in flight is skipped, so calling this every frame with the same walk output costs
@@ -103,6 +118,8 @@ public:
   // when they finished -- which is the only timing-independent way to observe that repeats were
   // dropped rather than merely completed before the repeat arrived.
   [[nodiscard]] uint32_t loads_started() const { return _loads_started.load(std::memory_order_acquire); }
+  // Trees installed from the hierarchy directory rather than loaded one by one.
+  [[nodiscard]] uint32_t directory_trees() const { return _directory_trees.load(std::memory_order_acquire); }
 
   // The bounds of the DATA, scanned from the root tree's point collections.
   //
@@ -117,6 +134,10 @@ private:
   void start_requested(const std::vector<tree_id_t> &ids);
   // Read the blob for `id`. Shared by both wait shapes.
   vio::task_t<bool> do_load(tree_id_t id, dew_error_t &error);
+  // Validate `id` and return where its blob lives; a zero size with `error` set when it has none.
+  storage_location_t location_for(tree_id_t id, dew_error_t &error) const;
+  // Turn a finished read into an installed tree.
+  bool install_read(tree_id_t id, read_request_t &read, dew_error_t &error);
   // Deserialize and install into the registry slot. The part that must not be written twice.
   bool install(tree_id_t id, const serialized_tree_t &data, dew_error_t &error);
 
@@ -129,6 +150,7 @@ private:
   // Atomic because both are public observations and a renderer reads them off its own thread.
   std::atomic<uint32_t> _in_flight{0};
   std::atomic<uint32_t> _loads_started{0};
+  std::atomic<uint32_t> _directory_trees{0};
   bool _shutting_down = false;
 };
 
@@ -0,0 +1,495 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include "cpu_rasterizer.hpp"
+
+#include <dew/render/buffer.h>
+
+#include "glm_include.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace dew::render
+{
+
+namespace
+{
+// One attribute fetch as the GL vertex puller does it: integer types normalized (the GL consumer binds
+// colours and rep_level with normalized = GL_TRUE), floats as stored. Missing components read as 0.
+float fetch_component(const cpu_rasterizer_t::buffer_t &buffer, uint32_t index, int component)
+{
+  const int components = int(buffer.components);
+  if (component >= components)
+    return 0.0f;
+  const size_t element = size_t(index) * size_t(components) + size_t(component);
+  auto read = [&]<typename T>(T) -> T {
+    T v;
+    if ((element + 1) * sizeof(T) > buffer.data.size())
+      return T(0);
+    memcpy(&v, buffer.data.data() + element * sizeof(T), sizeof(T));
+    return v;
+  };
+  switch (buffer.type)
+  {
+  case dew_type_u8:
+    return float(read(uint8_t())) / 255.0f;
+  case dew_type_i8:
+    return std::max(float(read(int8_t())) / 127.0f, -1.0f);
+  case dew_type_u16:
+    return float(read(uint16_t())) / 65535.0f;
+  case dew_type_i16:
+    return std::max(float(read(int16_t())) / 32767.0f, -1.0f);
+  case dew_type_u32:
+    return float(double(read(uint32_t())) / 4294967295.0);
+  case dew_type_i32:
+    return float(std::max(double(read(int32_t())) / 2147483647.0, -1.0));
+  case dew_type_r32:
+    return read(float());
+  case dew_type_r64:
+    return float(read(double()));
+  default:
+    return 0.0f;
+  }
+}
+
+// The dynpoints shaders' screen-door hash (lowbias32 of gl_VertexID), as a fraction in [0,1).
+float vertex_hash(uint32_t index)
+{
+  uint32_t h = index;
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+  return float(double(h) / 4294967296.0);
+}
+
+float smoothstep(float edge0, float edge1, float x)
+{
+  const float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+  return t * t * (3.0f - 2.0f * t);
+}
+
+const cpu_rasterizer_t::buffer_t *as_buffer(void *user_ptr)
+{
+  return static_cast<const cpu_rasterizer_t::buffer_t *>(user_ptr);
+}
+} // namespace
+
+image_difference_t compare_images(const cpu_image_t &a, const cpu_image_t &b, int tolerance)
+{
+  image_difference_t out;
+  if (a.width != b.width || a.height != b.height || a.width <= 0 || a.height <= 0)
+  {
+    out.differing_fraction = 1.0;
+    out.rmse = 1.0;
+    return out;
+  }
+  const size_t pixels = size_t(a.width) * size_t(a.height);
+  uint64_t differing = 0;
+  uint64_t covered_a = 0;
+  uint64_t covered_b = 0;
+  double squared = 0;
+  for (size_t i = 0; i < pixels; i++)
+  {
+    const uint8_t *pa = &a.rgba[i * 4];
+    const uint8_t *pb = &b.rgba[i * 4];
+    const bool in_a = pa[3] != 0;
+    const bool in_b = pb[3] != 0;
+    covered_a += in_a;
+    covered_b += in_b;
+    int max_delta = 0;
+    for (int c = 0; c < 3; c++)
+    {
+      const int delta = int(pa[c]) - int(pb[c]);
+      max_delta = std::max(max_delta, std::abs(delta));
+      squared += double(delta) * double(delta) / (255.0 * 255.0);
+    }
+    if (in_a != in_b || max_delta > tolerance)
+      differing++;
+  }
+  out.rmse = std::sqrt(squared / double(pixels * 3));
+  out.differing_fraction = double(differing) / double(pixels);
+  out.coverage_a = double(covered_a) / double(pixels);
+  out.coverage_b = double(covered_b) / double(pixels);
+  return out;
+}
+
+bool write_ppm(const cpu_image_t &image, const std::string &path)
+{
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f)
+    return false;
+  fprintf(f, "P6\n%d %d\n255\n", image.width, image.height);
+  std::vector<uint8_t> row(size_t(image.width) * 3);
+  bool ok = true;
+  for (int y = 0; y < image.height && ok; y++)
+  {
+    for (int x = 0; x < image.width; x++)
+      memcpy(&row[size_t(x) * 3], &image.rgba[(size_t(y) * size_t(image.width) + size_t(x)) * 4], 3);
+    ok = fwrite(row.data(), 1, row.size(), f) == row.size();
+  }
+  return fclose(f) == 0 && ok;
+}
+
+cpu_rasterizer_t::cpu_rasterizer_t(dew_renderer_t *renderer, dew_camera_t *camera, int width, int height)
+  : _renderer(renderer)
+  , _camera(camera)
+{
+  resize(width, height);
+  dew_renderer_callbacks_t callbacks = {};
+  callbacks.create_buffer = &static_create_buffer;
+  callbacks.initialize_buffer = &static_initialize_buffer;
+  callbacks.modify_buffer = &static_modify_buffer;
+  callbacks.destroy_buffer = &static_destroy_buffer;
+  callbacks.create_texture = &static_create_texture;
+  callbacks.initialize_texture = &static_initialize_texture;
+  callbacks.modify_texture = &static_modify_texture;
+  callbacks.destroy_texture = &static_destroy_texture;
+  dew_renderer_set_callback(renderer, callbacks, this);
+}
+
+cpu_rasterizer_t::~cpu_rasterizer_t()
+{
+  // A data source that outlives us would otherwise call back into freed memory on its teardown.
+  dew_renderer_set_callback(_renderer, dew_renderer_callbacks_t{}, nullptr);
+  for (auto *b : _buffers)
+    delete b;
+  for (auto *t : _textures)
+    delete t;
+}
+
+void cpu_rasterizer_t::resize(int width, int height)
+{
+  _image.width = std::max(1, width);
+  _image.height = std::max(1, height);
+  _image.rgba.assign(size_t(_image.width) * size_t(_image.height) * 4, 0);
+  _image.depth.assign(size_t(_image.width) * size_t(_image.height), 1.0f);
+}
+
+size_t cpu_rasterizer_t::live_buffers() const
+{
+  return _buffers.size();
+}
+
+uint64_t cpu_rasterizer_t::buffer_bytes() const
+{
+  uint64_t total = 0;
+  for (auto *b : _buffers)
+    total += b->data.size();
+  return total;
+}
+
+uint64_t cpu_rasterizer_t::take_uploaded_bytes()
+{
+  const uint64_t bytes = _uploaded_bytes;
+  _uploaded_bytes = 0;
+  return bytes;
+}
+
+cpu_frame_stats_t cpu_rasterizer_t::draw()
+{
+  std::fill(_image.rgba.begin(), _image.rgba.end(), uint8_t(0));
+  std::fill(_image.depth.begin(), _image.depth.end(), 1.0f);
+
+  double fov_rad = 0;
+  dew_camera_perspective_properties(_camera, &fov_rad, nullptr, nullptr, nullptr);
+  const float base_point_scale = float(point_world_size * (1.0 / tan(fov_rad / 2.0)) * _image.height / 2.0);
+
+  cpu_frame_stats_t stats;
+  auto frame = dew_renderer_frame(_renderer, _camera);
+  auto t0 = std::chrono::steady_clock::now();
+  stats.draw_groups = frame.to_render_size;
+  for (int i = 0; i < frame.to_render_size; i++)
+  {
+    auto &group = frame.to_render[i];
+    switch (group.draw_type)
+    {
+    case dew_flat_points:
+    case dew_dyn_points_1:
+    case dew_dyn_points_3:
+    case dew_dyn_points_crossfade: {
+      const float lod_scale = std::pow(lod_scale_base, float(group.lod_level));
+      splat_points(group, base_point_scale * lod_scale, stats);
+      stats.point_groups++;
+      stats.points_submitted += uint64_t(std::max(group.draw_size, 0));
+      break;
+    }
+    default:
+      stats.skipped_groups++;
+      break;
+    }
+  }
+  stats.raster_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  return stats;
+}
+
+void cpu_rasterizer_t::splat_points(const dew_draw_group_t &group, float point_scale, cpu_frame_stats_t &stats)
+{
+  const bool flat = group.draw_type == dew_flat_points;
+  const buffer_t *vertex = nullptr;
+  const buffer_t *color = nullptr;
+  const buffer_t *camera = nullptr;
+  const buffer_t *rep_level = nullptr;
+  const buffer_t *params = nullptr;
+  for (int b = 0; b < group.buffers_size; b++)
+  {
+    auto &buffer = group.buffers[b];
+    if (!buffer.user_ptr)
+      continue;
+    if (flat)
+    {
+      switch (dew_buffer_mapping_t(buffer.buffer_mapping))
+      {
+      case dew_bm_vertex:
+        vertex = as_buffer(buffer.user_ptr);
+        break;
+      case dew_bm_camera:
+        camera = as_buffer(buffer.user_ptr);
+        break;
+      case dew_bm_color:
+        color = as_buffer(buffer.user_ptr);
+        break;
+      }
+      continue;
+    }
+    switch (dew_dyn_points_buffer_mapping_t(buffer.buffer_mapping))
+    {
+    case dew_dyn_points_bm_vertex:
+      vertex = as_buffer(buffer.user_ptr);
+      break;
+    case dew_dyn_points_bm_color:
+      color = as_buffer(buffer.user_ptr);
+      break;
+    case dew_dyn_points_bm_camera:
+      camera = as_buffer(buffer.user_ptr);
+      break;
+    case dew_dyn_points_bm_replevel:
+      rep_level = as_buffer(buffer.user_ptr);
+      break;
+    case dew_dyn_points_bm_params:
+      params = as_buffer(buffer.user_ptr);
+      break;
+    case dew_dyn_points_bm_old_color: // always the same buffer as the new colour (see emit_draws)
+      break;
+    }
+  }
+  if (!vertex || !camera || camera->data.size() < sizeof(float) * 16)
+    return;
+
+  float camera_data[16];
+  memcpy(camera_data, camera->data.data(), sizeof(camera_data));
+  const glm::mat4 mvp = glm::make_mat4(camera_data);
+
+  // crossfade params: x = node fade alpha, w = new colour is mono (see emit_draws / dynpoints_crossfade.vert)
+  float fade_alpha = 1.0f;
+  bool mono = group.draw_type == dew_dyn_points_1;
+  if (params && params->data.size() >= sizeof(float) * 4)
+  {
+    float p[4];
+    memcpy(p, params->data.data(), sizeof(p));
+    fade_alpha = p[0];
+    mono = p[3] > 0.5f;
+  }
+
+  const int width = _image.width;
+  const int height = _image.height;
+  const uint32_t count = uint32_t(std::max(group.draw_size, 0));
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const glm::vec4 position(fetch_component(*vertex, i, 0), fetch_component(*vertex, i, 1), fetch_component(*vertex, i, 2), 1.0f);
+    const glm::vec4 clip = mvp * position;
+    if (clip.w <= 0.0f)
+      continue;
+
+    float size = 1.0f;
+    if (!flat)
+    {
+      // Per-point LOD, exactly as dynpoints_3.vert: rep_level * 255 against the grid level of this depth.
+      const float rep = rep_level ? fetch_component(*rep_level, i, 0) * 255.0f : 0.0f;
+      const float cells = group.lod_density_scale * clip.w / std::max(group.lod_px_scale, 1e-6f);
+      const float level = std::log2(std::max(cells, 1e-9f));
+      const float alpha = std::clamp(rep - level + 1.0f, 0.0f, 1.0f) * fade_alpha;
+      if (vertex_hash(i) > alpha)
+        continue;
+      size = std::clamp(point_scale / clip.w, 1.0f, 64.0f);
+    }
+
+    const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+    if (ndc.x < -1.0f || ndc.x > 1.0f || ndc.y < -1.0f || ndc.y > 1.0f || ndc.z < -1.0f || ndc.z > 1.0f)
+      continue;
+    const float depth = ndc.z * 0.5f + 0.5f;
+    const float cx = (ndc.x * 0.5f + 0.5f) * float(width);
+    const float cy = (0.5f - ndc.y * 0.5f) * float(height);
+
+    float rgb[3] = {1.0f, 1.0f, 1.0f};
+    if (color)
+    {
+      rgb[0] = fetch_component(*color, i, 0);
+      rgb[1] = mono ? rgb[0] : fetch_component(*color, i, 1);
+      rgb[2] = mono ? rgb[0] : fetch_component(*color, i, 2);
+    }
+
+    // GL point rasterization: the pixels whose centres fall inside the size x size square around the point.
+    const float half = size * 0.5f;
+    const int x0 = std::max(0, int(std::ceil(cx - half - 0.5f)));
+    const int x1 = std::min(width - 1, int(std::floor(cx + half - 0.5f)));
+    const int y0 = std::max(0, int(std::ceil(cy - half - 0.5f)));
+    const int y1 = std::min(height - 1, int(std::floor(cy + half - 0.5f)));
+    bool splatted = false;
+    for (int y = y0; y <= y1; y++)
+    {
+      for (int x = x0; x <= x1; x++)
+      {
+        float edge = 1.0f;
+        if (!flat)
+        {
+          // dynpoints.frag: a disc with a darkened rim.
+          const float u = (float(x) + 0.5f - (cx - half)) / size - 0.5f;
+          const float v = (float(y) + 0.5f - (cy - half)) / size - 0.5f;
+          const float dist = std::sqrt(u * u + v * v) * 2.0f;
+          if (dist > 1.0f)
+            continue;
+          edge = 1.0f - smoothstep(0.5f, 1.0f, dist) * 0.4f;
+        }
+        const size_t pixel = size_t(y) * size_t(width) + size_t(x);
+        if (depth >= _image.depth[pixel])
+          continue;
+        _image.depth[pixel] = depth;
+        uint8_t *out = &_image.rgba[pixel * 4];
+        for (int c = 0; c < 3; c++)
+          out[c] = uint8_t(std::lround(std::clamp(rgb[c] * edge, 0.0f, 1.0f) * 255.0f));
+        out[3] = 255;
+        splatted = true;
+      }
+    }
+    stats.points_splatted += splatted;
+  }
+}
+
+void cpu_rasterizer_t::static_create_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, enum dew_buffer_type_t buffer_type, void **buffer_user_ptr)
+{
+  (void)renderer;
+  auto *self = static_cast<cpu_rasterizer_t *>(renderer_user_ptr);
+  auto *buffer = new buffer_t;
+  buffer->buffer_type = buffer_type;
+  self->_buffers.push_back(buffer);
+  *buffer_user_ptr = buffer;
+}
+
+void cpu_rasterizer_t::static_initialize_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *buffer_user_ptr, enum dew_type_t type,
+                                                enum dew_components_t components, int buffer_size, void *data)
+{
+  (void)renderer;
+  auto *self = static_cast<cpu_rasterizer_t *>(renderer_user_ptr);
+  auto *cpu_buffer = static_cast<buffer_t *>(buffer_user_ptr);
+  cpu_buffer->type = type;
+  cpu_buffer->components = components;
+  const size_t size = size_t(std::max(buffer_size, 0));
+  cpu_buffer->data.resize(size);
+  if (data && size)
+    memcpy(cpu_buffer->data.data(), data, size);
+  self->_uploaded_bytes += size;
+  // Same ownership contract as the GL consumer: vertex/index data is copied out and released at once,
+  // uniform data (camera matrices, params) stays owned by the renderer and is re-sent through modify.
+  if (cpu_buffer->buffer_type != dew_buffer_type_uniform)
+    dew_buffer_release_data(buffer);
+}
+
+void cpu_rasterizer_t::static_modify_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *buffer_user_ptr, int offset, int buffer_size, void *data)
+{
+  (void)renderer;
+  auto *self = static_cast<cpu_rasterizer_t *>(renderer_user_ptr);
+  auto *cpu_buffer = static_cast<buffer_t *>(buffer_user_ptr);
+  if (buffer_size <= 0 || offset < 0)
+    return;
+  const size_t end = size_t(offset) + size_t(buffer_size);
+  if (cpu_buffer->data.size() < end)
+    cpu_buffer->data.resize(end);
+  if (data)
+    memcpy(cpu_buffer->data.data() + offset, data, size_t(buffer_size));
+  self->_uploaded_bytes += size_t(buffer_size);
+  if (cpu_buffer->buffer_type != dew_buffer_type_uniform)
+    dew_buffer_release_data(buffer);
+}
+
+void cpu_rasterizer_t::static_destroy_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, void *buffer_user_ptr)
+{
+  (void)renderer;
+  auto *self = static_cast<cpu_rasterizer_t *>(renderer_user_ptr);
+  auto *cpu_buffer = static_cast<buffer_t *>(buffer_user_ptr);
+  auto it = std::find(self->_buffers.begin(), self->_buffers.end(), cpu_buffer);
+  if (it == self->_buffers.end())
+    return;
+  self->_buffers.erase(it);
+  delete cpu_buffer;
+}
+
+void cpu_rasterizer_t::static_create_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, enum dew_texture_type_t buffer_texture_type, void **buffer_user_ptr)
+{
+  (void)renderer;
+  (void)buffer_texture_type;
+  auto *self = static_cast<cpu_rasterizer_t *>(renderer_user_ptr);
+  auto *texture = new buffer_t;
+  self->_textures.push_back(texture);
+  *buffer_user_ptr = texture;
+}
+
+void cpu_rasterizer_t::static_initialize_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *texture_user_ptr,
+                                                 enum dew_texture_type_t buffer_texture_type, enum dew_type_t type, enum dew_components_t components, int size[3], void *data)
+{
+  (void)renderer;
+  (void)renderer_user_ptr;
+  (void)texture_user_ptr;
+  (void)buffer_texture_type;
+  (void)type;
+  (void)components;
+  (void)size;
+  (void)data;
+  dew_buffer_release_data(buffer);
+}
+
+void cpu_rasterizer_t::static_modify_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *texture_user_ptr,
+                                             enum dew_texture_type_t buffer_texture_type, int offset[3], int size[3], void *data)
+{
+  (void)renderer;
+  (void)renderer_user_ptr;
+  (void)texture_user_ptr;
+  (void)buffer_texture_type;
+  (void)offset;
+  (void)size;
+  (void)data;
+  dew_buffer_release_data(buffer);
+}
+
+void cpu_rasterizer_t::static_destroy_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, void *texture_user_ptr)
+{
+  (void)renderer;
+  auto *self = static_cast<cpu_rasterizer_t *>(renderer_user_ptr);
+  auto *texture = static_cast<buffer_t *>(texture_user_ptr);
+  auto it = std::find(self->_textures.begin(), self->_textures.end(), texture);
+  if (it == self->_textures.end())
+    return;
+  self->_textures.erase(it);
+  delete texture;
+}
+
+} // namespace dew::render
@@ -0,0 +1,133 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#pragma once
+
+// A headless reference consumer of dew_renderer_callbacks_t: the buffer callbacks keep CPU copies, and
+// draw() splats the frame's point groups into an RGBA8 + depth image on the calling thread. It exists so the
+// streaming pipeline can be measured (frame time, time-to-full-detail, bytes per frame, image convergence) on
+// a machine without a GPU -- CI, a container, a profiler session -- with the exact draw groups a GL
+// consumer would get.
+//
+// It mirrors the GL example (examples/renderer/gl_renderer.cpp) and its dynpoints shaders, not a "nicer"
+// splatter: the same point size formula, the same per-point LOD screen-door (same hash of the vertex index),
+// the same disc with darkened rim. A difference in what the two draw is a bug in one of them. Everything
+// that is not a point group (skybox, environment, gizmos, boxes) is counted and skipped; those are
+// decoration and carry nothing about streaming.
+//
+// Like the GL consumer this is single-threaded: the callbacks and draw() must come from the thread that
+// drives dew_renderer_frame. Tear down in the usual consumer order -- data sources, then the rasterizer
+// (it unhooks its callbacks), then the renderer.
+
+#include <dew/render/camera.h>
+#include <dew/render/renderer.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dew::render
+{
+
+struct cpu_image_t
+{
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> rgba; // row 0 is the top; alpha 0 marks a pixel no point covered
+  std::vector<float> depth;  // window depth [0,1], 1 where nothing was drawn
+};
+
+struct cpu_frame_stats_t
+{
+  int draw_groups = 0;
+  int point_groups = 0;
+  int skipped_groups = 0;          // non-point groups (skybox, gizmo, ...), not rasterized
+  uint64_t points_submitted = 0;   // sum of draw_size over the point groups
+  uint64_t points_splatted = 0;    // survived the LOD screen-door, w > 0 and the viewport
+  double raster_ms = 0;            // the splat itself, excluding dew_renderer_frame
+};
+
+// Per-pixel comparison of two images of the same size. A pixel differs when coverage disagrees (one drawn,
+// one empty) or any colour channel is more than `tolerance` apart. rmse is over rgb in [0,1], all pixels.
+struct image_difference_t
+{
+  double rmse = 0;
+  double differing_fraction = 0;
+  double coverage_a = 0; // fraction of pixels covered
+  double coverage_b = 0;
+};
+
+image_difference_t compare_images(const cpu_image_t &a, const cpu_image_t &b, int tolerance = 8);
+
+// Binary PPM (P6) of the rgb channels, for eyeballing a benchmark run. Returns false on IO failure.
+bool write_ppm(const cpu_image_t &image, const std::string &path);
+
+class cpu_rasterizer_t
+{
+public:
+  cpu_rasterizer_t(dew_renderer_t *renderer, dew_camera_t *camera, int width, int height);
+  ~cpu_rasterizer_t();
+  cpu_rasterizer_t(const cpu_rasterizer_t &) = delete;
+  cpu_rasterizer_t &operator=(const cpu_rasterizer_t &) = delete;
+
+  void resize(int width, int height);
+  // Clear, run dew_renderer_frame for the camera and splat what it returned.
+  cpu_frame_stats_t draw();
+
+  [[nodiscard]] const cpu_image_t &image() const { return _image; }
+  // Buffer bookkeeping, the CPU stand-in for GPU memory: live buffers and the bytes they hold.
+  [[nodiscard]] size_t live_buffers() const;
+  [[nodiscard]] uint64_t buffer_bytes() const;
+  // Bytes handed over by initialize/modify since the last call -- the "upload" traffic of a frame.
+  uint64_t take_uploaded_bytes();
+
+  // Same knobs and defaults as gl_renderer.
+  float point_world_size = 0.05f;
+  float lod_scale_base = 1.1f;
+
+  struct buffer_t
+  {
+    dew_buffer_type_t buffer_type = dew_buffer_type_vertex;
+    dew_type_t type = dew_type_u8;
+    dew_components_t components = dew_components_1;
+    std::vector<uint8_t> data;
+  };
+
+private:
+  static void static_create_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, enum dew_buffer_type_t buffer_type, void **buffer_user_ptr);
+  static void static_initialize_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *buffer_user_ptr, enum dew_type_t type,
+                                       enum dew_components_t components, int buffer_size, void *data);
+  static void static_modify_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *buffer_user_ptr, int offset, int buffer_size, void *data);
+  static void static_destroy_buffer(struct dew_renderer_t *renderer, void *renderer_user_ptr, void *buffer_user_ptr);
+  static void static_create_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, enum dew_texture_type_t buffer_texture_type, void **buffer_user_ptr);
+  static void static_initialize_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *texture_user_ptr,
+                                        enum dew_texture_type_t buffer_texture_type, enum dew_type_t type, enum dew_components_t components, int size[3], void *data);
+  static void static_modify_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, struct dew_buffer_t *buffer, void *texture_user_ptr,
+                                    enum dew_texture_type_t buffer_texture_type, int offset[3], int size[3], void *data);
+  static void static_destroy_texture(struct dew_renderer_t *renderer, void *renderer_user_ptr, void *texture_user_ptr);
+
+  void splat_points(const dew_draw_group_t &group, float point_scale, cpu_frame_stats_t &stats);
+
+  dew_renderer_t *_renderer;
+  dew_camera_t *_camera;
+  cpu_image_t _image;
+  std::vector<buffer_t *> _buffers;
+  std::vector<buffer_t *> _textures; // kept only to balance create/destroy; texels are not retained
+  uint64_t _uploaded_bytes = 0;
+};
+
+} // namespace dew::render
@@ -77,6 +77,17 @@ public:
   virtual bool is_ready(load_handle_t handle) = 0;
   virtual loaded_node_data_t get_data(load_handle_t handle) = 0;
   virtual void cancel(load_handle_t handle) = 0;
+
+  // Read-ahead for a node the camera is predicted to reach: pull its blobs into the reader's compressed
+  // cache WITHOUT decoding or producing loaded data, so the real request_load a few frames later is a cache
+  // hit. is_ready() reports the reads landing; cancel() releases the handle (the bytes stay cached either
+  // way). A loader that cannot prefetch returns invalid_load_handle, which the scheduler treats as "off".
+  virtual load_handle_t request_prefetch(const void *request_data, uint32_t request_size)
+  {
+    (void)request_data;
+    (void)request_size;
+    return invalid_load_handle;
+  }
 };
 
 } // namespace dew::render
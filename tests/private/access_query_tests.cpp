@@ -32,11 +32,16 @@
 #include <dew/converter/converter.h>
 #include <dew/core/default_attribute_names.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdio>
 #include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <cstring>
+#include <filesystem>
+#include <map>
 #include <mutex>
 #include <string>
 #include <tuple>
@@ -160,6 +165,209 @@ bool build_dataset(const char *path)
   return ok;
 }
 
+// The same grid, pushed through dew_converter_push_points in small batches instead of read from a file.
+// The segment size is set low enough that the stream is cut into several segments on the way.
+bool build_pushed_dataset(const char *path)
+{
+  g_source = make_source();
+  std::remove(path);
+  dew_error_t *error = nullptr;
+  auto *converter = dew_converter_create(path, strlen(path), dew_open_file_semantics_truncate, &error);
+  if (!converter)
+  {
+    if (error)
+      dew_error_destroy(error);
+    return false;
+  }
+  dew_converter_set_node_point_limit(converter, 900);
+  dew_converter_set_tree_scale(converter, k_spacing);
+  dew_converter_set_push_segment_points(converter, 5000);
+
+  dew_converter_header_t header{};
+  for (int i = 0; i < 3; i++)
+  {
+    header.offset[i] = 0.0;
+    header.scale[i] = k_spacing;
+    header.min[i] = 0.0;
+    header.max[i] = double(k_grid - 1) * k_spacing;
+  }
+  const dew_attribute_t attributes[] = {{DEW_ATTRIBUTE_XYZ, uint32_t(strlen(DEW_ATTRIBUTE_XYZ)), dew_type_i32, dew_components_3},
+                                        {DEW_ATTRIBUTE_INTENSITY, uint32_t(strlen(DEW_ATTRIBUTE_INTENSITY)), dew_type_u16, dew_components_1}};
+  bool ok = true;
+  constexpr uint32_t batch = 1000;
+  for (uint32_t first = 0; first < k_point_count && ok; first += batch)
+  {
+    const uint32_t n = std::min(batch, k_point_count - first);
+    header.point_count = n;
+    dew_blob_t buffers[2];
+    buffers[0] = dew_blob_t(g_source.xyz.data() + size_t(first) * 3, uint32_t(n * 3 * sizeof(int32_t)));
+    buffers[1] = dew_blob_t(g_source.intensity.data() + first, uint32_t(n * sizeof(uint16_t)));
+    ok = dew_converter_push_points(converter, &header, attributes, 2, buffers, n, 1, &error) == dew_push_status_accepted;
+    if (first == 7 * batch)
+      dew_converter_push_flush(converter);
+  }
+  if (error)
+    dew_error_destroy(error);
+  dew_converter_push_end(converter);
+  dew_converter_wait_idle(converter);
+  ok = ok && dew_converter_status(converter) == dew_conversion_status_completed;
+  dew_converter_destroy(converter);
+  return ok;
+}
+
+// Two copies of the grid side by side ("left" at x 0.., "right" shifted one grid width along x), converted
+// together; then "right" is removed again, or replaced by "far", one more grid width along. The finished
+// conversion has collapsed every leaf into its own unit, so the edit has to re-read "right" and subtract
+// its points from the merged units.
+struct edit_file_t
+{
+  int32_t x_offset = 0;
+  uint32_t emitted = 0;
+};
+
+void edit_init(const char *name, size_t name_size, dew_converter_header_t *header, dew_attributes_t *attributes, void **user_ptr, dew_error_t **error)
+{
+  init(name, name_size, header, attributes, user_ptr, error);
+  auto *file = new edit_file_t();
+  const std::string file_name(name, name_size);
+  file->x_offset = file_name == "right" ? int32_t(k_grid) : file_name == "far" ? int32_t(2 * k_grid) : 0;
+  header->min[0] += double(file->x_offset) * k_spacing;
+  header->max[0] += double(file->x_offset) * k_spacing;
+  *user_ptr = file;
+}
+
+void edit_convert_data(void *user_ptr, const dew_converter_header_t *, const dew_attribute_t *, uint32_t, uint32_t max_points, dew_blob_t *buffers, uint32_t buffer_count, uint32_t *points_read, uint8_t *done,
+                       dew_error_t **)
+{
+  auto *file = static_cast<edit_file_t *>(user_ptr);
+  const uint32_t n = std::min(k_point_count - file->emitted, max_points);
+  auto *xyz = static_cast<int32_t *>(buffers[0].data);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    xyz[i * 3 + 0] = g_source.xyz[size_t(file->emitted + i) * 3 + 0] + file->x_offset;
+    xyz[i * 3 + 1] = g_source.xyz[size_t(file->emitted + i) * 3 + 1];
+    xyz[i * 3 + 2] = g_source.xyz[size_t(file->emitted + i) * 3 + 2];
+  }
+  if (buffer_count >= 2)
+    memcpy(buffers[1].data, g_source.intensity.data() + file->emitted, size_t(n) * sizeof(uint16_t));
+  file->emitted += n;
+  *points_read = n;
+  *done = file->emitted >= k_point_count ? 1 : 0;
+}
+
+void edit_destroy_user_ptr(void *user_ptr)
+{
+  delete static_cast<edit_file_t *>(user_ptr);
+}
+
+// `before_path`, when set, receives a copy of the dataset as it was before the edit.
+bool build_edited_dataset(const char *path, const char *replacement = nullptr, const char *before_path = nullptr)
+{
+  g_source = make_source();
+  std::remove(path);
+  dew_error_t *error = nullptr;
+  auto *converter = dew_converter_create(path, strlen(path), dew_open_file_semantics_truncate, &error);
+  if (!converter)
+  {
+    if (error)
+      dew_error_destroy(error);
+    return false;
+  }
+  dew_converter_file_convert_callbacks_t callbacks{};
+  callbacks.pre_init = pre_init;
+  callbacks.init = edit_init;
+  callbacks.convert_data = edit_convert_data;
+  callbacks.destroy_user_ptr = edit_destroy_user_ptr;
+  dew_converter_set_file_converter_callbacks(converter, callbacks);
+  dew_converter_set_node_point_limit(converter, 900);
+
+  dew_converter_str_buffer names[] = {{"left", 4}, {"right", 5}};
+  dew_converter_add_data_file(converter, names, 2);
+  dew_converter_wait_idle(converter);
+  bool ok = dew_converter_status(converter) == dew_conversion_status_completed;
+  if (ok && before_path)
+  {
+    std::error_code copy_error;
+    ok = std::filesystem::copy_file(path, before_path, std::filesystem::copy_options::overwrite_existing, copy_error);
+  }
+
+  // Unknown inputs are refused up front.
+  ok = ok && !dew_converter_remove_input(converter, "middle", 6, &error);
+  if (error)
+    dew_error_destroy(error);
+  error = nullptr;
+
+  if (replacement)
+    ok = ok && dew_converter_replace_input(converter, "right", 5, replacement, strlen(replacement), &error);
+  else
+    ok = ok && dew_converter_remove_input(converter, "right", 5, &error);
+  dew_converter_wait_idle(converter);
+  ok = ok && dew_converter_status(converter) == dew_conversion_status_completed;
+  if (error)
+    dew_error_destroy(error);
+  dew_converter_destroy(converter);
+  return ok;
+}
+
+// The grid pushed twice with duplicate elimination on: the second copy (intensity + 1000) arrives after a
+// flush, so it lands in its own chunk and only leaf collapse sees both copies. Its first batch is pushed
+// once more (intensity + 2000) inside that chunk, which the sort worker has to drop on its own.
+bool build_dedup_dataset(const char *path, uint64_t &duplicates_removed)
+{
+  g_source = make_source();
+  std::remove(path);
+  dew_error_t *error = nullptr;
+  auto *converter = dew_converter_create(path, strlen(path), dew_open_file_semantics_truncate, &error);
+  if (!converter)
+  {
+    if (error)
+      dew_error_destroy(error);
+    return false;
+  }
+  dew_converter_set_node_point_limit(converter, 900);
+  dew_converter_set_tree_scale(converter, k_spacing);
+  dew_converter_set_dedup(converter, 1, 0, dew_converter_dedup_keep_max_intensity);
+
+  dew_converter_header_t header{};
+  for (int i = 0; i < 3; i++)
+  {
+    header.offset[i] = 0.0;
+    header.scale[i] = k_spacing;
+    header.min[i] = 0.0;
+    header.max[i] = double(k_grid - 1) * k_spacing;
+  }
+  const dew_attribute_t attributes[] = {{DEW_ATTRIBUTE_XYZ, uint32_t(strlen(DEW_ATTRIBUTE_XYZ)), dew_type_i32, dew_components_3},
+                                        {DEW_ATTRIBUTE_INTENSITY, uint32_t(strlen(DEW_ATTRIBUTE_INTENSITY)), dew_type_u16, dew_components_1}};
+  constexpr uint32_t batch = 1000;
+  auto push = [&](uint32_t first, uint32_t n, uint16_t intensity_bias) {
+    std::vector<uint16_t> intensity(g_source.intensity.begin() + first, g_source.intensity.begin() + first + n);
+    for (auto &value : intensity)
+      value = uint16_t(value + intensity_bias);
+    header.point_count = n;
+    dew_blob_t buffers[2];
+    buffers[0] = dew_blob_t(g_source.xyz.data() + size_t(first) * 3, uint32_t(n * 3 * sizeof(int32_t)));
+    buffers[1] = dew_blob_t(intensity.data(), uint32_t(n * sizeof(uint16_t)));
+    return dew_converter_push_points(converter, &header, attributes, 2, buffers, n, 1, &error) == dew_push_status_accepted;
+  };
+  bool ok = true;
+  for (uint32_t first = 0; first < k_point_count && ok; first += batch)
+    ok = push(first, std::min(batch, k_point_count - first), 0);
+  dew_converter_push_flush(converter);
+  for (uint32_t first = 0; first < k_point_count && ok; first += batch)
+    ok = push(first, std::min(batch, k_point_count - first), 1000);
+  ok = ok && push(0, batch, 2000);
+  if (error)
+    dew_error_destroy(error);
+  dew_converter_push_end(converter);
+  dew_converter_wait_idle(converter);
+  ok = ok && dew_converter_status(converter) == dew_conversion_status_completed;
+  dew_converter_stats_t stats{};
+  dew_converter_get_compression_stats(converter, &stats);
+  duplicates_removed = stats.duplicate_points_removed;
+  dew_converter_destroy(converter);
+  return ok;
+}
+
 struct dataset_handle_t
 {
   explicit dataset_handle_t(const char *path)
@@ -182,6 +390,122 @@ struct dataset_handle_t
 
 const char *k_path = "access_query_test.dew";
 
+// A full-resolution query over everything, so every tree is resident for a look at the registry.
+void load_all_trees(dew_dataset_t *dataset)
+{
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -1e6;
+    spec.aabb_max[i] = 1e6;
+  }
+  spec.lod_mode = dew_lod_full;
+  spec.clip_mode = dew_clip_node;
+  auto *request = dew_dataset_request_region(dataset, &spec, nullptr);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+  dew_request_release(request);
+}
+
+using morton_range_t = std::pair<dew::core::morton::morton192_t, dew::core::morton::morton192_t>;
+
+// The morton range an edited grid file covers: its corners are points of the file, so they are its
+// smallest and largest morton codes.
+morton_range_t grid_file_range(const dew::core::tree_registry_t &registry, int32_t x_offset)
+{
+  const double min[3] = {double(x_offset) * k_spacing, 0.0, 0.0};
+  const double max[3] = {double(x_offset + int32_t(k_grid) - 1) * k_spacing, double(k_grid - 1) * k_spacing, double(k_grid - 1) * k_spacing};
+  morton_range_t range;
+  dew::core::convert_pos_to_morton(registry.tree_config.scale, registry.tree_config.offset, min, range.first);
+  dew::core::convert_pos_to_morton(registry.tree_config.scale, registry.tree_config.offset, max, range.second);
+  return range;
+}
+
+// Where the blobs of every resident node unit lie whose morton range misses all of `edited`, keyed by
+// the unit's range and whether it holds source points. An edit rewrites only the nodes it overlaps, so
+// these have to come through it unchanged.
+using unit_key_t = std::array<uint64_t, 7>;
+std::map<unit_key_t, std::vector<std::array<uint64_t, 3>>> units_outside(const dew::core::tree_registry_t &registry, const std::vector<morton_range_t> &edited)
+{
+  std::map<unit_key_t, std::vector<std::array<uint64_t, 3>>> units;
+  for (const auto &tree : registry.data)
+  {
+    if (!tree)
+      continue;
+    for (const auto &level : tree->data)
+      for (const auto &collection : level)
+      {
+        if (collection.data.empty())
+          continue;
+        const bool outside = std::all_of(edited.begin(), edited.end(), [&](const auto &range) { return collection.max < range.first || range.second < collection.min; });
+        if (!outside)
+          continue;
+        for (const auto &subset : collection.data)
+        {
+          const unit_key_t key = {collection.min.data[0], collection.min.data[1], collection.min.data[2], collection.max.data[0], collection.max.data[1], collection.max.data[2],
+                                  uint64_t(dew::core::input_data_id_is_leaf(subset.input_id))};
+          auto &locations = units[key];
+          for (const auto &location : tree->storage_map.info(subset.input_id).second)
+            locations.push_back({location.file_id, location.offset, location.size});
+        }
+      }
+  }
+  return units;
+}
+
+// The blobs of every unit outside the edited ranges before the edit, found at the same place after it.
+void require_untouched_units_kept(const char *before_path, dew_dataset_t *after, const std::vector<int32_t> &edited_offsets)
+{
+  dataset_handle_t before(before_path);
+  REQUIRE(before.handle != nullptr);
+  REQUIRE(dew_dataset_state(before.handle) == dew_dataset_ready);
+  load_all_trees(before.handle);
+  load_all_trees(after);
+
+  std::vector<morton_range_t> edited;
+  for (auto x_offset : edited_offsets)
+    edited.push_back(grid_file_range(before.handle->registry(), x_offset));
+  const auto kept_before = units_outside(before.handle->registry(), edited);
+  const auto kept_after = units_outside(after->registry(), edited);
+  REQUIRE(!kept_before.empty());
+  for (const auto &[key, locations] : kept_before)
+  {
+    auto it = kept_after.find(key);
+    REQUIRE(it != kept_after.end());
+    REQUIRE(it->second == locations);
+  }
+}
+
+// A point-budget query over the edited area: the LOD nodes the edit rebuilt must have lost the removed
+// file's points too, not just the leaves. Returns the x of every point.
+std::vector<double> lod_query_x(dew_dataset_t *dataset, double x_max)
+{
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -1.0;
+    spec.aabb_max[i] = double(k_grid) + 1.0;
+  }
+  spec.aabb_max[0] = x_max;
+  spec.lod_mode = dew_lod_point_budget;
+  spec.max_points = k_point_count / 8;
+  spec.position_format = dew_position_r64_absolute;
+  spec.clip_mode = dew_clip_node;
+  auto *request = dew_dataset_request_region(dataset, &spec, nullptr);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+  dew_request_result_t result{};
+  REQUIRE(dew_request_get_result(request, &result) == 1);
+  REQUIRE(result.point_count > 0);
+  REQUIRE(result.point_count < k_point_count);
+  const auto *positions = static_cast<const double *>(result.buffers[0].data);
+  std::vector<double> x;
+  for (uint64_t i = 0; i < result.point_count; i++)
+    x.push_back(positions[i * 3]);
+  dew_request_release(request);
+  return x;
+}
+
 // Element width for a dew_type_t, so a test can check a buffer holds exactly point_count entries.
 uint32_t size_for_format_bytes(dew_type_t type)
 {
@@ -249,6 +573,119 @@ TEST_CASE("access: a full-resolution box query returns exactly the converted poi
   dew_request_release(request);
 }
 
+TEST_CASE("access: points pushed as a live stream convert like the same points read from a file")
+{
+  const char *path = "access_query_push_test.dew";
+  REQUIRE(build_pushed_dataset(path));
+  dataset_handle_t dataset(path);
+  REQUIRE(dataset.handle != nullptr);
+  REQUIRE(dew_dataset_state(dataset.handle) == dew_dataset_ready);
+
+  const char *attributes[] = {DEW_ATTRIBUTE_INTENSITY};
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -1.0;
+    spec.aabb_max[i] = double(k_grid) + 1.0;
+  }
+  spec.lod_mode = dew_lod_full;
+  spec.attribute_names = attributes;
+  spec.attribute_count = 1;
+  spec.position_format = dew_position_r64_absolute;
+  spec.clip_mode = dew_clip_node;
+
+  dew_error_t *error = nullptr;
+  auto *request = dew_dataset_request_region(dataset.handle, &spec, &error);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+
+  dew_request_result_t result{};
+  REQUIRE(dew_request_get_result(request, &result) == 1);
+  // Every batch lands exactly once, across segment cuts, the explicit flush and batch coalescing.
+  REQUIRE(result.point_count == k_point_count);
+  dew_request_release(request);
+}
+
+TEST_CASE("access: a removed input's points are gone and the rest of the dataset is intact")
+{
+  const char *path = "access_query_edit_test.dew";
+  const char *before_path = "access_query_edit_test_before.dew";
+  REQUIRE(build_edited_dataset(path, nullptr, before_path));
+  dataset_handle_t dataset(path);
+  REQUIRE(dataset.handle != nullptr);
+  REQUIRE(dew_dataset_state(dataset.handle) == dew_dataset_ready);
+
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -1.0;
+    spec.aabb_max[i] = double(2 * k_grid) + 1.0;
+  }
+  spec.lod_mode = dew_lod_full;
+  spec.position_format = dew_position_r64_absolute;
+  spec.clip_mode = dew_clip_node;
+
+  auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+
+  dew_request_result_t result{};
+  REQUIRE(dew_request_get_result(request, &result) == 1);
+  REQUIRE(result.point_count == k_point_count);
+  const auto *positions = static_cast<const double *>(result.buffers[0].data);
+  for (uint64_t i = 0; i < result.point_count; i++)
+    REQUIRE(positions[i * 3] <= double(k_grid - 1) + 0.5);
+  dew_request_release(request);
+
+  for (double x : lod_query_x(dataset.handle, double(2 * k_grid) + 1.0))
+    REQUIRE(x <= double(k_grid - 1) + 0.5);
+  require_untouched_units_kept(before_path, dataset.handle, {int32_t(k_grid)});
+}
+
+TEST_CASE("access: a replaced input's points are gone and the replacement's are returned")
+{
+  const char *path = "access_query_replace_test.dew";
+  const char *before_path = "access_query_replace_test_before.dew";
+  REQUIRE(build_edited_dataset(path, "far", before_path));
+  dataset_handle_t dataset(path);
+  REQUIRE(dataset.handle != nullptr);
+  REQUIRE(dew_dataset_state(dataset.handle) == dew_dataset_ready);
+
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -1.0;
+    spec.aabb_max[i] = double(3 * k_grid) + 1.0;
+  }
+  spec.lod_mode = dew_lod_full;
+  spec.position_format = dew_position_r64_absolute;
+  spec.clip_mode = dew_clip_node;
+
+  auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+
+  dew_request_result_t result{};
+  REQUIRE(dew_request_get_result(request, &result) == 1);
+  REQUIRE(result.point_count == 2 * uint64_t(k_point_count));
+  // Nothing where "right" was; "far" holds exactly one grid's worth.
+  const auto *positions = static_cast<const double *>(result.buffers[0].data);
+  uint64_t far_points = 0;
+  for (uint64_t i = 0; i < result.point_count; i++)
+  {
+    const double x = positions[i * 3];
+    REQUIRE((x <= double(k_grid - 1) + 0.5 || x >= double(2 * k_grid) - 0.5));
+    if (x >= double(2 * k_grid) - 0.5)
+      far_points++;
+  }
+  REQUIRE(far_points == k_point_count);
+  dew_request_release(request);
+
+  for (double x : lod_query_x(dataset.handle, double(3 * k_grid) + 1.0))
+    REQUIRE((x <= double(k_grid - 1) + 0.5 || x >= double(2 * k_grid) - 0.5));
+  require_untouched_units_kept(before_path, dataset.handle, {int32_t(k_grid), int32_t(2 * k_grid)});
+}
+
 TEST_CASE("access: decoded positions land inside the dataset bounds and on the source grid")
 {
   dataset_handle_t dataset(k_path);
@@ -358,6 +795,209 @@ TEST_CASE("access: node-granular clipping is a superset of point clipping")
   REQUIRE(point_points == 9 * 9 * 9);
 }
 
+TEST_CASE("access: polygon, corridor and frustum regions clip to the shape and prune by it")
+{
+  using namespace dew::access;
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  auto query = [&](const dew_region_geometry_t &geometry, std::vector<double> &positions) {
+    dew_region_request_t spec{};
+    spec.lod_mode = dew_lod_full;
+    spec.position_format = dew_position_r64_absolute;
+    spec.clip_mode = dew_clip_point;
+    spec.geometry = &geometry;
+    auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    dew_request_result_t result{};
+    REQUIRE(dew_request_get_result(request, &result) == 1);
+    const auto *xyz = static_cast<const double *>(result.buffers[0].data);
+    positions.assign(xyz, xyz + result.point_count * 3);
+    dew_request_release(request);
+  };
+
+  // A right triangle whose hypotenuse runs along x + y = 10.2: the 66 grid cells with x + y <= 10.
+  const double triangle[] = {-0.5, -0.5, 10.7, -0.5, -0.5, 10.7};
+  dew_region_geometry_t polygon{};
+  polygon.shape = dew_region_polygon;
+  polygon.vertices = triangle;
+  polygon.vertex_count = 3;
+  std::vector<double> positions;
+  query(polygon, positions);
+  REQUIRE(positions.size() == size_t(66 * k_grid) * 3);
+  for (size_t i = 0; i < positions.size(); i += 3)
+    REQUIRE(positions[i] + positions[i + 1] <= 10.0);
+
+  // The same prism cut to z in [2.5, 5.5]: three layers.
+  polygon.z_min = 2.5;
+  polygon.z_max = 5.5;
+  query(polygon, positions);
+  REQUIRE(positions.size() == size_t(66 * 3) * 3);
+  for (size_t i = 0; i < positions.size(); i += 3)
+    REQUIRE((positions[i + 2] >= 3.0 && positions[i + 2] <= 5.0));
+
+  // Within 0.5 of the diagonal only x == y qualifies (the next cells are 0.707 away).
+  const double diagonal[] = {0.0, 0.0, 23.0, 23.0};
+  dew_region_geometry_t corridor{};
+  corridor.shape = dew_region_corridor;
+  corridor.vertices = diagonal;
+  corridor.vertex_count = 2;
+  corridor.radius = 0.5;
+  query(corridor, positions);
+  REQUIRE(positions.size() == size_t(k_grid * k_grid) * 3);
+  for (size_t i = 0; i < positions.size(); i += 3)
+    REQUIRE(positions[i] == positions[i + 1]);
+
+  // Six axis planes bounding [2.5, 5.5]^3.
+  dew_region_geometry_t frustum{};
+  frustum.shape = dew_region_frustum;
+  for (int axis = 0; axis < 3; axis++)
+  {
+    frustum.planes[axis * 2][axis] = 1.0;
+    frustum.planes[axis * 2][3] = -2.5;
+    frustum.planes[axis * 2 + 1][axis] = -1.0;
+    frustum.planes[axis * 2 + 1][3] = 5.5;
+  }
+  query(frustum, positions);
+  REQUIRE(positions.size() == size_t(27) * 3);
+
+  // The walk alone: a thin corridor reaches fewer nodes than the whole dataset.
+  region_query_t walk_query;
+  walk_query.whole_dataset = true;
+  region_result_t all;
+  region_walk(dataset.handle->registry(), walk_query, all);
+  REQUIRE(all.trees_to_load.empty());
+  walk_query.geometry.kind = geometry_kind_t::corridor;
+  walk_query.geometry.vertices.assign(std::begin(diagonal), std::end(diagonal));
+  walk_query.geometry.radius = 0.5;
+  region_result_t along;
+  region_walk(dataset.handle->registry(), walk_query, along);
+  MESSAGE("nodes: " << all.nodes.size() << " in the dataset, " << along.nodes.size() << " along the corridor");
+  REQUIRE(along.nodes.size() < all.nodes.size());
+  REQUIRE(along.total_points >= k_grid * k_grid);
+
+  // Bad shapes are refused up front.
+  dew_region_geometry_t degenerate{};
+  degenerate.shape = dew_region_polygon;
+  degenerate.vertices = triangle;
+  degenerate.vertex_count = 2;
+  dew_region_request_t spec{};
+  spec.geometry = &degenerate;
+  dew_error_t *error = nullptr;
+  REQUIRE(dew_dataset_request_region(dataset.handle, &spec, &error) == nullptr);
+  REQUIRE(error != nullptr);
+  dew_error_destroy(error);
+}
+
+TEST_CASE("access: attribute predicates filter per point and prune nodes by their zone maps")
+{
+  using namespace dew::access;
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  auto query = [&](const dew_attribute_predicate_t &predicate, bool fetch_intensity, std::vector<double> &positions, std::vector<uint16_t> &intensity) {
+    const char *attributes[] = {DEW_ATTRIBUTE_INTENSITY};
+    dew_region_request_t spec{};
+    spec.lod_mode = dew_lod_full;
+    spec.position_format = dew_position_r64_absolute;
+    spec.clip_mode = dew_clip_point;
+    spec.attribute_names = fetch_intensity ? attributes : nullptr;
+    spec.attribute_count = fetch_intensity ? 1 : 0;
+    spec.predicates = &predicate;
+    spec.predicate_count = 1;
+    auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    dew_request_result_t result{};
+    REQUIRE(dew_request_get_result(request, &result) == 1);
+    REQUIRE(result.buffer_count == (fetch_intensity ? 2u : 1u));
+    const auto *xyz = static_cast<const double *>(result.buffers[0].data);
+    positions.assign(xyz, xyz + result.point_count * 3);
+    if (fetch_intensity)
+    {
+      REQUIRE(result.buffers[1].size_bytes == result.point_count * sizeof(uint16_t));
+      const auto *values = static_cast<const uint16_t *>(result.buffers[1].data);
+      intensity.assign(values, values + result.point_count);
+    }
+    dew_request_release(request);
+  };
+
+  // intensity = x + 8y: [0, 15] keeps x 0..15 on y 0 and x 0..7 on y 1, on every z.
+  std::vector<double> positions;
+  std::vector<uint16_t> intensity;
+  const dew_attribute_predicate_t low{DEW_ATTRIBUTE_INTENSITY, dew_predicate_range, 0.0, 15.0, nullptr, 0};
+  query(low, true, positions, intensity);
+  REQUIRE(intensity.size() == size_t(24 * k_grid));
+  for (size_t i = 0; i < intensity.size(); i++)
+  {
+    REQUIRE(intensity[i] <= 15);
+    REQUIRE(uint16_t(positions[i * 3] + positions[i * 3 + 1] * 8) == intensity[i]);
+  }
+
+  // A predicate on an attribute that is not fetched still filters: only (0,0) and (1,1) on each z.
+  const double wanted[] = {0.0, 9.0};
+  const dew_attribute_predicate_t set{DEW_ATTRIBUTE_INTENSITY, dew_predicate_in, 0, 0, wanted, 2};
+  query(set, false, positions, intensity);
+  REQUIRE(positions.size() == size_t(2 * k_grid) * 3);
+  for (size_t i = 0; i < positions.size(); i += 3)
+    REQUIRE(positions[i] == positions[i + 1]);
+
+  // The walk alone, against the now resident trees: the zone maps rule nodes out before any read.
+  region_query_t walk_query;
+  walk_query.whole_dataset = true;
+  region_result_t all;
+  region_walk(dataset.handle->registry(), walk_query, all);
+  REQUIRE(all.trees_to_load.empty());
+
+  walk_query.attributes = &dataset.handle->attributes;
+  walk_query.predicates.push_back({DEW_ATTRIBUTE_INTENSITY, predicate_op_t::range, 0.0, 15.0, {}});
+  region_result_t filtered;
+  region_walk(dataset.handle->registry(), walk_query, filtered);
+  MESSAGE("nodes: " << all.nodes.size() << " unfiltered, " << filtered.nodes.size() << " with intensity <= 15");
+  REQUIRE(filtered.nodes.size() < all.nodes.size());
+  REQUIRE(filtered.total_points >= 24 * k_grid);
+
+  walk_query.predicates[0] = {DEW_ATTRIBUTE_INTENSITY, predicate_op_t::range, 1000.0, 2000.0, {}};
+  region_result_t none;
+  region_walk(dataset.handle->registry(), walk_query, none);
+  REQUIRE(none.nodes.empty());
+  REQUIRE(none.pruned_subtrees > 0);
+}
+
+TEST_CASE("access: a value-set zone map rules out values its range alone would admit")
+{
+  using namespace dew::access;
+  attribute_zone_t zone;
+  zone.min = 2;
+  zone.max = 6;
+  zone.value_bits[0] = (uint64_t(1) << 2) | (uint64_t(1) << 6);
+  zone.flags = attribute_zone_has_range | attribute_zone_has_values;
+
+  auto in = [](std::vector<double> values) { return attribute_predicate_t{"classification", predicate_op_t::in, 0, 0, std::move(values)}; };
+  auto not_in = [](std::vector<double> values) { return attribute_predicate_t{"classification", predicate_op_t::not_in, 0, 0, std::move(values)}; };
+  REQUIRE_FALSE(zone_may_match(zone, in({3, 4, 5})));
+  REQUIRE(zone_may_match(zone, in({6})));
+  REQUIRE_FALSE(zone_may_match(zone, not_in({2, 6})));
+  REQUIRE(zone_may_match(zone, not_in({2})));
+
+  // Without the value set only the range is known, and it cannot exclude 3..5.
+  zone.flags = attribute_zone_has_range;
+  REQUIRE(zone_may_match(zone, in({3, 4, 5})));
+  REQUIRE_FALSE(zone_may_match(zone, in({7})));
+
+  // Merging keeps the union, and anything unknown on either side stays unknown.
+  attribute_zone_t other = zone;
+  other.min = 9;
+  other.max = 9;
+  attribute_zone_merge(zone, other);
+  REQUIRE(zone.min == 2);
+  REQUIRE(zone.max == 9);
+  attribute_zone_merge(zone, attribute_zone_t());
+  REQUIRE(zone.flags == 0);
+  REQUIRE(zone_may_match(zone, in({100})));
+}
+
 TEST_CASE("access: copy-out matches the borrowed buffer, and refuses a short destination")
 {
   dataset_handle_t dataset(k_path);
@@ -599,12 +1239,13 @@ TEST_CASE("access: a wait that times out reports pending, not failure")
 
 TEST_CASE("access: results are byte-identical however many decode threads run")
 {
-  // Decode happens on the pool, so several nodes are decoded at once. If a node wrote straight into
-  // the shared concatenated buffers, the output order would depend on thread scheduling and this
-  // would differ run to run. Staging per node and appending in walk order is what prevents it -- and
-  // a reordering bug would still produce a plausible-looking point cloud, so only a byte comparison
-  // catches it.
-  auto run = [](uint32_t threads) {
+  // Decode happens on the pool, so several nodes are decoded at once, each straight into its slice
+  // of the shared concatenated buffers. The slices are handed out in walk order before any decode
+  // starts, which is what keeps the output independent of thread scheduling -- and a reordering bug
+  // would still produce a plausible-looking point cloud, so only a byte comparison catches it.
+  // Point clipping on a sub-box leaves gaps behind the straddling nodes, which the final compaction
+  // closes, so it is run both ways.
+  auto run = [](uint32_t threads, dew_clip_mode_t clip_mode, double lo, double hi) {
     dew_dataset_options_t options{};
     options.decode_threads = threads;
     dew_error_t *error = nullptr;
@@ -616,14 +1257,14 @@ TEST_CASE("access: results are byte-identical however many decode threads run")
     dew_region_request_t spec{};
     for (int i = 0; i < 3; i++)
     {
-      spec.aabb_min[i] = -1.0;
-      spec.aabb_max[i] = double(k_grid) + 1.0;
+      spec.aabb_min[i] = lo;
+      spec.aabb_max[i] = hi;
     }
     spec.lod_mode = dew_lod_full;
     spec.attribute_names = attributes;
     spec.attribute_count = 1;
     spec.position_format = dew_position_r64_absolute;
-    spec.clip_mode = dew_clip_node;
+    spec.clip_mode = clip_mode;
 
     auto *request = dew_dataset_request_region(dataset, &spec, nullptr);
     REQUIRE(request != nullptr);
@@ -634,17 +1275,33 @@ TEST_CASE("access: results are byte-identical however many decode threads run")
     std::vector<uint8_t> xyz(static_cast<const uint8_t *>(result.buffers[0].data), static_cast<const uint8_t *>(result.buffers[0].data) + result.buffers[0].size_bytes);
     std::vector<uint8_t> intensity(static_cast<const uint8_t *>(result.buffers[1].data), static_cast<const uint8_t *>(result.buffers[1].data) + result.buffers[1].size_bytes);
     const uint64_t count = result.point_count;
+    // The buffers are exact, and the nodes tile them back to back.
+    REQUIRE(xyz.size() == count * 3 * sizeof(double));
+    uint64_t next = 0;
+    for (uint32_t n = 0; n < result.node_count; n++)
+    {
+      REQUIRE(result.nodes[n].first_point == next);
+      next += result.nodes[n].point_count;
+    }
+    REQUIRE(next == count);
     dew_request_release(request);
     dew_dataset_close(dataset);
     return std::tuple{count, xyz, intensity};
   };
 
-  const auto inline_decode = run(1);
-  const auto parallel_decode = run(8);
+  const auto inline_decode = run(1, dew_clip_node, -1.0, double(k_grid) + 1.0);
+  const auto parallel_decode = run(8, dew_clip_node, -1.0, double(k_grid) + 1.0);
   REQUIRE(std::get<0>(inline_decode) == k_point_count);
   REQUIRE(std::get<0>(parallel_decode) == std::get<0>(inline_decode));
   REQUIRE(std::get<1>(parallel_decode) == std::get<1>(inline_decode));
   REQUIRE(std::get<2>(parallel_decode) == std::get<2>(inline_decode));
+
+  const auto inline_clipped = run(1, dew_clip_point, 4.0 - 0.25, 12.0 + 0.25);
+  const auto parallel_clipped = run(8, dew_clip_point, 4.0 - 0.25, 12.0 + 0.25);
+  REQUIRE(std::get<0>(inline_clipped) == 9 * 9 * 9);
+  REQUIRE(std::get<0>(parallel_clipped) == std::get<0>(inline_clipped));
+  REQUIRE(std::get<1>(parallel_clipped) == std::get<1>(inline_clipped));
+  REQUIRE(std::get<2>(parallel_clipped) == std::get<2>(inline_clipped));
 }
 
 TEST_CASE("access: attribute buffers stay aligned with the positions across mixed nodes")
@@ -753,6 +1410,471 @@ TEST_CASE("access: reads are genuinely overlapped, not merely coroutine-shaped")
   REQUIRE(batched_peak >= 8);
 }
 
+TEST_CASE("access: the walk and the reads are pipelined, and the request reports how it went")
+{
+  // A fresh dataset, so every sub-tree the query needs is really read by it.
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  auto run = [&](dew_lod_mode_t mode, std::vector<double> &positions) {
+    dew_region_request_t spec{};
+    spec.lod_mode = mode;
+    spec.position_format = dew_position_r64_absolute;
+    spec.clip_mode = dew_clip_point;
+    auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    dew_request_result_t result{};
+    REQUIRE(dew_request_get_result(request, &result) == 1);
+    const auto *xyz = static_cast<const double *>(result.buffers[0].data);
+    positions.assign(xyz, xyz + result.point_count * 3);
+    dew_request_stats_t stats{};
+    REQUIRE(dew_request_get_stats(request, &stats) == 1);
+    dew_request_release(request);
+    return stats;
+  };
+
+  std::vector<double> pipelined;
+  const auto stats = run(dew_lod_full, pipelined);
+  MESSAGE("walk rounds " << stats.walk_rounds << ", trees loaded " << stats.trees_loaded << ", round trips " << stats.round_trips << ", first blob after "
+                         << stats.time_to_first_blob_ms << " ms of " << stats.total_ms << " ms");
+  REQUIRE(pipelined.size() == size_t(k_point_count) * 3);
+  // One walk from the root, then exactly one more per sub-tree descended into -- never a re-walk.
+  REQUIRE(stats.walk_rounds == 1 + stats.trees_loaded);
+  REQUIRE(stats.time_to_first_blob_ms <= stats.total_ms);
+  REQUIRE(stats.speculative_trees == 0);
+
+  // What it read: positions only, so one blob per node, out of the nodes its walks looked at.
+  REQUIRE(stats.nodes_read > 0);
+  REQUIRE(stats.nodes_walked >= stats.nodes_read);
+  REQUIRE(stats.blobs_read == stats.nodes_read);
+  REQUIRE(stats.cache_hits <= stats.blobs_read);
+  REQUIRE(stats.bytes_compressed > 0);
+  REQUIRE(stats.bytes_decompressed > 0);
+  REQUIRE(stats.peak_reads_in_flight >= 1);
+  // The phases are disjoint stretches of the request's own thread, so they never exceed the whole.
+  const double phases = stats.walk_ms + stats.io_wait_ms + stats.decode_ms + stats.clip_ms + stats.append_ms;
+  REQUIRE(stats.walk_ms >= 0);
+  REQUIRE(stats.io_wait_ms >= 0);
+  REQUIRE(stats.decode_ms >= 0);
+  REQUIRE(stats.clip_ms >= 0);
+  REQUIRE(stats.append_ms >= 0);
+  REQUIRE(phases <= stats.total_ms + 1e-6);
+
+  // Again, with every sub-tree now resident: nothing to load, and -- since sub-trees are descended in
+  // the order they were asked for, not the order they landed -- the very same points in the very
+  // same order.
+  std::vector<double> resident;
+  const auto warm = run(dew_lod_full, resident);
+  REQUIRE(warm.trees_loaded == 0);
+  REQUIRE(resident == pipelined);
+  REQUIRE(warm.nodes_read == stats.nodes_read);
+
+  // The dataset adds up both.
+  dew_dataset_stats_t totals{};
+  dew_dataset_get_stats(dataset.handle, &totals);
+  REQUIRE(totals.requests == 2);
+  REQUIRE(totals.totals.nodes_read == stats.nodes_read + warm.nodes_read);
+  REQUIRE(totals.totals.blobs_read == stats.blobs_read + warm.blobs_read);
+  REQUIRE(totals.totals.trees_loaded == stats.trees_loaded);
+  REQUIRE(totals.totals.bytes_compressed == stats.bytes_compressed + warm.bytes_compressed);
+  REQUIRE(totals.totals.peak_reads_in_flight == std::max(stats.peak_reads_in_flight, warm.peak_reads_in_flight));
+  REQUIRE(totals.cache_hits + totals.cache_misses >= totals.totals.blobs_read);
+  REQUIRE(totals.cache_hits >= totals.totals.cache_hits);
+  REQUIRE(totals.peak_storage_reads_in_flight >= 1);
+}
+
+TEST_CASE("access: a region batch returns what each region would alone, sharing the nodes they overlap")
+{
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  const char *attributes[] = {DEW_ATTRIBUTE_INTENSITY};
+  auto base = [&]() {
+    dew_region_request_t spec{};
+    spec.lod_mode = dew_lod_full;
+    spec.attribute_names = attributes;
+    spec.attribute_count = 1;
+    spec.position_format = dew_position_r64_absolute;
+    spec.clip_mode = dew_clip_point;
+    return spec;
+  };
+
+  // Two boxes that overlap in the middle of the grid, one off to the side of it entirely, and the
+  // whole dataset (an empty box).
+  dew_region_t regions[4]{};
+  for (int i = 0; i < 3; i++)
+  {
+    regions[0].aabb_min[i] = -1.0;
+    regions[0].aabb_max[i] = double(k_grid) + 1.0;
+    regions[1].aabb_min[i] = -1.0;
+    regions[1].aabb_max[i] = double(k_grid) + 1.0;
+    regions[2].aabb_min[i] = double(k_grid) * 4.0;
+    regions[2].aabb_max[i] = double(k_grid) * 5.0;
+  }
+  regions[0].aabb_max[0] = double(k_grid) * 0.6;
+  regions[1].aabb_min[0] = double(k_grid) * 0.4;
+
+  struct region_points_t
+  {
+    std::vector<double> xyz;
+    std::vector<uint8_t> intensity;
+    std::vector<dew_result_node_t> nodes;
+  };
+  auto take = [](const dew_request_result_t &result) {
+    region_points_t out;
+    const auto *xyz = static_cast<const double *>(result.buffers[0].data);
+    out.xyz.assign(xyz, xyz + result.point_count * 3);
+    const auto *intensity = static_cast<const uint8_t *>(result.buffers[1].data);
+    out.intensity.assign(intensity, intensity + result.buffers[1].size_bytes);
+    out.nodes.assign(result.nodes, result.nodes + result.node_count);
+    return out;
+  };
+
+  std::vector<region_points_t> alone;
+  for (auto &region : regions)
+  {
+    auto spec = base();
+    for (int i = 0; i < 3; i++)
+    {
+      spec.aabb_min[i] = region.aabb_min[i];
+      spec.aabb_max[i] = region.aabb_max[i];
+    }
+    auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    REQUIRE(dew_request_region_count(request) == 1);
+    dew_request_result_t result{};
+    REQUIRE(dew_request_get_result(request, &result) == 1);
+    alone.push_back(take(result));
+    dew_request_release(request);
+  }
+  REQUIRE(alone[2].xyz.empty());
+  REQUIRE(alone[3].xyz.size() == size_t(k_point_count) * 3);
+
+  auto spec = base();
+  auto *request = dew_dataset_request_regions(dataset.handle, &spec, regions, 4, nullptr);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+  REQUIRE(dew_request_region_count(request) == 4);
+  size_t batch_nodes = 0;
+  for (uint32_t r = 0; r < 4; r++)
+  {
+    dew_request_result_t result{};
+    REQUIRE(dew_request_get_region_result(request, r, &result) == 1);
+    const auto batched = take(result);
+    // Same points, same order, same per-node split as the region asked for on its own.
+    REQUIRE(batched.xyz == alone[r].xyz);
+    REQUIRE(batched.intensity == alone[r].intensity);
+    REQUIRE(batched.nodes.size() == alone[r].nodes.size());
+    batch_nodes += batched.nodes.size();
+  }
+  dew_request_result_t out_of_range{};
+  REQUIRE(dew_request_get_region_result(request, 4, &out_of_range) == 0);
+  // Region 0 of a batch is also what the single-result accessor reports.
+  dew_request_result_t first{};
+  REQUIRE(dew_request_get_result(request, &first) == 1);
+  REQUIRE(first.point_count == alone[0].xyz.size() / 3);
+  dew_request_release(request);
+
+  // The regions overlap, so the results name some nodes more than once -- and every one of those was
+  // read and decoded a single time for the batch, because the batch walked the union once.
+  REQUIRE(batch_nodes > alone[3].nodes.size());
+}
+
+TEST_CASE("access: a sample draws exactly N distinct points, evenly, and reads LOD nodes where they suffice")
+{
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  auto run = [&](const double lo[3], const double hi[3], uint64_t n, uint64_t seed) {
+    const char *attributes[] = {DEW_ATTRIBUTE_INTENSITY};
+    dew_region_request_t spec{};
+    for (int i = 0; i < 3; i++)
+    {
+      spec.aabb_min[i] = lo[i];
+      spec.aabb_max[i] = hi[i];
+    }
+    spec.lod_mode = dew_lod_sample;
+    spec.max_points = n;
+    spec.sample_seed = seed;
+    spec.attribute_names = attributes;
+    spec.attribute_count = 1;
+    spec.position_format = dew_position_r64_absolute;
+    spec.clip_mode = dew_clip_point;
+    auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    dew_request_result_t result{};
+    REQUIRE(dew_request_get_result(request, &result) == 1);
+    const auto *xyz = static_cast<const double *>(result.buffers[0].data);
+    std::vector<double> positions(xyz, xyz + result.point_count * 3);
+    REQUIRE(result.buffers[1].size_bytes == result.point_count * sizeof(uint16_t));
+    uint32_t lod_nodes = 0;
+    uint64_t next = 0;
+    for (uint32_t i = 0; i < result.node_count; i++)
+    {
+      REQUIRE(result.nodes[i].first_point == next);
+      next += result.nodes[i].point_count;
+      lod_nodes += result.nodes[i].is_lod;
+    }
+    REQUIRE(next == result.point_count);
+    dew_request_release(request);
+    return std::pair{positions, lod_nodes};
+  };
+  // Every point a grid point inside the box, and none drawn twice.
+  auto check = [](const std::vector<double> &positions, const double lo[3], const double hi[3]) {
+    std::vector<std::tuple<double, double, double>> points;
+    for (size_t i = 0; i < positions.size(); i += 3)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        REQUIRE(positions[i + size_t(c)] >= lo[c]);
+        REQUIRE(positions[i + size_t(c)] <= hi[c]);
+        REQUIRE(positions[i + size_t(c)] == std::round(positions[i + size_t(c)]));
+      }
+      points.emplace_back(positions[i], positions[i + 1], positions[i + 2]);
+    }
+    std::sort(points.begin(), points.end());
+    REQUIRE(std::adjacent_find(points.begin(), points.end()) == points.end());
+  };
+
+  const double all_lo[3] = {-1, -1, -1};
+  const double all_hi[3] = {double(k_grid) + 1, double(k_grid) + 1, double(k_grid) + 1};
+
+  // A sparse sample is read from sampled LOD nodes where they are dense enough, yet spreads evenly
+  // over the grid's octants.
+  const auto [sparse, sparse_lod] = run(all_lo, all_hi, 800, 1);
+  REQUIRE(sparse.size() == 800 * 3);
+  REQUIRE(sparse_lod > 0);
+  check(sparse, all_lo, all_hi);
+  uint32_t octants[8] = {};
+  for (size_t i = 0; i < sparse.size(); i += 3)
+    octants[(sparse[i] >= k_grid / 2 ? 1 : 0) | (sparse[i + 1] >= k_grid / 2 ? 2 : 0) | (sparse[i + 2] >= k_grid / 2 ? 4 : 0)]++;
+  for (uint32_t count : octants)
+  {
+    MESSAGE("octant: " << count << " of 800");
+    REQUIRE(count >= 60);
+    REQUIRE(count <= 140);
+  }
+
+  // The seed decides the draw, and nothing else does.
+  REQUIRE(run(all_lo, all_hi, 800, 1).first == sparse);
+  REQUIRE(run(all_lo, all_hi, 800, 2).first != sparse);
+
+  // A dense sample of a sub-box needs the full resolution, and is clipped to the box before the draw.
+  const double lo[3] = {2.0 - 0.25, 2.0 - 0.25, 2.0 - 0.25};
+  const double hi[3] = {17.0 + 0.25, 17.0 + 0.25, 17.0 + 0.25}; // 16^3 = 4096 points
+  const auto [dense, dense_lod] = run(lo, hi, 3000, 7);
+  REQUIRE(dense.size() == 3000 * 3);
+  REQUIRE(dense_lod == 0);
+  check(dense, lo, hi);
+
+  // Asking for more than the region holds returns all of it.
+  const auto [everything, everything_lod] = run(lo, hi, 100000, 7);
+  REQUIRE(everything.size() == 4096 * 3);
+  REQUIRE(everything_lod == 0);
+  check(everything, lo, hi);
+}
+
+TEST_CASE("access: an aggregate request reduces in the engine and matches the points it summarises")
+{
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -0.5;
+    spec.aabb_max[i] = double(k_grid) - 0.5;
+  }
+  spec.lod_mode = dew_lod_full;
+
+  auto run = [&](const dew_aggregate_request_t &aggregate, dew_aggregate_result_t &out) {
+    auto *request = dew_dataset_request_aggregate(dataset.handle, &spec, &aggregate, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    REQUIRE(dew_request_get_aggregate(request, &out) == 1);
+    // Only the aggregate comes back; there are no points to read.
+    dew_request_result_t points{};
+    REQUIRE(dew_request_get_result(request, &points) == 1);
+    REQUIRE(points.point_count == 0);
+    return request;
+  };
+
+  // Mean / min / max of intensity (x + 8y) in 4x4 cells, and a histogram of it in bins of 8.
+  dew_aggregate_request_t aggregate{};
+  aggregate.attribute_name = DEW_ATTRIBUTE_INTENSITY;
+  aggregate.cell_size = 4.0;
+  aggregate.bin_count = 26;
+  aggregate.bin_min = 0;
+  aggregate.bin_max = 208;
+  aggregate.full_resolution = 1;
+  dew_aggregate_result_t result{};
+  auto *request = run(aggregate, result);
+
+  REQUIRE(result.point_count == k_point_count);
+  REQUIRE(result.used_lod == 0);
+  REQUIRE(result.value_min == 0.0);
+  REQUIRE(result.value_max == double(k_grid - 1) * 9.0);
+  REQUIRE(result.grid_width == 7); // six full columns, plus the one the far edge of the box falls in
+  REQUIRE(result.grid_height == 7);
+
+  std::vector<uint64_t> expected_count(size_t(result.grid_width) * result.grid_height, 0);
+  std::vector<double> expected_min(expected_count.size(), 1e300);
+  std::vector<double> expected_max(expected_count.size(), -1e300);
+  std::vector<double> expected_sum(expected_count.size(), 0.0);
+  std::vector<uint64_t> expected_bins(aggregate.bin_count, 0);
+  for (uint32_t z = 0; z < k_grid; z++)
+    for (uint32_t y = 0; y < k_grid; y++)
+      for (uint32_t x = 0; x < k_grid; x++)
+      {
+        const double value = double(x + y * 8);
+        const size_t cell = size_t(y / 4) * result.grid_width + x / 4;
+        expected_count[cell]++;
+        expected_min[cell] = std::min(expected_min[cell], value);
+        expected_max[cell] = std::max(expected_max[cell], value);
+        expected_sum[cell] += value;
+        expected_bins[size_t(value / 8)]++;
+      }
+  for (size_t cell = 0; cell < expected_count.size(); cell++)
+  {
+    REQUIRE(result.cell_count[cell] == expected_count[cell]);
+    if (expected_count[cell] == 0)
+    {
+      REQUIRE(std::isnan(result.cell_mean[cell]));
+      continue;
+    }
+    REQUIRE(result.cell_min[cell] == expected_min[cell]);
+    REQUIRE(result.cell_max[cell] == expected_max[cell]);
+    REQUIRE(result.cell_mean[cell] == doctest::Approx(expected_sum[cell] / double(expected_count[cell])));
+  }
+  REQUIRE(result.bin_count == aggregate.bin_count);
+  REQUIRE(std::vector<uint64_t>(result.bins, result.bins + result.bin_count) == expected_bins);
+  REQUIRE(result.below_bins == 0);
+  REQUIRE(result.above_bins == 0);
+  dew_request_release(request);
+
+  // A grid far coarser than the points lets sampled LOD nodes stand in: the same footprint, read
+  // from far fewer points.
+  dew_aggregate_request_t coarse{};
+  coarse.cell_size = 12.0;
+  dew_aggregate_result_t lod{};
+  request = run(coarse, lod);
+  MESSAGE("a 12-unit grid aggregated " << lod.point_count << " of " << k_point_count << " points");
+  REQUIRE(lod.used_lod == 1);
+  REQUIRE(lod.point_count > 0);
+  REQUIRE(lod.point_count < k_point_count);
+  REQUIRE(lod.value_min >= 0.0);
+  REQUIRE(lod.value_max <= double(k_grid - 1));
+  dew_request_release(request);
+
+  // A grid needs a bounded region; the whole dataset is not one.
+  dew_region_request_t whole{};
+  dew_error_t *error = nullptr;
+  REQUIRE(dew_dataset_request_aggregate(dataset.handle, &whole, &coarse, &error) == nullptr);
+  REQUIRE(error != nullptr);
+  dew_error_destroy(error);
+}
+
+TEST_CASE("access: knn and radius searches match a brute-force search over the source points")
+{
+  dataset_handle_t dataset(k_path);
+  REQUIRE(dataset.handle != nullptr);
+
+  // Sorted distances from `p` to every source point, the answer any correct search must reproduce.
+  auto brute_force = [](const double *p) {
+    std::vector<double> out;
+    out.reserve(k_point_count);
+    for (uint32_t z = 0; z < k_grid; z++)
+      for (uint32_t y = 0; y < k_grid; y++)
+        for (uint32_t x = 0; x < k_grid; x++)
+          out.push_back(std::sqrt((x - p[0]) * (x - p[0]) + (y - p[1]) * (y - p[1]) + (z - p[2]) * (z - p[2])));
+    std::sort(out.begin(), out.end());
+    return out;
+  };
+
+  // Neighbouring seeds, so their answers overlap, plus one outside the grid altogether.
+  const double seeds[] = {10.0, 10.0, 10.0, 10.4, 10.2, 9.7, 11.0, 10.0, 10.0, 0.2, 23.1, 5.5, -6.0, 30.0, 12.0};
+  const uint32_t seed_count = 5;
+  const char *attributes[] = {DEW_ATTRIBUTE_INTENSITY};
+
+  auto run = [&](bool knn, uint32_t k, double radius) {
+    dew_search_request_t spec{};
+    spec.query_points = seeds;
+    spec.query_count = seed_count;
+    spec.k = k;
+    spec.radius = radius;
+    spec.attribute_names = attributes;
+    spec.attribute_count = 1;
+    auto *request = knn ? dew_dataset_request_knn(dataset.handle, &spec, nullptr) : dew_dataset_request_radius(dataset.handle, &spec, nullptr);
+    REQUIRE(request != nullptr);
+    REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+    return request;
+  };
+
+  auto check = [&](dew_request_t *request, bool knn, uint32_t k, double radius) {
+    dew_search_result_t search{};
+    REQUIRE(dew_request_get_search(request, &search) == 1);
+    dew_request_result_t points{};
+    REQUIRE(dew_request_get_result(request, &points) == 1);
+    REQUIRE(search.query_count == seed_count);
+    REQUIRE(search.offsets[seed_count] == search.neighbour_count);
+    const auto *xyz = static_cast<const double *>(points.buffers[0].data);
+    const auto *intensity = static_cast<const uint16_t *>(points.buffers[1].data);
+    for (uint32_t q = 0; q < seed_count; q++)
+    {
+      const double *p = &seeds[q * 3];
+      auto expected = brute_force(p);
+      if (knn)
+        expected.resize(k);
+      else
+        expected.erase(std::upper_bound(expected.begin(), expected.end(), radius), expected.end());
+      const uint64_t first = search.offsets[q];
+      const uint64_t count = search.offsets[q + 1] - first;
+      REQUIRE(count == expected.size());
+      for (uint64_t i = 0; i < count; i++)
+      {
+        REQUIRE(search.distances[first + i] == doctest::Approx(expected[i]));
+        // The index really names that neighbour, and its attribute came along with it.
+        const uint64_t index = search.indices[first + i];
+        REQUIRE(index < points.point_count);
+        const double *n = &xyz[index * 3];
+        REQUIRE(std::sqrt((n[0] - p[0]) * (n[0] - p[0]) + (n[1] - p[1]) * (n[1] - p[1]) + (n[2] - p[2]) * (n[2] - p[2])) == doctest::Approx(search.distances[first + i]));
+        REQUIRE(intensity[index] == uint16_t(n[0] + n[1] * 8));
+      }
+    }
+    // Neighbouring seeds share neighbours, and each shared point is returned once.
+    REQUIRE(points.point_count < search.neighbour_count);
+  };
+
+  auto *knn = run(true, 9, 0.0);
+  check(knn, true, 9, 0.0);
+  dew_request_release(knn);
+
+  auto *radius = run(false, 0, 2.5);
+  check(radius, false, 0, 2.5);
+  dew_request_release(radius);
+
+  // A radius search needs a radius.
+  dew_search_request_t invalid{};
+  invalid.query_points = seeds;
+  invalid.query_count = 1;
+  dew_error_t *error = nullptr;
+  REQUIRE(dew_dataset_request_radius(dataset.handle, &invalid, &error) == nullptr);
+  REQUIRE(error != nullptr);
+  dew_error_destroy(error);
+
+  // A non-finite query point is refused rather than left to read the whole dataset.
+  const double not_finite[] = {10.0, std::numeric_limits<double>::quiet_NaN(), 10.0};
+  invalid.query_points = not_finite;
+  invalid.k = 1;
+  error = nullptr;
+  REQUIRE(dew_dataset_request_knn(dataset.handle, &invalid, &error) == nullptr);
+  REQUIRE(error != nullptr);
+  dew_error_destroy(error);
+}
+
 TEST_CASE("access: request status is idempotent and survives release-after-cancel")
 {
   dataset_handle_t dataset(k_path);
@@ -785,3 +1907,49 @@ TEST_CASE("access: request status is idempotent and survives release-after-cance
   REQUIRE(dew_request_status(request) == terminal); // cancelling a finished request changes nothing
   dew_request_release(request);
 }
+
+TEST_CASE("access: duplicate points are dropped within and across chunks, keeping the policy's survivor")
+{
+  const char *path = "access_query_dedup_test.dew";
+  uint64_t duplicates_removed = 0;
+  REQUIRE(build_dedup_dataset(path, duplicates_removed));
+  REQUIRE(duplicates_removed == uint64_t(k_point_count) + 1000);
+
+  dataset_handle_t dataset(path);
+  REQUIRE(dataset.handle != nullptr);
+  REQUIRE(dew_dataset_state(dataset.handle) == dew_dataset_ready);
+
+  const char *attributes[] = {DEW_ATTRIBUTE_INTENSITY};
+  dew_region_request_t spec{};
+  for (int i = 0; i < 3; i++)
+  {
+    spec.aabb_min[i] = -1.0;
+    spec.aabb_max[i] = double(k_grid) + 1.0;
+  }
+  spec.lod_mode = dew_lod_full;
+  spec.attribute_names = attributes;
+  spec.attribute_count = 1;
+  spec.position_format = dew_position_r64_absolute;
+  spec.clip_mode = dew_clip_node;
+
+  auto *request = dew_dataset_request_region(dataset.handle, &spec, nullptr);
+  REQUIRE(request != nullptr);
+  REQUIRE(dew_request_wait(request, -1) == dew_request_completed);
+
+  dew_request_result_t result{};
+  REQUIRE(dew_request_get_result(request, &result) == 1);
+  // One point per grid position survives three copies of the first batch and two of the rest...
+  REQUIRE(result.point_count == k_point_count);
+  REQUIRE(result.buffer_count == 2);
+  REQUIRE(result.buffers[1].type == dew_type_u16);
+  // ...and it is always a later copy: max-intensity never keeps the unbiased first push.
+  const auto *intensity = static_cast<const uint16_t *>(result.buffers[1].data);
+  uint32_t from_third_copy = 0;
+  for (uint64_t i = 0; i < result.point_count; i++)
+  {
+    REQUIRE(intensity[i] >= 1000);
+    from_third_copy += intensity[i] >= 2000 ? 1 : 0;
+  }
+  REQUIRE(from_third_copy == 1000);
+  dew_request_release(request);
+}
@@ -0,0 +1,123 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include <doctest/doctest.h>
+
+#include "autotuner.hpp"
+#include "perf_stats.hpp"
+
+#include <string>
+
+namespace
+{
+using namespace dew;
+using namespace dew::converter;
+using namespace dew::core;
+
+constexpr uint64_t operator""_mb(unsigned long long v)
+{
+  return uint64_t(v) * 1024 * 1024;
+}
+
+TEST_CASE("autotuner sheds memory first, feeds the backed-up stage and reverts a change that cost throughput")
+{
+  autotuner_t tuner(8, 1024_mb, 64_mb);
+  REQUIRE(tuner.settings().max_readers == 2);
+  REQUIRE(tuner.settings().max_sorters == 4);
+  REQUIRE(tuner.settings().max_compressors == 4);
+
+  std::string decision;
+  autotune_sample_t sample;
+  sample.seconds = 2;
+  REQUIRE(!tuner.update(sample, decision)); // baseline
+
+  auto advance = [&sample](uint64_t bytes) {
+    sample.read_bytes += bytes;
+    sample.write_bytes += bytes;
+  };
+
+  // Compressions queue up: one compressor more.
+  advance(400_mb);
+  sample.writes_queued = 6;
+  sample.writes_running = 4;
+  REQUIRE(tuner.update(sample, decision));
+  REQUIRE(tuner.settings().max_compressors == 5);
+
+  // Throughput then drops by half: the change is undone and the knob held.
+  advance(200_mb);
+  REQUIRE(tuner.update(sample, decision));
+  REQUIRE(tuner.settings().max_compressors == 4);
+  REQUIRE(decision.find("reverted") != std::string::npos);
+  advance(200_mb);
+  REQUIRE(!tuner.update(sample, decision));
+
+  // Sorts back up instead: one sorter more.
+  sample.writes_queued = 0;
+  sample.sorts_queued = 3;
+  advance(200_mb);
+  REQUIRE(tuner.update(sample, decision));
+  REQUIRE(tuner.settings().max_sorters == 5);
+
+  // Over 90% of the budget: a reader goes, and with one left the chunks halve; neither is reverted.
+  sample.sorts_queued = 0;
+  sample.memory_bytes = 1000_mb;
+  advance(10_mb);
+  REQUIRE(tuner.update(sample, decision));
+  REQUIRE(tuner.settings().max_readers == 1);
+  REQUIRE(tuner.settings().max_sorters == 5);
+  advance(10_mb);
+  REQUIRE(tuner.update(sample, decision));
+  REQUIRE(tuner.settings().read_chunk_bytes == 32_mb);
+
+  // An idle pipeline with inputs waiting and memory to spare gets its reader back.
+  sample.memory_bytes = 64_mb;
+  sample.inputs_waiting = 4;
+  sample.readers_active = 1;
+  advance(10_mb);
+  REQUIRE(tuner.update(sample, decision));
+  REQUIRE(tuner.settings().max_readers == 2);
+  REQUIRE(tuner.decisions() == 6);
+}
+
+TEST_CASE("perf stats keep the autotune settings and read older blobs without them")
+{
+  perf_stats_t stats;
+  stats.autotuned = true;
+  stats.autotune_read_chunk_bytes = 128_mb;
+  stats.autotune_max_readers = 3;
+  stats.autotune_max_sorters = 5;
+  stats.autotune_max_compressors = 6;
+  stats.autotune_decisions = 11;
+  uint32_t size = 0;
+  auto blob = stats.serialize(size);
+  REQUIRE(size == perf_stats_t::serialized_size);
+  auto parsed = perf_stats_t::deserialize(blob.get(), size);
+  REQUIRE(parsed.valid);
+  REQUIRE(parsed.autotuned);
+  REQUIRE(parsed.autotune_read_chunk_bytes == 128_mb);
+  REQUIRE(parsed.autotune_max_readers == 3);
+  REQUIRE(parsed.autotune_max_sorters == 5);
+  REQUIRE(parsed.autotune_max_compressors == 6);
+  REQUIRE(parsed.autotune_decisions == 11);
+
+  auto older = perf_stats_t::deserialize(blob.get(), perf_stats_t::serialized_size_with_pool);
+  REQUIRE(older.valid);
+  REQUIRE(!older.autotuned);
+  REQUIRE(older.autotune_decisions == 0);
+}
+
+} // namespace
@@ -1,4 +1,5 @@
 #include <doctest/doctest.h>
+#include <attribute_precision.hpp>
 #include <attributes_configs.hpp>
 #include <compressor.hpp>
 #include <compressor_zstd.hpp>
@@ -950,6 +951,22 @@ TEST_CASE("compression_stats v4 serialize/deserialize with LOD fields")
   REQUIRE(deserialized.per_attribute[1].lod_compressed_bytes == 2000);
 }
 
+TEST_CASE("compression_stats v6 round trips the duplicate count")
+{
+  compression_stats_t stats;
+  stats.input_file_count = 2;
+  stats.duplicate_points_removed = 123456789012ull;
+  stats.accumulate("position", point_format_t{dew_type_u32, dew_components_3}, 1000, 500);
+
+  uint32_t serialized_size = 0;
+  auto serialized = stats.serialize(serialized_size);
+  auto deserialized = compression_stats_t::deserialize(serialized.get(), serialized_size);
+  REQUIRE(deserialized.input_file_count == 2);
+  REQUIRE(deserialized.duplicate_points_removed == 123456789012ull);
+  REQUIRE(deserialized.per_attribute.size() == 1);
+  REQUIRE(deserialized.per_attribute[0].compressed_bytes == 500);
+}
+
 // --- delta_encode_single / delta_decode_single ---
 
 TEST_CASE("delta_encode_single round trip u8")
@@ -1495,3 +1512,141 @@ TEST_CASE("attributes_configs serialize round trip (no heap overflow for small c
   REQUIRE(fmt_orig.type == fmt_restored.type);
   REQUIRE(fmt_orig.components == fmt_restored.components);
 }
+
+TEST_CASE("attribute precision: gps_time restores within tolerance from a smaller blob")
+{
+  // A flight line's gps_time: seconds of week, sub-microsecond noise in the stored doubles.
+  const uint32_t count = 50000;
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> jitter(0.0, 2e-5);
+  std::vector<double> values(count);
+  double t = 380000.25;
+  for (auto &v : values)
+  {
+    t += jitter(gen);
+    v = t;
+  }
+  const uint32_t size = count * 8;
+  point_format_t format(dew_type_r64, dew_components_1);
+
+  attribute_precision_t precision;
+  precision.enabled = true;
+  precision.tolerance = 1e-6;
+  for (auto method : {compression_method_t::zstd, compression_method_t::ans})
+  {
+    auto compressor = create_compressor(method);
+    auto lossless = compressor->compress(values.data(), size, format, count);
+    double max_error = 0;
+    auto packed = compress_with_precision(compressor.get(), values.data(), size, format, count, precision, max_error);
+    REQUIRE(packed.data);
+    REQUIRE(max_error >= 0.5e-6);
+    REQUIRE(max_error < precision.tolerance);
+    REQUIRE(packed.size < lossless.size);
+
+    auto restored = decompress_any(packed.data.get(), packed.size);
+    REQUIRE(restored.error.code == 0);
+    REQUIRE(restored.size == size);
+    for (uint32_t i = 0; i < count; i++)
+    {
+      double v;
+      memcpy(&v, restored.data.get() + i * 8, 8);
+      REQUIRE(std::abs(v - values[i]) <= max_error);
+    }
+
+    // Packing restored values again reproduces them: collapse and LOD rewrites add no error.
+    double again_error = 0;
+    auto again = compress_with_precision(compressor.get(), restored.data.get(), size, format, count, precision, again_error);
+    auto twice = decompress_any(again.data.get(), again.size);
+    REQUIRE(twice.error.code == 0);
+    REQUIRE(memcmp(twice.data.get(), restored.data.get(), size) == 0);
+  }
+
+  // Non-finite values keep the buffer lossless.
+  values[10] = std::numeric_limits<double>::quiet_NaN();
+  double max_error = 0;
+  REQUIRE(!compress_with_precision(nullptr, values.data(), size, format, count, precision, max_error).data);
+}
+
+TEST_CASE("attribute precision: the r32 error bound covers the restore's rounding to float")
+{
+  // At this magnitude an r32 ulp is 2^-7, far coarser than the tolerance, so the restored value's
+  // rounding back to float dominates the error and has to be in the bound.
+  const uint32_t count = 20000;
+  std::mt19937 gen(13);
+  std::uniform_real_distribution<float> spread(100000.0f, 100100.0f);
+  std::vector<float> values(count);
+  for (auto &v : values)
+    v = spread(gen);
+  const uint32_t size = count * 4;
+  point_format_t format(dew_type_r32, dew_components_1);
+
+  attribute_precision_t precision;
+  precision.enabled = true;
+  precision.tolerance = 1e-3;
+  double max_error = 0;
+  auto packed = compress_with_precision(nullptr, values.data(), size, format, count, precision, max_error);
+  REQUIRE(packed.data);
+  REQUIRE(max_error >= 0x1p-8);
+  auto restored = decompress_any(packed.data.get(), packed.size);
+  REQUIRE(restored.error.code == 0);
+  REQUIRE(restored.size == size);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    float v;
+    memcpy(&v, restored.data.get() + i * 4, 4);
+    REQUIRE(std::abs(double(v) - double(values[i])) <= max_error);
+  }
+}
+
+TEST_CASE("attribute precision: integer low bits are dropped exactly, or rounded within tolerance")
+{
+  // 12-bit intensity scaled into u16: the low four bits are always zero.
+  const uint32_t count = 20000;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<uint32_t> sensor(0, 4095);
+  std::vector<uint16_t> intensity(count);
+  for (auto &v : intensity)
+    v = uint16_t(sensor(gen) << 4);
+  point_format_t u16(dew_type_u16, dew_components_1);
+
+  attribute_precision_t exact;
+  exact.enabled = true;
+  double max_error = -1;
+  auto packed = compress_with_precision(nullptr, intensity.data(), count * 2, u16, count, exact, max_error);
+  REQUIRE(packed.data);
+  REQUIRE(max_error == 0);
+  auto restored = decompress_any(packed.data.get(), packed.size);
+  REQUIRE(restored.error.code == 0);
+  REQUIRE(memcmp(restored.data.get(), intensity.data(), count * 2) == 0);
+
+  // Signed values rounded down to multiples of 4 (tolerance 3), stored as offsets from the minimum.
+  std::vector<int16_t> signed_values(count);
+  std::uniform_int_distribution<int> wide(-32768, 32767);
+  for (auto &v : signed_values)
+    v = int16_t(wide(gen));
+  point_format_t i16(dew_type_i16, dew_components_1);
+  attribute_precision_t coarse;
+  coarse.enabled = true;
+  coarse.tolerance = 3;
+  auto compressor = create_compressor(compression_method_t::zstd);
+  packed = compress_with_precision(compressor.get(), signed_values.data(), count * 2, i16, count, coarse, max_error);
+  REQUIRE(packed.data);
+  REQUIRE(max_error == 3);
+  restored = decompress_any(packed.data.get(), packed.size);
+  REQUIRE(restored.error.code == 0);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    int16_t v;
+    memcpy(&v, restored.data.get() + i * 2, 2);
+    REQUIRE(v <= signed_values[i]);
+    REQUIRE(signed_values[i] - v <= 3);
+    REQUIRE(v % 4 == 0);
+  }
+
+  // The policy is looked up by attribute name.
+  attributes_configs_t configs;
+  configs.set_attribute_precision("intensity", coarse);
+  REQUIRE(configs.get_attribute_precision("intensity").enabled);
+  REQUIRE(configs.get_attribute_precision("intensity").tolerance == 3);
+  REQUIRE(!configs.get_attribute_precision("gps_time").enabled);
+}
@@ -0,0 +1,232 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+
+// `dew copy --journal`, driven through cmd_copy itself: a copy into a dir:// bucket is interrupted
+// part way, resumed from its journal, and must then hold exactly what an uninterrupted copy writes.
+//
+// The interruption is a source data object that goes missing: with one read in flight the copy reads
+// the blobs in order, so everything before the missing one is written and journaled before the read
+// error stops it. The copy source is itself a DEW2 bucket (one object per blob, blob i = object i) so
+// the test can pull objects out from under it.
+
+#include <doctest/doctest.h>
+
+#include <dew/converter/converter.h>
+#include <dew/core/default_attribute_names.h>
+
+#include "bucket_format.hpp"
+#include "commands.hpp"
+#include "tree.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t k_grid = 24; // 24^3 = 13824 points
+
+uint32_t g_emitted = 0;
+
+dew_converter_file_pre_init_info_t pre_init(const char *, size_t, dew_error_t **)
+{
+  dew_converter_file_pre_init_info_t info{};
+  info.approximate_point_count = k_grid * k_grid * k_grid;
+  info.found_point_count = 1;
+  info.approximate_point_size_bytes = 12;
+  return info;
+}
+
+void init(const char *, size_t, dew_converter_header_t *header, dew_attributes_t *attributes, void **, dew_error_t **)
+{
+  header->point_count = k_grid * k_grid * k_grid;
+  for (int i = 0; i < 3; i++)
+  {
+    header->offset[i] = 0.0;
+    header->scale[i] = 1.0;
+    header->min[i] = 0.0;
+    header->max[i] = double(k_grid - 1);
+  }
+  dew_attributes_add_attribute(attributes, DEW_ATTRIBUTE_XYZ, uint32_t(strlen(DEW_ATTRIBUTE_XYZ)), dew_type_i32, dew_components_3);
+  g_emitted = 0;
+}
+
+void convert_data(void *, const dew_converter_header_t *, const dew_attribute_t *, uint32_t, uint32_t max_points, dew_blob_t *buffers, uint32_t buffer_count, uint32_t *points_read, uint8_t *done, dew_error_t **)
+{
+  const uint32_t total = k_grid * k_grid * k_grid;
+  const uint32_t n = std::min(total - g_emitted, max_points);
+  REQUIRE(buffer_count >= 1);
+  auto *xyz = static_cast<int32_t *>(buffers[0].data);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    const uint32_t p = g_emitted + i;
+    xyz[i * 3 + 0] = int32_t(p % k_grid);
+    xyz[i * 3 + 1] = int32_t((p / k_grid) % k_grid);
+    xyz[i * 3 + 2] = int32_t(p / (k_grid * k_grid));
+  }
+  g_emitted += n;
+  *points_read = n;
+  *done = g_emitted >= total ? 1 : 0;
+}
+
+// Convert the grid into a packed file, subdivided finely enough to give the copy a few dozen data blobs.
+bool build_dataset(const char *path)
+{
+  std::remove(path);
+  dew_error_t *error = nullptr;
+  auto *converter = dew_converter_create(path, strlen(path), dew_open_file_semantics_truncate, &error);
+  if (!converter)
+  {
+    if (error)
+      dew_error_destroy(error);
+    return false;
+  }
+  dew_converter_file_convert_callbacks_t callbacks{};
+  callbacks.pre_init = pre_init;
+  callbacks.init = init;
+  callbacks.convert_data = convert_data;
+  dew_converter_set_file_converter_callbacks(converter, callbacks);
+  dew_converter_set_node_point_limit(converter, 900);
+  dew_converter_str_buffer name{"synthetic", 9};
+  dew_converter_add_data_file(converter, &name, 1);
+  dew_converter_wait_idle(converter);
+  const bool ok = dew_converter_status(converter) == dew_conversion_status_completed;
+  dew_converter_destroy(converter);
+  return ok;
+}
+
+// cmd_copy as `dew copy <args...>` would call it.
+int run_copy(std::vector<std::string> args)
+{
+  args.insert(args.begin(), "copy");
+  std::vector<char *> argv;
+  for (auto &arg : args)
+    argv.push_back(arg.data());
+  return cmd_copy(int(argv.size()), argv.data());
+}
+
+std::vector<uint8_t> read_file(const std::filesystem::path &path)
+{
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Every object under data/ -- blobs, trees, registry, directory and metadata -- by name. The band and root
+// manifests carry the copy's freshly minted uuid, so only data/ is comparable between two copies.
+std::map<std::string, std::vector<uint8_t>> data_objects(const std::string &bucket_dir)
+{
+  std::map<std::string, std::vector<uint8_t>> objects;
+  for (auto &entry : std::filesystem::directory_iterator(std::filesystem::path(bucket_dir) / "data"))
+    if (entry.is_regular_file())
+      objects[entry.path().filename().string()] = read_file(entry.path());
+  return objects;
+}
+
+// A copy puts the data blobs first, as objects 0..n-1, then the trees: the lowest object id the bucket's
+// registry holds a tree at is the number of data blobs.
+uint32_t first_tree_object(const std::string &bucket_dir)
+{
+  auto manifest = read_file(std::filesystem::path(bucket_dir) / dew::core::bucket_root_manifest_name());
+  dew::core::root_manifest_t root;
+  REQUIRE(dew::core::deserialize_root_manifest(manifest.data(), uint32_t(manifest.size()), root).code == 0);
+  auto registry_bytes = read_file(std::filesystem::path(bucket_dir) / dew::core::bucket_data_object_name(root.tree_registry.file_id));
+  REQUIRE(registry_bytes.size() == root.tree_registry.size);
+  auto data = std::make_unique<uint8_t[]>(registry_bytes.size());
+  memcpy(data.get(), registry_bytes.data(), registry_bytes.size());
+  dew::core::tree_registry_t registry;
+  REQUIRE(dew::core::tree_registry_deserialize(data, uint32_t(registry_bytes.size()), registry).code == 0);
+  uint32_t first = root.tree_registry.file_id;
+  for (const auto &location : registry.locations)
+    if (location.size != 0)
+      first = std::min(first, location.file_id);
+  return first;
+}
+
+uint32_t count_lines(const std::string &path)
+{
+  uint32_t lines = 0;
+  for (auto c : read_file(path))
+    lines += c == '\n' ? 1 : 0;
+  return lines;
+}
+
+} // namespace
+
+TEST_CASE("dew copy --journal resumes an interrupted copy and matches an uninterrupted one")
+{
+  const char *packed_path = "test_copy_journal.dew";
+  const std::string source_dir = "test_copy_journal_source";
+  const std::string reference_dir = "test_copy_journal_reference";
+  const std::string resumed_dir = "test_copy_journal_resumed";
+  const std::string other_dir = "test_copy_journal_other";
+  const std::string parked_dir = "test_copy_journal_parked";
+  const std::string journal_path = "test_copy_journal.journal";
+  for (const auto &dir : {source_dir, reference_dir, resumed_dir, other_dir, parked_dir})
+    std::filesystem::remove_all(dir);
+  std::remove(journal_path.c_str());
+
+  REQUIRE(build_dataset(packed_path));
+  const std::string source = "dir://" + source_dir;
+  REQUIRE(run_copy({"-q", packed_path, source}) == 0);
+  REQUIRE(run_copy({"-q", source, "dir://" + reference_dir}) == 0);
+  const auto reference = data_objects(reference_dir);
+
+  // The source's data blobs are its objects 0..n-1 and its trees follow, so the lowest tree object is n.
+  const uint32_t blob_count = first_tree_object(source_dir);
+  REQUIRE(blob_count >= 4);
+  REQUIRE(reference.size() > blob_count);
+
+  // Interrupted run: blob `missing` cannot be read, so the copy stops after journaling every blob before it.
+  const uint32_t missing = blob_count / 2;
+  const auto missing_path = std::filesystem::path(source_dir) / dew::core::bucket_data_object_name(missing);
+  std::filesystem::create_directories(std::filesystem::path(parked_dir) / "data");
+  std::filesystem::rename(missing_path, std::filesystem::path(parked_dir) / dew::core::bucket_data_object_name(missing));
+  const std::string resumed = "dir://" + resumed_dir;
+  REQUIRE(run_copy({"-q", "--reads", "1", "--writes", "1", "--journal", journal_path, source, resumed}) != 0);
+  REQUIRE(std::filesystem::exists(journal_path));
+  CHECK(count_lines(journal_path) == missing + 1); // identity line + one per written blob
+  CHECK(!std::filesystem::exists(std::filesystem::path(resumed_dir) / dew::core::bucket_root_manifest_name()));
+  const auto journal_after_interrupt = read_file(journal_path);
+
+  // A journal only resumes the copy it was written for: another destination is refused, untouched.
+  CHECK(run_copy({"-q", "--journal", journal_path, source, "dir://" + other_dir}) != 0);
+  CHECK(read_file(journal_path) == journal_after_interrupt);
+  CHECK(!std::filesystem::exists(std::filesystem::path(other_dir) / dew::core::bucket_root_manifest_name()));
+
+  // Resume. The missing blob is back, and the blobs the journal lists are taken away: the resumed run
+  // can only succeed by skipping them.
+  std::filesystem::rename(std::filesystem::path(parked_dir) / dew::core::bucket_data_object_name(missing), missing_path);
+  for (uint32_t i = 0; i < missing; i++)
+    std::filesystem::rename(std::filesystem::path(source_dir) / dew::core::bucket_data_object_name(i), std::filesystem::path(parked_dir) / dew::core::bucket_data_object_name(i));
+  REQUIRE(run_copy({"-q", "--journal", journal_path, source, resumed}) == 0);
+  CHECK(!std::filesystem::exists(journal_path)); // removed once the copy committed
+  CHECK(std::filesystem::exists(std::filesystem::path(resumed_dir) / dew::core::bucket_root_manifest_name()));
+  CHECK(data_objects(resumed_dir) == reference);
+
+  std::remove(packed_path);
+  for (const auto &dir : {source_dir, reference_dir, resumed_dir, other_dir, parked_dir})
+    std::filesystem::remove_all(dir);
+}
@@ -19,11 +19,16 @@
 
 #include "data_source.hpp" // render::frame_camera_cpp_t
 #include "memory_budget.hpp"
+#include "occlusion_culler.hpp"
 #include "render_pipeline.hpp"
 #include "renderer_callbacks.hpp"
+#include "resource_arbiter.hpp"
 
 #include <vio/thread_pool.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace
 {
 using namespace dew;
@@ -44,6 +49,7 @@ TEST_CASE("derive_budgets(1GB) reproduces the historical sub-budget defaults exa
   REQUIRE(d.decoded_backlog_cap == 256_mb);
   REQUIRE(d.cpu_resident_budget == 256_mb);
   REQUIRE(d.io_clamp == 64);
+  REQUIRE(d.buffer_pool_bytes == 256_mb);
 }
 
 TEST_CASE("derive_budgets mobile target and clamps")
@@ -81,6 +87,73 @@ TEST_CASE("derive_budgets mobile target and clamps")
   }
 }
 
+TEST_CASE("point buffer pool size classes and recycling")
+{
+  // Classes: nothing at or below 64KB, then quarter steps with at most 25% slack.
+  REQUIRE(buffer_pool_t::class_for(64 * 1024) == 0);
+  REQUIRE(buffer_pool_t::class_for(64 * 1024 + 1) == 1);
+  REQUIRE(buffer_pool_t::class_bytes(1) == 80 * 1024);
+  for (uint64_t size : {uint64_t(100000), uint64_t(1) << 20, (uint64_t(1) << 20) + 1, uint64_t(24) * 8000000, uint64_t(1) << 30})
+  {
+    const auto size_class = buffer_pool_t::class_for(size);
+    REQUIRE(size_class != 0);
+    REQUIRE(buffer_pool_t::class_bytes(size_class) >= size);
+    REQUIRE(buffer_pool_t::class_bytes(size_class) * 4 <= size * 5 + 4);
+  }
+  REQUIRE(buffer_pool_t::class_for((uint64_t(1) << 30) + 1) == 0);
+
+  auto &pool = point_buffer_pool();
+  pool.set_retain_limit(64_mb);
+  uint8_t *first = nullptr;
+  {
+    auto buffer = pool.acquire(1000000);
+    first = buffer.get();
+  }
+  const auto before = pool.stats();
+  REQUIRE(before.retained_bytes >= 1000000);
+  {
+    auto again = pool.acquire(1000000 - 1000); // same class: the freed buffer comes back
+    REQUIRE(again.get() == first);
+    // Through the storage write's shared_ptr the buffer still finds its way home.
+    std::shared_ptr<uint8_t[]> shared = std::move(again);
+  }
+  const auto after = pool.stats();
+  REQUIRE(after.hits == before.hits + 1);
+  REQUIRE(after.retained_bytes == before.retained_bytes);
+
+  // A zero cap frees everything retained and every later release.
+  pool.set_retain_limit(0);
+  REQUIRE(pool.stats().retained_bytes == 0);
+  pool.acquire(1000000).reset();
+  REQUIRE(pool.stats().retained_bytes == 0);
+  pool.set_retain_limit(derive_budgets(1024_mb).buffer_pool_bytes);
+}
+
+TEST_CASE("point buffer pool keeps per-node free lists")
+{
+  auto &pool = point_buffer_pool();
+  pool.set_retain_limit(64_mb);
+  uint8_t *node1_buffer = nullptr;
+  buffer_pool_t::set_thread_node(1);
+  {
+    auto buffer = pool.acquire(2000000);
+    REQUIRE(buffer.get_deleter().node == 1);
+    node1_buffer = buffer.get();
+  }
+  buffer_pool_t::set_thread_node(0);
+  {
+    auto buffer = pool.acquire(2000000); // node 0 never gets node 1's buffer
+    REQUIRE(buffer.get() != node1_buffer);
+    buffer_pool_t::set_thread_node(1);
+    auto again = pool.acquire(2000000);
+    REQUIRE(again.get() == node1_buffer);
+    buffer_pool_t::set_thread_node(0);
+  }
+  pool.set_retain_limit(0);
+  REQUIRE(pool.stats().retained_bytes == 0);
+  pool.set_retain_limit(derive_budgets(1024_mb).buffer_pool_bytes);
+}
+
 TEST_CASE("compute_brake_level boundaries")
 {
   REQUIRE(compute_brake_level(0, 0) == brake_level_t::none);           // native: no probe
@@ -283,4 +356,425 @@ TEST_CASE("deferred (pending-destroy) bytes pre-charge the backlog cap")
   REQUIRE(stats.io_denied_backlog > 0);
 }
 
+// A loader whose read-aheads land as soon as they are issued; real loads never complete (as above).
+struct prefetching_loader_t : stub_node_loader_t
+{
+  int prefetches = 0;
+  std::vector<render::load_handle_t> prefetch_handles;
+  render::load_handle_t request_prefetch(const void *, uint32_t) override
+  {
+    prefetches++;
+    prefetch_handles.push_back(next_handle);
+    return next_handle++;
+  }
+  bool is_ready(render::load_handle_t handle) override
+  {
+    return std::find(prefetch_handles.begin(), prefetch_handles.end(), handle) != prefetch_handles.end();
+  }
+};
+
+TEST_CASE("prefetch only takes the IO slots the real loads leave, and counts a later load as a hit")
+{
+  render::callback_manager_t callbacks(nullptr);
+  prefetching_loader_t loader;
+  vio::thread_pool_t pool(1);
+  auto render_list = make_render_list(2, 1'000);
+
+  io_limits_t limits;
+  limits.max_concurrent_io = 4;
+  limits.max_new_io_per_frame = 4;
+  limits.decoded_backlog_cap = 512_mb;
+  limits.gpu_memory_budget = 512_mb;
+
+  prefetch_state_t prefetch;
+  render::frame_camera_cpp_t camera = {};
+  auto stats = process_io_and_upload(render_list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool,
+                                     camera, limits, 0.0, 1.0, false, 0, nullptr, &prefetch);
+  REQUIRE(stats.io_scheduled == 2);
+
+  // Five off-screen candidates along +x; the two real loads leave two slots.
+  std::vector<tree_walker_data_t> candidates;
+  for (int i = 0; i < 5; i++)
+  {
+    auto w = make_walker_data(1'000, false);
+    w.locations[0].offset = uint64_t(1000 + i) * 1'000'000;
+    w.tight_aabb.min = {double(10 + i), 0.0, 0.0};
+    w.tight_aabb.max = w.tight_aabb.min + glm::dvec3(1.0);
+    candidates.push_back(w);
+  }
+  const int issued = schedule_prefetch(prefetch, candidates, glm::dvec3(20.0, 0.0, 0.0), tree_config_t(), &loader, limits, stats);
+  REQUIRE(issued == 2);
+  REQUIRE(loader.prefetches == 2);
+  REQUIRE(stats.io_scheduled + stats.prefetch_scheduled == limits.max_new_io_per_frame);
+  // Closest to the PREDICTED eye first: the two largest offsets.
+  REQUIRE(prefetch.warmed.count(cache_key_t{0, candidates[4].locations[0].offset}) == 1);
+  REQUIRE(prefetch.warmed.count(cache_key_t{0, candidates[3].locations[0].offset}) == 1);
+
+  // A second pass in the same frame adds nothing: the slots are gone.
+  REQUIRE(schedule_prefetch(prefetch, candidates, glm::dvec3(20.0, 0.0, 0.0), tree_config_t(), &loader, limits, stats) == 0);
+
+  // The camera arrives: the warmed node joins the render list, its read-ahead has landed, so the real load is a hit.
+  auto node = std::make_unique<render_node_t>();
+  node->walker_data = candidates[4];
+  render_list.push_back(std::move(node));
+  auto stats2 = process_io_and_upload(render_list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool,
+                                      camera, limits, 0.0, 1.0, false, 0, nullptr, &prefetch);
+  REQUIRE(stats2.prefetch_hits == 1);
+  REQUIRE(prefetch.hits_total == 1);
+  REQUIRE(prefetch.hit_rate() == doctest::Approx(0.5));
+  cancel_prefetch(prefetch, &loader);
+  REQUIRE(prefetch.in_flight.empty());
+}
+
+// A loader whose read-aheads never land.
+struct stalled_prefetch_loader_t : stub_node_loader_t
+{
+  render::load_handle_t request_prefetch(const void *, uint32_t) override
+  {
+    return next_handle++;
+  }
+};
+
+TEST_CASE("read-aheads in flight hold IO slots, and a load waits for its own read-ahead instead of reading twice")
+{
+  render::callback_manager_t callbacks(nullptr);
+  stalled_prefetch_loader_t loader;
+  vio::thread_pool_t pool(1);
+
+  io_limits_t limits;
+  limits.max_concurrent_io = 4;
+  limits.max_new_io_per_frame = 8;
+  limits.decoded_backlog_cap = 512_mb;
+  limits.gpu_memory_budget = 512_mb;
+
+  std::vector<tree_walker_data_t> candidates;
+  for (int i = 0; i < 3; i++)
+  {
+    auto w = make_walker_data(1'000, false);
+    w.locations[0].offset = uint64_t(1000 + i) * 1'000'000;
+    w.tight_aabb.min = {double(10 + i), 0.0, 0.0};
+    w.tight_aabb.max = w.tight_aabb.min + glm::dvec3(1.0);
+    candidates.push_back(w);
+  }
+  prefetch_state_t prefetch;
+  io_upload_stats_t stats;
+  REQUIRE(schedule_prefetch(prefetch, candidates, glm::dvec3(10.0, 0.0, 0.0), tree_config_t(), &loader, limits, stats) == 3);
+
+  // Three slots are the read-aheads', so of three on-screen nodes only one loads.
+  render::frame_camera_cpp_t camera = {};
+  auto render_list = make_render_list(3, 1'000);
+  auto stats2 = process_io_and_upload(render_list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool,
+                                      camera, limits, 0.0, 1.0, false, 0, nullptr, &prefetch);
+  REQUIRE(stats2.prefetch_in_flight == 3);
+  REQUIRE(stats2.io_scheduled == 1);
+  REQUIRE(loader.requests == 1);
+
+  // With the slots to spare, a node whose read-ahead is still in flight is not read again; a plain one is.
+  limits.max_concurrent_io = 16;
+  render_list_t arrived;
+  auto warmed = std::make_unique<render_node_t>();
+  warmed->walker_data = candidates[0];
+  arrived.push_back(std::move(warmed));
+  auto plain = std::make_unique<render_node_t>();
+  plain->walker_data = make_walker_data(1'000, true);
+  plain->walker_data.tight_aabb.min = {50.0, 0.0, 0.0};
+  plain->walker_data.tight_aabb.max = {50.5, 0.5, 0.5};
+  arrived.push_back(std::move(plain));
+  auto stats3 = process_io_and_upload(arrived, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool,
+                                      camera, limits, 0.0, 1.0, false, 0, nullptr, &prefetch);
+  REQUIRE(stats3.io_scheduled == 1);
+  REQUIRE(loader.requests == 2);
+  REQUIRE(arrived[0]->io_state == render_node_io_state::none);
+  REQUIRE(arrived[1]->io_state == render_node_io_state::loading);
+  REQUIRE(prefetch.warmed.count(cache_key_t{0, candidates[0].locations[0].offset}) == 1);
+  cancel_prefetch(prefetch, &loader);
+}
+
+// Eye at the origin looking down +y, z up, 16:9 -- the pyramid is 128x72.
+static render::frame_camera_cpp_t make_forward_camera()
+{
+  render::frame_camera_cpp_t camera;
+  camera.view = glm::lookAt(glm::dvec3(0.0), glm::dvec3(0.0, 1.0, 0.0), glm::dvec3(0.0, 0.0, 1.0));
+  camera.projection = glm::perspective(glm::radians(60.0), 16.0 / 9.0, 0.1, 1000.0);
+  camera.view_projection = camera.projection * camera.view;
+  camera.inverse_view = glm::inverse(camera.view);
+  camera.inverse_projection = glm::inverse(camera.projection);
+  camera.inverse_view_projection = glm::inverse(camera.view_projection);
+  return camera;
+}
+
+// An uploaded node standing in for a facade 5 units ahead: x in [-4,4], z in [-2,2], its occluder samples a
+// regular 8x4 grid (one per unit cell, as an LOD prefix would be).
+static std::unique_ptr<render_node_t> make_wall_node()
+{
+  auto wall = std::make_unique<render_node_t>();
+  wall->walker_data = make_walker_data(32, false);
+  wall->walker_data.tight_aabb.min = {-4.0, 5.0, -2.0};
+  wall->walker_data.tight_aabb.max = {4.0, 5.0, 2.0};
+  std::vector<float> vertices;
+  for (int z = 0; z < 4; z++)
+    for (int x = 0; x < 8; x++)
+      vertices.insert(vertices.end(), {-3.5f + float(x), 5.0f, -1.5f + float(z)});
+  capture_occluder_samples(*wall, vertices.data(), uint32_t(vertices.size() * sizeof(float)), 32, true);
+  wall->gpu_state = render_node_gpu_state::uploaded;
+  return wall;
+}
+
+static node_aabb_t make_box(glm::dvec3 min, glm::dvec3 max)
+{
+  node_aabb_t box;
+  box.min = min;
+  box.max = max;
+  return box;
+}
+
+TEST_CASE("occlusion pyramid: a box behind splatted occluders is occluded, one in front or beside is not")
+{
+  auto wall = make_wall_node();
+  REQUIRE(wall->occluder_samples.size() == 32);
+  REQUIRE(wall->occluder_radius == doctest::Approx(0.75)); // 0.75 * sqrt(8 * 4 / 32)
+
+  occlusion_pyramid_t pyramid;
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-1.0, 20.0, -1.0}, {1.0, 22.0, 1.0}))); // nothing built yet
+  pyramid.begin(make_forward_camera(), 1920, 1080);
+  REQUIRE(pyramid.width() == 128);
+  REQUIRE(pyramid.height() == 72);
+  pyramid.splat_node(*wall, glm::dvec3(0.0));
+  pyramid.build();
+  REQUIRE(pyramid.valid());
+  REQUIRE(pyramid.coverage() > 0.2);
+
+  REQUIRE(pyramid.is_occluded(make_box({-1.0, 20.0, -1.0}, {1.0, 22.0, 1.0})));          // behind the wall
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-0.5, 3.0, -0.5}, {0.5, 4.0, 0.5})));       // in front of it
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-1.0, 5.0, -1.0}, {1.0, 6.0, 1.0})));       // touching it: within the bias
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-1.0, 20.0, 30.0}, {1.0, 22.0, 32.0})));    // above it
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-20.0, 20.0, -1.0}, {20.0, 22.0, 1.0})));   // wider than it
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-1.0, -1.0, -1.0}, {1.0, 30.0, 1.0})));     // reaches the eye
+}
+
+TEST_CASE("occlusion pyramid from a depth readback")
+{
+  occlusion_pyramid_t pyramid;
+  const auto camera = make_forward_camera();
+  pyramid.begin(camera, 1920, 1080);
+  // The consumer's depth: a full-screen surface at view depth 10, as window depth.
+  const glm::dvec4 clip = camera.projection * glm::dvec4(0.0, 0.0, -10.0, 1.0);
+  const float window_depth = float(clip.z / clip.w * 0.5 + 0.5);
+  std::fill(pyramid.level0(), pyramid.level0() + pyramid.width() * pyramid.height(), window_depth);
+  pyramid.convert_window_depth();
+  pyramid.build();
+  REQUIRE(pyramid.coverage() == doctest::Approx(1.0));
+  REQUIRE(pyramid.is_occluded(make_box({-1.0, 20.0, -1.0}, {1.0, 22.0, 1.0})));
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-1.0, 9.0, -1.0}, {1.0, 10.0, 1.0})));
+
+  // A cleared (far-plane) readback occludes nothing.
+  pyramid.begin(camera, 1920, 1080);
+  std::fill(pyramid.level0(), pyramid.level0() + pyramid.width() * pyramid.height(), 1.0f);
+  pyramid.convert_window_depth();
+  pyramid.build();
+  REQUIRE(pyramid.coverage() == 0.0);
+  REQUIRE_FALSE(pyramid.is_occluded(make_box({-1.0, 20.0, -1.0}, {1.0, 22.0, 1.0})));
+}
+
+TEST_CASE("occluded nodes are loaded last (deprioritize) or not at all (skip)")
+{
+  render::callback_manager_t callbacks(nullptr);
+  vio::thread_pool_t pool(1);
+  const auto camera = make_forward_camera();
+  auto wall = make_wall_node();
+  occlusion_pyramid_t pyramid;
+  pyramid.begin(camera, 1920, 1080);
+  pyramid.splat_node(*wall, glm::dvec3(0.0));
+  pyramid.build();
+
+  // A near node behind the wall, and a farther one well clear of it.
+  auto make_list = [] {
+    render_list_t list;
+    auto hidden = std::make_unique<render_node_t>();
+    hidden->walker_data = make_walker_data(1'000, false);
+    hidden->walker_data.tight_aabb = make_box({-1.0, 20.0, -1.0}, {1.0, 22.0, 1.0});
+    list.push_back(std::move(hidden));
+    auto clear = std::make_unique<render_node_t>();
+    clear->walker_data = make_walker_data(1'000, false);
+    clear->walker_data.tight_aabb = make_box({-1.0, 100.0, 60.0}, {1.0, 102.0, 62.0});
+    list.push_back(std::move(clear));
+    return list;
+  };
+
+  io_limits_t limits;
+  limits.max_concurrent_io = 64;
+  limits.max_new_io_per_frame = 1;
+  limits.decoded_backlog_cap = 512_mb;
+  limits.gpu_memory_budget = 512_mb;
+
+  {
+    stub_node_loader_t loader;
+    auto list = make_list();
+    auto stats = process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr, nullptr,
+                                       &pyramid, occlusion_mode_t::deprioritize);
+    REQUIRE(stats.occlusion_tested == 2);
+    REQUIRE(stats.occlusion_occluded == 1);
+    // Closest-first would pick the hidden node; the one slot goes to the visible one instead.
+    REQUIRE(list[0]->io_state == render_node_io_state::none);
+    REQUIRE(list[1]->io_state == render_node_io_state::loading);
+    // With room to spare the hidden node still loads, after it.
+    limits.max_new_io_per_frame = 16;
+    process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr, nullptr, &pyramid,
+                          occlusion_mode_t::deprioritize);
+    REQUIRE(list[0]->io_state == render_node_io_state::loading);
+  }
+  {
+    stub_node_loader_t loader;
+    auto list = make_list();
+    auto stats = process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr, nullptr,
+                                       &pyramid, occlusion_mode_t::skip);
+    REQUIRE(stats.occlusion_occluded == 1);
+    REQUIRE(stats.io_scheduled == 1);
+    REQUIRE(loader.requests == 1);
+    REQUIRE(list[0]->io_state == render_node_io_state::none);
+  }
+  {
+    // Off: the pyramid is ignored and nothing is tested.
+    stub_node_loader_t loader;
+    auto list = make_list();
+    auto stats = process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr, nullptr,
+                                       &pyramid, occlusion_mode_t::off);
+    REQUIRE(stats.occlusion_tested == 0);
+    REQUIRE(loader.requests == 2);
+  }
+}
+
+// The arbiter only compares source pointers; it never dereferences them.
+static const dew_converter_data_source_t *fake_source(uintptr_t id)
+{
+  return reinterpret_cast<const dew_converter_data_source_t *>(id);
+}
+
+TEST_CASE("resource arbiter: each source gets the global caps minus what the others hold")
+{
+  resource_arbiter_t arbiter;
+  arbiter.set_memory_budget(1024_mb); // decoded backlog 256MB, io clamp 64
+  arbiter.set_gpu_memory_budget(512_mb);
+  arbiter.set_max_in_flight_io(64);
+  const auto *a = fake_source(1);
+  const auto *b = fake_source(2);
+  arbiter.add_source(a);
+  arbiter.add_source(b);
+
+  arbiter_report_t ra;
+  ra.backlog_bytes = 100_mb;
+  ra.gpu_bytes = 300_mb;
+  ra.io_in_flight = 40;
+  arbiter.report(a, std::move(ra));
+
+  const auto gb = arbiter.grant(b);
+  REQUIRE(gb.decoded_backlog_cap == 156_mb);
+  REQUIRE(gb.gpu_memory_budget == 212_mb);
+  REQUIRE(gb.max_concurrent_io == 24);
+  // a's own holdings are not subtracted from a's grant.
+  const auto ga = arbiter.grant(a);
+  REQUIRE(ga.decoded_backlog_cap == 256_mb);
+  REQUIRE(ga.max_concurrent_io == 64);
+  // Caches and the resident budget are split evenly.
+  REQUIRE(ga.share.read_cache_bytes == 128_mb);
+  REQUIRE(ga.share.cpu_resident_budget == 128_mb);
+
+  // Over-committed: the grant saturates at zero instead of wrapping.
+  arbiter_report_t big;
+  big.gpu_bytes = 600_mb;
+  arbiter.report(a, std::move(big));
+  REQUIRE(arbiter.grant(b).gpu_memory_budget == 0);
+
+  // A source that leaves stops counting, and the share goes back to the whole.
+  arbiter.remove_source(a);
+  const auto alone = arbiter.grant(b);
+  REQUIRE(alone.gpu_memory_budget == 512_mb);
+  REQUIRE(alone.share.read_cache_bytes == 256_mb);
+  REQUIRE(arbiter.stats().sources == 1);
+}
+
+TEST_CASE("resource arbiter: the screen-error floor admits the coarsest waiting nodes across sources")
+{
+  resource_arbiter_t arbiter;
+  arbiter.set_max_in_flight_io(4);
+  const auto *a = fake_source(1);
+  const auto *b = fake_source(2);
+  arbiter.add_source(a);
+  arbiter.add_source(b);
+
+  arbiter_report_t ra;
+  ra.io_in_flight = 1;
+  ra.demand = {0.01, 0.02, 0.03};
+  arbiter.report(a, std::move(ra));
+  arbiter_report_t rb;
+  rb.demand = {0.5, 0.4, 0.005};
+  arbiter.report(b, std::move(rb));
+  // 3 free slots for 6 waiting nodes: b's two and a's coarsest.
+  REQUIRE(arbiter.grant(a).min_screen_error == doctest::Approx(0.03));
+
+  // Room for everything: no floor.
+  arbiter.set_max_in_flight_io(64);
+  REQUIRE(arbiter.grant(a).min_screen_error == 0.0);
+}
+
+TEST_CASE("screen-error ranking loads the coarsest node first and honours the arbiter floor")
+{
+  render::callback_manager_t callbacks(nullptr);
+  vio::thread_pool_t pool(1);
+  render::frame_camera_cpp_t camera = {};
+  camera.projection = glm::perspective(glm::radians(60.0), 1.0, 0.1, 1000.0);
+
+  // A small cell close by (fine detail) and a big cell far away that is still coarser on screen.
+  auto make_list = [] {
+    render_list_t list;
+    auto fine = std::make_unique<render_node_t>();
+    fine->walker_data = make_walker_data(1'000, false);
+    fine->walker_data.aabb = make_box({10.0, 0.0, 0.0}, {11.0, 1.0, 1.0});
+    fine->walker_data.tight_aabb = fine->walker_data.aabb;
+    list.push_back(std::move(fine));
+    auto coarse = std::make_unique<render_node_t>();
+    coarse->walker_data = make_walker_data(1'000, false);
+    coarse->walker_data.aabb = make_box({50.0, 0.0, 0.0}, {90.0, 40.0, 40.0});
+    coarse->walker_data.tight_aabb = coarse->walker_data.aabb;
+    list.push_back(std::move(coarse));
+    return list;
+  };
+  REQUIRE(node_screen_error(make_list()[1]->walker_data, 50.0, camera.projection) > node_screen_error(make_list()[0]->walker_data, 10.0, camera.projection));
+
+  io_limits_t limits;
+  limits.max_concurrent_io = 64;
+  limits.max_new_io_per_frame = 1;
+  limits.decoded_backlog_cap = 512_mb;
+  limits.gpu_memory_budget = 512_mb;
+  {
+    // Distance order (no arbiter): the near, fine node.
+    stub_node_loader_t loader;
+    auto list = make_list();
+    process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr);
+    REQUIRE(list[0]->io_state == render_node_io_state::loading);
+  }
+  limits.rank_by_screen_error = true;
+  {
+    stub_node_loader_t loader;
+    auto list = make_list();
+    auto stats = process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr);
+    REQUIRE(list[1]->io_state == render_node_io_state::loading);
+    REQUIRE(list[0]->io_state == render_node_io_state::none);
+    // The one left behind is the bid for next frame.
+    REQUIRE(stats.screen_error_demand.size() == 1);
+    REQUIRE(stats.screen_error_demand[0] == doctest::Approx(node_screen_error(list[0]->walker_data, list[0]->cached_distance, camera.projection)));
+  }
+  {
+    // A floor above the fine node's error: only the coarse one may load, however many slots are free.
+    stub_node_loader_t loader;
+    auto list = make_list();
+    limits.max_new_io_per_frame = 16;
+    limits.min_screen_error = node_screen_error(list[0]->walker_data, 10.0, camera.projection) * 1.5;
+    auto stats = process_io_and_upload(list, glm::dvec3(0.0), tree_config_t(), callbacks, &loader, pool, camera, limits, 0.0, 1.0, false, 0, nullptr);
+    REQUIRE(loader.requests == 1);
+    REQUIRE(stats.io_denied_arbiter == 1);
+    REQUIRE(list[0]->io_state == render_node_io_state::none);
+  }
+}
+
 } // namespace
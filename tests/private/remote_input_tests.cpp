@@ -0,0 +1,113 @@
+#include <doctest/doctest.h>
+
+#include <loop_blocking.hpp>
+#include <remote_input.hpp>
+
+#include <vio/event_loop.h>
+#include <vio/objstore/create_object_store.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dew::converter;
+using namespace dew::core;
+
+namespace
+{
+// Put `bytes` at dir://<bucket_dir>/<name> through the same object store the input will be read from.
+void put_object(const std::string &bucket_dir, const std::string &name, const std::vector<uint8_t> &bytes)
+{
+  vio::thread_with_event_loop_t loop_thread;
+  auto io = vio::objstore::create_io_manager("dir://" + bucket_dir, std::string_view(), loop_thread.event_loop());
+  REQUIRE(io.has_value());
+  auto *store = io.value().get();
+  auto error = run_on_loop_blocking(loop_thread.event_loop(), [store, &name, &bytes]() -> vio::task_t<dew_error_t> {
+    return [](vio::objstore::io_manager_t *store, std::string name, std::vector<uint8_t> bytes) -> vio::task_t<dew_error_t> {
+      auto data = std::make_shared<uint8_t[]>(bytes.size());
+      memcpy(data.get(), bytes.data(), bytes.size());
+      auto r = co_await store->write_object(name, std::move(data), uint32_t(bytes.size()));
+      if (!r.has_value())
+        co_return dew_error_t{1, r.error().msg};
+      co_return dew_error_t{};
+    }(store, name, bytes);
+  });
+  REQUIRE(error.code == 0);
+  loop_thread.stop_and_join();
+}
+} // namespace
+
+TEST_CASE("remote input names")
+{
+  REQUIRE(is_remote_input("s3://bucket/tile.laz"));
+  REQUIRE(is_remote_input("AZ://container/tile.las"));
+  REQUIRE(is_remote_input("dir://bucket/tile.las"));
+  REQUIRE(!is_remote_input("/data/tile.laz"));
+  REQUIRE(!is_remote_input("file:///data/tile.laz"));
+  REQUIRE(!is_remote_input("C:\\data\\tile.laz"));
+}
+
+TEST_CASE("remote input streams windows with read-ahead and seeks")
+{
+  const std::string bucket_dir = "test_remote_input_bucket";
+  std::filesystem::remove_all(bucket_dir);
+  std::vector<uint8_t> bytes(300 * 1024 + 17);
+  for (size_t i = 0; i < bytes.size(); i++)
+    bytes[i] = uint8_t((i * 31) ^ (i >> 8));
+  put_object(bucket_dir, "input.bin", bytes);
+
+  remote_input_options_t options;
+  options.window_bytes = 64 * 1024; // several windows over the object
+  options.read_ahead = 2;
+  dew_error_t error;
+  auto input = remote_input_t::open("dir://" + bucket_dir + "/input.bin", options, error);
+  REQUIRE(error.code == 0);
+  REQUIRE(input);
+  REQUIRE(input->size() == bytes.size());
+
+  // Header-style probe outside the stream.
+  uint8_t header[32];
+  REQUIRE(input->read_range(0, header, sizeof(header)).code == 0);
+  REQUIRE(memcmp(header, bytes.data(), sizeof(header)) == 0);
+  REQUIRE(input->read_range(bytes.size() - 4, header, 8).code != 0);
+
+  // Sequential read across window boundaries, in odd-sized pieces.
+  auto &stream = input->stream();
+  std::vector<uint8_t> read_back(bytes.size());
+  size_t at = 0;
+  while (at < bytes.size())
+  {
+    auto piece = std::min<size_t>(10007, bytes.size() - at);
+    stream.read(reinterpret_cast<char *>(read_back.data() + at), std::streamsize(piece));
+    REQUIRE(size_t(stream.gcount()) == piece);
+    at += piece;
+  }
+  REQUIRE(read_back == bytes);
+  REQUIRE(stream.get() == std::char_traits<char>::eof());
+
+  // The LAZ open pattern: jump to the end, read, come back; then skip forward inside the read-ahead.
+  stream.clear();
+  stream.seekg(-100, std::ios_base::end);
+  REQUIRE(uint64_t(stream.tellg()) == bytes.size() - 100);
+  uint8_t tail[100];
+  stream.read(reinterpret_cast<char *>(tail), sizeof(tail));
+  REQUIRE(memcmp(tail, bytes.data() + bytes.size() - 100, sizeof(tail)) == 0);
+  stream.clear();
+  stream.seekg(227);
+  uint8_t middle[64];
+  stream.read(reinterpret_cast<char *>(middle), sizeof(middle));
+  REQUIRE(memcmp(middle, bytes.data() + 227, sizeof(middle)) == 0);
+  stream.seekg(100 * 1024 + 3);
+  stream.read(reinterpret_cast<char *>(middle), sizeof(middle));
+  REQUIRE(memcmp(middle, bytes.data() + 100 * 1024 + 3, sizeof(middle)) == 0);
+  REQUIRE(input->error().code == 0);
+
+  input.reset();
+  REQUIRE(!remote_input_t::open("dir://" + bucket_dir + "/missing.bin", options, error));
+  REQUIRE(error.code != 0);
+  REQUIRE(!remote_input_t::open("dir://" + bucket_dir, options, error));
+  std::filesystem::remove_all(bucket_dir);
+}
@@ -48,6 +48,8 @@
 #include <dew/render/camera.h>
 #include <dew/render/renderer.h>
 
+#include "cpu_rasterizer.hpp"
+
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
@@ -692,3 +694,39 @@ TEST_CASE("render: removing the data source stops the draw groups")
   REQUIRE(after.group_count == 0);
   REQUIRE(after.point_draw_size == 0);
 }
+
+TEST_CASE("render: the CPU rasterizer splats the cloud and releases its buffers")
+{
+  // The headless backend `dew bench` measures with. It replaces the recording consumer here (the fixture
+  // has not rendered yet, so no buffer was created under the old callbacks).
+  render_fixture_t fixture;
+  dew::render::cpu_rasterizer_t rasterizer(fixture.renderer, fixture.camera, 320, 240);
+  fixture.look_from(1, 1, 1, 2.0);
+
+  dew::render::cpu_frame_stats_t stats;
+  dew::render::image_difference_t empty;
+  for (int i = 0; i < 400; i++)
+  {
+    stats = rasterizer.draw();
+    empty = dew::render::compare_images(rasterizer.image(), dew::render::cpu_image_t{320, 240, std::vector<uint8_t>(320 * 240 * 4, 0), std::vector<float>(320 * 240, 1.0f)});
+    if (stats.points_splatted > 0 && i > 8)
+      break;
+  }
+  MESSAGE("point groups: ", stats.point_groups, "  submitted: ", stats.points_submitted, "  splatted: ", stats.points_splatted, "  coverage: ", empty.coverage_a);
+  REQUIRE(stats.point_groups > 0);
+  REQUIRE(stats.points_splatted > 0);
+  REQUIRE(stats.points_splatted <= stats.points_submitted);
+  REQUIRE(empty.coverage_a > 0.0);
+  REQUIRE(empty.differing_fraction == doctest::Approx(empty.coverage_a));
+  REQUIRE(rasterizer.live_buffers() > 0);
+  REQUIRE(rasterizer.buffer_bytes() > 0);
+
+  // An image compared with itself is identical.
+  const auto self = dew::render::compare_images(rasterizer.image(), rasterizer.image());
+  REQUIRE(self.differing_fraction == 0.0);
+  REQUIRE(self.rmse == 0.0);
+
+  dew_converter_data_source_destroy(fixture.data_source);
+  fixture.data_source = nullptr;
+  REQUIRE(rasterizer.live_buffers() == 0);
+}
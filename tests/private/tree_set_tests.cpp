@@ -29,6 +29,7 @@
 #include <doctest/doctest.h>
 
 #include "blob_reader.hpp"
+#include "hierarchy_directory.hpp"
 #include "storage_handler.hpp"
 #include "tree_set.hpp"
 
@@ -67,8 +68,10 @@ struct tree_set_fixture_t : vio::about_to_block_t
   void on_index_written() {}
   void on_storage_error(const dew_error_t &&) {}
 
-  // A registry of k_tree_count trees, all written to storage, none resident.
-  std::unique_ptr<uint8_t[]> build_registry(uint32_t &out_size)
+  // A registry of k_tree_count trees, all written to storage, none resident. The trees form a small
+  // hierarchy -- 0 over {1, 2}, 1 over {3} -- and with `directory_depth` the registry also names a
+  // hierarchy directory of that many tree levels.
+  std::unique_ptr<uint8_t[]> build_registry(uint32_t &out_size, uint32_t directory_depth = 0)
   {
     tree_registry_t source;
     source.tree_config.scale = 0.001;
@@ -104,6 +107,10 @@ struct tree_set_fixture_t : vio::about_to_block_t
       collection.max = tree->morton_max;
       collection.min_lod = morton::morton_lod(collection.min, collection.max);
       tree->data[0].push_back(std::move(collection));
+      if (i == 0)
+        tree->sub_trees = {tree_id_t{1}, tree_id_t{2}};
+      else if (i == 1)
+        tree->sub_trees = {tree_id_t{3}};
 
       ids.push_back(tree_id_t{i});
       serialized.push_back(tree_serialize(*tree));
@@ -130,6 +137,22 @@ struct tree_set_fixture_t : vio::about_to_block_t
     for (uint32_t i = 0; i < k_tree_count; i++)
       source.locations[i] = locations[i];
 
+    if (directory_depth > 0)
+    {
+      auto directory = hierarchy_directory_serialize(source.root, directory_depth, [&source](tree_id_t id) -> const tree_t * { return source.get(id); });
+      REQUIRE(directory.data);
+      std::unique_lock<std::mutex> lock(mutex);
+      done = false;
+      storage.write_tree_registry(std::move(directory), [this, &source](storage_location_t location, dew_error_t &&write_error) {
+        std::unique_lock<std::mutex> inner(mutex);
+        REQUIRE(write_error.code == 0);
+        source.hierarchy_directory = location;
+        done = true;
+        cond.notify_all();
+      });
+      cond.wait(lock, [this] { return done; });
+    }
+
     auto serialized_registry = tree_registry_serialize(source);
     out_size = uint32_t(serialized_registry.size);
     auto copy = std::make_unique<uint8_t[]>(out_size);
@@ -286,3 +309,42 @@ TEST_CASE("tree_set: both wait shapes install the same tree")
   via_request.begin_shutdown();
   via_load.begin_shutdown();
 }
+
+TEST_CASE("tree_set: the hierarchy directory installs the top trees with one read")
+{
+  // The directory exists to replace one read per tree at the top of the octree with a single read.
+  // So: the trees it holds are resident without a single tree load, the one below its depth is not,
+  // and that one still loads on demand the ordinary way.
+  tree_set_fixture_t fixture;
+  uint32_t registry_size = 0;
+  auto registry_blob = fixture.build_registry(registry_size, 2);
+
+  tree_set_t trees(fixture.storage.reader(), fixture.loop_thread.event_loop());
+  REQUIRE(trees.initialize(registry_blob, registry_size).code == 0);
+  REQUIRE(trees.registry().hierarchy_directory.size != 0);
+
+  bool loaded = false;
+  dew_error_t load_error;
+  on_loop(fixture.loop_thread.event_loop(), [&] {
+    [](tree_set_t *set, bool *out, dew_error_t *err) -> vio::detached_task_t { *out = co_await set->load_directory(*err); }(&trees, &loaded, &load_error);
+  });
+  REQUIRE(wait_resident(trees, tree_id_t{2}));
+  // The last install and the coroutine's return run in the same loop task; this one queues behind it.
+  on_loop(fixture.loop_thread.event_loop(), [&] {});
+  REQUIRE(loaded);
+  REQUIRE(load_error.code == 0);
+  REQUIRE(trees.resident(tree_id_t{0}));
+  REQUIRE(trees.resident(tree_id_t{1}));
+  REQUIRE(!trees.resident(tree_id_t{3}));
+  REQUIRE(trees.directory_trees() == 3);
+  REQUIRE(trees.loads_started() == 0);
+  // Installed like a loaded tree: the right one in each slot, its sub-trees intact for the walk.
+  REQUIRE(trees.registry().get(tree_id_t{1})->morton_max.data[0] == uint64_t(1) << 21);
+  REQUIRE(trees.registry().get(tree_id_t{1})->sub_trees.size() == 1);
+
+  trees.request({tree_id_t{0}, tree_id_t{3}});
+  REQUIRE(wait_resident(trees, tree_id_t{3}));
+  REQUIRE(trees.loads_started() == 1);
+
+  trees.begin_shutdown();
+}
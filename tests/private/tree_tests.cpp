@@ -1,5 +1,6 @@
 #include <doctest/doctest.h>
 #include <fmt/printf.h>
+#include <thread>
 #include <utility>
 
 #include <vio/event_loop.h>
@@ -24,6 +25,7 @@
 #include <dew/core/default_attribute_names.h>
 #include <tree.hpp>
 #include <tree_build.hpp>
+#include <tree_registry_journal.hpp>
 
 namespace
 {
@@ -386,6 +388,80 @@ TEST_CASE("reparent non-zero child position")
     REQUIRE(tree.magnitude == 1);
   }
 }
+
+static uint64_t registry_point_count(dew::core::tree_registry_t &registry)
+{
+  uint64_t count = 0;
+  for (auto &tree : registry.data)
+  {
+    if (!tree)
+      continue;
+    for (auto &level : tree->data)
+      for (auto &collection : level)
+        count += collection.point_count;
+  }
+  return count;
+}
+
+TEST_CASE("sharded insertion matches serial insertion")
+{
+  tree_test_infrastructure test_util(256);
+  dew::core::tree_registry_t serial_registry(test_util.node_limit, test_util.tree_config);
+  constexpr int cells = 16;
+  constexpr uint64_t cell_span = (uint64_t(1) << 15) - 1;
+
+  // Two chunks per top-level cell, inserted serially into both registries: the second overflows the cell's
+  // leaf, so each cell ends up as a subtree of the (magnitude 1) root.
+  for (int round = 0; round < 2; round++)
+  {
+    for (int cell = 0; cell < cells; cell++)
+    {
+      auto points = create_points(test_util, uint64_t(cell) << 15, (uint64_t(cell) << 15) + cell_span);
+      auto locations = points.locations;
+      if (round == 0 && cell == 0)
+      {
+        test_util.tree_registry.root = dew::converter::tree_initialize(test_util.tree_registry, test_util.cache_file_handler, points.header, points.attribute_id, std::move(points.locations));
+        serial_registry.root = dew::converter::tree_initialize(serial_registry, test_util.cache_file_handler, points.header, points.attribute_id, std::move(locations));
+        continue;
+      }
+      test_util.tree_registry.root = dew::converter::tree_add_points(test_util.tree_registry, test_util.cache_file_handler, test_util.tree_registry.root, points.header, points.attribute_id, std::move(points.locations));
+      serial_registry.root = dew::converter::tree_add_points(serial_registry, test_util.cache_file_handler, serial_registry.root, points.header, points.attribute_id, std::move(locations));
+    }
+  }
+
+  // A third round as one batch: serially into one registry, through shards on their own threads into the other.
+  std::vector<dew::converter::tree_insert_t> batch;
+  for (int cell = 0; cell < cells; cell++)
+  {
+    auto points = create_points(test_util, uint64_t(cell) << 15, (uint64_t(cell) << 15) + cell_span);
+    serial_registry.root = dew::converter::tree_add_points(serial_registry, test_util.cache_file_handler, serial_registry.root, points.header, points.attribute_id, std::vector<dew::core::storage_location_t>(points.locations));
+    batch.push_back({points.header, points.attribute_id, std::move(points.locations)});
+  }
+
+  size_t next = 0;
+  size_t max_shards = 0;
+  while (next < batch.size())
+  {
+    dew::converter::tree_shard_plan_t plan;
+    next = dew::converter::tree_plan_shards(test_util.tree_registry, test_util.cache_file_handler, batch, next, plan);
+    max_shards = std::max(max_shards, plan.shards.size());
+    std::vector<std::thread> threads;
+    for (auto &shard : plan.shards)
+      threads.emplace_back([&test_util, &plan, &shard] { dew::converter::tree_shard_insert(test_util.tree_registry, test_util.cache_file_handler, plan, shard); });
+    for (auto &thread : threads)
+      thread.join();
+    dew::converter::tree_merge_shards(test_util.tree_registry, plan);
+  }
+
+  REQUIRE(max_shards == cells);
+  REQUIRE(test_util.tree_registry.current_id == serial_registry.current_id);
+  REQUIRE(test_util.tree_registry.data.size() == test_util.tree_registry.current_id);
+  REQUIRE(registry_point_count(test_util.tree_registry) == uint64_t(3 * cells * 256));
+  REQUIRE(registry_point_count(test_util.tree_registry) == registry_point_count(serial_registry));
+  require_chunk_refs_consistent(test_util.tree_registry);
+  require_chunk_refs_consistent(serial_registry);
+}
+
 TEST_CASE("lod generation updates subset count and offset")
 {
   tree_test_infrastructure test_util(256);
@@ -636,6 +712,50 @@ TEST_CASE("get_done_morton returns all-max when all files done" * doctest::test_
   REQUIRE(result->data[2] == expected.data[2]);
 }
 
+TEST_CASE("get_done_morton holds at an open push stream segment's floor" * doctest::test_suite("[incremental_lod]"))
+{
+  dew::converter::input_data_source_registry_t registry;
+  auto tree_config = create_tree_config(0.001, 0.0);
+
+  auto ref1 = register_test_file(registry, "file1.las");
+  pre_init_test_file(registry, tree_config, ref1.input_id, 10.0);
+  auto next1 = registry.next_input_to_process();
+  REQUIRE(next1.has_value());
+
+  double floor_pos[3] = {20.0, 0.0, 0.0};
+  dew::core::morton::morton192_t floor = {};
+  dew::core::convert_pos_to_morton(tree_config.scale, tree_config.offset, floor_pos, floor);
+  dew::converter::input_data_reference_t segment;
+  REQUIRE(registry.register_stream_segment(floor, segment));
+
+  // The file is done and the stream is not: everything below the stream's floor is final, nothing above.
+  mark_file_done(registry, next1->id);
+  auto result = registry.get_done_morton();
+  REQUIRE(result.has_value());
+  REQUIRE(!(floor < *result));
+  REQUIRE(!registry.all_inserted_into_tree());
+
+  // Below the reported watermark is final: neither a new segment nor a lower floor may reach there.
+  double low_pos[3] = {5.0, 0.0, 0.0};
+  dew::core::morton::morton192_t low = {};
+  dew::core::convert_pos_to_morton(tree_config.scale, tree_config.offset, low_pos, low);
+  REQUIRE(!registry.lower_stream_floor(segment.input_id, low));
+  dew::converter::input_data_reference_t refused;
+  REQUIRE(!registry.register_stream_segment(low, refused));
+
+  // Once the segment is closed and inserted the stream no longer holds the watermark.
+  auto sub = segment.input_id;
+  registry.handle_sub_added(sub);
+  registry.handle_reading_done(segment.input_id);
+  REQUIRE(!registry.stream_segment_complete(segment.input_id));
+  registry.handle_tree_done_with_input(sub);
+  REQUIRE(registry.stream_segment_complete(segment.input_id));
+  REQUIRE(registry.all_inserted_into_tree());
+  auto all = registry.get_done_morton();
+  REQUIRE(all.has_value());
+  REQUIRE(floor < *all);
+}
+
 TEST_CASE("get_done_morton clamps by undispatched files" * doctest::test_suite("[incremental_lod]"))
 {
   // An undispatched file with KNOWN pre-init bounds no longer blocks the watermark outright: its
@@ -870,6 +990,94 @@ TEST_CASE("tree registry v3 round-trip preserves state, watermark, refs and snap
   REQUIRE(restored.input_registry_snapshot == registry.input_registry_snapshot);
 }
 
+TEST_CASE("tree registry journal replays deltas onto the snapshot" * doctest::test_suite("[registry_v2]"))
+{
+  auto config = create_tree_config(0.001, 0.0);
+  dew::core::tree_registry_t registry(1000, config);
+  registry.current_id = 64;
+  registry.locations.resize(64);
+  registry.tree_state.assign(64, uint8_t(dew::core::tree_state_t::building));
+  registry.tree_band.assign(64, dew::core::tree_band_none);
+  for (uint32_t i = 0; i < 64; i++)
+  {
+    registry.locations[i] = {0, 128, 4096 + uint64_t(i) * 128};
+    registry.chunk_tree_refs[dew::core::input_data_id_t{i, 0}] = {1, 1000 + i};
+  }
+  registry.input_registry_snapshot = {1, 2, 3};
+
+  auto to_blob = [](const dew::core::serialized_tree_registry_t &serialized)
+  {
+    dew::core::tree_registry_journal_blob_t blob;
+    blob.size = uint32_t(serialized.size);
+    blob.data = std::make_unique<uint8_t[]>(blob.size);
+    memcpy(blob.data.get(), serialized.data.get(), blob.size);
+    return blob;
+  };
+
+  dew::core::tree_registry_journal_t journal;
+  auto first = dew::core::tree_registry_journal_next(journal, registry);
+  REQUIRE(first.snapshot);
+  std::vector<dew::core::tree_registry_journal_blob_t> records;
+  records.push_back(to_blob(first.data));
+  dew::core::tree_registry_journal_commit(journal, std::move(first), {0, records[0].size, 1 << 20});
+
+  // A pass that touched a couple of trees and chunks.
+  registry.current_id = 65;
+  registry.locations.push_back({0, 256, 8192});
+  registry.tree_state.push_back(uint8_t(dew::core::tree_state_t::building));
+  registry.tree_band.push_back(dew::core::tree_band_none);
+  registry.locations[3] = {0, 512, 1 << 21};
+  registry.tree_state[5] = uint8_t(dew::core::tree_state_t::final);
+  registry.tree_band[5] = 2;
+  registry.chunk_tree_refs.erase(dew::core::input_data_id_t{7, 0});
+  registry.chunk_tree_refs[dew::core::input_data_id_t{8, 0}] = {2, 1008};
+  registry.chunk_tree_refs[dew::core::input_data_id_t{100, 1}] = {1, 42};
+  registry.input_registry_snapshot = {4, 5};
+
+  auto second = dew::core::tree_registry_journal_next(journal, registry);
+  REQUIRE(!second.snapshot);
+  REQUIRE(uint32_t(second.data.size) < records[0].size / 4);
+  records.push_back(to_blob(second.data));
+  dew::core::tree_registry_journal_commit(journal, std::move(second), {0, records[1].size, 2 << 20});
+  REQUIRE(journal.records.size() == 2);
+
+  auto manifest = dew::core::tree_registry_journal_manifest(journal.records);
+  REQUIRE(dew::core::tree_registry_journal_is_manifest(manifest.data.get(), uint32_t(manifest.size)));
+  std::vector<dew::core::storage_location_t> parsed;
+  REQUIRE(dew::core::tree_registry_journal_parse_manifest(manifest.data.get(), uint32_t(manifest.size), parsed).code == 0);
+  REQUIRE(parsed.size() == 2);
+  REQUIRE(parsed[1].offset == journal.records[1].offset);
+
+  // A pre-journal reader refuses the manifest rather than misparsing it.
+  auto manifest_blob = to_blob(manifest);
+  dew::core::tree_registry_t refused;
+  REQUIRE(dew::core::tree_registry_deserialize(manifest_blob.data, manifest_blob.size, refused).code != 0);
+
+  std::unique_ptr<uint8_t[]> replayed;
+  uint32_t replayed_size = 0;
+  REQUIRE(dew::core::tree_registry_journal_replay(records, replayed, replayed_size).code == 0);
+  dew::core::tree_registry_t restored;
+  REQUIRE(dew::core::tree_registry_deserialize(replayed, replayed_size, restored).code == 0);
+  REQUIRE(restored.current_id == registry.current_id);
+  REQUIRE(restored.locations.size() == registry.locations.size());
+  for (size_t i = 0; i < registry.locations.size(); i++)
+    REQUIRE(restored.locations[i] == registry.locations[i]);
+  REQUIRE(restored.tree_state == registry.tree_state);
+  REQUIRE(restored.tree_band == registry.tree_band);
+  REQUIRE(restored.chunk_tree_refs.size() == registry.chunk_tree_refs.size());
+  for (auto &[chunk_id, chunk_ref] : registry.chunk_tree_refs)
+  {
+    REQUIRE(restored.chunk_tree_refs.contains(chunk_id));
+    REQUIRE(restored.chunk_tree_refs.at(chunk_id).tree_count == chunk_ref.tree_count);
+    REQUIRE(restored.chunk_tree_refs.at(chunk_id).point_count == chunk_ref.point_count);
+  }
+  REQUIRE(restored.input_registry_snapshot == registry.input_registry_snapshot);
+
+  // Compaction: once the deltas outweigh the snapshot the next record is a snapshot again.
+  journal.delta_bytes = journal.snapshot_size;
+  REQUIRE(dew::core::tree_registry_journal_next(journal, registry).snapshot);
+}
+
 namespace
 {
 // The 40-byte tree_config layout that v1/v2 registry blobs serialized (no read_chunk_byte_target).
@@ -0,0 +1,92 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+#include <doctest/doctest.h>
+
+#include "worker_pools.hpp"
+
+#include <vio/thread_pool.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace dew;
+using namespace dew::converter;
+using namespace dew::core;
+
+TEST_CASE("numa cpu list parsing and topology detection")
+{
+  std::vector<int> cpus;
+  REQUIRE(parse_cpu_list("0-3,8,10-11\n", cpus));
+  REQUIRE(cpus == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+  REQUIRE(parse_cpu_list("", cpus));
+  REQUIRE(cpus.empty()); // memory-only node
+  REQUIRE(!parse_cpu_list("3-1", cpus));
+  REQUIRE(!parse_cpu_list("0,x", cpus));
+
+  REQUIRE(detect_numa_topology("/nonexistent/dew/sysfs").empty());
+#if defined(__linux__)
+  auto root = std::filesystem::temp_directory_path() / "dew_numa_topology_test";
+  std::filesystem::remove_all(root);
+  auto add_node = [&](const char *name, const char *cpulist) {
+    std::filesystem::create_directories(root / name);
+    std::ofstream(root / name / "cpulist") << cpulist;
+  };
+  add_node("node1", "4-7\n");
+  add_node("node0", "0-3\n");
+  add_node("node2", "\n"); // memory-only: skipped
+  std::filesystem::create_directories(root / "power");
+  auto nodes = detect_numa_topology(root.string());
+  std::filesystem::remove_all(root);
+  REQUIRE(nodes.size() == 2);
+  REQUIRE(nodes[0].id == 0);
+  REQUIRE(nodes[0].cpus == std::vector<int>{0, 1, 2, 3});
+  REQUIRE(nodes[1].id == 1);
+  REQUIRE(nodes[1].cpus.size() == 4);
+
+  // Routing: one node keeps the shared pool; two nodes split inputs and subtrees.
+  vio::thread_pool_t shared(4);
+  worker_pools_t pools(shared, 4);
+  REQUIRE(!pools.enable_numa({nodes[0]}));
+  REQUIRE(&pools.pool_for_input({5, 0}) == &shared);
+  REQUIRE(pools.enable_numa({{0, {0}}, {1, {0}}}));
+  REQUIRE(pools.node_count() == 2);
+  REQUIRE(pools.node_for_input({5, 3}) == 1);
+  REQUIRE(pools.node_for_tree(tree_id_t(4)) == 0);
+  REQUIRE(&pools.pool(0) != &shared);
+  REQUIRE(&pools.pool(0) != &pools.pool(1));
+  REQUIRE(pools.node_stats().size() == 2);
+  // The node pools have a worker per CPU of their own, so the shared pool keeps two and parks the rest.
+  for (int spin = 0; spin < 1000 && pools.parked_shared_workers() < 2; spin++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  REQUIRE(pools.parked_shared_workers() == 2);
+  bool ran = false;
+  shared.enqueue([&ran] { ran = true; }).get(); // the two it kept still run work
+  REQUIRE(ran);
+  pools.join();
+  REQUIRE(pools.node_stats().size() == 2);
+  REQUIRE(&pools.pool(1) == &shared); // joined pools take no more work
+  shared.join(); // returns: join() released the parked workers
+#endif
+}
+
+} // namespace
@@ -49,7 +49,7 @@ _CUSTOM_CLASS_SNIPPETS = {
     "dew_laszip_callbacks": ("Converter", "dewpy::bind_use_laszip_callbacks(cls);"),
     # The C request lifecycle (opaque handle, borrowed buffers, explicit release) is not what a
     # Python caller wants; Dataset.query_box() runs it end to end and hands back NumPy arrays.
-    "dew_dataset_request_region": ("Dataset", "dewpy::bind_query_box(cls);\n  dewpy::bind_query_submit<PyRequest>(cls);"),
+    "dew_dataset_request_region": ("Dataset", "dewpy::bind_query_box(cls);\n  dewpy::bind_aggregate_box(cls);\n  dewpy::bind_query_submit<PyRequest>(cls);"),
     # The pump is how a Python event loop drives the library without blocking: a wake callback says
     # "look again", poll() dispatches. Both are py.skip in the header because their C signatures carry
     # a raw user_ptr the generators cannot express.
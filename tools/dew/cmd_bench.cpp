@@ -0,0 +1,566 @@
+/************************************************************************
+** dewfall - point cloud management software.
+** Copyright (C) 2026  Jørgen Lind
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Affero General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+************************************************************************/
+
+// `dew bench` -- streaming-convergence benchmark on the headless CPU rasterizer.
+//
+// Flies a scripted camera path over a dataset, one dew_renderer_frame per step, with the CPU splatter
+// (cpu_rasterizer.hpp) as the consumer, then holds the last pose until streaming settles. It reports what
+// the GL example can only show by eye: frame time, the per-frame IO/upload counters, how long the last view
+// takes to reach full detail, and how far each frame of that hold is from a reference image of the same
+// view rendered by a separate, unconstrained session that was allowed to load everything first.
+//
+// The reference comes first and from its own data source, so the benchmarked session starts with a cold
+// read cache either way.
+
+#include "commands.hpp"
+#include "tool_common.hpp"
+
+#include <argh.h>
+#include <fmt/format.h>
+#include <dew/converter/connection_cli.h>
+#include <dew/converter/converter_data_source.h>
+#include <dew/render/camera.h>
+#include <dew/render/renderer.h>
+
+#include "cpu_rasterizer.hpp"
+#include "data_source_converter.hpp" // io_stats_last / frame_timings: the in-process counters
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+enum class camera_path_t
+{
+  orbit,
+  dolly,
+  pan
+};
+
+struct bench_args_t
+{
+  std::string url;
+  std::string connection;
+  camera_path_t path = camera_path_t::orbit;
+  uint32_t frames = 240;
+  uint32_t settle_frames = 600;
+  uint32_t width = 800;
+  uint32_t height = 600;
+  uint32_t fps = 60;
+  uint64_t memory_budget_mb = 0;
+  double prefetch_ms = 0;
+  uint32_t occlusion = 0; // occlusion_mode_t
+  std::string ppm_prefix;
+  bool reference = true;
+  bool verbose = false;
+};
+
+void print_usage()
+{
+  fmt::print(stderr, R"(Usage: dew bench <dataset> [options]
+
+Render a scripted camera path with the headless CPU rasterizer and report per-frame streaming
+counters, time-to-full-detail for the final view, and its image difference to a fully loaded reference.
+
+Options:
+  --path orbit|dolly|pan     camera path (default: orbit)
+  -n, --frames <n>           frames along the path (default: 240)
+  --settle <n>               frame limit for the hold at the last pose (default: 600)
+  --width <px>, --height <px>  image size (default: 800x600)
+  --fps <n>                  pace frames to this rate so IO gets wall time; 0 = unpaced (default: 60)
+  --memory-budget <MB>       dew_converter_data_source_set_memory_budget for the benchmarked session
+  --prefetch <ms>            predictive prefetch lookahead (default: 0, off)
+  --occlusion off|deprioritize|skip  occlusion culling before IO (default: off)
+  --no-reference             skip the reference render (no image scores)
+  --ppm <prefix>             write <prefix>_arrival.ppm, _converged.ppm and _reference.ppm
+  -C, --connection <spec>    connection string for cloud datasets
+  -v, --verbose              print the per-frame table
+)");
+}
+
+// One renderer + data source + camera + CPU consumer. Torn down in consumer order (data source first).
+struct session_t
+{
+  dew_renderer_t *renderer = nullptr;
+  dew_converter_data_source_t *data_source = nullptr;
+  dew_camera_t *camera = nullptr;
+  dew::render::cpu_rasterizer_t *rasterizer = nullptr;
+
+  ~session_t()
+  {
+    if (data_source)
+      dew_converter_data_source_destroy(data_source);
+    delete rasterizer;
+    if (camera)
+      dew_camera_destroy(camera);
+    if (renderer)
+      dew_renderer_destroy(renderer);
+  }
+
+  bool open(const bench_args_t &args, std::string &error_out)
+  {
+    renderer = dew_renderer_create();
+    camera = dew_camera_create();
+    rasterizer = new dew::render::cpu_rasterizer_t(renderer, camera, int(args.width), int(args.height));
+    dew_error_t *error = dew_error_create();
+    data_source = dew_converter_data_source_create_with_connection(args.url.c_str(), uint32_t(args.url.size()), args.connection.c_str(), uint32_t(args.connection.size()), error, renderer);
+    if (!data_source)
+    {
+      error_out = tool::get_error_string(error);
+      dew_error_destroy(error);
+      return false;
+    }
+    dew_error_destroy(error);
+    dew_converter_data_source_set_viewport(data_source, int(args.width), int(args.height));
+    dew_renderer_add_data_source(renderer, dew_converter_data_source_get(data_source));
+    dew_camera_set_perspective(camera, 45, args.width, args.height, 0.1, 100000);
+    return true;
+  }
+
+  // The dataset extent, once the root tree is in (see renderer_example: get_tight_aabb is empty this early).
+  void wait_for_aabb(double aabb_min[3], double aabb_max[3]) const
+  {
+    struct state_t
+    {
+      std::mutex mutex;
+      std::condition_variable cv;
+      bool done = false;
+      double min[3];
+      double max[3];
+    } state;
+    auto callback = [](double cb_min[3], double cb_max[3], void *user_ptr) {
+      auto *s = static_cast<state_t *>(user_ptr);
+      std::unique_lock<std::mutex> lock(s->mutex);
+      memcpy(s->min, cb_min, sizeof(s->min));
+      memcpy(s->max, cb_max, sizeof(s->max));
+      s->done = true;
+      s->cv.notify_one();
+    };
+    std::unique_lock<std::mutex> lock(state.mutex);
+    dew_converter_data_source_request_aabb(data_source, callback, &state);
+    state.cv.wait(lock, [&state] { return state.done; });
+    memcpy(aabb_min, state.min, sizeof(state.min));
+    memcpy(aabb_max, state.max, sizeof(state.max));
+  }
+
+  // Nothing in flight, nothing decoding or uploading, no subtree still to load, no fade playing.
+  [[nodiscard]] bool settled() const
+  {
+    const auto &io = data_source->io_stats_last;
+    const auto &t = data_source->frame_timings;
+    return io.io_in_flight == 0 && io.io_scheduled == 0 && io.uploads_done == 0 && io.backlog_bytes == 0 && t.walker_trees_to_load == 0 &&
+           !dew_converter_data_source_is_animating(data_source);
+  }
+};
+
+struct pose_t
+{
+  double eye[3];
+  double center[3];
+};
+
+// t in [0, 1] along the path. Distances are in units of the dataset's bounding radius.
+pose_t camera_pose(camera_path_t path, double t, const double center[3], double radius)
+{
+  pose_t pose;
+  memcpy(pose.center, center, sizeof(pose.center));
+  switch (path)
+  {
+  case camera_path_t::orbit: {
+    // Once around at 30 degrees elevation, far enough to see the whole cloud.
+    const double angle = 2.0 * 3.14159265358979323846 * t;
+    const double elevation = 30.0 * 3.14159265358979323846 / 180.0;
+    const double distance = 2.0 * radius;
+    pose.eye[0] = center[0] + distance * std::cos(elevation) * std::cos(angle);
+    pose.eye[1] = center[1] + distance * std::cos(elevation) * std::sin(angle);
+    pose.eye[2] = center[2] + distance * std::sin(elevation);
+    break;
+  }
+  case camera_path_t::dolly: {
+    // From overview into the middle: the path that forces the deepest refinement.
+    const double distance = 3.0 * radius + (0.3 * radius - 3.0 * radius) * t;
+    pose.eye[0] = center[0];
+    pose.eye[1] = center[1] - distance * 0.8;
+    pose.eye[2] = center[2] + distance * 0.6;
+    break;
+  }
+  case camera_path_t::pan: {
+    // A low fly-by across the cloud, looking ahead: the leading edge keeps exposing new nodes.
+    const double x = center[0] - radius + 2.0 * radius * t;
+    pose.eye[0] = x;
+    pose.eye[1] = center[1] - 0.8 * radius;
+    pose.eye[2] = center[2] + 0.4 * radius;
+    pose.center[0] = x;
+    break;
+  }
+  }
+  return pose;
+}
+
+void apply_pose(dew_camera_t *camera, const pose_t &pose)
+{
+  const double up[3] = {0.0, 0.0, 1.0};
+  dew_camera_look_at(camera, pose.eye, pose.center, up);
+}
+
+struct frame_row_t
+{
+  uint32_t frame;
+  bool hold;
+  double frame_ms;
+  double raster_ms;
+  dew::converter::io_upload_stats_t io;
+  uint64_t uploaded_bytes;
+  uint64_t points;
+  dew::render::image_difference_t diff;
+};
+
+double percentile(std::vector<double> values, double p)
+{
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  const size_t index = std::min(values.size() - 1, size_t(p * double(values.size() - 1) + 0.5));
+  return values[index];
+}
+
+void pace(clock_type::time_point frame_start, uint32_t fps)
+{
+  if (fps == 0)
+    return;
+  const auto target = frame_start + std::chrono::microseconds(1'000'000 / fps);
+  std::this_thread::sleep_until(target);
+}
+
+} // namespace
+
+int cmd_bench(int argc, char **argv)
+{
+  argh::parser cmdl;
+  cmdl.add_params({"--path", "-n", "--frames", "--settle", "--width", "--height", "--fps", "--memory-budget", "--prefetch", "--occlusion", "--ppm", "-C", "--connection"});
+  cmdl.parse(argc, argv);
+  if (cmdl[{"-h", "--help"}] || cmdl.size() < 2)
+  {
+    print_usage();
+    return cmdl[{"-h", "--help"}] ? 0 : 1;
+  }
+  if (!tool::check_options(cmdl, {"no-reference", "v", "verbose"},
+                           {"path", "n", "frames", "settle", "width", "height", "fps", "memory-budget", "prefetch", "ppm", "C", "connection"}))
+    return 1;
+
+  bench_args_t args;
+  args.url = cmdl[1];
+  args.verbose = cmdl[{"-v", "--verbose"}];
+  args.reference = !cmdl["--no-reference"];
+  cmdl({"--ppm"}) >> args.ppm_prefix;
+
+  std::string path_text;
+  if (cmdl({"--path"}) >> path_text)
+  {
+    if (path_text == "orbit")
+      args.path = camera_path_t::orbit;
+    else if (path_text == "dolly")
+      args.path = camera_path_t::dolly;
+    else if (path_text == "pan")
+      args.path = camera_path_t::pan;
+    else
+    {
+      fmt::print(stderr, "Error: --path must be orbit, dolly or pan\n");
+      return 1;
+    }
+  }
+  auto parse_u32_option = [&cmdl](std::initializer_list<const char *> names, uint32_t &out) {
+    std::string text;
+    if (!(cmdl(names) >> text))
+      return true;
+    if (!tool::parse_u32(text, out))
+    {
+      fmt::print(stderr, "Error: --{} needs a non-negative integer, got '{}'\n", *(names.end() - 1) + 2, text);
+      return false;
+    }
+    return true;
+  };
+  if (!parse_u32_option({"-n", "--frames"}, args.frames) || !parse_u32_option({"--settle"}, args.settle_frames) || !parse_u32_option({"--width"}, args.width) ||
+      !parse_u32_option({"--height"}, args.height) || !parse_u32_option({"--fps"}, args.fps))
+    return 1;
+  {
+    std::string text;
+    if (cmdl({"--memory-budget"}) >> text && !tool::parse_u64(text, args.memory_budget_mb))
+    {
+      fmt::print(stderr, "Error: --memory-budget needs a size in MB, got '{}'\n", text);
+      return 1;
+    }
+    if (cmdl({"--prefetch"}) >> text)
+    {
+      // strtod, not std::stod: the project builds -fno-exceptions.
+      char *end = nullptr;
+      args.prefetch_ms = std::strtod(text.c_str(), &end);
+      if (end == text.c_str() || args.prefetch_ms < 0)
+      {
+        fmt::print(stderr, "Error: --prefetch needs a lookahead in ms, got '{}'\n", text);
+        return 1;
+      }
+    }
+    if (cmdl({"--occlusion"}) >> text)
+    {
+      if (text == "off")
+        args.occlusion = 0;
+      else if (text == "deprioritize")
+        args.occlusion = 1;
+      else if (text == "skip")
+        args.occlusion = 2;
+      else
+      {
+        fmt::print(stderr, "Error: --occlusion must be off, deprioritize or skip, got '{}'\n", text);
+        return 1;
+      }
+    }
+  }
+  if (args.frames == 0 || args.width == 0 || args.height == 0)
+  {
+    fmt::print(stderr, "Error: --frames, --width and --height must be positive\n");
+    return 1;
+  }
+  {
+    std::string conn_error;
+    if (!dew::converter::cli::resolve_connection_spec(cmdl({"-C", "--connection"}).str(), args.connection, conn_error))
+    {
+      fmt::print(stderr, "Connection error: {}\n", conn_error);
+      return 1;
+    }
+  }
+
+  double aabb_min[3];
+  double aabb_max[3];
+  double center[3];
+  double radius = 0;
+  pose_t final_pose{};
+
+  // ---- reference: the final view, unconstrained, loaded until it settles ----------------------------
+  dew::render::cpu_image_t reference;
+  bool have_reference = false;
+  if (args.reference)
+  {
+    session_t ref;
+    std::string error;
+    if (!ref.open(args, error))
+    {
+      fmt::print(stderr, "Error: failed to open '{}': {}\n", args.url, error);
+      return 1;
+    }
+    ref.wait_for_aabb(aabb_min, aabb_max);
+    dew_converter_data_source_set_gpu_memory_budget(ref.data_source, size_t(4096) * 1024 * 1024);
+    dew_converter_data_source_set_max_in_flight_io(ref.data_source, 256);
+    for (int i = 0; i < 3; i++)
+      center[i] = (aabb_min[i] + aabb_max[i]) * 0.5;
+    radius = 0.5 * std::sqrt((aabb_max[0] - aabb_min[0]) * (aabb_max[0] - aabb_min[0]) + (aabb_max[1] - aabb_min[1]) * (aabb_max[1] - aabb_min[1]) +
+                             (aabb_max[2] - aabb_min[2]) * (aabb_max[2] - aabb_min[2]));
+    final_pose = camera_pose(args.path, 1.0, center, radius);
+    apply_pose(ref.camera, final_pose);
+    int settled_run = 0;
+    uint32_t frame = 0;
+    const uint32_t limit = args.settle_frames * 4;
+    for (; frame < limit && settled_run < 3; frame++)
+    {
+      ref.rasterizer->draw();
+      settled_run = ref.settled() ? settled_run + 1 : 0;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (settled_run < 3)
+      fmt::print(stderr, "Warning: the reference did not settle within {} frames; image scores are approximate\n", limit);
+    reference = ref.rasterizer->image();
+    have_reference = true;
+  }
+
+  // ---- the benchmarked session -------------------------------------------------------------------
+  session_t bench;
+  {
+    std::string error;
+    if (!bench.open(args, error))
+    {
+      fmt::print(stderr, "Error: failed to open '{}': {}\n", args.url, error);
+      return 1;
+    }
+  }
+  if (!have_reference)
+  {
+    bench.wait_for_aabb(aabb_min, aabb_max);
+    for (int i = 0; i < 3; i++)
+      center[i] = (aabb_min[i] + aabb_max[i]) * 0.5;
+    radius = 0.5 * std::sqrt((aabb_max[0] - aabb_min[0]) * (aabb_max[0] - aabb_min[0]) + (aabb_max[1] - aabb_min[1]) * (aabb_max[1] - aabb_min[1]) +
+                             (aabb_max[2] - aabb_min[2]) * (aabb_max[2] - aabb_min[2]));
+    final_pose = camera_pose(args.path, 1.0, center, radius);
+  }
+  if (args.memory_budget_mb > 0)
+    dew_converter_data_source_set_memory_budget(bench.data_source, args.memory_budget_mb * 1024 * 1024);
+  if (args.prefetch_ms > 0)
+    dew_converter_data_source_set_prefetch_lookahead_ms(bench.data_source, args.prefetch_ms);
+  if (args.occlusion > 0)
+    dew_converter_data_source_set_occlusion_culling(bench.data_source, args.occlusion);
+
+  std::vector<frame_row_t> rows;
+  rows.reserve(args.frames + args.settle_frames);
+  auto run_frame = [&](uint32_t frame, bool hold) {
+    const auto start = clock_type::now();
+    const auto stats = bench.rasterizer->draw();
+    frame_row_t row{};
+    row.frame = frame;
+    row.hold = hold;
+    row.frame_ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    row.raster_ms = stats.raster_ms;
+    row.io = bench.data_source->io_stats_last;
+    row.uploaded_bytes = bench.rasterizer->take_uploaded_bytes();
+    row.points = stats.points_submitted;
+    if (hold && have_reference)
+      row.diff = dew::render::compare_images(bench.rasterizer->image(), reference);
+    rows.push_back(row);
+    pace(start, args.fps);
+  };
+
+  const auto bench_start = clock_type::now();
+  for (uint32_t frame = 0; frame < args.frames; frame++)
+  {
+    const double t = args.frames > 1 ? double(frame) / double(args.frames - 1) : 1.0;
+    apply_pose(bench.camera, camera_pose(args.path, t, center, radius));
+    run_frame(frame, false);
+  }
+  const auto arrival = clock_type::now();
+  dew::render::cpu_image_t arrival_image = bench.rasterizer->image();
+
+  // Hold the last pose until three settled frames in a row: that is "full detail" for this budget.
+  int settled_run = 0;
+  uint32_t hold_frames = 0;
+  uint32_t converged_hold_frame = 0;
+  clock_type::time_point converged_at = arrival;
+  for (; hold_frames < args.settle_frames && settled_run < 3; hold_frames++)
+  {
+    run_frame(args.frames + hold_frames, true);
+    if (bench.settled())
+    {
+      if (settled_run == 0)
+      {
+        converged_at = clock_type::now();
+        converged_hold_frame = hold_frames;
+      }
+      settled_run++;
+    }
+    else
+    {
+      settled_run = 0;
+    }
+  }
+  const bool converged = settled_run >= 3;
+  const auto bench_end = clock_type::now();
+
+  if (!args.ppm_prefix.empty())
+  {
+    dew::render::write_ppm(arrival_image, args.ppm_prefix + "_arrival.ppm");
+    dew::render::write_ppm(bench.rasterizer->image(), args.ppm_prefix + "_converged.ppm");
+    if (have_reference)
+      dew::render::write_ppm(reference, args.ppm_prefix + "_reference.ppm");
+  }
+
+  // ---- report ---------------------------------------------------------------------------------------
+  if (args.verbose)
+  {
+    fmt::print("{:>6} {:>4} {:>9} {:>9} {:>6} {:>6} {:>6} {:>5} {:>11} {:>11} {:>11} {:>11} {:>8} {:>8}\n", "frame", "hold", "frame_ms", "raster_ms", "io_new", "io_fly",
+               "upl", "deny", "backlog", "gpu", "uploaded", "points", "diff%", "rmse");
+    for (const auto &r : rows)
+    {
+      std::string diff_text = r.hold && have_reference ? fmt::format("{:.2f}", r.diff.differing_fraction * 100.0) : std::string("-");
+      std::string rmse_text = r.hold && have_reference ? fmt::format("{:.4f}", r.diff.rmse) : std::string("-");
+      fmt::print("{:>6} {:>4} {:>9.2f} {:>9.2f} {:>6} {:>6} {:>6} {:>5} {:>11} {:>11} {:>11} {:>11} {:>8} {:>8}\n", r.frame, r.hold ? "*" : "", r.frame_ms, r.raster_ms, r.io.io_scheduled,
+                 r.io.io_in_flight, r.io.uploads_done, r.io.io_denied_backlog + r.io.io_denied_gpu, tool::format_bytes(r.io.backlog_bytes), tool::format_bytes(r.io.gpu_memory_used),
+                 tool::format_bytes(r.uploaded_bytes), tool::format_number(r.points), diff_text, rmse_text);
+    }
+    fmt::print("\n");
+  }
+
+  std::vector<double> path_frame_ms;
+  uint64_t uploaded_total = 0;
+  uint64_t scheduled_total = 0;
+  for (const auto &r : rows)
+  {
+    if (!r.hold)
+      path_frame_ms.push_back(r.frame_ms);
+    uploaded_total += r.uploaded_bytes;
+    scheduled_total += uint64_t(r.io.io_scheduled);
+  }
+  double mean_ms = 0;
+  for (double ms : path_frame_ms)
+    mean_ms += ms;
+  mean_ms /= double(std::max<size_t>(1, path_frame_ms.size()));
+
+  const char *path_name = args.path == camera_path_t::orbit ? "orbit" : args.path == camera_path_t::dolly ? "dolly" : "pan";
+  fmt::print("Dataset:         {}\n", args.url);
+  fmt::print("Camera path:     {} ({} frames, {}x{}, {})\n", path_name, args.frames, args.width, args.height, args.fps ? fmt::format("{} fps pacing", args.fps) : std::string("unpaced"));
+  fmt::print("Frame time:      mean {:.2f} ms  p50 {:.2f}  p95 {:.2f}  max {:.2f}\n", mean_ms, percentile(path_frame_ms, 0.5), percentile(path_frame_ms, 0.95),
+             percentile(path_frame_ms, 1.0));
+  fmt::print("IO:              {} loads scheduled, {} uploaded ({}/frame)\n", tool::format_number(scheduled_total), tool::format_bytes(uploaded_total),
+             tool::format_bytes(uploaded_total / std::max<uint64_t>(1, rows.size())));
+  const double path_s = std::chrono::duration<double>(arrival - bench_start).count();
+  if (converged)
+    fmt::print("Full detail:     {:.0f} ms after arrival (hold frame {}; {:.2f} s from the first frame)\n", std::chrono::duration<double, std::milli>(converged_at - arrival).count(),
+               converged_hold_frame, path_s + std::chrono::duration<double>(converged_at - arrival).count());
+  else
+    fmt::print("Full detail:     not reached within {} hold frames ({:.2f} s)\n", args.settle_frames, std::chrono::duration<double>(bench_end - arrival).count());
+  if (have_reference)
+  {
+    const auto at_arrival = dew::render::compare_images(arrival_image, reference);
+    const auto at_end = dew::render::compare_images(bench.rasterizer->image(), reference);
+    fmt::print("Image vs ref:    arrival {:.2f}% differing (rmse {:.4f}), final {:.2f}% (rmse {:.4f}); coverage {:.1f}% / ref {:.1f}%\n", at_arrival.differing_fraction * 100.0,
+               at_arrival.rmse, at_end.differing_fraction * 100.0, at_end.rmse, at_end.coverage_a * 100.0, at_end.coverage_b * 100.0);
+    // The first hold frame within 1% of the reference: what a user perceives as "done", usually well before
+    // the last straggler upload settles the counters.
+    for (const auto &r : rows)
+    {
+      if (r.hold && r.diff.differing_fraction <= 0.01)
+      {
+        fmt::print("Within 1% of ref: hold frame {}\n", r.frame - args.frames);
+        break;
+      }
+    }
+  }
+  if (args.prefetch_ms > 0)
+  {
+    uint64_t issued = 0, hits = 0;
+    double hit_rate = 0;
+    dew_converter_data_source_get_prefetch_stats(bench.data_source, &issued, &hits, nullptr, nullptr, &hit_rate);
+    fmt::print("Prefetch:        {} issued, {} hits ({:.1f}%)\n", issued, hits, hit_rate * 100.0);
+  }
+  if (args.occlusion > 0)
+  {
+    // Last frame only: by then the view has settled, so this is the steady-state share the pyramid hides.
+    uint32_t tested = 0, occluded = 0, occluders = 0;
+    double coverage = 0, build_ms = 0;
+    dew_converter_data_source_get_occlusion_stats(bench.data_source, &tested, &occluded, &occluders, &coverage, &build_ms);
+    fmt::print("Occlusion:       {} of {} unloaded nodes occluded, {} occluders, {:.1f}% coverage, {:.3f} ms build\n", occluded, tested, occluders,
+               coverage * 100.0, build_ms);
+  }
+  return 0;
+}
@@ -14,6 +14,7 @@
 
 #include <dew/converter/connection_cli.h>
 #include <dew/converter/converter.h>
+#include <dew/converter/laszip_file_convert_callbacks.h>
 
 namespace
 {
@@ -118,6 +119,8 @@ void print_compression_stats(const dew_converter_stats_t &stats)
     double size_gb = double(stats.input_file_size_bytes) / (1024.0 * 1024.0 * 1024.0);
     fmt::print("  Source size:    {:.2f} GB\n", size_gb);
   }
+  if (stats.duplicate_points_removed > 0)
+    fmt::print("  Duplicates:     {} points removed\n", format_number(stats.duplicate_points_removed));
   fmt::print("  Total buffers:  {}\n", format_number(stats.total_buffer_count));
   fmt::print("  Method:         {}\n", method_name(stats.compression_method));
   fmt::print("\n");
@@ -145,7 +148,7 @@ void print_compression_stats(const dew_converter_stats_t &stats)
              format_number(total_compressed), total_ratio);
 }
 
-void print_perf_stats(const dew_converter_perf_stats_t &ps)
+void print_perf_stats(dew_converter_t *converter, const dew_converter_perf_stats_t &ps)
 {
   double overall = ps.total_time_seconds > 0 ? ps.total_bytes_written_mb / ps.total_time_seconds : 0;
 
@@ -177,6 +180,22 @@ void print_perf_stats(const dew_converter_perf_stats_t &ps)
     if (ps.lod_write.operation_count > 0)
       fmt::print(stderr, "    LOD write IO:      avg {:.2f} MB/s, peak {:.2f} MB/s, low {:.2f} MB/s\n", ps.lod_write.avg_mbps, ps.lod_write.peak_mbps, ps.lod_write.low_mbps);
   }
+
+  if (ps.buffer_pool_hits > 0 || ps.buffer_pool_misses > 0)
+    fmt::print(stderr, "  Buffer pool:         {} reused, {} allocated ({:.2f}s in allocator), peak {:.1f} MB in use\n", ps.buffer_pool_hits, ps.buffer_pool_misses, ps.allocation_seconds,
+               double(ps.peak_buffer_bytes) / (1024.0 * 1024.0));
+  if (ps.peak_rss_bytes > 0)
+    fmt::print(stderr, "  Peak RSS:            {:.1f} MB\n", double(ps.peak_rss_bytes) / (1024.0 * 1024.0));
+  if (ps.autotuned)
+    fmt::print(stderr, "  Autotune:            {} MiB chunks, {} readers, {} sorters, {} compressors ({} changes)\n", ps.autotune_read_chunk_bytes >> 20, ps.autotune_max_readers, ps.autotune_max_sorters,
+               ps.autotune_max_compressors, ps.autotune_decisions);
+  uint32_t numa_nodes = dew_converter_get_numa_node_count(converter);
+  for (uint32_t i = 0; i < numa_nodes; i++)
+  {
+    dew_converter_numa_node_stats_t node;
+    if (dew_converter_get_numa_node_stats(converter, i, &node))
+      fmt::print(stderr, "  NUMA node {}:         {} workers, {:.2f} CPU-s, {:.0f}% utilized\n", node.node, node.workers, node.cpu_seconds, node.utilization * 100.0);
+  }
   fmt::print(stderr, "---\n");
 }
 
@@ -187,9 +206,18 @@ struct args_t
   std::string connection;        // --connection spec (inline / @file / env:VAR) for a cloud output URL
   std::string cache;             // --cache: explicit local cache file for a cloud output (destination mode)
   uint64_t cache_max_bytes = 0;  // --cache-max-bytes: resident cap for the cache file; 0 = unlimited
+  std::string input_connection;  // --input-connection spec for s3:// / az:// inputs
+  uint64_t read_window = 0;      // --read-window: ranged-GET size for remote inputs; 0 = default
   dew_converter_compression_t compression;
   bool inspect = false;
+  bool numa = false;             // --numa: one pinned worker pool per NUMA node
+  bool autotune = false;         // --autotune: tune chunk size and stage concurrency while running
+  bool dedup = false;            // --dedup: duplicate-point elimination after the morton sort
+  uint8_t dedup_grid_lod = 0;    // --dedup grid[:N]: also merge points sharing a 2^N-step cell
+  dew_converter_dedup_keep_t dedup_keep = dew_converter_dedup_keep_first;
+  std::vector<std::pair<std::string, double>> precision; // --precision name=tolerance,...
   uint32_t node_point_limit = 0; // points per node / blob-size lever; 0 = converter default
+  uint32_t hierarchy_depth = 0;  // --hierarchy-depth: tree levels in the hierarchy directory; 0 = none
 };
 
 // Byte counts accept an optional K/M/G suffix (binary units).
@@ -212,7 +240,7 @@ uint64_t parse_byte_size(const char *str)
 
 void print_convert_usage()
 {
-  fmt::print(stderr, "Usage: dew convert [options] <input.las|laz> [more inputs ...]\n\n");
+  fmt::print(stderr, "Usage: dew convert [options] <input.las|laz|s3://bucket/input.laz> [more inputs ...]\n\n");
   fmt::print(stderr, "Convert point cloud input into a .dew dataset -- a local packed file or, with a cloud\n");
   fmt::print(stderr, "URL, uploaded incrementally while the conversion runs.\n\n");
   fmt::print(stderr, "Options:\n");
@@ -220,15 +248,23 @@ void print_convert_usage()
   fmt::print(stderr, "  -C, --connection <spec>  connection string for a cloud output (inline / @file / env:VAR)\n");
   fmt::print(stderr, "  -c, --compression <m>    none | zstd | huff0 (default: zstd)\n");
   fmt::print(stderr, "  -n, --node-points <N>    points per octree node (the blob-size lever)\n");
+  fmt::print(stderr, "      --hierarchy-depth <N>  write the top N tree levels as one directory blob (fewer reads at open)\n");
   fmt::print(stderr, "      --cache <path>       explicit local cache file for a cloud output\n");
   fmt::print(stderr, "      --cache-max-bytes <N[K|M|G]>  resident cap for the cache file\n");
+  fmt::print(stderr, "      --input-connection <spec>  connection string for object-store inputs (default: environment)\n");
+  fmt::print(stderr, "      --read-window <N[K|M|G]>   ranged-GET window for object-store inputs (default: 8M)\n");
+  fmt::print(stderr, "      --numa               one pinned worker pool per NUMA node (multi-socket machines)\n");
+  fmt::print(stderr, "      --autotune           tune chunk size and reader/sorter/compressor counts while converting\n");
+  fmt::print(stderr, "      --dedup <mode>       drop duplicate points: exact | grid | grid:N (2^N-step cells; grid = grid:1)\n");
+  fmt::print(stderr, "      --dedup-keep <p>     survivor of a duplicate run: first | last | intensity | gps-time (default: first)\n");
+  fmt::print(stderr, "      --precision <a=t,...>  store attribute a within tolerance t (e.g. gps_time=1e-6,intensity=0)\n");
   fmt::print(stderr, "  -i, --inspect            print a dataset's stats instead of converting\n");
 }
 
 bool parse_arguments(int argc, char **argv, args_t &args, int &exit_code)
 {
   argh::parser cmdl;
-  cmdl.add_params({"-o", "--out", "-u", "--url", "-C", "--connection", "-c", "--compression", "-n", "--node-points", "--cache", "--cache-max-bytes"});
+  cmdl.add_params({"-o", "--out", "-u", "--url", "-C", "--connection", "-c", "--compression", "-n", "--node-points", "--cache", "--cache-max-bytes", "--input-connection", "--read-window", "--dedup", "--dedup-keep", "--precision", "--hierarchy-depth"});
   cmdl.parse(argc, argv);
 
   if (cmdl[{"-h", "--help"}])
@@ -237,7 +273,7 @@ bool parse_arguments(int argc, char **argv, args_t &args, int &exit_code)
     exit_code = 0; // help is not an error
     return false;
   }
-  if (!tool::check_options(cmdl, {"i", "inspect"}, {"o", "out", "u", "url", "C", "connection", "c", "compression", "n", "node-points", "cache", "cache-max-bytes"}))
+  if (!tool::check_options(cmdl, {"i", "inspect", "numa", "autotune"}, {"o", "out", "u", "url", "C", "connection", "c", "compression", "n", "node-points", "cache", "cache-max-bytes", "input-connection", "read-window", "dedup", "dedup-keep", "precision", "hierarchy-depth"}))
     return false;
 
   for (size_t i = 1; i < cmdl.pos_args().size(); i++)
@@ -256,10 +292,84 @@ bool parse_arguments(int argc, char **argv, args_t &args, int &exit_code)
       return false;
     }
   }
+  if (auto v = cmdl("--hierarchy-depth"))
+  {
+    if (!tool::parse_u32(v.str(), args.hierarchy_depth))
+    {
+      fmt::print(stderr, "Error: --hierarchy-depth requires a non-negative integer\n");
+      return false;
+    }
+  }
   args.cache = cmdl("--cache").str();
   if (auto v = cmdl("--cache-max-bytes"))
     args.cache_max_bytes = parse_byte_size(v.str().c_str());
+  args.input_connection = cmdl("--input-connection").str();
+  if (auto v = cmdl("--read-window"))
+    args.read_window = parse_byte_size(v.str().c_str());
   args.inspect = cmdl[{"-i", "--inspect"}];
+  args.numa = cmdl["--numa"];
+  args.autotune = cmdl["--autotune"];
+  if (auto v = cmdl("--dedup"))
+  {
+    const auto mode = v.str();
+    uint32_t grid_lod = 0;
+    bool valid = mode == "exact";
+    if (mode == "grid")
+    {
+      grid_lod = 1;
+      valid = true;
+    }
+    else if (mode.starts_with("grid:"))
+    {
+      valid = tool::parse_u32(mode.substr(5), grid_lod) && grid_lod > 0 && grid_lod < 64;
+    }
+    if (!valid)
+    {
+      fmt::print(stderr, "Error: --dedup expects exact, grid or grid:N (1 <= N < 64)\n");
+      return false;
+    }
+    args.dedup = true;
+    args.dedup_grid_lod = uint8_t(grid_lod);
+  }
+  if (auto v = cmdl("--dedup-keep"))
+  {
+    const auto policy = v.str();
+    if (policy == "first")
+      args.dedup_keep = dew_converter_dedup_keep_first;
+    else if (policy == "last")
+      args.dedup_keep = dew_converter_dedup_keep_last;
+    else if (policy == "intensity")
+      args.dedup_keep = dew_converter_dedup_keep_max_intensity;
+    else if (policy == "gps-time")
+      args.dedup_keep = dew_converter_dedup_keep_latest_gps_time;
+    else
+    {
+      fmt::print(stderr, "Error: --dedup-keep expects first, last, intensity or gps-time\n");
+      return false;
+    }
+  }
+  if (auto v = cmdl("--precision"))
+  {
+    std::string list = v.str();
+    size_t start = 0;
+    while (start <= list.size())
+    {
+      size_t end = list.find(',', start);
+      if (end == std::string::npos)
+        end = list.size();
+      std::string entry = list.substr(start, end - start);
+      size_t eq = entry.find('=');
+      char *parse_end = nullptr;
+      double tolerance = eq != std::string::npos ? std::strtod(entry.c_str() + eq + 1, &parse_end) : -1;
+      if (eq == 0 || eq == std::string::npos || !parse_end || *parse_end || !(tolerance >= 0))
+      {
+        fmt::print(stderr, "Error: --precision expects attribute=tolerance[,attribute=tolerance...] with tolerance >= 0\n");
+        return false;
+      }
+      args.precision.emplace_back(entry.substr(0, eq), tolerance);
+      start = end + 1;
+    }
+  }
 
   return true;
 }
@@ -321,6 +431,17 @@ int cmd_convert(int argc, char **argv)
       return 1;
     }
   }
+  if (!args.input_connection.empty() || args.read_window)
+  {
+    std::string input_connection;
+    std::string conn_error;
+    if (!dew::converter::cli::resolve_connection_spec(args.input_connection, input_connection, conn_error))
+    {
+      fmt::print(stderr, "Input connection error: {}\n", conn_error);
+      return 1;
+    }
+    dew_laszip_set_remote_options(args.read_window, 2, input_connection.data(), input_connection.size());
+  }
   dew_error_t *create_error = nullptr;
   // --cache pins an explicit local cache file for a cloud destination; without it a cloud URL still
   // converts through an implicit cache in the OS cache dir (create_with_connection reroutes).
@@ -351,12 +472,22 @@ int cmd_convert(int argc, char **argv)
   dew_converter_set_compression(converter.get(), args.compression);
   if (args.node_point_limit > 0)
     dew_converter_set_node_point_limit(converter.get(), args.node_point_limit);
+  if (args.hierarchy_depth > 0)
+    dew_converter_set_hierarchy_directory_depth(converter.get(), args.hierarchy_depth);
+  if (args.dedup)
+    dew_converter_set_dedup(converter.get(), 1, args.dedup_grid_lod, args.dedup_keep);
+  for (auto &[name, tolerance] : args.precision)
+    dew_converter_set_attribute_precision(converter.get(), name.data(), uint32_t(name.size()), tolerance);
+  if (args.numa && !dew_converter_set_numa_pools(converter.get(), 1))
+    fmt::print(stderr, "Warning: --numa ignored, fewer than two NUMA nodes found\n");
+  if (args.autotune)
+    dew_converter_set_autotune(converter.get(), 1);
   dew_converter_add_data_file(converter.get(), input_str_buf.data(), int(input_str_buf.size()));
   dew_converter_wait_idle(converter.get());
 
   dew_converter_perf_stats_t perf_stats;
   dew_converter_get_live_perf_stats(converter.get(), &perf_stats);
-  print_perf_stats(perf_stats);
+  print_perf_stats(converter.get(), perf_stats);
 
   dew_converter_stats_t stats;
   dew_converter_get_compression_stats(converter.get(), &stats);
@@ -24,6 +24,9 @@
 // object destinations are always written in the DEW2 layout (one object per blob + band + root
 // manifest, see bucket_format.hpp). Credentials come from a per-side connection string (inline / @file / env:VAR) or
 // the standard AWS_*/AZURE_* environment.
+//
+// Data blobs move through a bounded pipeline (N reads feeding M writes under a byte budget) rather than
+// one round trip at a time; a copy to an object destination can journal its progress and resume.
 
 #include "commands.hpp"
 #include "tool_common.hpp"
@@ -35,6 +38,7 @@
 #include "bucket_format.hpp"
 #include "dataset_types.hpp"
 #include "error.hpp"
+#include "hierarchy_directory.hpp"
 #include "input_storage_map.hpp"
 #include "packed_file_backend.hpp"
 #include "storage_backend.hpp"
@@ -47,10 +51,15 @@
 
 #include <fmt/printf.h>
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -71,8 +80,15 @@ struct copy_args_t
   std::string dest_url;
   std::string source_connection_spec;
   std::string dest_connection_spec;
+  std::string journal_path;
+  uint32_t max_reads = 8;
+  uint32_t max_writes = 8;
+  uint64_t buffer_mb = 256;
+  uint32_t hierarchy_depth = 0;
+  bool hierarchy_depth_set = false; // unset = keep the source's directory depth
   bool force = false;
   bool quiet = false;
+  bool verbose = false;
 };
 
 void print_usage()
@@ -89,7 +105,16 @@ void print_usage()
              "  -s, --source-connection <spec>       connection string for the source store\n"
              "  -d, --destination-connection <spec>  connection string for the destination store\n"
              "  -f, --force                          overwrite the destination if it already exists\n"
+             "      --reads <n>                      data-blob reads in flight (default 8)\n"
+             "      --writes <n>                     data-blob writes in flight (default 8)\n"
+             "      --buffer-mb <MB>                 bytes read but not yet written, at most (default 256)\n"
+             "      --journal <file>                 record written blobs in <file>; re-running the same copy\n"
+             "                                       with it skips them (object destinations only; the\n"
+             "                                       journal is removed when the copy commits)\n"
+             "      --hierarchy-depth <n>            write the top n tree levels as one hierarchy directory blob,\n"
+             "                                       read in one go at open (0 = none; default: as the source)\n"
              "  -q, --quiet                          only print errors\n"
+             "  -v, --verbose                        report throughput and pipeline depth while copying\n"
              "  -h, --help                           show this help\n"
              "\n"
              "A <spec> is an inline connection string (key=value;...), '@path' to read it from a file,\n"
@@ -108,7 +133,7 @@ void print_usage()
 bool parse_args(int argc, char **argv, copy_args_t &args, int &exit_code)
 {
   argh::parser cmdl;
-  cmdl.add_params({"-s", "--source-connection", "-d", "--destination-connection"});
+  cmdl.add_params({"-s", "--source-connection", "-d", "--destination-connection", "--reads", "--writes", "--buffer-mb", "--journal", "--hierarchy-depth"});
   cmdl.parse(argc, argv);
 
   if (cmdl[{"-h", "--help"}])
@@ -117,7 +142,7 @@ bool parse_args(int argc, char **argv, copy_args_t &args, int &exit_code)
     exit_code = 0; // help is not an error
     return false;
   }
-  if (!tool::check_options(cmdl, {"f", "force", "q", "quiet"}, {"s", "source-connection", "d", "destination-connection"}))
+  if (!tool::check_options(cmdl, {"f", "force", "q", "quiet", "v", "verbose"}, {"s", "source-connection", "d", "destination-connection", "reads", "writes", "buffer-mb", "journal", "hierarchy-depth"}))
   {
     exit_code = 1;
     return false;
@@ -132,8 +157,39 @@ bool parse_args(int argc, char **argv, copy_args_t &args, int &exit_code)
   args.dest_url = cmdl[2];
   args.source_connection_spec = cmdl({"-s", "--source-connection"}).str();
   args.dest_connection_spec = cmdl({"-d", "--destination-connection"}).str();
+  args.journal_path = cmdl({"--journal"}).str();
   args.force = cmdl[{"-f", "--force"}];
   args.quiet = cmdl[{"-q", "--quiet"}];
+  args.verbose = cmdl[{"-v", "--verbose"}];
+  std::string text;
+  if (cmdl({"--reads"}) >> text && (!tool::parse_u32(text, args.max_reads) || args.max_reads == 0))
+  {
+    fmt::print(stderr, "Error: --reads needs a positive integer, got '{}'\n", text);
+    exit_code = 1;
+    return false;
+  }
+  if (cmdl({"--writes"}) >> text && (!tool::parse_u32(text, args.max_writes) || args.max_writes == 0))
+  {
+    fmt::print(stderr, "Error: --writes needs a positive integer, got '{}'\n", text);
+    exit_code = 1;
+    return false;
+  }
+  if (cmdl({"--buffer-mb"}) >> text && (!tool::parse_u64(text, args.buffer_mb) || args.buffer_mb == 0))
+  {
+    fmt::print(stderr, "Error: --buffer-mb needs a positive size in MB, got '{}'\n", text);
+    exit_code = 1;
+    return false;
+  }
+  if (cmdl({"--hierarchy-depth"}) >> text)
+  {
+    if (!tool::parse_u32(text, args.hierarchy_depth))
+    {
+      fmt::print(stderr, "Error: --hierarchy-depth needs a non-negative integer, got '{}'\n", text);
+      exit_code = 1;
+      return false;
+    }
+    args.hierarchy_depth_set = true;
+  }
   return true;
 }
 
@@ -203,8 +259,379 @@ vio::task_t<dew_error_t> collect_source(storage_backend_t *src, tree_registry_t
   co_return dew_error_t{};
 }
 
+// The copy's hierarchy directory, built from the trees AFTER their storage maps were remapped so it
+// describes the destination. Null when `depth` is zero.
+serialized_tree_registry_t build_hierarchy_directory(const tree_registry_t *registry, const std::vector<std::pair<uint32_t, std::shared_ptr<tree_t>>> &trees, uint32_t depth)
+{
+  std::vector<const tree_t *> by_id(registry->locations.size(), nullptr);
+  for (auto &[i, tree] : trees)
+    by_id[i] = tree.get();
+  return hierarchy_directory_serialize(registry->root, depth, [&by_id](tree_id_t id) -> const tree_t * { return id.data < by_id.size() ? by_id[id.data] : nullptr; });
+}
+
+static dew_error_t to_points_error(const vio::error_t &e)
+{
+  return dew_error_t{e.code != 0 ? e.code : -1, e.msg};
+}
+
+// Where the data blobs go: a storage backend (packed destination: allocate_blob + write_allocated) or a
+// DEW2 bucket, where data blob i of the sorted unique-blob list becomes object data/{i:08x}. That fixed
+// numbering is what makes an object copy resumable: a re-run puts every blob under the same name.
+struct blob_sink_t
+{
+  storage_backend_t *backend = nullptr;
+  vio::objstore::io_manager_t *io = nullptr;
+};
+
+// Knobs for copy_data_blobs, filled from the command line. `journal_identity` is the part of the journal
+// header fixed before the source is enumerated (the urls); the blob count and bytes are appended to it.
+// `hierarchy_depth` is the copy's own: the tree levels its hierarchy directory holds (0 = none).
+struct pipeline_options_t
+{
+  uint32_t max_reads = 8;
+  uint32_t max_writes = 8;
+  uint64_t max_buffered = 256ull << 20;
+  bool verbose = false;
+  std::string journal_path;
+  std::string journal_identity;
+  uint32_t hierarchy_depth = 0;
+};
+
+// Progress journal of a resumable copy to an object destination. Line one identifies the copy (urls, blob
+// count, total bytes); every later line is the index of a data blob whose write completed. Since object
+// ids are fixed per blob (see blob_sink_t) that is all a resumed run needs to skip it. A torn last line
+// from a killed run parses as garbage and is ignored -- that blob is simply written again.
+class copy_journal_t
+{
+public:
+  ~copy_journal_t()
+  {
+    if (_file)
+      fclose(_file);
+  }
+
+  dew_error_t open(const std::string &path, const std::string &identity, size_t blob_count)
+  {
+    _path = path;
+    _done.assign(blob_count, 0);
+    if (FILE *existing = fopen(path.c_str(), "r"))
+    {
+      std::string line;
+      bool first = true;
+      bool matches = true;
+      while (read_line(existing, line))
+      {
+        if (first)
+        {
+          first = false;
+          matches = line == identity;
+          if (!matches)
+            break;
+          continue;
+        }
+        char *end = nullptr;
+        unsigned long long index = strtoull(line.c_str(), &end, 10);
+        if (end == line.c_str() || *end != '\0' || index >= blob_count || _done[index])
+          continue;
+        _done[index] = 1;
+        _done_count++;
+      }
+      fclose(existing);
+      if (!first && !matches)
+        return dew_error_t{-1, fmt::format("journal '{}' belongs to a different copy; delete it to start over", path)};
+      _file = fopen(path.c_str(), "a");
+      if (_file && first)
+        fmt::print(_file, "{}\n", identity);
+    }
+    else
+    {
+      _file = fopen(path.c_str(), "w");
+      if (_file)
+        fmt::print(_file, "{}\n", identity);
+    }
+    if (!_file)
+      return dew_error_t{-1, fmt::format("cannot open journal '{}' for writing", path)};
+    fflush(_file);
+    return dew_error_t{};
+  }
+
+  [[nodiscard]] bool done(size_t index) const
+  {
+    return index < _done.size() && _done[index];
+  }
+  [[nodiscard]] size_t done_count() const
+  {
+    return _done_count;
+  }
+  // Called as each write completes; flushed so a kill loses at most the line being written.
+  void record(uint32_t index)
+  {
+    fmt::print(_file, "{}\n", index);
+    fflush(_file);
+  }
+  // The copy committed: nothing left to resume.
+  void remove()
+  {
+    if (_file)
+      fclose(_file);
+    _file = nullptr;
+    std::remove(_path.c_str());
+  }
+
+private:
+  static bool read_line(FILE *file, std::string &line)
+  {
+    line.clear();
+    int c;
+    while ((c = fgetc(file)) != EOF && c != '\n')
+      line.push_back(char(c));
+    return c != EOF || !line.empty();
+  }
+
+  FILE *_file = nullptr;
+  std::string _path;
+  std::vector<uint8_t> _done;
+  size_t _done_count = 0;
+};
+
+// The bounded read -> write pipeline for data blobs: upload_handler_t's put_window_t with a read stage in
+// front. One driver coroutine (copy_data_blobs) launches detached reads and writes on the event loop and
+// parks on the window until one of them completes; coroutines interleave at co_await points, no threads
+// involved. Reads are admitted while fewer than max_reads are in flight and the bytes held between a read
+// starting and its write finishing stay under max_buffered (a single blob larger than that is admitted on
+// its own), so a slow destination throttles the reads instead of piling blobs up in memory. The detached
+// tasks reference the window: the driver drains it before EVERY exit.
+struct transfer_window_t
+{
+  struct job_t
+  {
+    uint32_t index;
+    storage_location_t source;
+    std::shared_ptr<uint8_t[]> data;
+  };
+
+  int reads_in_flight = 0;
+  int writes_in_flight = 0;
+  uint64_t bytes_buffered = 0;
+  std::deque<job_t> ready;                 // read, waiting for a write slot
+  std::vector<storage_location_t> written; // by blob index, size 0 until its write completed
+  dew_error_t first_error = {};
+  uint64_t completions = 0;
+  std::coroutine_handle<> waiter = {};
+
+  // -v reporting.
+  uint64_t bytes_written = 0;
+  uint64_t blobs_written = 0;
+  int peak_reads = 0;
+  int peak_writes = 0;
+  uint64_t peak_buffered = 0;
+
+  struct progress_awaiter_t
+  {
+    transfer_window_t &window;
+    uint64_t seen;
+    [[nodiscard]] bool await_ready() const
+    {
+      return window.completions != seen;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      window.waiter = handle;
+    }
+    void await_resume() const
+    {
+    }
+  };
+  // Suspend until some read or write completes after `seen` was sampled from `completions` (returns at
+  // once if one already has -- a mem:// store completes inside the launch).
+  [[nodiscard]] progress_awaiter_t wait_for_progress(uint64_t seen)
+  {
+    return progress_awaiter_t{*this, seen};
+  }
+  void completed()
+  {
+    completions++;
+    if (waiter)
+    {
+      auto handle = waiter;
+      waiter = {};
+      handle.resume(); // the driver re-evaluates the window in its loop
+    }
+  }
+};
+
+vio::detached_task_t read_windowed(transfer_window_t *window, storage_backend_t *src, uint32_t index, storage_location_t location)
+{
+  std::shared_ptr<uint8_t[]> buffer(new uint8_t[location.size]);
+  uint32_t bytes_read = 0;
+  auto err = co_await src->read_blob(location, buffer.get(), bytes_read);
+  if (err.code == 0)
+  {
+    window->ready.push_back(transfer_window_t::job_t{index, location, std::move(buffer)});
+  }
+  else
+  {
+    if (window->first_error.code == 0)
+      window->first_error = err;
+    window->bytes_buffered -= location.size;
+  }
+  window->reads_in_flight--;
+  window->completed();
+}
+
+vio::detached_task_t write_windowed(transfer_window_t *window, blob_sink_t sink, copy_journal_t *journal, uint32_t index, storage_location_t target, std::shared_ptr<uint8_t[]> data)
+{
+  dew_error_t err = {};
+  if (sink.backend)
+  {
+    err = co_await sink.backend->write_allocated(target, std::move(data));
+  }
+  else
+  {
+    auto r = co_await sink.io->write_object(bucket_data_object_name(target.file_id), std::move(data), target.size);
+    if (!r.has_value())
+      err = to_points_error(r.error());
+  }
+  if (err.code == 0)
+  {
+    window->written[index] = target;
+    window->bytes_written += target.size;
+    window->blobs_written++;
+    if (journal)
+      journal->record(index);
+  }
+  else if (window->first_error.code == 0)
+  {
+    window->first_error = err;
+  }
+  window->bytes_buffered -= target.size;
+  window->writes_in_flight--;
+  window->completed();
+}
+
+// Step 2 of every copy: move the unique data blobs verbatim to `sink` through a transfer_window_t and
+// fill `remap` (old -> new location). `blob_count` counts every data blob in the destination; `resumed_count`
+// (optional) the ones among them a journal says an earlier run already wrote, which this run skipped.
+vio::task_t<dew_error_t> copy_data_blobs(storage_backend_t *src, blob_sink_t sink, const pipeline_options_t *options, const std::map<blob_key_t, storage_location_t> *unique_blobs,
+                                         std::map<blob_key_t, storage_location_t> *remap, copy_journal_t *journal, uint64_t *blob_count, uint64_t *resumed_count)
+{
+  std::vector<std::pair<blob_key_t, storage_location_t>> blobs(unique_blobs->begin(), unique_blobs->end());
+  uint64_t total_bytes = 0;
+  for (const auto &[key, loc] : blobs)
+    total_bytes += loc.size;
+
+  copy_journal_t *active_journal = nullptr;
+  if (!options->journal_path.empty())
+  {
+    auto identity = fmt::format("{} {} {}", options->journal_identity, blobs.size(), total_bytes);
+    if (auto e = journal->open(options->journal_path, identity, blobs.size()); e.code != 0)
+      co_return e;
+    active_journal = journal;
+  }
+
+  transfer_window_t window;
+  window.written.resize(blobs.size());
+  uint64_t resumed_bytes = 0;
+  for (size_t i = 0; active_journal && i < blobs.size(); ++i)
+  {
+    if (!active_journal->done(i))
+      continue;
+    auto &loc = window.written[i];
+    loc.file_id = uint32_t(i);
+    loc.offset = 0;
+    loc.size = blobs[i].second.size;
+    resumed_bytes += loc.size;
+  }
+  if (options->verbose && active_journal && active_journal->done_count())
+    fmt::print("resuming: {} of {} data blobs ({}) already written\n", active_journal->done_count(), blobs.size(), tool::format_bytes(resumed_bytes));
+
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  auto last_report = start;
+  auto report = [&](const char *label) {
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+    const uint64_t rate = seconds > 0 ? uint64_t(double(window.bytes_written) / seconds) : 0;
+    fmt::print("{} {}/{} blobs, {} of {}, {}/s | in flight: {} reads, {} writes, {} buffered\n", label, window.blobs_written + (active_journal ? active_journal->done_count() : 0), blobs.size(),
+               tool::format_bytes(window.bytes_written + resumed_bytes), tool::format_bytes(total_bytes), tool::format_bytes(rate), window.reads_in_flight, window.writes_in_flight,
+               tool::format_bytes(window.bytes_buffered));
+  };
+
+  size_t next_read = 0;
+  while (true)
+  {
+    const uint64_t seen = window.completions;
+    bool launched = false;
+    if (window.first_error.code == 0)
+    {
+      while (!window.ready.empty() && window.writes_in_flight < int(options->max_writes))
+      {
+        auto job = std::move(window.ready.front());
+        window.ready.pop_front();
+        storage_location_t target;
+        if (sink.backend)
+        {
+          sink.backend->allocate_blob(job.source.size, storage_backend_t::blob_kind_t::data, target);
+        }
+        else
+        {
+          target.file_id = job.index;
+          target.offset = 0;
+          target.size = job.source.size;
+        }
+        window.writes_in_flight++;
+        window.peak_writes = std::max(window.peak_writes, window.writes_in_flight);
+        write_windowed(&window, sink, active_journal, job.index, target, std::move(job.data));
+        launched = true;
+      }
+      while (next_read < blobs.size() && window.reads_in_flight < int(options->max_reads))
+      {
+        if (active_journal && active_journal->done(next_read))
+        {
+          next_read++;
+          continue;
+        }
+        const storage_location_t source = blobs[next_read].second;
+        if (window.bytes_buffered != 0 && window.bytes_buffered + source.size > options->max_buffered)
+          break;
+        window.bytes_buffered += source.size;
+        window.peak_buffered = std::max(window.peak_buffered, window.bytes_buffered);
+        window.reads_in_flight++;
+        window.peak_reads = std::max(window.peak_reads, window.reads_in_flight);
+        read_windowed(&window, src, uint32_t(next_read), source);
+        next_read++;
+        launched = true;
+      }
+    }
+    const bool idle = window.reads_in_flight == 0 && window.writes_in_flight == 0;
+    if (idle && (window.first_error.code != 0 || (window.ready.empty() && next_read == blobs.size())))
+      break;
+    if (options->verbose && clock::now() - last_report >= std::chrono::seconds(1))
+    {
+      last_report = clock::now();
+      report("  copying:");
+    }
+    if (!launched)
+      co_await window.wait_for_progress(seen);
+  }
+  if (window.first_error.code != 0)
+    co_return window.first_error;
+
+  for (size_t i = 0; i < blobs.size(); ++i)
+    (*remap)[blobs[i].first] = window.written[i];
+  *blob_count = blobs.size();
+  if (resumed_count)
+    *resumed_count = active_journal ? active_journal->done_count() : 0;
+  if (options->verbose)
+  {
+    report("  done:");
+    fmt::print("  peak in flight: {} reads, {} writes, {} buffered (limits {} / {} / {})\n", window.peak_reads, window.peak_writes, tool::format_bytes(window.peak_buffered), options->max_reads,
+               options->max_writes, tool::format_bytes(options->max_buffered));
+  }
+  co_return dew_error_t{};
+}
+
 // The copy itself, run on the event-loop thread. src/dst/load/registry outlive it (main blocks).
-vio::task_t<dew_error_t> do_copy(storage_backend_t *src, storage_backend_t *dst, index_load_t *load, tree_registry_t *registry, uint64_t *blob_count, uint64_t *tree_count)
+vio::task_t<dew_error_t> do_copy(storage_backend_t *src, storage_backend_t *dst, index_load_t *load, tree_registry_t *registry, const pipeline_options_t *options, uint64_t *blob_count, uint64_t *tree_count)
 {
   // 1. Enumerate trees + the unique data blobs they reference.
   std::vector<std::pair<uint32_t, std::shared_ptr<tree_t>>> trees;
@@ -212,21 +639,13 @@ vio::task_t<dew_error_t> do_copy(storage_backend_t *src, storage_backend_t *dst,
   if (auto e = co_await collect_source(src, registry, trees, unique_blobs); e.code != 0)
     co_return e;
 
-  // 2. Copy each unique data blob verbatim into the destination; remember old -> new location.
+  // 2. Copy each unique data blob verbatim into the destination; remember old -> new location. A packed
+  //    destination is truncated on open, so there is no journal to resume from.
   std::map<blob_key_t, storage_location_t> remap;
-  for (const auto &[key, src_loc] : unique_blobs)
-  {
-    std::shared_ptr<uint8_t[]> buffer(new uint8_t[src_loc.size]);
-    uint32_t bytes_read = 0;
-    if (auto e = co_await src->read_blob(src_loc, buffer.get(), bytes_read); e.code != 0)
-      co_return e;
-    storage_location_t new_loc;
-    dst->allocate_blob(src_loc.size, storage_backend_t::blob_kind_t::data, new_loc);
-    if (auto e = co_await dst->write_allocated(new_loc, buffer); e.code != 0)
-      co_return e;
-    remap[key] = new_loc;
-    ++*blob_count;
-  }
+  blob_sink_t sink;
+  sink.backend = dst;
+  if (auto e = co_await copy_data_blobs(src, sink, options, &unique_blobs, &remap, nullptr, blob_count, nullptr); e.code != 0)
+    co_return e;
 
   // 3. Rewrite each tree's storage locations in place (preserving attributes_id + the serialized
   //    ref_counts -- a rebuild via add_storage would reset every ref_count to 1 and corrupt the copy on
@@ -249,6 +668,15 @@ vio::task_t<dew_error_t> do_copy(storage_backend_t *src, storage_backend_t *dst,
     registry->locations[i] = tree_loc;
     ++*tree_count;
   }
+  registry->hierarchy_directory = {};
+  if (auto directory = build_hierarchy_directory(registry, trees, options->hierarchy_depth); directory.data)
+  {
+    storage_location_t directory_loc;
+    dst->allocate_blob(uint32_t(directory.size), storage_backend_t::blob_kind_t::metadata, directory_loc);
+    if (auto e = co_await dst->write_allocated(directory_loc, directory.data); e.code != 0)
+      co_return e;
+    registry->hierarchy_directory = directory_loc;
+  }
 
   // 4. Serialize + write the tree registry. The copy is not bound to any bucket (no dataset uuid /
   //    residency travels with it), so bucket-mirror states must not dangle: demote uploaded -> final
@@ -281,11 +709,6 @@ vio::task_t<dew_error_t> do_copy(storage_backend_t *src, storage_backend_t *dst,
   co_return co_await dst->write_index(std::move(checkpoint));
 }
 
-static dew_error_t to_points_error(const vio::error_t &e)
-{
-  return dew_error_t{e.code != 0 ? e.code : -1, e.msg};
-}
-
 // PUT one data object data/{object_id:08x} whose content is exactly `bytes`.
 vio::task_t<dew_error_t> dew2_put_object(vio::objstore::io_manager_t *io, uint32_t object_id, const uint8_t *bytes, uint32_t size, uint64_t *object_count)
 {
@@ -312,9 +735,10 @@ vio::task_t<dew_error_t> dew2_probe_manifest(vio::objstore::io_manager_t *io, bo
 // bytes, storage_location_t = {object_id, 0, size} -- whole-object reads, no ranges), one band
 // manifest covering everything, then the root manifest (complete=1) as the atomic commit point.
 // Mirrors upload_handler_t's commit order (data objects < band < root); deterministic object-id
-// assignment means a re-run overwrites its own orphans. A fresh uuid is minted by the caller -- a
-// copy is a new dataset generation, resumable by no cache.
-vio::task_t<dew_error_t> do_copy_dew2(storage_backend_t *src, vio::objstore::io_manager_t *io, index_load_t *load, tree_registry_t *registry, const uint8_t (&uuid)[16], uint64_t *blob_count, uint64_t *tree_count, uint64_t *object_count)
+// assignment means a re-run overwrites its own orphans, and lets a journaled re-run skip the data
+// objects an interrupted one already wrote. A fresh uuid is minted by the caller -- a copy is a new
+// dataset generation, resumable by no cache.
+vio::task_t<dew_error_t> do_copy_dew2(storage_backend_t *src, vio::objstore::io_manager_t *io, index_load_t *load, tree_registry_t *registry, const uint8_t (&uuid)[16], const pipeline_options_t *options, uint64_t *blob_count, uint64_t *resumed_count, uint64_t *tree_count, uint64_t *object_count)
 {
   // 1. Enumerate trees + the unique data blobs they reference.
   std::vector<std::pair<uint32_t, std::shared_ptr<tree_t>>> trees;
@@ -322,7 +746,16 @@ vio::task_t<dew_error_t> do_copy_dew2(storage_backend_t *src, vio::objstore::io_
   if (auto e = co_await collect_source(src, registry, trees, unique_blobs); e.code != 0)
     co_return e;
 
-  uint32_t next_object_id = 0;
+  // 2. Data blobs, verbatim, one object each: blob i of unique_blobs is object i (see blob_sink_t).
+  std::map<blob_key_t, storage_location_t> remap;
+  copy_journal_t journal;
+  blob_sink_t sink;
+  sink.io = io;
+  if (auto e = co_await copy_data_blobs(src, sink, options, &unique_blobs, &remap, &journal, blob_count, resumed_count); e.code != 0)
+    co_return e;
+  *object_count += *blob_count - *resumed_count; // only the objects this run put
+
+  uint32_t next_object_id = uint32_t(unique_blobs.size());
   auto put_bytes = [&](const uint8_t *bytes, uint32_t size, storage_location_t &out) -> vio::task_t<dew_error_t> {
     out.file_id = next_object_id++;
     out.offset = 0;
@@ -330,22 +763,6 @@ vio::task_t<dew_error_t> do_copy_dew2(storage_backend_t *src, vio::objstore::io_
     co_return co_await dew2_put_object(io, out.file_id, bytes, size, object_count);
   };
 
-  // 2. Data blobs, verbatim, one object each.
-  std::map<blob_key_t, storage_location_t> remap;
-  std::vector<uint8_t> blob_bytes;
-  for (const auto &[key, src_loc] : unique_blobs)
-  {
-    blob_bytes.resize(src_loc.size);
-    uint32_t bytes_read = 0;
-    if (auto e = co_await src->read_blob(src_loc, blob_bytes.data(), bytes_read); e.code != 0)
-      co_return e;
-    storage_location_t bucket_location;
-    if (auto e = co_await put_bytes(blob_bytes.data(), src_loc.size, bucket_location); e.code != 0)
-      co_return e;
-    remap[key] = bucket_location;
-    ++*blob_count;
-  }
-
   // 3. Trees: remap the storage maps to object locations (preserving ref_counts, as in do_copy),
   //    re-serialize, append. The registry mirrors the bucket state: everything uploaded, band 0.
   band_manifest_t band;
@@ -370,6 +787,14 @@ vio::task_t<dew_error_t> do_copy_dew2(storage_backend_t *src, vio::objstore::io_
     band.trees.push_back(band_tree_entry_t{i, tree_loc});
     ++*tree_count;
   }
+  registry->hierarchy_directory = {};
+  if (auto directory = build_hierarchy_directory(registry, trees, options->hierarchy_depth); directory.data)
+  {
+    storage_location_t directory_loc;
+    if (auto e = co_await put_bytes(directory.data.get(), uint32_t(directory.size), directory_loc); e.code != 0)
+      co_return e;
+    registry->hierarchy_directory = directory_loc;
+  }
 
   // 4. Registry + the metadata payloads (verbatim), each as its own object. Unlike incremental uploads,
   //    a copy has the source's stats/perf at hand, so the bucket carries them too.
@@ -426,6 +851,8 @@ vio::task_t<dew_error_t> do_copy_dew2(storage_backend_t *src, vio::objstore::io_
   auto r = co_await io->write_object(bucket_root_manifest_name(), std::move(root_data), k_root_manifest_size);
   if (!r.has_value())
     co_return to_points_error(r.error());
+  if (!options->journal_path.empty())
+    journal.remove();
   co_return dew_error_t{};
 }
 
@@ -473,6 +900,12 @@ int cmd_copy(int argc, char **argv)
   const auto parsed_dest = parse_url(args.dest_url);
   const bool dest_is_object = !parsed_dest.scheme.empty() && parsed_dest.scheme != "file";
 
+  if (!args.journal_path.empty() && !dest_is_object)
+  {
+    fmt::print(stderr, "--journal needs an object destination (a packed file destination is rewritten from scratch)\n");
+    return 1;
+  }
+
   std::unique_ptr<storage_backend_t> dst;
   std::unique_ptr<vio::objstore::io_manager_t> dest_io;
   if (dest_is_object)
@@ -554,7 +987,34 @@ int cmd_copy(int argc, char **argv)
     return 1;
   }
 
+  pipeline_options_t pipeline;
+  pipeline.max_reads = args.max_reads;
+  pipeline.max_writes = args.max_writes;
+  pipeline.max_buffered = args.buffer_mb << 20;
+  pipeline.verbose = args.verbose && !args.quiet;
+  pipeline.journal_path = args.journal_path;
+  pipeline.journal_identity = fmt::format("dew-copy-journal 1 {} {}", args.source_url, args.dest_url);
+  pipeline.hierarchy_depth = args.hierarchy_depth;
+  // Without --hierarchy-depth a source that carries a hierarchy directory keeps one at the same depth;
+  // only its header is needed. Unreadable is not fatal -- the copy just goes without.
+  if (!args.hierarchy_depth_set && registry.hierarchy_directory.size != 0)
+  {
+    const auto location = registry.hierarchy_directory;
+    auto buffer = std::make_shared<std::vector<uint8_t>>(location.size);
+    uint32_t bytes_read = 0;
+    err = run_on_loop_blocking(loop, [src_ptr = src.get(), location, buffer, read = &bytes_read]() -> vio::task_t<dew_error_t> { return src_ptr->read_blob(location, buffer->data(), *read); });
+    uint32_t depth = 0;
+    std::vector<hierarchy_directory_entry_t> entries;
+    if (err.code == 0)
+      err = hierarchy_directory_parse(buffer->data(), bytes_read, depth, entries);
+    if (err.code == 0)
+      pipeline.hierarchy_depth = depth;
+    else if (!args.quiet)
+      fmt::print(stderr, "warning: cannot read the source hierarchy directory, the copy has none: {}\n", err.msg);
+  }
+
   uint64_t blob_count = 0;
+  uint64_t resumed_count = 0;
   uint64_t tree_count = 0;
   uint64_t object_count = 0;
   storage_backend_t *src_ptr = src.get();
@@ -566,15 +1026,15 @@ int cmd_copy(int argc, char **argv)
     std::random_device rd;
     for (auto &b : uuid)
       b = uint8_t(rd());
-    copy_err = run_on_loop_blocking(loop, [src_ptr, io_ptr = dest_io.get(), load_ptr = &load, registry_ptr = &registry, &uuid, blobs = &blob_count, trees = &tree_count, objects = &object_count]() -> vio::task_t<dew_error_t> {
-      return do_copy_dew2(src_ptr, io_ptr, load_ptr, registry_ptr, uuid, blobs, trees, objects);
+    copy_err = run_on_loop_blocking(loop, [src_ptr, io_ptr = dest_io.get(), load_ptr = &load, registry_ptr = &registry, &uuid, options = &pipeline, blobs = &blob_count, resumed = &resumed_count, trees = &tree_count, objects = &object_count]() -> vio::task_t<dew_error_t> {
+      return do_copy_dew2(src_ptr, io_ptr, load_ptr, registry_ptr, uuid, options, blobs, resumed, trees, objects);
     });
   }
   else
   {
     storage_backend_t *dst_ptr = dst.get();
-    copy_err = run_on_loop_blocking(loop, [src_ptr, dst_ptr, load_ptr = &load, registry_ptr = &registry, blobs = &blob_count, treees = &tree_count]() -> vio::task_t<dew_error_t> {
-      return do_copy(src_ptr, dst_ptr, load_ptr, registry_ptr, blobs, treees);
+    copy_err = run_on_loop_blocking(loop, [src_ptr, dst_ptr, load_ptr = &load, registry_ptr = &registry, options = &pipeline, blobs = &blob_count, treees = &tree_count]() -> vio::task_t<dew_error_t> {
+      return do_copy(src_ptr, dst_ptr, load_ptr, registry_ptr, options, blobs, treees);
     });
   }
   if (copy_err.code != 0)
@@ -585,7 +1045,9 @@ int cmd_copy(int argc, char **argv)
 
   if (!args.quiet)
   {
-    if (dest_is_object)
+    if (dest_is_object && resumed_count != 0)
+      fmt::print("Copied {} data blobs ({} resumed from the journal) + {} trees as {} new objects: {} -> {} (DEW2)\n", blob_count, resumed_count, tree_count, object_count, args.source_url, args.dest_url);
+    else if (dest_is_object)
       fmt::print("Copied {} data blobs + {} trees as {} objects: {} -> {} (DEW2)\n", blob_count, tree_count, object_count, args.source_url, args.dest_url);
     else
       fmt::print("Copied {} data blobs + {} trees: {} -> {}\n", blob_count, tree_count, args.source_url, args.dest_url);
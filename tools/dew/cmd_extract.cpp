@@ -11,6 +11,7 @@
 #include <dataset_types.hpp>
 #include <attributes_configs.hpp>
 #include <tree.hpp>
+#include <tree_registry_journal.hpp>
 #include <compressor.hpp>
 #include <input_header.hpp>
 
@@ -526,7 +527,33 @@ vio::task_t<void> run_extract(vio::event_loop_t &event_loop, extract_args_t args
       co_return;
     }
 
-    auto tree_reg_err = tree_registry_deserialize(tree_reg_blob, tree_registry_loc.size, tree_registry);
+    // A journaled registry: the index points at a manifest; replay its records into one blob.
+    uint32_t tree_reg_size = tree_registry_loc.size;
+    if (tree_registry_journal_is_manifest(tree_reg_blob.get(), tree_reg_size))
+    {
+      std::vector<storage_location_t> record_locations;
+      auto manifest_err = tree_registry_journal_parse_manifest(tree_reg_blob.get(), tree_reg_size, record_locations);
+      std::vector<tree_registry_journal_blob_t> records(record_locations.size());
+      for (size_t i = 0; manifest_err.code == 0 && i < records.size(); i++)
+      {
+        records[i].size = record_locations[i].size;
+        records[i].data = std::make_unique<uint8_t[]>(records[i].size);
+        auto record_read = co_await vio::read_file(event_loop, *dew_file, records[i].data.get(), records[i].size, int64_t(record_locations[i].offset));
+        if (!record_read.has_value() || record_read.value() != records[i].size)
+          manifest_err = {1, "failed to read a journal record"};
+      }
+      if (manifest_err.code == 0)
+        manifest_err = tree_registry_journal_replay(records, tree_reg_blob, tree_reg_size);
+      if (manifest_err.code != 0)
+      {
+        fmt::print(stderr, "Error: failed to replay tree registry journal: {}\n", manifest_err.msg);
+        exit_code = 1;
+        event_loop.stop();
+        co_return;
+      }
+    }
+
+    auto tree_reg_err = tree_registry_deserialize(tree_reg_blob, tree_reg_size, tree_registry);
     if (tree_reg_err.code != 0)
     {
       fmt::print(stderr, "Error: failed to deserialize tree registry: {}\n", tree_reg_err.msg);
@@ -243,6 +243,8 @@ int cmd_info(int argc, char **argv)
     fmt::print("Input files:   {}\n", format_number(stats.input_file_count));
     if (stats.input_file_size_bytes > 0)
       fmt::print("Source size:   {}\n", format_bytes(stats.input_file_size_bytes));
+    if (stats.duplicate_points_removed > 0)
+      fmt::print("Duplicates:    {} points removed\n", format_number(stats.duplicate_points_removed));
     if (has_lod)
       fmt::print("Total buffers: {} ({} source, {} LOD)\n",
                  format_number(stats.total_buffer_count),
@@ -402,6 +404,14 @@ int cmd_info(int argc, char **argv)
           fmt::print("    Read cache:        {} hits, {} misses ({:.1f}% hit rate)\n", perf.cache_hits, perf.cache_misses, hit_rate);
         }
       }
+      if (perf.buffer_pool_hits > 0 || perf.buffer_pool_misses > 0)
+        fmt::print("  Buffer pool:         {} reused, {} allocated ({:.2f}s in allocator), peak {:.1f} MB in use\n", perf.buffer_pool_hits, perf.buffer_pool_misses, perf.allocation_seconds,
+                   double(perf.peak_buffer_bytes) / (1024.0 * 1024.0));
+      if (perf.peak_rss_bytes > 0)
+        fmt::print("  Peak RSS:            {:.1f} MB\n", double(perf.peak_rss_bytes) / (1024.0 * 1024.0));
+      if (perf.autotuned)
+        fmt::print("  Autotune:            {} MiB chunks, {} readers, {} sorters, {} compressors ({} changes)\n", perf.autotune_read_chunk_bytes >> 20, perf.autotune_max_readers, perf.autotune_max_sorters,
+                   perf.autotune_max_compressors, perf.autotune_decisions);
     }
 
     if (arg + 1 < files.size())
@@ -48,12 +48,27 @@ struct query_args_t
   dew_lod_mode_t lod_mode = dew_lod_full;
   int32_t level = 0;
   uint64_t max_points = 0;
+  uint64_t seed = 0;
   dew_clip_mode_t clip_mode = dew_clip_point;
   dew_position_format_t position_format = dew_position_r64_absolute;
   std::vector<std::string> attributes;
+  struct predicate_t
+  {
+    std::string attribute;
+    dew_predicate_op_t op = dew_predicate_range;
+    double min = 0;
+    double max = 0;
+    std::vector<double> values;
+  };
+  std::vector<predicate_t> predicates;
+  dew_region_shape_t shape = dew_region_box;
+  std::vector<double> vertices;
+  double radius = 0;
+  double z_range[2] = {0, 0};
   std::string out_path;
   bool csv = false;
   bool stats_only = false;
+  bool verbose = false;
 };
 
 void print_usage()
@@ -66,19 +81,34 @@ local packed file, this works against any dataset URL and returns decoded coordi
 Options:
   --aabb minx,miny,minz,maxx,maxy,maxz   the box (default: the whole dataset)
   --attributes a,b,c                     attributes to fetch alongside the positions
-  --lod full|<level>|budget:<n>          how far to descend (default: full resolution)
+  --lod full|<level>|budget:<n>|sample:<n>
+                                         how far to descend (default: full resolution);
+                                         sample:<n> draws exactly n points uniformly at random
+  --seed N                               the seed of a sample:<n> draw (default: 0)
   --clip node|point                      whole overlapping nodes, or exactly the points
                                          inside the box (default: point)
   --position r64|r32|i32                 coordinate format (default: r64, lossless)
+  --where "a=lo..hi;b=v,v;c!=v,v"        keep only points whose attributes pass every
+                                         filter: a range, a value set, or an excluded set
+  --polygon x,y,x,y,x,y,...              keep only points inside this polygon (in x/y)
+  --corridor r:x,y,x,y,...               keep only points within r of this polyline (in x/y)
+  --zrange lo,hi                         limit --polygon / --corridor to lo <= z <= hi
   --connection SPEC                      cloud credentials for s3:// / az:// datasets
   --stats                                print counts only, no point data
+  -v, --verbose                          also print how the request went: nodes walked and
+                                         read, blobs and bytes, cache hits, peak reads in
+                                         flight, and where the time went
   --csv                                  write CSV instead of raw binary
   -o FILE                                write to FILE instead of stdout
 
 Examples:
   dew query scan.dew --stats
+  dew query s3://bucket/scan --aabb 0,0,0,50,50,20 --stats -v
   dew query scan.dew --aabb 0,0,0,50,50,20 --attributes intensity --csv -o box.csv
+  dew query scan.dew --where "classification=2,6" --attributes classification --stats
+  dew query scan.dew --corridor 2.5:0,0,100,40,180,40 --zrange 0,30 --stats
   dew query s3://bucket/scan --aabb 0,0,0,10,10,10 --lod budget:100000 --stats
+  dew query scan.dew --lod sample:1000000 --seed 7 --attributes classification -o train.bin
 )");
 }
 
@@ -129,6 +159,37 @@ std::vector<std::string> split_commas(const std::string &text)
   return out;
 }
 
+// One --where filter: "name=lo..hi", "name=v,v,..." or "name!=v,v,...".
+bool parse_predicate(const std::string &text, query_args_t::predicate_t &out)
+{
+  const size_t eq = text.find('=');
+  if (eq == std::string::npos || eq == 0)
+    return false;
+  const bool negate = text[eq - 1] == '!';
+  out.attribute = text.substr(0, negate ? eq - 1 : eq);
+  const std::string value_text = text.substr(eq + 1);
+  auto parse_number = [](const std::string &token, double &value) {
+    char *end = nullptr;
+    value = std::strtod(token.c_str(), &end);
+    return !token.empty() && end == token.c_str() + token.size();
+  };
+  const size_t dots = value_text.find("..");
+  if (dots != std::string::npos)
+  {
+    out.op = dew_predicate_range;
+    return !negate && !out.attribute.empty() && parse_number(value_text.substr(0, dots), out.min) && parse_number(value_text.substr(dots + 2), out.max);
+  }
+  out.op = negate ? dew_predicate_not_in : dew_predicate_in;
+  for (const auto &token : split_commas(value_text))
+  {
+    double value = 0;
+    if (!parse_number(token, value))
+      return false;
+    out.values.push_back(value);
+  }
+  return !out.attribute.empty() && !out.values.empty();
+}
+
 const char *type_name(dew_type_t type)
 {
   switch (type)
@@ -174,7 +235,7 @@ void print_element(FILE *out, const dew_attribute_buffer_t &buffer, uint64_t ind
 int cmd_query(int argc, char **argv)
 {
   argh::parser cmdl;
-  cmdl.add_params({"--aabb", "--attributes", "--lod", "--clip", "--position", "--connection", "-o", "--output"});
+  cmdl.add_params({"--aabb", "--attributes", "--lod", "--seed", "--clip", "--position", "--where", "--polygon", "--corridor", "--zrange", "--connection", "-o", "--output"});
   cmdl.parse(argc, argv);
 
   if (cmdl[{"-h", "--help"}] || cmdl.size() < 2)
@@ -189,6 +250,7 @@ int cmd_query(int argc, char **argv)
   cmdl({"-o", "--output"}) >> args.out_path;
   args.csv = cmdl["--csv"];
   args.stats_only = cmdl["--stats"];
+  args.verbose = cmdl[{"-v", "--verbose"}];
 
   std::string box_text;
   if (cmdl({"--aabb"}) >> box_text)
@@ -205,6 +267,83 @@ int cmd_query(int argc, char **argv)
   if (cmdl({"--attributes"}) >> attribute_text)
     args.attributes = split_commas(attribute_text);
 
+  std::string where_text;
+  if (cmdl({"--where"}) >> where_text)
+  {
+    size_t start = 0;
+    while (start <= where_text.size())
+    {
+      const size_t semicolon = where_text.find(';', start);
+      const std::string clause = where_text.substr(start, semicolon == std::string::npos ? std::string::npos : semicolon - start);
+      if (!clause.empty())
+      {
+        query_args_t::predicate_t predicate;
+        if (!parse_predicate(clause, predicate))
+        {
+          fmt::print(stderr, "Error: cannot parse --where clause '{}'\n", clause);
+          return 1;
+        }
+        args.predicates.push_back(std::move(predicate));
+      }
+      if (semicolon == std::string::npos)
+        break;
+      start = semicolon + 1;
+    }
+  }
+
+  auto parse_numbers = [](const std::string &text, std::vector<double> &out) {
+    for (const auto &token : split_commas(text))
+    {
+      char *end = nullptr;
+      out.push_back(std::strtod(token.c_str(), &end));
+      if (end != token.c_str() + token.size())
+        return false;
+    }
+    return true;
+  };
+  std::string polygon_text;
+  if (cmdl({"--polygon"}) >> polygon_text)
+  {
+    args.shape = dew_region_polygon;
+    if (!parse_numbers(polygon_text, args.vertices) || args.vertices.size() % 2 || args.vertices.size() < 6)
+    {
+      fmt::print(stderr, "Error: --polygon needs at least three x,y pairs\n");
+      return 1;
+    }
+  }
+  std::string corridor_text;
+  if (cmdl({"--corridor"}) >> corridor_text)
+  {
+    if (args.shape != dew_region_box)
+    {
+      fmt::print(stderr, "Error: --polygon and --corridor are mutually exclusive\n");
+      return 1;
+    }
+    args.shape = dew_region_corridor;
+    const size_t colon = corridor_text.find(':');
+    char *end = nullptr;
+    if (colon != std::string::npos)
+      args.radius = std::strtod(corridor_text.c_str(), &end);
+    if (colon == std::string::npos || end != corridor_text.c_str() + colon || args.radius < 0 || !parse_numbers(corridor_text.substr(colon + 1), args.vertices) ||
+        args.vertices.size() % 2 || args.vertices.size() < 4)
+    {
+      fmt::print(stderr, "Error: --corridor needs a radius and at least two x,y pairs, as r:x,y,x,y\n");
+      return 1;
+    }
+  }
+  std::string zrange_text;
+  if (cmdl({"--zrange"}) >> zrange_text)
+  {
+    std::vector<double> range;
+    if (!parse_numbers(zrange_text, range) || range.size() != 2 || !(range[0] < range[1]))
+    {
+      fmt::print(stderr, "Error: --zrange needs two increasing numbers\n");
+      return 1;
+    }
+    args.z_range[0] = range[0];
+    args.z_range[1] = range[1];
+  }
+
   std::string lod_text;
   if (cmdl({"--lod"}) >> lod_text && lod_text != "full")
   {
@@ -213,6 +352,16 @@ int cmd_query(int argc, char **argv)
       args.lod_mode = dew_lod_point_budget;
       args.max_points = std::strtoull(lod_text.c_str() + 7, nullptr, 10);
     }
+    else if (lod_text.rfind("sample:", 0) == 0)
+    {
+      args.lod_mode = dew_lod_sample;
+      args.max_points = std::strtoull(lod_text.c_str() + 7, nullptr, 10);
+      if (args.max_points == 0)
+      {
+        fmt::print(stderr, "Error: --lod sample:<n> needs n > 0\n");
+        return 1;
+      }
+    }
     else
     {
       args.lod_mode = dew_lod_level;
@@ -220,6 +369,10 @@ int cmd_query(int argc, char **argv)
     }
   }
 
+  std::string seed_text;
+  if (cmdl({"--seed"}) >> seed_text)
+    args.seed = std::strtoull(seed_text.c_str(), nullptr, 10);
+
   std::string clip_text;
   if (cmdl({"--clip"}) >> clip_text)
     args.clip_mode = (clip_text == "node") ? dew_clip_node : dew_clip_point;
@@ -293,11 +446,28 @@ int cmd_query(int argc, char **argv)
   spec.lod_mode = args.lod_mode;
   spec.lod = args.level;
   spec.max_points = args.max_points;
+  spec.sample_seed = args.seed;
   spec.attribute_names = attribute_ptrs.empty() ? nullptr : attribute_ptrs.data();
   spec.attribute_count = uint32_t(attribute_ptrs.size());
   spec.position_format = args.position_format;
   spec.clip_mode = args.clip_mode;
 
+  std::vector<dew_attribute_predicate_t> predicates;
+  predicates.reserve(args.predicates.size());
+  for (const auto &predicate : args.predicates)
+    predicates.push_back({predicate.attribute.c_str(), predicate.op, predicate.min, predicate.max, predicate.values.data(), uint32_t(predicate.values.size())});
+  spec.predicates = predicates.empty() ? nullptr : predicates.data();
+  spec.predicate_count = uint32_t(predicates.size());
+
+  dew_region_geometry_t geometry{};
+  geometry.shape = args.shape;
+  geometry.vertices = args.vertices.empty() ? nullptr : args.vertices.data();
+  geometry.vertex_count = uint32_t(args.vertices.size() / 2);
+  geometry.z_min = args.z_range[0];
+  geometry.z_max = args.z_range[1];
+  geometry.radius = args.radius;
+  spec.geometry = args.shape == dew_region_box ? nullptr : &geometry;
+
   auto *request = dew_dataset_request_region(dataset, &spec, &error);
   if (!request || dew_request_wait(request, -1) != dew_request_completed)
   {
@@ -337,6 +507,18 @@ int cmd_query(int argc, char **argv)
     fmt::print(stderr, "  {:<14} {}x{}  {} bytes\n", i == 0 ? "xyz" : std::string(buffer.name, buffer.name_size), type_name(buffer.type), uint32_t(buffer.components), buffer.size_bytes);
   }
 
+  dew_request_stats_t stats{};
+  if (args.verbose && dew_request_get_stats(request, &stats))
+  {
+    fmt::print(stderr, "request\n");
+    fmt::print(stderr, "  walk     {} rounds  {} nodes walked  {} nodes read\n", stats.walk_rounds, stats.nodes_walked, stats.nodes_read);
+    fmt::print(stderr, "  trees    {} loaded  {} prefetched\n", stats.trees_loaded, stats.speculative_trees);
+    fmt::print(stderr, "  blobs    {} read  {} from cache  {} bytes stored  {} bytes decoded\n", stats.blobs_read, stats.cache_hits, stats.bytes_compressed, stats.bytes_decompressed);
+    fmt::print(stderr, "  reads    peak {} in flight  {} round trips  first blob at {:.1f} ms\n", stats.peak_reads_in_flight, stats.round_trips, stats.time_to_first_blob_ms);
+    fmt::print(stderr, "  time     {:.1f} ms: walk {:.1f}  io wait {:.1f}  decode {:.1f}  clip {:.1f}  append {:.1f}\n", stats.total_ms, stats.walk_ms, stats.io_wait_ms, stats.decode_ms, stats.clip_ms,
+               stats.append_ms);
+  }
+
   int exit_code = 0;
   if (!args.stats_only && result.point_count > 0)
   {
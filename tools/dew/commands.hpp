@@ -20,6 +20,7 @@
 // The `dew` CLI subcommand entry points. Each receives the argv slice starting at the subcommand
 // name (argv[0] == subcommand), parses its own flags with argh, and returns the process exit code.
 
+int cmd_bench(int argc, char **argv);
 int cmd_convert(int argc, char **argv);
 int cmd_copy(int argc, char **argv);
 int cmd_extract(int argc, char **argv);
@@ -43,6 +43,7 @@ constexpr command_t k_commands[] = {
   {"copy", cmd_copy, "copy a dataset between storage locations (packed file, dir://, s3://, az://)"},
   {"laz", cmd_laz, "introspect a LAS/LAZ file: header, VLRs, point subranges"},
   {"query", cmd_query, "query the points inside a box and write them out (CSV or raw)"},
+  {"bench", cmd_bench, "render a camera path headlessly and report streaming convergence"},
 };
 
 void print_usage()